@@ -0,0 +1,75 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "./Bounds3D.h"
+
+#include <algorithm>
+
+namespace geometry {
+
+    Bounds3D::Bounds3D(const Vector3D& low, const Vector3D& high) {
+        this->low[0] = low.x();
+        this->low[1] = low.y();
+        this->low[2] = low.z();
+        this->high[0] = high.x();
+        this->high[1] = high.y();
+        this->high[2] = high.z();
+    }
+
+    Bounds3D Bounds3D::merged(const Bounds3D& other) const {
+        Bounds3D result;
+        for (int axis = 0; axis < 3; ++axis) {
+            result.low[axis] = std::min(low[axis], other.low[axis]);
+            result.high[axis] = std::max(high[axis], other.high[axis]);
+        }
+        return result;
+    }
+
+    Bounds3D Bounds3D::swept(const Vector3D& displacement) const {
+        Bounds3D result = *this;
+        const double* motion = displacement.data();
+        for (int axis = 0; axis < 3; ++axis) {
+            // The box covers the end position, it reaches back to the start
+            if (motion[axis] > 0.0) {
+                result.low[axis] -= motion[axis];
+            } else {
+                result.high[axis] -= motion[axis];
+            }
+        }
+        return result;
+    }
+
+    bool Bounds3D::contains(const Bounds3D& other) const {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (other.low[axis] < low[axis] || other.high[axis] > high[axis]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Bounds3D::overlaps(const Bounds3D& other) const {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (other.low[axis] > high[axis] || other.high[axis] < low[axis]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    double Bounds3D::surfaceArea() const {
+        double dx = high[0] - low[0], dy = high[1] - low[1], dz = high[2] - low[2];
+        return 2.0 * (dx * dy + dy * dz + dz * dx);
+    }
+
+    bool Bounds3D::operator==(const Bounds3D& other) const {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (low[axis] != other.low[axis] || high[axis] != other.high[axis]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace geometry
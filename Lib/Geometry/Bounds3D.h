@@ -0,0 +1,45 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef BOUNDS3D_H
+#define BOUNDS3D_H
+
+#include "./Vector3D.h"
+
+namespace geometry {
+
+    /**
+     * @struct Bounds3D
+     * @brief An axis aligned bounding box.
+     *
+     * Plain arrays of low and high corners, so broad phases and trees can read one axis at a time.
+     * Shared by the BVH of the renderer and the broad phase of the physics.
+     */
+    struct Bounds3D {
+        double low[3] = {0.0, 0.0, 0.0};
+        double high[3] = {0.0, 0.0, 0.0};
+
+        Bounds3D() = default;
+        Bounds3D(const Vector3D& low, const Vector3D& high);
+
+        Bounds3D merged(const Bounds3D& other) const;
+
+        /**
+         * @brief Grow the box to cover a motion
+         * @param displacement The motion that ended at this box
+         * @return The union of the box and the box moved back by displacement
+         */
+        Bounds3D swept(const Vector3D& displacement) const;
+
+        bool contains(const Bounds3D& other) const;
+        bool overlaps(const Bounds3D& other) const;
+        double surfaceArea() const;
+        double center(int axis) const { return 0.5 * (low[axis] + high[axis]); }
+        bool operator==(const Bounds3D& other) const;
+        bool operator!=(const Bounds3D& other) const { return !(*this == other); }
+    };
+
+} // namespace geometry
+
+#endif // BOUNDS3D_H
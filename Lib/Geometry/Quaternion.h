@@ -14,6 +14,11 @@
 #include "Vector3D.h"
 #include "../Math/math_common.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
 namespace geometry {
 
     /**
@@ -26,6 +31,9 @@ namespace geometry {
      * 
      * Quaternions provide a robust way to represent rotations in 3D space
      * without gimbal lock and with efficient composition operations.
+     *
+     * Like Vector3D, the per-quaternion operations are inline and constexpr wherever <cmath>
+     * allows it. Only the array kernels and the matrix conversions are compiled separately.
      */
     class Quaternion {
     public:
@@ -36,7 +44,7 @@ namespace geometry {
          * @brief Default constructor for Quaternion.
          * Initializes the quaternion as identity quaternion (1, 0, 0, 0).
          */
-        Quaternion();
+        constexpr Quaternion() noexcept;
 
         /**
          * @brief Parameterized constructor for Quaternion.
@@ -47,7 +55,7 @@ namespace geometry {
          * @param y The second imaginary component of the quaternion.
          * @param z The third imaginary component of the quaternion.
          */
-        Quaternion(double w, double x, double y, double z);
+        constexpr Quaternion(double w, double x, double y, double z) noexcept;
 
         /**
          * @brief Constructor from axis and angle.
@@ -73,25 +81,25 @@ namespace geometry {
          * @brief Get the scalar (real) component.
          * @return The w component of the quaternion.
          */
-        [[nodiscard]] double w() const { return components[0]; }
+        [[nodiscard]] constexpr double w() const noexcept { return components[0]; }
 
         /**
          * @brief Get the x component.
          * @return The x component of the quaternion.
          */
-        [[nodiscard]] double x() const { return components[1]; }
+        [[nodiscard]] constexpr double x() const noexcept { return components[1]; }
 
         /**
          * @brief Get the y component.
          * @return The y component of the quaternion.
          */
-        [[nodiscard]] double y() const { return components[2]; }
+        [[nodiscard]] constexpr double y() const noexcept { return components[2]; }
 
         /**
          * @brief Get the z component.
          * @return The z component of the quaternion.
          */
-        [[nodiscard]] double z() const { return components[3]; }
+        [[nodiscard]] constexpr double z() const noexcept { return components[3]; }
 
         /**
          * @brief Accessor method to get the value at a specific index.
@@ -99,13 +107,25 @@ namespace geometry {
          * @return The value at the specified index.
          * @throws std::out_of_range if index is out of bounds.
          */
-        [[nodiscard]] double at(int index) const;
+        [[nodiscard]] constexpr double at(int index) const;
 
         /**
          * @brief Get the size of the quaternion (always 4).
          * @return The size (4).
          */
-        [[nodiscard]] int size() const { return 4; }
+        [[nodiscard]] constexpr int size() const noexcept { return 4; }
+
+        /**
+         * @brief Get the components as a contiguous array.
+         * @return Pointer to w, followed by x, y and z.
+         */
+        [[nodiscard]] constexpr const double* data() const noexcept { return components; }
+
+        /**
+         * @brief Get the components as a contiguous array.
+         * @return Pointer to w, followed by x, y and z.
+         */
+        [[nodiscard]] constexpr double* data() noexcept { return components; }
 
         // Component mutators
         
@@ -113,25 +133,25 @@ namespace geometry {
          * @brief Set the scalar component.
          * @param w_val The new w value.
          */
-        void setW(double w_val);
+        constexpr void setW(double w_val) noexcept;
 
         /**
          * @brief Set the x component.
          * @param x_val The new x value.
          */
-        void setX(double x_val);
+        constexpr void setX(double x_val) noexcept;
 
         /**
          * @brief Set the y component.
          * @param y_val The new y value.
          */
-        void setY(double y_val);
+        constexpr void setY(double y_val) noexcept;
 
         /**
          * @brief Set the z component.
          * @param z_val The new z value.
          */
-        void setZ(double z_val);
+        constexpr void setZ(double z_val) noexcept;
 
         /**
          * @brief Set all quaternion components.
@@ -140,7 +160,7 @@ namespace geometry {
          * @param y_val The y component.
          * @param z_val The z component.
          */
-        void set(double w_val, double x_val, double y_val, double z_val);
+        constexpr void set(double w_val, double x_val, double y_val, double z_val) noexcept;
 
         // Quaternion-specific operators
         
@@ -152,7 +172,7 @@ namespace geometry {
          * @param other The quaternion to multiply with.
          * @return A new quaternion representing the combined rotation.
          */
-        Quaternion operator*(const Quaternion& other) const;
+        constexpr Quaternion operator*(const Quaternion& other) const noexcept;
 
         /**
          * @brief Vector rotation operator.
@@ -161,7 +181,7 @@ namespace geometry {
          * @param v The 3D vector to rotate.
          * @return The rotated vector.
          */
-        Vector3D operator*(const Vector3D& v) const;
+        constexpr Vector3D operator*(const Vector3D& v) const noexcept;
 
         // Override operators to return Quaternion instead of Vector
         
@@ -170,21 +190,21 @@ namespace geometry {
          * @param other The quaternion to add.
          * @return Sum of quaternions.
          */
-        Quaternion operator+(const Quaternion& other) const;
+        constexpr Quaternion operator+(const Quaternion& other) const noexcept;
 
         /**
          * @brief Quaternion subtraction.
          * @param other The quaternion to subtract.
          * @return Difference of quaternions.
          */
-        Quaternion operator-(const Quaternion& other) const;
+        constexpr Quaternion operator-(const Quaternion& other) const noexcept;
 
         /**
          * @brief Scalar multiplication.
          * @param scalar The scalar to multiply by.
          * @return Scaled quaternion.
          */
-        Quaternion operator*(double scalar) const;
+        constexpr Quaternion operator*(double scalar) const noexcept;
 
         // Quaternion-specific methods
         
@@ -194,7 +214,7 @@ namespace geometry {
          *
          * @return The conjugate quaternion.
          */
-        Quaternion conjugate() const;
+        constexpr Quaternion conjugate() const noexcept;
 
         /**
          * @brief Get the inverse of this quaternion.
@@ -203,7 +223,7 @@ namespace geometry {
          * @return The inverse quaternion.
          * @throws std::invalid_argument if quaternion has zero magnitude.
          */
-        Quaternion inverse() const;
+        constexpr Quaternion inverse() const;
 
         /**
          * @brief Normalize this quaternion to unit length.
@@ -222,7 +242,7 @@ namespace geometry {
          * @brief Get the vector part (imaginary components) of the quaternion.
          * @return A 3D vector containing [x, y, z] components.
          */
-        Vector3D vectorPart() const;
+        constexpr Vector3D vectorPart() const noexcept;
 
         /**
          * @brief Convert quaternion to 3x3 rotation matrix.
@@ -264,19 +284,19 @@ namespace geometry {
          * @param epsilon Tolerance for the check (default: 1e-9).
          * @return True if the quaternion is normalized.
          */
-        bool isUnit(double epsilon = 1e-9) const;
+        constexpr bool isUnit(double epsilon = 1e-9) const noexcept;
 
         /**
          * @brief Get the length (magnitude) of the quaternion.
          * @return The length of the quaternion.
          */
-        [[nodiscard]] double length() const;
+        [[nodiscard]] double length() const noexcept;
 
         /**
          * @brief Get the squared length of the quaternion.
          * @return The squared length of the quaternion.
          */
-        [[nodiscard]] double lengthSquared() const;
+        [[nodiscard]] constexpr double lengthSquared() const noexcept;
 
         // Static factory methods
         
@@ -284,7 +304,7 @@ namespace geometry {
          * @brief Create identity quaternion.
          * @return Identity quaternion (1, 0, 0, 0).
          */
-        static Quaternion identity();
+        static constexpr Quaternion identity() noexcept;
 
         /**
          * @brief Create quaternion from axis-angle representation.
@@ -346,7 +366,50 @@ namespace geometry {
          * @param q2 Second quaternion.
          * @return Dot product value.
          */
-        double dot(const Quaternion& other) const;
+        constexpr double dot(const Quaternion& other) const noexcept;
+
+        // Batch operations
+        // The quaternion is turned into a 3x3 matrix once, then applied to whole arrays in SIMD
+        // loops, split across threads for large arrays. Outputs may alias the inputs.
+
+        /**
+         * @brief Rotate an array of vectors.
+         * Gives the same vectors as operator* applied to each one.
+         * @param vectors The vectors to rotate.
+         * @param out Output, the rotated vectors, count of them.
+         * @param count The number of vectors.
+         */
+        void rotate(const Vector3D* vectors, Vector3D* out, size_t count) const;
+
+        /**
+         * @brief Spherical linear interpolation of arrays of quaternions, as slerp.
+         * @param from The first quaternion of each pair.
+         * @param to The second quaternion of each pair.
+         * @param t The interpolation parameter of each pair, clamped to [0, 1].
+         * @param out Output, the interpolated quaternions.
+         * @param count The number of pairs.
+         * @throws std::invalid_argument if a quaternion has zero magnitude, out is then partly written.
+         */
+        static void slerp(const Quaternion* from, const Quaternion* to, const double* t, Quaternion* out, size_t count);
+
+        /**
+         * @brief Normalized linear interpolation of arrays of quaternions, as nlerp.
+         * @param from The first quaternion of each pair.
+         * @param to The second quaternion of each pair.
+         * @param t The interpolation parameter of each pair, clamped to [0, 1].
+         * @param out Output, the interpolated quaternions.
+         * @param count The number of pairs.
+         * @throws std::invalid_argument if a quaternion or a result has zero magnitude, out is then partly written.
+         */
+        static void nlerp(const Quaternion* from, const Quaternion* to, const double* t, Quaternion* out, size_t count);
+
+        /**
+         * @brief Normalize an array of quaternions in place.
+         * @param quaternions The quaternions to normalize.
+         * @param count The number of quaternions.
+         * @throws std::invalid_argument if a quaternion has zero magnitude, it is then left unchanged.
+         */
+        static void normalize(Quaternion* quaternions, size_t count);
 
         // Common quaternion constants
         static const Quaternion IDENTITY;
@@ -364,7 +427,238 @@ namespace geometry {
      * @param q Quaternion to output.
      * @return Reference to output stream.
      */
-    std::ostream& operator<<(std::ostream& os, const Quaternion& q);
+    inline std::ostream& operator<<(std::ostream& os, const Quaternion& q);
+
+    // Inline implementation
+
+    constexpr Quaternion::Quaternion() noexcept : components{1.0, 0.0, 0.0, 0.0} {}
+
+    constexpr Quaternion::Quaternion(double w, double x, double y, double z) noexcept : components{w, x, y, z} {}
+
+    inline constexpr Quaternion Quaternion::IDENTITY(1.0, 0.0, 0.0, 0.0);
+
+    inline Quaternion::Quaternion(const Vector3D& axis, double angle) : components{1.0, 0.0, 0.0, 0.0} {
+        Vector3D normalizedAxis = axis.normal();
+        double halfAngle = angle * 0.5;
+        double sinHalfAngle = std::sin(halfAngle);
+        components[0] = std::cos(halfAngle);
+        components[1] = normalizedAxis.x() * sinHalfAngle;
+        components[2] = normalizedAxis.y() * sinHalfAngle;
+        components[3] = normalizedAxis.z() * sinHalfAngle;
+    }
+
+    inline Quaternion::Quaternion(const math::Vector<double>& comp) : components{1.0, 0.0, 0.0, 0.0} {
+        if (comp.size() != 4) {
+            throw std::invalid_argument("Vector must be 4D to convert to Quaternion");
+        }
+        components[0] = comp[0];
+        components[1] = comp[1];
+        components[2] = comp[2];
+        components[3] = comp[3];
+    }
+
+    constexpr double Quaternion::at(int index) const {
+        if (index < 0 || index >= 4) {
+            throw std::out_of_range("Quaternion index out of bounds");
+        }
+        return components[index];
+    }
+
+    constexpr void Quaternion::setW(double w_val) noexcept { components[0] = w_val; }
+    constexpr void Quaternion::setX(double x_val) noexcept { components[1] = x_val; }
+    constexpr void Quaternion::setY(double y_val) noexcept { components[2] = y_val; }
+    constexpr void Quaternion::setZ(double z_val) noexcept { components[3] = z_val; }
+
+    constexpr void Quaternion::set(double w_val, double x_val, double y_val, double z_val) noexcept {
+        components[0] = w_val;
+        components[1] = x_val;
+        components[2] = y_val;
+        components[3] = z_val;
+    }
+
+    constexpr Quaternion Quaternion::identity() noexcept {
+        return Quaternion(1.0, 0.0, 0.0, 0.0);
+    }
+
+    inline Quaternion Quaternion::fromAxisAngle(const Vector3D& axis, double angle) {
+        return Quaternion(axis, angle);
+    }
+
+    inline Quaternion Quaternion::fromVectorToVector(const Vector3D& from, const Vector3D& to) {
+        Vector3D fromNorm = from.normal();
+        Vector3D toNorm = to.normal();
+        double cosTheta = fromNorm.dot(toNorm);
+
+        // Same direction
+        if (cosTheta > 0.9999) {
+            return identity();
+        }
+        // Opposite directions, half a turn around any perpendicular axis
+        if (cosTheta < -0.9999) {
+            Vector3D axis = std::abs(fromNorm.x()) > 0.1 ? Vector3D(0.0, 1.0, 0.0) : Vector3D(1.0, 0.0, 0.0);
+            return Quaternion(fromNorm.cross(axis).normal(), math::pi);
+        }
+        return Quaternion(fromNorm.cross(toNorm).normal(), std::acos(cosTheta));
+    }
+
+    inline Quaternion Quaternion::fromEulerAngles(double roll, double pitch, double yaw) {
+        // Half angles
+        double cr = std::cos(roll * 0.5);
+        double sr = std::sin(roll * 0.5);
+        double cp = std::cos(pitch * 0.5);
+        double sp = std::sin(pitch * 0.5);
+        double cy = std::cos(yaw * 0.5);
+        double sy = std::sin(yaw * 0.5);
+
+        // ZYX convention (yaw-pitch-roll)
+        return Quaternion(cr * cp * cy + sr * sp * sy,
+                          sr * cp * cy - cr * sp * sy,
+                          cr * sp * cy + sr * cp * sy,
+                          cr * cp * sy - sr * sp * cy);
+    }
+
+    constexpr Quaternion Quaternion::operator*(const Quaternion& other) const noexcept {
+        // Hamilton product: (w1*w2 - v1.v2, w1*v2 + w2*v1 + v1 x v2)
+        const double w1 = w(), x1 = x(), y1 = y(), z1 = z();
+        const double w2 = other.w(), x2 = other.x(), y2 = other.y(), z2 = other.z();
+        return Quaternion(w1 * w2 - x1 * x2 - y1 * y2 - z1 * z2,
+                          w1 * x2 + x1 * w2 + y1 * z2 - z1 * y2,
+                          w1 * y2 - x1 * z2 + y1 * w2 + z1 * x2,
+                          w1 * z2 + x1 * y2 - y1 * x2 + z1 * w2);
+    }
+
+    constexpr Vector3D Quaternion::operator*(const Vector3D& v) const noexcept {
+        // v' = q * v * q^-1, expanded for a unit quaternion:
+        // v' = v + 2w (qv x v) + 2 qv x (qv x v), with qv the vector part
+        const Vector3D qv = vectorPart();
+        const Vector3D cross1 = qv.cross(v);
+        const Vector3D cross2 = qv.cross(cross1);
+        return v + cross1 * (2.0 * w()) + cross2 * 2.0;
+    }
+
+    constexpr Quaternion Quaternion::operator+(const Quaternion& other) const noexcept {
+        // Component-wise, used by interpolation and averaging, not a composition of rotations
+        return Quaternion(w() + other.w(), x() + other.x(), y() + other.y(), z() + other.z());
+    }
+
+    constexpr Quaternion Quaternion::operator-(const Quaternion& other) const noexcept {
+        return Quaternion(w() - other.w(), x() - other.x(), y() - other.y(), z() - other.z());
+    }
+
+    constexpr Quaternion Quaternion::operator*(double scalar) const noexcept {
+        return Quaternion(w() * scalar, x() * scalar, y() * scalar, z() * scalar);
+    }
+
+    constexpr Quaternion Quaternion::conjugate() const noexcept {
+        return Quaternion(w(), -x(), -y(), -z());
+    }
+
+    constexpr Quaternion Quaternion::inverse() const {
+        double normSq = lengthSquared();
+        if (normSq == 0.0) {
+            throw std::runtime_error("Cannot invert a zero-length quaternion");
+        }
+        return conjugate() * (1.0 / normSq);
+    }
+
+    inline Quaternion Quaternion::normalize() const {
+        double len = length();
+        if (len == 0.0) {
+            throw std::invalid_argument("Cannot normalize a zero-length quaternion.");
+        }
+        return (*this) * (1.0 / len);
+    }
+
+    inline void Quaternion::normalizeInPlace() {
+        double len = length();
+        if (len == 0.0) {
+            throw std::invalid_argument("Cannot normalize a zero-length quaternion.");
+        }
+        for (double& component : components) {
+            component /= len;
+        }
+    }
+
+    inline double Quaternion::length() const noexcept {
+        return std::sqrt(lengthSquared());
+    }
+
+    constexpr double Quaternion::lengthSquared() const noexcept {
+        return dot(*this);
+    }
+
+    constexpr Vector3D Quaternion::vectorPart() const noexcept {
+        return Vector3D(x(), y(), z());
+    }
+
+    inline double Quaternion::getRotationAngle() const {
+        // Full angle, not half-angle
+        return 2.0 * std::acos(std::abs(normalize().w()));
+    }
+
+    inline Vector3D Quaternion::getRotationAxis() const {
+        Quaternion q = normalize();
+        // Sine of the half-angle, close to zero for no rotation or a full turn
+        double s = std::sqrt(1.0 - q.w() * q.w());
+        if (s < 0.001) {
+            throw std::invalid_argument("Quaternion represents no rotation (identity quaternion)");
+        }
+        return Vector3D(q.x() / s, q.y() / s, q.z() / s);
+    }
+
+    inline void Quaternion::toAxisAngle(Vector3D& axis, double& angle) const {
+        angle = getRotationAngle();
+        axis = getRotationAxis();
+    }
+
+    constexpr bool Quaternion::isUnit(double epsilon) const noexcept {
+        return math::absolute(lengthSquared() - 1.0) < epsilon;
+    }
+
+    constexpr double Quaternion::dot(const Quaternion& other) const noexcept {
+        return w() * other.w() + x() * other.x() + y() * other.y() + z() * other.z();
+    }
+
+    inline Quaternion Quaternion::slerp(const Quaternion& q1, const Quaternion& q2, double t) {
+        t = std::clamp(t, 0.0, 1.0);
+        Quaternion qa = q1.normalize();
+        Quaternion qb = q2.normalize();
+
+        // q and -q are the same rotation, take the shorter path
+        double dot = qa.dot(qb);
+        if (dot < 0.0) {
+            qb = qb * (-1.0);
+            dot = -dot;
+        }
+
+        // Linear interpolation for very close quaternions, to avoid dividing by zero
+        const double DOT_THRESHOLD = 0.9995;
+        if (dot > DOT_THRESHOLD) {
+            return (qa + (qb - qa) * t).normalize();
+        }
+
+        // Rotate qa toward the part of qb orthogonal to it
+        double theta = std::acos(dot) * t;
+        Quaternion qbPerpendicular = (qb - qa * dot).normalize();
+        return qa * std::cos(theta) + qbPerpendicular * std::sin(theta);
+    }
+
+    inline Quaternion Quaternion::nlerp(const Quaternion& q1, const Quaternion& q2, double t) {
+        t = std::clamp(t, 0.0, 1.0);
+        Quaternion qa = q1.normalize();
+        Quaternion qb = q2.normalize();
+
+        // Take the shorter path
+        if (qa.dot(qb) < 0.0) {
+            qb = qb * (-1.0);
+        }
+        return (qa * (1.0 - t) + qb * t).normalize();
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, const Quaternion& q) {
+        os << "Quaternion(" << q.w() << ", " << q.x() << ", " << q.y() << ", " << q.z() << ")";
+        return os;
+    }
 
 } // namespace geometry
 
@@ -7,6 +7,9 @@
 
 namespace geometry {
 
+// Default constructor
+Ray::Ray() : origin(Vector3D::ZERO), direction(Vector3D::UNIT_X) {}
+
 // Constructor
 Ray::Ray(const Vector3D& origin, const Vector3D& direction)
     : origin(origin), direction(direction.normal()) {
@@ -11,6 +11,12 @@ namespace geometry {
 
     class Ray {
     public:
+        /**
+         * Default constructor, ray from the origin along the X axis
+         * Used to size ray buffers before filling them
+         */
+        Ray();
+
         /**
          * Constructor for Ray
          * @param origin Starting point of the ray
@@ -0,0 +1,77 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "Transform.h"
+
+#include <stdexcept>
+
+namespace geometry {
+
+    namespace {
+        /// Element count from which the batch loops are split across threads
+        constexpr size_t BATCH_PARALLEL_THRESHOLD = size_t(1) << 14;
+    }
+
+    Transform::Transform() : Transform(Quaternion::identity()) {}
+
+    Transform::Transform(const Quaternion& rotation, const Vector3D& translation, double scale)
+        : rotation(rotation.normalize()), translation(translation), scale(scale) {
+        if (!(scale > 0.0)) {
+            throw std::invalid_argument("Scale must be positive");
+        }
+        // The columns are the rotated axes
+        const Vector3D axes[3] = {Vector3D(1, 0, 0), Vector3D(0, 1, 0), Vector3D(0, 0, 1)};
+        Vector3D columns[3];
+        this->rotation.rotate(axes, columns, 3);
+        for (int row = 0; row < 3; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                matrix[3 * row + col] = columns[col].data()[row];
+            }
+        }
+    }
+
+    Vector3D Transform::transformPoint(const Vector3D& point) const {
+        Vector3D result;
+        transformPoints(&point, &result, 1);
+        return result;
+    }
+
+    Vector3D Transform::transformNormal(const Vector3D& normal) const {
+        Vector3D result;
+        transformNormals(&normal, &result, 1);
+        return result;
+    }
+
+    void Transform::transformPoints(const Vector3D* points, Vector3D* out, size_t count) const {
+        const double m00 = scale * matrix[0], m01 = scale * matrix[1], m02 = scale * matrix[2];
+        const double m10 = scale * matrix[3], m11 = scale * matrix[4], m12 = scale * matrix[5];
+        const double m20 = scale * matrix[6], m21 = scale * matrix[7], m22 = scale * matrix[8];
+        const double tx = translation.x(), ty = translation.y(), tz = translation.z();
+
+        const double* in = points->data();
+        double* result = out->data();
+        const long long size = static_cast<long long>(count);
+        #pragma omp parallel for simd schedule(static) if(count >= BATCH_PARALLEL_THRESHOLD)
+        for (long long i = 0; i < size; ++i) {
+            const double px = in[3 * i], py = in[3 * i + 1], pz = in[3 * i + 2];
+            result[3 * i] = m00 * px + m01 * py + m02 * pz + tx;
+            result[3 * i + 1] = m10 * px + m11 * py + m12 * pz + ty;
+            result[3 * i + 2] = m20 * px + m21 * py + m22 * pz + tz;
+        }
+    }
+
+    void Transform::transformNormals(const Vector3D* normals, Vector3D* out, size_t count) const {
+        rotation.rotate(normals, out, count);
+    }
+
+    Transform Transform::operator*(const Transform& other) const {
+        return Transform(rotation * other.rotation, transformPoint(other.translation), scale * other.scale);
+    }
+
+    Transform Transform::inverse() const {
+        Quaternion back = rotation.conjugate();
+        return Transform(back, (back * translation) * (-1.0 / scale), 1.0 / scale);
+    }
+
+} // namespace geometry
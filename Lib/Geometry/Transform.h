@@ -0,0 +1,95 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include "Quaternion.h"
+#include "Vector3D.h"
+
+#include <cstddef>
+
+namespace geometry {
+
+    /**
+     * @class Transform
+     * @brief A rigid transform with a uniform scale: points are scaled, rotated, then translated.
+     *
+     * The rotation is kept as a quaternion and as its 3x3 matrix, computed once, so that arrays of
+     * points and normals are transformed by plain matrix products in SIMD loops. Normals are only
+     * rotated, the scale being uniform they stay perpendicular to the transformed surfaces.
+     */
+    class Transform {
+    public:
+        /**
+         * @brief Create the identity transform
+         */
+        Transform();
+
+        /**
+         * @brief Create a transform
+         * @param rotation The rotation (will be normalized)
+         * @param translation The translation, applied last
+         * @param scale The uniform scale, applied first
+         * @throws std::invalid_argument if rotation has zero magnitude or scale is not positive
+         */
+        explicit Transform(const Quaternion& rotation, const Vector3D& translation = Vector3D(0, 0, 0), double scale = 1.0);
+
+        const Quaternion& getRotation() const { return rotation; }
+        const Vector3D& getTranslation() const { return translation; }
+        double getScale() const { return scale; }
+
+        /**
+         * @brief Transform a point
+         * @param point The point
+         * @return scale, rotate then translate the point
+         */
+        Vector3D transformPoint(const Vector3D& point) const;
+
+        /**
+         * @brief Transform a normal or a direction
+         * @param normal The normal
+         * @return The rotated normal
+         */
+        Vector3D transformNormal(const Vector3D& normal) const;
+
+        /**
+         * @brief Transform an array of points, out may alias points
+         * @param points The points
+         * @param out Output, the transformed points, count of them
+         * @param count The number of points
+         */
+        void transformPoints(const Vector3D* points, Vector3D* out, size_t count) const;
+
+        /**
+         * @brief Transform an array of normals or directions, out may alias normals
+         * @param normals The normals
+         * @param out Output, the rotated normals, count of them
+         * @param count The number of normals
+         */
+        void transformNormals(const Vector3D* normals, Vector3D* out, size_t count) const;
+
+        /**
+         * @brief Compose two transforms
+         * @param other The transform applied first
+         * @return The transform applying other, then this
+         */
+        Transform operator*(const Transform& other) const;
+
+        /**
+         * @brief Get the inverse transform
+         * @return The transform undoing this one
+         */
+        Transform inverse() const;
+
+    private:
+        Quaternion rotation;
+        Vector3D translation;
+        double scale;
+        double matrix[9]; ///< The rotation matrix, row major
+    };
+
+} // namespace geometry
+
+#endif // TRANSFORM_H
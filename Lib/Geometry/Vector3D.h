@@ -4,10 +4,12 @@
 #ifndef VECTOR3D_H
 #define VECTOR3D_H
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <stdexcept>
 #include "../Math/Vector.hpp"
+#include "../Math/math_common.h"
 
 namespace geometry {
 
@@ -19,13 +21,16 @@ namespace geometry {
      * dot product, cross product, normalization, and other geometric computations.
      * Unlike the template Vector class which manages pointers, this class stores
      * actual double values for mathematical computations.
+     *
+     * The class is header-only and constexpr wherever <cmath> allows it, so that constants
+     * fold at compile time and the renderer's inner loops inline it without link-time optimization.
      */
     class Vector3D {
     public:
         /**
          * @brief Default constructor that creates a 3D vector with all elements initialized to 0.0.
          */
-        Vector3D();
+        constexpr Vector3D() noexcept;
 
         /**
          * @brief Constructor that creates a 3D vector with specified x, y, z values.
@@ -33,7 +38,7 @@ namespace geometry {
          * @param y The y-coordinate of the vector.
          * @param z The z-coordinate of the vector.
          */
-        Vector3D(double x, double y, double z);
+        constexpr Vector3D(double x, double y, double z) noexcept;
 
         /**
          * @brief Constructor that creates a Vector3D from a Vector template.
@@ -46,19 +51,19 @@ namespace geometry {
          * @brief Get the x-component of the vector.
          * @return The x-coordinate.
          */
-        [[nodiscard]] double x() const;
+        [[nodiscard]] constexpr double x() const noexcept;
 
         /**
          * @brief Get the y-component of the vector.
          * @return The y-coordinate.
          */
-        [[nodiscard]] double y() const;
+        [[nodiscard]] constexpr double y() const noexcept;
 
         /**
          * @brief Get the z-component of the vector.
          * @return The z-coordinate.
          */
-        [[nodiscard]] double z() const;
+        [[nodiscard]] constexpr double z() const noexcept;
 
         /**
          * @brief Accessor method to get the value at a specific index.
@@ -66,25 +71,38 @@ namespace geometry {
          * @return The value at the specified index.
          * @throws std::out_of_range if index is out of bounds.
          */
-        [[nodiscard]] double at(int index) const;
+        [[nodiscard]] constexpr double at(int index) const;
+
+        /**
+         * @brief Get the components as a contiguous array.
+         * Arrays of vectors are arrays of x, y, z triplets, for the batch kernels.
+         * @return Pointer to x, followed by y and z.
+         */
+        [[nodiscard]] constexpr const double* data() const noexcept { return components; }
+
+        /**
+         * @brief Get the components as a contiguous array.
+         * @return Pointer to x, followed by y and z.
+         */
+        [[nodiscard]] constexpr double* data() noexcept { return components; }
 
         /**
          * @brief Set the x-component of the vector.
          * @param x The new x-coordinate.
          */
-        void setX(double x);
+        constexpr void setX(double x) noexcept;
 
         /**
          * @brief Set the y-component of the vector.
          * @param y The new y-coordinate.
          */
-        void setY(double y);
+        constexpr void setY(double y) noexcept;
 
         /**
          * @brief Set the z-component of the vector.
          * @param z The new z-coordinate.
          */
-        void setZ(double z);
+        constexpr void setZ(double z) noexcept;
 
         /**
          * @brief Set all components of the vector.
@@ -92,42 +110,42 @@ namespace geometry {
          * @param y The new y-coordinate.
          * @param z The new z-coordinate.
          */
-        void set(double x, double y, double z);
+        constexpr void set(double x, double y, double z) noexcept;
 
         /**
          * @brief Equality operator that compares two vectors.
          * @param other The vector to compare with.
          * @return True if vectors are equal (within epsilon), false otherwise.
          */
-        bool operator==(const Vector3D& other) const;
+        constexpr bool operator==(const Vector3D& other) const noexcept;
 
         /**
          * @brief Inequality operator that compares two vectors.
          * @param other The vector to compare with.
          * @return True if vectors are not equal, false otherwise.
          */
-        bool operator!=(const Vector3D& other) const;
+        constexpr bool operator!=(const Vector3D& other) const noexcept;
 
         /**
          * @brief Addition operator that adds two vectors element-wise.
          * @param other The vector to add.
          * @return A new vector containing the result of the addition.
          */
-        Vector3D operator+(const Vector3D& other) const;
+        constexpr Vector3D operator+(const Vector3D& other) const noexcept;
 
         /**
          * @brief Subtraction operator that subtracts two vectors element-wise.
          * @param other The vector to subtract.
          * @return A new vector containing the result of the subtraction.
          */
-        Vector3D operator-(const Vector3D& other) const;
+        constexpr Vector3D operator-(const Vector3D& other) const noexcept;
 
         /**
          * @brief Scalar multiplication operator.
          * @param scalar The scalar value to multiply by.
          * @return A new vector scaled by the scalar.
          */
-        Vector3D operator*(double scalar) const;
+        constexpr Vector3D operator*(double scalar) const noexcept;
 
         /**
          * @brief Scalar division operator.
@@ -135,39 +153,39 @@ namespace geometry {
          * @return A new vector divided by the scalar.
          * @throws std::invalid_argument if scalar is zero.
          */
-        Vector3D operator/(double scalar) const;
+        constexpr Vector3D operator/(double scalar) const;
 
         /**
          * @brief Unary minus operator.
          * @return A new vector with negated components.
          */
-        Vector3D operator-() const;
+        constexpr Vector3D operator-() const noexcept;
 
         /**
          * @brief Calculate the dot product with another Vector3D.
          * @param other The other Vector3D.
          * @return The dot product of the two vectors.
          */
-        double dot(const Vector3D& other) const;
+        constexpr double dot(const Vector3D& other) const noexcept;
 
         /**
          * @brief Calculate the cross product with another Vector3D.
          * @param other The other Vector3D.
          * @return A new Vector3D that is the cross product.
          */
-        Vector3D cross(const Vector3D& other) const;
+        constexpr Vector3D cross(const Vector3D& other) const noexcept;
 
         /**
          * @brief Get the length (magnitude) of the vector.
          * @return The length of the vector.
          */
-        [[nodiscard]] double length() const;
+        [[nodiscard]] double length() const noexcept;
 
         /**
          * @brief Get the squared length of the vector (without taking the square root).
          * @return The squared length of the vector.
          */
-        [[nodiscard]] double lengthSquared() const;
+        [[nodiscard]] constexpr double lengthSquared() const noexcept;
 
         /**
          * @brief Normalize the vector (make its length equal to 1).
@@ -187,21 +205,21 @@ namespace geometry {
          * @param other The other vector.
          * @return The distance between the two vectors.
          */
-        double distance(const Vector3D& other) const;
+        double distance(const Vector3D& other) const noexcept;
 
         /**
          * @brief Calculate the squared distance between two vectors.
          * @param other The other vector.
          * @return The squared distance between the two vectors.
          */
-        double squaredDistance(const Vector3D& other) const;
+        constexpr double squaredDistance(const Vector3D& other) const noexcept;
 
         /**
          * @brief Check if this vector is parallel to another Vector3D.
          * @param other The other Vector3D.
          * @return True if the vectors are parallel, false otherwise.
          */
-        bool parallel(const Vector3D& other) const;
+        constexpr bool parallel(const Vector3D& other) const noexcept;
 
         /**
          * @brief Calculate the angle (in radians) between two 3D vectors.
@@ -211,17 +229,26 @@ namespace geometry {
          */
         double angle(const Vector3D& other) const;
 
+        /**
+         * @brief Build two unit vectors spanning the plane orthogonal to this vector.
+         * The three vectors form a right-handed orthonormal basis: axisU x axisV is this vector normalized.
+         * @param axisU Receives the first tangent.
+         * @param axisV Receives the second tangent.
+         * @throws std::invalid_argument if vector has zero length.
+         */
+        void tangentBasis(Vector3D& axisU, Vector3D& axisV) const;
+
         /**
          * @brief Check if all elements of the vector are zero.
          * @return True if all elements are zero, false otherwise.
          */
-        bool zero() const;
+        constexpr bool zero() const noexcept;
 
         /**
          * @brief Get the size of the vector (always 3 for Vector3D).
          * @return The size (3).
          */
-        [[nodiscard]] int size() const { return 3; }
+        [[nodiscard]] constexpr int size() const noexcept { return 3; }
 
         /**
          * @brief Convert to Vector template.
@@ -254,7 +281,176 @@ namespace geometry {
      * @param vector The vector to multiply.
      * @return A new vector scaled by the scalar.
      */
-    Vector3D operator*(double scalar, const Vector3D& vector);
+    constexpr Vector3D operator*(double scalar, const Vector3D& vector) noexcept;
+
+    // Inline implementation
+
+    constexpr Vector3D::Vector3D() noexcept : components{0.0, 0.0, 0.0} {}
+
+    constexpr Vector3D::Vector3D(double x, double y, double z) noexcept : components{x, y, z} {}
+
+    inline constexpr Vector3D Vector3D::ZERO(0.0, 0.0, 0.0);
+    inline constexpr Vector3D Vector3D::UNIT_X(1.0, 0.0, 0.0);
+    inline constexpr Vector3D Vector3D::UNIT_Y(0.0, 1.0, 0.0);
+    inline constexpr Vector3D Vector3D::UNIT_Z(0.0, 0.0, 1.0);
+
+    inline Vector3D::Vector3D(const math::Vector<double>& data) : components{0.0, 0.0, 0.0} {
+        if (data.size() != 3) {
+            throw std::invalid_argument("Vector must be of size 3 to convert to Vector3D");
+        }
+        components[0] = data[0];
+        components[1] = data[1];
+        components[2] = data[2];
+    }
+
+    constexpr double Vector3D::x() const noexcept { return components[0]; }
+    constexpr double Vector3D::y() const noexcept { return components[1]; }
+    constexpr double Vector3D::z() const noexcept { return components[2]; }
+
+    constexpr double Vector3D::at(int index) const {
+        if (index < 0 || index >= 3) {
+            throw std::out_of_range("Vector3D index out of bounds");
+        }
+        return components[index];
+    }
+
+    constexpr void Vector3D::setX(double x) noexcept { components[0] = x; }
+    constexpr void Vector3D::setY(double y) noexcept { components[1] = y; }
+    constexpr void Vector3D::setZ(double z) noexcept { components[2] = z; }
+
+    constexpr void Vector3D::set(double x, double y, double z) noexcept {
+        components[0] = x;
+        components[1] = y;
+        components[2] = z;
+    }
+
+    constexpr bool Vector3D::operator==(const Vector3D& other) const noexcept {
+        return math::absolute(components[0] - other.components[0]) < EPSILON &&
+               math::absolute(components[1] - other.components[1]) < EPSILON &&
+               math::absolute(components[2] - other.components[2]) < EPSILON;
+    }
+
+    constexpr bool Vector3D::operator!=(const Vector3D& other) const noexcept {
+        return !(*this == other);
+    }
+
+    constexpr Vector3D Vector3D::operator+(const Vector3D& other) const noexcept {
+        return Vector3D(components[0] + other.components[0],
+                        components[1] + other.components[1],
+                        components[2] + other.components[2]);
+    }
+
+    constexpr Vector3D Vector3D::operator-(const Vector3D& other) const noexcept {
+        return Vector3D(components[0] - other.components[0],
+                        components[1] - other.components[1],
+                        components[2] - other.components[2]);
+    }
+
+    constexpr Vector3D Vector3D::operator*(double scalar) const noexcept {
+        return Vector3D(components[0] * scalar, components[1] * scalar, components[2] * scalar);
+    }
+
+    constexpr Vector3D Vector3D::operator/(double scalar) const {
+        if (math::absolute(scalar) < EPSILON) {
+            throw std::invalid_argument("Cannot divide by zero");
+        }
+        return Vector3D(components[0] / scalar, components[1] / scalar, components[2] / scalar);
+    }
+
+    constexpr Vector3D Vector3D::operator-() const noexcept {
+        return Vector3D(-components[0], -components[1], -components[2]);
+    }
+
+    constexpr double Vector3D::dot(const Vector3D& other) const noexcept {
+        return components[0] * other.components[0] +
+               components[1] * other.components[1] +
+               components[2] * other.components[2];
+    }
+
+    constexpr Vector3D Vector3D::cross(const Vector3D& other) const noexcept {
+        return Vector3D(components[1] * other.components[2] - components[2] * other.components[1],
+                        components[2] * other.components[0] - components[0] * other.components[2],
+                        components[0] * other.components[1] - components[1] * other.components[0]);
+    }
+
+    inline double Vector3D::length() const noexcept {
+        return std::sqrt(lengthSquared());
+    }
+
+    constexpr double Vector3D::lengthSquared() const noexcept {
+        return dot(*this);
+    }
+
+    inline Vector3D Vector3D::normal() const {
+        double len = length();
+        if (len < EPSILON) {
+            throw std::invalid_argument("Cannot normalize a zero-length vector");
+        }
+        return *this / len;
+    }
+
+    inline void Vector3D::normalize() {
+        double len = length();
+        if (len < EPSILON) {
+            throw std::invalid_argument("Cannot normalize a zero-length vector");
+        }
+        components[0] /= len;
+        components[1] /= len;
+        components[2] /= len;
+    }
+
+    inline double Vector3D::distance(const Vector3D& other) const noexcept {
+        return std::sqrt(squaredDistance(other));
+    }
+
+    constexpr double Vector3D::squaredDistance(const Vector3D& other) const noexcept {
+        return (*this - other).lengthSquared();
+    }
+
+    constexpr bool Vector3D::parallel(const Vector3D& other) const noexcept {
+        return cross(other).zero();
+    }
+
+    inline double Vector3D::angle(const Vector3D& other) const {
+        double magnitudes = length() * other.length();
+        if (magnitudes < EPSILON) {
+            throw std::invalid_argument("Cannot calculate angle with zero-length vector");
+        }
+        // Clamp to valid range for acos to handle floating point errors
+        double cosAngle = std::clamp(dot(other) / magnitudes, -1.0, 1.0);
+        return std::acos(cosAngle);
+    }
+
+    inline void Vector3D::tangentBasis(Vector3D& axisU, Vector3D& axisV) const {
+        Vector3D n = normal();
+        // Any axis far from the normal gives a well-conditioned cross product
+        Vector3D helper = math::absolute(n.x()) < 0.9 ? UNIT_X : UNIT_Y;
+        axisU = helper.cross(n).normal();
+        axisV = n.cross(axisU);
+    }
+
+    constexpr bool Vector3D::zero() const noexcept {
+        return math::absolute(components[0]) < EPSILON &&
+               math::absolute(components[1]) < EPSILON &&
+               math::absolute(components[2]) < EPSILON;
+    }
+
+    inline math::Vector<double> Vector3D::toVector() const {
+        math::Vector<double> result(3);
+        result[0] = components[0];
+        result[1] = components[1];
+        result[2] = components[2];
+        return result;
+    }
+
+    constexpr Vector3D operator*(double scalar, const Vector3D& vector) noexcept {
+        return vector * scalar;
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, const Vector3D& v) {
+        os << "[" << v.components[0] << ", " << v.components[1] << ", " << v.components[2] << "]";
+        return os;
+    }
 
 } // namespace geometry
 
@@ -7,7 +7,11 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 
 namespace math {
     /**
@@ -46,8 +50,9 @@ namespace math {
         #pragma region Utility_Methods
 
         void swapRows(size_t r1, size_t r2);
-        Matrix transpose();
+        Matrix transpose() const;
         void clear();
+        void fill(const T& value);
         size_t getRows() const;
         size_t getCols() const;
         
@@ -56,18 +61,61 @@ namespace math {
 
         #pragma endregion
 
+        #pragma region Elementwise_Reductions
+
+        /**
+         * @brief Replace every element by f(element)
+         * @param f A function of one element, called concurrently on large matrices
+         */
+        template<typename F>
+        void map(F f);
+
+        /**
+         * @brief Replace every element by f(element, other element at the same place)
+         * @param other A matrix of the same size
+         * @param f A function of two elements, called concurrently on large matrices
+         * @throws std::invalid_argument if the sizes differ
+         */
+        template<typename U, typename F>
+        void zip(const Matrix<U>& other, F f);
+
+        // Reductions, for arithmetic T. NaN elements are always skipped, and so are infinite
+        // ones when finiteOnly is set, e.g. the "nothing hit" depth of a depth buffer.
+        // With no element left, min and max return the largest and lowest value of T
+        // (+/- infinity for floating types) and sum returns 0.
+        T min(bool finiteOnly = false) const;
+        T max(bool finiteOnly = false) const;
+        T sum(bool finiteOnly = false) const;
+
+        #pragma endregion
+
+        template<typename U>
+        friend class Matrix;
+
     private:
         size_t rows_{0}, cols_{0}; ///< Number of rows and columns
         T **p{nullptr}; /// Pointer to the 2D array holding the matrix
 
+        /// Element count from which whole-matrix loops are split across the OpenMP team
+        static constexpr size_t PARALLEL_THRESHOLD = size_t(1) << 16;
+        /// Side of the square blocks copied by transpose, 32x32 doubles fit in L1 twice
+        static constexpr size_t TRANSPOSE_BLOCK = 32;
+
         void allocSpace();
         void freeSpace();
+
+        /// Whether a reduction keeps an element: never NaN, and finite when finiteOnly
+        static bool keeps(const T& v, bool finiteOnly) {
+            return finiteOnly ? v - v == T{} : v == v;
+        }
     };
 
     /* TEMPLATE IMPLEMENTATION */
 
     /**
      * @brief Allocates memory for the matrix.
+     * Large matrices allocate their rows in static bands across the OpenMP team, so on
+     * NUMA hosts each row is first-touched by the thread that later processes it.
      */
     template<typename T>
     void Matrix<T>::allocSpace() {
@@ -77,6 +125,7 @@ namespace math {
         }
 
         p = new T*[rows_];
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
         for (size_t i = 0; i < rows_; ++i) {
             p[i] = new T[cols_];
         }
@@ -102,6 +151,7 @@ namespace math {
     template<typename T>
     Matrix<T>::Matrix(size_t rows, size_t cols) : rows_(rows), cols_(cols) {
         allocSpace();
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
         for (size_t i = 0; i < rows_; ++i) {
             for (size_t j = 0; j < cols_; ++j) {
                 p[i][j] = T{};
@@ -115,6 +165,7 @@ namespace math {
     template<typename T>
     Matrix<T>::Matrix(size_t rows, size_t cols, const T& initialValue) : rows_(rows), cols_(cols) {
         allocSpace();
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
         for (size_t i = 0; i < rows_; ++i) {
             for (size_t j = 0; j < cols_; ++j) {
                 p[i][j] = initialValue;
@@ -128,6 +179,7 @@ namespace math {
     template<typename T>
     Matrix<T>::Matrix(const T* const* a, size_t rows, size_t cols) : rows_(rows), cols_(cols) {
         allocSpace();
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
         for (size_t i = 0; i < rows_; ++i) {
             for (size_t j = 0; j < cols_; ++j) {
                 p[i][j] = a[i][j];
@@ -149,6 +201,7 @@ namespace math {
     template<typename T>
     Matrix<T>::Matrix(const Matrix& other) : rows_(other.rows_), cols_(other.cols_) {
         allocSpace();
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
         for (size_t i = 0; i < rows_; ++i) {
             for (size_t j = 0; j < cols_; ++j) {
                 p[i][j] = other.p[i][j];
@@ -179,6 +232,7 @@ namespace math {
         rows_ = other.rows_;
         cols_ = other.cols_;
         allocSpace();
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
         for (size_t i = 0; i < rows_; ++i) {
             for (size_t j = 0; j < cols_; ++j) {
                 p[i][j] = other.p[i][j];
@@ -223,13 +277,23 @@ namespace math {
 
     /**
      * @brief Transposes the matrix.
+     * Copies square blocks so the rows read and the rows written both stay in cache; bands of
+     * output rows go to separate threads on large matrices.
      */
     template<typename T>
-    Matrix<T> Matrix<T>::transpose() {
+    Matrix<T> Matrix<T>::transpose() const {
         Matrix<T> transposed(cols_, rows_);
-        for (size_t i = 0; i < rows_; ++i) {
-            for (size_t j = 0; j < cols_; ++j) {
-                transposed.p[j][i] = p[i][j];
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
+        for (size_t jb = 0; jb < cols_; jb += TRANSPOSE_BLOCK) {
+            const size_t jEnd = std::min(cols_, jb + TRANSPOSE_BLOCK);
+            for (size_t ib = 0; ib < rows_; ib += TRANSPOSE_BLOCK) {
+                const size_t iEnd = std::min(rows_, ib + TRANSPOSE_BLOCK);
+                for (size_t j = jb; j < jEnd; ++j) {
+                    T* out = transposed.p[j];
+                    for (size_t i = ib; i < iEnd; ++i) {
+                        out[i] = p[i][j];
+                    }
+                }
             }
         }
         return transposed;
@@ -240,11 +304,112 @@ namespace math {
      */
     template<typename T>
     void Matrix<T>::clear() {
+        fill(T{});
+    }
+
+    /**
+     * @brief Sets all elements to a value.
+     */
+    template<typename T>
+    void Matrix<T>::fill(const T& value) {
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
         for (size_t i = 0; i < rows_; ++i) {
+            T* row = p[i];
+            #pragma omp simd
             for (size_t j = 0; j < cols_; ++j) {
-                p[i][j] = T{};
+                row[j] = value;
+            }
+        }
+    }
+
+    /**
+     * @brief Applies a function to every element, in place.
+     */
+    template<typename T>
+    template<typename F>
+    void Matrix<T>::map(F f) {
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
+        for (size_t i = 0; i < rows_; ++i) {
+            T* row = p[i];
+            #pragma omp simd
+            for (size_t j = 0; j < cols_; ++j) {
+                row[j] = f(row[j]);
+            }
+        }
+    }
+
+    /**
+     * @brief Combines every element with the matching element of another matrix, in place.
+     */
+    template<typename T>
+    template<typename U, typename F>
+    void Matrix<T>::zip(const Matrix<U>& other, F f) {
+        if (other.getRows() != rows_ || other.getCols() != cols_) {
+            throw std::invalid_argument("Matrix dimensions do not match");
+        }
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
+        for (size_t i = 0; i < rows_; ++i) {
+            T* row = p[i];
+            const U* otherRow = other.p[i];
+            #pragma omp simd
+            for (size_t j = 0; j < cols_; ++j) {
+                row[j] = f(row[j], otherRow[j]);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the smallest element kept by the reduction.
+     */
+    template<typename T>
+    T Matrix<T>::min(bool finiteOnly) const {
+        static_assert(std::is_arithmetic<T>::value, "Matrix::min needs an arithmetic type");
+        T result = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+        #pragma omp parallel for schedule(static) reduction(min:result) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
+        for (size_t i = 0; i < rows_; ++i) {
+            const T* row = p[i];
+            #pragma omp simd reduction(min:result)
+            for (size_t j = 0; j < cols_; ++j) {
+                result = keeps(row[j], finiteOnly) && row[j] < result ? row[j] : result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the largest element kept by the reduction.
+     */
+    template<typename T>
+    T Matrix<T>::max(bool finiteOnly) const {
+        static_assert(std::is_arithmetic<T>::value, "Matrix::max needs an arithmetic type");
+        T result = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+        #pragma omp parallel for schedule(static) reduction(max:result) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
+        for (size_t i = 0; i < rows_; ++i) {
+            const T* row = p[i];
+            #pragma omp simd reduction(max:result)
+            for (size_t j = 0; j < cols_; ++j) {
+                result = keeps(row[j], finiteOnly) && row[j] > result ? row[j] : result;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the sum of the elements kept by the reduction.
+     */
+    template<typename T>
+    T Matrix<T>::sum(bool finiteOnly) const {
+        static_assert(std::is_arithmetic<T>::value, "Matrix::sum needs an arithmetic type");
+        T result{};
+        #pragma omp parallel for schedule(static) reduction(+:result) if(rows_ * cols_ >= PARALLEL_THRESHOLD)
+        for (size_t i = 0; i < rows_; ++i) {
+            const T* row = p[i];
+            #pragma omp simd reduction(+:result)
+            for (size_t j = 0; j < cols_; ++j) {
+                result += keeps(row[j], finiteOnly) ? row[j] : T{};
             }
         }
+        return result;
     }
 
     /**
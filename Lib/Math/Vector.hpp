@@ -11,6 +11,8 @@
 #define VECTOR_H
 
 #include <iostream>
+#include <stdexcept>
+#include <utility>
 
 namespace math {
 
@@ -47,6 +49,7 @@ namespace math {
         const T& operator[](size_t index) const;
 
         [[nodiscard]] size_t size() const { return m_size; }
+        [[nodiscard]] size_t capacity() const { return m_capacity; }
 
         #pragma endregion
 
@@ -55,7 +58,9 @@ namespace math {
         void clear();          // set size to 0 and free storage
         bool empty() const;    // true if size == 0
 
-        void append(const T& element);
+        void reserve(size_t capacity);   // grow storage without changing the size
+        void append(const T& element);   // amortized O(1), storage grows geometrically
+        void removeLast();               // O(1), storage is kept
         void insert(size_t index, const T& element);
         void erase(size_t index);
 
@@ -77,6 +82,7 @@ namespace math {
 
     private:
         size_t m_size{0};     ///< The number of elements in the vector.
+        size_t m_capacity{0}; ///< The number of elements the storage can hold.
         T *elements{nullptr};   ///< Array of pointers to objects of type T.
 
         void allocateSpace(size_t n);
@@ -91,6 +97,7 @@ namespace math {
      */
     template<typename T>
     void Vector<T>::allocateSpace(size_t n) {
+        m_capacity = n;
         if (n == 0) {
             elements = nullptr;
             return;
@@ -105,6 +112,7 @@ namespace math {
     void Vector<T>::freeSpace() {
         delete[] elements;
         elements = nullptr;
+        m_capacity = 0;
     }
 
     /**
@@ -137,7 +145,7 @@ namespace math {
      * @brief Default constructor creating an empty vector.
      */
     template<typename T>
-    Vector<T>::Vector() : m_size(0), elements(nullptr) {}
+    Vector<T>::Vector() : m_size(0), m_capacity(0), elements(nullptr) {}
 
     /**
      * @brief Destructor to free allocated memory.
@@ -164,8 +172,9 @@ namespace math {
      * @param other The vector to move from.
      */
     template<typename T>
-    Vector<T>::Vector(Vector&& other) noexcept : m_size(other.m_size), elements(other.elements) {
+    Vector<T>::Vector(Vector&& other) noexcept : m_size(other.m_size), m_capacity(other.m_capacity), elements(other.elements) {
         other.m_size = 0;
+        other.m_capacity = 0;
         other.elements = nullptr;
     }
 
@@ -196,8 +205,10 @@ namespace math {
         if (this == &other) return *this;
         freeSpace();
         m_size = other.m_size;
+        m_capacity = other.m_capacity;
         elements = other.elements;
         other.m_size = 0;
+        other.m_capacity = 0;
         other.elements = nullptr;
         return *this;
     }
@@ -277,22 +288,49 @@ namespace math {
         return m_size == 0;
     }
 
+    /**
+     * @brief Grows the storage to hold at least a number of elements, the size is unchanged.
+     * @param capacity The number of elements to make room for.
+     */
+    template<typename T>
+    void Vector<T>::reserve(size_t capacity) {
+        if (capacity <= m_capacity) return;
+        T* newElements = new T[capacity];
+        for (size_t i = 0; i < m_size; ++i) {
+            newElements[i] = std::move(elements[i]);
+        }
+        delete[] elements;
+        elements = newElements;
+        m_capacity = capacity;
+    }
+
     /**
      * @brief Appends an element to the end of the vector.
+     * The storage doubles when full, so a sequence of appends costs amortized O(1) each.
      * @param element The element to append.
      */
     template<typename T>
     void Vector<T>::append(const T& element) {
-        T* newElements = new T[m_size + 1];
-        for (size_t i = 0; i < m_size; ++i) {
-            newElements[i] = elements[i];
+        if (m_size == m_capacity) {
+            T copy = element;   // element may live in the storage about to be freed
+            reserve(m_capacity == 0 ? 4 : 2 * m_capacity);
+            elements[m_size] = std::move(copy);
+        } else {
+            elements[m_size] = element;
         }
-        newElements[m_size] = element;
-        freeSpace();
-        elements = newElements;
         ++m_size;
     }
 
+    /**
+     * @brief Removes the last element, keeping the storage for later appends.
+     */
+    template<typename T>
+    void Vector<T>::removeLast() {
+        if (m_size == 0) throw std::out_of_range("Vector is empty");
+        --m_size;
+        elements[m_size] = T{};   // release what the element holds
+    }
+
     /**
      * @brief Inserts an element at the specified index.
      * @param index The index to insert the element at.
@@ -311,6 +349,7 @@ namespace math {
         }
         freeSpace();
         elements = newElements;
+        m_capacity = m_size + 1;
         ++m_size;
     }
 
@@ -330,6 +369,7 @@ namespace math {
         }
         freeSpace();
         elements = newElements;
+        m_capacity = m_size - 1;
         --m_size;
     }
 
@@ -11,7 +11,10 @@ namespace math {
     // Defining constants
     constexpr double pi = 3.14159265358979323846;
 
-    inline double square(const double x) { return x * x; }
+    constexpr double square(const double x) noexcept { return x * x; }
+
+    /// std::abs, usable in constant expressions
+    constexpr double absolute(const double x) noexcept { return x < 0.0 ? -x : x; }
 
     inline double triangle_area(const double a, const double b, const double c) {
         double semi_perimeter = (a + b + c) * 0.5;
@@ -0,0 +1,546 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "BroadPhase.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+namespace physics {
+
+    using geometry::Box;
+    using geometry::Circle;
+    using geometry::Sphere;
+
+    namespace {
+
+        /// Bodies aimed at per column of the sweep
+        constexpr double COLUMN_BODIES = 256.0;
+        /// Columns along each of the two axes across the sort axis, at most
+        constexpr int MAX_COLUMNS = 64;
+        /// Pairs gathered per block of the narrow phase
+        constexpr size_t NARROW_BLOCK = 64;
+        /// Swaps allowed to the insertion sort per body before falling back to a full sort
+        constexpr size_t SWAPS_PER_BODY = 8;
+
+        enum PairKind { SPHERE_SPHERE, BOX_BOX, SPHERE_BOX, OTHER, PAIR_KIND_COUNT };
+
+        bool sphereSphere(const Vector3D& c1, double r1, const Vector3D& c2, double r2) {
+            Vector3D d = c2 - c1;
+            return d.dot(d) <= (r1 + r2) * (r1 + r2);
+        }
+
+        bool sphereBox(const Vector3D& c, double r, const Bounds3D& box) {
+            double center[3] = {c.x(), c.y(), c.z()};
+            double distance2 = 0.0;
+            for (int axis = 0; axis < 3; ++axis) {
+                double outside = std::max({box.low[axis] - center[axis], 0.0, center[axis] - box.high[axis]});
+                distance2 += outside * outside;
+            }
+            return distance2 <= r * r;
+        }
+
+        bool circleSphere(const Circle& circle, const Vector3D& c, double r) {
+            const Vector3D& n = circle.getNormal();
+            Vector3D toCenter = c - circle.getCenter();
+            double height = toCenter.dot(n);
+            if (std::fabs(height) > r) {
+                return false;
+            }
+            // Closest point of the disk to the sphere center
+            Vector3D radial = toCenter - n * height;
+            double radialLength = radial.length();
+            Vector3D closest = circle.getCenter();
+            if (radialLength > 0.0) {
+                closest = closest + radial * (std::min(radialLength, circle.getRadius()) / radialLength);
+            }
+            Vector3D d = c - closest;
+            return d.dot(d) <= r * r;
+        }
+
+        // Separating axes of the box faces and of the disk plane, conservative for the edge axes
+        bool circleBox(const Circle& circle, const Bounds3D& box) {
+            if (!BroadPhase::boundsOf(circle).overlaps(box)) {
+                return false;
+            }
+            const Vector3D& n = circle.getNormal();
+            double normal[3] = {n.x(), n.y(), n.z()};
+            double extent = 0.0, offset = 0.0;
+            double center[3] = {circle.getCenter().x(), circle.getCenter().y(), circle.getCenter().z()};
+            for (int axis = 0; axis < 3; ++axis) {
+                double half = 0.5 * (box.high[axis] - box.low[axis]);
+                extent += half * std::fabs(normal[axis]);
+                offset += (0.5 * (box.high[axis] + box.low[axis]) - center[axis]) * normal[axis];
+            }
+            return std::fabs(offset) <= extent;
+        }
+
+        // True if the disk b reaches the plane of the disk a
+        bool diskReachesPlane(const Circle& a, const Circle& b) {
+            double cosine = a.getNormal().dot(b.getNormal());
+            double reach = b.getRadius() * std::sqrt(std::max(0.0, 1.0 - cosine * cosine));
+            return std::fabs((b.getCenter() - a.getCenter()).dot(a.getNormal())) <= reach;
+        }
+
+        bool circleCircle(const Circle& a, const Circle& b) {
+            return sphereSphere(a.getCenter(), a.getRadius(), b.getCenter(), b.getRadius())
+                && diskReachesPlane(a, b) && diskReachesPlane(b, a);
+        }
+
+        Bounds3D boxBounds(const Box& box) {
+            return Bounds3D(box.getMinCorner(), box.getMaxCorner());
+        }
+
+        bool overlapsOrdered(const Box& a, const Box& b) {
+            return boxBounds(a).overlaps(boxBounds(b));
+        }
+        bool overlapsOrdered(const Box& a, const Sphere& b) {
+            return sphereBox(b.getCenter(), b.getRadius(), boxBounds(a));
+        }
+        bool overlapsOrdered(const Box& a, const Circle& b) {
+            return circleBox(b, boxBounds(a));
+        }
+        bool overlapsOrdered(const Sphere& a, const Sphere& b) {
+            return sphereSphere(a.getCenter(), a.getRadius(), b.getCenter(), b.getRadius());
+        }
+        bool overlapsOrdered(const Sphere& a, const Circle& b) {
+            return circleSphere(b, a.getCenter(), a.getRadius());
+        }
+        bool overlapsOrdered(const Circle& a, const Circle& b) {
+            return circleCircle(a, b);
+        }
+
+        template<typename A, typename B>
+        auto overlapsEither(const A& a, const B& b, int) -> decltype(overlapsOrdered(a, b)) {
+            return overlapsOrdered(a, b);
+        }
+        template<typename A, typename B>
+        bool overlapsEither(const A& a, const B& b, long) {
+            return overlapsOrdered(b, a);
+        }
+
+    } // namespace
+
+    // ========== Bounds ==========
+
+    Bounds3D BroadPhase::boundsOf(const BodyShape& shape) {
+        return std::visit([](auto&& geom) {
+            using T = std::decay_t<decltype(geom)>;
+            if constexpr (std::is_same_v<T, Box>) {
+                return boxBounds(geom);
+            } else {
+                Bounds3D bounds;
+                double center[3] = {geom.getCenter().x(), geom.getCenter().y(), geom.getCenter().z()};
+                double extent[3] = {geom.getRadius(), geom.getRadius(), geom.getRadius()};
+                if constexpr (std::is_same_v<T, Circle>) {
+                    // A disk reaches r * sin(angle between the axis and its normal) along each axis
+                    double normal[3] = {geom.getNormal().x(), geom.getNormal().y(), geom.getNormal().z()};
+                    for (int axis = 0; axis < 3; ++axis) {
+                        extent[axis] *= std::sqrt(std::max(0.0, 1.0 - normal[axis] * normal[axis]));
+                    }
+                }
+                for (int axis = 0; axis < 3; ++axis) {
+                    bounds.low[axis] = center[axis] - extent[axis];
+                    bounds.high[axis] = center[axis] + extent[axis];
+                }
+                return bounds;
+            }
+        }, shape);
+    }
+
+    // ========== Bodies ==========
+
+    size_t BroadPhase::addBody(const BodyShape& shape) {
+        size_t id;
+        if (!freeIds.empty()) {
+            id = freeIds[freeIds.size() - 1];
+            freeIds.removeLast();
+        } else {
+            id = bodies.size();
+            bodies.append(Body());
+            bounds.append(Bounds3D());
+        }
+        bodies[id].shape = shape;
+        bounds[id] = boundsOf(shape);
+        bodies[id].alive = true;
+        ++bodyCount;
+        orderValid = false;
+        return id;
+    }
+
+    void BroadPhase::setBody(size_t id, const BodyShape& shape, const Vector3D& displacement) {
+        checkBody(id);
+        bodies[id].shape = shape;
+        bounds[id] = boundsOf(shape).swept(displacement);
+    }
+
+    void BroadPhase::removeBody(size_t id) {
+        checkBody(id);
+        bodies[id].alive = false;
+        freeIds.append(id);
+        --bodyCount;
+        orderValid = false;
+    }
+
+    const BodyShape& BroadPhase::getShape(size_t id) const {
+        checkBody(id);
+        return bodies[id].shape;
+    }
+
+    const Bounds3D& BroadPhase::getBounds(size_t id) const {
+        checkBody(id);
+        return bounds[id];
+    }
+
+    void BroadPhase::checkBody(size_t id) const {
+        if (!containsBody(id)) {
+            throw std::out_of_range("Invalid body id");
+        }
+    }
+
+    // ========== Broad phase ==========
+
+    void BroadPhase::chooseAxis() {
+        // The axis of largest variance of the box centers separates the most bodies
+        const long long n = static_cast<long long>(bodyCount);
+        double sum[3] = {0.0, 0.0, 0.0}, sum2[3] = {0.0, 0.0, 0.0};
+        #pragma omp parallel for reduction(+:sum[:3], sum2[:3]) schedule(static)
+        for (long long id = 0; id < static_cast<long long>(bodies.size()); ++id) {
+            if (!bodies[static_cast<size_t>(id)].alive) {
+                continue;
+            }
+            const Bounds3D& box = bounds[static_cast<size_t>(id)];
+            for (int axis = 0; axis < 3; ++axis) {
+                double center = 0.5 * (box.low[axis] + box.high[axis]);
+                sum[axis] += center;
+                sum2[axis] += center * center;
+            }
+        }
+        int best = 0;
+        double bestVariance = -1.0;
+        for (int axis = 0; axis < 3; ++axis) {
+            double variance = sum2[axis] - sum[axis] * sum[axis] / std::max<double>(1.0, static_cast<double>(n));
+            if (variance > bestVariance) {
+                bestVariance = variance;
+                best = axis;
+            }
+        }
+        if (best != sortAxis) {
+            sortAxis = best;
+            orderValid = false;
+        }
+    }
+
+    void BroadPhase::sortBodies() {
+        // Sort keys next to the ids, so that neither sort chases the bounds of the bodies
+        struct SortKey {
+            double low;
+            uint32_t id;
+        };
+        const int axis = sortAxis;
+        const size_t n = bodyCount;
+        math::Vector<SortKey> keys(n);
+
+        if (orderValid) {
+            for (size_t i = 0; i < n; ++i) {
+                keys[i] = SortKey{bounds[order[i]].low[axis], order[i]};
+            }
+            // Insertion sort repairs the order of coherent motion in O(N + swaps)
+            const size_t budget = SWAPS_PER_BODY * n;
+            size_t swaps = 0;
+            SortKey* key = keys.begin();
+            for (size_t i = 1; i < n && swaps <= budget; ++i) {
+                SortKey moving = key[i];
+                size_t j = i;
+                while (j > 0 && key[j - 1].low > moving.low) {
+                    key[j] = key[j - 1];
+                    --j;
+                }
+                swaps += i - j;
+                key[j] = moving;
+            }
+            if (swaps <= budget) {
+                for (size_t i = 0; i < n; ++i) {
+                    order[i] = key[i].id;
+                }
+                return;
+            }
+        }
+
+        size_t next = 0;
+        for (size_t id = 0; id < bodies.size(); ++id) {
+            if (bodies[id].alive) {
+                keys[next++] = SortKey{bounds[id].low[axis], static_cast<uint32_t>(id)};
+            }
+        }
+        std::sort(keys.begin(), keys.end(), [](const SortKey& a, const SortKey& b) {
+            return a.low < b.low || (a.low == b.low && a.id < b.id);
+        });
+        order = math::Vector<uint32_t>(n);
+        for (size_t i = 0; i < n; ++i) {
+            order[i] = keys[i].id;
+        }
+        orderValid = true;
+        ++fullSortCount;
+    }
+
+    void BroadPhase::buildColumns() {
+        const size_t n = order.size();
+        if (orderedBounds.size() != n) {
+            orderedBounds = math::Vector<Bounds3D>(n);
+        }
+        #pragma omp parallel for schedule(static)
+        for (long long i = 0; i < static_cast<long long>(n); ++i) {
+            orderedBounds.begin()[i] = bounds[order.begin()[i]];
+        }
+
+        // A grid across the sort axis, with cells about twice the mean body size and a few hundred
+        // bodies per column, so that sweeping a column only meets bodies that are close on all axes
+        const int axes[2] = {(sortAxis + 1) % 3, (sortAxis + 2) % 3};
+        double low[2] = {INFINITY, INFINITY}, high[2] = {-INFINITY, -INFINITY}, width[2] = {0.0, 0.0};
+        for (const Bounds3D& box : orderedBounds) {
+            for (int g = 0; g < 2; ++g) {
+                low[g] = std::min(low[g], box.low[axes[g]]);
+                high[g] = std::max(high[g], box.high[axes[g]]);
+                width[g] += box.high[axes[g]] - box.low[axes[g]];
+            }
+        }
+        const double perAxis = std::sqrt(static_cast<double>(n) / COLUMN_BODIES);
+        for (int g = 0; g < 2; ++g) {
+            double extent = high[g] - low[g];
+            columnCount[g] = 1;
+            columnLow[g] = n == 0 ? 0.0 : low[g];
+            columnScale[g] = 1.0;
+            if (n == 0 || !(extent > 0.0)) {
+                continue;
+            }
+            double meanWidth = std::max(width[g] / static_cast<double>(n), extent * 1e-6);
+            double count = std::min({perAxis, extent / (2.0 * meanWidth), static_cast<double>(MAX_COLUMNS)});
+            columnCount[g] = std::max(1, static_cast<int>(count));
+            columnScale[g] = columnCount[g] / extent;
+        }
+
+        // Counting sort of the bodies into every column they overlap, which keeps each column sorted
+        const size_t cells = static_cast<size_t>(columnCount[0]) * static_cast<size_t>(columnCount[1]);
+        columnStart = math::Vector<size_t>(cells + 1);
+        std::fill(columnStart.begin(), columnStart.end(), 0);
+        auto span = [&](const Bounds3D& box, int range[4]) {
+            range[0] = columnOf(0, box.low[axes[0]]);
+            range[1] = columnOf(0, box.high[axes[0]]);
+            range[2] = columnOf(1, box.low[axes[1]]);
+            range[3] = columnOf(1, box.high[axes[1]]);
+        };
+        int range[4];
+        for (const Bounds3D& box : orderedBounds) {
+            span(box, range);
+            for (int c1 = range[2]; c1 <= range[3]; ++c1) {
+                for (int c0 = range[0]; c0 <= range[1]; ++c0) {
+                    ++columnStart[static_cast<size_t>(c1) * columnCount[0] + c0 + 1];
+                }
+            }
+        }
+        for (size_t c = 0; c < cells; ++c) {
+            columnStart[c + 1] += columnStart[c];
+        }
+
+        const size_t entries = columnStart[cells];
+        if (columnIds.size() != entries) {
+            columnIds = math::Vector<uint32_t>(entries);
+            for (int axis = 0; axis < 3; ++axis) {
+                sortedLow[axis] = math::Vector<double>(entries);
+                sortedHigh[axis] = math::Vector<double>(entries);
+            }
+        }
+        math::Vector<size_t> next(cells);
+        std::copy(columnStart.begin(), columnStart.begin() + cells, next.begin());
+        for (size_t i = 0; i < n; ++i) {
+            const Bounds3D& box = orderedBounds[i];
+            span(box, range);
+            for (int c1 = range[2]; c1 <= range[3]; ++c1) {
+                for (int c0 = range[0]; c0 <= range[1]; ++c0) {
+                    size_t entry = next[static_cast<size_t>(c1) * columnCount[0] + c0]++;
+                    columnIds.begin()[entry] = order[i];
+                    for (int axis = 0; axis < 3; ++axis) {
+                        sortedLow[axis].begin()[entry] = box.low[axis];
+                        sortedHigh[axis].begin()[entry] = box.high[axis];
+                    }
+                }
+            }
+        }
+    }
+
+    int BroadPhase::columnOf(int g, double value) const {
+        int column = static_cast<int>((value - columnLow[g]) * columnScale[g]);
+        return std::clamp(column, 0, columnCount[g] - 1);
+    }
+
+    const math::Vector<BodyPair>& BroadPhase::findPairs() {
+        chooseAxis();
+        sortBodies();
+        buildColumns();
+
+        // Sweep each column along the sort axis, the two other axes reject the rest
+        const int a0 = sortAxis, a1 = (sortAxis + 1) % 3, a2 = (sortAxis + 2) % 3;
+        const double* low0 = sortedLow[a0].begin();
+        const double* high0 = sortedHigh[a0].begin();
+        const double* low1 = sortedLow[a1].begin();
+        const double* high1 = sortedHigh[a1].begin();
+        const double* low2 = sortedLow[a2].begin();
+        const double* high2 = sortedHigh[a2].begin();
+        const uint32_t* ids = columnIds.begin();
+
+        const size_t cells = static_cast<size_t>(columnCount[0]) * static_cast<size_t>(columnCount[1]);
+        columnPairs = math::Vector<math::Vector<BodyPair>>(cells);
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (long long cell = 0; cell < static_cast<long long>(cells); ++cell) {
+            math::Vector<BodyPair>& out = columnPairs[static_cast<size_t>(cell)];
+            const int c0 = static_cast<int>(cell % columnCount[0]);
+            const int c1 = static_cast<int>(cell / columnCount[0]);
+            const size_t end = columnStart[static_cast<size_t>(cell) + 1];
+            for (size_t i = columnStart[static_cast<size_t>(cell)]; i < end; ++i) {
+                const double high = high0[i];
+                for (size_t j = i + 1; j < end && low0[j] <= high; ++j) {
+                    if (low1[j] > high1[i] || low1[i] > high1[j] || low2[j] > high2[i] || low2[i] > high2[j]) {
+                        continue;
+                    }
+                    // Pairs sharing several columns are reported by the column of the low corner of their overlap
+                    if (columnOf(0, std::max(low1[i], low1[j])) != c0 || columnOf(1, std::max(low2[i], low2[j])) != c1) {
+                        continue;
+                    }
+                    uint32_t first = ids[i], second = ids[j];
+                    out.append(first < second ? BodyPair{first, second} : BodyPair{second, first});
+                }
+            }
+        }
+
+        size_t total = 0;
+        for (size_t cell = 0; cell < cells; ++cell) {
+            total += columnPairs[cell].size();
+        }
+        pairs = math::Vector<BodyPair>(total);
+        size_t next = 0;
+        for (size_t cell = 0; cell < cells; ++cell) {
+            for (const BodyPair& pair : columnPairs[cell]) {
+                pairs[next++] = pair;
+            }
+        }
+        return pairs;
+    }
+
+    // ========== Narrow phase ==========
+
+    bool BroadPhase::overlaps(const BodyShape& a, const BodyShape& b) {
+        return std::visit([](auto&& first, auto&& second) {
+            return overlapsEither(first, second, 0);
+        }, a, b);
+    }
+
+    size_t BroadPhase::narrowPhase(const math::Vector<BodyPair>& candidates, math::Vector<BodyPair>& contacts) const {
+        const size_t count = candidates.size();
+        math::Vector<uint8_t> touching(count);
+
+        // Group the pairs by kind, so that each block runs one branch free test
+        math::Vector<size_t> byKind[PAIR_KIND_COUNT];
+        for (size_t p = 0; p < count; ++p) {
+            const BodyShape& a = bodies[candidates[p].first].shape;
+            const BodyShape& b = bodies[candidates[p].second].shape;
+            PairKind kind = OTHER;
+            if (a.index() == b.index()) {
+                kind = std::holds_alternative<Sphere>(a) ? SPHERE_SPHERE : std::holds_alternative<Box>(a) ? BOX_BOX : OTHER;
+            } else if (!std::holds_alternative<Circle>(a) && !std::holds_alternative<Circle>(b)) {
+                kind = SPHERE_BOX;
+            }
+            byKind[kind].append(p);
+        }
+
+        for (int kind = 0; kind < PAIR_KIND_COUNT; ++kind) {
+            const math::Vector<size_t>& list = byKind[kind];
+            const long long blockCount = static_cast<long long>((list.size() + NARROW_BLOCK - 1) / NARROW_BLOCK);
+            #pragma omp parallel for schedule(static)
+            for (long long block = 0; block < blockCount; ++block) {
+                const size_t begin = static_cast<size_t>(block) * NARROW_BLOCK;
+                const size_t size = std::min(NARROW_BLOCK, list.size() - begin);
+                const size_t* pairIndices = list.begin() + begin;
+
+                if (kind == OTHER) {
+                    for (size_t k = 0; k < size; ++k) {
+                        const BodyPair& pair = candidates[pairIndices[k]];
+                        touching[pairIndices[k]] = overlaps(bodies[pair.first].shape, bodies[pair.second].shape) ? 1 : 0;
+                    }
+                    continue;
+                }
+
+                // Gather the block as structure of arrays: the center of each side, half extents and a radius
+                alignas(64) double ax[NARROW_BLOCK], ay[NARROW_BLOCK], az[NARROW_BLOCK];
+                alignas(64) double bx[NARROW_BLOCK], by[NARROW_BLOCK], bz[NARROW_BLOCK];
+                alignas(64) double ex[NARROW_BLOCK], ey[NARROW_BLOCK], ez[NARROW_BLOCK];
+                alignas(64) double radius[NARROW_BLOCK];
+                alignas(64) uint8_t result[NARROW_BLOCK];
+                for (size_t k = 0; k < size; ++k) {
+                    const BodyPair& pair = candidates[pairIndices[k]];
+                    const Body* first = &bodies[pair.first];
+                    const Body* second = &bodies[pair.second];
+                    if (kind == SPHERE_BOX && std::holds_alternative<Box>(first->shape)) {
+                        std::swap(first, second);
+                    }
+                    // The shapes at the end of the step, not their swept bounds
+                    const Bounds3D firstBounds = boundsOf(first->shape);
+                    const Bounds3D secondBounds = boundsOf(second->shape);
+                    ax[k] = 0.5 * (firstBounds.low[0] + firstBounds.high[0]);
+                    ay[k] = 0.5 * (firstBounds.low[1] + firstBounds.high[1]);
+                    az[k] = 0.5 * (firstBounds.low[2] + firstBounds.high[2]);
+                    bx[k] = 0.5 * (secondBounds.low[0] + secondBounds.high[0]);
+                    by[k] = 0.5 * (secondBounds.low[1] + secondBounds.high[1]);
+                    bz[k] = 0.5 * (secondBounds.low[2] + secondBounds.high[2]);
+                    if (kind == BOX_BOX) {
+                        // Summed half extents of the boxes
+                        ex[k] = 0.5 * ((firstBounds.high[0] - firstBounds.low[0]) + (secondBounds.high[0] - secondBounds.low[0]));
+                        ey[k] = 0.5 * ((firstBounds.high[1] - firstBounds.low[1]) + (secondBounds.high[1] - secondBounds.low[1]));
+                        ez[k] = 0.5 * ((firstBounds.high[2] - firstBounds.low[2]) + (secondBounds.high[2] - secondBounds.low[2]));
+                        radius[k] = 0.0;
+                    } else if (kind == SPHERE_SPHERE) {
+                        ex[k] = ey[k] = ez[k] = 0.0;
+                        radius[k] = std::get<Sphere>(first->shape).getRadius() + std::get<Sphere>(second->shape).getRadius();
+                    } else {
+                        ex[k] = 0.5 * (secondBounds.high[0] - secondBounds.low[0]);
+                        ey[k] = 0.5 * (secondBounds.high[1] - secondBounds.low[1]);
+                        ez[k] = 0.5 * (secondBounds.high[2] - secondBounds.low[2]);
+                        radius[k] = std::get<Sphere>(first->shape).getRadius();
+                    }
+                }
+
+                // One test for the three kinds: the distance from the first center to a box of half
+                // extents e around the second center, against the radius (zero extents for spheres,
+                // zero radius for boxes)
+                #pragma omp simd
+                for (size_t k = 0; k < size; ++k) {
+                    double dx = std::max(std::fabs(ax[k] - bx[k]) - ex[k], 0.0);
+                    double dy = std::max(std::fabs(ay[k] - by[k]) - ey[k], 0.0);
+                    double dz = std::max(std::fabs(az[k] - bz[k]) - ez[k], 0.0);
+                    result[k] = dx * dx + dy * dy + dz * dz <= radius[k] * radius[k] ? 1 : 0;
+                }
+                for (size_t k = 0; k < size; ++k) {
+                    touching[pairIndices[k]] = result[k];
+                }
+            }
+        }
+
+        size_t contactCount = 0;
+        for (size_t p = 0; p < count; ++p) {
+            contactCount += touching[p];
+        }
+        contacts = math::Vector<BodyPair>(contactCount);
+        size_t next = 0;
+        for (size_t p = 0; p < count; ++p) {
+            if (touching[p]) {
+                contacts[next++] = candidates[p];
+            }
+        }
+        return contactCount;
+    }
+
+} // namespace physics
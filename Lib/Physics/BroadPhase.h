@@ -0,0 +1,164 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef BROAD_PHASE_H
+#define BROAD_PHASE_H
+
+#include "../Geometry/Bounds3D.h"
+#include "../Geometry/Box.h"
+#include "../Geometry/Circle.h"
+#include "../Geometry/Sphere.h"
+#include "../Geometry/Vector3D.h"
+#include "../Math/Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+
+namespace physics {
+
+    using geometry::Bounds3D;
+    using geometry::Vector3D;
+
+    /// The shapes a body can have
+    using BodyShape = std::variant<geometry::Box, geometry::Sphere, geometry::Circle>;
+
+    /**
+     * @struct BodyPair
+     * @brief Two bodies that may touch, first < second.
+     */
+    struct BodyPair {
+        uint32_t first = 0;
+        uint32_t second = 0;
+
+        bool operator==(const BodyPair& other) const { return first == other.first && second == other.second; }
+        bool operator!=(const BodyPair& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @class BroadPhase
+     * @brief Sweep and prune over the bounds of boxes, spheres and circles, with an exact narrow phase.
+     *
+     * Bodies are sorted by the low bound of their box along the axis their centers spread the most
+     * along. A body can then only overlap the bodies that follow it until their low bound passes its
+     * high bound, and the other two axes reject most of those. The order of the previous step is kept
+     * and repaired by insertion sort, which costs O(N) for coherent motion; a full sort takes over when
+     * too many bodies swapped. One sorted axis alone still meets every body of a slab of space, so
+     * the two other axes are cut in a grid of columns, and each body is swept only in the columns its
+     * bounds overlap. Columns are swept in parallel and their pairs concatenated in column order, so
+     * the pairs come out in the same order whatever the number of threads.
+     *
+     * A body can be swept over the motion of a step (setBody with a displacement): its box then covers
+     * its start and end positions, so fast bodies are paired with what they pass through between two
+     * steps, for a continuous narrow phase.
+     *
+     * The narrow phase tests the shapes of candidate pairs exactly, except circle against circle and
+     * circle against box which are conservative (separating axes of the planes and box faces only).
+     * Pairs are grouped by kind and tested in blocks of structure of arrays that the compiler vectorizes.
+     */
+    class BroadPhase {
+    public:
+        /**
+         * @brief Add a body
+         * @param shape The shape of the body
+         * @return The id of the body, stable until it is removed, then reused
+         */
+        size_t addBody(const BodyShape& shape);
+
+        /**
+         * @brief Move or reshape a body
+         * @param id The id of the body
+         * @param shape The new shape, at the end of the step
+         * @param displacement The motion over the step, the bounds then cover the whole motion
+         * @throws std::out_of_range if id is not a body
+         */
+        void setBody(size_t id, const BodyShape& shape, const Vector3D& displacement = Vector3D(0, 0, 0));
+
+        /**
+         * @brief Remove a body
+         * @param id The id of the body
+         * @throws std::out_of_range if id is not a body
+         */
+        void removeBody(size_t id);
+
+        /**
+         * @brief Compute the bounds of a body shape
+         * @param shape The shape
+         * @return The smallest box around the shape
+         */
+        static Bounds3D boundsOf(const BodyShape& shape);
+
+        const BodyShape& getShape(size_t id) const;
+        const Bounds3D& getBounds(size_t id) const;
+        bool containsBody(size_t id) const { return id < bodies.size() && bodies[id].alive; }
+        size_t getBodyCount() const { return bodyCount; }
+
+        /**
+         * @brief Find the pairs of bodies whose bounds overlap
+         * @return The candidate pairs, valid until the next call
+         */
+        const math::Vector<BodyPair>& findPairs();
+
+        /**
+         * @brief Keep the candidate pairs whose shapes overlap
+         * @param candidates Pairs returned by findPairs
+         * @param contacts Output, the pairs in contact, in the order of candidates
+         * @return The number of pairs in contact
+         */
+        size_t narrowPhase(const math::Vector<BodyPair>& candidates, math::Vector<BodyPair>& contacts) const;
+
+        /**
+         * @brief Test two shapes for contact, as the narrow phase does
+         * @param a The first shape
+         * @param b The second shape
+         * @return True if the shapes overlap, or may for circles against circles or boxes
+         */
+        static bool overlaps(const BodyShape& a, const BodyShape& b);
+
+        int getSortAxis() const { return sortAxis; }
+        size_t getFullSortCount() const { return fullSortCount; }
+
+    private:
+        /// Shape of one body
+        struct Body {
+            BodyShape shape = geometry::Sphere(Vector3D(0, 0, 0), 1.0);
+            bool alive = false;
+        };
+
+        math::Vector<Body> bodies;
+        math::Vector<Bounds3D> bounds;      ///< Bounds of each body, apart from the shapes for the sweep
+        size_t bodyCount = 0;
+        math::Vector<size_t> freeIds;
+
+        math::Vector<uint32_t> order;       ///< Live bodies sorted by low bound along sortAxis
+        bool orderValid = false;            ///< False after bodies were added or removed
+        int sortAxis = 0;
+        size_t fullSortCount = 0;
+
+        math::Vector<Bounds3D> orderedBounds; ///< Bounds of the bodies of order
+
+        // Grid of columns across the sort axis
+        int columnCount[2] = {1, 1};
+        double columnLow[2] = {0.0, 0.0};
+        double columnScale[2] = {1.0, 1.0};    ///< Columns per unit of length
+        math::Vector<size_t> columnStart;   ///< First entry of each column in columnIds, and the end
+        math::Vector<uint32_t> columnIds;   ///< Bodies of each column, in sorted order
+
+        // Bounds of the entries of columnIds, one array per axis and side
+        math::Vector<double> sortedLow[3];
+        math::Vector<double> sortedHigh[3];
+
+        math::Vector<math::Vector<BodyPair>> columnPairs;  ///< Pairs found in each column
+        math::Vector<BodyPair> pairs;
+
+        void checkBody(size_t id) const;
+        void chooseAxis();
+        void sortBodies();
+        void buildColumns();
+        int columnOf(int g, double value) const;
+    };
+
+} // namespace physics
+
+#endif // BROAD_PHASE_H
@@ -0,0 +1,267 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "Integrator.h"
+
+#include <omp.h>
+#include <cmath>
+#include <stdexcept>
+
+namespace physics {
+
+    Integrator::Integrator(IntegrationMethod method) : method(method) {}
+
+    size_t Integrator::addBody(const Vector3D& position, const Vector3D& velocity, double mass,
+                               const Quaternion& orientation) {
+        if (mass < 0.0) {
+            throw std::invalid_argument("Mass must not be negative");
+        }
+        Quaternion unit = orientation.normalize();
+        px.append(position.x()); py.append(position.y()); pz.append(position.z());
+        vx.append(velocity.x()); vy.append(velocity.y()); vz.append(velocity.z());
+        fx.append(0.0); fy.append(0.0); fz.append(0.0);
+        inverseMass.append(mass > 0.0 ? 1.0 / mass : 0.0);
+        drag.append(0.0);
+        qw.append(unit.w()); qx.append(unit.x()); qy.append(unit.y()); qz.append(unit.z());
+        wx.append(0.0); wy.append(0.0); wz.append(0.0);
+        tx.append(0.0); ty.append(0.0); tz.append(0.0);
+        // A solid sphere of radius 1 until told otherwise
+        inverseInertia.append(mass > 0.0 ? 1.0 / (0.4 * mass) : 0.0);
+        return count++;
+    }
+
+    void Integrator::setDrag(size_t id, double dragCoefficient, double area) {
+        checkBody(id);
+        if (dragCoefficient < 0.0 || area < 0.0) {
+            throw std::invalid_argument("Drag coefficient and area must not be negative");
+        }
+        drag[id] = 0.5 * dragCoefficient * area;
+    }
+
+    void Integrator::setInertia(size_t id, double inertia) {
+        checkBody(id);
+        if (inertia < 0.0) {
+            throw std::invalid_argument("Inertia must not be negative");
+        }
+        inverseInertia[id] = inertia > 0.0 ? 1.0 / inertia : 0.0;
+    }
+
+    void Integrator::applyForce(size_t id, const Vector3D& force) {
+        checkBody(id);
+        fx[id] += force.x();
+        fy[id] += force.y();
+        fz[id] += force.z();
+    }
+
+    void Integrator::applyTorque(size_t id, const Vector3D& torque) {
+        checkBody(id);
+        tx[id] += torque.x();
+        ty[id] += torque.y();
+        tz[id] += torque.z();
+    }
+
+    void Integrator::setAirDensity(double density) {
+        if (density < 0.0) {
+            throw std::invalid_argument("Air density must not be negative");
+        }
+        airDensity = density;
+    }
+
+    // ========== Stepping ==========
+
+    void Integrator::step(double dt) {
+        if (!(dt > 0.0)) {
+            throw std::invalid_argument("Time step must be positive");
+        }
+        stepLinear(dt);
+        stepAngular(dt);
+        clearForces();
+    }
+
+    void Integrator::stepLinear(double dt) {
+        const long long n = static_cast<long long>(count);
+        double* __restrict x = px.begin();
+        double* __restrict y = py.begin();
+        double* __restrict z = pz.begin();
+        double* __restrict u = vx.begin();
+        double* __restrict v = vy.begin();
+        double* __restrict w = vz.begin();
+        const double* __restrict forceX = fx.begin();
+        const double* __restrict forceY = fy.begin();
+        const double* __restrict forceZ = fz.begin();
+        const double* __restrict im = inverseMass.begin();
+        const double* __restrict k = drag.begin();
+        const double gx = gravity.x(), gy = gravity.y(), gz = gravity.z();
+        const double rho = airDensity;
+
+        if (method == IntegrationMethod::SEMI_IMPLICIT_EULER) {
+            #pragma omp parallel for simd schedule(static)
+            for (long long i = 0; i < n; ++i) {
+                // Static bodies feel no gravity either
+                const double g = im[i] > 0.0 ? 1.0 : 0.0;
+                const double ax = g * gx + forceX[i] * im[i];
+                const double ay = g * gy + forceY[i] * im[i];
+                const double az = g * gz + forceZ[i] * im[i];
+                // Drag linearized at the current speed and taken implicitly, so that a large step
+                // slows a fast body down to rest at most, it never turns it around
+                const double speed = std::sqrt(u[i] * u[i] + v[i] * v[i] + w[i] * w[i]);
+                const double damping = 1.0 / (1.0 + rho * k[i] * speed * im[i] * dt);
+                u[i] = (u[i] + ax * dt) * damping;
+                v[i] = (v[i] + ay * dt) * damping;
+                w[i] = (w[i] + az * dt) * damping;
+                x[i] += u[i] * dt;
+                y[i] += v[i] * dt;
+                z[i] += w[i] * dt;
+            }
+        } else {
+            const double halfDt2 = 0.5 * dt * dt;
+            #pragma omp parallel for simd schedule(static)
+            for (long long i = 0; i < n; ++i) {
+                const double g = im[i] > 0.0 ? 1.0 : 0.0;
+                const double cx = g * gx + forceX[i] * im[i];
+                const double cy = g * gy + forceY[i] * im[i];
+                const double cz = g * gz + forceZ[i] * im[i];
+                const double dragFactor = rho * k[i] * im[i];
+
+                // Acceleration at the start of the step
+                const double speed0 = std::sqrt(u[i] * u[i] + v[i] * v[i] + w[i] * w[i]);
+                const double ax0 = cx - dragFactor * speed0 * u[i];
+                const double ay0 = cy - dragFactor * speed0 * v[i];
+                const double az0 = cz - dragFactor * speed0 * w[i];
+                x[i] += u[i] * dt + ax0 * halfDt2;
+                y[i] += v[i] * dt + ay0 * halfDt2;
+                z[i] += w[i] * dt + az0 * halfDt2;
+
+                // Acceleration at the end, drag taken at the predicted velocity
+                const double pu = u[i] + ax0 * dt;
+                const double pv = v[i] + ay0 * dt;
+                const double pw = w[i] + az0 * dt;
+                const double speed1 = std::sqrt(pu * pu + pv * pv + pw * pw);
+                const double ax1 = cx - dragFactor * speed1 * pu;
+                const double ay1 = cy - dragFactor * speed1 * pv;
+                const double az1 = cz - dragFactor * speed1 * pw;
+                u[i] += 0.5 * (ax0 + ax1) * dt;
+                v[i] += 0.5 * (ay0 + ay1) * dt;
+                w[i] += 0.5 * (az0 + az1) * dt;
+            }
+        }
+    }
+
+    void Integrator::stepAngular(double dt) {
+        const long long n = static_cast<long long>(count);
+        double* __restrict qa = qw.begin();
+        double* __restrict qb = qx.begin();
+        double* __restrict qc = qy.begin();
+        double* __restrict qd = qz.begin();
+        double* __restrict a = wx.begin();
+        double* __restrict b = wy.begin();
+        double* __restrict c = wz.begin();
+        const double* __restrict torqueX = tx.begin();
+        const double* __restrict torqueY = ty.begin();
+        const double* __restrict torqueZ = tz.begin();
+        const double* __restrict ii = inverseInertia.begin();
+        const double halfDt = 0.5 * dt;
+
+        #pragma omp parallel for simd schedule(static)
+        for (long long i = 0; i < n; ++i) {
+            a[i] += torqueX[i] * ii[i] * dt;
+            b[i] += torqueY[i] * ii[i] * dt;
+            c[i] += torqueZ[i] * ii[i] * dt;
+
+            // dq/dt = (0, w) * q / 2, with w the angular velocity in world space
+            const double w0 = qa[i], x0 = qb[i], y0 = qc[i], z0 = qd[i];
+            double w1 = w0 + halfDt * (-a[i] * x0 - b[i] * y0 - c[i] * z0);
+            double x1 = x0 + halfDt * (a[i] * w0 + b[i] * z0 - c[i] * y0);
+            double y1 = y0 + halfDt * (b[i] * w0 + c[i] * x0 - a[i] * z0);
+            double z1 = z0 + halfDt * (c[i] * w0 + a[i] * y0 - b[i] * x0);
+            const double scale = 1.0 / std::sqrt(w1 * w1 + x1 * x1 + y1 * y1 + z1 * z1);
+            qa[i] = w1 * scale;
+            qb[i] = x1 * scale;
+            qc[i] = y1 * scale;
+            qd[i] = z1 * scale;
+        }
+    }
+
+    void Integrator::clearForces() {
+        const long long n = static_cast<long long>(count);
+        #pragma omp parallel for simd schedule(static)
+        for (long long i = 0; i < n; ++i) {
+            fx.begin()[i] = 0.0; fy.begin()[i] = 0.0; fz.begin()[i] = 0.0;
+            tx.begin()[i] = 0.0; ty.begin()[i] = 0.0; tz.begin()[i] = 0.0;
+        }
+    }
+
+    // ========== World sync ==========
+
+    void Integrator::attach(size_t id, rendering::World::ObjectHandle handle) {
+        checkBody(id);
+        attachedBodies.append(id);
+        attachedObjects.append(handle);
+        syncedPositions.append(getPosition(id));
+    }
+
+    size_t Integrator::syncWorld(rendering::World& world) {
+        size_t moved = 0;
+        for (size_t a = 0; a < attachedBodies.size(); ++a) {
+            Vector3D position = getPosition(attachedBodies[a]);
+            if (position == syncedPositions[a]) {
+                continue;
+            }
+            world.moveObject(attachedObjects[a], position - syncedPositions[a]);
+            syncedPositions[a] = position;
+            ++moved;
+        }
+        return moved;
+    }
+
+    // ========== Accessors ==========
+
+    Vector3D Integrator::getPosition(size_t id) const {
+        checkBody(id);
+        return Vector3D(px[id], py[id], pz[id]);
+    }
+
+    Vector3D Integrator::getVelocity(size_t id) const {
+        checkBody(id);
+        return Vector3D(vx[id], vy[id], vz[id]);
+    }
+
+    Vector3D Integrator::getAngularVelocity(size_t id) const {
+        checkBody(id);
+        return Vector3D(wx[id], wy[id], wz[id]);
+    }
+
+    Quaternion Integrator::getOrientation(size_t id) const {
+        checkBody(id);
+        return Quaternion(qw[id], qx[id], qy[id], qz[id]);
+    }
+
+    void Integrator::setPosition(size_t id, const Vector3D& position) {
+        checkBody(id);
+        px[id] = position.x();
+        py[id] = position.y();
+        pz[id] = position.z();
+    }
+
+    void Integrator::setVelocity(size_t id, const Vector3D& velocity) {
+        checkBody(id);
+        vx[id] = velocity.x();
+        vy[id] = velocity.y();
+        vz[id] = velocity.z();
+    }
+
+    void Integrator::setAngularVelocity(size_t id, const Vector3D& angularVelocity) {
+        checkBody(id);
+        wx[id] = angularVelocity.x();
+        wy[id] = angularVelocity.y();
+        wz[id] = angularVelocity.z();
+    }
+
+    void Integrator::checkBody(size_t id) const {
+        if (id >= count) {
+            throw std::out_of_range("Invalid body id");
+        }
+    }
+
+} // namespace physics
@@ -0,0 +1,166 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef INTEGRATOR_H
+#define INTEGRATOR_H
+
+#include "../Geometry/Quaternion.h"
+#include "../Geometry/Vector3D.h"
+#include "../Math/Vector.hpp"
+#include "../Rendering/World.h"
+
+#include <cstddef>
+
+namespace physics {
+
+    using geometry::Quaternion;
+    using geometry::Vector3D;
+
+    /**
+     * @brief The stepping schemes of the integrator
+     */
+    enum class IntegrationMethod {
+        SEMI_IMPLICIT_EULER,   ///< Velocity first, then position with the new velocity
+        VELOCITY_VERLET        ///< Second order, forces evaluated at both ends of the step
+    };
+
+    /**
+     * @class Integrator
+     * @brief Rigid bodies and particles stepped under gravity, drag and applied forces.
+     *
+     * Bodies are stored as structure of arrays: one array per component of the positions, velocities,
+     * forces, orientations and angular velocities, so a step is a few loops over contiguous doubles
+     * that the compiler vectorizes and OpenMP splits across threads.
+     *
+     * Drag is quadratic, F = -airDensity * drag * |v| * v with drag = Cd * A / 2, the model of a
+     * falling body or an open parachute. Bodies turn at a constant angular velocity unless a torque
+     * is applied, with an isotropic inertia.
+     *
+     * Bodies can be attached to objects of a World; syncWorld then moves the objects to the bodies,
+     * skipping the bodies at rest, so that simulation and rendering can be interleaved. Only the
+     * translation is synced, the shapes of a World are not rotated.
+     */
+    class Integrator {
+    public:
+        explicit Integrator(IntegrationMethod method = IntegrationMethod::SEMI_IMPLICIT_EULER);
+
+        /**
+         * @brief Add a body
+         * @param position The position of the center of mass
+         * @param velocity The initial velocity
+         * @param mass The mass, infinite (0 inverse mass) for static bodies if 0
+         * @param orientation The initial orientation
+         * @return The id of the body
+         * @throws std::invalid_argument if mass is negative
+         */
+        size_t addBody(const Vector3D& position, const Vector3D& velocity, double mass,
+                       const Quaternion& orientation = Quaternion::identity());
+
+        /**
+         * @brief Set the drag of a body, e.g. when its parachute opens
+         * @param id The id of the body
+         * @param dragCoefficient The drag coefficient Cd (about 1.3 for a parachute, 0.47 for a sphere)
+         * @param area The reference area facing the motion
+         * @throws std::out_of_range if id is not a body
+         * @throws std::invalid_argument if dragCoefficient or area is negative
+         */
+        void setDrag(size_t id, double dragCoefficient, double area);
+
+        /**
+         * @brief Set the inertia of a body, the same around every axis
+         * @param id The id of the body
+         * @param inertia The moment of inertia, infinite if 0
+         * @throws std::out_of_range if id is not a body
+         * @throws std::invalid_argument if inertia is negative
+         */
+        void setInertia(size_t id, double inertia);
+
+        /**
+         * @brief Apply a force through the center of mass for the next step
+         * @param id The id of the body
+         * @param force The force, accumulated until the next step
+         * @throws std::out_of_range if id is not a body
+         */
+        void applyForce(size_t id, const Vector3D& force);
+
+        /**
+         * @brief Apply a torque for the next step
+         * @param id The id of the body
+         * @param torque The torque, accumulated until the next step
+         * @throws std::out_of_range if id is not a body
+         */
+        void applyTorque(size_t id, const Vector3D& torque);
+
+        /**
+         * @brief Advance every body
+         * @param dt The time step, in seconds
+         * @throws std::invalid_argument if dt is not positive
+         */
+        void step(double dt);
+
+        /**
+         * @brief Attach a body to an object of a world, moved by syncWorld
+         * @param id The id of the body
+         * @param handle The object, taken to be at the body position when attached
+         * @throws std::out_of_range if id is not a body
+         */
+        void attach(size_t id, rendering::World::ObjectHandle handle);
+
+        /**
+         * @brief Move the attached objects of a world by the motion of their bodies since the last sync
+         * @param world The world of the attached objects
+         * @return The number of objects moved
+         * @throws std::out_of_range if an attached object was removed from the world
+         */
+        size_t syncWorld(rendering::World& world);
+
+        Vector3D getPosition(size_t id) const;
+        Vector3D getVelocity(size_t id) const;
+        Vector3D getAngularVelocity(size_t id) const;
+        Quaternion getOrientation(size_t id) const;
+        void setPosition(size_t id, const Vector3D& position);
+        void setVelocity(size_t id, const Vector3D& velocity);
+        void setAngularVelocity(size_t id, const Vector3D& angularVelocity);
+
+        size_t getBodyCount() const { return count; }
+        IntegrationMethod getMethod() const { return method; }
+        void setMethod(IntegrationMethod newMethod) { method = newMethod; }
+        const Vector3D& getGravity() const { return gravity; }
+        void setGravity(const Vector3D& newGravity) { gravity = newGravity; }
+        double getAirDensity() const { return airDensity; }
+        void setAirDensity(double density);
+
+    private:
+        IntegrationMethod method;
+        Vector3D gravity = Vector3D(0, -9.81, 0);
+        double airDensity = 1.225;     ///< kg/m^3, air at sea level
+        size_t count = 0;
+
+        // Linear state, one array per component
+        math::Vector<double> px, py, pz;
+        math::Vector<double> vx, vy, vz;
+        math::Vector<double> fx, fy, fz;
+        math::Vector<double> inverseMass;
+        math::Vector<double> drag;              ///< Cd * A / 2
+
+        // Angular state
+        math::Vector<double> qw, qx, qy, qz;
+        math::Vector<double> wx, wy, wz;
+        math::Vector<double> tx, ty, tz;
+        math::Vector<double> inverseInertia;
+
+        // Objects of a world following the bodies
+        math::Vector<size_t> attachedBodies;
+        math::Vector<rendering::World::ObjectHandle> attachedObjects;
+        math::Vector<Vector3D> syncedPositions;
+
+        void checkBody(size_t id) const;
+        void stepLinear(double dt);
+        void stepAngular(double dt);
+        void clearForces();
+    };
+
+} // namespace physics
+
+#endif // INTEGRATOR_H
@@ -0,0 +1,339 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "SweptSphere.h"
+#include "../Geometry/Ray.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace physics {
+
+    using geometry::Box;
+    using geometry::Circle;
+    using geometry::Plane;
+    using geometry::Ray;
+    using geometry::Rectangle;
+    using geometry::Sphere;
+
+    namespace {
+
+        /// Newton steps of the advancement before giving up on a grazing motion
+        constexpr int MAX_ADVANCE_STEPS = 64;
+        /// Gap at which the sphere touches, relative to its radius
+        constexpr double CONTACT_TOLERANCE = 1e-9;
+
+        Vector3D unitOr(const Vector3D& v, const Vector3D& fallback) {
+            double length = v.length();
+            return length > 0.0 ? v / length : fallback;
+        }
+
+        Vector3D closestOnPlane(const Plane& plane, const Vector3D& p) {
+            return p - plane.getNormal() * (p - plane.getOrigin()).dot(plane.getNormal());
+        }
+
+        Vector3D closestOnDisk(const Circle& circle, const Vector3D& p) {
+            const Vector3D& n = circle.getNormal();
+            Vector3D radial = p - n * (p - circle.getCenter()).dot(n) - circle.getCenter();
+            double length = radial.length();
+            if (length > circle.getRadius()) {
+                radial = radial * (circle.getRadius() / length);
+            }
+            return circle.getCenter() + radial;
+        }
+
+        Vector3D closestInBox(const Box& box, const Vector3D& p) {
+            Vector3D low = box.getMinCorner(), high = box.getMaxCorner();
+            return Vector3D(std::clamp(p.x(), low.x(), high.x()),
+                            std::clamp(p.y(), low.y(), high.y()),
+                            std::clamp(p.z(), low.z(), high.z()));
+        }
+
+        /// The side of a flat shape the motion starts on, as its normal or the opposite
+        Vector3D facingNormal(const Vector3D& normal, const Vector3D& onSurface, const Vector3D& start) {
+            return (start - onSurface).dot(normal) < 0.0 ? -normal : normal;
+        }
+
+        SweepHit makeHit(double time, const Vector3D& normal, const Vector3D& point) {
+            SweepHit hit;
+            hit.time = time;
+            hit.normal = normal;
+            hit.point = point;
+            return hit;
+        }
+
+        /**
+         * Advance the sphere along its motion by Newton steps on its gap to a convex shape. The gap
+         * is convex in time, so each step lands before the first contact, and a gap that stops
+         * shrinking never closes.
+         */
+        template<typename ClosestPoint>
+        std::optional<SweepHit> advance(const SweptSphere& sphere, double fromTime, const Vector3D& fallbackNormal,
+                                        ClosestPoint closest) {
+            const Vector3D motion = sphere.getEnd() - sphere.getStart();
+            const double tolerance = CONTACT_TOLERANCE * std::max(1.0, sphere.getRadius());
+            double time = fromTime;
+            for (int stepCount = 0; stepCount < MAX_ADVANCE_STEPS; ++stepCount) {
+                Vector3D center = sphere.getCenterAt(time);
+                Vector3D point = closest(center);
+                Vector3D offset = center - point;
+                double distance = offset.length();
+                double gap = distance - sphere.getRadius();
+                if (gap <= tolerance) {
+                    return makeHit(time, unitOr(offset, fallbackNormal), point);
+                }
+                double rate = motion.dot(offset) / distance;
+                if (rate >= 0.0) {
+                    return std::nullopt;
+                }
+                time -= gap / rate;
+                if (time > 1.0) {
+                    return std::nullopt;
+                }
+            }
+            return std::nullopt;
+        }
+
+        /// The hit at time 0 of a sphere that starts in contact
+        template<typename ClosestPoint>
+        std::optional<SweepHit> startContact(const SweptSphere& sphere, const Vector3D& fallbackNormal, ClosestPoint closest) {
+            Vector3D point = closest(sphere.getStart());
+            Vector3D offset = sphere.getStart() - point;
+            if (offset.length() > sphere.getRadius()) {
+                return std::nullopt;
+            }
+            return makeHit(0.0, unitOr(offset, fallbackNormal), point);
+        }
+
+    } // namespace
+
+    SweptSphere::SweptSphere() : start(0, 0, 0), end(0, 0, 0), radius(1.0) {}
+
+    SweptSphere::SweptSphere(const Vector3D& start, const Vector3D& end, double radius)
+        : start(start), end(end), radius(radius) {
+        if (!(radius > 0.0)) {
+            throw std::invalid_argument("Radius must be positive");
+        }
+    }
+
+    std::optional<SweepHit> SweptSphere::sweep(const Plane& plane) const {
+        const Vector3D normal = facingNormal(plane.getNormal(), plane.getOrigin(), start);
+        auto closest = [&](const Vector3D& p) { return closestOnPlane(plane, p); };
+        if (auto hit = startContact(*this, normal, closest)) {
+            return hit;
+        }
+        const double length = (end - start).length();
+        if (length == 0.0) {
+            return std::nullopt;
+        }
+        // The plane moved toward the sphere by its radius
+        Plane shifted(plane.getOrigin() + normal * radius, plane.getNormal());
+        std::optional<double> depth = shifted.rayIntersectDepth(Ray(start, end - start), length);
+        if (!depth) {
+            return std::nullopt;
+        }
+        double time = *depth / length;
+        return makeHit(time, normal, getCenterAt(time) - normal * radius);
+    }
+
+    std::optional<SweepHit> SweptSphere::sweep(const Rectangle& rectangle) const {
+        const Vector3D normal = facingNormal(rectangle.getNormal(), rectangle.getOrigin(), start);
+        auto closest = [&](const Vector3D& p) { return rectangle.closestPointOnRectangle(p); };
+        if (auto hit = startContact(*this, normal, closest)) {
+            return hit;
+        }
+        const double length = (end - start).length();
+        if (length == 0.0) {
+            return std::nullopt;
+        }
+        // The face moved toward the sphere by its radius, then the rounded edges. A sphere starting
+        // closer to the plane than its radius is already past that face, it can only reach an edge
+        if ((start - rectangle.getOrigin()).dot(normal) > radius) {
+            Rectangle shifted = rectangle.translate(normal * radius);
+            if (std::optional<double> depth = shifted.rayIntersectDepth(Ray(start, end - start), length)) {
+                double time = *depth / length;
+                return makeHit(time, normal, getCenterAt(time) - normal * radius);
+            }
+        }
+        return advance(*this, 0.0, normal, closest);
+    }
+
+    std::optional<SweepHit> SweptSphere::sweep(const Circle& circle) const {
+        const Vector3D normal = facingNormal(circle.getNormal(), circle.getCenter(), start);
+        auto closest = [&](const Vector3D& p) { return closestOnDisk(circle, p); };
+        if (auto hit = startContact(*this, normal, closest)) {
+            return hit;
+        }
+        const double length = (end - start).length();
+        if (length == 0.0) {
+            return std::nullopt;
+        }
+        // The disk moved toward the sphere by its radius, then the rounded rim
+        if ((start - circle.getCenter()).dot(normal) > radius) {
+            Circle shifted(circle.getCenter() + normal * radius, circle.getRadius(), circle.getNormal());
+            if (std::optional<double> depth = shifted.rayIntersectDepth(Ray(start, end - start), length)) {
+                double time = *depth / length;
+                return makeHit(time, normal, getCenterAt(time) - normal * radius);
+            }
+        }
+        return advance(*this, 0.0, normal, closest);
+    }
+
+    std::optional<SweepHit> SweptSphere::sweep(const Box& box) const {
+        const Vector3D fallback = unitOr(start - end, Vector3D(0, 0, 1));
+        auto closest = [&](const Vector3D& p) { return closestInBox(box, p); };
+        if (auto hit = startContact(*this, fallback, closest)) {
+            return hit;
+        }
+        const double length = (end - start).length();
+        if (length == 0.0) {
+            return std::nullopt;
+        }
+
+        // The box grown by the radius holds the rounded box the center must enter
+        const Vector3D low = box.getMinCorner(), high = box.getMaxCorner();
+        const Vector3D margin(radius, radius, radius);
+        Box grown(low - margin, box.getWidth() + 2.0 * radius, box.getHeight() + 2.0 * radius,
+                  box.getDepth() + 2.0 * radius, box.getNormal());
+        double entry = 0.0;
+        const Vector3D grownLow = low - margin, grownHigh = high + margin;
+        bool startsInside = start.x() > grownLow.x() && start.x() < grownHigh.x()
+                         && start.y() > grownLow.y() && start.y() < grownHigh.y()
+                         && start.z() > grownLow.z() && start.z() < grownHigh.z();
+        if (!startsInside) {
+            std::optional<double> depth = grown.rayIntersectDepth(Ray(start, end - start), length);
+            if (!depth) {
+                return std::nullopt;
+            }
+            entry = *depth / length;
+
+            // Entering through a face, away from the edges, is the contact
+            Vector3D center = getCenterAt(entry);
+            const double tolerance = CONTACT_TOLERANCE * std::max(1.0, radius);
+            double c[3] = {center.x(), center.y(), center.z()};
+            double l[3] = {low.x(), low.y(), low.z()};
+            double h[3] = {high.x(), high.y(), high.z()};
+            int outside = 0, axis = 0;
+            for (int a = 0; a < 3; ++a) {
+                if (c[a] < l[a] - tolerance || c[a] > h[a] + tolerance) {
+                    ++outside;
+                    axis = a;
+                }
+            }
+            if (outside == 1) {
+                double n[3] = {0.0, 0.0, 0.0};
+                n[axis] = c[axis] > h[axis] ? 1.0 : -1.0;
+                return makeHit(entry, Vector3D(n[0], n[1], n[2]), closest(center));
+            }
+        }
+        return advance(*this, entry, fallback, closest);
+    }
+
+    std::optional<SweepHit> SweptSphere::sweep(const Sphere& sphere) const {
+        const Vector3D fallback = unitOr(start - end, Vector3D(0, 0, 1));
+        Vector3D offset = start - sphere.getCenter();
+        if (offset.length() <= sphere.getRadius() + radius) {
+            Vector3D normal = unitOr(offset, fallback);
+            return makeHit(0.0, normal, sphere.getCenter() + normal * sphere.getRadius());
+        }
+        const double length = (end - start).length();
+        if (length == 0.0) {
+            return std::nullopt;
+        }
+        // The sphere grown by the radius
+        Sphere grown(sphere.getCenter(), sphere.getRadius() + radius);
+        std::optional<double> depth = grown.rayIntersectDepth(Ray(start, end - start), length);
+        if (!depth) {
+            return std::nullopt;
+        }
+        double time = std::min(1.0, *depth / length);
+        Vector3D normal = unitOr(getCenterAt(time) - sphere.getCenter(), fallback);
+        return makeHit(time, normal, sphere.getCenter() + normal * sphere.getRadius());
+    }
+
+    std::optional<SweepHit> SweptSphere::sweep(const SweepTarget& target) const {
+        return std::visit([this](auto&& geom) { return sweep(geom); }, target);
+    }
+
+    // ========== Batch ==========
+
+    size_t SweptSphere::sweepAll(const math::Vector<SweptSphere>& spheres,
+                                 const math::Vector<rendering::Camera::ShapeVariant>& shapes,
+                                 math::Vector<SweepHit>& hits) {
+        // Bounds of the objects, planes are unbounded and empty shapes are skipped
+        const size_t shapeCount = shapes.size();
+        math::Vector<double> bounds(6 * shapeCount);
+        math::Vector<uint8_t> present(shapeCount);
+        const double infinity = std::numeric_limits<double>::infinity();
+        for (size_t t = 0; t < shapeCount; ++t) {
+            Vector3D low(-infinity, -infinity, -infinity), high(infinity, infinity, infinity);
+            present[t] = std::visit([&](auto&& shape) {
+                using T = std::decay_t<decltype(*shape.getGeometry())>;
+                const T* geom = shape.getGeometry();
+                if (geom == nullptr) {
+                    return 0;
+                }
+                if constexpr (std::is_same_v<T, Rectangle>) {
+                    Vector3D corners[4];
+                    geom->getCorners(corners);
+                    low = high = corners[0];
+                    for (const Vector3D& corner : corners) {
+                        low = Vector3D(std::min(low.x(), corner.x()), std::min(low.y(), corner.y()), std::min(low.z(), corner.z()));
+                        high = Vector3D(std::max(high.x(), corner.x()), std::max(high.y(), corner.y()), std::max(high.z(), corner.z()));
+                    }
+                } else if constexpr (std::is_same_v<T, Box>) {
+                    low = geom->getMinCorner();
+                    high = geom->getMaxCorner();
+                } else if constexpr (std::is_same_v<T, Circle> || std::is_same_v<T, Sphere>) {
+                    Vector3D extent(geom->getRadius(), geom->getRadius(), geom->getRadius());
+                    low = geom->getCenter() - extent;
+                    high = geom->getCenter() + extent;
+                }
+                return 1;
+            }, shapes[t]);
+            double* b = bounds.begin() + 6 * t;
+            b[0] = low.x(); b[1] = low.y(); b[2] = low.z();
+            b[3] = high.x(); b[4] = high.y(); b[5] = high.z();
+        }
+
+        const long long count = static_cast<long long>(spheres.size());
+        hits = math::Vector<SweepHit>(spheres.size());
+        size_t hitCount = 0;
+        #pragma omp parallel for schedule(dynamic, 64) reduction(+:hitCount)
+        for (long long s = 0; s < count; ++s) {
+            const SweptSphere& sphere = spheres[static_cast<size_t>(s)];
+            const Vector3D& a = sphere.start;
+            const Vector3D& b = sphere.end;
+            const double r = sphere.radius;
+            double low[3] = {std::min(a.x(), b.x()) - r, std::min(a.y(), b.y()) - r, std::min(a.z(), b.z()) - r};
+            double high[3] = {std::max(a.x(), b.x()) + r, std::max(a.y(), b.y()) + r, std::max(a.z(), b.z()) + r};
+
+            SweepHit best;
+            for (size_t t = 0; t < shapeCount; ++t) {
+                const double* box = bounds.begin() + 6 * t;
+                if (!present[t] || low[0] > box[3] || high[0] < box[0] || low[1] > box[4] || high[1] < box[1]
+                    || low[2] > box[5] || high[2] < box[2]) {
+                    continue;
+                }
+                std::optional<SweepHit> hit = std::visit([&](auto&& shape) {
+                    return sphere.sweep(*shape.getGeometry());
+                }, shapes[t]);
+                if (hit && (!best.isHit() || hit->time < best.time)) {
+                    best = *hit;
+                    best.target = t;
+                }
+            }
+            if (best.isHit()) {
+                ++hitCount;
+            }
+            hits[static_cast<size_t>(s)] = best;
+        }
+        return hitCount;
+    }
+
+} // namespace physics
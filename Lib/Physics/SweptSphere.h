@@ -0,0 +1,110 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef SWEPT_SPHERE_H
+#define SWEPT_SPHERE_H
+
+#include "../Geometry/Box.h"
+#include "../Geometry/Circle.h"
+#include "../Geometry/Plane.h"
+#include "../Geometry/Rectangle.h"
+#include "../Geometry/Sphere.h"
+#include "../Geometry/Vector3D.h"
+#include "../Math/Vector.hpp"
+#include "../Rendering/Camera.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <variant>
+
+namespace physics {
+
+    using geometry::Vector3D;
+
+    /// The scene geometry a moving sphere can hit
+    using SweepTarget = std::variant<geometry::Plane, geometry::Rectangle, geometry::Circle, geometry::Box, geometry::Sphere>;
+
+    /**
+     * @struct SweepHit
+     * @brief The first contact of a moving sphere.
+     */
+    struct SweepHit {
+        static constexpr size_t NO_TARGET = SIZE_MAX;
+
+        double time = 1.0;                  ///< Fraction of the motion at the contact, in [0, 1]
+        Vector3D normal = Vector3D(0, 0, 1); ///< Unit normal of the target at the contact, toward the sphere
+        Vector3D point = Vector3D(0, 0, 0);  ///< Point of contact on the target
+        size_t target = NO_TARGET;          ///< Index of the object hit, for batch queries
+
+        bool isHit() const { return target != NO_TARGET; }
+    };
+
+    /**
+     * @class SweptSphere
+     * @brief A sphere moving in a straight line over a step, for continuous collision queries.
+     *
+     * A sphere of radius r first touches a shape when its center enters the shape grown by r. The flat
+     * parts of the grown shape are the faces moved out by r, and the ray intersection of the shape
+     * (rayIntersectDepth) finds them exactly: an inflated sphere for spheres, a shifted plane, rectangle
+     * or disk for the flat shapes, a grown box for boxes. The rounded parts, along the edges of
+     * rectangles and boxes and the rim of disks, are reached by conservative advancement: Newton steps
+     * on the gap between the sphere and the shape, which is convex in time along a straight motion, so
+     * no step overshoots the first contact.
+     *
+     * A sphere already touching a target at the start of the motion hits it at time 0, with the
+     * normal pushing it out.
+     */
+    class SweptSphere {
+    public:
+        SweptSphere();
+
+        /**
+         * @brief Create a swept sphere
+         * @param start The center at the start of the motion
+         * @param end The center at the end of the motion
+         * @param radius The radius of the sphere
+         * @throws std::invalid_argument if radius is not positive
+         */
+        SweptSphere(const Vector3D& start, const Vector3D& end, double radius);
+
+        const Vector3D& getStart() const { return start; }
+        const Vector3D& getEnd() const { return end; }
+        double getRadius() const { return radius; }
+        Vector3D getCenterAt(double time) const { return start + (end - start) * time; }
+
+        std::optional<SweepHit> sweep(const geometry::Plane& plane) const;
+        std::optional<SweepHit> sweep(const geometry::Rectangle& rectangle) const;
+        std::optional<SweepHit> sweep(const geometry::Circle& circle) const;
+        std::optional<SweepHit> sweep(const geometry::Box& box) const;
+        std::optional<SweepHit> sweep(const geometry::Sphere& sphere) const;
+
+        /**
+         * @brief Find the first contact with a target
+         * @param target The target
+         * @return The contact, with target left to NO_TARGET, or nullopt if the sphere misses it
+         */
+        std::optional<SweepHit> sweep(const SweepTarget& target) const;
+
+        /**
+         * @brief Find the first contact of many spheres with the objects of a scene
+         * @param spheres The moving spheres
+         * @param shapes The objects, e.g. World::getObjects
+         * @param hits Output, the earliest contact of each sphere, with the index of the object hit,
+         *             not a hit if it misses every object
+         * @return The number of spheres that hit an object
+         */
+        static size_t sweepAll(const math::Vector<SweptSphere>& spheres,
+                               const math::Vector<rendering::Camera::ShapeVariant>& shapes,
+                               math::Vector<SweepHit>& hits);
+
+    private:
+        Vector3D start;
+        Vector3D end;
+        double radius;
+    };
+
+} // namespace physics
+
+#endif // SWEPT_SPHERE_H
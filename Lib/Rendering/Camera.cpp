@@ -3,6 +3,9 @@
 //
 
 #include "Camera.h"
+#include "IrradianceCache.h"
+#include "Lightmap.h"
+#include "ShadowMap.h"
 #include "../Math/Matrix.hpp"
 #include "../Math/Vector.hpp"
 
@@ -10,6 +13,7 @@
 #include <limits>
 #include <cmath>
 #include <algorithm>
+#include <stdexcept>
 
 namespace rendering {
 
@@ -18,6 +22,8 @@ namespace rendering {
         : viewport(viewport), FOV_Angle(FOV_Angle) {
     }
 
+    Camera::Camera() : Camera(Rectangle(Vector3D(0, 0, 0), Vector3D(1, 0, 0), Vector3D(0, 1, 0))) {}
+
     const Rectangle& Camera::getViewport() const {
         return viewport;
     }
@@ -107,6 +113,171 @@ namespace rendering {
         return fovOrigin;
     }
 
+    std::array<Camera, 2> Camera::makeStereoPair(double eyeSeparation) const {
+        Vector3D halfOffset = viewport.getLengthVec().normal() * (eyeSeparation / 2.0);
+        std::array<Camera, 2> eyes = {*this, *this};
+        eyes[0].translate(halfOffset * -1.0);
+        eyes[1].translate(halfOffset);
+        return eyes;
+    }
+
+    std::array<Camera, 6> Camera::makeCubeMapFaces() const {
+        const Vector3D eye = getFOVOrigin();
+        const Vector3D widthAxis = viewport.getWidthVec().normal();
+        const Vector3D lengthAxis = viewport.getLengthVec().normal();
+        const Quaternion turns[6] = {
+            Quaternion::identity(),
+            Quaternion(widthAxis, M_PI / 2.0),
+            Quaternion(widthAxis, M_PI),
+            Quaternion(widthAxis, 3.0 * M_PI / 2.0),
+            Quaternion(lengthAxis, M_PI / 2.0),
+            Quaternion(lengthAxis, -M_PI / 2.0)
+        };
+
+        std::array<Camera, 6> faces = {*this, *this, *this, *this, *this, *this};
+        for (size_t face = 0; face < faces.size(); ++face) {
+            // Rectangle::rotate turns around the world origin, so move the eye there first
+            faces[face].translate(eye * -1.0);
+            faces[face].rotate(turns[face]);
+            faces[face].translate(eye);
+        }
+        return faces;
+    }
+
+    double Camera::getPixelSpread(size_t imageWidth, size_t imageHeight) const {
+        if (imageWidth == 0 || imageHeight == 0) {
+            return 0.0;
+        }
+        // Size of a pixel on the viewport seen from the FOV origin, the larger side for non square pixels
+        double pixelSize = std::max(viewport.getLength() / static_cast<double>(imageWidth), viewport.getWidth() / static_cast<double>(imageHeight));
+        double distance = (viewport.getCenter() - getFOVOrigin()).length();
+        return std::atan2(pixelSize, distance);
+    }
+
+    void Camera::setSceneReplication(bool enabled) {
+        sceneReplication = enabled;
+    }
+
+    bool Camera::isSceneReplicationEnabled() const {
+        return sceneReplication;
+    }
+
+    void Camera::setShadowPackets(bool enabled) {
+        shadowPackets = enabled;
+    }
+
+    bool Camera::isShadowPacketsEnabled() const {
+        return shadowPackets;
+    }
+
+    void Camera::setSecondaryRaySorting(bool enabled) {
+        secondaryRaySorting = enabled;
+    }
+
+    bool Camera::isSecondaryRaySortingEnabled() const {
+        return secondaryRaySorting;
+    }
+
+    void Camera::setSecondaryRayBatchSize(size_t primaryRays) {
+        if (primaryRays == 0) {
+            throw std::invalid_argument("Secondary ray batch size must be positive");
+        }
+        secondaryRayBatchSize = primaryRays;
+    }
+
+    size_t Camera::getSecondaryRayBatchSize() const {
+        return secondaryRayBatchSize;
+    }
+
+    void Camera::setFramebufferLayout(PixelLayout layout) {
+        framebufferLayout = layout;
+    }
+
+    PixelLayout Camera::getFramebufferLayout() const {
+        return framebufferLayout;
+    }
+
+    void Camera::setRenderSchedule(const RenderSchedule& schedule) {
+        if (schedule.tileSize == 0 || schedule.chunkSize == 0 || schedule.threadCount < 0) {
+            throw std::invalid_argument("Render schedule tile size and chunk size must be positive");
+        }
+        renderSchedule = schedule;
+    }
+
+    const RenderSchedule& Camera::getRenderSchedule() const {
+        return renderSchedule;
+    }
+
+    void Camera::setLightmaps(std::shared_ptr<const LightmapSet> lightmaps) {
+        this->lightmaps = std::move(lightmaps);
+    }
+
+    const std::shared_ptr<const LightmapSet>& Camera::getLightmaps() const {
+        return lightmaps;
+    }
+
+    void Camera::setIrradianceCache(std::shared_ptr<IrradianceCache> irradianceCache) {
+        this->irradianceCache = std::move(irradianceCache);
+    }
+
+    const std::shared_ptr<IrradianceCache>& Camera::getIrradianceCache() const {
+        return irradianceCache;
+    }
+
+    void Camera::setShadowMode(ShadowMode mode) {
+        shadowMode = mode;
+    }
+
+    Camera::ShadowMode Camera::getShadowMode() const {
+        return shadowMode;
+    }
+
+    void Camera::setShadowMapResolution(size_t resolution) {
+        if (resolution == 0) {
+            throw std::invalid_argument("Shadow map resolution must be positive");
+        }
+        shadowMapResolution = resolution;
+    }
+
+    size_t Camera::getShadowMapResolution() const {
+        return shadowMapResolution;
+    }
+
+    void Camera::setShadowMaps(std::shared_ptr<const ShadowMapSet> shadowMaps) {
+        this->shadowMaps = std::move(shadowMaps);
+    }
+
+    const std::shared_ptr<const ShadowMapSet>& Camera::getShadowMaps() const {
+        return shadowMaps;
+    }
+
+    LightingCache Camera::prepareLighting(const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights, LightingStorage& storage, double pixelSpread) const {
+        LightingCache lighting;
+        lighting.pixelSpread = pixelSpread;
+        storage.lights = LightBlock(lights);
+        lighting.lights = &storage.lights;
+        if (lightmaps && lightmaps->matches(shapes, lights)) {
+            lighting.lightmaps = lightmaps.get();
+        }
+
+        if (shadowMode == ShadowMode::SHADOW_MAPPED) {
+            if (shadowMaps && shadowMaps->matches(shapes, lights)) {
+                storage.shadowMaps = shadowMaps;
+            } else {
+                storage.shadowMaps = std::make_shared<const ShadowMapSet>(ShadowMapSet::build(shapes, lights, shadowMapResolution));
+            }
+            lighting.shadowMaps = storage.shadowMaps.get();
+        }
+
+        if (irradianceCache) {
+            if (!irradianceCache->matches(shapes, lights)) {
+                irradianceCache->reset(shapes, lights);
+            }
+            lighting.irradiance = irradianceCache.get();
+        }
+        return lighting;
+    }
+
     Ray Camera::generateRay(const Vector3D& pointOnViewport) const {
         if (!viewport.containsPoint(pointOnViewport)) {
             throw std::invalid_argument("Point is not on the viewport rectangle");
@@ -19,17 +19,63 @@
 #include "./Image.h"
 #include "./Shape.hpp"
 #include "./Light.h"
+#include "./RenderSchedule.h"
+#include "./LightBlock.h"
+
+#include <array>
+#include <memory>
 
 
 using namespace geometry;
 
 namespace rendering {
 
+    class ScenePager;
+    struct RenderPlan;
+    struct GBuffer;
+    class LightmapSet;
+    class ShadowMapSet;
+    struct PixelShadows;
+    class IrradianceCache;
+
     struct Hit {
         double t; // Distance along the ray to the hit point
         size_t shapeIndex; // Index of the shape that was hit
     };
 
+    /**
+     * @brief Precomputed lighting data a lit render may use in place of shadow rays
+     */
+    struct LightingCache {
+        const LightmapSet* lightmaps = nullptr;     ///< Baked lighting of static planar surfaces, null if none
+        const ShadowMapSet* shadowMaps = nullptr;   ///< Shadow maps of the lights, null for ray traced shadows
+        const LightBlock* lights = nullptr;         ///< The lights laid out for vectorized lighting, built per call if null
+        const PixelShadows* pixelShadows = nullptr; ///< Shadow rays of the pixel traced ahead with its tile, null if none
+        double pixelSpread = 0.0;                   ///< Angle between the rays of neighboring pixels, sizes texture footprints
+        IrradianceCache* irradiance = nullptr;      ///< Indirect diffuse light of the scene, null for direct light only
+    };
+
+    /**
+     * @brief Lighting data built for one render, owned for the duration of the render
+     */
+    struct LightingStorage {
+        std::shared_ptr<const ShadowMapSet> shadowMaps;   ///< Shadow maps built or reused for this render
+        LightBlock lights;                                ///< The lights of the rendered scene
+    };
+
+    /**
+     * @brief The local shading of a hit by processRayHitAdvanced and the secondary rays it spawns
+     */
+    struct AdvancedShading {
+        RGBA_Color local;                   ///< The lit surface color
+        const Material* material = nullptr; ///< The material of the shape, null if none
+        bool terminal = true;               ///< True when the recursion depth is exhausted, the color is then local alone
+        bool refracts = false;              ///< True if refractRay is traced
+        bool reflects = false;              ///< True if reflectRay is traced
+        Ray refractRay;                     ///< The ray through a transparent material
+        Ray reflectRay;                     ///< The ray mirrored by a reflective material
+    };
+
     class Camera {
     public:
         // Type alias for shape variants
@@ -44,6 +90,12 @@ namespace rendering {
          */
         Camera(const Rectangle& viewport, float FOV_Angle = 65.0f);
 
+        /**
+         * Default constructor, a unit viewport at the world origin, so cameras can be stored in math::Vector
+         * Set the viewport before rendering.
+         */
+        Camera();
+
         /**
          * Get the viewport rectangle of the camera
          * @return Rectangle The viewport rectangle
@@ -140,6 +192,196 @@ namespace rendering {
          */
         Vector3D getFOVOrigin() const;
 
+        /**
+         * Get the two eyes of a stereo pair centered on this camera
+         * Each eye is this camera moved half the separation along the viewport length, left eye first.
+         * @param eyeSeparation The distance between the eyes
+         * @return std::array<Camera, 2> The left and right eyes, with the settings of this camera
+         */
+        std::array<Camera, 2> makeStereoPair(double eyeSeparation) const;
+
+        /**
+         * Get the six faces of a cube map around the FOV origin of this camera
+         * The faces are this camera turned around its FOV origin: a quarter, half and three quarter turn
+         * around the viewport width axis, then a quarter turn either way around the length axis. They
+         * cover the whole sphere when the viewport is square and the FOV angle is 90 degrees.
+         * @return std::array<Camera, 6> This view first, then the turned ones, with the settings of this camera
+         */
+        std::array<Camera, 6> makeCubeMapFaces() const;
+
+        /**
+         * Get the angle between the 3D rays of neighboring pixels, the spread of a pixel's ray cone
+         * @param imageWidth The width of the rendered image
+         * @param imageHeight The height of the rendered image
+         * @return double The angle in radians
+         */
+        double getPixelSpread(size_t imageWidth, size_t imageHeight) const;
+
+        /**
+         * Enable or disable per-NUMA-node copies of the scene during lit renders
+         * Has no effect on single node hosts.
+         * @param enabled Whether each node should read its own copy of the shapes and lights
+         */
+        void setSceneReplication(bool enabled);
+
+        /**
+         * Check if the scene is replicated per NUMA node during lit renders
+         * @return bool True if replication is enabled
+         */
+        bool isSceneReplicationEnabled() const;
+
+        /**
+         * Enable or disable tile packets of shadow rays in renderScene3DLight and renderScene3DLight_Advanced
+         * Each tile traces the shadow rays of its first hits toward each light as one packet, culling the
+         * shapes out of the packet once. The images are the same either way.
+         * @param enabled Whether ray traced shadows of primary hits are traced per tile
+         */
+        void setShadowPackets(bool enabled);
+
+        /**
+         * Check if shadow rays of primary hits are traced in tile packets
+         * @return bool True if packets are enabled
+         */
+        bool isShadowPacketsEnabled() const;
+
+        /**
+         * Enable or disable sorted secondary rays in renderScene3DLight_Advanced
+         * Bands of rows are shaded wave by wave: the reflected and refracted rays of a wave are
+         * buffered, sorted by origin cell and direction octant, then traced in that order. The images
+         * are the same either way; tile packets of shadow rays are not used while sorting.
+         * @param enabled Whether secondary rays are sorted before being traced
+         */
+        void setSecondaryRaySorting(bool enabled);
+
+        /**
+         * Check if secondary rays are sorted before being traced
+         * @return bool True if sorting is enabled
+         */
+        bool isSecondaryRaySortingEnabled() const;
+
+        /**
+         * Set the number of primary rays sorted together when secondary ray sorting is enabled
+         * Bands hold whole rows, so a batch may be up to one row larger.
+         * @param primaryRays The minimum number of primary rays per batch (65536 by default)
+         * @throws std::invalid_argument if primaryRays is zero
+         */
+        void setSecondaryRayBatchSize(size_t primaryRays);
+
+        /**
+         * Get the number of primary rays sorted together
+         * @return size_t The minimum number of primary rays per batch
+         */
+        size_t getSecondaryRayBatchSize() const;
+
+        /**
+         * Set the memory layout of the framebuffers and depth buffers used by renders
+         * Tiled layouts keep each 8x8 tile contiguous, matching the tile order pixels are rendered in.
+         * @param layout The pixel layout (ROW_MAJOR by default)
+         */
+        void setFramebufferLayout(PixelLayout layout);
+
+        /**
+         * Get the memory layout of the framebuffers and depth buffers used by renders
+         * @return PixelLayout The pixel layout
+         */
+        PixelLayout getFramebufferLayout() const;
+
+        /**
+         * Set how renders distribute their pixels over the OpenMP team
+         * @param schedule The tile size, chunk size and thread count (see RenderAutotuner)
+         */
+        void setRenderSchedule(const RenderSchedule& schedule);
+
+        /**
+         * Get how renders distribute their pixels over the OpenMP team
+         * @return RenderSchedule The schedule
+         */
+        const RenderSchedule& getRenderSchedule() const;
+
+        /**
+         * Set the baked lighting used by lit renders
+         * The lightmaps are only used while the rendered shapes and lights are those they were baked from.
+         * @param lightmaps The baked lightmaps, null to light every surface per pixel
+         */
+        void setLightmaps(std::shared_ptr<const LightmapSet> lightmaps);
+
+        /**
+         * Get the baked lighting used by lit renders
+         * @return The lightmaps, null if none are set
+         */
+        const std::shared_ptr<const LightmapSet>& getLightmaps() const;
+
+        /**
+         * Set the irradiance cache adding one bounce of diffuse interreflection to lit renders
+         * The cache keeps its records while the rendered shapes and lights stay the same, and is reset otherwise.
+         * @param irradianceCache The cache, null to render direct light only
+         */
+        void setIrradianceCache(std::shared_ptr<IrradianceCache> irradianceCache);
+
+        /**
+         * Get the irradiance cache used by lit renders
+         * @return The cache, null if none is set
+         */
+        const std::shared_ptr<IrradianceCache>& getIrradianceCache() const;
+
+        // Enum for shadow evaluation methods
+        enum class ShadowMode {
+            RAY_TRACED,     ///< One shadow ray per light and hit point, exact
+            SHADOW_MAPPED   ///< Filtered lookups in cube shadow maps, approximate
+        };
+
+        /**
+         * Set how lit renders evaluate shadows (RAY_TRACED by default)
+         * In SHADOW_MAPPED mode, each render builds the shadow maps of its lights first, unless
+         * shadow maps of the same scene were set with setShadowMaps.
+         * @param mode The shadow mode
+         */
+        void setShadowMode(ShadowMode mode);
+
+        /**
+         * Get how lit renders evaluate shadows
+         * @return ShadowMode The shadow mode
+         */
+        ShadowMode getShadowMode() const;
+
+        /**
+         * Set the resolution of the shadow maps built by renders
+         * @param resolution The texels per side of each cube face
+         * @throws std::invalid_argument if resolution is zero
+         */
+        void setShadowMapResolution(size_t resolution);
+
+        /**
+         * Get the resolution of the shadow maps built by renders
+         * @return size_t The texels per side of each cube face
+         */
+        size_t getShadowMapResolution() const;
+
+        /**
+         * Set prebuilt shadow maps, reused by SHADOW_MAPPED renders of the scene they were built from
+         * @param shadowMaps The shadow maps of a static scene, null to build them at every render
+         */
+        void setShadowMaps(std::shared_ptr<const ShadowMapSet> shadowMaps);
+
+        /**
+         * Get the prebuilt shadow maps
+         * @return The shadow maps, null if none are set
+         */
+        const std::shared_ptr<const ShadowMapSet>& getShadowMaps() const;
+
+        /**
+         * Gather the precomputed lighting a lit render of a scene uses
+         * Lightmaps and prebuilt shadow maps are used if they were computed from these shapes and lights.
+         * In SHADOW_MAPPED mode without matching prebuilt maps, the shadow maps are built into storage.
+         * The lights are always laid out into a LightBlock in storage.
+         * @param shapes The vector of shapes in the scene
+         * @param lights The vector of lights in the scene
+         * @param storage Output parameter owning the data built for this render
+         * @param pixelSpread The angle between the rays of neighboring pixels (see getPixelSpread), 0 samples textures at full resolution
+         * @return LightingCache The lighting data, valid while the camera and storage are
+         */
+        LightingCache prepareLighting(const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights, LightingStorage& storage, double pixelSpread = 0.0) const;
+
         /**
          * Generate a ray using a point on the viewport and the normal vector
          * @param pointOnViewport A point on the viewport rectangle
@@ -169,6 +411,31 @@ namespace rendering {
          */
         Ray generateRandomRayForPixel(size_t pixelX, size_t pixelY, size_t imageWidth, size_t imageHeight, bool is3D) const;
 
+        /**
+         * Generate a ray through a sub-pixel position (for multisampling)
+         * An offset of (0, 0) gives the ray of generateRayForPixel, the pixel spans offsets -0.5 to 0.5.
+         * @param pixelX The x-coordinate of the pixel
+         * @param pixelY The y-coordinate of the pixel
+         * @param offsetX The horizontal offset from the pixel sample point, in pixels
+         * @param offsetY The vertical offset from the pixel sample point, in pixels
+         * @param imageWidth The width of the image in pixels
+         * @param imageHeight The height of the image in pixels
+         * @param is3D Whether to generate a ray for 3D rendering (perspective) or 2D rendering (orthographic)
+         * @return Ray The generated ray
+         */
+        Ray generateRayForSubpixel(size_t pixelX, size_t pixelY, double offsetX, double offsetY, size_t imageWidth, size_t imageHeight, bool is3D) const;
+
+        /**
+         * Find where a point of the scene appears in a 3D render, the inverse of generateRayForPixel
+         * @param point The point to project
+         * @param imageWidth The width of the image in pixels
+         * @param imageHeight The height of the image in pixels
+         * @param pixelX Output parameter for the x-coordinate, pixel x spans x - 0.5 to x + 0.5
+         * @param pixelY Output parameter for the y-coordinate, pixel y spans y - 0.5 to y + 0.5
+         * @return True if the point is in front of the camera and inside the viewport
+         */
+        bool projectToPixel(const Vector3D& point, size_t imageWidth, size_t imageHeight, double& pixelX, double& pixelY) const;
+
         /**
          * Process ray hits to determine the resulting color at the hit point
          * @param hits The vector of hits detected by the ray
@@ -179,9 +446,32 @@ namespace rendering {
          */
         static RGBA_Color processRayHitRegression(const Hit& closest_hit, const Ray& hitRay, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights, math::Vector<size_t> index_to_test, double remaining = 1.0, double accR = 0.0, double accG = 0.0, double accB = 0.0, double accA = 0.0);
 
-        static RGBA_Color processRayHitOld(math::Vector<Hit>& hits, const Ray& hitRay, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights);
+        static RGBA_Color processRayHitOld(math::Vector<Hit>& hits, const Ray& hitRay, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights, const LightingCache& lighting = LightingCache());
         
-        static RGBA_Color processRayHitAdvanced(const Hit& closest_hit, const Ray& hitRay, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights, int recursivity_depth = 10);
+        static RGBA_Color processRayHitAdvanced(const Hit& closest_hit, const Ray& hitRay, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights, int recursivity_depth = 10, const LightingCache& lighting = LightingCache());
+
+        /**
+         * Shade a hit as processRayHitAdvanced does, without tracing its secondary rays
+         * @param hit The hit to shade
+         * @param hitRay The ray that hit
+         * @param shapes The vector of shapes in the scene
+         * @param lights The vector of lights in the scene
+         * @param recursivity_depth The secondary bounces left, none are spawned at 0
+         * @param lighting Precomputed lighting of the scene
+         * @return AdvancedShading The local color and the secondary rays to trace
+         */
+        static AdvancedShading shadeAdvancedHit(const Hit& hit, const Ray& hitRay, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights, int recursivity_depth, const LightingCache& lighting = LightingCache());
+
+        /**
+         * Blend the local shading of a hit with the colors its secondary rays brought back
+         * @param shading The shading of the hit
+         * @param refractHit True if the refracted ray hit a shape
+         * @param behindColor The color seen along the refracted ray
+         * @param reflectHit True if the reflected ray hit a shape
+         * @param reflectedColor The color seen along the reflected ray
+         * @return RGBA_Color The clamped color of the hit, as processRayHitAdvanced returns it
+         */
+        static RGBA_Color combineAdvancedShading(const AdvancedShading& shading, bool refractHit, const RGBA_Color& behindColor, bool reflectHit, const RGBA_Color& reflectedColor);
 
         /**
          * Find the next hit along a ray for a given set of shapes
@@ -194,7 +484,30 @@ namespace rendering {
 
         static std::optional<Hit> findClosestHit(const Ray& ray, const math::Vector<ShapeVariant>& shapes, int excludeIndex);
 
-        static RGBA_Color calculateLighting(const Vector3D& hitPoint, const Vector3D& normal, const math::Vector<Light>& lights, const math::Vector<ShapeVariant>& shapes, size_t selfIndex);
+        /**
+         * Compute the fraction of a light reaching a point past the shapes of a scene, with a shadow ray
+         * @param hitPoint The lit point
+         * @param lightPosition The position of the light
+         * @param shapes The vector of shapes in the scene
+         * @param selfIndex The index of the lit shape, which does not shadow itself
+         * @param candidates The indices of the shapes to test in scene order, null to test them all
+         * @return double The transmission, 0 behind an opaque shape
+         */
+        static double shadowTransmission(const Vector3D& hitPoint, const Vector3D& lightPosition, const math::Vector<ShapeVariant>& shapes, size_t selfIndex, const math::Vector<size_t>* candidates = nullptr);
+
+        /**
+         * Compute the direct lighting received by a surface point, with shadows
+         * The unshadowed terms of all lights are computed in vectorized blocks; shadows are only
+         * queried for lights facing the point whose contribution is not negligible.
+         * @param hitPoint The point of the surface
+         * @param normal The normal of the surface at the point
+         * @param lights The vector of lights in the scene
+         * @param shapes The vector of shapes in the scene
+         * @param selfIndex The index of the lit shape, which does not shadow itself
+         * @param lighting Baked lighting looked up first and shadow maps replacing shadow rays, if set
+         * @return RGBA_Color The accumulated light color
+         */
+        static RGBA_Color calculateLighting(const Vector3D& hitPoint, const Vector3D& normal, const math::Vector<Light>& lights, const math::Vector<ShapeVariant>& shapes, size_t selfIndex, const LightingCache& lighting = LightingCache());
 
         /**
          * Render the scene from the camera's perspective
@@ -269,6 +582,19 @@ namespace rendering {
          */
         Image renderScene3DLight_Advanced_MSAA(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, size_t samplesPerPixel) const;
 
+        /**
+         * Render the scene with multisample anti-aliasing
+         * Visibility is traced samplesPerPixel times per pixel, but shading runs once per distinct shape
+         * covering the pixel: at the pixel sample point when one shape covers every sample, otherwise at
+         * the covered sample nearest the centroid of its samples. Shaded colors are weighted by coverage,
+         * uncovered samples keep the background of the framebuffer.
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param shapes The vector of shapes in the scene
+         * @param lights The vector of lights in the scene
+         * @param samplesPerPixel The number of visibility samples per pixel
+         * @return Image The rendered image
+         */
         Image renderScene3DLight_MSAA(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, size_t samplesPerPixel) const;
 
         // Enum for anti-aliasing methods
@@ -283,9 +609,118 @@ namespace rendering {
 
         Image renderScene3DLight_AA(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, size_t samplesPerPixel = 8, AntiAliasingMethod method = AntiAliasingMethod::NONE) const;
 
+        /**
+         * Render the scene with SSAA one tile at a time
+         * Each thread renders the samples of one tile of output pixels into a reused buffer and
+         * downsamples it straight into the output, so the upscaled image is never allocated.
+         * The result matches the full-frame SSAA of renderScene3DLight_AA and renderScene3DLight_Advanced_AA.
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param shapes The vector of shapes in the scene
+         * @param lights The vector of lights in the scene
+         * @param samplesPerPixel The number of samples per pixel, a multiple of 4
+         * @param tileSize The side of the output tiles in pixels
+         * @param advanced Whether to shade with processRayHitAdvanced instead of processRayHitOld
+         * @return Image The rendered image
+         */
+        Image renderScene3DLight_SSAATiled(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, size_t samplesPerPixel, size_t tileSize, bool advanced = false) const;
+
+        /**
+         * Render a low sample preview of the scene and capture its G-buffer for a Denoiser
+         * Each pixel averages samplesPerPixel randomly jittered samples, a single sample traces the
+         * pixel sample point. The G-buffer holds the surface seen from the pixel sample point.
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param shapes The vector of shapes in the scene
+         * @param lights The vector of lights in the scene
+         * @param samplesPerPixel The number of samples per pixel
+         * @param gbuffer Output parameter for the depth, normal and albedo of each pixel
+         * @param advanced Whether to shade with processRayHitAdvanced instead of processRayHitOld
+         * @return Image The rendered image
+         */
+        Image renderScene3DLight_Preview(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, size_t samplesPerPixel, GBuffer& gbuffer, bool advanced = false) const;
+
+        /**
+         * Render the scene with the anti-aliasing options chosen by a RenderPlanner
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param shapes The vector of shapes in the scene
+         * @param lights The vector of lights in the scene
+         * @param plan The plan of the render
+         * @param advanced Whether to shade with processRayHitAdvanced instead of processRayHitOld
+         * @return Image The rendered image
+         */
+        Image renderScene3DLight_Planned(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, const RenderPlan& plan, bool advanced = false) const;
+
+        /**
+         * Render the flat colors of an out-of-core scene
+         * Rays are traced in bands of rows; each band only loads the pages its rays cross.
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param pager The paged shapes of the scene
+         * @param shapes Additional in-memory shapes
+         * @return Image The rendered image
+         */
+        Image renderScene3DColorPaged(size_t imageWidth, size_t imageHeight, ScenePager& pager, const math::Vector<ShapeVariant>& shapes) const;
+
+        /**
+         * Render the depth shaded colors of an out-of-core scene
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param pager The paged shapes of the scene
+         * @param shapes Additional in-memory shapes
+         * @return Image The rendered depth map image
+         */
+        Image renderScene3DDepthPaged(size_t imageWidth, size_t imageHeight, ScenePager& pager, const math::Vector<ShapeVariant>& shapes) const;
+
+        /**
+         * Render the direct lighting of an out-of-core scene
+         * The closest surface is lit with shadows, shadow rays being batched per light through the pages.
+         * Transparency stacking and secondary bounces are not traced for paged scenes.
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param pager The paged shapes of the scene
+         * @param shapes Additional in-memory shapes
+         * @param lights The vector of lights in the scene
+         * @return Image The rendered image
+         */
+        Image renderScene3DLightPaged(size_t imageWidth, size_t imageHeight, ScenePager& pager, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights) const;
+
+        /**
+         * Render the lighting of the scene from several cameras at once
+         * For stereo pairs, cube maps and camera arrays. The views share one scene snapshot, one
+         * lighting setup, one shadow packet tracer and one pass of the OpenMP team over the tiles of
+         * all views, with no barrier between views. Each task renders one tile in a pair of neighboring
+         * views, so the shadow rays of corresponding pixels are traced as one packet.
+         * The views must share their FOV angle, viewport size and framebuffer layout, which set the
+         * pixel spread (texture level of detail) and framebuffers computed once for all of them. The
+         * other render settings (schedule, shadows, scene replication, lightmaps and caches) are
+         * those of the first view.
+         * @param views The cameras, close ones next to each other
+         * @param imageWidth The width of every image in pixels
+         * @param imageHeight The height of every image in pixels
+         * @param shapes The vector of shapes in the scene
+         * @param lights The vector of lights in the scene
+         * @param advanced Whether to shade as renderScene3DLight_Advanced instead of renderScene3DLight
+         * @return math::Vector<Image> One image per view, as each view renders it alone (secondary ray sorting aside)
+         * @throws std::invalid_argument if the views differ in FOV angle, viewport size or framebuffer layout
+         */
+        static math::Vector<Image> renderMultiView3DLight(const math::Vector<Camera>& views, size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, bool advanced = false);
+
     private:
         Rectangle viewport;
         double FOV_Angle = 65.0f; // Field of View angle degrees
+        bool sceneReplication = false; // Replicate the scene per NUMA node while rendering
+        bool shadowPackets = true; // Trace the shadow rays of primary hits in tile packets
+        bool secondaryRaySorting = false; // Sort the secondary rays of advanced renders before tracing them
+        size_t secondaryRayBatchSize = 65536; // Primary rays per batch of sorted secondary rays
+        PixelLayout framebufferLayout = PixelLayout::ROW_MAJOR; // Memory layout of render targets
+        RenderSchedule renderSchedule; // Pixel distribution over the OpenMP team
+        std::shared_ptr<const LightmapSet> lightmaps; // Baked lighting of static planar surfaces
+        ShadowMode shadowMode = ShadowMode::RAY_TRACED; // Shadow evaluation of lit renders
+        size_t shadowMapResolution = 256; // Cube face resolution of the shadow maps built by renders
+        std::shared_ptr<const ShadowMapSet> shadowMaps; // Prebuilt shadow maps of a static scene
+        std::shared_ptr<IrradianceCache> irradianceCache; // Indirect diffuse light, kept across renders of a static scene
     };
 
 }
@@ -43,30 +43,81 @@ namespace rendering {
     }
 
 
+    Ray Camera::generateRayForSubpixel(size_t pixelX, size_t pixelY, double offsetX, double offsetY, size_t imageWidth, size_t imageHeight, bool is3D) const {
+        double u = (static_cast<double>(pixelX) + offsetX) / static_cast<double>(imageWidth);
+        double v = (static_cast<double>(pixelY) + offsetY) / static_cast<double>(imageHeight);
+        Vector3D pixelPosition = viewport.getPointAt(u, v);
+
+        if (is3D) {
+            // For 3D, adjust pixel position based on FOV origin
+            Vector3D fovOrigin = getFOVOrigin();
+            Vector3D direction = (pixelPosition - fovOrigin).normal();
+            return Ray(fovOrigin, direction);
+        }
+        return generateRay(pixelPosition);
+    }
+
+    bool Camera::projectToPixel(const Vector3D& point, size_t imageWidth, size_t imageHeight, double& pixelX, double& pixelY) const {
+        // Intersect the line from the FOV origin to the point with the viewport plane
+        Vector3D fovOrigin = getFOVOrigin();
+        const Vector3D& normal = viewport.getNormal();
+        Vector3D toPoint = point - fovOrigin;
+        double alongNormal = toPoint.dot(normal);
+        if (alongNormal <= 1e-12) {
+            return false; // Behind the camera
+        }
+        Vector3D onViewport = fovOrigin + toPoint * ((viewport.getOrigin() - fovOrigin).dot(normal) / alongNormal);
+
+        Vector3D local = onViewport - viewport.getOrigin();
+        double u = local.dot(viewport.getLengthVec()) / viewport.getLength();
+        double v = local.dot(viewport.getWidthVec()) / viewport.getWidth();
+        if (u < 0.0 || u > 1.0 || v < 0.0 || v > 1.0) {
+            return false;
+        }
+        pixelX = u * static_cast<double>(imageWidth);
+        pixelY = v * static_cast<double>(imageHeight);
+        return true;
+    }
+
+    void multisampleOffset(size_t sampleIndex, size_t sampleCount, double& offsetX, double& offsetY) {
+        double radicalInverse = 0.0;
+        double digit = 0.5;
+        for (size_t bits = sampleIndex; bits != 0; bits >>= 1, digit *= 0.5) {
+            if (bits & 1) {
+                radicalInverse += digit;
+            }
+        }
+        offsetX = (static_cast<double>(sampleIndex) + 0.5) / static_cast<double>(sampleCount) - 0.5;
+        offsetY = radicalInverse + 0.5 / static_cast<double>(sampleCount) - 0.5;
+    }
+
     void applyDepthShadingToPixel(Image& image, size_t x, size_t y, double depth, double max_depth) {
         double intensity = std::max(0.0, 1.2 - (depth / max_depth));
         image.setPixel(x, y, image.getPixel(x, y)*intensity);
     }
 
-    void applyDepthShadingToImage(Image& image, const math::Matrix<double>& depthBuffer, double max_depth) {
-        size_t width = image.getWidth();
-        size_t height = image.getHeight();
-
-        for (size_t y = 0; y < height; ++y) {
-            for (size_t x = 0; x < width; ++x) {
-                double depth = depthBuffer(x, y);
-                if (depth < std::numeric_limits<double>::infinity()) {
-                    applyDepthShadingToPixel(image, x, y, depth, max_depth);
-                }
+    void applyDepthShadingToImage(Image& image, const PixelBuffer<double>& depthBuffer, double max_depth) {
+        // Tile order, so tiled image and depth buffers are both walked block by block
+        forEachPixel(image.getWidth(), image.getHeight(), [&](size_t x, size_t y) {
+            double depth = depthBuffer(x, y);
+            if (depth < std::numeric_limits<double>::infinity()) {
+                applyDepthShadingToPixel(image, x, y, depth, max_depth);
             }
+        });
+    }
+
+    RGBA_Color shapeDisplayColor(const Camera::ShapeVariant& shape) {
+        const Material* material = std::visit([](auto&& typedShape) { return typedShape.getMaterial(); }, shape);
+        if (!material) {
+            return MISSING_COLOR;
         }
+        const RGBA_Color& albedo = material->getAlbedo();
+        return albedo == Colors::black() ? DEFAULT_SHAPE_COLORS[shape.index()] : albedo;
     }
 
     void shapeProcessSimple(Ray& ray, math::Vector<rendering::Camera::ShapeVariant>& shapes, RGBA_Color& pixelColor, double& closestDistance, bool& hitFound) {
         for (size_t i = 0; i < shapes.size(); ++i) {
             std::visit([&](auto&& shape) {
-                using T = std::decay_t<decltype(shape)>;
-
                 std::optional<double> distance = std::nullopt;
                 if (shape.getGeometry()) {
                     distance = shape.getGeometry()->rayIntersectDepth(ray);
@@ -75,82 +126,94 @@ namespace rendering {
                 if (distance && *distance < closestDistance) {
                     closestDistance = *distance;
                     hitFound = true;
-
-                    pixelColor = shape.getMaterial() ? shape.getMaterial()->getAlbedo() : RGBA_Color(1, 0, 1, 1); // Default to black if no color
-
-                    if (pixelColor == RGBA_Color(0, 0, 0, 1)) {
-                        if constexpr (std::is_same_v<T, Shape<Box>>) {
-                            pixelColor = RGBA_Color(1, 0, 0, 1); // Red
-                        } else if constexpr (std::is_same_v<T, Shape<Circle>>) {
-                            pixelColor = RGBA_Color(0, 1, 0, 1); // Green
-                        } else if constexpr (std::is_same_v<T, Shape<Plane>>) {
-                            pixelColor = RGBA_Color(0.5, 0.5, 0.5, 1); // Gray
-                        } else if constexpr (std::is_same_v<T, Shape<Rectangle>>) {
-                            pixelColor = RGBA_Color(0, 0, 1, 1); // Blue
-                        } else if constexpr (std::is_same_v<T, Shape<Sphere>>) {
-                            pixelColor = RGBA_Color(1, 1, 1, 1); // White
-                        }
-                    }
+                    pixelColor = shapeDisplayColor(shapes[i]);
                 }
 
             }, shapes[i]);
         }
     }
 
-    Image SSAADownScaling(Image& image_in, size_t samplesPerPixel) {
-        size_t imageWidth = image_in.getWidth() / (samplesPerPixel / 2);
-        size_t imageHeight = image_in.getHeight() / (samplesPerPixel / 2);
-        Image image_out(imageWidth, imageHeight);
-
-        const double exposure = 0.5;  // Adjustable exposure control
-        const double gamma = 2.2;     // Standard gamma correction value
-        
-        #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (size_t y = 0; y < imageHeight; ++y) {
-            for (size_t x = 0; x < imageWidth; ++x) {
-                double accR = 0.0, accG = 0.0, accB = 0.0, accA = 0.0;
-                
-                for (size_t ay = 0; ay < samplesPerPixel / 2; ++ay) {
-                    for (size_t ax = 0; ax < samplesPerPixel / 2; ++ax) {
-                        size_t sampleX = x * (samplesPerPixel / 2) + ax;
-                        size_t sampleY = y * (samplesPerPixel / 2) + ay;
-                        RGBA_Color sampleColor = image_in.getPixel(sampleX, sampleY);
-
-                        // Convert from sRGB to linear space
-                        double r = std::pow(sampleColor.r(), gamma);
-                        double g = std::pow(sampleColor.g(), gamma);
-                        double b = std::pow(sampleColor.b(), gamma);
-
-                        accR += r;
-                        accG += g;
-                        accB += b;
-                        accA += sampleColor.a();
+    bool findLightSampleHits(const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes, bool advanced, math::Vector<Hit>& hits) {
+        if (advanced) {
+            Hit hit;
+            double closestDistance = std::numeric_limits<double>::infinity();
+            for (size_t i = 0; i < shapes.size(); ++i) {
+                std::visit([&](auto&& shape) {
+                    if (shape.getGeometry()) {
+                        if (auto d = shape.getGeometry()->rayIntersectDepth(ray, closestDistance)) {
+                            // only accept hits in front of the origin
+                            if (*d > 1e-9) {
+                                hit = Hit{*d, i};
+                                closestDistance = *d;
+                            }
+                        }
+                    }
+                }, shapes[i]);
+            }
+            if (closestDistance == std::numeric_limits<double>::infinity()) {
+                return false;
+            }
+            hits.append(hit);
+            return true;
+        }
+
+        for (size_t i = 0; i < shapes.size(); ++i) {
+            std::visit([&](auto&& shape) {
+                if (shape.getGeometry()) {
+                    if (auto d = shape.getGeometry()->rayIntersectDepth(ray)) {
+                        // only accept hits in front of the origin
+                        if (*d > 1e-9) {
+                            hits.append(Hit{*d, i});
+                        }
                     }
                 }
-                double numSamples = static_cast<double>(samplesPerPixel);
+            }, shapes[i]);
+        }
+        return !hits.empty();
+    }
 
-                // Average in Linear space
-                double avgR = accR / numSamples;
-                double avgG = accG / numSamples;
-                double avgB = accB / numSamples;
-                double avgA = accA / numSamples;
+    RGBA_Color shadeLightHits(math::Vector<Hit>& hits, const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, bool advanced, const LightingCache& lighting) {
+        if (advanced) {
+            return Camera::processRayHitAdvanced(hits[0], ray, shapes, lights, 10, lighting).clamp();
+        }
+        return Camera::processRayHitOld(hits, ray, shapes, lights, lighting).clamp();
+    }
 
-                // Apply exposure adjustment
-                avgR = 1.0 - std::exp(-avgR * exposure);
-                avgG = 1.0 - std::exp(-avgG * exposure);
-                avgB = 1.0 - std::exp(-avgB * exposure);
+    std::optional<Hit> shadeLightSample(const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, bool advanced, const LightingCache& lighting, RGBA_Color& color) {
+        math::Vector<Hit> hits;
+        if (!findLightSampleHits(ray, shapes, advanced, hits)) {
+            return std::nullopt;
+        }
+        // Hits of the basic shading are in shape order, the closest is searched before shading reorders them
+        Hit closest = hits[0];
+        for (const Hit& hit : hits) {
+            if (hit.t < closest.t) {
+                closest = hit;
+            }
+        }
+        color = shadeLightHits(hits, ray, shapes, lights, advanced, lighting);
+        return closest;
+    }
 
+    Image SSAADownScaling(Image& image_in, size_t samplesPerPixel) {
+        size_t imageWidth = image_in.getWidth() / (samplesPerPixel / 2);
+        size_t imageHeight = image_in.getHeight() / (samplesPerPixel / 2);
+        Image image_out = makeFramebuffer(imageWidth, imageHeight, image_in.getLayout());
 
-                // Convert back to sRGB space
-                double finalR = std::pow(avgR, 1.0 / gamma);
-                double finalG = std::pow(avgG, 1.0 / gamma);
-                double finalB = std::pow(avgB, 1.0 / gamma);
+        const size_t factor = samplesPerPixel / 2;
 
-                RGBA_Color finalColor(finalR, finalG, finalB, avgA);
-                image_out.setPixel(x, y, finalColor.clamp());
-            }
-        }
+        forEachPixel(imageWidth, imageHeight, [&](size_t x, size_t y) {
+            image_out.setPixel(x, y, resolveSupersampledPixel(samplesPerPixel, [&](size_t ax, size_t ay) {
+                return image_in.getPixel(x * factor + ax, y * factor + ay);
+            }));
+        });
         return image_out;
     }
 
+    Image makeFramebuffer(size_t imageWidth, size_t imageHeight, PixelLayout layout) {
+        // The rows are first-touched by the default team inside the Matrix constructors
+        TeamPin pin;
+        return Image(static_cast<int>(imageWidth), static_cast<int>(imageHeight), layout);
+    }
+
 } // namespace rendering
\ No newline at end of file
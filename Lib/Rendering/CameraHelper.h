@@ -13,10 +13,18 @@
 #include "../Math/Matrix.hpp"
 #include "../Math/math_common.h"
 #include "Shape.hpp"
+#include "NumaTopology.h"
+#include "PixelBuffer.hpp"
+#include "RenderSchedule.h"
 
+#include <omp.h>
 #include <limits>
 #include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <variant>
 
 namespace rendering {
 
@@ -33,10 +41,32 @@ namespace rendering {
     /**
      * Apply depth shading to an entire image based on a depth buffer
      * @param image The image to modify
-     * @param depthBuffer The depth buffer containing depth values
+     * @param depthBuffer The depth buffer containing depth values, same size as the image
      * @param max_depth The maximum depth in the scene
      */
-    void applyDepthShadingToImage(Image& image, const math::Matrix<double>& depthBuffer, double max_depth);
+    void applyDepthShadingToImage(Image& image, const PixelBuffer<double>& depthBuffer, double max_depth);
+
+    /// Colors of shapes with a black albedo, in the order of the alternatives of Camera::ShapeVariant
+    inline constexpr RGBA_Color DEFAULT_SHAPE_COLORS[] = {
+        Colors::red(),                    // Box
+        Colors::green(),                  // Circle
+        RGBA_Color(0.5, 0.5, 0.5, 1.0),   // Plane, gray
+        Colors::blue(),                   // Rectangle
+        Colors::white()                   // Sphere
+    };
+    static_assert(std::size(DEFAULT_SHAPE_COLORS) == std::variant_size_v<Camera::ShapeVariant>,
+                  "One default color per shape type");
+
+    /// Color of shapes without material, and of rays hitting nothing
+    inline constexpr RGBA_Color MISSING_COLOR = RGBA_Color(1.0, 0.0, 1.0, 1.0);
+
+    /**
+     * Get the flat display color of a shape
+     * The albedo of its material, magenta without material, and a per-type color for black albedos
+     * @param shape The shape to color
+     * @return RGBA_Color The display color
+     */
+    RGBA_Color shapeDisplayColor(const Camera::ShapeVariant& shape);
 
     /**
      * Simple shape processing for ray intersection testing
@@ -48,14 +78,232 @@ namespace rendering {
      */
     void shapeProcessSimple(Ray& ray, math::Vector<rendering::Camera::ShapeVariant>& shapes, RGBA_Color& pixelColor, double& closestDistance, bool& hitFound);
 
+    /**
+     * Find the hits of one primary ray that renderScene3DLight or renderScene3DLight_Advanced shade
+     * @param ray The primary ray
+     * @param shapes The shapes of the scene
+     * @param advanced Whether the hits are shaded with processRayHitAdvanced
+     * @param hits Output, every hit in front of the origin, or only the closest one when advanced
+     * @return True if the ray hit a shape
+     */
+    bool findLightSampleHits(const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes, bool advanced, math::Vector<Hit>& hits);
+
+    /**
+     * Shade the hits found by findLightSampleHits
+     * @param lighting Precomputed lighting of the scene (see Camera::prepareLighting)
+     * @return RGBA_Color The clamped color
+     */
+    RGBA_Color shadeLightHits(math::Vector<Hit>& hits, const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, bool advanced, const LightingCache& lighting);
+
+    /**
+     * Shade one primary ray as renderScene3DLight or renderScene3DLight_Advanced do
+     * @param lighting Precomputed lighting of the scene (see Camera::prepareLighting)
+     * @param color Output, the clamped color, left untouched when nothing is hit
+     * @return The closest hit, the one the color was shaded at, or nothing if the ray hit no shape
+     */
+    std::optional<Hit> shadeLightSample(const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, bool advanced, const LightingCache& lighting, RGBA_Color& color);
+
     /**
      * Super-Sample Anti-Aliasing downscaling function
      * @param image_in The high-resolution input image
      * @param samplesPerPixel The number of samples per pixel used
-     * @return Image The downscaled image with anti-aliasing applied
+     * @return Image The downscaled image with anti-aliasing applied, in the layout of image_in
      */
     Image SSAADownScaling(Image& image_in, size_t samplesPerPixel);
 
+    /**
+     * Resolve the supersamples of one output pixel, as SSAADownScaling does
+     * Samples are averaged in linear space, exposure mapped and converted back to sRGB.
+     * @param samplesPerPixel The number of samples per pixel, the block is samplesPerPixel / 2 samples wide
+     * @param sampleAt Callable returning the sample color at sampleAt(ax, ay) inside the block
+     * @return RGBA_Color The clamped pixel color
+     */
+    template<typename SampleFunction>
+    RGBA_Color resolveSupersampledPixel(size_t samplesPerPixel, SampleFunction&& sampleAt) {
+        const double exposure = 0.5;  // Adjustable exposure control
+        const double gamma = 2.2;     // Standard gamma correction value
+        double accR = 0.0, accG = 0.0, accB = 0.0, accA = 0.0;
+
+        for (size_t ay = 0; ay < samplesPerPixel / 2; ++ay) {
+            for (size_t ax = 0; ax < samplesPerPixel / 2; ++ax) {
+                RGBA_Color sampleColor = sampleAt(ax, ay);
+
+                // Convert from sRGB to linear space
+                accR += std::pow(sampleColor.r(), gamma);
+                accG += std::pow(sampleColor.g(), gamma);
+                accB += std::pow(sampleColor.b(), gamma);
+                accA += sampleColor.a();
+            }
+        }
+        double numSamples = static_cast<double>(samplesPerPixel);
+
+        // Average in linear space, then apply exposure adjustment
+        double avgR = 1.0 - std::exp(-(accR / numSamples) * exposure);
+        double avgG = 1.0 - std::exp(-(accG / numSamples) * exposure);
+        double avgB = 1.0 - std::exp(-(accB / numSamples) * exposure);
+
+        // Convert back to sRGB space
+        RGBA_Color finalColor(std::pow(avgR, 1.0 / gamma), std::pow(avgG, 1.0 / gamma), std::pow(avgB, 1.0 / gamma), accA / numSamples);
+        return finalColor.clamp();
+    }
+
+    /**
+     * Get the offset of one anti-aliasing sample from the pixel sample point, in pixels
+     * The samples form a Hammersley set, stratified on both axes and a rotated grid for 4 samples.
+     * @param sampleIndex The index of the sample
+     * @param sampleCount The number of samples per pixel
+     * @param offsetX Output parameter for the horizontal offset, between -0.5 and 0.5
+     * @param offsetY Output parameter for the vertical offset, between -0.5 and 0.5
+     */
+    void multisampleOffset(size_t sampleIndex, size_t sampleCount, double& offsetX, double& offsetY);
+
+    /**
+     * Allocate a framebuffer for a render
+     * On multi-node hosts the render threads are pinned first, so each NUMA node
+     * first-touches the band of rows it will write in forEachPixel. The calling
+     * thread and the workers get their affinity back once the framebuffer is allocated.
+     * @param imageWidth The width of the image in pixels
+     * @param imageHeight The height of the image in pixels
+     * @param layout The memory layout of the framebuffer
+     * @return Image The framebuffer, filled with the debug color
+     */
+    Image makeFramebuffer(size_t imageWidth, size_t imageHeight, PixelLayout layout = PixelLayout::ROW_MAJOR);
+
+    /**
+     * Run a function on every tile of an image with the OpenMP team
+     * Tiles are squares of schedule.tileSize pixels clipped to the image, each processed by one thread.
+     * On multi-node hosts threads are pinned to their node and each processes the static
+     * band of tile rows it first-touched in makeFramebuffer. On single node hosts tiles are
+     * scheduled dynamically, schedule.chunkSize tiles at a time.
+     * @param imageWidth The width of the image in pixels
+     * @param imageHeight The height of the image in pixels
+     * @param schedule The tile size, chunk size and team size to use
+     * @param tileFunction Callable invoked as tileFunction(beginX, beginY, endX, endY), ends excluded
+     */
+    template<typename TileFunction>
+    void forEachTile(size_t imageWidth, size_t imageHeight, const RenderSchedule& schedule, TileFunction&& tileFunction) {
+        const NumaTopology& topology = NumaTopology::get();
+        const size_t tileSize = std::max<size_t>(1, schedule.tileSize);
+        const size_t chunkSize = std::max<size_t>(1, schedule.chunkSize);
+        const int threadCount = schedule.resolvedThreadCount();
+        const size_t tilesX = (imageWidth + tileSize - 1) / tileSize;
+        const size_t tilesY = (imageHeight + tileSize - 1) / tileSize;
+        auto runTile = [&](size_t tileX, size_t tileY) {
+            tileFunction(tileX * tileSize, tileY * tileSize, std::min(imageWidth, (tileX + 1) * tileSize), std::min(imageHeight, (tileY + 1) * tileSize));
+        };
+
+        if (topology.isMultiNode()) {
+            #pragma omp parallel num_threads(threadCount)
+            {
+                ThreadPin pin(static_cast<size_t>(omp_get_thread_num()), static_cast<size_t>(omp_get_num_threads()));
+
+                #pragma omp for schedule(static)
+                for (size_t tileY = 0; tileY < tilesY; ++tileY) {
+                    for (size_t tileX = 0; tileX < tilesX; ++tileX) {
+                        runTile(tileX, tileY);
+                    }
+                }
+            }
+            return;
+        }
+
+        #pragma omp parallel for collapse(2) schedule(dynamic, chunkSize) num_threads(threadCount)
+        for (size_t tileY = 0; tileY < tilesY; ++tileY) {
+            for (size_t tileX = 0; tileX < tilesX; ++tileX) {
+                runTile(tileX, tileY);
+            }
+        }
+    }
+
+    /**
+     * Run a function on every tile of several views of the same size with the OpenMP team
+     * Each task is one tile of a group of groupSize neighboring views, the last group taking the
+     * remaining views. The tasks of all groups form one pool, so threads done with a cheap view
+     * move on to the next one without waiting for the others. The pool is walked group by group
+     * rather than tile by tile, which keeps the framebuffers being written few enough to stay in
+     * cache. Tiles are scheduled as in forEachTile.
+     * @param viewCount The number of views
+     * @param groupSize The number of views rendered together per tile
+     * @param imageWidth The width of every view in pixels
+     * @param imageHeight The height of every view in pixels
+     * @param schedule The tile size, chunk size and team size to use
+     * @param tileFunction Callable invoked as tileFunction(firstView, groupViews, beginX, beginY, endX, endY), ends excluded
+     */
+    template<typename TileFunction>
+    void forEachViewTile(size_t viewCount, size_t groupSize, size_t imageWidth, size_t imageHeight, const RenderSchedule& schedule, TileFunction&& tileFunction) {
+        const NumaTopology& topology = NumaTopology::get();
+        const size_t tileSize = std::max<size_t>(1, schedule.tileSize);
+        const size_t chunkSize = std::max<size_t>(1, schedule.chunkSize);
+        const int threadCount = schedule.resolvedThreadCount();
+        const size_t tilesX = (imageWidth + tileSize - 1) / tileSize;
+        const size_t tilesY = (imageHeight + tileSize - 1) / tileSize;
+        groupSize = std::max<size_t>(1, groupSize);
+        const size_t groupCount = (viewCount + groupSize - 1) / groupSize;
+        auto runTile = [&](size_t tileX, size_t tileY, size_t group) {
+            const size_t firstView = group * groupSize;
+            tileFunction(firstView, std::min(groupSize, viewCount - firstView),
+                         tileX * tileSize, tileY * tileSize, std::min(imageWidth, (tileX + 1) * tileSize), std::min(imageHeight, (tileY + 1) * tileSize));
+        };
+
+        if (topology.isMultiNode()) {
+            // Same static bands of tile rows as forEachTile, which every framebuffer was first-touched with
+            #pragma omp parallel num_threads(threadCount)
+            {
+                ThreadPin pin(static_cast<size_t>(omp_get_thread_num()), static_cast<size_t>(omp_get_num_threads()));
+
+                #pragma omp for schedule(static)
+                for (size_t tileY = 0; tileY < tilesY; ++tileY) {
+                    for (size_t group = 0; group < groupCount; ++group) {
+                        for (size_t tileX = 0; tileX < tilesX; ++tileX) {
+                            runTile(tileX, tileY, group);
+                        }
+                    }
+                }
+            }
+            return;
+        }
+
+        #pragma omp parallel for collapse(3) schedule(dynamic, chunkSize) num_threads(threadCount)
+        for (size_t group = 0; group < groupCount; ++group) {
+            for (size_t tileY = 0; tileY < tilesY; ++tileY) {
+                for (size_t tileX = 0; tileX < tilesX; ++tileX) {
+                    runTile(tileX, tileY, group);
+                }
+            }
+        }
+    }
+
+    /**
+     * Run a function on every pixel of an image with the OpenMP team
+     * Pixels are handed out in tiles as in forEachTile, each tile being processed row by row
+     * by one thread, so tiled framebuffers are written one contiguous block at a time.
+     * @param imageWidth The width of the image in pixels
+     * @param imageHeight The height of the image in pixels
+     * @param schedule The tile size, chunk size and team size to use
+     * @param pixelFunction Callable invoked as pixelFunction(x, y)
+     */
+    template<typename PixelFunction>
+    void forEachPixel(size_t imageWidth, size_t imageHeight, const RenderSchedule& schedule, PixelFunction&& pixelFunction) {
+        forEachTile(imageWidth, imageHeight, schedule, [&](size_t beginX, size_t beginY, size_t endX, size_t endY) {
+            for (size_t y = beginY; y < endY; ++y) {
+                for (size_t x = beginX; x < endX; ++x) {
+                    pixelFunction(x, y);
+                }
+            }
+        });
+    }
+
+    /**
+     * Run a function on every pixel of an image with the default RenderSchedule
+     * @param imageWidth The width of the image in pixels
+     * @param imageHeight The height of the image in pixels
+     * @param pixelFunction Callable invoked as pixelFunction(x, y)
+     */
+    template<typename PixelFunction>
+    void forEachPixel(size_t imageWidth, size_t imageHeight, PixelFunction&& pixelFunction) {
+        forEachPixel(imageWidth, imageHeight, RenderSchedule(), std::forward<PixelFunction>(pixelFunction));
+    }
+
 } // namespace rendering
 
 #endif // CAMERA_HELPER_HPP
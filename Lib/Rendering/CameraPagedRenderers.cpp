@@ -0,0 +1,235 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "Camera.h"
+#include "CameraHelper.h"
+#include "ScenePager.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace rendering {
+
+    namespace {
+
+        constexpr double EPSILON = 1e-9;
+        constexpr double SHADOW_EPSILON = 1e-6;
+        constexpr double TRANSMISSION_THRESHOLD = 1e-12;
+
+        /// Pixels traced per batch, bounds the ray queues whatever the image size
+        constexpr size_t PAGED_BATCH_PIXELS = size_t(1) << 16;
+
+        /// Page index recorded for hits on in-memory shapes
+        constexpr size_t IN_MEMORY_PAGE = std::numeric_limits<size_t>::max();
+
+        /// Closest hit of a ray, with what shading needs so the page can be evicted afterwards
+        struct PagedHit {
+            double t = std::numeric_limits<double>::infinity();
+            size_t page = IN_MEMORY_PAGE;
+            size_t slot = 0;
+            bool found = false;
+            RGBA_Color color;
+            Vector3D normal;
+        };
+
+        void checkAspectRatio(const Camera& camera, size_t imageWidth, size_t imageHeight) {
+            double aspectRatio = static_cast<double>(imageWidth) / static_cast<double>(imageHeight);
+            double precision = 1e-6;
+            if (std::abs(aspectRatio - camera.getViewportAspectRatio()) > precision) {
+                throw std::invalid_argument("Image aspect ratio does not match camera viewport aspect ratio");
+            }
+        }
+
+        math::Vector<Ray> generateBatchRays(const Camera& camera, size_t imageWidth, size_t imageHeight, size_t firstRow, size_t rowCount) {
+            math::Vector<Ray> rays(rowCount * imageWidth);
+            #pragma omp parallel for schedule(static)
+            for (size_t r = 0; r < rays.size(); ++r) {
+                rays[r] = camera.generateRayForPixel(r % imageWidth, firstRow + r / imageWidth, imageWidth, imageHeight, true);
+            }
+            return rays;
+        }
+
+        /**
+         * Run a function on each batch of rows of the image
+         * @param batchFunction Callable invoked as batchFunction(firstRow, rowCount)
+         */
+        template<typename BatchFunction>
+        void forEachPagedBatch(size_t imageWidth, size_t imageHeight, BatchFunction&& batchFunction) {
+            size_t rowsPerBatch = std::max<size_t>(1, PAGED_BATCH_PIXELS / imageWidth);
+            for (size_t firstRow = 0; firstRow < imageHeight; firstRow += rowsPerBatch) {
+                batchFunction(firstRow, std::min(rowsPerBatch, imageHeight - firstRow));
+            }
+        }
+
+        void intersectClosest(const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes, size_t page, bool withNormal, PagedHit& hit) {
+            for (size_t i = 0; i < shapes.size(); ++i) {
+                std::visit([&](auto&& shape) {
+                    if (!shape.getGeometry()) {
+                        return;
+                    }
+                    auto d = shape.getGeometry()->rayIntersectDepth(ray, hit.t);
+                    // only accept hits in front of the origin
+                    if (d && *d > EPSILON && *d < hit.t) {
+                        hit.t = *d;
+                        hit.page = page;
+                        hit.slot = i;
+                        hit.found = true;
+                        hit.color = shapeDisplayColor(shapes[i]);
+                        if (withNormal) {
+                            hit.normal = shape.getNormalAt(ray.getPointAt(*d));
+                        }
+                    }
+                }, shapes[i]);
+            }
+        }
+
+        void traceClosest(ScenePager& pager, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Ray>& rays, bool withNormal, math::Vector<PagedHit>& hits) {
+            #pragma omp parallel for schedule(dynamic, 64)
+            for (size_t r = 0; r < rays.size(); ++r) {
+                intersectClosest(rays[r], shapes, IN_MEMORY_PAGE, withNormal, hits[r]);
+            }
+
+            // Pages farther than the closest hit found so far are skipped, and never loaded if no ray needs them
+            pager.traceBatch(rays,
+                [&](size_t r, double entryDistance) { return entryDistance < hits[r].t; },
+                [&](size_t r, size_t page, const math::Vector<Camera::ShapeVariant>& pageShapes) {
+                    intersectClosest(rays[r], pageShapes, page, withNormal, hits[r]);
+                });
+        }
+
+        void accumulateTransmission(const Ray& shadowRay, double distanceToLight, const math::Vector<Camera::ShapeVariant>& shapes, size_t page, const PagedHit& self, double& transmission) {
+            for (size_t j = 0; j < shapes.size() && transmission > TRANSMISSION_THRESHOLD; ++j) {
+                if (page == self.page && j == self.slot) {
+                    continue;
+                }
+                std::visit([&](auto&& otherShape) {
+                    if (otherShape.getGeometry()) {
+                        auto shadowDist = otherShape.getGeometry()->rayIntersectDepth(shadowRay, std::numeric_limits<double>::infinity());
+                        if (shadowDist && *shadowDist < distanceToLight) {
+                            const RGBA_Color* occColor = otherShape.getMaterial() ? &otherShape.getMaterial()->getAlbedo() : nullptr;
+                            double occAlpha = occColor ? occColor->a() : 1.0;
+                            if (occAlpha >= 1.0 - TRANSMISSION_THRESHOLD) {
+                                transmission = 0.0;
+                            } else {
+                                transmission *= (1.0 - occAlpha);
+                            }
+                        }
+                    }
+                }, shapes[j]);
+            }
+        }
+
+    } // namespace
+
+    Image Camera::renderScene3DColorPaged(size_t imageWidth, size_t imageHeight, ScenePager& pager, const math::Vector<ShapeVariant>& shapes) const {
+        checkAspectRatio(*this, imageWidth, imageHeight);
+        Image Image3D = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
+
+        forEachPagedBatch(imageWidth, imageHeight, [&](size_t firstRow, size_t rowCount) {
+            math::Vector<Ray> rays = generateBatchRays(*this, imageWidth, imageHeight, firstRow, rowCount);
+            math::Vector<PagedHit> hits(rays.size());
+            traceClosest(pager, shapes, rays, false, hits);
+
+            #pragma omp parallel for schedule(static)
+            for (size_t r = 0; r < rays.size(); ++r) {
+                if (hits[r].found) {
+                    Image3D.setPixel(r % imageWidth, firstRow + r / imageWidth, hits[r].color);
+                }
+            }
+        });
+
+        return Image3D;
+    }
+
+    Image Camera::renderScene3DDepthPaged(size_t imageWidth, size_t imageHeight, ScenePager& pager, const math::Vector<ShapeVariant>& shapes) const {
+        checkAspectRatio(*this, imageWidth, imageHeight);
+        Image Image3D = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
+        PixelBuffer<double> depthBuffer(imageWidth, imageHeight, std::numeric_limits<double>::infinity(), framebufferLayout);
+
+        forEachPagedBatch(imageWidth, imageHeight, [&](size_t firstRow, size_t rowCount) {
+            math::Vector<Ray> rays = generateBatchRays(*this, imageWidth, imageHeight, firstRow, rowCount);
+            math::Vector<PagedHit> hits(rays.size());
+            traceClosest(pager, shapes, rays, false, hits);
+
+            #pragma omp parallel for schedule(static)
+            for (size_t r = 0; r < rays.size(); ++r) {
+                if (hits[r].found) {
+                    size_t x = r % imageWidth;
+                    size_t y = firstRow + r / imageWidth;
+                    depthBuffer(x, y) = hits[r].t;
+                    Image3D.setPixel(x, y, hits[r].color);
+                }
+            }
+        });
+
+        applyDepthShadingToImage(Image3D, depthBuffer, depthBuffer.max(true));
+        return Image3D;
+    }
+
+    Image Camera::renderScene3DLightPaged(size_t imageWidth, size_t imageHeight, ScenePager& pager, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights) const {
+        Image Image3D = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
+
+        if (lights.size() == 0) {
+            return Image3D; // Return empty image if no lights
+        }
+
+        forEachPagedBatch(imageWidth, imageHeight, [&](size_t firstRow, size_t rowCount) {
+            math::Vector<Ray> rays = generateBatchRays(*this, imageWidth, imageHeight, firstRow, rowCount);
+            math::Vector<PagedHit> hits(rays.size());
+            traceClosest(pager, shapes, rays, true, hits);
+
+            math::Vector<RGBA_Color> accumulatedLight(rays.size());
+            math::Vector<Ray> shadowRays(rays.size());
+            math::Vector<double> distances(rays.size());
+            math::Vector<double> transmission(rays.size());
+
+            // One batched shadow pass per light, so each page is loaded once per light and batch
+            for (const Light& light : lights) {
+                #pragma omp parallel for schedule(static)
+                for (size_t r = 0; r < rays.size(); ++r) {
+                    transmission[r] = 0.0;
+                    if (!hits[r].found) {
+                        continue;
+                    }
+                    Vector3D hitPoint = rays[r].getPointAt(hits[r].t);
+                    Vector3D hitToLight = light.getPosition() - hitPoint;
+                    distances[r] = hitToLight.length();
+                    Vector3D lightDir = hitToLight.normal();
+                    shadowRays[r] = Ray(hitPoint + lightDir * SHADOW_EPSILON, lightDir);
+                    transmission[r] = 1.0;
+                    accumulateTransmission(shadowRays[r], distances[r], shapes, IN_MEMORY_PAGE, hits[r], transmission[r]);
+                }
+
+                pager.traceBatch(shadowRays,
+                    [&](size_t r, double entryDistance) { return transmission[r] > TRANSMISSION_THRESHOLD && entryDistance < distances[r]; },
+                    [&](size_t r, size_t page, const math::Vector<ShapeVariant>& pageShapes) {
+                        accumulateTransmission(shadowRays[r], distances[r], pageShapes, page, hits[r], transmission[r]);
+                    });
+
+                #pragma omp parallel for schedule(static)
+                for (size_t r = 0; r < rays.size(); ++r) {
+                    if (transmission[r] > TRANSMISSION_THRESHOLD) {
+                        double nDotL = std::max(0.0, hits[r].normal.dot(shadowRays[r].getDirection()));
+                        RGBA_Color lightCol = light.getColor() * light.getIntensity();
+                        double distanceAtten = 1.0 / (1.0 + 0.03 * distances[r] * distances[r]);
+                        accumulatedLight[r] = accumulatedLight[r] + lightCol * (transmission[r] * nDotL * distanceAtten);
+                    }
+                }
+            }
+
+            #pragma omp parallel for schedule(static)
+            for (size_t r = 0; r < rays.size(); ++r) {
+                if (hits[r].found) {
+                    RGBA_Color litSurface = hits[r].color * accumulatedLight[r];
+                    Image3D.setPixel(r % imageWidth, firstRow + r / imageWidth, RGBA_Color(litSurface.r(), litSurface.g(), litSurface.b(), hits[r].color.a()).clamp());
+                }
+            }
+        });
+
+        return Image3D;
+    }
+
+} // namespace rendering
@@ -2,11 +2,18 @@
 
 // Internal libraries
 #include "Camera.h"
+#include "CameraHelper.h"
+#include "IrradianceCache.h"
+#include "Lightmap.h"
+#include "ShadowMap.h"
+#include "ShadowPacket.h"
+#include "Texture.h"
 
 // External libraries
 #include <optional>
 #include <algorithm>
 #include <limits>
+#include <cmath>
 
 namespace rendering {
 
@@ -15,6 +22,7 @@ namespace rendering {
     static constexpr double EPSILON_REMAINING = 1e-6;
     static constexpr double SHADOW_EPSILON = 1e-6;
     static constexpr double TRANSMISSION_THRESHOLD = 1e-12;
+    static constexpr double LIGHT_CUTOFF = 1.0 / 1024.0;
 
     std::optional<Hit> Camera::findNextHit(const Ray& ray, const math::Vector<rendering::Camera::ShapeVariant>& shapes, const math::Vector<size_t>& excluded_indexes) {
         Hit next_hit;
@@ -64,8 +72,8 @@ namespace rendering {
         return closest_hit;
     }
 
-    RGBA_Color Camera::processRayHitOld(math::Vector<Hit>& hits, const Ray& hitRay, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights){
-        if (hits.empty()) return RGBA_Color(1,0,1,1); // Magenta for no hit
+    RGBA_Color Camera::processRayHitOld(math::Vector<Hit>& hits, const Ray& hitRay, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights, const LightingCache& lighting){
+        if (hits.empty()) return MISSING_COLOR;
         
         std::sort(hits.begin(), hits.end(), [](const Hit a, const Hit b){
             return a.t < b.t;
@@ -87,35 +95,21 @@ namespace rendering {
             // Access the shape
             size_t i = h.shapeIndex;
             std::visit([&](auto&& shape) {
-                using T = std::decay_t<decltype(shape)>;
-
                 // Compute lighting at this hit
                 const Vector3D hitPoint = hitRay.getPointAt(h.t);
                 const Vector3D normal = shape.getNormalAt(hitPoint);
 
                 // #pragma omp parallel for schedule(dynamic)
-                accumulatedLight = calculateLighting(hitPoint, normal, lights, shapes, i);
+                accumulatedLight = calculateLighting(hitPoint, normal, lights, shapes, i, lighting);
+                if (lighting.irradiance) {
+                    accumulatedLight = accumulatedLight + lighting.irradiance->indirectLight(hitPoint, normal, shapes, lights, i, lighting);
+                }
 
                 // Get surface color (avoid repeated comparisons)
                 const RGBA_Color* shapeColor = shape.getMaterial() ? &shape.getMaterial()->getAlbedo() : nullptr;
-                RGBA_Color surfColor;
-                if (shapeColor && *shapeColor != RGBA_Color(0,0,0,1)) {
-                    surfColor = *shapeColor;
-                } else {
-                    // Default colors by shape type
-                    if constexpr (std::is_same_v<T, Shape<Box>>) {
-                        surfColor = RGBA_Color(1,0,0,1);
-                    } else if constexpr (std::is_same_v<T, Shape<Circle>>) {
-                        surfColor = RGBA_Color(0,1,0,1);
-                    } else if constexpr (std::is_same_v<T, Shape<Plane>>) {
-                        surfColor = RGBA_Color(0.5,0.5,0.5,1);
-                    } else if constexpr (std::is_same_v<T, Shape<Rectangle>>) {
-                        surfColor = RGBA_Color(0,0,1,1);
-                    } else if constexpr (std::is_same_v<T, Shape<Sphere>>) {
-                        surfColor = RGBA_Color(1,1,1,1);
-                    } else {
-                        surfColor = RGBA_Color(1,0,1,1);
-                    }
+                RGBA_Color surfColor = shapeColor && *shapeColor != Colors::black() ? *shapeColor : DEFAULT_SHAPE_COLORS[shapes[i].index()];
+                if (shape.getMaterial() && shape.getMaterial()->hasAlbedoTexture()) {
+                    surfColor = texturedAlbedo(shapes[i], *shape.getMaterial(), hitPoint, normal, hitRay.getDirection(), h.t * lighting.pixelSpread);
                 }
 
                 double srcA = surfColor.a();
@@ -165,7 +159,7 @@ namespace rendering {
 
             // No ambient
 
-            RGBA_Color surfColor = shape.getMaterial() ? shape.getMaterial()->getAlbedo() : RGBA_Color(1,0,1,1);
+            RGBA_Color surfColor = shape.getMaterial() ? shape.getMaterial()->getAlbedo() : MISSING_COLOR;
 
             RGBA_Color litSurface = surfColor * accumulatedLight;
 
@@ -198,18 +192,9 @@ namespace rendering {
         return finalColor.clamp();
     }
 
-    RGBA_Color Camera::processRayHitAdvanced(const Hit& hit, const Ray& hitRay, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights, int recursivity_depth){
-        // Add recursivity depth check | Moved to later to return local color with no processing
-        // if (recursivity_depth <= 0) {
-        //     return new RGBA_Color(0,0,0,1); // Black if max depth
-        // }
-
-        if (hit.t == std::numeric_limits<double>::infinity()) return RGBA_Color(1,0,1,1); // Magenta for no hit
-        
-        RGBA_Color Local_color(0,0,0,1);
-        RGBA_Color Transparency_color(1,0,1,1);
-        RGBA_Color Reflection_color(1,0,1,1);
-        RGBA_Color final_color(1,0,1,1);
+    AdvancedShading Camera::shadeAdvancedHit(const Hit& hit, const Ray& hitRay, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights, int recursivity_depth, const LightingCache& lighting){
+        AdvancedShading shading;
+        shading.local = RGBA_Color(0,0,0,1);
 
         // Access the shape
         size_t i = hit.shapeIndex;
@@ -217,154 +202,228 @@ namespace rendering {
 
             // Get material
             const Material* material = shape.getMaterial();
-
-            // Get Color at hit point
+            shading.material = material;
 
             // Compute lighting at this hit
             Vector3D hitPoint = hitRay.getPointAt(hit.t);
             Vector3D normal = shape.getNormalAt(hitPoint);
 
-            RGBA_Color accumulatedLight = calculateLighting(hitPoint, normal, lights, shapes, i);
+            RGBA_Color accumulatedLight = calculateLighting(hitPoint, normal, lights, shapes, i, lighting);
 
-            // No ambient
+            // Indirect diffuse light, if any
+            if (lighting.irradiance) {
+                accumulatedLight = accumulatedLight + lighting.irradiance->indirectLight(hitPoint, normal, shapes, lights, i, lighting);
+            }
 
-            RGBA_Color surfColor = material ? material->getAlbedo() : RGBA_Color(1,0,1,1);
-            Local_color = (surfColor * accumulatedLight).clamp();
+            RGBA_Color surfColor = material ? material->getAlbedo() : MISSING_COLOR;
+            if (material && material->hasAlbedoTexture()) {
+                surfColor = texturedAlbedo(shapes[i], *material, hitPoint, normal, hitRay.getDirection(), hit.t * lighting.pixelSpread);
+            }
+            shading.local = (surfColor * accumulatedLight).clamp();
 
             if (recursivity_depth <= 0) {
-                final_color = Local_color.clamp();
                 return;
             }
+            shading.terminal = false;
 
             // If no material, skip advanced processing but continue to blending
             if (material != nullptr) {
                 Vector3D rayDir = hitRay.getDirection();
-                
-                // Handle transparency with recursion
+
+                // Transparency continues along the refracted ray
                 if (material->isTransparent()) {
                     Vector3D refractDir = material->getRefractedDirection(rayDir, normal);
-                    Ray refractRay(hitPoint + refractDir * 1e-4, refractDir);
-                    
-                    std::optional<Hit> next_hit = findClosestHit(refractRay, shapes, i);
-
-                    if (next_hit) {
-                        RGBA_Color behindColor = processRayHitAdvanced(*next_hit, refractRay, shapes, lights, recursivity_depth - 1);
-                        // Apply material color as a filter to the light passing through
-                        RGBA_Color materialFilter = material->getAlbedo();
-                        Transparency_color = RGBA_Color(
-                            behindColor.r() * materialFilter.r(),
-                            behindColor.g() * materialFilter.g(), 
-                            behindColor.b() * materialFilter.b(),
-                            behindColor.a()
-                        );
-                    } else {
-                        Transparency_color = RGBA_Color(1,0,1,1); // Debug color
-                    }
+                    shading.refractRay = Ray(hitPoint + refractDir * 1e-4, refractDir);
+                    shading.refracts = true;
                 }
 
-                // Handle reflection/refraction here if needed
+                // Reflection along the mirrored ray
                 if (material->isReflective()) {
                     Vector3D reflectDir = rayDir - normal * 2.0 * rayDir.dot(normal);
-                    Ray reflectRay(hitPoint + reflectDir * 1e-4, reflectDir);
-
-                    std::optional<Hit> next_hit = findClosestHit(reflectRay, shapes, i);
-
-                    if (next_hit) {
-                        Reflection_color = processRayHitAdvanced(*next_hit, reflectRay, shapes, lights, recursivity_depth - 1);
-                    } else {
-                        Reflection_color = RGBA_Color(1,0,1,1); // Debug color
-                    }
+                    shading.reflectRay = Ray(hitPoint + reflectDir * 1e-4, reflectDir);
+                    shading.reflects = true;
                 }
             } // End of material processing
+        }, shapes[i]);
+        return shading;
+    }
 
-            // Combine colors based on material properties
-            // Blend local color with reflection and transmission based on material properties
-            final_color = Local_color;
-            
-            if (material) {
-                double metalness = material->getMetalness();
-                double transmission = material->getTransmission();
-                double roughness = material->getRoughness();
-                
-                // For transparent materials, blend with transmitted light
-                if (material->isTransparent() && Transparency_color!= RGBA_Color(1,0,1,1)) {
-                    // Transmission strength based on material transmission property or alpha channel
-                    double transmissionStrength = transmission;
-                    if (transmissionStrength == 0.0 && material->hasAlbedo()) {
-                        // Use alpha channel for transparency if no explicit transmission
-                        transmissionStrength = 1.0 - material->getAlbedo().a();
-                    }
-                    transmissionStrength *= (1.0 - metalness); // Metals don't transmit light
-                    // Manual alpha blending for transparency
-                    final_color = final_color * (1.0 - transmissionStrength) + Transparency_color * transmissionStrength;
-                }
+    RGBA_Color Camera::combineAdvancedShading(const AdvancedShading& shading, bool refractHit, const RGBA_Color& behindColor, bool reflectHit, const RGBA_Color& reflectedColor){
+        if (shading.terminal) {
+            return shading.local.clamp();
+        }
 
-                // For metallic materials, blend more reflection
-                if (material->isReflective() && Reflection_color!= RGBA_Color(1,0,1,1)) {
-                    // Fresnel-like reflection mixing based on metalness and roughness
-                    double reflectionStrength = metalness * (1.0 - roughness * 0.8);
-                    // Manual alpha blending: result = src * (1-alpha) + dst * alpha
-                    final_color = final_color * (1.0 - reflectionStrength) + Reflection_color * reflectionStrength;
-                }
-                
-                // Add emissive contribution if material is emissive
-                if (material->isEmissive()) {
-                    RGBA_Color emissiveContrib = material->getEmissive() * material->getEmissiveIntensity();
-                    final_color = final_color + emissiveContrib;
+        const Material* material = shading.material;
+        RGBA_Color Transparency_color(1,0,1,1);
+        RGBA_Color Reflection_color(1,0,1,1);
+        if (shading.refracts && refractHit) {
+            // Apply material color as a filter to the light passing through
+            RGBA_Color materialFilter = material->getAlbedo();
+            Transparency_color = RGBA_Color(
+                behindColor.r() * materialFilter.r(),
+                behindColor.g() * materialFilter.g(),
+                behindColor.b() * materialFilter.b(),
+                behindColor.a()
+            );
+        }
+        if (shading.reflects && reflectHit) {
+            Reflection_color = reflectedColor;
+        }
+
+        // Combine colors based on material properties
+        // Blend local color with reflection and transmission based on material properties
+        RGBA_Color final_color = shading.local;
+
+        if (material) {
+            double metalness = material->getMetalness();
+            double transmission = material->getTransmission();
+            double roughness = material->getRoughness();
+
+            // For transparent materials, blend with transmitted light
+            if (material->isTransparent() && Transparency_color!= MISSING_COLOR) {
+                // Transmission strength based on material transmission property or alpha channel
+                double transmissionStrength = transmission;
+                if (transmissionStrength == 0.0 && material->hasAlbedo()) {
+                    // Use alpha channel for transparency if no explicit transmission
+                    transmissionStrength = 1.0 - material->getAlbedo().a();
                 }
+                transmissionStrength *= (1.0 - metalness); // Metals don't transmit light
+                // Manual alpha blending for transparency
+                final_color = final_color * (1.0 - transmissionStrength) + Transparency_color * transmissionStrength;
             }
-            
-            // Apply clamping to final color
-            final_color = final_color.clamp();
 
-        }, shapes[i]);
-        return final_color;
-        
-        // Fallback return (should not reach here)
-        return RGBA_Color(1, 0, 1, 1); // Magenta for error
+            // For metallic materials, blend more reflection
+            if (material->isReflective() && Reflection_color!= MISSING_COLOR) {
+                // Fresnel-like reflection mixing based on metalness and roughness
+                double reflectionStrength = metalness * (1.0 - roughness * 0.8);
+                // Manual alpha blending: result = src * (1-alpha) + dst * alpha
+                final_color = final_color * (1.0 - reflectionStrength) + Reflection_color * reflectionStrength;
+            }
+
+            // Add emissive contribution if material is emissive
+            if (material->isEmissive()) {
+                RGBA_Color emissiveContrib = material->getEmissive() * material->getEmissiveIntensity();
+                final_color = final_color + emissiveContrib;
+            }
+        }
+
+        // Apply clamping to final color
+        return final_color.clamp();
+    }
+
+    RGBA_Color Camera::processRayHitAdvanced(const Hit& hit, const Ray& hitRay, const math::Vector<ShapeVariant>& shapes, const math::Vector<Light>& lights, int recursivity_depth, const LightingCache& lighting){
+        if (hit.t == std::numeric_limits<double>::infinity()) return MISSING_COLOR;
+
+        AdvancedShading shading = shadeAdvancedHit(hit, hitRay, shapes, lights, recursivity_depth, lighting);
+
+        // Secondary rays traced depth first
+        std::optional<Hit> refractHit, reflectHit;
+        RGBA_Color behindColor, reflectedColor;
+        if (shading.refracts) {
+            refractHit = findClosestHit(shading.refractRay, shapes, hit.shapeIndex);
+            if (refractHit) {
+                behindColor = processRayHitAdvanced(*refractHit, shading.refractRay, shapes, lights, recursivity_depth - 1, lighting);
+            }
+        }
+        if (shading.reflects) {
+            reflectHit = findClosestHit(shading.reflectRay, shapes, hit.shapeIndex);
+            if (reflectHit) {
+                reflectedColor = processRayHitAdvanced(*reflectHit, shading.reflectRay, shapes, lights, recursivity_depth - 1, lighting);
+            }
+        }
+        return combineAdvancedShading(shading, refractHit.has_value(), behindColor, reflectHit.has_value(), reflectedColor);
+    }
+
+    double Camera::shadowTransmission(const Vector3D& hitPoint, const Vector3D& lightPosition, const math::Vector<ShapeVariant>& shapes, size_t selfIndex, const math::Vector<size_t>* candidates) {
+        Vector3D hitToLight = (lightPosition - hitPoint);
+        double distanceToLight = hitToLight.length();
+        Vector3D lightDir = hitToLight.normal();
+        Ray lightRay(hitPoint + lightDir * SHADOW_EPSILON, lightDir);
+
+        // Check for occlusions
+        double transmission = 1.0;
+        const size_t count = candidates ? candidates->size() : shapes.size();
+        for (size_t c = 0; c < count && transmission > TRANSMISSION_THRESHOLD; ++c) {
+            const size_t j = candidates ? (*candidates)[c] : c;
+            if (selfIndex == j) {
+                continue;
+            }
+            std::visit([&](auto&& otherShape) {
+                if (otherShape.getGeometry()) {
+                    auto shadowDist = otherShape.getGeometry()->rayIntersectDepth(lightRay, std::numeric_limits<double>::infinity());
+                    if (shadowDist && *shadowDist < distanceToLight) {
+                        const RGBA_Color* occColor = otherShape.getMaterial() ? &otherShape.getMaterial()->getAlbedo() : nullptr;
+                        double occAlpha = occColor ? occColor->a() : 1.0;
+                        if (occAlpha >= 1.0 - TRANSMISSION_THRESHOLD) {
+                            transmission = 0.0;
+                        } else {
+                            transmission *= (1.0 - occAlpha);
+                        }
+                    }
+                }
+            }, shapes[j]);
+        }
+        return transmission;
     }
 
-    RGBA_Color Camera::calculateLighting(const Vector3D& hitPoint, const Vector3D& normal, const math::Vector<Light>& lights, const math::Vector<ShapeVariant>& shapes, size_t selfIndex){
+    RGBA_Color Camera::calculateLighting(const Vector3D& hitPoint, const Vector3D& normal, const math::Vector<Light>& lights, const math::Vector<ShapeVariant>& shapes, size_t selfIndex, const LightingCache& lighting){
         RGBA_Color accumulatedLight(0.0, 0.0, 0.0, 1.0);
+
+        // Baked static surfaces: one lookup whatever the number of lights
+        if (lighting.lightmaps && lighting.lightmaps->lookup(selfIndex, hitPoint, accumulatedLight)) {
+            return accumulatedLight;
+        }
         
-        // #pragma omp parallel for schedule(dynamic)
-        for (const Light &light : lights) {
-            Vector3D hitToLight = (light.getPosition() - hitPoint);
-            double distanceToLight = hitToLight.length();
-            Vector3D lightDir = hitToLight.normal();
-
-            Ray lightRay(hitPoint + lightDir * SHADOW_EPSILON, lightDir);
-            double transmission = 1.0;
-
-            // Check for occlusions
-            // #pragma omp parallel for schedule(dynamic)
-            for (size_t j = 0; j < shapes.size(); ++j) {
-                if (selfIndex != j && transmission > TRANSMISSION_THRESHOLD) {
-                    std::visit([&](auto&& otherShape) {
-                        if (otherShape.getGeometry()) {
-                            auto shadowDist = otherShape.getGeometry()->rayIntersectDepth(lightRay, std::numeric_limits<double>::infinity());
-                            if (shadowDist && *shadowDist < distanceToLight) {
-                                const RGBA_Color* occColor = otherShape.getMaterial() ? &otherShape.getMaterial()->getAlbedo() : nullptr;
-                                double occAlpha = occColor ? occColor->a() : 1.0;
-                                if (occAlpha >= 1.0 - TRANSMISSION_THRESHOLD) {
-                                    transmission = 0.0;
-                                } else {
-                                    transmission *= (1.0 - occAlpha);
-                                }
-                            }
-                        }
-                    }, shapes[j]);
+        // Renders share one block per frame; direct calls lay the lights out here
+        LightBlock localBlock;
+        const LightBlock* block = lighting.lights;
+        if (!block || block->size() != lights.size()) {
+            localBlock = LightBlock(lights);
+            block = &localBlock;
+        }
+
+        // Lights with a negligible unshadowed contribution skip their shadow query and count as lit,
+        // as long as all of them together shift the result by less than LIGHT_CUTOFF
+        double unqueriedBudget = LIGHT_CUTOFF;
+        double red = 0.0, green = 0.0, blue = 0.0;
+        double weightsSquared[LightBlock::CHUNK];
+
+        for (size_t first = 0; first < lights.size(); first += LightBlock::CHUNK) {
+            const size_t count = std::min(LightBlock::CHUNK, lights.size() - first);
+            block->unshadowedWeights(first, count, hitPoint, normal, weightsSquared);
+
+            for (size_t k = 0; k < count; ++k) {
+                // Lights behind the surface contribute nothing, shadowed or not
+                if (!(weightsSquared[k] > 0.0)) {
+                    continue;
+                }
+                const size_t lightIndex = first + k;
+                const double weight = std::sqrt(weightsSquared[k]);
+                double transmission = 1.0;
+
+                const double peakContribution = block->peak.begin()[lightIndex] * weight;
+                if (peakContribution < unqueriedBudget) {
+                    unqueriedBudget -= peakContribution;
+                } else if (lighting.shadowMaps) {
+                    // Filtered shadow map lookup in place of the shadow ray
+                    transmission = lighting.shadowMaps->visibility(lightIndex, hitPoint, selfIndex);
+                } else {
+                    // Traced ahead with the tile of the pixel, or now
+                    double traced = lighting.pixelShadows ? lighting.pixelShadows->lookup(hitPoint, selfIndex, lightIndex) : PixelShadows::NOT_TRACED;
+                    transmission = traced != PixelShadows::NOT_TRACED ? traced : shadowTransmission(hitPoint, lights[lightIndex].getPosition(), shapes, selfIndex);
                 }
-            }
 
-            if (transmission > TRANSMISSION_THRESHOLD) {
-                double nDotL = std::max(0.0, normal.dot(lightDir));
-                RGBA_Color lightCol = light.getColor() * light.getIntensity();
-                double distanceAtten = 1.0 / (1.0 + 0.03 * distanceToLight * distanceToLight);
-                RGBA_Color contrib = lightCol * (transmission * nDotL * distanceAtten);
-                accumulatedLight = accumulatedLight + contrib;
+                if (transmission > TRANSMISSION_THRESHOLD) {
+                    const double scale = transmission * weight;
+                    red += block->red.begin()[lightIndex] * scale;
+                    green += block->green.begin()[lightIndex] * scale;
+                    blue += block->blue.begin()[lightIndex] * scale;
+                }
             }
         }
+
+        // Every contribution is positive, so one clamp at the end equals clamping after each light
+        accumulatedLight.setRGBA(red, green, blue, 1.0);
         return accumulatedLight;
     }
 }
\ No newline at end of file
@@ -4,77 +4,245 @@
 
 #include "Camera.h"
 #include "CameraHelper.h"
+#include "RenderPlanner.h"
+#include "Denoiser.h"
+#include "Lightmap.h"
+#include "ShadowMap.h"
+#include "SecondaryRays.h"
+#include "ShadowPacket.h"
 #include <omp.h>
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <limits>
+#include <optional>
 
 namespace rendering {
 
+    namespace {
+        /// Views rendered together per tile by renderMultiView3DLight, the two eyes of a stereo pair
+        constexpr size_t MULTI_VIEW_GROUP_SIZE = 2;
+
+        /**
+         * Render one tile of renderScene3DLight or renderScene3DLight_Advanced, in one or more views
+         * With a packet tracer, the hits of every pixel of every view are found first, then the shadow
+         * rays of the first hits are traced one packet per light, then the pixels are shaded.
+         * @param cameras The views, viewCount of them
+         * @param images The framebuffers of the views, viewCount of them
+         * @param tracer The shadow packet tracer of the scene, null to trace shadow rays per pixel
+         */
+        void renderLightTile(const Camera* cameras, Image* images, size_t viewCount, size_t beginX, size_t beginY, size_t endX, size_t endY, size_t imageWidth, size_t imageHeight,
+                             const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, bool advanced,
+                             const LightingCache& lighting, const ShadowPacketTracer* tracer) {
+            const size_t tileWidth = endX - beginX;
+            const size_t viewPixels = tileWidth * (endY - beginY);
+            const size_t pixelCount = viewPixels * viewCount;
+            math::Vector<math::Vector<Hit>> tileHits(pixelCount);
+            ShadowTile shadowTile;
+            if (tracer) {
+                shadowTile.reset(pixelCount, lights.size());
+            }
+
+            for (size_t pixel = 0; pixel < pixelCount; ++pixel) {
+                const Camera& camera = cameras[pixel / viewPixels];
+                const size_t local = pixel % viewPixels;
+                Ray ray = camera.generateRayForPixel(beginX + local % tileWidth, beginY + local / tileWidth, imageWidth, imageHeight, true);
+                math::Vector<Hit>& hits = tileHits[pixel];
+                if (findLightSampleHits(ray, shapes, advanced, hits) && tracer) {
+                    // The point shaded first, computed as processRayHitOld and processRayHitAdvanced do
+                    Hit first = hits[0];
+                    for (const Hit& hit : hits) {
+                        if (hit.t < first.t) {
+                            first = hit;
+                        }
+                    }
+                    Vector3D point = ray.getPointAt(first.t);
+                    Vector3D normal = std::visit([&](auto&& shape) { return shape.getNormalAt(point); }, shapes[first.shapeIndex]);
+                    shadowTile.setPoint(pixel, point, normal, first.shapeIndex);
+                }
+            }
+
+            if (tracer) {
+                shadowTile.trace(*tracer, lights, *lighting.lights);
+            }
+
+            LightingCache pixelLighting = lighting;
+            for (size_t view = 0; view < viewCount; ++view) {
+                const Camera& camera = cameras[view];
+                pixelLighting.pixelSpread = camera.getPixelSpread(imageWidth, imageHeight);
+                for (size_t local = 0; local < viewPixels; ++local) {
+                    const size_t pixel = view * viewPixels + local;
+                    math::Vector<Hit>& hits = tileHits[pixel];
+                    if (hits.empty()) {
+                        continue;
+                    }
+                    size_t x = beginX + local % tileWidth, y = beginY + local / tileWidth;
+                    pixelLighting.pixelShadows = tracer ? &shadowTile.getPixel(pixel) : nullptr;
+                    Ray ray = camera.generateRayForPixel(x, y, imageWidth, imageHeight, true);
+                    images[view].setPixel(x, y, shadeLightHits(hits, ray, shapes, lights, advanced, pixelLighting));
+                }
+            }
+        }
+
+        /**
+         * Resolve one pixel with multisampling: visibility per sample, shading once per covering shape
+         * @param color In, the background of the pixel; out, the coverage weighted color
+         * @return True if any sample hit a shape
+         */
+        bool shadeMultisampledPixel(const Camera& camera, size_t x, size_t y, size_t imageWidth, size_t imageHeight, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, size_t samplesPerPixel, bool advanced, const LightingCache& lighting, RGBA_Color& color) {
+            const size_t NO_SHAPE = std::numeric_limits<size_t>::max();
+
+            // Visibility: the closest shape of each sample
+            math::Vector<size_t> sampleShapes(samplesPerPixel);
+            size_t missCount = 0;
+            for (size_t sample = 0; sample < samplesPerPixel; ++sample) {
+                double offsetX, offsetY;
+                multisampleOffset(sample, samplesPerPixel, offsetX, offsetY);
+                Ray ray = camera.generateRayForSubpixel(x, y, offsetX, offsetY, imageWidth, imageHeight, true);
+
+                sampleShapes[sample] = NO_SHAPE;
+                double closestDistance = std::numeric_limits<double>::infinity();
+                for (size_t i = 0; i < shapes.size(); ++i) {
+                    std::visit([&](auto&& shape) {
+                        if (shape.getGeometry()) {
+                            if (auto d = shape.getGeometry()->rayIntersectDepth(ray, closestDistance)) {
+                                // only accept hits in front of the origin
+                                if (*d > 1e-9) {
+                                    sampleShapes[sample] = i;
+                                    closestDistance = *d;
+                                }
+                            }
+                        }
+                    }, shapes[i]);
+                }
+                if (sampleShapes[sample] == NO_SHAPE) {
+                    ++missCount;
+                }
+            }
+            if (missCount == samplesPerPixel) {
+                return false;
+            }
+
+            const RGBA_Color background = color;
+            double weight = static_cast<double>(missCount) / static_cast<double>(samplesPerPixel);
+            double accR = background.r() * weight, accG = background.g() * weight;
+            double accB = background.b() * weight, accA = background.a() * weight;
+
+            // Shading: once per distinct shape, in the order shapes first appear among the samples
+            for (size_t first = 0; first < samplesPerPixel; ++first) {
+                size_t shapeIndex = sampleShapes[first];
+                bool alreadyShaded = shapeIndex == NO_SHAPE;
+                for (size_t previous = 0; previous < first && !alreadyShaded; ++previous) {
+                    alreadyShaded = sampleShapes[previous] == shapeIndex;
+                }
+                if (alreadyShaded) {
+                    continue;
+                }
+
+                size_t coverage = 0;
+                double centroidX = 0.0, centroidY = 0.0;
+                for (size_t sample = first; sample < samplesPerPixel; ++sample) {
+                    if (sampleShapes[sample] == shapeIndex) {
+                        double offsetX, offsetY;
+                        multisampleOffset(sample, samplesPerPixel, offsetX, offsetY);
+                        centroidX += offsetX;
+                        centroidY += offsetY;
+                        ++coverage;
+                    }
+                }
+
+                // Fully covered pixels shade at the pixel sample point, partially covered ones at
+                // the covered sample nearest the centroid, which is sure to lie on the shape
+                double shadeX = 0.0, shadeY = 0.0;
+                if (coverage < samplesPerPixel) {
+                    centroidX /= static_cast<double>(coverage);
+                    centroidY /= static_cast<double>(coverage);
+                    double bestDistance = std::numeric_limits<double>::infinity();
+                    for (size_t sample = first; sample < samplesPerPixel; ++sample) {
+                        if (sampleShapes[sample] != shapeIndex) {
+                            continue;
+                        }
+                        double offsetX, offsetY;
+                        multisampleOffset(sample, samplesPerPixel, offsetX, offsetY);
+                        double distance = (offsetX - centroidX) * (offsetX - centroidX) + (offsetY - centroidY) * (offsetY - centroidY);
+                        if (distance < bestDistance) {
+                            bestDistance = distance;
+                            shadeX = offsetX;
+                            shadeY = offsetY;
+                        }
+                    }
+                }
+
+                RGBA_Color shaded = background;
+                Ray shadingRay = camera.generateRayForSubpixel(x, y, shadeX, shadeY, imageWidth, imageHeight, true);
+                shadeLightSample(shadingRay, shapes, lights, advanced, lighting, shaded);
+
+                weight = static_cast<double>(coverage) / static_cast<double>(samplesPerPixel);
+                accR += shaded.r() * weight;
+                accG += shaded.g() * weight;
+                accB += shaded.b() * weight;
+                accA += shaded.a() * weight;
+            }
+
+            color = RGBA_Color(accR, accG, accB, accA).clamp();
+            return true;
+        }
+
+    } // namespace
+
     Image Camera::renderScene2DColor(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes) const {
-        Image image(imageWidth, imageHeight);
+        Image image = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
 
         if (shapes.size() == 0) {
             return image; // Return empty image if no shapes
         }
 
         // For each pixel in the image, generate a ray through the corresponding point on the viewport
-        #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (size_t y = 0; y < imageHeight; ++y) {
-            for (size_t x = 0; x < imageWidth; ++x) {
-                Ray ray = generateRayForPixel(x, y, imageWidth, imageHeight, false);
+        forEachPixel(imageWidth, imageHeight, renderSchedule, [&](size_t x, size_t y) {
+            Ray ray = generateRayForPixel(x, y, imageWidth, imageHeight, false);
 
-                double closestDistance = std::numeric_limits<double>::infinity();
-                RGBA_Color pixelColor(0, 0, 0, 1); // Default to black
-                bool hitFound = false;
+            double closestDistance = std::numeric_limits<double>::infinity();
+            RGBA_Color pixelColor(0, 0, 0, 1); // Default to black
+            bool hitFound = false;
 
-                shapeProcessSimple(ray, shapes, pixelColor, closestDistance, hitFound);
+            shapeProcessSimple(ray, shapes, pixelColor, closestDistance, hitFound);
 
-                if (hitFound) {
-                    image.setPixel(x, y, pixelColor);
-                }
+            if (hitFound) {
+                image.setPixel(x, y, pixelColor);
             }
-        }
+        });
         return image;
     }
 
     Image Camera::renderScene2DDepth(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes) const {
-        Image image(imageWidth, imageHeight);
+        Image image = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
 
         if (shapes.size() == 0) {
             return image; // Return empty image if no shapes
         }
 
         // Use a matrix of pointers to doubles for depth buffer
-        math::Matrix<double> depthBuffer(imageWidth, imageHeight, std::numeric_limits<double>::infinity());
-
-        // Apply depth-based shading
-        double max_depth = -1.0;
-
-        #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (size_t y = 0; y < imageHeight; ++y) {
-            for (size_t x = 0; x < imageWidth; ++x) {
-                Ray ray = generateRayForPixel(x, y, imageWidth, imageHeight, false);
-                
-                double closestDistance = std::numeric_limits<double>::infinity();
-                RGBA_Color pixelColor(0, 0, 0, 1); // Default to black
-                bool hitFound = false;
-
-                shapeProcessSimple(ray, shapes, pixelColor, closestDistance, hitFound);
-
-                if (hitFound) {
-                    // set max depth
-                    if (closestDistance > max_depth) {
-                        max_depth = closestDistance;
-                    }
-                    // Store depth
-                    depthBuffer(x, y) = closestDistance;
-                    // Store color
-                    image.setPixel(x, y, pixelColor);
-                }
+        PixelBuffer<double> depthBuffer(imageWidth, imageHeight, std::numeric_limits<double>::infinity(), framebufferLayout);
+
+        forEachPixel(imageWidth, imageHeight, renderSchedule, [&](size_t x, size_t y) {
+            Ray ray = generateRayForPixel(x, y, imageWidth, imageHeight, false);
+            
+            double closestDistance = std::numeric_limits<double>::infinity();
+            RGBA_Color pixelColor(0, 0, 0, 1); // Default to black
+            bool hitFound = false;
+
+            shapeProcessSimple(ray, shapes, pixelColor, closestDistance, hitFound);
+
+            if (hitFound) {
+                // Store depth
+                depthBuffer(x, y) = closestDistance;
+                // Store color
+                image.setPixel(x, y, pixelColor);
             }
-        }
+        });
 
-        applyDepthShadingToImage(image, depthBuffer, max_depth);
+        // Apply depth-based shading, relative to the farthest hit; misses stay at infinity
+        applyDepthShadingToImage(image, depthBuffer, depthBuffer.max(true));
 
         return image;
     }
@@ -85,29 +253,26 @@ namespace rendering {
             throw std::invalid_argument("Image aspect ratio does not match camera viewport aspect ratio");
         }
 
-        Image Image3D(imageWidth, imageHeight);
+        Image Image3D = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
 
         if (shapes.size() == 0) {
             return Image3D; // Return empty image if no shapes
         }
 
-        #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (size_t y = 0; y < imageHeight; ++y) {
-            for (size_t x = 0; x < imageWidth; ++x) {
-                Ray ray = generateRayForPixel(x, y, imageWidth, imageHeight, true);
+        forEachPixel(imageWidth, imageHeight, renderSchedule, [&](size_t x, size_t y) {
+            Ray ray = generateRayForPixel(x, y, imageWidth, imageHeight, true);
 
-                double closestDistance = std::numeric_limits<double>::infinity();
-                bool hitFound = false;
-                RGBA_Color pixelColor(0, 0, 0, 1); // Default to black
+            double closestDistance = std::numeric_limits<double>::infinity();
+            bool hitFound = false;
+            RGBA_Color pixelColor(0, 0, 0, 1); // Default to black
 
-                shapeProcessSimple(ray, shapes, pixelColor, closestDistance, hitFound);
-                
-                // Store the depth and color for this pixel
-                if (hitFound) {
-                    Image3D.setPixel(x, y, pixelColor);
-                }
+            shapeProcessSimple(ray, shapes, pixelColor, closestDistance, hitFound);
+            
+            // Store the depth and color for this pixel
+            if (hitFound) {
+                Image3D.setPixel(x, y, pixelColor);
             }
-        }
+        });
 
         return Image3D;
     }
@@ -120,146 +285,86 @@ namespace rendering {
             throw std::invalid_argument("Image aspect ratio does not match camera viewport aspect ratio");
         }
 
-        Image Image3D(imageWidth, imageHeight);
+        Image Image3D = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
 
         if (shapes.size() == 0) {
             return Image3D; // Return empty image if no shapes
         }
 
         // Use a matrix of pointers to doubles for depth buffer
-        math::Matrix<double> depthBuffer(imageWidth, imageHeight, std::numeric_limits<double>::infinity());
+        PixelBuffer<double> depthBuffer(imageWidth, imageHeight, std::numeric_limits<double>::infinity(), framebufferLayout);
 
-        // Apply depth-based shading
-        double max_depth = -1.0;
+        forEachPixel(imageWidth, imageHeight, renderSchedule, [&](size_t x, size_t y) {
+            Ray ray = generateRayForPixel(x, y, imageWidth, imageHeight, true);
 
-        #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (size_t y = 0; y < imageHeight; ++y) {
-            for (size_t x = 0; x < imageWidth; ++x) {
-                Ray ray = generateRayForPixel(x, y, imageWidth, imageHeight, true);
+            double closestDistance = std::numeric_limits<double>::infinity();
+            bool hitFound = false;
+            RGBA_Color pixelColor(0, 0, 0, 1); // Default to black
 
-                double closestDistance = std::numeric_limits<double>::infinity();
-                bool hitFound = false;
-                RGBA_Color pixelColor(0, 0, 0, 1); // Default to black
-
-                shapeProcessSimple(ray, shapes, pixelColor, closestDistance, hitFound);
-                
-                // Store the depth and color for this pixel
-                if (hitFound) {
-                    // set max depth
-                    if (closestDistance > max_depth) {
-                        max_depth = closestDistance;
-                    }
-                    depthBuffer(x, y) = closestDistance;
-                    Image3D.setPixel(x, y, pixelColor);
-                }
+            shapeProcessSimple(ray, shapes, pixelColor, closestDistance, hitFound);
+            
+            // Store the depth and color for this pixel
+            if (hitFound) {
+                depthBuffer(x, y) = closestDistance;
+                Image3D.setPixel(x, y, pixelColor);
             }
-        }
+        });
 
-        applyDepthShadingToImage(Image3D, depthBuffer, max_depth);
+        // Apply depth-based shading, relative to the farthest hit; misses stay at infinity
+        applyDepthShadingToImage(Image3D, depthBuffer, depthBuffer.max(true));
 
         return Image3D;
     }
 
     Image Camera::renderScene3DLight(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights) const {
-        Image Image3D(imageWidth, imageHeight);
+        Image Image3D = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
 
         if (shapes.size() == 0 || lights.size() == 0) {
             return Image3D; // Return empty image if no shapes or lights
         }
 
-        #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (size_t y = 0; y < imageHeight; ++y) {
-            for (size_t x = 0; x < imageWidth; ++x) {
-                Ray ray = generateRayForPixel(x, y, imageWidth, imageHeight, true);
+        // Per-node copies of the scene when replication is enabled on a NUMA host
+        NodeReplicated<math::Vector<ShapeVariant>> sceneShapes(shapes, sceneReplication);
+        NodeReplicated<math::Vector<Light>> sceneLights(lights, sceneReplication);
+        LightingStorage lightingStorage;
+        const LightingCache lighting = prepareLighting(shapes, lights, lightingStorage, getPixelSpread(imageWidth, imageHeight));
 
-                math::Vector<Hit> hits;
-
-                // #pragma omp parallel for schedule(dynamic)
-                for (size_t i = 0; i < shapes.size(); ++i) {
-                    std::visit([&](auto&& shape) {
-                        if (shape.getGeometry()) {
-                            if (auto d = shape.getGeometry()->rayIntersectDepth(ray)) {
-                                // only accept hits in front of the origin
-                                if (*d > 1e-9) {
-                                    hits.append(Hit{*d, i});
-                                }
-                            }
-                        }
-                    }, shapes[i]);
-                }
-
-                if (!hits.empty()) {
-                    RGBA_Color finalColor = Camera::processRayHitOld(hits, ray, shapes, lights);
-                    Image3D.setPixel(x, y, finalColor.clamp());
-                }
-            }
+        // Shadow rays of the primary hits in tile packets, unless shadow maps replace them
+        std::optional<ShadowPacketTracer> tracer;
+        if (shadowPackets && !lighting.shadowMaps) {
+            tracer.emplace(shapes);
         }
 
+        forEachTile(imageWidth, imageHeight, renderSchedule, [&](size_t beginX, size_t beginY, size_t endX, size_t endY) {
+            renderLightTile(this, &Image3D, 1, beginX, beginY, endX, endY, imageWidth, imageHeight, sceneShapes.local(), sceneLights.local(), false, lighting, tracer ? &*tracer : nullptr);
+        });
+
         return Image3D;
     }
 
     Image Camera::renderScene3DLight_MSAA(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, size_t samplesPerPixel) const {
-        Image Image3D(imageWidth, imageHeight);
+        if (samplesPerPixel == 0) {
+            throw std::invalid_argument("samplesPerPixel must be positive");
+        }
+
+        Image Image3D = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
 
         if (shapes.size() == 0 || lights.size() == 0) {
             return Image3D; // Return empty image if no shapes or lights
         }
 
-        #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (size_t y = 0; y < imageHeight; ++y) {
-            for (size_t x = 0; x < imageWidth; ++x) {
-                math::Vector<RGBA_Color> sampleColors;
-                #pragma omp parallel for schedule(dynamic)
-                for (size_t sample_number = 0; sample_number < samplesPerPixel; ++sample_number) {
-                    Ray ray = generateRandomRayForPixel(x, y, imageWidth, imageHeight, true);
-
-                    // Collect all hits along the view ray and sort them front-to-back
-                    math::Vector<Hit> hits;
+        // Per-node copies of the scene when replication is enabled on a NUMA host
+        NodeReplicated<math::Vector<ShapeVariant>> sceneShapes(shapes, sceneReplication);
+        NodeReplicated<math::Vector<Light>> sceneLights(lights, sceneReplication);
+        LightingStorage lightingStorage;
+        const LightingCache lighting = prepareLighting(shapes, lights, lightingStorage, getPixelSpread(imageWidth, imageHeight));
 
-                    // #pragma omp parallel for schedule(dynamic)
-                    for (size_t i = 0; i < shapes.size(); ++i) {
-                        std::visit([&](auto&& shape) {
-                            if (shape.getGeometry()) {
-                                if (auto d = shape.getGeometry()->rayIntersectDepth(ray)) {
-                                    // only accept hits in front of the origin
-                                    if (*d > 1e-9) {
-                                        hits.append(Hit{*d, i});
-                                    }
-                                }
-                            }
-                        }, shapes[i]);
-                    }
-
-                    if (!hits.empty()) {
-                        RGBA_Color color = Camera::processRayHitOld(hits, ray, shapes, lights);
-                        sampleColors.append(color);
-                    }                
-                }
-
-                // Average samples for this pixel
-                if (!sampleColors.empty()) {
-                    double accR = 0.0, accG = 0.0, accB = 0.0, accA = 0.0;
-                    size_t numColors = sampleColors.size();
-
-                    // Move accumulation outside the parallel region
-                    accR = sampleColors[0].r();
-                    accG = sampleColors[0].g();
-                    accB = sampleColors[0].b();
-                    accA = sampleColors[0].a();
-
-                    for (size_t i = 1; i < numColors; i++) {
-                        accR += sampleColors[i].r();
-                        accG += sampleColors[i].g();
-                        accB += sampleColors[i].b();
-                        accA += sampleColors[i].a();
-                    }
-
-                    double numSamples = static_cast<double>(numColors);
-                    RGBA_Color finalColor(accR / numSamples, accG / numSamples, accB / numSamples, accA / numSamples);
-                    Image3D.setPixel(x, y, finalColor.clamp());
-                }
+        forEachPixel(imageWidth, imageHeight, renderSchedule, [&](size_t x, size_t y) {
+            RGBA_Color pixelColor = Image3D.getPixel(x, y);
+            if (shadeMultisampledPixel(*this, x, y, imageWidth, imageHeight, sceneShapes.local(), sceneLights.local(), samplesPerPixel, false, lighting, pixelColor)) {
+                Image3D.setPixel(x, y, pixelColor);
             }
-        }
+        });
 
         return Image3D;
     }
@@ -269,7 +374,7 @@ namespace rendering {
             throw std::invalid_argument("samplesPerPixel must be a multiple of 4 not zero");
         }
 
-        Image Image3D(imageWidth, imageHeight);
+        Image Image3D(imageWidth, imageHeight, framebufferLayout);
 
         if (shapes.size() == 0 || lights.size() == 0) {
             return Image3D; // Return empty image if no shapes or lights
@@ -305,109 +410,128 @@ namespace rendering {
     }
 
     Image Camera::renderScene3DLight_Advanced(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights) const {
-        Image Image3D(imageWidth, imageHeight);
+        Image Image3D = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
 
         if (shapes.size() == 0 || lights.size() == 0) {
             return Image3D; // Return empty image if no shapes or lights
         }
 
-        #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (size_t y = 0; y < imageHeight; ++y) {
-            for (size_t x = 0; x < imageWidth; ++x) {
-                Ray ray = generateRayForPixel(x, y, imageWidth, imageHeight, true);
-
-                Hit hit;
-                double closestDistance = std::numeric_limits<double>::infinity();
-
-                // #pragma omp parallel for schedule(dynamic)
-                for (size_t i = 0; i < shapes.size(); ++i) {
-                    std::visit([&](auto&& shape) {
-                        if (shape.getGeometry()) {
-                            if (auto d = shape.getGeometry()->rayIntersectDepth(ray, closestDistance)) {
-                                // only accept hits in front of the origin
-                                if (*d > 1e-9) {
-                                    hit = Hit{*d, i};
-                                    closestDistance = *d;
-                                }
-                            }
-                        }
-                    }, shapes[i]);
+        // Per-node copies of the scene when replication is enabled on a NUMA host
+        NodeReplicated<math::Vector<ShapeVariant>> sceneShapes(shapes, sceneReplication);
+        NodeReplicated<math::Vector<Light>> sceneLights(lights, sceneReplication);
+        LightingStorage lightingStorage;
+        const LightingCache lighting = prepareLighting(shapes, lights, lightingStorage, getPixelSpread(imageWidth, imageHeight));
+
+        if (secondaryRaySorting) {
+            // Bands of whole rows, each shaded as one batch of sorted secondary rays
+            const size_t bandRows = std::max<size_t>(1, (secondaryRayBatchSize + imageWidth - 1) / imageWidth);
+            for (size_t beginY = 0; beginY < imageHeight; beginY += bandRows) {
+                const size_t endY = std::min(imageHeight, beginY + bandRows);
+                const long long pixelCount = static_cast<long long>((endY - beginY) * imageWidth);
+                SecondaryRayBatch batch(shapes, lights, lighting, static_cast<size_t>(pixelCount));
+
+                #pragma omp parallel for schedule(dynamic, 64)
+                for (long long pixel = 0; pixel < pixelCount; ++pixel) {
+                    const size_t x = static_cast<size_t>(pixel) % imageWidth, y = beginY + static_cast<size_t>(pixel) / imageWidth;
+                    Ray ray = generateRayForPixel(x, y, imageWidth, imageHeight, true);
+                    math::Vector<Hit> hits;
+                    if (findLightSampleHits(ray, shapes, true, hits)) {
+                        batch.setPrimary(static_cast<size_t>(pixel), ray, hits[0]);
+                    }
                 }
 
-                if (closestDistance < std::numeric_limits<double>::infinity()) {
-                    RGBA_Color finalColor = Camera::processRayHitAdvanced(hit, ray, shapes, lights);
-                    Image3D.setPixel(x, y, finalColor.clamp());
+                batch.trace();
+                for (long long pixel = 0; pixel < pixelCount; ++pixel) {
+                    if (batch.hasColor(static_cast<size_t>(pixel))) {
+                        Image3D.setPixel(static_cast<size_t>(pixel) % imageWidth, beginY + static_cast<size_t>(pixel) / imageWidth, batch.getColor(static_cast<size_t>(pixel)).clamp());
+                    }
                 }
             }
+            return Image3D;
+        }
+
+        // Shadow rays of the primary hits in tile packets, unless shadow maps replace them
+        std::optional<ShadowPacketTracer> tracer;
+        if (shadowPackets && !lighting.shadowMaps) {
+            tracer.emplace(shapes);
         }
 
+        forEachTile(imageWidth, imageHeight, renderSchedule, [&](size_t beginX, size_t beginY, size_t endX, size_t endY) {
+            renderLightTile(this, &Image3D, 1, beginX, beginY, endX, endY, imageWidth, imageHeight, sceneShapes.local(), sceneLights.local(), true, lighting, tracer ? &*tracer : nullptr);
+        });
+
         return Image3D;
     }
 
-    Image Camera::renderScene3DLight_Advanced_MSAA(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, size_t samplesPerPixel) const {
-        Image Image3D(imageWidth, imageHeight);
+    math::Vector<Image> Camera::renderMultiView3DLight(const math::Vector<Camera>& views, size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, bool advanced) {
+        const size_t viewCount = views.size();
+        math::Vector<Image> images(viewCount);
+        if (viewCount == 0) {
+            return images;
+        }
+
+        // The pixel spread and the framebuffers are computed once, from the first view
+        const Camera& settings = views[0];
+        auto sameSize = [](double a, double b) { return std::fabs(a - b) <= 1e-9 * std::max(std::fabs(a), std::fabs(b)); };
+        for (const Camera& view : views) {
+            // Turned views recompute their viewport sides, which may move them by a rounding error
+            if (view.FOV_Angle != settings.FOV_Angle || !sameSize(view.getViewportWidth(), settings.getViewportWidth())
+                || !sameSize(view.getViewportLength(), settings.getViewportLength()) || view.framebufferLayout != settings.framebufferLayout) {
+                throw std::invalid_argument("Multi-view renders need views with the same FOV angle, viewport size and framebuffer layout");
+            }
+        }
+        for (size_t view = 0; view < viewCount; ++view) {
+            images[view] = makeFramebuffer(imageWidth, imageHeight, settings.framebufferLayout);
+        }
 
         if (shapes.size() == 0 || lights.size() == 0) {
-            return Image3D; // Return empty image if no shapes or lights
+            return images; // Return empty images if no shapes or lights
         }
 
-        #pragma omp parallel for collapse(2) schedule(dynamic)
-        for (size_t y = 0; y < imageHeight; ++y) {
-            for (size_t x = 0; x < imageWidth; ++x) {
-                math::Vector<RGBA_Color> sampleColors;
-
-                #pragma omp parallel for schedule(dynamic)
-                for (size_t sample_number = 0; sample_number < samplesPerPixel; ++sample_number) {
-                    Ray ray = generateRandomRayForPixel(x, y, imageWidth, imageHeight, true);
-
-                    Hit hit;
-                    double closestDistance = std::numeric_limits<double>::infinity();
-
-                    // #pragma omp parallel for schedule(dynamic)
-                    for (size_t i = 0; i < shapes.size(); ++i) {
-                        std::visit([&](auto&& shape) {
-                            if (shape.getGeometry()) {
-                                if (auto d = shape.getGeometry()->rayIntersectDepth(ray, closestDistance)) {
-                                    // only accept hits in front of the origin
-                                    if (*d > 1e-9) {
-                                        hit = Hit{*d, i};
-                                        closestDistance = *d;
-                                    }
-                                }
-                            }
-                        }, shapes[i]);
-                    }
+        // One scene snapshot, lighting setup and shadow packet tracer for every view
+        NodeReplicated<math::Vector<ShapeVariant>> sceneShapes(shapes, settings.sceneReplication);
+        NodeReplicated<math::Vector<Light>> sceneLights(lights, settings.sceneReplication);
+        LightingStorage lightingStorage;
+        const LightingCache lighting = settings.prepareLighting(shapes, lights, lightingStorage, settings.getPixelSpread(imageWidth, imageHeight));
 
-                    if (closestDistance < std::numeric_limits<double>::infinity()) {
-                        sampleColors.append(Camera::processRayHitAdvanced(hit, ray, shapes, lights));
-                    }              
-                }
+        std::optional<ShadowPacketTracer> tracer;
+        if (settings.shadowPackets && !lighting.shadowMaps) {
+            tracer.emplace(shapes);
+        }
 
-                // Average samples for this pixel
-                if (!sampleColors.empty()) {
-                    double accR = 0.0, accG = 0.0, accB = 0.0, accA = 0.0;
-                    size_t numColors = sampleColors.size();
-
-                    // Move accumulation outside the parallel region
-                    accR = sampleColors[0].r();
-                    accG = sampleColors[0].g();
-                    accB = sampleColors[0].b();
-                    accA = sampleColors[0].a();
-
-                    for (size_t i = 1; i < numColors; i++) {
-                        accR += sampleColors[i].r();
-                        accG += sampleColors[i].g();
-                        accB += sampleColors[i].b();
-                        accA += sampleColors[i].a();
-                    }
+        forEachViewTile(viewCount, MULTI_VIEW_GROUP_SIZE, imageWidth, imageHeight, settings.renderSchedule,
+                        [&](size_t firstView, size_t groupViews, size_t beginX, size_t beginY, size_t endX, size_t endY) {
+            renderLightTile(views.begin() + firstView, &images[firstView], groupViews, beginX, beginY, endX, endY, imageWidth, imageHeight,
+                            sceneShapes.local(), sceneLights.local(), advanced, lighting, tracer ? &*tracer : nullptr);
+        });
 
-                    double numSamples = static_cast<double>(numColors);
-                    RGBA_Color finalColor(accR / numSamples, accG / numSamples, accB / numSamples, accA / numSamples);
-                    Image3D.setPixel(x, y, finalColor.clamp());
-                }
-            }
+        return images;
+    }
+
+    Image Camera::renderScene3DLight_Advanced_MSAA(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, size_t samplesPerPixel) const {
+        if (samplesPerPixel == 0) {
+            throw std::invalid_argument("samplesPerPixel must be positive");
         }
 
+        Image Image3D = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
+
+        if (shapes.size() == 0 || lights.size() == 0) {
+            return Image3D; // Return empty image if no shapes or lights
+        }
+
+        // Per-node copies of the scene when replication is enabled on a NUMA host
+        NodeReplicated<math::Vector<ShapeVariant>> sceneShapes(shapes, sceneReplication);
+        NodeReplicated<math::Vector<Light>> sceneLights(lights, sceneReplication);
+        LightingStorage lightingStorage;
+        const LightingCache lighting = prepareLighting(shapes, lights, lightingStorage, getPixelSpread(imageWidth, imageHeight));
+
+        forEachPixel(imageWidth, imageHeight, renderSchedule, [&](size_t x, size_t y) {
+            RGBA_Color pixelColor = Image3D.getPixel(x, y);
+            if (shadeMultisampledPixel(*this, x, y, imageWidth, imageHeight, sceneShapes.local(), sceneLights.local(), samplesPerPixel, true, lighting, pixelColor)) {
+                Image3D.setPixel(x, y, pixelColor);
+            }
+        });
+
         return Image3D;
     }
 
@@ -416,7 +540,7 @@ namespace rendering {
             throw std::invalid_argument("samplesPerPixel must be a multiple of 4 not zero");
         }
 
-        Image Image3D(imageWidth, imageHeight);
+        Image Image3D(imageWidth, imageHeight, framebufferLayout);
 
         if (shapes.size() == 0 || lights.size() == 0) {
             return Image3D; // Return empty image if no shapes or lights
@@ -451,4 +575,167 @@ namespace rendering {
         }
     }
 
-} // namespace rendering
\ No newline at end of file
+    Image Camera::renderScene3DLight_SSAATiled(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, size_t samplesPerPixel, size_t tileSize, bool advanced) const {
+        if (samplesPerPixel == 0 || samplesPerPixel % 4 != 0) {
+            throw std::invalid_argument("samplesPerPixel must be a multiple of 4 not zero");
+        }
+        if (tileSize == 0) {
+            throw std::invalid_argument("Tile size must be positive");
+        }
+
+        Image Image3D = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
+
+        if (shapes.size() == 0 || lights.size() == 0) {
+            return Image3D; // Return empty image if no shapes or lights
+        }
+
+        const size_t factor = samplesPerPixel / 2;
+        const size_t sampleWidth = imageWidth * factor;
+        const size_t sampleHeight = imageHeight * factor;
+        const size_t tileSamples = tileSize * factor;
+        const size_t tilesX = (imageWidth + tileSize - 1) / tileSize;
+        const size_t tilesY = (imageHeight + tileSize - 1) / tileSize;
+
+        // Per-node copies of the scene when replication is enabled on a NUMA host
+        NodeReplicated<math::Vector<ShapeVariant>> sceneShapes(shapes, sceneReplication);
+        NodeReplicated<math::Vector<Light>> sceneLights(lights, sceneReplication);
+        LightingStorage lightingStorage;
+        const LightingCache lighting = prepareLighting(shapes, lights, lightingStorage, getPixelSpread(imageWidth, imageHeight));
+
+        const size_t chunkSize = std::max<size_t>(1, renderSchedule.chunkSize);
+
+        #pragma omp parallel num_threads(renderSchedule.resolvedThreadCount())
+        {
+            const math::Vector<ShapeVariant>& localShapes = sceneShapes.local();
+            const math::Vector<Light>& localLights = sceneLights.local();
+
+            // Samples of the current tile, reused for every tile of the thread
+            math::Vector<RGBA_Color> samples(tileSamples * tileSamples);
+
+            #pragma omp for collapse(2) schedule(dynamic, chunkSize)
+            for (size_t tileY = 0; tileY < tilesY; ++tileY) {
+                for (size_t tileX = 0; tileX < tilesX; ++tileX) {
+                    const size_t x0 = tileX * tileSize;
+                    const size_t y0 = tileY * tileSize;
+                    const size_t x1 = std::min(imageWidth, x0 + tileSize);
+                    const size_t y1 = std::min(imageHeight, y0 + tileSize);
+
+                    for (size_t sy = 0; sy < (y1 - y0) * factor; ++sy) {
+                        for (size_t sx = 0; sx < (x1 - x0) * factor; ++sx) {
+                            Ray ray = generateRayForPixel(x0 * factor + sx, y0 * factor + sy, sampleWidth, sampleHeight, true);
+                            RGBA_Color color(1.0, 0.0, 1.0, 1.0); // Debug magenta, as an untouched framebuffer pixel
+                            shadeLightSample(ray, localShapes, localLights, advanced, lighting, color);
+                            samples[sy * tileSamples + sx] = color;
+                        }
+                    }
+
+                    for (size_t y = y0; y < y1; ++y) {
+                        for (size_t x = x0; x < x1; ++x) {
+                            Image3D.setPixel(x, y, resolveSupersampledPixel(samplesPerPixel, [&](size_t ax, size_t ay) {
+                                return samples[((y - y0) * factor + ay) * tileSamples + (x - x0) * factor + ax];
+                            }));
+                        }
+                    }
+                }
+            }
+        }
+
+        return Image3D;
+    }
+
+    Image Camera::renderScene3DLight_Planned(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, const RenderPlan& plan, bool advanced) const {
+        switch (plan.method) {
+            case Camera::AntiAliasingMethod::NONE: {
+                return advanced ? renderScene3DLight_Advanced(imageWidth, imageHeight, shapes, lights)
+                                : renderScene3DLight(imageWidth, imageHeight, shapes, lights);
+            }
+            case Camera::AntiAliasingMethod::SSAA: {
+                if (plan.ssaaStrategy == SSAAStrategy::TILED) {
+                    return renderScene3DLight_SSAATiled(imageWidth, imageHeight, shapes, lights, plan.samplesPerPixel, plan.tileSize, advanced);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+
+        return advanced ? renderScene3DLight_Advanced_AA(imageWidth, imageHeight, shapes, lights, plan.samplesPerPixel, plan.method)
+                        : renderScene3DLight_AA(imageWidth, imageHeight, shapes, lights, plan.samplesPerPixel, plan.method);
+    }
+
+    Image Camera::renderScene3DLight_Preview(size_t imageWidth, size_t imageHeight, math::Vector<ShapeVariant> shapes, math::Vector<Light> lights, size_t samplesPerPixel, GBuffer& gbuffer, bool advanced) const {
+        if (samplesPerPixel == 0) {
+            throw std::invalid_argument("samplesPerPixel must be positive");
+        }
+
+        gbuffer = GBuffer(imageWidth, imageHeight);
+        Image Image3D = makeFramebuffer(imageWidth, imageHeight, framebufferLayout);
+
+        if (shapes.size() == 0 || lights.size() == 0) {
+            return Image3D; // Return empty image if no shapes or lights
+        }
+
+        // Per-node copies of the scene when replication is enabled on a NUMA host
+        NodeReplicated<math::Vector<ShapeVariant>> sceneShapes(shapes, sceneReplication);
+        NodeReplicated<math::Vector<Light>> sceneLights(lights, sceneReplication);
+        LightingStorage lightingStorage;
+        const LightingCache lighting = prepareLighting(shapes, lights, lightingStorage, getPixelSpread(imageWidth, imageHeight));
+
+        forEachPixel(imageWidth, imageHeight, renderSchedule, [&](size_t x, size_t y) {
+            const math::Vector<ShapeVariant>& localShapes = sceneShapes.local();
+            const math::Vector<Light>& localLights = sceneLights.local();
+
+            // Guide: the closest surface at the pixel sample point
+            Ray centerRay = generateRayForPixel(x, y, imageWidth, imageHeight, true);
+            Hit hit{std::numeric_limits<double>::infinity(), 0};
+            double closestDistance = std::numeric_limits<double>::infinity();
+            for (size_t i = 0; i < localShapes.size(); ++i) {
+                std::visit([&](auto&& shape) {
+                    if (shape.getGeometry()) {
+                        if (auto d = shape.getGeometry()->rayIntersectDepth(centerRay, closestDistance)) {
+                            // only accept hits in front of the origin
+                            if (*d > 1e-9) {
+                                hit = Hit{*d, i};
+                                closestDistance = *d;
+                            }
+                        }
+                    }
+                }, localShapes[i]);
+            }
+            if (closestDistance < std::numeric_limits<double>::infinity()) {
+                Vector3D hitPoint = centerRay.getPointAt(hit.t);
+                gbuffer.depth(x, y) = hit.t;
+                gbuffer.normal(x, y) = std::visit([&](auto&& shape) { return shape.getNormalAt(hitPoint); }, localShapes[hit.shapeIndex]);
+                gbuffer.albedo(x, y) = shapeDisplayColor(localShapes[hit.shapeIndex]);
+            }
+
+            RGBA_Color pixelColor;
+            if (samplesPerPixel == 1) {
+                if (shadeLightSample(centerRay, localShapes, localLights, advanced, lighting, pixelColor)) {
+                    Image3D.setPixel(x, y, pixelColor);
+                }
+                return;
+            }
+
+            // Uncovered samples keep the background
+            const RGBA_Color background = Image3D.getPixel(x, y);
+            double accR = 0.0, accG = 0.0, accB = 0.0, accA = 0.0;
+            bool hitFound = false;
+            for (size_t sample = 0; sample < samplesPerPixel; ++sample) {
+                RGBA_Color sampleColor = background;
+                hitFound |= shadeLightSample(generateRandomRayForPixel(x, y, imageWidth, imageHeight, true), localShapes, localLights, advanced, lighting, sampleColor).has_value();
+                accR += sampleColor.r();
+                accG += sampleColor.g();
+                accB += sampleColor.b();
+                accA += sampleColor.a();
+            }
+            if (hitFound) {
+                double numSamples = static_cast<double>(samplesPerPixel);
+                Image3D.setPixel(x, y, RGBA_Color(accR / numSamples, accG / numSamples, accB / numSamples, accA / numSamples).clamp());
+            }
+        });
+
+        return Image3D;
+    }
+
+} // namespace rendering
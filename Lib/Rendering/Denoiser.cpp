@@ -0,0 +1,250 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "Denoiser.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace rendering {
+
+    namespace {
+
+        /// B3-spline kernel of the à-trous passes
+        constexpr float KERNEL[5] = {1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f};
+
+        /// log2(e), the falloff is a power of two so exp(-x) is 2^-(x * LOG2_E)
+        constexpr double LOG2_E = 1.4426950408889634;
+
+        /// Largest exponent of the falloff, past it a tap weighs 2^-100 and stays a normal float
+        constexpr float MAX_FALLOFF_EXPONENT = 100.0f;
+
+        /// Depth of background pixels, far enough that any surface tap hits the falloff cap
+        constexpr float BACKGROUND_DEPTH = 1e30f;
+
+        inline int32_t floatBits(float value) {
+            int32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        inline float bitsFloat(int32_t bits) {
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        /**
+         * Edge-stopping falloff 2^-exponent, to a relative error below 1e-4
+         * Split as 2^-(whole + 1) * 2^(1 - fraction): the first factor is built in the exponent
+         * bits, the second is a cubic fit on [0, 1]. Only multiplies, adds and integer operations,
+         * so the tap loop vectorizes where std::exp would be a scalar call. The exponent is capped
+         * so far taps never produce denormals, which are slow on most cores.
+         */
+        inline float falloff(float exponent) {
+            // Non-negative floats order like their bits, and an integer select if-converts where a
+            // float one does not under trapping math. Rounding may leave the exponent slightly
+            // negative, which only makes the fraction slightly negative.
+            const int32_t capBits = floatBits(MAX_FALLOFF_EXPONENT);
+            int32_t bits = floatBits(exponent);
+            float t = bitsFloat(bits < capBits ? bits : capBits);
+
+            int32_t whole = static_cast<int32_t>(t);
+            float g = 1.0f - (t - static_cast<float>(whole));
+            float mantissa = 1.0f + g * (0.69512331f + g * (0.22764372f + g * 0.07705975f));
+            return mantissa * bitsFloat((126 - whole) << 23);
+        }
+
+        /// Planar row-major copy of an image, one array per channel, so rows load into SIMD lanes
+        struct ColorPlanes {
+            math::Vector<float> r, g, b, a;
+
+            explicit ColorPlanes(size_t pixelCount) : r(pixelCount), g(pixelCount), b(pixelCount), a(pixelCount) {}
+        };
+
+        /// Planar row-major copy of a G-buffer
+        struct GuidePlanes {
+            math::Vector<float> depth, inverseDepth, normalX, normalY, normalZ, albedoR, albedoG, albedoB;
+
+            explicit GuidePlanes(size_t pixelCount)
+                : depth(pixelCount), inverseDepth(pixelCount), normalX(pixelCount), normalY(pixelCount), normalZ(pixelCount),
+                  albedoR(pixelCount), albedoG(pixelCount), albedoB(pixelCount) {}
+        };
+
+    } // namespace
+
+    Denoiser::Denoiser(size_t iterations) : iterations(iterations) {}
+
+    Image Denoiser::denoise(const Image& noisy, const GBuffer& guide) const {
+        const size_t width = noisy.getWidth();
+        const size_t height = noisy.getHeight();
+        if (guide.getWidth() != width || guide.getHeight() != height) {
+            throw std::invalid_argument("G-buffer size does not match image size");
+        }
+        if (iterations == 0 || width == 0 || height == 0) {
+            return noisy;
+        }
+
+        const size_t pixelCount = width * height;
+        ColorPlanes source(pixelCount), target(pixelCount);
+        GuidePlanes planes(pixelCount);
+
+        const PixelBuffer<RGBA_Color>& noisyPixels = noisy.getPixelBuffer();
+        // Albedos are stored scaled, so their squared difference is already a falloff exponent
+        const float albedoScale = static_cast<float>(std::sqrt(LOG2_E) / albedoSigma);
+
+        #pragma omp parallel for schedule(static)
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                size_t i = y * width + x;
+                const RGBA_Color& color = noisyPixels(x, y);
+                source.r[i] = static_cast<float>(color.r());
+                source.g[i] = static_cast<float>(color.g());
+                source.b[i] = static_cast<float>(color.b());
+                source.a[i] = static_cast<float>(color.a());
+
+                double depth = guide.depth(x, y);
+                bool covered = depth < std::numeric_limits<double>::infinity();
+                // Background pixels share a far depth with a unit scale and a normal, so they only
+                // blend with each other: surfaces and background are always a capped falloff apart
+                const Vector3D& normal = guide.normal(x, y);
+                const RGBA_Color& albedo = guide.albedo(x, y);
+                planes.depth[i] = covered ? static_cast<float>(depth) : BACKGROUND_DEPTH;
+                planes.inverseDepth[i] = covered ? 1.0f / (static_cast<float>(depth) + 1e-6f) : 1.0f;
+                planes.normalX[i] = covered ? static_cast<float>(normal.x()) : 0.0f;
+                planes.normalY[i] = covered ? static_cast<float>(normal.y()) : 0.0f;
+                planes.normalZ[i] = covered ? static_cast<float>(normal.z()) : 1.0f;
+                planes.albedoR[i] = static_cast<float>(albedo.r()) * albedoScale;
+                planes.albedoG[i] = static_cast<float>(albedo.g()) * albedoScale;
+                planes.albedoB[i] = static_cast<float>(albedo.b()) * albedoScale;
+            }
+        }
+
+        // Weights are exp(-distance / sigma), computed as 2^-(distance * log2(e) / sigma)
+        const float normalScale = static_cast<float>(LOG2_E / normalSigma);
+
+        for (size_t pass = 0; pass < iterations; ++pass) {
+            const std::ptrdiff_t step = std::ptrdiff_t(1) << pass;
+            // Later passes average already smoothed colors, so they tolerate less difference
+            const double passColorSigma = colorSigma / static_cast<double>(step);
+            const float colorScale = static_cast<float>(LOG2_E / (passColorSigma * passColorSigma));
+            const float depthScale = static_cast<float>(LOG2_E / (depthSigma * static_cast<double>(step)));
+
+            // Raw planes, the SIMD loops must not go through bounds-checked accessors
+            const float* srcR = source.r.begin();
+            const float* srcG = source.g.begin();
+            const float* srcB = source.b.begin();
+            const float* srcA = source.a.begin();
+            const float* depth = planes.depth.begin();
+            const float* inverseDepth = planes.inverseDepth.begin();
+            const float* normalX = planes.normalX.begin();
+            const float* normalY = planes.normalY.begin();
+            const float* normalZ = planes.normalZ.begin();
+            const float* albedoR = planes.albedoR.begin();
+            const float* albedoG = planes.albedoG.begin();
+            const float* albedoB = planes.albedoB.begin();
+            float* dstR = target.r.begin();
+            float* dstG = target.g.begin();
+            float* dstB = target.b.begin();
+            float* dstA = target.a.begin();
+
+            #pragma omp parallel
+            {
+                // Accumulators of one row, reused for every row of the thread
+                math::Vector<float> rowR(width), rowG(width), rowB(width), rowA(width), rowW(width);
+                float* accR = rowR.begin();
+                float* accG = rowG.begin();
+                float* accB = rowB.begin();
+                float* accA = rowA.begin();
+                float* accW = rowW.begin();
+
+                #pragma omp for schedule(static)
+                for (size_t y = 0; y < height; ++y) {
+                    std::fill(accR, accR + width, 0.0f);
+                    std::fill(accG, accG + width, 0.0f);
+                    std::fill(accB, accB + width, 0.0f);
+                    std::fill(accA, accA + width, 0.0f);
+                    std::fill(accW, accW + width, 0.0f);
+
+                    const size_t row = y * width;
+                    for (int ky = -2; ky <= 2; ++ky) {
+                        std::ptrdiff_t qy = static_cast<std::ptrdiff_t>(y) + ky * step;
+                        if (qy < 0 || qy >= static_cast<std::ptrdiff_t>(height)) {
+                            continue;
+                        }
+                        for (int kx = -2; kx <= 2; ++kx) {
+                            // Taps falling outside the image are skipped, so the x range of a tap is contiguous
+                            const std::ptrdiff_t offset = kx * step;
+                            const std::ptrdiff_t begin = std::max<std::ptrdiff_t>(0, -offset);
+                            const std::ptrdiff_t end = std::min<std::ptrdiff_t>(static_cast<std::ptrdiff_t>(width), static_cast<std::ptrdiff_t>(width) - offset);
+                            const std::ptrdiff_t tapRow = qy * static_cast<std::ptrdiff_t>(width) + offset;
+                            const float kernel = KERNEL[ky + 2] * KERNEL[kx + 2];
+
+                            #pragma omp simd
+                            for (std::ptrdiff_t x = begin; x < end; ++x) {
+                                const size_t p = row + static_cast<size_t>(x);
+                                const size_t q = static_cast<size_t>(tapRow + x);
+
+                                float dr = srcR[p] - srcR[q];
+                                float dg = srcG[p] - srcG[q];
+                                float db = srcB[p] - srcB[q];
+                                float colorDistance = dr * dr + dg * dg + db * db;
+
+                                float cosine = normalX[p] * normalX[q] + normalY[p] * normalY[q] + normalZ[p] * normalZ[q];
+                                float normalDistance = 1.0f - cosine;
+
+                                float depthDistance = std::fabs(depth[p] - depth[q]) * inverseDepth[p];
+
+                                float ar = albedoR[p] - albedoR[q];
+                                float ag = albedoG[p] - albedoG[q];
+                                float ab = albedoB[p] - albedoB[q];
+                                float albedoDistance = ar * ar + ag * ag + ab * ab;
+
+                                float weight = kernel * falloff(colorDistance * colorScale + normalDistance * normalScale
+                                                                + depthDistance * depthScale + albedoDistance);
+
+                                accR[x] += weight * srcR[q];
+                                accG[x] += weight * srcG[q];
+                                accB[x] += weight * srcB[q];
+                                accA[x] += weight * srcA[q];
+                                accW[x] += weight;
+                            }
+                        }
+                    }
+
+                    // The center tap always has a positive weight
+                    #pragma omp simd
+                    for (size_t x = 0; x < width; ++x) {
+                        float inverse = 1.0f / accW[x];
+                        dstR[row + x] = accR[x] * inverse;
+                        dstG[row + x] = accG[x] * inverse;
+                        dstB[row + x] = accB[x] * inverse;
+                        dstA[row + x] = accA[x] * inverse;
+                    }
+                }
+            }
+
+            std::swap(source, target);
+        }
+
+        Image result(noisy);
+        PixelBuffer<RGBA_Color>& resultPixels = result.getPixelBuffer();
+        #pragma omp parallel for schedule(static)
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                size_t i = y * width + x;
+                // setRGBA clamps
+                resultPixels(x, y).setRGBA(source.r[i], source.g[i], source.b[i], source.a[i]);
+            }
+        }
+        return result;
+    }
+
+} // namespace rendering
@@ -0,0 +1,113 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef DENOISER_H
+#define DENOISER_H
+
+#include "Image.h"
+#include "PixelBuffer.hpp"
+#include "RGBA_Color.h"
+#include "../Geometry/Vector3D.h"
+
+#include <cstddef>
+#include <limits>
+
+using namespace geometry;
+
+namespace rendering {
+
+    /**
+     * @struct GBuffer
+     * @brief What the primary ray of each pixel saw, captured while rendering.
+     */
+    struct GBuffer {
+        PixelBuffer<double> depth;          ///< Distance to the surface, infinity where nothing was hit
+        PixelBuffer<Vector3D> normal;       ///< Surface normal, zero where nothing was hit
+        PixelBuffer<RGBA_Color> albedo;     ///< Display color of the surface (see shapeDisplayColor)
+
+        GBuffer() = default;
+
+        /**
+         * @brief Constructor of an empty G-buffer, every pixel seeing nothing
+         * @param width The width in pixels
+         * @param height The height in pixels
+         */
+        GBuffer(size_t width, size_t height)
+            : depth(width, height, std::numeric_limits<double>::infinity()),
+              normal(width, height),
+              albedo(width, height, RGBA_Color(0, 0, 0, 1)) {}
+
+        size_t getWidth() const { return depth.getWidth(); }
+        size_t getHeight() const { return depth.getHeight(); }
+    };
+
+    /**
+     * @class Denoiser
+     * @brief Edge-avoiding à-trous wavelet filter for low sample renders.
+     *
+     * Each pass blurs the image with a 5x5 B3-spline kernel whose taps are spaced 2^pass pixels
+     * apart, so five passes cover a 125 pixel wide footprint for the cost of 125 taps. Every tap
+     * is weighted down by its difference in color, depth, normal and albedo with the center, so
+     * noise is averaged away inside surfaces but not across their edges. Passes run on planar
+     * float copies of the buffers, rows in parallel and pixels of a row in SIMD lanes.
+     */
+    class Denoiser {
+    public:
+        /**
+         * @brief Constructor
+         * @param iterations The number of à-trous passes
+         */
+        explicit Denoiser(size_t iterations = 5);
+
+        /**
+         * @brief Filter a render
+         * @param noisy The render to filter
+         * @param guide The G-buffer captured with it
+         * @return Image The filtered render, in the layout of noisy
+         * @throws std::invalid_argument if the G-buffer does not have the size of the image
+         */
+        Image denoise(const Image& noisy, const GBuffer& guide) const;
+
+        void setIterations(size_t count) { iterations = count; }
+        size_t getIterations() const { return iterations; }
+
+        /**
+         * @brief Set how much color difference is tolerated, halved at every pass
+         * @param sigma The standard deviation of the color weight, 0.5 by default
+         */
+        void setColorSigma(double sigma) { colorSigma = sigma; }
+        double getColorSigma() const { return colorSigma; }
+
+        /**
+         * @brief Set how much relative depth difference per pixel of distance is tolerated
+         * @param sigma The depth tolerance, 0.05 by default
+         */
+        void setDepthSigma(double sigma) { depthSigma = sigma; }
+        double getDepthSigma() const { return depthSigma; }
+
+        /**
+         * @brief Set how much normal difference is tolerated
+         * @param sigma The tolerance on 1 - cos of the angle between normals, 0.1 by default
+         */
+        void setNormalSigma(double sigma) { normalSigma = sigma; }
+        double getNormalSigma() const { return normalSigma; }
+
+        /**
+         * @brief Set how much albedo difference is tolerated
+         * @param sigma The standard deviation of the albedo weight, 0.1 by default
+         */
+        void setAlbedoSigma(double sigma) { albedoSigma = sigma; }
+        double getAlbedoSigma() const { return albedoSigma; }
+
+    private:
+        size_t iterations;
+        double colorSigma = 0.5;
+        double depthSigma = 0.05;
+        double normalSigma = 0.1;
+        double albedoSigma = 0.1;
+    };
+
+} // namespace rendering
+
+#endif // DENOISER_H
@@ -0,0 +1,543 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "DynamicBVH.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+namespace rendering {
+
+    namespace {
+
+        constexpr double EPSILON = 1e-9;
+
+        // Grow a vector to hold at least size entries, keeping its contents
+        template<typename T>
+        void reserveEntries(math::Vector<T>& vector, size_t size) {
+            if (vector.size() >= size) {
+                return;
+            }
+            math::Vector<T> grown(std::max<size_t>({size, vector.size() * 2, 16}));
+            for (size_t i = 0; i < vector.size(); ++i) {
+                grown[i] = std::move(vector[i]);
+            }
+            vector = std::move(grown);
+        }
+
+        // Distance along the ray to the entry of a box, infinity if the ray misses it before tmax
+        double slabEntry(const Bounds3D& bounds, const double* origin, const double* inverse, double tmax) {
+            double tNear = 0.0, tFar = tmax;
+            for (int axis = 0; axis < 3; ++axis) {
+                double t0 = (bounds.low[axis] - origin[axis]) * inverse[axis];
+                double t1 = (bounds.high[axis] - origin[axis]) * inverse[axis];
+                // NaN bounds (a flat box seen edge on) leave the interval unchanged
+                tNear = std::max(tNear, std::min(t0, t1));
+                tFar = std::min(tFar, std::max(t0, t1));
+            }
+            return tNear <= tFar ? tNear : std::numeric_limits<double>::infinity();
+        }
+
+        // The traversal stack of the calling thread, grown to the height of the trees it walks
+        math::Vector<size_t>& traversalStack() {
+            thread_local math::Vector<size_t> stack(64);
+            return stack;
+        }
+
+    } // namespace
+
+    // ========== DynamicBVH ==========
+
+    DynamicBVH::DynamicBVH(double rebuildThreshold) : rebuildThreshold(rebuildThreshold) {
+        if (!(rebuildThreshold > 1.0)) {
+            throw std::invalid_argument("BVH rebuild threshold must be above 1");
+        }
+    }
+
+    bool DynamicBVH::boundsOf(const Camera::ShapeVariant& shape, Bounds3D& bounds) {
+        return std::visit([&](auto&& typedShape) {
+            using T = std::decay_t<decltype(typedShape)>;
+            const auto* geom = typedShape.getGeometry();
+            if (!geom) {
+                return false;
+            }
+
+            if constexpr (std::is_same_v<T, Shape<Box>>) {
+                Vector3D corners[8];
+                geom->getCorners(corners);
+                bounds = Bounds3D(corners[0], corners[0]);
+                for (const Vector3D& corner : corners) {
+                    bounds = bounds.merged(Bounds3D(corner, corner));
+                }
+                return true;
+            } else if constexpr (std::is_same_v<T, Shape<Circle>> || std::is_same_v<T, Shape<Sphere>>) {
+                Vector3D extent(geom->getRadius(), geom->getRadius(), geom->getRadius());
+                bounds = Bounds3D(geom->getCenter() - extent, geom->getCenter() + extent);
+                return true;
+            } else if constexpr (std::is_same_v<T, Shape<Rectangle>>) {
+                Vector3D corners[4];
+                geom->getCorners(corners);
+                bounds = Bounds3D(corners[0], corners[0]);
+                for (const Vector3D& corner : corners) {
+                    bounds = bounds.merged(Bounds3D(corner, corner));
+                }
+                return true;
+            } else {
+                return false;
+            }
+        }, shape);
+    }
+
+    size_t DynamicBVH::allocateNode() {
+        if (freeList != NONE) {
+            size_t node = freeList;
+            freeList = nodes[node].parent;
+            nodes[node] = Node();
+            return node;
+        }
+        reserveEntries(nodes, nodeCount + 1);
+        nodes[nodeCount] = Node();
+        return nodeCount++;
+    }
+
+    void DynamicBVH::freeNode(size_t node) {
+        nodes[node] = Node();
+        nodes[node].isFree = true;
+        nodes[node].parent = freeList;
+        freeList = node;
+    }
+
+    void DynamicBVH::checkLeaf(size_t proxy) const {
+        if (proxy >= nodeCount || nodes[proxy].isFree || !nodes[proxy].isLeaf()) {
+            throw std::out_of_range("Invalid BVH proxy");
+        }
+    }
+
+    size_t DynamicBVH::insert(size_t object, const Bounds3D& bounds) {
+        size_t leaf = allocateNode();
+        nodes[leaf].bounds = bounds;
+        nodes[leaf].builtArea = bounds.surfaceArea();
+        nodes[leaf].object = object;
+        ++leafCount;
+        attachLeaf(leaf);
+        return leaf;
+    }
+
+    void DynamicBVH::attachLeaf(size_t leaf) {
+        if (root == NONE) {
+            nodes[leaf].parent = NONE;
+            root = leaf;
+            return;
+        }
+
+        const Bounds3D& bounds = nodes[leaf].bounds;
+        size_t sibling = findSibling(bounds);
+        size_t parent = allocateNode();
+        size_t grandParent = nodes[sibling].parent;
+        nodes[parent].parent = grandParent;
+        nodes[parent].left = sibling;
+        nodes[parent].right = leaf;
+        nodes[parent].bounds = nodes[sibling].bounds.merged(nodes[leaf].bounds);
+        nodes[parent].builtArea = nodes[parent].bounds.surfaceArea();
+        nodes[sibling].parent = parent;
+        nodes[leaf].parent = parent;
+
+        if (grandParent == NONE) {
+            root = parent;
+        } else {
+            if (nodes[grandParent].left == sibling) {
+                nodes[grandParent].left = parent;
+            } else {
+                nodes[grandParent].right = parent;
+            }
+            refitFrom(grandParent, true);
+        }
+    }
+
+    size_t DynamicBVH::findSibling(const Bounds3D& bounds) const {
+        // Descend while growing a child costs less than pairing with the whole node
+        size_t index = root;
+        while (!nodes[index].isLeaf()) {
+            const Node& node = nodes[index];
+            double area = node.bounds.surfaceArea();
+            double combinedArea = node.bounds.merged(bounds).surfaceArea();
+            double cost = 2.0 * combinedArea;
+            double inheritance = 2.0 * (combinedArea - area);
+
+            auto descendCost = [&](size_t child) {
+                double grown = nodes[child].bounds.merged(bounds).surfaceArea();
+                return nodes[child].isLeaf() ? grown + inheritance : grown - nodes[child].bounds.surfaceArea() + inheritance;
+            };
+            double leftCost = descendCost(node.left);
+            double rightCost = descendCost(node.right);
+
+            if (cost < leftCost && cost < rightCost) {
+                break;
+            }
+            index = leftCost < rightCost ? node.left : node.right;
+        }
+        return index;
+    }
+
+    void DynamicBVH::refitFrom(size_t node, bool structural) {
+        size_t degraded = NONE;
+        while (node != NONE) {
+            Node& current = nodes[node];
+            Bounds3D bounds = nodes[current.left].bounds.merged(nodes[current.right].bounds);
+            if (bounds == current.bounds) {
+                break;
+            }
+            double area = bounds.surfaceArea();
+            if (structural) {
+                // Insertions and removals change what the subtree holds, not its quality
+                current.builtArea = std::max(0.0, current.builtArea + area - current.bounds.surfaceArea());
+            } else if (area > rebuildThreshold * current.builtArea) {
+                degraded = node;
+            }
+            current.bounds = bounds;
+            rotate(node);
+            node = nodes[node].parent;
+        }
+
+        if (degraded != NONE) {
+            rebuildSubtree(degraded);
+            ++subtreeRebuildCount;
+        }
+    }
+
+    void DynamicBVH::rotate(size_t node) {
+        const size_t left = nodes[node].left, right = nodes[node].right;
+
+        // Swapping a child with a grandchild under the other child leaves the node bounds unchanged
+        // and only resizes that other child: keep the swap shrinking it the most
+        double bestGain = 0.0;
+        size_t moved = NONE, grandChild = NONE, under = NONE;
+        auto consider = [&](size_t child, size_t other) {
+            if (nodes[other].isLeaf()) {
+                return;
+            }
+            double area = nodes[other].bounds.surfaceArea();
+            const size_t grandChildren[2] = {nodes[other].left, nodes[other].right};
+            for (int i = 0; i < 2; ++i) {
+                double gain = area - nodes[child].bounds.merged(nodes[grandChildren[1 - i]].bounds).surfaceArea();
+                if (gain > bestGain) {
+                    bestGain = gain;
+                    moved = child;
+                    grandChild = grandChildren[i];
+                    under = other;
+                }
+            }
+        };
+        consider(left, right);
+        consider(right, left);
+        if (moved == NONE) {
+            return;
+        }
+
+        if (nodes[node].left == moved) {
+            nodes[node].left = grandChild;
+        } else {
+            nodes[node].right = grandChild;
+        }
+        nodes[grandChild].parent = node;
+        if (nodes[under].left == grandChild) {
+            nodes[under].left = moved;
+        } else {
+            nodes[under].right = moved;
+        }
+        nodes[moved].parent = under;
+        nodes[under].bounds = nodes[nodes[under].left].bounds.merged(nodes[nodes[under].right].bounds);
+        nodes[under].builtArea = nodes[under].bounds.surfaceArea();
+    }
+
+    void DynamicBVH::remove(size_t proxy) {
+        checkLeaf(proxy);
+        detachLeaf(proxy);
+        freeNode(proxy);
+        --leafCount;
+    }
+
+    void DynamicBVH::detachLeaf(size_t leaf) {
+        size_t parent = nodes[leaf].parent;
+        nodes[leaf].parent = NONE;
+        if (parent == NONE) {
+            root = NONE;
+            return;
+        }
+
+        size_t grandParent = nodes[parent].parent;
+        size_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+        if (grandParent == NONE) {
+            root = sibling;
+            return;
+        }
+        if (nodes[grandParent].left == parent) {
+            nodes[grandParent].left = sibling;
+        } else {
+            nodes[grandParent].right = sibling;
+        }
+        refitFrom(grandParent, true);
+    }
+
+    void DynamicBVH::update(size_t proxy, const Bounds3D& bounds) {
+        checkLeaf(proxy);
+        if (nodes[proxy].bounds == bounds) {
+            return;
+        }
+        nodes[proxy].bounds = bounds;
+        nodes[proxy].builtArea = bounds.surfaceArea();
+        size_t parent = nodes[proxy].parent;
+        if (parent == NONE) {
+            return;
+        }
+
+        // An object that left its sibling behind is moved to a better place instead of stretching its ancestors
+        size_t sibling = nodes[parent].left == proxy ? nodes[parent].right : nodes[parent].left;
+        if (nodes[sibling].bounds.merged(bounds).surfaceArea() > rebuildThreshold * nodes[parent].builtArea) {
+            detachLeaf(proxy);
+            attachLeaf(proxy);
+            ++reinsertionCount;
+            return;
+        }
+        refitFrom(parent, false);
+    }
+
+    void DynamicBVH::setObject(size_t proxy, size_t object) {
+        checkLeaf(proxy);
+        nodes[proxy].object = object;
+    }
+
+    size_t DynamicBVH::getObject(size_t proxy) const {
+        checkLeaf(proxy);
+        return nodes[proxy].object;
+    }
+
+    const Bounds3D& DynamicBVH::getBounds(size_t proxy) const {
+        checkLeaf(proxy);
+        return nodes[proxy].bounds;
+    }
+
+    void DynamicBVH::rebuild() {
+        if (root != NONE) {
+            rebuildSubtree(root);
+        }
+    }
+
+    void DynamicBVH::clear() {
+        nodes.clear();
+        scratch.clear();
+        nodeCount = 0;
+        freeList = NONE;
+        root = NONE;
+        leafCount = 0;
+    }
+
+    size_t DynamicBVH::gatherLeaves(size_t node) {
+        // Breadth first in scratch: internal nodes are freed as they are expanded, leaves kept
+        reserveEntries(scratch, nodeCount);
+        size_t head = 0, tail = 0, leaves = 0;
+        scratch[tail++] = node;
+        while (head < tail) {
+            size_t current = scratch[head++];
+            if (nodes[current].isLeaf()) {
+                scratch[leaves++] = current;
+            } else {
+                scratch[tail++] = nodes[current].left;
+                scratch[tail++] = nodes[current].right;
+                freeNode(current);
+            }
+        }
+        return leaves;
+    }
+
+    void DynamicBVH::rebuildSubtree(size_t node) {
+        if (nodes[node].isLeaf()) {
+            return;
+        }
+        size_t parent = nodes[node].parent;
+        bool isLeft = parent != NONE && nodes[parent].left == node;
+
+        size_t count = gatherLeaves(node);
+        size_t rebuilt = buildRange(0, count, parent);
+        if (parent == NONE) {
+            root = rebuilt;
+        } else if (isLeft) {
+            nodes[parent].left = rebuilt;
+        } else {
+            nodes[parent].right = rebuilt;
+        }
+    }
+
+    size_t DynamicBVH::buildRange(size_t begin, size_t end, size_t parent) {
+        if (end - begin == 1) {
+            nodes[scratch[begin]].parent = parent;
+            return scratch[begin];
+        }
+
+        // Median split of the leaf centers along the longest side of their bounds
+        double low[3], high[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            low[axis] = std::numeric_limits<double>::infinity();
+            high[axis] = -std::numeric_limits<double>::infinity();
+        }
+        for (size_t i = begin; i < end; ++i) {
+            for (int axis = 0; axis < 3; ++axis) {
+                double center = nodes[scratch[i]].bounds.center(axis);
+                low[axis] = std::min(low[axis], center);
+                high[axis] = std::max(high[axis], center);
+            }
+        }
+        int axis = 0;
+        for (int a = 1; a < 3; ++a) {
+            if (high[a] - low[a] > high[axis] - low[axis]) {
+                axis = a;
+            }
+        }
+        size_t middle = begin + (end - begin) / 2;
+        std::nth_element(scratch.begin() + begin, scratch.begin() + middle, scratch.begin() + end, [&](size_t a, size_t b) {
+            return nodes[a].bounds.center(axis) < nodes[b].bounds.center(axis);
+        });
+
+        // Every node freed by gatherLeaves is in the free list, so allocating never moves the nodes
+        size_t node = allocateNode();
+        nodes[node].parent = parent;
+        size_t left = buildRange(begin, middle, node);
+        size_t right = buildRange(middle, end, node);
+        nodes[node].left = left;
+        nodes[node].right = right;
+        nodes[node].bounds = nodes[left].bounds.merged(nodes[right].bounds);
+        nodes[node].builtArea = nodes[node].bounds.surfaceArea();
+        return node;
+    }
+
+    std::optional<Hit> DynamicBVH::findClosestHit(const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes, int excludeIndex) const {
+        if (root == NONE) {
+            return std::nullopt;
+        }
+
+        const Vector3D& direction = ray.getDirection();
+        const double origin[3] = {ray.getOrigin().x(), ray.getOrigin().y(), ray.getOrigin().z()};
+        const double inverse[3] = {1.0 / direction.x(), 1.0 / direction.y(), 1.0 / direction.z()};
+
+        Hit closest{std::numeric_limits<double>::infinity(), size_t(-1)};
+        math::Vector<size_t>& stack = traversalStack();
+        size_t top = 0;
+        if (slabEntry(nodes[root].bounds, origin, inverse, closest.t) < closest.t) {
+            stack[top++] = root;
+        }
+
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (node.isLeaf()) {
+                if (static_cast<int>(node.object) == excludeIndex) {
+                    continue;
+                }
+                std::visit([&](auto&& shape) {
+                    if (shape.getGeometry()) {
+                        if (auto d = shape.getGeometry()->rayIntersectDepth(ray, closest.t)) {
+                            // only accept hits in front of the origin
+                            if (*d > EPSILON && *d < closest.t) {
+                                closest = Hit{*d, node.object};
+                            }
+                        }
+                    }
+                }, shapes[node.object]);
+                continue;
+            }
+
+            // Nearest child on top of the stack, children the closest hit is in front of are skipped
+            double leftEntry = slabEntry(nodes[node.left].bounds, origin, inverse, closest.t);
+            double rightEntry = slabEntry(nodes[node.right].bounds, origin, inverse, closest.t);
+            size_t first = node.left, second = node.right;
+            if (rightEntry < leftEntry) {
+                std::swap(first, second);
+                std::swap(leftEntry, rightEntry);
+            }
+            reserveEntries(stack, top + 2);
+            if (rightEntry < closest.t) {
+                stack[top++] = second;
+            }
+            if (leftEntry < closest.t) {
+                stack[top++] = first;
+            }
+        }
+
+        if (closest.t == std::numeric_limits<double>::infinity()) {
+            return std::nullopt;
+        }
+        return closest;
+    }
+
+    size_t DynamicBVH::query(const Bounds3D& bounds, math::Vector<size_t>& objects) const {
+        if (root == NONE) {
+            return 0;
+        }
+
+        math::Vector<size_t>& stack = traversalStack();
+        size_t top = 0, count = 0;
+        stack[top++] = root;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (!node.bounds.overlaps(bounds)) {
+                continue;
+            }
+            if (node.isLeaf()) {
+                reserveEntries(objects, count + 1);
+                objects[count++] = node.object;
+            } else {
+                reserveEntries(stack, top + 2);
+                stack[top++] = node.left;
+                stack[top++] = node.right;
+            }
+        }
+        return count;
+    }
+
+    size_t DynamicBVH::getHeight() const {
+        if (root == NONE) {
+            return 0;
+        }
+        // Depth first with the depth of each node stored next to it
+        math::Vector<size_t> stack(2 * nodeCount + 2);
+        size_t top = 0, height = 0;
+        stack[top++] = root;
+        stack[top++] = 1;
+        while (top > 0) {
+            size_t depth = stack[--top];
+            size_t node = stack[--top];
+            height = std::max(height, depth);
+            if (!nodes[node].isLeaf()) {
+                stack[top++] = nodes[node].left;
+                stack[top++] = depth + 1;
+                stack[top++] = nodes[node].right;
+                stack[top++] = depth + 1;
+            }
+        }
+        return height;
+    }
+
+    double DynamicBVH::getCost() const {
+        if (root == NONE || nodes[root].isLeaf()) {
+            return 0.0;
+        }
+        double rootArea = nodes[root].bounds.surfaceArea();
+        if (rootArea <= 0.0) {
+            return 0.0;
+        }
+        double sum = 0.0;
+        for (size_t i = 0; i < nodeCount; ++i) {
+            if (!nodes[i].isFree && !nodes[i].isLeaf()) {
+                sum += nodes[i].bounds.surfaceArea();
+            }
+        }
+        return sum / rootArea;
+    }
+
+} // namespace rendering
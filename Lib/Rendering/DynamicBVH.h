@@ -0,0 +1,169 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef DYNAMIC_BVH_H
+#define DYNAMIC_BVH_H
+
+#include "Camera.h"
+#include "../Geometry/Bounds3D.h"
+#include "../Geometry/Ray.h"
+#include "../Geometry/Vector3D.h"
+#include "../Math/Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace rendering {
+
+    /**
+     * @class DynamicBVH
+     * @brief Bounding volume hierarchy over moving objects, kept up to date without global rebuilds.
+     *
+     * Each object is a leaf, its proxy, whose index stays valid until the object is removed.
+     * Insertion descends toward the sibling that grows the tree surface the least, removal splices
+     * the leaf out, and moving an object refits the bounds of its ancestors up to the first one
+     * that does not change, so updating k objects costs O(k log N). Every node refitted then tries
+     * to swap a child with a grandchild when it shrinks the surface of the tree (Kopta's rotations),
+     * which also keeps trees built by insertions alone shallow.
+     *
+     * Refitting keeps the tree correct but lets its quality drift as objects move apart. Every node
+     * remembers its surface area when it was last built. An object that would grow its parent past
+     * rebuildThreshold times that area is taken out and inserted again instead; when refits grow a
+     * node past it little by little, the highest such node on the path is rebuilt top down by
+     * median splits, which only touches the leaves under it.
+     */
+    class DynamicBVH {
+    public:
+        static constexpr size_t NONE = SIZE_MAX;
+        static constexpr double DEFAULT_REBUILD_THRESHOLD = 2.0;
+
+        /**
+         * @brief Create an empty tree
+         * @param rebuildThreshold The growth of a node surface that triggers the rebuild of its subtree
+         * @throws std::invalid_argument if rebuildThreshold is not above 1
+         */
+        explicit DynamicBVH(double rebuildThreshold = DEFAULT_REBUILD_THRESHOLD);
+
+        /**
+         * @brief Compute the bounds of a shape
+         * @param shape The shape
+         * @param bounds Output parameter for the bounds
+         * @return False if the shape has no geometry or is unbounded (planes)
+         */
+        static bool boundsOf(const Camera::ShapeVariant& shape, Bounds3D& bounds);
+
+        /**
+         * @brief Add an object
+         * @param object The index of the object, reported by queries
+         * @param bounds The bounds of the object
+         * @return The proxy of the object
+         */
+        size_t insert(size_t object, const Bounds3D& bounds);
+
+        /**
+         * @brief Remove an object
+         * @param proxy The proxy returned by insert
+         * @throws std::out_of_range if proxy is not a leaf of the tree
+         */
+        void remove(size_t proxy);
+
+        /**
+         * @brief Move an object, refitting its ancestors
+         * @param proxy The proxy returned by insert
+         * @param bounds The new bounds of the object
+         * @throws std::out_of_range if proxy is not a leaf of the tree
+         */
+        void update(size_t proxy, const Bounds3D& bounds);
+
+        /**
+         * @brief Change the object index a proxy reports
+         * @param proxy The proxy returned by insert
+         * @param object The new index of the object
+         * @throws std::out_of_range if proxy is not a leaf of the tree
+         */
+        void setObject(size_t proxy, size_t object);
+
+        size_t getObject(size_t proxy) const;
+        const Bounds3D& getBounds(size_t proxy) const;
+
+        /**
+         * @brief Rebuild the whole tree top down
+         */
+        void rebuild();
+
+        /**
+         * @brief Remove every object
+         */
+        void clear();
+
+        /**
+         * @brief Find the closest shape hit by a ray
+         * @param ray The ray
+         * @param shapes The shapes the object indices refer to
+         * @param excludeIndex The index of a shape to skip, -1 for none
+         * @return The closest hit, nullopt if no object is hit
+         */
+        std::optional<Hit> findClosestHit(const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes, int excludeIndex = -1) const;
+
+        /**
+         * @brief Collect the objects whose bounds overlap a box
+         * @param bounds The box
+         * @param objects Output parameter, filled from its first entry and grown when too small
+         * @return The number of objects found
+         */
+        size_t query(const Bounds3D& bounds, math::Vector<size_t>& objects) const;
+
+        size_t getLeafCount() const { return leafCount; }
+        size_t getHeight() const;
+        double getRebuildThreshold() const { return rebuildThreshold; }
+
+        /**
+         * @brief Get the surface area heuristic cost of the tree, lower traces faster
+         * @return The summed surface of the internal nodes relative to the root surface
+         */
+        double getCost() const;
+
+        size_t getSubtreeRebuildCount() const { return subtreeRebuildCount; }
+        size_t getReinsertionCount() const { return reinsertionCount; }
+
+    private:
+        /// Leaf or internal node, leaves have no children
+        struct Node {
+            Bounds3D bounds;
+            double builtArea = 0.0;     ///< Surface when the subtree was last built, grown by insertions
+            size_t parent = NONE;
+            size_t left = NONE;
+            size_t right = NONE;
+            size_t object = NONE;       ///< Object of a leaf
+            bool isFree = false;        ///< True while the node is in the free list
+            bool isLeaf() const { return left == NONE; }
+        };
+
+        double rebuildThreshold;
+        math::Vector<Node> nodes;
+        size_t nodeCount = 0;           ///< Nodes in use or in the free list
+        size_t freeList = NONE;         ///< Free nodes, chained through parent
+        size_t root = NONE;
+        size_t leafCount = 0;
+        size_t subtreeRebuildCount = 0;
+        size_t reinsertionCount = 0;
+        math::Vector<size_t> scratch;   ///< Leaves of the subtree being rebuilt
+
+        size_t allocateNode();
+        void freeNode(size_t node);
+        void checkLeaf(size_t proxy) const;
+        size_t findSibling(const Bounds3D& bounds) const;
+        void attachLeaf(size_t leaf);
+        void detachLeaf(size_t leaf);
+        void refitFrom(size_t node, bool structural);
+        void rotate(size_t node);
+        void rebuildSubtree(size_t node);
+        size_t gatherLeaves(size_t node);
+        size_t buildRange(size_t begin, size_t end, size_t parent);
+    };
+
+} // namespace rendering
+
+#endif // DYNAMIC_BVH_H
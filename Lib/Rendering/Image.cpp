@@ -8,14 +8,15 @@
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <utility>
 
 namespace rendering
 {
-    Image::Image() : width(0), height(0), pixels(0,0) {}
+    Image::Image() : width(0), height(0), pixels() {}
 
 
     // Constructor with width and height - initializes all colors to black
-    Image::Image(int w, int h) : width(0), height(0), pixels(1, 1) {
+    Image::Image(int w, int h, PixelLayout layout) : width(0), height(0), pixels() {
         if (w <= 0 || h <= 0)
         {
             throw std::invalid_argument("Image dimensions must be positive");
@@ -23,16 +24,9 @@ namespace rendering
 
         width = static_cast<size_t>(w);
         height = static_cast<size_t>(h);
-        pixels = math::Matrix<RGBA_Color>(height, width);
 
-        // Initialize all colors to black (0, 0, 0, 1)
-        for (size_t y = 0; y < height; ++y)
-        {
-            for (size_t x = 0; x < width; ++x)
-            {
-                pixels(y, x) = RGBA_Color(1.0, 0.0, 1.0, 1.0);
-            }
-        }
+        // Initialize all colors to the debug magenta, in static bands for first-touch placement
+        pixels = PixelBuffer<RGBA_Color>(width, height, RGBA_Color(1.0, 0.0, 1.0, 1.0), layout);
     }
 
     // Constructor from color matrix
@@ -49,9 +43,14 @@ namespace rendering
     // Copy constructor (Matrix has its own copy semantics)
     Image::Image(const Image &other) : width(other.width), height(other.height), pixels(other.pixels) {}
 
+    Image::Image(Image &&other) noexcept : width(other.width), height(other.height), pixels(std::move(other.pixels)) {
+        other.width = 0;
+        other.height = 0;
+    }
+
     // Constructor from file
     Image::Image(const std::string &filename, const std::string &filePath)
-        : width(0), height(0), pixels(1, 1) // initialize pixels to avoid requiring a default ctor
+        : width(0), height(0), pixels()
     {
         std::string fullPath = filePath + filename;
         
@@ -77,7 +76,7 @@ namespace rendering
         // Initialize image with detected dimensions (assign because pixels was already constructed)
         width = static_cast<size_t>(w);
         height = static_cast<size_t>(h);
-        pixels = math::Matrix<RGBA_Color>(height, width);
+        pixels = PixelBuffer<RGBA_Color>(width, height);
         
         // Read pixel data using ImageMagick convert command
         // Convert to RGBA text format for easy parsing
@@ -111,14 +110,14 @@ namespace rendering
                     double blue = b / 255.0;
                     double alpha = a / 255.0;
                     
-                    pixels(y, x) = RGBA_Color(red, green, blue, alpha);
+                    pixels(x, y) = RGBA_Color(red, green, blue, alpha);
                 } else if (sscanf(line, "%d,%d: (%d,%d,%d)", &px, &py, &r, &g, &b) == 5) {
                     // RGB format without alpha
                     double red = r / 255.0;
                     double green = g / 255.0;
                     double blue = b / 255.0;
                     
-                    pixels(y, x) = RGBA_Color(red, green, blue, 1.0);
+                    pixels(x, y) = RGBA_Color(red, green, blue, 1.0);
                 } else {
                     pclose(convertPipe);
                     throw std::runtime_error("Failed to parse pixel data at position (" + 
@@ -139,7 +138,22 @@ namespace rendering
 
         width = other.width;
         height = other.height;
-        pixels = other.pixels; // Matrix copy assignment
+        pixels = other.pixels; // PixelBuffer copy assignment
+
+        return *this;
+    }
+
+    Image &Image::operator=(Image &&other) noexcept {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        width = other.width;
+        height = other.height;
+        pixels = std::move(other.pixels);
+        other.width = 0;
+        other.height = 0;
 
         return *this;
     }
@@ -156,10 +170,18 @@ namespace rendering
         return width * height;
     }
 
+    PixelLayout Image::getLayout() const {
+        return pixels.getLayout();
+    }
+
+    void Image::setLayout(PixelLayout layout) {
+        pixels.setLayout(layout);
+    }
+
     bool Image::isValid() const {
         // Valid if dimensions are positive and the internal matrix matches
         if (width == 0 || height == 0) return false;
-        if (pixels.getRows() != height || pixels.getCols() != width) return false;
+        if (pixels.getHeight() != height || pixels.getWidth() != width) return false;
         return true;
     }
 
@@ -169,7 +191,7 @@ namespace rendering
             throw std::out_of_range("Color coordinates out of bounds");
         }
 
-        return pixels(y, x);
+        return pixels(x, y);
     }
 
     void Image::setPixel(size_t x, size_t y, const RGBA_Color &color) {
@@ -178,17 +200,11 @@ namespace rendering
             throw std::out_of_range("Color coordinates out of bounds");
         }
 
-        pixels(y, x) = color;
+        pixels(x, y) = color;
     }
 
     void Image::fill(const RGBA_Color &fillColor) {
-        for (size_t y = 0; y < height; ++y)
-        {
-            for (size_t x = 0; x < width; ++x)
-            {
-                pixels(y, x) = fillColor;
-            }
-        }
+        pixels.fill(fillColor);
     }
 
     void Image::clear() {
@@ -204,19 +220,19 @@ namespace rendering
         size_t minWidth = std::min(width, newWidth);
         size_t minHeight = std::min(height, newHeight);
 
-        // Preserve old matrix
-        math::Matrix<RGBA_Color> old = pixels;
+        // Preserve old pixels
+        PixelBuffer<RGBA_Color> old = pixels;
 
-        // Allocate new matrix
-        pixels = math::Matrix<RGBA_Color>(newHeight, newWidth);
+        // Allocate new pixels in the same layout
+        pixels = PixelBuffer<RGBA_Color>(newWidth, newHeight, old.getLayout());
 
         // Copy preserved pixels and initialize new ones to black
         for (size_t y = 0; y < newHeight; ++y) {
             for (size_t x = 0; x < newWidth; ++x) {
                 if (y < minHeight && x < minWidth) {
-                    pixels(y, x) = old(y, x);
+                    pixels(x, y) = old(x, y);
                 } else {
-                    pixels(y, x) = RGBA_Color(0.0, 0.0, 0.0, 1.0);
+                    pixels(x, y) = RGBA_Color(0.0, 0.0, 0.0, 1.0);
                 }
             }
         }
@@ -230,7 +246,7 @@ namespace rendering
         {
             for (size_t x = 0; x < width; ++x)
             {
-                pixels(y, x) = pixels(y, x).toGrayscale();
+                pixels(x, y) = pixels(x, y).toGrayscale();
             }
         }
     }
@@ -253,7 +269,7 @@ namespace rendering
         {
             for (size_t x = 0; x < width; ++x)
             {
-                pixels(y, x).invert();
+                pixels(x, y).invert();
             }
         }
     }
@@ -349,7 +365,7 @@ namespace rendering
             // Fill row data
             for (int x = 0; x < w_i; ++x)
             {
-                const RGBA_Color color = pixels(static_cast<size_t>(y), static_cast<size_t>(x));
+                const RGBA_Color& color = pixels(static_cast<size_t>(x), static_cast<size_t>(y));
                 rowData[x * 4 + 0] = static_cast<unsigned char>(std::clamp(color.b() * 255.0, 0.0, 255.0)); // Blue
                 rowData[x * 4 + 1] = static_cast<unsigned char>(std::clamp(color.g() * 255.0, 0.0, 255.0)); // Green
                 rowData[x * 4 + 2] = static_cast<unsigned char>(std::clamp(color.r() * 255.0, 0.0, 255.0)); // Red
@@ -506,8 +522,8 @@ namespace rendering
         return Image(*this); // Use copy constructor
     }
 
-    const math::Matrix<RGBA_Color> &Image::getPixelMatrix() const {
-        return pixels;
+    math::Matrix<RGBA_Color> Image::getPixelMatrix() const {
+        return pixels.toRowMajor();
     }
 
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define IMAGE_H
 
 #include "../Math/Matrix.hpp"
+#include "PixelBuffer.hpp"
 #include "RGBA_Color.h"
 
 namespace rendering {
@@ -11,7 +12,8 @@ namespace rendering {
      * @brief A class representing a 2D image composed of RGBA colors.
      *
      * This class provides functionality for creating, manipulating, and accessing
-     * color data in a 2D image format. Uses a Matrix<RGBA_Color> for internal storage.
+     * color data in a 2D image format. Uses a PixelBuffer<RGBA_Color> for internal storage,
+     * row-major by default or tiled / Morton ordered for tile-local render and filter passes.
      */
     class Image {
     public:
@@ -26,9 +28,10 @@ namespace rendering {
          * Initializes all colors to black (0, 0, 0, 1).
          * @param w The width of the image in pixels.
          * @param h The height of the image in pixels.
+         * @param layout The memory layout of the pixels.
          * @throws std::invalid_argument if width or height is non-positive.
          */
-        Image(int w, int h);
+        Image(int w, int h, PixelLayout layout = PixelLayout::ROW_MAJOR);
 
         /**
          * @brief Constructs an image from a given matrix of colors.
@@ -44,6 +47,12 @@ namespace rendering {
          */
         Image(const Image& other);
 
+        /**
+         * @brief Move constructor, takes the pixels of other.
+         * @param other The image to move from, left empty.
+         */
+        Image(Image&& other) noexcept;
+
         /**
          * @brief Constructs an image from a file.
          * @param filename The name of the file to load.
@@ -58,6 +67,13 @@ namespace rendering {
          */
         Image& operator=(const Image& other);
 
+        /**
+         * @brief Move assignment operator, takes the pixels of other.
+         * @param other The image to move from, left empty.
+         * @return Reference to this image.
+         */
+        Image& operator=(Image&& other) noexcept;
+
         /**
          * @brief Get the width of the image.
          * @return The width in pixels.
@@ -76,6 +92,18 @@ namespace rendering {
          */
         size_t getNumPixels() const;
 
+        /**
+         * @brief Get the memory layout of the pixels.
+         * @return The layout.
+         */
+        PixelLayout getLayout() const;
+
+        /**
+         * @brief Change the memory layout of the pixels, keeping their values.
+         * @param layout The new layout.
+         */
+        void setLayout(PixelLayout layout);
+
         /**
          * @brief Check if the image is valid (no null colors).
          * @return True if all colors are non-null, false otherwise.
@@ -100,6 +128,13 @@ namespace rendering {
          */
         void setPixel(size_t x, size_t y, const RGBA_Color& color);
 
+        /**
+         * @brief Get the pixel storage, for filters that read or write colors in place.
+         * @return Reference to the pixel buffer, addressed as pixels(x, y).
+         */
+        const PixelBuffer<RGBA_Color>& getPixelBuffer() const { return pixels; }
+        PixelBuffer<RGBA_Color>& getPixelBuffer() { return pixels; }
+
         /**
          * @brief Fill the entire image with a single color.
          * @param fillColor The color to fill the image with.
@@ -144,15 +179,16 @@ namespace rendering {
         Image copy() const;
 
         /**
-         * @brief Get a const reference to the internal color matrix.
-         * @return Const reference to the color matrix.
+         * @brief Get the pixels as a row-major color matrix indexed (y, x).
+         * Tiled layouts are converted tile by tile, row-major images are copied as is.
+         * @return The color matrix.
          */
-        const math::Matrix<RGBA_Color>& getPixelMatrix() const;
+        math::Matrix<RGBA_Color> getPixelMatrix() const;
 
     private:
         size_t width;                          ///< Width of the image in pixels
         size_t height;                         ///< Height of the image in pixels
-        math::Matrix<RGBA_Color> pixels;    ///< Matrix storing color data as pointers
+        PixelBuffer<RGBA_Color> pixels;        ///< Color data in the selected layout
     };
 
 }
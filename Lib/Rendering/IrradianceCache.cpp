@@ -0,0 +1,374 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "IrradianceCache.h"
+#include "Texture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <variant>
+
+namespace rendering {
+
+    namespace {
+
+        constexpr double PI = 3.14159265358979323846;
+        constexpr size_t MAX_TREE_DEPTH = 24;
+        constexpr double FRONT_TOLERANCE = 0.01;   ///< Fraction of a record radius it may lie in front of the shaded point
+
+        // Grow the box [low, high] around a point
+        void extend(Vector3D& low, Vector3D& high, const Vector3D& point) {
+            low = Vector3D(std::min(low.x(), point.x()), std::min(low.y(), point.y()), std::min(low.z(), point.z()));
+            high = Vector3D(std::max(high.x(), point.x()), std::max(high.y(), point.y()), std::max(high.z(), point.z()));
+        }
+
+        bool insideNode(const Vector3D& point, const Vector3D& center, double halfSize) {
+            return std::fabs(point.x() - center.x()) <= halfSize && std::fabs(point.y() - center.y()) <= halfSize
+                && std::fabs(point.z() - center.z()) <= halfSize;
+        }
+
+        size_t childIndex(const Vector3D& point, const Vector3D& center) {
+            return (point.x() >= center.x() ? 1 : 0) | (point.y() >= center.y() ? 2 : 0) | (point.z() >= center.z() ? 4 : 0);
+        }
+
+        /**
+         * @brief Get the light leaving a surface hit by a hemisphere ray toward its origin
+         * Diffuse reflection of the direct light only, shapes without a material reflect nothing.
+         */
+        RGBA_Color bouncedLight(const Camera::ShapeVariant& variant, const Ray& ray, const Hit& hit, const math::Vector<Camera::ShapeVariant>& shapes,
+                                const math::Vector<Light>& lights, const LightingCache& lighting, double footprint) {
+            return std::visit([&](auto&& shape) {
+                const Material* material = shape.getMaterial();
+                if (!material) {
+                    return RGBA_Color(0, 0, 0, 1);
+                }
+                Vector3D point = ray.getPointAt(hit.t);
+                Vector3D normal = shape.getNormalAt(point);
+                RGBA_Color albedo = material->getAlbedo();
+                if (material->hasAlbedoTexture()) {
+                    albedo = texturedAlbedo(variant, *material, point, normal, ray.getDirection(), footprint);
+                }
+                RGBA_Color light = Camera::calculateLighting(point, normal, lights, shapes, hit.shapeIndex, lighting);
+                return RGBA_Color(albedo.r() * light.r(), albedo.g() * light.g(), albedo.b() * light.b(), 1.0);
+            }, variant);
+        }
+
+    } // namespace
+
+    bool IrradianceCache::matches(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights) const {
+        return sceneSet && sceneHash == SceneHash::compute(shapes, lights, HASHED_FIELDS);
+    }
+
+    void IrradianceCache::reset(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights) {
+        const double inf = std::numeric_limits<double>::infinity();
+        Vector3D low(inf, inf, inf), high(-inf, -inf, -inf);
+
+        // Bounded shapes, the origins of planes and the lights
+        for (size_t i = 0; i < shapes.size(); ++i) {
+            std::visit([&](auto&& shape) {
+                using T = std::decay_t<decltype(shape)>;
+                const auto* geom = shape.getGeometry();
+                if (!geom) {
+                    return;
+                }
+                if constexpr (std::is_same_v<T, Shape<Box>>) {
+                    extend(low, high, geom->getMinCorner());
+                    extend(low, high, geom->getMaxCorner());
+                } else if constexpr (std::is_same_v<T, Shape<Circle>> || std::is_same_v<T, Shape<Sphere>>) {
+                    Vector3D extent(geom->getRadius(), geom->getRadius(), geom->getRadius());
+                    extend(low, high, geom->getCenter() - extent);
+                    extend(low, high, geom->getCenter() + extent);
+                } else if constexpr (std::is_same_v<T, Shape<Plane>>) {
+                    extend(low, high, geom->getOrigin());
+                } else if constexpr (std::is_same_v<T, Shape<Rectangle>>) {
+                    Vector3D corners[4];
+                    geom->getCorners(corners);
+                    for (const Vector3D& corner : corners) {
+                        extend(low, high, corner);
+                    }
+                }
+            }, shapes[i]);
+        }
+        for (size_t i = 0; i < lights.size(); ++i) {
+            extend(low, high, lights[i].getPosition());
+        }
+
+        Vector3D center(0, 0, 0);
+        double halfSize = 0.0;
+        if (low.x() <= high.x()) {
+            center = (low + high) * 0.5;
+            halfSize = 0.5 * std::max({high.x() - low.x(), high.y() - low.y(), high.z() - low.z()});
+        }
+        resetTree(center, std::max(halfSize * 1.01, maxSpacing));
+
+        sceneHash = SceneHash::compute(shapes, lights, HASHED_FIELDS);
+        sceneSet = true;
+    }
+
+    void IrradianceCache::resetTree(const Vector3D& center, double halfSize) {
+        std::unique_lock<std::shared_mutex> lock(treeMutex);
+        nodes.clear();
+        records.clear();
+        recordNext.clear();
+        Node root;
+        root.center = center;
+        root.halfSize = halfSize;
+        nodes.push_back(root);
+        lookupCount = 0;
+    }
+
+    RGBA_Color IrradianceCache::indirectLight(const Vector3D& point, const Vector3D& normal, const math::Vector<Camera::ShapeVariant>& shapes,
+                                              const math::Vector<Light>& lights, size_t selfIndex, const LightingCache& lighting) {
+        RGBA_Color light;
+        if (interpolate(point, normal, light)) {
+            return light;
+        }
+
+        // Traced outside the lock, two threads may add close records, which is harmless
+        IrradianceRecord record = computeRecord(point, normal, shapes, lights, selfIndex, lighting);
+        insert(record);
+        return RGBA_Color(record.light[0], record.light[1], record.light[2], 0.0);
+    }
+
+    bool IrradianceCache::interpolate(const Vector3D& point, const Vector3D& normal, RGBA_Color& light) const {
+        ++lookupCount;
+        const double inverseAccuracy = 1.0 / accuracy;
+        double weightSum = 0.0;
+        double sum[3] = {0.0, 0.0, 0.0};
+
+        auto blend = [&](const IrradianceRecord& record) {
+            Vector3D offset = point - record.position;
+            double error = offset.length() / record.radius + std::sqrt(std::max(0.0, 1.0 - normal.dot(record.normal)));
+            if (error >= accuracy) {
+                return;
+            }
+            // Records in front of the point see another hemisphere
+            if (offset.dot(record.normal + normal) * 0.5 < -FRONT_TOLERANCE * record.radius) {
+                return;
+            }
+            // Ward's weight less its threshold, so records fade out at the edge of their validity
+            double weight = 1.0 / std::max(error, 1e-9) - inverseAccuracy;
+            Vector3D rotation = record.normal.cross(normal);
+            for (int c = 0; c < 3; ++c) {
+                double value = record.light[c] + rotation.dot(record.rotationGradient[c]) + offset.dot(record.translationGradient[c]);
+                sum[c] += weight * std::max(0.0, value);
+            }
+            weightSum += weight;
+        };
+
+        std::shared_lock<std::shared_mutex> lock(treeMutex);
+        if (nodes.empty()) {
+            return false;
+        }
+
+        // The root holds the records outside the tree, every other node is tested loosely:
+        // its records are valid at most its half size away from it
+        size_t stack[MAX_TREE_DEPTH * 8 + 8];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            for (size_t r = node.firstRecord; r != NONE; r = recordNext[r]) {
+                blend(records[r]);
+            }
+            for (size_t child : node.children) {
+                if (child != NONE && insideNode(point, nodes[child].center, 2.0 * nodes[child].halfSize)) {
+                    stack[top++] = child;
+                }
+            }
+        }
+
+        if (weightSum <= 0.0) {
+            return false;
+        }
+        light = RGBA_Color(sum[0] / weightSum, sum[1] / weightSum, sum[2] / weightSum, 0.0);
+        return true;
+    }
+
+    IrradianceRecord IrradianceCache::computeRecord(const Vector3D& point, const Vector3D& normal, const math::Vector<Camera::ShapeVariant>& shapes,
+                                                    const math::Vector<Light>& lights, size_t selfIndex, const LightingCache& lighting) const {
+        IrradianceRecord record;
+        record.position = point;
+        record.normal = normal.normal();
+
+        // One bounce: the surfaces seen are lit directly, without shadow rays traced ahead for pixels
+        LightingCache bounceLighting = lighting;
+        bounceLighting.irradiance = nullptr;
+        bounceLighting.pixelShadows = nullptr;
+
+        Vector3D tangent, bitangent;
+        record.normal.tangentBasis(tangent, bitangent);
+
+        const size_t M = thetaSamples, N = phiSamples;
+        const double inf = std::numeric_limits<double>::infinity();
+        math::Vector<double> radiance(M * N * 3);
+        math::Vector<double> distance(M * N);
+        math::Vector<double> sinTheta(M), cosTheta(M), tanTheta(M);
+        for (size_t j = 0; j < M; ++j) {
+            sinTheta[j] = std::sqrt((j + 0.5) / M);
+            cosTheta[j] = std::sqrt(1.0 - sinTheta[j] * sinTheta[j]);
+            tanTheta[j] = sinTheta[j] / cosTheta[j];
+        }
+
+        // Stratified cosine weighted hemisphere, one ray through the center of each stratum
+        double inverseDistanceSum = 0.0;
+        for (size_t k = 0; k < N; ++k) {
+            double phi = 2.0 * PI * (k + 0.5) / N;
+            Vector3D azimuth = tangent * std::cos(phi) + bitangent * std::sin(phi);
+            for (size_t j = 0; j < M; ++j) {
+                size_t s = j * N + k;
+                Ray ray(point, azimuth * sinTheta[j] + record.normal * cosTheta[j]);
+                auto hit = Camera::findClosestHit(ray, shapes, static_cast<int>(selfIndex));
+                if (!hit) {
+                    distance[s] = inf;
+                    continue;
+                }
+                distance[s] = hit->t;
+                inverseDistanceSum += 1.0 / hit->t;
+                RGBA_Color light = bouncedLight(shapes[hit->shapeIndex], ray, *hit, shapes, lights, bounceLighting, hit->t * PI / (2.0 * M));
+                radiance[s * 3] = light.r();
+                radiance[s * 3 + 1] = light.g();
+                radiance[s * 3 + 2] = light.b();
+            }
+        }
+
+        // Light is the mean of the strata, the irradiance over pi
+        const double strata = static_cast<double>(M * N);
+        for (size_t s = 0; s < M * N; ++s) {
+            for (int c = 0; c < 3; ++c) {
+                record.light[c] += radiance[s * 3 + c] / strata;
+            }
+        }
+
+        // Gradients of Ward and Heckbert, divided by pi like the light
+        for (int c = 0; c < 3; ++c) {
+            record.rotationGradient[c] = Vector3D(0, 0, 0);
+            record.translationGradient[c] = Vector3D(0, 0, 0);
+        }
+        for (size_t k = 0; k < N; ++k) {
+            double phi = 2.0 * PI * (k + 0.5) / N;
+            double phiLow = 2.0 * PI * k / N;
+            Vector3D u = tangent * std::cos(phi) + bitangent * std::sin(phi);
+            Vector3D v = tangent * -std::sin(phi) + bitangent * std::cos(phi);
+            Vector3D vLow = tangent * -std::sin(phiLow) + bitangent * std::cos(phiLow);
+            size_t previousK = (k + N - 1) % N;
+
+            double rotation[3] = {0.0, 0.0, 0.0};
+            double alongTheta[3] = {0.0, 0.0, 0.0};
+            double alongPhi[3] = {0.0, 0.0, 0.0};
+            for (size_t j = 0; j < M; ++j) {
+                size_t s = j * N + k;
+                double sinLow = std::sqrt(static_cast<double>(j) / M);
+                double cosLow = std::sqrt(1.0 - sinLow * sinLow);
+                double cosHigh = std::sqrt(1.0 - static_cast<double>(j + 1) / M);
+                for (int c = 0; c < 3; ++c) {
+                    rotation[c] += tanTheta[j] * radiance[s * 3 + c];
+                }
+                if (j > 0) {
+                    size_t below = (j - 1) * N + k;
+                    double closest = std::min(distance[s], distance[below]);
+                    if (closest < inf) {
+                        double factor = sinLow * cosLow * cosLow / closest;
+                        for (int c = 0; c < 3; ++c) {
+                            alongTheta[c] += factor * (radiance[s * 3 + c] - radiance[below * 3 + c]);
+                        }
+                    }
+                }
+                size_t beside = j * N + previousK;
+                double closest = std::min(distance[s], distance[beside]);
+                if (closest < inf) {
+                    double factor = (cosLow - cosHigh) / (sinTheta[j] * closest);
+                    for (int c = 0; c < 3; ++c) {
+                        alongPhi[c] += factor * (radiance[s * 3 + c] - radiance[beside * 3 + c]);
+                    }
+                }
+            }
+            for (int c = 0; c < 3; ++c) {
+                record.rotationGradient[c] = record.rotationGradient[c] + v * (rotation[c] / strata);
+                record.translationGradient[c] = record.translationGradient[c] + u * (alongTheta[c] * 2.0 / N) + vLow * (alongPhi[c] / PI);
+            }
+        }
+
+        // Harmonic mean distance, shortened where the translation gradient predicts a steeper change
+        double radius = inverseDistanceSum > 0.0 ? strata / inverseDistanceSum : inf;
+        for (int c = 0; c < 3; ++c) {
+            double slope = record.translationGradient[c].length();
+            if (slope > 0.0 && record.light[c] > 0.0) {
+                radius = std::min(radius, record.light[c] / slope);
+            }
+        }
+        record.radius = std::clamp(radius, minSpacing, maxSpacing);
+        return record;
+    }
+
+    void IrradianceCache::insert(const IrradianceRecord& record) {
+        std::unique_lock<std::shared_mutex> lock(treeMutex);
+        if (nodes.empty()) {
+            Node root;
+            root.center = record.position;
+            root.halfSize = maxSpacing;
+            nodes.push_back(root);
+        }
+
+        // Smallest node holding the position and at least as large as the distance the record is valid for
+        const double validity = accuracy * record.radius;
+        size_t current = 0;
+        if (insideNode(record.position, nodes[0].center, nodes[0].halfSize)) {
+            for (size_t depth = 0; depth < MAX_TREE_DEPTH; ++depth) {
+                const double childHalf = nodes[current].halfSize * 0.5;
+                if (childHalf < validity) {
+                    break;
+                }
+                size_t octant = childIndex(record.position, nodes[current].center);
+                if (nodes[current].children[octant] == NONE) {
+                    Node child;
+                    const Vector3D& center = nodes[current].center;
+                    child.center = Vector3D(center.x() + ((octant & 1) ? childHalf : -childHalf),
+                                            center.y() + ((octant & 2) ? childHalf : -childHalf),
+                                            center.z() + ((octant & 4) ? childHalf : -childHalf));
+                    child.halfSize = childHalf;
+                    nodes.push_back(child);
+                    nodes[current].children[octant] = nodes.size() - 1;
+                }
+                current = nodes[current].children[octant];
+            }
+        }
+
+        records.push_back(record);
+        recordNext.push_back(nodes[current].firstRecord);
+        nodes[current].firstRecord = records.size() - 1;
+    }
+
+    void IrradianceCache::setAccuracy(double value) {
+        if (!(value > 0.0)) {
+            throw std::invalid_argument("Irradiance cache accuracy must be positive");
+        }
+        accuracy = value;
+    }
+
+    void IrradianceCache::setSpacing(double minimum, double maximum) {
+        if (!(minimum > 0.0) || !(maximum >= minimum)) {
+            throw std::invalid_argument("Irradiance cache spacing must satisfy 0 < minimum <= maximum");
+        }
+        minSpacing = minimum;
+        maxSpacing = maximum;
+    }
+
+    void IrradianceCache::setHemisphereSamples(size_t thetaCount, size_t phiCount) {
+        if (thetaCount < 2 || phiCount < 2) {
+            throw std::invalid_argument("Irradiance cache hemispheres need at least 2 strata per angle");
+        }
+        thetaSamples = thetaCount;
+        phiSamples = phiCount;
+    }
+
+    size_t IrradianceCache::getRecordCount() const {
+        std::shared_lock<std::shared_mutex> lock(treeMutex);
+        return records.size();
+    }
+
+} // namespace rendering
@@ -0,0 +1,186 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef IRRADIANCE_CACHE_H
+#define IRRADIANCE_CACHE_H
+
+#include "Camera.h"
+#include "Light.h"
+#include "RGBA_Color.h"
+#include "SceneHash.h"
+#include "../Geometry/Vector3D.h"
+#include "../Math/Vector.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+
+namespace rendering {
+
+    /**
+     * @struct IrradianceRecord
+     * @brief The indirect light reaching one point of a surface, with its gradients.
+     * Light is stored in the units of Camera::calculateLighting: the cosine weighted mean of the
+     * radiance over the hemisphere, which is the irradiance divided by pi.
+     */
+    struct IrradianceRecord {
+        Vector3D position;
+        Vector3D normal;
+        double radius = 0.0;                ///< Harmonic mean distance to the surfaces seen, clamped to the spacing bounds
+        double light[3] = {0.0, 0.0, 0.0};  ///< Indirect light per RGB channel
+        Vector3D rotationGradient[3];       ///< Change of each channel as the normal rotates
+        Vector3D translationGradient[3];    ///< Change of each channel as the position moves
+    };
+
+    /**
+     * @class IrradianceCache
+     * @brief Sparse records of one bounce diffuse interreflection, interpolated between (Ward's irradiance cache).
+     *
+     * Shading a point asks the cache for its indirect light. Records whose weight
+     * 1 / (|x - xi| / Ri + sqrt(1 - n . ni)) exceeds 1 / accuracy are blended with their
+     * rotation and translation gradients. When none is close enough, a new record is computed
+     * from a stratified cosine weighted hemisphere of rays lit by Camera::calculateLighting, and
+     * inserted. Its radius is the harmonic mean distance of the rays, reduced where the translation
+     * gradient says the light changes faster, so records crowd where the indirect light varies.
+     *
+     * Records live in a loose octree: a record is stored in the smallest node holding its position
+     * that is at least as large as the distance it is valid for. Lookups share a lock, insertions
+     * take it exclusively, and hemispheres are traced outside the lock. Records are kept while the
+     * scene stays the one the cache was reset for, so static scenes reuse them across frames.
+     */
+    class IrradianceCache {
+    public:
+        static constexpr double DEFAULT_ACCURACY = 0.3;
+        static constexpr size_t DEFAULT_THETA_SAMPLES = 8;
+        static constexpr size_t DEFAULT_PHI_SAMPLES = 24;
+        /// The records hold the direct light of calculateLighting reflected once by the albedo of the shapes, textured or not
+        static constexpr SceneField HASHED_FIELDS = SceneField::GEOMETRY | SceneField::OPACITY | SceneField::ALBEDO | SceneField::ALBEDO_TEXTURE
+                                                  | SceneField::LIGHT_POSITIONS | SceneField::LIGHT_EMISSION;
+
+        IrradianceCache() = default;
+
+        IrradianceCache(const IrradianceCache&) = delete;
+        IrradianceCache& operator=(const IrradianceCache&) = delete;
+
+        /**
+         * @brief Check if the records were computed for a scene
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         * @return True if the HASHED_FIELDS of the scene are those the cache was reset for
+         */
+        bool matches(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights) const;
+
+        /**
+         * @brief Drop every record and fit the octree to a scene
+         * Not thread safe, call it between renders.
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         */
+        void reset(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights);
+
+        /**
+         * @brief Get the indirect light reaching a point, computing a record if none is close enough
+         * @param point The shaded point
+         * @param normal The normal of the surface at the point
+         * @param shapes The shapes of the scene the cache was reset for
+         * @param lights The lights of the scene
+         * @param selfIndex The shape of the point
+         * @param lighting Precomputed lighting of the scene, used to light the hemisphere rays
+         * @return The indirect light, to add to the direct light of calculateLighting, with a zero alpha
+         */
+        RGBA_Color indirectLight(const Vector3D& point, const Vector3D& normal, const math::Vector<Camera::ShapeVariant>& shapes,
+                                 const math::Vector<Light>& lights, size_t selfIndex, const LightingCache& lighting);
+
+        /**
+         * @brief Interpolate the cached records at a point
+         * @param point The shaded point
+         * @param normal The normal of the surface at the point
+         * @param light Output parameter for the interpolated light, with a zero alpha
+         * @return False if no record is close enough
+         */
+        bool interpolate(const Vector3D& point, const Vector3D& normal, RGBA_Color& light) const;
+
+        /**
+         * @brief Trace the hemisphere of a point into a record, without inserting it
+         * @param point The point
+         * @param normal The normal of the surface at the point
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         * @param selfIndex The shape of the point
+         * @param lighting Precomputed lighting of the scene
+         * @return The record
+         */
+        IrradianceRecord computeRecord(const Vector3D& point, const Vector3D& normal, const math::Vector<Camera::ShapeVariant>& shapes,
+                                       const math::Vector<Light>& lights, size_t selfIndex, const LightingCache& lighting) const;
+
+        /**
+         * @brief Add a record to the cache
+         * @param record The record
+         */
+        void insert(const IrradianceRecord& record);
+
+        /**
+         * @brief Set how far records are reused, smaller is more accurate and computes more records
+         * @param value The largest allowed 1 / weight, 0.3 by default
+         * @throws std::invalid_argument if value is not positive
+         */
+        void setAccuracy(double value);
+        double getAccuracy() const { return accuracy; }
+
+        /**
+         * @brief Set the bounds of the record radii, in world units
+         * @param minimum The smallest radius, which bounds the record count in corners
+         * @param maximum The largest radius, which keeps records local in open scenes
+         * @throws std::invalid_argument unless 0 < minimum <= maximum
+         */
+        void setSpacing(double minimum, double maximum);
+        double getMinSpacing() const { return minSpacing; }
+        double getMaxSpacing() const { return maxSpacing; }
+
+        /**
+         * @brief Set the strata of the hemispheres traced for new records
+         * @param thetaCount The strata in elevation
+         * @param phiCount The strata in azimuth
+         * @throws std::invalid_argument if a count is below 2
+         */
+        void setHemisphereSamples(size_t thetaCount, size_t phiCount);
+        size_t getThetaSamples() const { return thetaSamples; }
+        size_t getPhiSamples() const { return phiSamples; }
+
+        size_t getRecordCount() const;
+        size_t getLookupCount() const { return lookupCount.load(); }
+
+    private:
+        static constexpr size_t NONE = SIZE_MAX;
+
+        /// Node of the loose octree, its records chained through recordNext
+        struct Node {
+            Vector3D center;
+            double halfSize;
+            size_t children[8] = {NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE};
+            size_t firstRecord = NONE;
+        };
+
+        double accuracy = DEFAULT_ACCURACY;
+        double minSpacing = 0.05;
+        double maxSpacing = 4.0;
+        size_t thetaSamples = DEFAULT_THETA_SAMPLES;
+        size_t phiSamples = DEFAULT_PHI_SAMPLES;
+
+        uint64_t sceneHash = 0;
+        bool sceneSet = false;
+        mutable std::shared_mutex treeMutex;
+        std::deque<Node> nodes;
+        std::deque<IrradianceRecord> records;
+        std::deque<size_t> recordNext;      ///< Next record of the same node
+        mutable std::atomic<size_t> lookupCount{0};
+
+        void resetTree(const Vector3D& center, double halfSize);
+    };
+
+} // namespace rendering
+
+#endif // IRRADIANCE_CACHE_H
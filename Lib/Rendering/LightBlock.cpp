@@ -0,0 +1,48 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "LightBlock.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rendering {
+
+    LightBlock::LightBlock(const math::Vector<Light>& lights)
+        : x(lights.size()), y(lights.size()), z(lights.size()),
+          red(lights.size()), green(lights.size()), blue(lights.size()), peak(lights.size()) {
+        for (size_t i = 0; i < lights.size(); ++i) {
+            const Light& light = lights[i];
+            x.begin()[i] = light.getPosition().x();
+            y.begin()[i] = light.getPosition().y();
+            z.begin()[i] = light.getPosition().z();
+            red.begin()[i] = light.getColor().r() * light.getIntensity();
+            green.begin()[i] = light.getColor().g() * light.getIntensity();
+            blue.begin()[i] = light.getColor().b() * light.getIntensity();
+            peak.begin()[i] = std::max({red.begin()[i], green.begin()[i], blue.begin()[i]});
+        }
+    }
+
+    void LightBlock::unshadowedWeights(size_t first, size_t count, const Vector3D& point, const Vector3D& normal, double* weightsSquared) const {
+        const double* __restrict lx = x.begin() + first;
+        const double* __restrict ly = y.begin() + first;
+        const double* __restrict lz = z.begin() + first;
+        double* __restrict out = weightsSquared;
+        const double px = point.x(), py = point.y(), pz = point.z();
+        const double nx = normal.x(), ny = normal.y(), nz = normal.z();
+
+        // Branch free so the compiler vectorizes it: no comparison, no square root
+        #pragma omp simd
+        for (size_t i = 0; i < count; ++i) {
+            double dx = lx[i] - px, dy = ly[i] - py, dz = lz[i] - pz;
+            double distanceSquared = dx * dx + dy * dy + dz * dz;
+            double facing = nx * dx + ny * dy + nz * dz;
+            double positiveFacing = 0.5 * (facing + std::fabs(facing));
+            double attenuation = 1.0 / (1.0 + ATTENUATION * distanceSquared);
+            // (max(0, N.L) * attenuation)^2 with N.L = facing / distance; the tiny term only guards a light on the point
+            out[i] = positiveFacing * facing / (distanceSquared + 1e-300) * attenuation * attenuation;
+        }
+    }
+
+} // namespace rendering
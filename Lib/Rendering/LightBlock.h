@@ -0,0 +1,60 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef LIGHT_BLOCK_H
+#define LIGHT_BLOCK_H
+
+#include "Light.h"
+#include "../Math/Vector.hpp"
+
+#include <cstddef>
+
+namespace rendering {
+
+    /**
+     * @class LightBlock
+     * @brief The lights of a scene laid out one array per component, for vectorized lighting.
+     *
+     * Positions and radiances (color times intensity) of all lights are contiguous, so the
+     * unshadowed terms of many lights are computed in one SIMD loop. A block is built once per
+     * render and shared by every pixel.
+     */
+    class LightBlock {
+    public:
+        /// Quadratic distance attenuation of point lights: 1 / (1 + ATTENUATION * d^2)
+        static constexpr double ATTENUATION = 0.03;
+
+        /// Lights handled by one call of unshadowedWeights in the lighting loop, sized for the stack
+        static constexpr size_t CHUNK = 64;
+
+        LightBlock() = default;
+
+        /**
+         * @brief Lay out lights for vectorized lighting
+         * @param lights The lights of the scene
+         */
+        explicit LightBlock(const math::Vector<Light>& lights);
+
+        /**
+         * @brief Compute the squared unshadowed weight of a range of lights at a surface point
+         * The weight of a light is max(0, N.L) times its distance attenuation, squared so the loop
+         * needs no square root and vectorizes; lights behind the surface weigh zero.
+         * @param first The index of the first light
+         * @param count The number of lights, at most size() - first
+         * @param point The lit point
+         * @param normal The unit normal of the surface at the point
+         * @param weightsSquared Output array of count squared weights
+         */
+        void unshadowedWeights(size_t first, size_t count, const Vector3D& point, const Vector3D& normal, double* weightsSquared) const;
+
+        size_t size() const { return x.size(); }
+
+        math::Vector<double> x, y, z;               ///< Positions of the lights
+        math::Vector<double> red, green, blue;      ///< Radiances of the lights
+        math::Vector<double> peak;                  ///< Largest radiance component of each light
+    };
+
+} // namespace rendering
+
+#endif // LIGHT_BLOCK_H
@@ -0,0 +1,301 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "Lightmap.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <variant>
+
+namespace rendering {
+
+    namespace {
+
+        constexpr char LIGHTMAP_FILE_MAGIC[8] = {'S', 'I', '3', 'D', 'L', 'M', 'A', 'P'};
+        constexpr uint32_t LIGHTMAP_FILE_VERSION = 1;
+
+        struct LightmapFileHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t reserved;
+            uint64_t sceneHash;
+            uint64_t shapeCount;
+            uint64_t mapCount;
+        };
+
+        /// On-disk lightmap, followed by its width * height * 3 texels
+        struct LightmapRecord {
+            uint64_t shapeIndex;
+            uint64_t width;
+            uint64_t height;
+            double origin[3];
+            double axisU[3];
+            double axisV[3];
+            double stepU;
+            double stepV;
+        };
+
+        void storeVector(double* out, const Vector3D& v) {
+            out[0] = v.x();
+            out[1] = v.y();
+            out[2] = v.z();
+        }
+
+        Vector3D loadVector(const double* in) {
+            return Vector3D(in[0], in[1], in[2]);
+        }
+
+        // Texels along one side: at most texelSize apart, at most MAX_RESOLUTION
+        size_t resolutionOf(double length, double texelSize) {
+            double cells = std::ceil(length / texelSize);
+            return static_cast<size_t>(std::clamp(cells, 1.0, static_cast<double>(LightmapSet::MAX_RESOLUTION - 1))) + 1;
+        }
+
+        /**
+         * @brief Lay out the texel grid of a planar shape
+         * @return False if the shape is not planar or has no geometry
+         */
+        bool layoutLightmap(const Camera::ShapeVariant& variant, double texelSize, double planeExtent, Lightmap& map, Vector3D& normal) {
+            double sizeU = 0.0, sizeV = 0.0;
+            bool planar = std::visit([&](auto&& shape) {
+                using T = std::decay_t<decltype(shape)>;
+                const auto* geom = shape.getGeometry();
+                if (!geom) {
+                    return false;
+                }
+
+                if constexpr (std::is_same_v<T, Shape<Plane>>) {
+                    normal = geom->getNormal();
+                    normal.tangentBasis(map.axisU, map.axisV);
+                    map.origin = geom->getOrigin() - map.axisU * planeExtent - map.axisV * planeExtent;
+                    sizeU = sizeV = 2.0 * planeExtent;
+                    return true;
+                } else if constexpr (std::is_same_v<T, Shape<Rectangle>>) {
+                    normal = geom->getNormal();
+                    map.axisU = geom->getLengthVec();
+                    map.axisV = geom->getWidthVec();
+                    map.origin = geom->getOrigin();
+                    sizeU = geom->getLength();
+                    sizeV = geom->getWidth();
+                    return true;
+                } else if constexpr (std::is_same_v<T, Shape<Circle>>) {
+                    normal = geom->getNormal();
+                    normal.tangentBasis(map.axisU, map.axisV);
+                    map.origin = geom->getCenter() - map.axisU * geom->getRadius() - map.axisV * geom->getRadius();
+                    sizeU = sizeV = 2.0 * geom->getRadius();
+                    return true;
+                } else {
+                    return false;
+                }
+            }, variant);
+            if (!planar) {
+                return false;
+            }
+
+            map.width = resolutionOf(sizeU, texelSize);
+            map.height = resolutionOf(sizeV, texelSize);
+            map.stepU = sizeU / static_cast<double>(map.width - 1);
+            map.stepV = sizeV / static_cast<double>(map.height - 1);
+            return true;
+        }
+
+    } // namespace
+
+    bool Lightmap::sample(const Vector3D& point, RGBA_Color& irradiance) const {
+        const double tolerance = 1e-6;
+        Vector3D local = point - origin;
+        double u = local.dot(axisU) / stepU;
+        double v = local.dot(axisV) / stepV;
+        double maxU = static_cast<double>(width - 1);
+        double maxV = static_cast<double>(height - 1);
+        if (!(u >= -tolerance && v >= -tolerance && u <= maxU + tolerance && v <= maxV + tolerance)) {
+            return false;
+        }
+        u = std::clamp(u, 0.0, maxU);
+        v = std::clamp(v, 0.0, maxV);
+
+        size_t i0 = std::min(static_cast<size_t>(u), width - 1);
+        size_t j0 = std::min(static_cast<size_t>(v), height - 1);
+        size_t i1 = std::min(i0 + 1, width - 1);
+        size_t j1 = std::min(j0 + 1, height - 1);
+        double fu = u - static_cast<double>(i0);
+        double fv = v - static_cast<double>(j0);
+
+        const float* t = texels.begin();
+        const float* t00 = t + 3 * (j0 * width + i0);
+        const float* t10 = t + 3 * (j0 * width + i1);
+        const float* t01 = t + 3 * (j1 * width + i0);
+        const float* t11 = t + 3 * (j1 * width + i1);
+        double rgb[3];
+        for (int c = 0; c < 3; ++c) {
+            double top = t00[c] + (t10[c] - t00[c]) * fu;
+            double bottom = t01[c] + (t11[c] - t01[c]) * fu;
+            rgb[c] = top + (bottom - top) * fv;
+        }
+        irradiance.setRGBA(rgb[0], rgb[1], rgb[2], 1.0);
+        return true;
+    }
+
+    LightmapSet LightmapSet::bake(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, double texelSize, double planeExtent) {
+        if (!(texelSize > 0.0)) {
+            throw std::invalid_argument("Texel size must be positive");
+        }
+        if (!(planeExtent > 0.0)) {
+            throw std::invalid_argument("Plane extent must be positive");
+        }
+
+        LightmapSet result;
+        result.sceneHash = SceneHash::compute(shapes, lights, HASHED_FIELDS);
+
+        const LightBlock lightBlock(lights);
+        const LightingCache lighting{nullptr, nullptr, &lightBlock};
+        for (size_t shapeIndex = 0; shapeIndex < shapes.size(); ++shapeIndex) {
+            Lightmap map;
+            Vector3D normal;
+            if (!layoutLightmap(shapes[shapeIndex], texelSize, planeExtent, map, normal)) {
+                continue;
+            }
+            map.shapeIndex = shapeIndex;
+            map.texels = math::Vector<float>(3 * map.width * map.height);
+
+            // The lighting of the renderers, so lookups match it exactly on texels
+            float* texels = map.texels.begin();
+            const long long texelCount = static_cast<long long>(map.width * map.height);
+            #pragma omp parallel for schedule(dynamic, 64)
+            for (long long texel = 0; texel < texelCount; ++texel) {
+                size_t i = static_cast<size_t>(texel) % map.width;
+                size_t j = static_cast<size_t>(texel) / map.width;
+                Vector3D point = map.origin + map.axisU * (map.stepU * static_cast<double>(i)) + map.axisV * (map.stepV * static_cast<double>(j));
+                RGBA_Color light = Camera::calculateLighting(point, normal, lights, shapes, shapeIndex, lighting);
+                texels[3 * texel] = static_cast<float>(light.r());
+                texels[3 * texel + 1] = static_cast<float>(light.g());
+                texels[3 * texel + 2] = static_cast<float>(light.b());
+            }
+
+            result.maps.append(map);
+        }
+
+        result.indexMaps(shapes.size());
+        return result;
+    }
+
+    void LightmapSet::indexMaps(size_t shapeCount) {
+        mapOfShape = math::Vector<size_t>(shapeCount);
+        std::fill(mapOfShape.begin(), mapOfShape.end(), NO_MAP);
+        for (size_t m = 0; m < maps.size(); ++m) {
+            if (maps[m].shapeIndex < shapeCount) {
+                mapOfShape[maps[m].shapeIndex] = m;
+            }
+        }
+    }
+
+    bool LightmapSet::matches(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights) const {
+        return shapes.size() == mapOfShape.size() && SceneHash::compute(shapes, lights, HASHED_FIELDS) == sceneHash;
+    }
+
+    const Lightmap* LightmapSet::find(size_t shapeIndex) const {
+        if (shapeIndex >= mapOfShape.size() || mapOfShape[shapeIndex] == NO_MAP) {
+            return nullptr;
+        }
+        return &maps[mapOfShape[shapeIndex]];
+    }
+
+    bool LightmapSet::lookup(size_t shapeIndex, const Vector3D& point, RGBA_Color& irradiance) const {
+        const Lightmap* map = find(shapeIndex);
+        return map && map->sample(point, irradiance);
+    }
+
+    size_t LightmapSet::getTexelCount() const {
+        size_t count = 0;
+        for (const Lightmap& map : maps) {
+            count += map.width * map.height;
+        }
+        return count;
+    }
+
+    void LightmapSet::save(const std::string& filePath) const {
+        FILE* out = fopen(filePath.c_str(), "wb");
+        if (!out) {
+            throw std::runtime_error("Failed to create lightmap file: " + filePath);
+        }
+
+        LightmapFileHeader header{};
+        std::memcpy(header.magic, LIGHTMAP_FILE_MAGIC, sizeof(LIGHTMAP_FILE_MAGIC));
+        header.version = LIGHTMAP_FILE_VERSION;
+        header.sceneHash = sceneHash;
+        header.shapeCount = mapOfShape.size();
+        header.mapCount = maps.size();
+        fwrite(&header, sizeof(header), 1, out);
+
+        for (const Lightmap& map : maps) {
+            LightmapRecord record{};
+            record.shapeIndex = map.shapeIndex;
+            record.width = map.width;
+            record.height = map.height;
+            storeVector(record.origin, map.origin);
+            storeVector(record.axisU, map.axisU);
+            storeVector(record.axisV, map.axisV);
+            record.stepU = map.stepU;
+            record.stepV = map.stepV;
+            fwrite(&record, sizeof(record), 1, out);
+            fwrite(map.texels.begin(), sizeof(float), map.texels.size(), out);
+        }
+
+        bool failed = ferror(out) != 0;
+        fclose(out);
+        if (failed) {
+            throw std::runtime_error("Failed to write lightmap file: " + filePath);
+        }
+    }
+
+    LightmapSet LightmapSet::load(const std::string& filePath) {
+        FILE* in = fopen(filePath.c_str(), "rb");
+        if (!in) {
+            throw std::runtime_error("Failed to open lightmap file: " + filePath);
+        }
+
+        LightmapSet result;
+        LightmapFileHeader header;
+        if (fread(&header, sizeof(header), 1, in) != 1 || std::memcmp(header.magic, LIGHTMAP_FILE_MAGIC, sizeof(LIGHTMAP_FILE_MAGIC)) != 0 || header.version != LIGHTMAP_FILE_VERSION) {
+            fclose(in);
+            throw std::runtime_error("Not a lightmap file: " + filePath);
+        }
+        result.sceneHash = header.sceneHash;
+
+        for (uint64_t m = 0; m < header.mapCount; ++m) {
+            LightmapRecord record;
+            bool valid = fread(&record, sizeof(record), 1, in) == 1
+                && record.width >= 2 && record.height >= 2
+                && record.width <= MAX_RESOLUTION && record.height <= MAX_RESOLUTION
+                && record.shapeIndex < header.shapeCount;
+            Lightmap map;
+            if (valid) {
+                map.shapeIndex = record.shapeIndex;
+                map.width = record.width;
+                map.height = record.height;
+                map.origin = loadVector(record.origin);
+                map.axisU = loadVector(record.axisU);
+                map.axisV = loadVector(record.axisV);
+                map.stepU = record.stepU;
+                map.stepV = record.stepV;
+                map.texels = math::Vector<float>(3 * map.width * map.height);
+                valid = fread(map.texels.begin(), sizeof(float), map.texels.size(), in) == map.texels.size();
+            }
+            if (!valid) {
+                fclose(in);
+                throw std::runtime_error("Truncated lightmap file: " + filePath);
+            }
+            result.maps.append(map);
+        }
+        fclose(in);
+
+        result.indexMaps(header.shapeCount);
+        return result;
+    }
+
+} // namespace rendering
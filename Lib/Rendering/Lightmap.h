@@ -0,0 +1,134 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef LIGHTMAP_H
+#define LIGHTMAP_H
+
+#include "Camera.h"
+#include "Light.h"
+#include "SceneHash.h"
+#include "RGBA_Color.h"
+#include "../Math/Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace rendering {
+
+    /**
+     * @struct Lightmap
+     * @brief The baked direct irradiance of one planar surface.
+     *
+     * Irradiance is sampled on a grid of width x height texels spanning origin to
+     * origin + axisU * stepU * (width - 1) + axisV * stepV * (height - 1), texel (i, j)
+     * lying at origin + axisU * stepU * i + axisV * stepV * j. Texels hold RGB triplets, row by row.
+     */
+    struct Lightmap {
+        size_t shapeIndex = 0;      ///< Index of the surface in the baked scene
+        Vector3D origin;            ///< Position of texel (0, 0)
+        Vector3D axisU;             ///< Unit direction of the texel rows
+        Vector3D axisV;             ///< Unit direction of the texel columns
+        double stepU = 0.0;         ///< Spacing of the texels along axisU
+        double stepV = 0.0;         ///< Spacing of the texels along axisV
+        size_t width = 0;
+        size_t height = 0;
+        math::Vector<float> texels;
+
+        /**
+         * @brief Interpolate the irradiance at a point of the surface
+         * @param point The point, projected onto the surface
+         * @param irradiance Output parameter for the bilinear interpolation of the four nearest texels
+         * @return False if the point projects outside the baked region
+         */
+        bool sample(const Vector3D& point, RGBA_Color& irradiance) const;
+    };
+
+    /**
+     * @class LightmapSet
+     * @brief Baked direct lighting of the static planar surfaces of a scene.
+     *
+     * Baking evaluates Camera::calculateLighting, shadows included, on a texel grid over every
+     * Plane, Rectangle and Circle of the scene. While the set matches the scene it was baked
+     * from, shading those surfaces is a bilinear lookup whatever the number of lights.
+     * Infinite planes are baked over a square of side 2 * planeExtent centered on their origin,
+     * points outside a baked region are lit as usual.
+     */
+    class LightmapSet {
+    public:
+        static constexpr double DEFAULT_PLANE_EXTENT = 10.0;   ///< Half side of the baked square of an infinite plane
+        static constexpr size_t MAX_RESOLUTION = 1024;         ///< Maximum texels per side of one lightmap
+        /// The texels hold the direct light of calculateLighting, shadows included, not the color of the surfaces
+        static constexpr SceneField HASHED_FIELDS = SceneField::GEOMETRY | SceneField::OPACITY | SceneField::LIGHT_POSITIONS | SceneField::LIGHT_EMISSION;
+
+        LightmapSet() = default;
+
+        /**
+         * @brief Bake the planar surfaces of a scene, the texels of each surface in parallel
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         * @param texelSize The spacing of the texels in world units, coarser when a side would exceed MAX_RESOLUTION
+         * @param planeExtent The half side of the baked square of infinite planes
+         * @return The baked set
+         * @throws std::invalid_argument if texelSize or planeExtent is not positive
+         */
+        static LightmapSet bake(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, double texelSize, double planeExtent = DEFAULT_PLANE_EXTENT);
+
+        /**
+         * @brief Load a set written by save
+         * @param filePath The lightmap file
+         * @return The loaded set
+         * @throws std::runtime_error if the file cannot be read or is not a lightmap file
+         */
+        static LightmapSet load(const std::string& filePath);
+
+        /**
+         * @brief Write the set to disk
+         * @param filePath The lightmap file to write
+         * @throws std::runtime_error if the file cannot be written
+         */
+        void save(const std::string& filePath) const;
+
+        /**
+         * @brief Check if the set was baked from a scene
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         * @return True if the HASHED_FIELDS of the scene are those of the bake
+         */
+        bool matches(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights) const;
+
+        /**
+         * @brief Look up the baked irradiance at a point of a surface
+         * @param shapeIndex The index of the surface in the scene
+         * @param point The point of the surface
+         * @param irradiance Output parameter for the irradiance
+         * @return False if the surface has no lightmap or the point lies outside it
+         */
+        bool lookup(size_t shapeIndex, const Vector3D& point, RGBA_Color& irradiance) const;
+
+        /**
+         * @brief Get the lightmap of a surface
+         * @param shapeIndex The index of the surface in the scene
+         * @return The lightmap, null if the surface was not baked
+         */
+        const Lightmap* find(size_t shapeIndex) const;
+
+        size_t getMapCount() const { return maps.size(); }
+        size_t getTexelCount() const;
+        uint64_t getSceneHash() const { return sceneHash; }
+
+    private:
+        static constexpr size_t NO_MAP = std::numeric_limits<size_t>::max();
+
+        uint64_t sceneHash = 0;
+        math::Vector<Lightmap> maps;
+        math::Vector<size_t> mapOfShape;   ///< Index in maps of each shape of the scene, NO_MAP if not baked
+
+        void indexMaps(size_t shapeCount);
+    };
+
+} // namespace rendering
+
+#endif // LIGHTMAP_H
@@ -41,6 +41,8 @@ namespace rendering {
           transmission(other.transmission) {
         
         albedo = copyColor(other.albedo);
+        albedoTexture = other.albedoTexture;
+        textureScale = other.textureScale;
         specular = copyColor(other.specular);
         emissive = copyColor(other.emissive);
     }
@@ -49,6 +51,8 @@ namespace rendering {
     Material& Material::operator=(const Material& other) {
         if (this != &other) {
             albedo = copyColor(other.albedo);
+            albedoTexture = other.albedoTexture;
+            textureScale = other.textureScale;
             specular = copyColor(other.specular);
             emissive = copyColor(other.emissive);
             
@@ -66,6 +70,8 @@ namespace rendering {
         : albedo(std::move(other.albedo)),
           specular(std::move(other.specular)),
           emissive(std::move(other.emissive)),
+          albedoTexture(std::move(other.albedoTexture)),
+          textureScale(other.textureScale),
           absorption(other.absorption),
           roughness(other.roughness),
           metalness(other.metalness),
@@ -79,6 +85,8 @@ namespace rendering {
             albedo = std::move(other.albedo);
             specular = std::move(other.specular);
             emissive = std::move(other.emissive);
+            albedoTexture = std::move(other.albedoTexture);
+            textureScale = other.textureScale;
             
             absorption = other.absorption;
             roughness = other.roughness;
@@ -109,6 +117,20 @@ namespace rendering {
         albedo.reset();
     }
 
+    // Albedo texture methods
+    void Material::setAlbedoTexture(std::shared_ptr<const Texture> texture, double scale) {
+        if (!(scale > 0.0)) {
+            throw std::invalid_argument("Texture scale must be positive");
+        }
+        albedoTexture = std::move(texture);
+        textureScale = scale;
+    }
+
+    void Material::clearAlbedoTexture() {
+        albedoTexture.reset();
+        textureScale = 1.0;
+    }
+
     // Specular methods
     void Material::setSpecular(const RGBA_Color& color) {
         specular = std::make_unique<RGBA_Color>(color);
@@ -310,6 +332,10 @@ namespace rendering {
             return false;
         }
 
+        if (albedoTexture != other.albedoTexture || (albedoTexture && textureScale != other.textureScale)) {
+            return false;
+        }
+
         // Compare colors
         if (hasAlbedo() != other.hasAlbedo() || 
             (hasAlbedo() && getAlbedo() != other.getAlbedo())) {
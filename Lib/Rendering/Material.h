@@ -16,6 +16,8 @@
 
 namespace rendering {
 
+    class Texture;
+
     /**
      * @brief Material class representing physical material properties for rendering
      * 
@@ -47,6 +49,13 @@ namespace rendering {
         bool hasAlbedo() const;
         void clearAlbedo();
 
+        // Albedo texture methods, the texture modulates the albedo (see texturedAlbedo)
+        void setAlbedoTexture(std::shared_ptr<const Texture> texture, double scale = 1.0);
+        const std::shared_ptr<const Texture>& getAlbedoTexture() const { return albedoTexture; }
+        bool hasAlbedoTexture() const { return albedoTexture != nullptr; }
+        void clearAlbedoTexture();
+        double getTextureScale() const { return textureScale; }
+
         // Specular color methods
         void setSpecular(const RGBA_Color& color);
         const RGBA_Color& getSpecular() const;
@@ -104,6 +113,8 @@ namespace rendering {
         std::unique_ptr<RGBA_Color> specular;  // The specular color for reflections
         std::unique_ptr<RGBA_Color> emissive;  // The emissive color for light emission
         double emissiveIntensity = 1.0; // Intensity multiplier for emissive color
+        std::shared_ptr<const Texture> albedoTexture; // Texture modulating the albedo, shared between materials
+        double textureScale = 1.0;     // Texture repeats per unit of the surface coordinates
 
         // Physical properties (clamped to valid ranges)
         double absorption = 0.0;       // Light absorption coefficient [0.0, 1.0]
@@ -0,0 +1,198 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "NumaTopology.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace rendering {
+
+    namespace {
+
+        /**
+         * @brief Parse a sysfs cpu list such as "0-3,8-11"
+         * @param list The list to parse
+         * @return The processor ids in the list
+         */
+        math::Vector<int> parseCpuList(const std::string& list) {
+            math::Vector<int> cpus;
+            std::stringstream stream(list);
+            std::string range;
+            while (std::getline(stream, range, ',')) {
+                if (range.empty() || range == "\n") continue;
+                size_t dash = range.find('-');
+                int first = std::stoi(range.substr(0, dash));
+                int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.append(cpu);
+                }
+            }
+            return cpus;
+        }
+
+        /**
+         * @brief Get the processors the calling thread may run on
+         * @return The processor ids of the affinity mask, empty if it cannot be read
+         */
+        math::Vector<int> readAffinity() {
+            math::Vector<int> cpus;
+            #ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+                return cpus;
+            }
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.append(cpu);
+                }
+            }
+            #endif
+            return cpus;
+        }
+
+        /**
+         * @brief Set the processors the calling thread may run on
+         * @param cpus The processor ids of the affinity mask, nothing is done if empty
+         */
+        void writeAffinity(const math::Vector<int>& cpus) {
+            #ifdef __linux__
+            if (cpus.empty()) {
+                return;
+            }
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : cpus) {
+                CPU_SET(cpu, &set);
+            }
+            sched_setaffinity(0, sizeof(set), &set);
+            #else
+            (void)cpus;
+            #endif
+        }
+
+    } // namespace
+
+    const NumaTopology& NumaTopology::get() {
+        static const NumaTopology topology;
+        return topology;
+    }
+
+    NumaTopology::NumaTopology() {
+        #ifdef __linux__
+        for (size_t node = 0; ; ++node) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!file) break;
+
+            std::string list;
+            std::getline(file, list);
+            math::Vector<int> cpus;
+            try {
+                cpus = parseCpuList(list);
+            } catch (const std::exception&) {
+                break; // Unreadable topology, fall back to a single node
+            }
+            // Memory-only nodes have no processor to run on
+            if (!cpus.empty()) {
+                nodeCpus.append(cpus);
+            }
+        }
+        #endif
+
+        if (nodeCpus.empty()) {
+            math::Vector<int> cpus;
+            for (int cpu = 0; cpu < omp_get_num_procs(); ++cpu) {
+                cpus.append(cpu);
+            }
+            nodeCpus = math::Vector<math::Vector<int>>(1);
+            nodeCpus[0] = cpus;
+        }
+
+        int maxCpu = 0;
+        for (const math::Vector<int>& cpus : nodeCpus) {
+            for (int cpu : cpus) maxCpu = std::max(maxCpu, cpu);
+        }
+        cpuToNode = math::Vector<size_t>(static_cast<size_t>(maxCpu) + 1);
+        for (size_t node = 0; node < nodeCpus.size(); ++node) {
+            for (int cpu : nodeCpus[node]) {
+                cpuToNode[static_cast<size_t>(cpu)] = node;
+            }
+        }
+    }
+
+    size_t NumaTopology::getNodeOfCpu(int cpu) const {
+        if (cpu < 0 || static_cast<size_t>(cpu) >= cpuToNode.size()) {
+            return 0;
+        }
+        return cpuToNode[static_cast<size_t>(cpu)];
+    }
+
+    size_t NumaTopology::getNodeOfThread(size_t threadIndex, size_t threadCount) const {
+        if (threadCount == 0 || threadIndex >= threadCount) {
+            return 0;
+        }
+        return (threadIndex * nodeCpus.size()) / threadCount;
+    }
+
+    size_t NumaTopology::getCurrentThreadNode() const {
+        return getNodeOfThread(static_cast<size_t>(omp_get_thread_num()), static_cast<size_t>(omp_get_num_threads()));
+    }
+
+    void NumaTopology::pinCurrentThread(size_t threadIndex, size_t threadCount) const {
+        if (!isMultiNode()) {
+            return;
+        }
+
+        #ifdef __linux__
+        // The whole node rather than one processor, the scheduler still balances threads inside it
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : nodeCpus[getNodeOfThread(threadIndex, threadCount)]) {
+            CPU_SET(cpu, &set);
+        }
+        sched_setaffinity(0, sizeof(set), &set);
+        #else
+        (void)threadIndex;
+        (void)threadCount;
+        #endif
+    }
+
+    ThreadPin::ThreadPin(size_t threadIndex, size_t threadCount) : previousCpus(readAffinity()) {
+        NumaTopology::get().pinCurrentThread(threadIndex, threadCount);
+    }
+
+    ThreadPin::~ThreadPin() {
+        writeAffinity(previousCpus);
+    }
+
+    TeamPin::TeamPin() : previousCpus(static_cast<size_t>(omp_get_max_threads())) {
+        const NumaTopology& topology = NumaTopology::get();
+
+        #pragma omp parallel
+        {
+            size_t threadIndex = static_cast<size_t>(omp_get_thread_num());
+            previousCpus[threadIndex] = readAffinity();
+            topology.pinCurrentThread(threadIndex, static_cast<size_t>(omp_get_num_threads()));
+        }
+    }
+
+    TeamPin::~TeamPin() {
+        #pragma omp parallel
+        {
+            size_t threadIndex = static_cast<size_t>(omp_get_thread_num());
+            if (threadIndex < previousCpus.size()) {
+                writeAffinity(previousCpus[threadIndex]);
+            }
+        }
+    }
+
+} // namespace rendering
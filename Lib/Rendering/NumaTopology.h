@@ -0,0 +1,235 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef NUMA_TOPOLOGY_H
+#define NUMA_TOPOLOGY_H
+
+#include "../Math/Vector.hpp"
+
+#include <cstddef>
+#include <omp.h>
+
+namespace rendering {
+
+    /**
+     * @class NumaTopology
+     * @brief Describes the NUMA nodes of the host and pins render threads onto them.
+     *
+     * The topology is read once from /sys/devices/system/node on Linux. On other
+     * platforms, or when the information is missing, the host is reported as a single
+     * node holding every processor, and every placement helper becomes a no-op.
+     *
+     * Render threads are spread over the nodes in contiguous blocks: with T threads and
+     * N nodes, thread t lives on node (t * N) / T. The same rule is used to first-touch
+     * framebuffers (static row bands) and to pick the scene replica a thread reads from.
+     */
+    class NumaTopology {
+    public:
+        /**
+         * @brief Get the topology of the host, detected on first use
+         * @return Reference to the shared topology
+         */
+        static const NumaTopology& get();
+
+        /**
+         * @brief Get the number of NUMA nodes
+         * @return The number of nodes (at least 1)
+         */
+        size_t getNodeCount() const { return nodeCpus.size(); }
+
+        /**
+         * @brief Check if the host has more than one NUMA node
+         * @return True on multi-socket machines, false otherwise
+         */
+        bool isMultiNode() const { return nodeCpus.size() > 1; }
+
+        /**
+         * @brief Get the processors belonging to a node
+         * @param node The node index
+         * @return The processor ids of the node
+         * @throws std::out_of_range if node is invalid
+         */
+        const math::Vector<int>& getCpusOfNode(size_t node) const { return nodeCpus[node]; }
+
+        /**
+         * @brief Get the node a processor belongs to
+         * @param cpu The processor id
+         * @return The node index, 0 if the processor is unknown
+         */
+        size_t getNodeOfCpu(int cpu) const;
+
+        /**
+         * @brief Get the node assigned to a render thread
+         * @param threadIndex The index of the thread in its team
+         * @param threadCount The size of the team
+         * @return The node index the thread should run on
+         */
+        size_t getNodeOfThread(size_t threadIndex, size_t threadCount) const;
+
+        /**
+         * @brief Get the node assigned to the calling OpenMP thread
+         * @return The node index of the calling thread
+         */
+        size_t getCurrentThreadNode() const;
+
+        /**
+         * @brief Restrict the calling thread to the processors of its node
+         * The thread keeps the whole node to run on, the previous mask is not saved:
+         * use ThreadPin to get it back. Does nothing on single node hosts.
+         * @param threadIndex The index of the thread in its team
+         * @param threadCount The size of the team
+         */
+        void pinCurrentThread(size_t threadIndex, size_t threadCount) const;
+
+    private:
+        NumaTopology();
+
+        math::Vector<math::Vector<int>> nodeCpus; ///< Processor ids of each node
+        math::Vector<size_t> cpuToNode;           ///< Node of each processor id
+    };
+
+    /**
+     * @class ThreadPin
+     * @brief Pins the calling thread to its node for the lifetime of the object.
+     *
+     * The affinity mask of the thread is saved on construction and restored on
+     * destruction, so a thread borrowed for a parallel region, or the caller itself,
+     * is not left restricted to one node afterward. The thread is only pinned on
+     * multi-node hosts, but its mask is saved and restored on every Linux host.
+     */
+    class ThreadPin {
+    public:
+        /**
+         * @brief Save the affinity of the calling thread and pin it to its node
+         * @param threadIndex The index of the thread in its team
+         * @param threadCount The size of the team
+         */
+        ThreadPin(size_t threadIndex, size_t threadCount);
+
+        /**
+         * @brief Restore the affinity saved on construction
+         */
+        ~ThreadPin();
+
+        ThreadPin(const ThreadPin&) = delete;
+        ThreadPin& operator=(const ThreadPin&) = delete;
+
+    private:
+        math::Vector<int> previousCpus; ///< Processor ids the thread could run on, empty when not saved
+    };
+
+    /**
+     * @class TeamPin
+     * @brief Pins every thread of the default OpenMP team to its node for the lifetime of the object.
+     *
+     * Used around code that first-touches memory in parallel regions it does not own, such as
+     * the Matrix constructors. Each thread saves its affinity mask under its thread number and
+     * gets it back on destruction, which relies on the runtime reusing the same pooled threads
+     * with the same numbers for teams of the same size, as libgomp and libomp do. The threads
+     * are only pinned on multi-node hosts, but their masks are saved and restored on every
+     * Linux host.
+     */
+    class TeamPin {
+    public:
+        /**
+         * @brief Save the affinity of every thread of the default team and pin it to its node
+         */
+        TeamPin();
+
+        /**
+         * @brief Restore the affinity of every thread saved on construction
+         */
+        ~TeamPin();
+
+        TeamPin(const TeamPin&) = delete;
+        TeamPin& operator=(const TeamPin&) = delete;
+
+    private:
+        math::Vector<math::Vector<int>> previousCpus; ///< Processor ids each thread could run on, by thread number
+    };
+
+    /**
+     * @class NodeReplicated
+     * @brief Read-only copy of a value on every NUMA node.
+     *
+     * When enabled on a multi-node host, each node gets its own copy of the value,
+     * allocated by a thread pinned to that node so the pages land in local memory.
+     * Otherwise the wrapper only references the source.
+     *
+     * @tparam T The replicated type, must be default constructible and copy assignable
+     */
+    template<typename T>
+    class NodeReplicated {
+    public:
+        /**
+         * @brief Build the replicas
+         * @param value The source value, must outlive the wrapper
+         * @param enabled Whether to replicate at all
+         */
+        NodeReplicated(const T& value, bool enabled);
+
+        /**
+         * @brief Get the copy local to the calling OpenMP thread
+         * @return Reference to the local replica, or to the source when not replicated
+         */
+        const T& local() const;
+
+        /**
+         * @brief Check if the value was replicated
+         * @return True if there is one copy per node
+         */
+        bool isReplicated() const { return !replicas.empty(); }
+
+    private:
+        const T& source;
+        math::Vector<T> replicas;
+    };
+
+    /* TEMPLATE IMPLEMENTATION */
+
+    template<typename T>
+    NodeReplicated<T>::NodeReplicated(const T& value, bool enabled) : source(value) {
+        const NumaTopology& topology = NumaTopology::get();
+        if (!enabled || !topology.isMultiNode()) {
+            return;
+        }
+
+        size_t nodeCount = topology.getNodeCount();
+        replicas = math::Vector<T>(nodeCount);
+        math::Vector<bool> copied(nodeCount);
+
+        // The first thread of each node copies the value, so the copy is first-touched locally
+        #pragma omp parallel
+        {
+            size_t threadIndex = static_cast<size_t>(omp_get_thread_num());
+            size_t threadCount = static_cast<size_t>(omp_get_num_threads());
+            ThreadPin pin(threadIndex, threadCount);
+
+            size_t node = topology.getNodeOfThread(threadIndex, threadCount);
+            bool firstOfNode = threadIndex == 0 || topology.getNodeOfThread(threadIndex - 1, threadCount) != node;
+            if (firstOfNode) {
+                replicas[node] = source;
+                copied[node] = true;
+            }
+        }
+
+        // Teams smaller than the node count leave some nodes without a copy
+        for (size_t node = 0; node < nodeCount; ++node) {
+            if (!copied[node]) {
+                replicas[node] = source;
+            }
+        }
+    }
+
+    template<typename T>
+    const T& NodeReplicated<T>::local() const {
+        if (replicas.empty()) {
+            return source;
+        }
+        return replicas[NumaTopology::get().getCurrentThreadNode()];
+    }
+
+} // namespace rendering
+
+#endif // NUMA_TOPOLOGY_H
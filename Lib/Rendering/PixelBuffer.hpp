@@ -0,0 +1,273 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef PIXEL_BUFFER_HPP
+#define PIXEL_BUFFER_HPP
+
+#include "../Math/Matrix.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace rendering {
+
+    /**
+     * @brief Memory layout of the pixels of a PixelBuffer
+     */
+    enum class PixelLayout {
+        ROW_MAJOR, ///< One storage row per image row (default)
+        TILED,     ///< Square tiles stored contiguously, pixels row-major inside a tile
+        MORTON     ///< Square tiles stored contiguously, pixels in Morton (Z) order inside a tile
+    };
+
+    /// Side of the square tiles used by the tiled layouts and the tile schedulers, in pixels
+    constexpr size_t PIXEL_TILE_SIZE = 8;
+
+    /**
+     * @class PixelBuffer
+     * @brief 2D per-pixel storage with a selectable memory layout.
+     *
+     * Pixels are addressed with (x, y) whatever the layout. In the tiled layouts each
+     * PIXEL_TILE_SIZE x PIXEL_TILE_SIZE tile is one contiguous storage row, so a pass
+     * working tile by tile (rendering, SSAA downsampling, filters) stays within a few
+     * cache lines and a single page instead of touching PIXEL_TILE_SIZE image rows.
+     * Border tiles are padded, padding pixels are never visible through the accessors.
+     *
+     * @tparam T The per-pixel type, must be default constructible and copy assignable
+     */
+    template<typename T>
+    class PixelBuffer {
+    public:
+        #pragma region Constructors
+
+        /**
+         * @brief Default constructor, creates an empty 0x0 buffer
+         */
+        PixelBuffer();
+
+        /**
+         * @brief Constructs a buffer of default constructed pixels
+         * @param width The width in pixels
+         * @param height The height in pixels
+         * @param layout The memory layout
+         */
+        PixelBuffer(size_t width, size_t height, PixelLayout layout = PixelLayout::ROW_MAJOR);
+
+        /**
+         * @brief Constructs a buffer with every pixel set to a value
+         * Large buffers are initialised in parallel static bands (see Matrix).
+         * @param width The width in pixels
+         * @param height The height in pixels
+         * @param initialValue The value of every pixel
+         * @param layout The memory layout
+         */
+        PixelBuffer(size_t width, size_t height, const T& initialValue, PixelLayout layout = PixelLayout::ROW_MAJOR);
+
+        /**
+         * @brief Constructs a buffer from a row-major matrix indexed (y, x)
+         * @param rowMajor The source pixels
+         * @param layout The memory layout of the new buffer
+         */
+        explicit PixelBuffer(const math::Matrix<T>& rowMajor, PixelLayout layout = PixelLayout::ROW_MAJOR);
+
+        #pragma endregion
+
+        #pragma region Element_Access
+
+        /**
+         * @brief Access a pixel, no bounds checking
+         * @param x The x-coordinate (column)
+         * @param y The y-coordinate (row)
+         * @return Reference to the pixel
+         */
+        inline T& operator()(size_t x, size_t y) { return storage(storageRow(x, y), storageCol(x, y)); }
+        inline const T& operator()(size_t x, size_t y) const { return storage(storageRow(x, y), storageCol(x, y)); }
+
+        size_t getWidth() const { return width; }
+        size_t getHeight() const { return height; }
+        PixelLayout getLayout() const { return layout; }
+
+        #pragma endregion
+
+        #pragma region Utility_Methods
+
+        /**
+         * @brief Set every pixel to a value
+         * @param value The value to write
+         */
+        void fill(const T& value);
+
+        /**
+         * @brief Replace every pixel by f(pixel)
+         * @param f A function of one value, called concurrently on large buffers, and also on the
+         *          padding of partial tiles
+         */
+        template<typename F>
+        void map(F f) { storage.map(f); }
+
+        // Reductions over the pixels, see Matrix::min, max and sum. Tiled buffers with partial
+        // tiles are reduced on a row-major copy, so the padding does not count.
+        T min(bool finiteOnly = false) const;
+        T max(bool finiteOnly = false) const;
+        T sum(bool finiteOnly = false) const;
+
+        /**
+         * @brief Copy the pixels into a row-major matrix indexed (y, x)
+         * Converted tile by tile in parallel, so both sides are read and written in large runs.
+         * @return The row-major matrix
+         */
+        math::Matrix<T> toRowMajor() const;
+
+        /**
+         * @brief Change the memory layout, keeping the pixels
+         * @param newLayout The new layout
+         */
+        void setLayout(PixelLayout newLayout);
+
+        /**
+         * @brief Index of a pixel inside its tile in Morton order
+         * @param localX The x-coordinate inside the tile
+         * @param localY The y-coordinate inside the tile
+         * @return The interleaved index, bit i of x goes to bit 2i and bit i of y to bit 2i+1
+         */
+        static constexpr size_t mortonIndex(size_t localX, size_t localY) {
+            return spreadBits(localX) | (spreadBits(localY) << 1);
+        }
+
+        #pragma endregion
+
+    private:
+        size_t width{0};                        ///< Width in pixels
+        size_t height{0};                       ///< Height in pixels
+        size_t tilesX{0};                       ///< Number of tiles per tile row
+        PixelLayout layout{PixelLayout::ROW_MAJOR};
+        math::Matrix<T> storage;                ///< Image rows, or one row per tile
+
+        static constexpr size_t tileCount(size_t pixels) {
+            return (pixels + PIXEL_TILE_SIZE - 1) / PIXEL_TILE_SIZE;
+        }
+
+        static constexpr size_t spreadBits(size_t v) {
+            uint32_t bits = static_cast<uint32_t>(v) & 0x0000FFFFu;
+            bits = (bits | (bits << 8)) & 0x00FF00FFu;
+            bits = (bits | (bits << 4)) & 0x0F0F0F0Fu;
+            bits = (bits | (bits << 2)) & 0x33333333u;
+            bits = (bits | (bits << 1)) & 0x55555555u;
+            return static_cast<size_t>(bits);
+        }
+
+        bool hasPadding() const {
+            return layout != PixelLayout::ROW_MAJOR && (width % PIXEL_TILE_SIZE != 0 || height % PIXEL_TILE_SIZE != 0);
+        }
+
+        static size_t storageRows(size_t w, size_t h, PixelLayout l) {
+            return l == PixelLayout::ROW_MAJOR ? h : tileCount(w) * tileCount(h);
+        }
+
+        static size_t storageCols(size_t w, size_t h, PixelLayout l) {
+            if (w == 0 || h == 0) return 0;
+            return l == PixelLayout::ROW_MAJOR ? w : PIXEL_TILE_SIZE * PIXEL_TILE_SIZE;
+        }
+
+        inline size_t storageRow(size_t x, size_t y) const {
+            if (layout == PixelLayout::ROW_MAJOR) return y;
+            return (y / PIXEL_TILE_SIZE) * tilesX + x / PIXEL_TILE_SIZE;
+        }
+
+        inline size_t storageCol(size_t x, size_t y) const {
+            switch (layout) {
+                case PixelLayout::TILED:
+                    return (y % PIXEL_TILE_SIZE) * PIXEL_TILE_SIZE + x % PIXEL_TILE_SIZE;
+                case PixelLayout::MORTON:
+                    return mortonIndex(x % PIXEL_TILE_SIZE, y % PIXEL_TILE_SIZE);
+                default:
+                    return x;
+            }
+        }
+    };
+
+    /* TEMPLATE IMPLEMENTATION */
+
+    template<typename T>
+    PixelBuffer<T>::PixelBuffer() : storage(0, 0) {}
+
+    template<typename T>
+    PixelBuffer<T>::PixelBuffer(size_t width, size_t height, PixelLayout layout)
+        : width(width), height(height), tilesX(tileCount(width)), layout(layout),
+          storage(storageRows(width, height, layout), storageCols(width, height, layout)) {}
+
+    template<typename T>
+    PixelBuffer<T>::PixelBuffer(size_t width, size_t height, const T& initialValue, PixelLayout layout)
+        : width(width), height(height), tilesX(tileCount(width)), layout(layout),
+          storage(storageRows(width, height, layout), storageCols(width, height, layout), initialValue) {}
+
+    template<typename T>
+    PixelBuffer<T>::PixelBuffer(const math::Matrix<T>& rowMajor, PixelLayout layout)
+        : PixelBuffer(rowMajor.getCols(), rowMajor.getRows(), layout) {
+        if (layout == PixelLayout::ROW_MAJOR) {
+            storage = rowMajor;
+            return;
+        }
+
+        #pragma omp parallel for schedule(static)
+        for (size_t ty = 0; ty < tileCount(height); ++ty) {
+            for (size_t y = ty * PIXEL_TILE_SIZE; y < std::min(height, (ty + 1) * PIXEL_TILE_SIZE); ++y) {
+                for (size_t x = 0; x < width; ++x) {
+                    (*this)(x, y) = rowMajor(y, x);
+                }
+            }
+        }
+    }
+
+    template<typename T>
+    void PixelBuffer<T>::fill(const T& value) {
+        storage.fill(value);
+    }
+
+    template<typename T>
+    T PixelBuffer<T>::min(bool finiteOnly) const {
+        return hasPadding() ? toRowMajor().min(finiteOnly) : storage.min(finiteOnly);
+    }
+
+    template<typename T>
+    T PixelBuffer<T>::max(bool finiteOnly) const {
+        return hasPadding() ? toRowMajor().max(finiteOnly) : storage.max(finiteOnly);
+    }
+
+    template<typename T>
+    T PixelBuffer<T>::sum(bool finiteOnly) const {
+        return hasPadding() ? toRowMajor().sum(finiteOnly) : storage.sum(finiteOnly);
+    }
+
+    template<typename T>
+    math::Matrix<T> PixelBuffer<T>::toRowMajor() const {
+        if (layout == PixelLayout::ROW_MAJOR) {
+            return storage;
+        }
+
+        math::Matrix<T> rowMajor(height, width);
+        // One band of tile rows per iteration: reads whole tiles, writes PIXEL_TILE_SIZE full rows
+        #pragma omp parallel for schedule(static)
+        for (size_t ty = 0; ty < tileCount(height); ++ty) {
+            for (size_t y = ty * PIXEL_TILE_SIZE; y < std::min(height, (ty + 1) * PIXEL_TILE_SIZE); ++y) {
+                for (size_t x = 0; x < width; ++x) {
+                    rowMajor(y, x) = (*this)(x, y);
+                }
+            }
+        }
+        return rowMajor;
+    }
+
+    template<typename T>
+    void PixelBuffer<T>::setLayout(PixelLayout newLayout) {
+        if (newLayout == layout) {
+            return;
+        }
+        *this = PixelBuffer<T>(toRowMajor(), newLayout);
+    }
+
+} // namespace rendering
+
+#endif // PIXEL_BUFFER_HPP
@@ -6,7 +6,10 @@
 #define RGBA_COLOR_H
 
 #include "../Math/Vector.hpp"
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
+#include <stdexcept>
 
 namespace rendering {
 
@@ -20,13 +23,16 @@ namespace rendering {
      * 
      * Unlike inheriting from Vector, this class uses composition to avoid exposing 
      * vector operations that don't make sense for colors (like normalization, distance, etc.).
+     *
+     * The components are stored inline and every operation is constexpr, so colors are plain
+     * values that the renderer can build and combine without allocating.
      */
     class RGBA_Color {
     public:
         /**
          * @brief Default constructor that creates an RGBA color with all components set to 0.0 (transparent black).
          */
-        RGBA_Color();
+        constexpr RGBA_Color() noexcept;
 
         /**
          * @brief Constructor that creates an RGBA color with specified red, green, blue, and alpha values.
@@ -35,7 +41,7 @@ namespace rendering {
          * @param b The blue component (typically 0.0 to 1.0).
          * @param a The alpha component (typically 0.0 to 1.0).
          */
-        RGBA_Color(double r, double g, double b, double a = 1.0);
+        constexpr RGBA_Color(double r, double g, double b, double a = 1.0) noexcept;
 
         /**
          * @brief Constructor that creates an RGBA_Color from a general Vector.
@@ -48,14 +54,14 @@ namespace rendering {
          * @brief Copy constructor that creates a deep copy of another RGBA_Color.
          * @param other The RGBA_Color to copy.
          */
-        RGBA_Color(const RGBA_Color& other);
+        constexpr RGBA_Color(const RGBA_Color& other) noexcept = default;
 
         /**
          * @brief Assignment operator that performs a deep copy of another RGBA_Color.
          * @param other The RGBA_Color to copy.
          * @return Reference to this RGBA_Color after assignment.
          */
-        RGBA_Color& operator=(const RGBA_Color& other);
+        constexpr RGBA_Color& operator=(const RGBA_Color& other) noexcept = default;
 
         // === Component Access ===
         
@@ -63,49 +69,49 @@ namespace rendering {
          * @brief Get the red component of the color.
          * @return The red component value.
          */
-        [[nodiscard]] double r() const;
+        [[nodiscard]] constexpr double r() const noexcept { return components[0]; }
 
         /**
          * @brief Get the green component of the color.
          * @return The green component value.
          */
-        [[nodiscard]] double g() const;
+        [[nodiscard]] constexpr double g() const noexcept { return components[1]; }
 
         /**
          * @brief Get the blue component of the color.
          * @return The blue component value.
          */
-        [[nodiscard]] double b() const;
+        [[nodiscard]] constexpr double b() const noexcept { return components[2]; }
 
         /**
          * @brief Get the alpha component of the color.
          * @return The alpha component value.
          */
-        [[nodiscard]] double a() const;
+        [[nodiscard]] constexpr double a() const noexcept { return components[3]; }
 
         /**
          * @brief Set the red component of the color.
          * @param red The new red component value.
          */
-        void setR(double red);
+        constexpr void setR(double red) noexcept;
 
         /**
          * @brief Set the green component of the color.
          * @param green The new green component value.
          */
-        void setG(double green);
+        constexpr void setG(double green) noexcept;
 
         /**
          * @brief Set the blue component of the color.
          * @param blue The new blue component value.
          */
-        void setB(double blue);
+        constexpr void setB(double blue) noexcept;
 
         /**
          * @brief Set the alpha component of the color.
          * @param alpha The new alpha component value.
          */
-        void setA(double alpha);
+        constexpr void setA(double alpha) noexcept;
 
         /**
          * @brief Set all RGBA components at once.
@@ -114,12 +120,12 @@ namespace rendering {
          * @param blue The blue component value.
          * @param alpha The alpha component value.
          */
-        void setRGBA(double red, double green, double blue, double alpha = 1.0);
+        constexpr void setRGBA(double red, double green, double blue, double alpha = 1.0) noexcept;
 
         /**
          * @brief Invert the color (1.0 - component) for RGB, alpha remains unchanged.
          */
-        void invert();
+        constexpr void invert() noexcept;
 
         // === Color-Specific Operations ===
 
@@ -128,59 +134,59 @@ namespace rendering {
          * @param other The color to add.
          * @return A new color with the sum of components.
          */
-        RGBA_Color operator+(const RGBA_Color& other) const;
+        constexpr RGBA_Color operator+(const RGBA_Color& other) const noexcept;
 
         /**
          * @brief Subtract two colors component-wise.
          * @param other The color to subtract.
          * @return A new color with the difference of components.
          */
-        RGBA_Color operator-(const RGBA_Color& other) const;
+        constexpr RGBA_Color operator-(const RGBA_Color& other) const noexcept;
 
         /**
          * @brief Multiply color by a scalar (brightness scaling).
          * @param scalar The scalar to multiply by.
          * @return A new color with scaled components.
          */
-        RGBA_Color operator*(double scalar) const;
+        constexpr RGBA_Color operator*(double scalar) const noexcept;
 
         /**
          * @brief Multiply two colors component-wise (color filtering).
          * @param other The color to multiply with.
          * @return A new color with multiplied components.
          */
-        RGBA_Color operator*(const RGBA_Color& other) const;
+        constexpr RGBA_Color operator*(const RGBA_Color& other) const noexcept;
 
         /**
          * @brief Check if two colors are equal.
          * @param other The color to compare with.
          * @return True if colors are equal, false otherwise.
          */
-        bool operator==(const RGBA_Color& other) const;
+        constexpr bool operator==(const RGBA_Color& other) const noexcept;
 
         /**
          * @brief Check if two colors are not equal.
          * @param other The color to compare with.
          * @return True if colors are not equal, false otherwise.
          */
-        bool operator!=(const RGBA_Color& other) const;
+        constexpr bool operator!=(const RGBA_Color& other) const noexcept;
 
         /**
          * @brief Clamp all color components to the range [0.0, 1.0] in place.
          */
-        void clampself();
+        constexpr void clampself() noexcept;
 
         /**
          * @brief Clamp all color components to the range [0.0, 1.0].
          * @return A new RGBA_Color with clamped components.
          */
-        RGBA_Color clamp() const;
+        constexpr RGBA_Color clamp() const noexcept;
 
         /**
          * @brief Convert the color to grayscale using standard luminance weights.
          * @return A new grayscale RGBA_Color (R=G=B=luminance, A=original alpha).
          */
-        RGBA_Color toGrayscale(const double& rw = 0.299, const double& gw = 0.587, const double& bw = 0.114) const;
+        constexpr RGBA_Color toGrayscale(const double& rw = 0.299, const double& gw = 0.587, const double& bw = 0.114) const noexcept;
 
         /**
          * @brief Linearly interpolate between this color and another.
@@ -188,20 +194,20 @@ namespace rendering {
          * @param t The interpolation factor (0.0 = this color, 1.0 = other color).
          * @return A new interpolated color.
          */
-        RGBA_Color lerp(const RGBA_Color& other, double t) const;
+        constexpr RGBA_Color lerp(const RGBA_Color& other, double t) const noexcept;
 
         /**
          * @brief Blend this color with another using alpha blending.
          * @param background The background color.
          * @return A new blended color.
          */
-        RGBA_Color alphaBlend(const RGBA_Color& background) const;
+        constexpr RGBA_Color alphaBlend(const RGBA_Color& background) const noexcept;
 
         /**
-         * @brief Get the underlying vector representation.
-         * @return Const reference to the internal vector.
+         * @brief Get the components as a vector.
+         * @return A Vector containing the r, g, b, a components.
          */
-        [[nodiscard]] const math::Vector<double>& asVector() const;
+        [[nodiscard]] math::Vector<double> asVector() const;
 
         /**
          * @brief Output stream operator for debugging and display purposes.
@@ -217,10 +223,10 @@ namespace rendering {
          * @param color The color.
          * @return A new scaled color.
          */
-        friend RGBA_Color operator*(double scalar, const RGBA_Color& color);
+        friend constexpr RGBA_Color operator*(double scalar, const RGBA_Color& color) noexcept;
 
     private:
-        math::Vector<double> components; ///< Internal storage for RGBA components
+        double components[4]; ///< Internal storage for RGBA components
     };
 
     // Convenience functions for common colors
@@ -228,32 +234,136 @@ namespace rendering {
         /**
          * @brief Create a black color (0, 0, 0, 1).
          */
-        RGBA_Color black();
+        constexpr RGBA_Color black() noexcept { return RGBA_Color(0.0, 0.0, 0.0, 1.0); }
 
         /**
          * @brief Create a white color (1, 1, 1, 1).
          */
-        RGBA_Color white();
+        constexpr RGBA_Color white() noexcept { return RGBA_Color(1.0, 1.0, 1.0, 1.0); }
 
         /**
          * @brief Create a red color (1, 0, 0, 1).
          */
-        RGBA_Color red();
+        constexpr RGBA_Color red() noexcept { return RGBA_Color(1.0, 0.0, 0.0, 1.0); }
 
         /**
          * @brief Create a green color (0, 1, 0, 1).
          */
-        RGBA_Color green();
+        constexpr RGBA_Color green() noexcept { return RGBA_Color(0.0, 1.0, 0.0, 1.0); }
 
         /**
          * @brief Create a blue color (0, 0, 1, 1).
          */
-        RGBA_Color blue();
+        constexpr RGBA_Color blue() noexcept { return RGBA_Color(0.0, 0.0, 1.0, 1.0); }
 
         /**
          * @brief Create a transparent color (0, 0, 0, 0).
          */
-        RGBA_Color transparent();
+        constexpr RGBA_Color transparent() noexcept { return RGBA_Color(0.0, 0.0, 0.0, 0.0); }
+    }
+    // Inline implementation
+
+    constexpr RGBA_Color::RGBA_Color() noexcept : components{0.0, 0.0, 0.0, 0.0} {}
+
+    constexpr RGBA_Color::RGBA_Color(double r, double g, double b, double a) noexcept
+        : components{std::clamp(r, 0.0, 1.0), std::clamp(g, 0.0, 1.0), std::clamp(b, 0.0, 1.0), std::clamp(a, 0.0, 1.0)} {}
+
+    inline RGBA_Color::RGBA_Color(const math::Vector<double>& v) : components{0.0, 0.0, 0.0, 0.0} {
+        if (v.size() != 4) {
+            throw std::invalid_argument("Vector must have exactly 4 components to create an RGBA Color");
+        }
+        setRGBA(v[0], v[1], v[2], v[3]);
+    }
+
+    constexpr void RGBA_Color::setR(double red) noexcept { components[0] = std::clamp(red, 0.0, 1.0); }
+    constexpr void RGBA_Color::setG(double green) noexcept { components[1] = std::clamp(green, 0.0, 1.0); }
+    constexpr void RGBA_Color::setB(double blue) noexcept { components[2] = std::clamp(blue, 0.0, 1.0); }
+    constexpr void RGBA_Color::setA(double alpha) noexcept { components[3] = std::clamp(alpha, 0.0, 1.0); }
+
+    constexpr void RGBA_Color::setRGBA(double red, double green, double blue, double alpha) noexcept {
+        setR(red);
+        setG(green);
+        setB(blue);
+        setA(alpha);
+    }
+
+    constexpr void RGBA_Color::invert() noexcept {
+        setRGBA(1.0 - r(), 1.0 - g(), 1.0 - b(), a());
+    }
+
+    constexpr RGBA_Color RGBA_Color::operator+(const RGBA_Color& other) const noexcept {
+        return RGBA_Color(r() + other.r(), g() + other.g(), b() + other.b(), a() + other.a());
+    }
+
+    constexpr RGBA_Color RGBA_Color::operator-(const RGBA_Color& other) const noexcept {
+        return RGBA_Color(r() - other.r(), g() - other.g(), b() - other.b(), a() - other.a());
+    }
+
+    constexpr RGBA_Color RGBA_Color::operator*(double scalar) const noexcept {
+        return RGBA_Color(r() * scalar, g() * scalar, b() * scalar, a() * scalar);
+    }
+
+    constexpr RGBA_Color RGBA_Color::operator*(const RGBA_Color& other) const noexcept {
+        return RGBA_Color(r() * other.r(), g() * other.g(), b() * other.b(), a() * other.a());
+    }
+
+    constexpr bool RGBA_Color::operator==(const RGBA_Color& other) const noexcept {
+        return r() == other.r() && g() == other.g() && b() == other.b() && a() == other.a();
+    }
+
+    constexpr bool RGBA_Color::operator!=(const RGBA_Color& other) const noexcept {
+        return !(*this == other);
+    }
+
+    constexpr void RGBA_Color::clampself() noexcept {
+        setRGBA(r(), g(), b(), a());
+    }
+
+    constexpr RGBA_Color RGBA_Color::clamp() const noexcept {
+        // Components are kept in [0, 1], the constructor clamps anyway
+        return RGBA_Color(r(), g(), b(), a());
+    }
+
+    constexpr RGBA_Color RGBA_Color::toGrayscale(const double& rw, const double& gw, const double& bw) const noexcept {
+        // Standard luminance weights: 0.299*R + 0.587*G + 0.114*B
+        double luminance = rw * r() + gw * g() + bw * b();
+        return RGBA_Color(luminance, luminance, luminance, a());
+    }
+
+    constexpr RGBA_Color RGBA_Color::lerp(const RGBA_Color& other, double t) const noexcept {
+        t = std::clamp(t, 0.0, 1.0);
+        return RGBA_Color(r() + t * (other.r() - r()),
+                          g() + t * (other.g() - g()),
+                          b() + t * (other.b() - b()),
+                          a() + t * (other.a() - a()));
+    }
+
+    constexpr RGBA_Color RGBA_Color::alphaBlend(const RGBA_Color& background) const noexcept {
+        double alpha = a();
+        double invAlpha = 1.0 - alpha;
+        return RGBA_Color(alpha * r() + invAlpha * background.r(),
+                          alpha * g() + invAlpha * background.g(),
+                          alpha * b() + invAlpha * background.b(),
+                          alpha + invAlpha * background.a());
+    }
+
+    inline math::Vector<double> RGBA_Color::asVector() const {
+        math::Vector<double> result(4);
+        for (size_t i = 0; i < 4; ++i) {
+            result[i] = components[i];
+        }
+        return result;
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, const RGBA_Color& color) {
+        os << std::fixed << std::setprecision(3)
+           << "RGBA(" << color.r() << ", " << color.g() << ", "
+           << color.b() << ", " << color.a() << ")";
+        return os;
+    }
+
+    constexpr RGBA_Color operator*(double scalar, const RGBA_Color& color) noexcept {
+        return color * scalar;
     }
 }
 
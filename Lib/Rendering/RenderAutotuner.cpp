@@ -0,0 +1,123 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "RenderAutotuner.h"
+#include "SceneHash.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace rendering {
+
+    namespace {
+
+        // Time one render with a schedule, best of two after a warmup
+        double benchmark(Camera& camera, const RenderSchedule& schedule, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, size_t width, size_t height) {
+            camera.setRenderSchedule(schedule);
+            camera.renderScene3DLight(width, height, shapes, lights);
+
+            double best = std::numeric_limits<double>::infinity();
+            for (int run = 0; run < 2; ++run) {
+                auto start = std::chrono::steady_clock::now();
+                camera.renderScene3DLight(width, height, shapes, lights);
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                best = std::min(best, elapsed.count());
+            }
+            return best;
+        }
+
+    } // namespace
+
+    RenderAutotuner::RenderAutotuner(const RenderAutotuner& other) {
+        std::lock_guard<std::mutex> lock(other.cacheMutex);
+        cache = other.cache;
+    }
+
+    RenderAutotuner& RenderAutotuner::operator=(const RenderAutotuner& other) {
+        if (this != &other) {
+            std::scoped_lock lock(cacheMutex, other.cacheMutex);
+            cache = other.cache;
+        }
+        return *this;
+    }
+
+    math::Vector<RenderSchedule> RenderAutotuner::candidateSchedules() {
+        int fullTeam = std::max(1, omp_get_max_threads());
+        math::Vector<int> teams;
+        teams.append(fullTeam);
+        if (fullTeam > 1) {
+            teams.append(fullTeam / 2);
+        }
+
+        math::Vector<RenderSchedule> candidates;
+        for (int threads : teams) {
+            for (size_t tileSize : TILE_SIZES) {
+                for (size_t chunkSize : CHUNK_SIZES) {
+                    RenderSchedule schedule;
+                    schedule.tileSize = tileSize;
+                    schedule.chunkSize = chunkSize;
+                    schedule.threadCount = threads;
+                    candidates.append(schedule);
+                }
+            }
+        }
+        return candidates;
+    }
+
+    bool RenderAutotuner::findCached(uint64_t sceneHash, size_t imageWidth, size_t imageHeight, RenderSchedule& schedule) const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(CacheKey(sceneHash, imageWidth, imageHeight));
+        if (it == cache.end()) {
+            return false;
+        }
+        schedule = it->second;
+        return true;
+    }
+
+    size_t RenderAutotuner::getCacheSize() const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return cache.size();
+    }
+
+    void RenderAutotuner::clearCache() {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        cache.clear();
+    }
+
+    RenderSchedule RenderAutotuner::tune(const Camera& camera, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, size_t imageWidth, size_t imageHeight) {
+        if (imageWidth == 0 || imageHeight == 0) {
+            throw std::invalid_argument("Image dimensions must be positive");
+        }
+
+        uint64_t sceneHash = SceneHash::compute(shapes, lights);
+        RenderSchedule best;
+        if (findCached(sceneHash, imageWidth, imageHeight, best)) {
+            return best;
+        }
+
+        // Same aspect ratio as the output, at most BENCHMARK_PIXELS pixels
+        double scale = std::min(1.0, std::sqrt(static_cast<double>(BENCHMARK_PIXELS) / static_cast<double>(imageWidth * imageHeight)));
+        size_t benchmarkWidth = std::max<size_t>(1, static_cast<size_t>(std::lround(imageWidth * scale)));
+        size_t benchmarkHeight = std::max<size_t>(1, static_cast<size_t>(std::lround(imageHeight * scale)));
+
+        Camera benchmarkCamera(camera);
+        double bestTime = std::numeric_limits<double>::infinity();
+        for (const RenderSchedule& candidate : candidateSchedules()) {
+            double time = benchmark(benchmarkCamera, candidate, shapes, lights, benchmarkWidth, benchmarkHeight);
+            if (time < bestTime) {
+                bestTime = time;
+                best = candidate;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        cache[CacheKey(sceneHash, imageWidth, imageHeight)] = best;
+        return best;
+    }
+
+} // namespace rendering
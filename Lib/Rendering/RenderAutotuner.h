@@ -0,0 +1,82 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef RENDER_AUTOTUNER_H
+#define RENDER_AUTOTUNER_H
+
+#include "Camera.h"
+#include "RenderSchedule.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace rendering {
+
+    /**
+     * @class RenderAutotuner
+     * @brief Picks the RenderSchedule of a scene by timing candidates on a small render.
+     *
+     * The best tile size, chunk size and thread count depend on the host and on how uneven
+     * the cost of the pixels of a scene is. The tuner renders a low resolution version of the
+     * actual scene with each candidate schedule and keeps the fastest one, cached per hash of
+     * the scene contents and output resolution. The view is left out of the key, so the frames
+     * of a camera animation only pay for it once.
+     */
+    class RenderAutotuner {
+    public:
+        /// Candidate tile sides, in pixels
+        static constexpr size_t TILE_SIZES[] = {8, 16, 32, 64};
+        /// Candidate tiles per dynamic scheduling chunk
+        static constexpr size_t CHUNK_SIZES[] = {1, 4};
+        /// Maximum number of pixels of the benchmark render
+        static constexpr size_t BENCHMARK_PIXELS = 128 * 128;
+
+        RenderAutotuner() = default;
+        RenderAutotuner(const RenderAutotuner& other);
+        RenderAutotuner& operator=(const RenderAutotuner& other);
+
+        /**
+         * @brief Get the fastest schedule for a lit render of a scene, benchmarking it if not cached
+         * @param camera The camera of the benchmark renders, its schedule and view are not part of the cache key
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @return The fastest candidate schedule
+         * @throws std::invalid_argument if the image dimensions are zero
+         */
+        RenderSchedule tune(const Camera& camera, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, size_t imageWidth, size_t imageHeight);
+
+        /**
+         * @brief Look up a previously tuned schedule
+         * @param sceneHash The hash of the scene (see SceneHash::compute)
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param schedule Output parameter for the cached schedule
+         * @return True if the schedule was cached
+         */
+        bool findCached(uint64_t sceneHash, size_t imageWidth, size_t imageHeight, RenderSchedule& schedule) const;
+
+        size_t getCacheSize() const;
+        void clearCache();
+
+        /**
+         * @brief Get the schedules the tuner chooses from
+         * @return Every tile size and chunk size, with the full and the half OpenMP team
+         */
+        static math::Vector<RenderSchedule> candidateSchedules();
+
+    private:
+        using CacheKey = std::tuple<uint64_t, size_t, size_t>;
+
+        mutable std::mutex cacheMutex;
+        std::map<CacheKey, RenderSchedule> cache;
+    };
+
+} // namespace rendering
+
+#endif // RENDER_AUTOTUNER_H
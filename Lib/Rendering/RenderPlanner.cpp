@@ -0,0 +1,162 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "RenderPlanner.h"
+#include "NumaTopology.h"
+#include "Material.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace rendering {
+
+    namespace {
+
+        std::string formatBytes(size_t bytes) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.1f MiB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+            return buffer;
+        }
+
+        size_t threadCount() {
+            return static_cast<size_t>(std::max(1, omp_get_max_threads()));
+        }
+
+    } // namespace
+
+    RenderPlanner::RenderPlanner(size_t memoryBudget) : memoryBudget(memoryBudget) {
+        if (memoryBudget == 0) {
+            throw std::invalid_argument("Memory budget must be positive");
+        }
+    }
+
+    size_t RenderPlanner::estimateImageBytes(size_t width, size_t height) {
+        // Rounded up to whole tiles, the padding of the tiled layouts
+        size_t paddedWidth = (width + PIXEL_TILE_SIZE - 1) / PIXEL_TILE_SIZE * PIXEL_TILE_SIZE;
+        size_t paddedHeight = (height + PIXEL_TILE_SIZE - 1) / PIXEL_TILE_SIZE * PIXEL_TILE_SIZE;
+        return paddedWidth * paddedHeight * sizeof(RGBA_Color);
+    }
+
+    size_t RenderPlanner::estimateSceneBytes(size_t shapeCount, size_t lightCount) {
+        // Each shape owns its geometry and material on the heap
+        size_t largestGeometry = std::max({sizeof(Box), sizeof(Circle), sizeof(Plane), sizeof(Rectangle), sizeof(Sphere)});
+        size_t shapeBytes = sizeof(Camera::ShapeVariant) + largestGeometry + sizeof(Material);
+        return shapeCount * shapeBytes + lightCount * sizeof(Light);
+    }
+
+    void RenderPlanner::validate(const RenderRequest& request) {
+        if (request.imageWidth == 0 || request.imageHeight == 0) {
+            throw std::invalid_argument("Image dimensions must be positive");
+        }
+        if (request.frameCount == 0) {
+            throw std::invalid_argument("Frame count must be positive");
+        }
+        if (request.method == Camera::AntiAliasingMethod::FXAA) {
+            throw std::invalid_argument("FXAA not implemented yet");
+        }
+        if (request.method != Camera::AntiAliasingMethod::NONE && (request.samplesPerPixel == 0 || request.samplesPerPixel % 4 != 0)) {
+            throw std::invalid_argument("samplesPerPixel must be a multiple of 4 not zero");
+        }
+    }
+
+    MemoryEstimate RenderPlanner::estimate(const RenderRequest& request, SSAAStrategy ssaaStrategy, size_t tileSize, FrameStorage frameStorage) const {
+        validate(request);
+
+        MemoryEstimate result;
+        size_t imageBytes = estimateImageBytes(request.imageWidth, request.imageHeight);
+        result.framebufferBytes = imageBytes;
+
+        switch (request.method) {
+            case Camera::AntiAliasingMethod::SSAA: {
+                size_t factor = request.samplesPerPixel / 2;
+                if (ssaaStrategy == SSAAStrategy::FULL_FRAME) {
+                    result.supersampleBytes = estimateImageBytes(request.imageWidth * factor, request.imageHeight * factor);
+                } else {
+                    if (tileSize == 0) {
+                        throw std::invalid_argument("Tile size must be positive");
+                    }
+                    // One tile of samples per thread
+                    result.supersampleBytes = threadCount() * (tileSize * factor) * (tileSize * factor) * sizeof(RGBA_Color);
+                }
+                break;
+            }
+            case Camera::AntiAliasingMethod::MSAA: {
+                // The covering shape of each sample of the current pixel, per thread
+                result.supersampleBytes = threadCount() * request.samplesPerPixel * sizeof(size_t);
+                break;
+            }
+            default:
+                break;
+        }
+
+        // Video::addFrame copies the stored frames into a new array, so both copies coexist for a moment
+        if (request.frameCount > 1 && frameStorage == FrameStorage::IN_MEMORY) {
+            result.frameStoreBytes = 2 * request.frameCount * imageBytes;
+        }
+
+        // The world's shapes, the copy handed to the renderer and the per-node replicas
+        size_t sceneCopies = 2 + (request.sceneReplication ? NumaTopology::get().getNodeCount() : 0);
+        result.sceneBytes = sceneCopies * estimateSceneBytes(request.shapeCount, request.lightCount);
+
+        return result;
+    }
+
+    RenderPlan RenderPlanner::plan(const RenderRequest& request) const {
+        validate(request);
+
+        RenderPlan result;
+        result.method = request.method;
+        result.samplesPerPixel = request.samplesPerPixel;
+
+        // Frames stay in memory whenever some SSAA strategy fits, streaming costs a disk write per frame
+        math::Vector<FrameStorage> storages(request.frameCount > 1 ? 2 : 1);
+        storages[0] = FrameStorage::IN_MEMORY;
+        if (request.frameCount > 1) {
+            storages[1] = FrameStorage::STREAMING;
+        }
+
+        MemoryEstimate smallest;
+        for (FrameStorage storage : storages) {
+            result.frameStorage = storage;
+
+            result.ssaaStrategy = SSAAStrategy::FULL_FRAME;
+            result.tileSize = 0;
+            result.estimate = estimate(request, SSAAStrategy::FULL_FRAME, 0, storage);
+            if (result.estimate.total() <= memoryBudget) {
+                return result;
+            }
+            smallest = result.estimate;
+
+            if (request.method != Camera::AntiAliasingMethod::SSAA) {
+                continue;
+            }
+
+            result.ssaaStrategy = SSAAStrategy::TILED;
+            for (size_t tileSize : SSAA_TILE_SIZES) {
+                result.tileSize = tileSize;
+                result.estimate = estimate(request, SSAAStrategy::TILED, tileSize, storage);
+                if (result.estimate.total() <= memoryBudget) {
+                    return result;
+                }
+                smallest = result.estimate;
+            }
+        }
+
+        throw std::runtime_error(describeOverflow(request, smallest));
+    }
+
+    std::string RenderPlanner::describeOverflow(const RenderRequest& request, const MemoryEstimate& smallest) const {
+        return "Render of " + std::to_string(request.imageWidth) + "x" + std::to_string(request.imageHeight)
+            + (request.frameCount > 1 ? " over " + std::to_string(request.frameCount) + " frames" : std::string())
+            + " needs at least " + formatBytes(smallest.total())
+            + " (framebuffer " + formatBytes(smallest.framebufferBytes)
+            + ", supersampling " + formatBytes(smallest.supersampleBytes)
+            + ", frames " + formatBytes(smallest.frameStoreBytes)
+            + ", scene " + formatBytes(smallest.sceneBytes)
+            + ") but the memory budget is " + formatBytes(memoryBudget);
+    }
+
+} // namespace rendering
@@ -0,0 +1,143 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef RENDER_PLANNER_H
+#define RENDER_PLANNER_H
+
+#include "Camera.h"
+
+#include <cstddef>
+#include <string>
+
+namespace rendering {
+
+    /**
+     * @brief How the supersampled image of an SSAA render is held
+     */
+    enum class SSAAStrategy {
+        FULL_FRAME, ///< Render the whole upscaled image, then downsample it
+        TILED       ///< Render and downsample one tile of output pixels at a time
+    };
+
+    /**
+     * @brief Where the frames of an animation are kept
+     */
+    enum class FrameStorage {
+        IN_MEMORY, ///< Frames accumulate in the Video
+        STREAMING  ///< Frames are written to disk as they are added (see Video::enableFrameStreaming)
+    };
+
+    /**
+     * @struct RenderRequest
+     * @brief What a lit render or an animation asks for
+     */
+    struct RenderRequest {
+        size_t imageWidth = 0;
+        size_t imageHeight = 0;
+        size_t samplesPerPixel = 4;
+        Camera::AntiAliasingMethod method = Camera::AntiAliasingMethod::NONE;
+        size_t frameCount = 1;          ///< 1 for a still image
+        size_t shapeCount = 0;
+        size_t lightCount = 0;
+        bool sceneReplication = false;  ///< Scene copied per NUMA node while rendering (see Camera::setSceneReplication)
+    };
+
+    /**
+     * @struct MemoryEstimate
+     * @brief Peak memory of a render, by consumer, in bytes
+     */
+    struct MemoryEstimate {
+        size_t framebufferBytes = 0;    ///< Output image
+        size_t supersampleBytes = 0;    ///< SSAA upscaled image or tile buffers, MSAA sample coverage
+        size_t frameStoreBytes = 0;     ///< Frames kept by the Video
+        size_t sceneBytes = 0;          ///< Shapes and lights, with their per-node copies
+
+        size_t total() const { return framebufferBytes + supersampleBytes + frameStoreBytes + sceneBytes; }
+    };
+
+    /**
+     * @struct RenderPlan
+     * @brief How a request fits its memory budget
+     */
+    struct RenderPlan {
+        Camera::AntiAliasingMethod method = Camera::AntiAliasingMethod::NONE;
+        size_t samplesPerPixel = 4;
+        SSAAStrategy ssaaStrategy = SSAAStrategy::FULL_FRAME;
+        size_t tileSize = 0;            ///< Side of the output tiles of a tiled SSAA render, in pixels
+        FrameStorage frameStorage = FrameStorage::IN_MEMORY;
+        MemoryEstimate estimate;
+    };
+
+    /**
+     * @class RenderPlanner
+     * @brief Chooses the memory-bound options of a render from a memory budget.
+     *
+     * SSAA renders an image samplesPerPixel / 2 times larger per axis and a Video keeps every
+     * frame, so the same request can need a few megabytes or far more than the host has.
+     * The planner estimates the peak memory of each option and keeps in-memory frames and a
+     * full-frame SSAA pass while they fit. It then tries in-memory frames with tiled SSAA, from
+     * the largest tiles down, and only streams frames when no in-memory option fits, trying
+     * full-frame and then tiled SSAA again. It refuses the request before anything is allocated
+     * when even the smallest configuration does not fit.
+     */
+    class RenderPlanner {
+    public:
+        /// Candidate tile sides of tiled SSAA, largest first
+        static constexpr size_t SSAA_TILE_SIZES[] = {64, 32, 16, PIXEL_TILE_SIZE};
+
+        /**
+         * @brief Constructor
+         * @param memoryBudget The memory available to the render in bytes
+         * @throws std::invalid_argument if memoryBudget is zero
+         */
+        explicit RenderPlanner(size_t memoryBudget);
+
+        size_t getMemoryBudget() const { return memoryBudget; }
+
+        /**
+         * @brief Estimate the peak memory of a request with given options
+         * @param request The render request
+         * @param ssaaStrategy The SSAA strategy, ignored for other methods
+         * @param tileSize The tile side of tiled SSAA
+         * @param frameStorage The frame storage, ignored for still images
+         * @return The estimate
+         * @throws std::invalid_argument if the request is invalid
+         */
+        MemoryEstimate estimate(const RenderRequest& request, SSAAStrategy ssaaStrategy, size_t tileSize, FrameStorage frameStorage) const;
+
+        /**
+         * @brief Choose the options of a request within the budget
+         * @param request The render request
+         * @return The plan
+         * @throws std::invalid_argument if the request is invalid
+         * @throws std::runtime_error if the request cannot fit in the budget
+         */
+        RenderPlan plan(const RenderRequest& request) const;
+
+        /**
+         * @brief Estimate the memory of an image, including the padding of tiled layouts
+         * @param width The width in pixels
+         * @param height The height in pixels
+         * @return The size in bytes
+         */
+        static size_t estimateImageBytes(size_t width, size_t height);
+
+        /**
+         * @brief Estimate the memory of a scene
+         * @param shapeCount The number of shapes
+         * @param lightCount The number of lights
+         * @return The size in bytes of one copy of the scene
+         */
+        static size_t estimateSceneBytes(size_t shapeCount, size_t lightCount);
+
+    private:
+        size_t memoryBudget;
+
+        static void validate(const RenderRequest& request);
+        std::string describeOverflow(const RenderRequest& request, const MemoryEstimate& smallest) const;
+    };
+
+} // namespace rendering
+
+#endif // RENDER_PLANNER_H
@@ -0,0 +1,44 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef RENDER_SCHEDULE_H
+#define RENDER_SCHEDULE_H
+
+#include "PixelBuffer.hpp"
+
+#include <omp.h>
+#include <cstddef>
+
+namespace rendering {
+
+    /**
+     * @struct RenderSchedule
+     * @brief How the pixels of a render are distributed over the OpenMP team.
+     *
+     * The team itself is the persistent OpenMP thread pool: its threads are kept alive
+     * between parallel regions as long as the team size does not change, so a render
+     * only wakes them. The defaults reproduce the historical 8x8 tiles handed out one
+     * at a time to every available thread. RenderAutotuner picks them per host and scene.
+     */
+    struct RenderSchedule {
+        size_t tileSize = PIXEL_TILE_SIZE;  ///< Side of the square tiles handed to threads, in pixels
+        size_t chunkSize = 1;               ///< Tiles per dynamic scheduling chunk
+        int threadCount = 0;                ///< Threads of the render team, 0 for the OpenMP default
+
+        /**
+         * @brief Get the size of the render team
+         * @return The thread count, the OpenMP default when threadCount is 0
+         */
+        int resolvedThreadCount() const { return threadCount > 0 ? threadCount : omp_get_max_threads(); }
+
+        bool operator==(const RenderSchedule& other) const {
+            return tileSize == other.tileSize && chunkSize == other.chunkSize && threadCount == other.threadCount;
+        }
+
+        bool operator!=(const RenderSchedule& other) const { return !(*this == other); }
+    };
+
+} // namespace rendering
+
+#endif // RENDER_SCHEDULE_H
@@ -0,0 +1,29 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "SceneChanges.h"
+
+namespace rendering {
+
+    void ChangeVersions::record(ChangeKind kinds, uint64_t version) {
+        if (hasChange(kinds, ChangeKind::ADDED)) added = version;
+        if (hasChange(kinds, ChangeKind::GEOMETRY)) geometry = version;
+        if (hasChange(kinds, ChangeKind::MATERIAL)) material = version;
+        if (hasChange(kinds, ChangeKind::TRANSFORM)) transform = version;
+    }
+
+    ChangeKind ChangeVersions::since(uint64_t sinceVersion) const {
+        ChangeKind kinds = ChangeKind::NONE;
+        if (added > sinceVersion) kinds |= ChangeKind::ADDED;
+        if (geometry > sinceVersion) kinds |= ChangeKind::GEOMETRY;
+        if (material > sinceVersion) kinds |= ChangeKind::MATERIAL;
+        if (transform > sinceVersion) kinds |= ChangeKind::TRANSFORM;
+        return kinds;
+    }
+
+    bool SceneChangeSet::changesObjectIndex() const {
+        return objectsRemoved || hasChange(objectKinds, ChangeKind::ADDED | ChangeKind::GEOMETRY | ChangeKind::TRANSFORM);
+    }
+
+} // namespace rendering
@@ -0,0 +1,111 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef SCENE_CHANGES_H
+#define SCENE_CHANGES_H
+
+#include "SlotMap.hpp"
+#include "../Math/Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rendering {
+
+    /**
+     * @brief The kinds of change of an object or a light, combined as bit flags
+     */
+    enum class ChangeKind : uint8_t {
+        NONE = 0,
+        ADDED = 1,      ///< Added to the scene
+        GEOMETRY = 2,   ///< Shape replaced, or the shape of its geometry changed
+        MATERIAL = 4,   ///< Material of an object, color or intensity of a light
+        TRANSFORM = 8   ///< Moved without changing shape
+    };
+
+    inline ChangeKind operator|(ChangeKind a, ChangeKind b) {
+        return static_cast<ChangeKind>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b));
+    }
+
+    inline ChangeKind& operator|=(ChangeKind& a, ChangeKind b) {
+        return a = a | b;
+    }
+
+    /**
+     * @brief Check if a set of changes contains one of some kinds
+     * @param changes The changes
+     * @param kinds The kinds looked for
+     * @return True if any kind of kinds is in changes
+     */
+    inline bool hasChange(ChangeKind changes, ChangeKind kinds) {
+        return (static_cast<uint8_t>(changes) & static_cast<uint8_t>(kinds)) != 0;
+    }
+
+    /**
+     * @struct ChangeVersions
+     * @brief The scene version of the last change of each kind to an object or a light, 0 for never.
+     */
+    struct ChangeVersions {
+        uint64_t added = 0;
+        uint64_t geometry = 0;
+        uint64_t material = 0;
+        uint64_t transform = 0;
+
+        /**
+         * @brief Record a change
+         * @param kinds The kinds of the change
+         * @param version The scene version of the change
+         */
+        void record(ChangeKind kinds, uint64_t version);
+
+        /**
+         * @brief Get the kinds of change since a version
+         * @param sinceVersion The version, changes made at it are not reported
+         * @return The kinds changed after sinceVersion
+         */
+        ChangeKind since(uint64_t sinceVersion) const;
+    };
+
+    /**
+     * @struct SceneChangeSet
+     * @brief What changed in a World between two versions.
+     *
+     * Lists the live objects and lights added or changed and what changed for each. Removed objects
+     * and lights are only flagged, their handles are no longer valid anyway. Camera moves are not
+     * scene changes: an animation of the camera alone yields empty change sets.
+     */
+    struct SceneChangeSet {
+        uint64_t sinceVersion = 0;                  ///< The version the changes are counted from
+        uint64_t version = 0;                       ///< The version of the world when queried
+
+        math::Vector<SlotHandle> objects;           ///< Objects added or changed
+        math::Vector<ChangeKind> objectChanges;     ///< What changed for each object of objects
+        math::Vector<SlotHandle> lights;            ///< Lights added or changed
+        math::Vector<ChangeKind> lightChanges;      ///< What changed for each light of lights
+
+        ChangeKind objectKinds = ChangeKind::NONE;  ///< Every kind of change of the objects
+        ChangeKind lightKinds = ChangeKind::NONE;   ///< Every kind of change of the lights
+        bool objectsRemoved = false;
+        bool lightsRemoved = false;
+
+        bool empty() const { return !changesObjects() && !changesLights(); }
+        bool changesObjects() const { return objectKinds != ChangeKind::NONE || objectsRemoved; }
+        bool changesLights() const { return lightKinds != ChangeKind::NONE || lightsRemoved; }
+
+        /**
+         * @brief Check if the spatial index of the objects was updated
+         * @return True if objects were added, removed, reshaped or moved; material changes leave it alone
+         */
+        bool changesObjectIndex() const;
+
+        /**
+         * @brief Check if caches of the lighting (lightmaps, shadow maps, irradiance) are out of date
+         * @return True for any change of the objects or lights
+         */
+        bool invalidatesLighting() const { return !empty(); }
+    };
+
+} // namespace rendering
+
+#endif // SCENE_CHANGES_H
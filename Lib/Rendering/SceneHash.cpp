@@ -0,0 +1,121 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "SceneHash.h"
+#include "Material.h"
+#include "Texture.h"
+
+namespace rendering {
+
+    namespace {
+
+        constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+        constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+        constexpr SceneField MATERIAL_FIELDS = SceneField::OPACITY | SceneField::ALBEDO | SceneField::SURFACE | SceneField::ALBEDO_TEXTURE;
+
+        void hashBytes(uint64_t& hash, const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= FNV_PRIME;
+            }
+        }
+
+        void hashDouble(uint64_t& hash, double value) {
+            hashBytes(hash, &value, sizeof(value));
+        }
+
+        void hashSize(uint64_t& hash, size_t value) {
+            hashBytes(hash, &value, sizeof(value));
+        }
+
+        void hashColor(uint64_t& hash, const RGBA_Color& color) {
+            hashDouble(hash, color.r());
+            hashDouble(hash, color.g());
+            hashDouble(hash, color.b());
+            hashDouble(hash, color.a());
+        }
+
+        void hashVector(uint64_t& hash, const Vector3D& vector) {
+            hashDouble(hash, vector.x());
+            hashDouble(hash, vector.y());
+            hashDouble(hash, vector.z());
+        }
+
+        // Unset optional colors hash as a flag, so setting one always changes the hash
+        void hashOptionalColor(uint64_t& hash, const RGBA_Color* color) {
+            hashSize(hash, color ? 1 : 0);
+            if (color) {
+                hashColor(hash, *color);
+            }
+        }
+
+        void hashMaterial(uint64_t& hash, const Material& material, SceneField fields) {
+            if (hasField(fields, SceneField::OPACITY)) {
+                hashDouble(hash, material.hasAlbedo() ? material.getAlbedo().a() : 1.0);
+            }
+            if (hasField(fields, SceneField::ALBEDO)) {
+                hashOptionalColor(hash, material.hasAlbedo() ? &material.getAlbedo() : nullptr);
+            }
+            if (hasField(fields, SceneField::ALBEDO_TEXTURE)) {
+                // Texture ids start at 1 and are never reused, an edited texture is a new one
+                hashSize(hash, material.hasAlbedoTexture() ? material.getAlbedoTexture()->getId() : 0);
+                hashDouble(hash, material.getTextureScale());
+            }
+            if (hasField(fields, SceneField::SURFACE)) {
+                hashOptionalColor(hash, material.hasSpecular() ? &material.getSpecular() : nullptr);
+                hashOptionalColor(hash, material.hasEmissive() ? &material.getEmissive() : nullptr);
+                hashDouble(hash, material.getEmissiveIntensity());
+                hashDouble(hash, material.getAbsorption());
+                hashDouble(hash, material.getRoughness());
+                hashDouble(hash, material.getMetalness());
+                hashDouble(hash, material.getRefractiveIndex());
+                hashDouble(hash, material.getTransmission());
+            }
+        }
+
+    } // namespace
+
+    uint64_t SceneHash::compute(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, SceneField fields) {
+        uint64_t hash = FNV_OFFSET_BASIS;
+
+        if (hasField(fields, SceneField::GEOMETRY)) {
+            hashSize(hash, shapes.size());
+        }
+        for (const auto& shape : shapes) {
+            if (hasField(fields, SceneField::GEOMETRY)) {
+                hashSize(hash, shape.index());
+            }
+            std::visit([&](const auto& s) {
+                // Geometry classes only hold doubles, their bytes are their value
+                const auto* geometry = s.getGeometry();
+                if (geometry && hasField(fields, SceneField::GEOMETRY)) {
+                    hashBytes(hash, geometry, sizeof(*geometry));
+                }
+                const Material* material = s.getMaterial();
+                if (hasField(fields, MATERIAL_FIELDS)) {
+                    hashSize(hash, material ? 1 : 0);
+                }
+                if (material) {
+                    hashMaterial(hash, *material, fields);
+                }
+            }, shape);
+        }
+
+        if (hasField(fields, SceneField::LIGHT_POSITIONS | SceneField::LIGHT_EMISSION)) {
+            hashSize(hash, lights.size());
+        }
+        for (const Light& light : lights) {
+            if (hasField(fields, SceneField::LIGHT_POSITIONS)) {
+                hashVector(hash, light.getPosition());
+            }
+            if (hasField(fields, SceneField::LIGHT_EMISSION)) {
+                hashColor(hash, light.getColor());
+                hashDouble(hash, light.getIntensity());
+            }
+        }
+        return hash;
+    }
+
+} // namespace rendering
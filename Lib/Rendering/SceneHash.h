@@ -0,0 +1,68 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef SCENE_HASH_H
+#define SCENE_HASH_H
+
+#include "Camera.h"
+#include "Light.h"
+#include "../Math/Vector.hpp"
+
+#include <cstdint>
+
+namespace rendering {
+
+    /**
+     * @brief The parts of a scene a hash covers, combined as bit flags
+     */
+    enum class SceneField : uint8_t {
+        NONE = 0,
+        GEOMETRY = 1,           ///< Type and geometry of every shape, and the number of shapes
+        OPACITY = 2,            ///< Albedo alpha, what shadow rays stop at
+        ALBEDO = 4,             ///< Albedo color
+        SURFACE = 8,            ///< Specular, emission, absorption, roughness, metalness, refractive index and transmission
+        LIGHT_POSITIONS = 16,   ///< Position of every light, and the number of lights
+        LIGHT_EMISSION = 32,    ///< Color and intensity of every light
+        ALBEDO_TEXTURE = 64,    ///< Identity and scale of albedo textures, which are read-only once opened
+        ALL = 127
+    };
+
+    constexpr SceneField operator|(SceneField a, SceneField b) {
+        return static_cast<SceneField>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b));
+    }
+
+    /**
+     * @brief Check if a set of fields contains one of some fields
+     * @param fields The fields
+     * @param wanted The fields looked for
+     * @return True if any field of wanted is in fields
+     */
+    inline bool hasField(SceneField fields, SceneField wanted) {
+        return (static_cast<uint8_t>(fields) & static_cast<uint8_t>(wanted)) != 0;
+    }
+
+    /**
+     * @class SceneHash
+     * @brief FNV-1a hashes of the contents of a scene, used to tell when a baked cache is stale.
+     *
+     * Each cache hashes only the fields its data depends on, so unrelated edits keep it valid:
+     * the render autotuner hashes everything, shadow maps the geometry, opacity and light
+     * positions, lightmaps and irradiance caches the direct lighting inputs (see their
+     * HASHED_FIELDS). The view is never hashed.
+     */
+    class SceneHash {
+    public:
+        /**
+         * @brief Hash some fields of the shapes and lights of a scene
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         * @param fields The fields to hash
+         * @return The FNV-1a hash of the fields
+         */
+        static uint64_t compute(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, SceneField fields = SceneField::ALL);
+    };
+
+} // namespace rendering
+
+#endif // SCENE_HASH_H
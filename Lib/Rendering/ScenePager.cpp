@@ -0,0 +1,807 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "ScenePager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <variant>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SCENE_PAGER_MMAP 1
+#endif
+
+namespace rendering {
+
+    namespace {
+
+        constexpr char PAGE_FILE_MAGIC[8] = {'S', 'I', '3', 'D', 'P', 'A', 'G', 'E'};
+        constexpr uint32_t PAGE_FILE_VERSION = 1;
+
+        enum RecordFlags : uint32_t {
+            HAS_MATERIAL = 1u << 0,
+            HAS_ALBEDO = 1u << 1,
+            HAS_SPECULAR = 1u << 2,
+            HAS_EMISSIVE = 1u << 3,
+            UNBOUNDED = 1u << 4
+        };
+
+        struct PageFileHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t reserved;
+            uint64_t pageCount;
+            uint64_t recordCount;
+            uint64_t directoryOffset;
+        };
+
+        /// Fixed size on-disk shape, type is the index in Camera::ShapeVariant
+        struct ShapeRecord {
+            uint32_t type;
+            uint32_t flags;
+            double geometry[9];
+            double bounds[6];
+            double albedo[4];
+            double specular[4];
+            double emissive[4];
+            double emissiveIntensity;
+            double absorption;
+            double roughness;
+            double metalness;
+            double refractiveIndex;
+            double transmission;
+        };
+
+        /// Approximate heap footprint of a decoded shape, used for the cache budget
+        constexpr size_t ESTIMATED_SHAPE_BYTES = sizeof(Camera::ShapeVariant) + sizeof(geometry::Box) + sizeof(Material)
+                                                + 3 * (sizeof(RGBA_Color) + sizeof(math::Vector<double>) + 4 * sizeof(double));
+
+        void storeVector(double* out, const Vector3D& v) {
+            out[0] = v.x();
+            out[1] = v.y();
+            out[2] = v.z();
+        }
+
+        Vector3D loadVector(const double* in) {
+            return Vector3D(in[0], in[1], in[2]);
+        }
+
+        void storeColor(double* out, const RGBA_Color& color) {
+            out[0] = color.r();
+            out[1] = color.g();
+            out[2] = color.b();
+            out[3] = color.a();
+        }
+
+        RGBA_Color loadColor(const double* in) {
+            return RGBA_Color(in[0], in[1], in[2], in[3]);
+        }
+
+        void setBounds(ShapeRecord& record, const Vector3D* points, size_t count) {
+            for (int axis = 0; axis < 3; ++axis) {
+                record.bounds[axis] = std::numeric_limits<double>::infinity();
+                record.bounds[3 + axis] = -std::numeric_limits<double>::infinity();
+            }
+            for (size_t i = 0; i < count; ++i) {
+                double coords[3];
+                storeVector(coords, points[i]);
+                for (int axis = 0; axis < 3; ++axis) {
+                    record.bounds[axis] = std::min(record.bounds[axis], coords[axis]);
+                    record.bounds[3 + axis] = std::max(record.bounds[3 + axis], coords[axis]);
+                }
+            }
+        }
+
+        /**
+         * @brief Encode a shape into a record
+         * @return False if the shape has no geometry
+         */
+        bool encodeShape(const Camera::ShapeVariant& variant, ShapeRecord& record) {
+            std::memset(&record, 0, sizeof(record));
+            record.type = static_cast<uint32_t>(variant.index());
+
+            bool hasGeometry = std::visit([&](auto&& shape) {
+                using T = std::decay_t<decltype(shape)>;
+                const auto* geom = shape.getGeometry();
+                if (!geom) {
+                    return false;
+                }
+
+                if constexpr (std::is_same_v<T, Shape<Box>>) {
+                    storeVector(record.geometry, geom->getOrigin());
+                    record.geometry[3] = geom->getWidth();
+                    record.geometry[4] = geom->getHeight();
+                    record.geometry[5] = geom->getDepth();
+                    storeVector(record.geometry + 6, geom->getNormal());
+                    Vector3D corners[2] = {geom->getMinCorner(), geom->getMaxCorner()};
+                    setBounds(record, corners, 2);
+                } else if constexpr (std::is_same_v<T, Shape<Circle>>) {
+                    storeVector(record.geometry, geom->getCenter());
+                    record.geometry[3] = geom->getRadius();
+                    storeVector(record.geometry + 4, geom->getNormal());
+                    Vector3D extent(geom->getRadius(), geom->getRadius(), geom->getRadius());
+                    Vector3D corners[2] = {geom->getCenter() - extent, geom->getCenter() + extent};
+                    setBounds(record, corners, 2);
+                } else if constexpr (std::is_same_v<T, Shape<Plane>>) {
+                    storeVector(record.geometry, geom->getOrigin());
+                    storeVector(record.geometry + 3, geom->getNormal());
+                    record.flags |= UNBOUNDED;
+                    for (int axis = 0; axis < 3; ++axis) {
+                        record.bounds[axis] = -std::numeric_limits<double>::infinity();
+                        record.bounds[3 + axis] = std::numeric_limits<double>::infinity();
+                    }
+                } else if constexpr (std::is_same_v<T, Shape<Rectangle>>) {
+                    Vector3D corners[4];
+                    geom->getCorners(corners);
+                    storeVector(record.geometry, corners[0]);     // Top left
+                    storeVector(record.geometry + 3, corners[1]); // Top right
+                    storeVector(record.geometry + 6, corners[3]); // Bottom left
+                    setBounds(record, corners, 4);
+                } else if constexpr (std::is_same_v<T, Shape<Sphere>>) {
+                    storeVector(record.geometry, geom->getCenter());
+                    record.geometry[3] = geom->getRadius();
+                    Vector3D extent(geom->getRadius(), geom->getRadius(), geom->getRadius());
+                    Vector3D corners[2] = {geom->getCenter() - extent, geom->getCenter() + extent};
+                    setBounds(record, corners, 2);
+                }
+
+                if (const Material* material = shape.getMaterial()) {
+                    record.flags |= HAS_MATERIAL;
+                    if (material->hasAlbedo()) {
+                        record.flags |= HAS_ALBEDO;
+                        storeColor(record.albedo, material->getAlbedo());
+                    }
+                    if (material->hasSpecular()) {
+                        record.flags |= HAS_SPECULAR;
+                        storeColor(record.specular, material->getSpecular());
+                    }
+                    if (material->hasEmissive()) {
+                        record.flags |= HAS_EMISSIVE;
+                        storeColor(record.emissive, material->getEmissive());
+                    }
+                    record.emissiveIntensity = material->getEmissiveIntensity();
+                    record.absorption = material->getAbsorption();
+                    record.roughness = material->getRoughness();
+                    record.metalness = material->getMetalness();
+                    record.refractiveIndex = material->getRefractiveIndex();
+                    record.transmission = material->getTransmission();
+                }
+                return true;
+            }, variant);
+
+            return hasGeometry;
+        }
+
+        Material decodeMaterial(const ShapeRecord& record) {
+            Material material;
+            if (record.flags & HAS_ALBEDO) {
+                material.setAlbedo(loadColor(record.albedo));
+            } else {
+                material.clearAlbedo();
+            }
+            if (record.flags & HAS_SPECULAR) material.setSpecular(loadColor(record.specular));
+            if (record.flags & HAS_EMISSIVE) material.setEmissive(loadColor(record.emissive));
+            material.setEmissiveIntensity(record.emissiveIntensity);
+            material.setAbsorption(record.absorption);
+            material.setRoughness(record.roughness);
+            material.setMetalness(record.metalness);
+            material.setRefractiveIndex(record.refractiveIndex);
+            material.setTransmission(record.transmission);
+            return material;
+        }
+
+        template<typename GeometryType>
+        Camera::ShapeVariant makeShape(const GeometryType& geom, const ShapeRecord& record) {
+            if (record.flags & HAS_MATERIAL) {
+                return Camera::ShapeVariant{Shape<GeometryType>(geom, decodeMaterial(record))};
+            }
+            return Camera::ShapeVariant{Shape<GeometryType>(geom)};
+        }
+
+        Camera::ShapeVariant decodeShape(const ShapeRecord& record) {
+            const double* g = record.geometry;
+            switch (record.type) {
+                case 0: return makeShape(Box(loadVector(g), g[3], g[4], g[5], loadVector(g + 6)), record);
+                case 1: return makeShape(Circle(loadVector(g), g[3], loadVector(g + 4)), record);
+                case 2: return makeShape(Plane(loadVector(g), loadVector(g + 3)), record);
+                case 3: return makeShape(Rectangle(loadVector(g), loadVector(g + 3), loadVector(g + 6)), record);
+                case 4: return makeShape(Sphere(loadVector(g), g[3]), record);
+                default: throw std::runtime_error("Unknown shape type in page file");
+            }
+        }
+
+        /// Spread the low 21 bits of v so that there are two zero bits between each
+        uint64_t spreadBits3(uint64_t v) {
+            v &= 0x1FFFFFull;
+            v = (v | (v << 32)) & 0x1F00000000FFFFull;
+            v = (v | (v << 16)) & 0x1F0000FF0000FFull;
+            v = (v | (v << 8)) & 0x100F00F00F00F00Full;
+            v = (v | (v << 4)) & 0x10C30C30C30C30C3ull;
+            v = (v | (v << 2)) & 0x1249249249249249ull;
+            return v;
+        }
+
+        struct SortKey {
+            uint64_t code;
+            uint64_t record;
+            bool operator<(const SortKey& other) const {
+                return code != other.code ? code < other.code : record < other.record;
+            }
+        };
+
+        /**
+         * @class MappedFile
+         * @brief Read-only view of a whole file, memory mapped when the platform allows it.
+         */
+        class MappedFile {
+        public:
+            explicit MappedFile(const std::string& path) {
+                #ifdef SCENE_PAGER_MMAP
+                descriptor = ::open(path.c_str(), O_RDONLY);
+                if (descriptor < 0) {
+                    throw std::runtime_error("Failed to open file: " + path);
+                }
+                struct stat info;
+                if (fstat(descriptor, &info) != 0) {
+                    ::close(descriptor);
+                    throw std::runtime_error("Failed to stat file: " + path);
+                }
+                length = static_cast<size_t>(info.st_size);
+                if (length > 0) {
+                    void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, descriptor, 0);
+                    if (address == MAP_FAILED) {
+                        ::close(descriptor);
+                        throw std::runtime_error("Failed to map file: " + path);
+                    }
+                    bytes = static_cast<const unsigned char*>(address);
+                }
+                #else
+                FILE* file = fopen(path.c_str(), "rb");
+                if (!file) {
+                    throw std::runtime_error("Failed to open file: " + path);
+                }
+                fseek(file, 0, SEEK_END);
+                length = static_cast<size_t>(ftell(file));
+                fseek(file, 0, SEEK_SET);
+                buffer = std::make_unique<unsigned char[]>(length);
+                if (fread(buffer.get(), 1, length, file) != length) {
+                    fclose(file);
+                    throw std::runtime_error("Failed to read file: " + path);
+                }
+                fclose(file);
+                bytes = buffer.get();
+                #endif
+            }
+
+            ~MappedFile() {
+                #ifdef SCENE_PAGER_MMAP
+                if (bytes) munmap(const_cast<unsigned char*>(bytes), length);
+                if (descriptor >= 0) ::close(descriptor);
+                #endif
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            const unsigned char* data() const { return bytes; }
+            size_t size() const { return length; }
+
+            /// Give up ownership of the mapping, used by ScenePager to keep it open
+            void release(int& outDescriptor, const unsigned char*& outBytes, size_t& outLength) {
+                #ifdef SCENE_PAGER_MMAP
+                outDescriptor = descriptor;
+                outBytes = bytes;
+                outLength = length;
+                descriptor = -1;
+                bytes = nullptr;
+                #else
+                (void)outDescriptor;
+                (void)outBytes;
+                (void)outLength;
+                throw std::logic_error("Mappings can only be released on POSIX platforms");
+                #endif
+            }
+
+        private:
+            const unsigned char* bytes{nullptr};
+            size_t length{0};
+            #ifdef SCENE_PAGER_MMAP
+            int descriptor{-1};
+            #else
+            std::unique_ptr<unsigned char[]> buffer;
+            #endif
+        };
+
+        /**
+         * @brief Distance at which a ray enters an axis aligned box
+         * @return False if the ray misses the box
+         */
+        bool slabEntry(const Ray& ray, const double* boxMin, const double* boxMax, double& entry) {
+            double origin[3];
+            double direction[3];
+            storeVector(origin, ray.getOrigin());
+            storeVector(direction, ray.getDirection());
+
+            double tNear = 0.0;
+            double tFar = std::numeric_limits<double>::infinity();
+            for (int axis = 0; axis < 3; ++axis) {
+                if (direction[axis] == 0.0) {
+                    if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis]) return false;
+                    continue;
+                }
+                double inverse = 1.0 / direction[axis];
+                double t0 = (boxMin[axis] - origin[axis]) * inverse;
+                double t1 = (boxMax[axis] - origin[axis]) * inverse;
+                if (t0 > t1) std::swap(t0, t1);
+                tNear = std::max(tNear, t0);
+                tFar = std::min(tFar, t1);
+                if (tNear > tFar) return false;
+            }
+            entry = tNear;
+            return true;
+        }
+
+    } // namespace
+
+    #pragma region ScenePageWriter
+
+    ScenePageWriter::ScenePageWriter(const std::string& filePath, size_t shapesPerPage)
+        : filePath(filePath), spillPath(filePath + ".spill"), shapesPerPage(shapesPerPage) {
+        if (shapesPerPage == 0) {
+            throw std::invalid_argument("shapesPerPage must be positive");
+        }
+        spill = fopen(spillPath.c_str(), "wb");
+        if (!spill) {
+            throw std::runtime_error("Failed to create spill file: " + spillPath);
+        }
+    }
+
+    ScenePageWriter::~ScenePageWriter() {
+        if (spill) {
+            fclose(spill);
+            std::remove(spillPath.c_str());
+        }
+    }
+
+    void ScenePageWriter::addShape(const Camera::ShapeVariant& shape) {
+        if (finalized) {
+            throw std::logic_error("Cannot add shapes to a finalized page file");
+        }
+        ShapeRecord record;
+        if (!encodeShape(shape, record)) {
+            return;
+        }
+        if (fwrite(&record, sizeof(record), 1, spill) != 1) {
+            throw std::runtime_error("Failed to write spill file: " + spillPath);
+        }
+        ++shapeCount;
+    }
+
+    void ScenePageWriter::finalize() {
+        if (finalized) {
+            return;
+        }
+        finalized = true;
+        fclose(spill);
+        spill = nullptr;
+
+        // The spill file is removed however finalize ends, including when it throws
+        struct SpillRemover {
+            const std::string& path;
+            ~SpillRemover() { std::remove(path.c_str()); }
+        } spillRemover{spillPath};
+
+        MappedFile spilled(spillPath);
+        const unsigned char* recordBytes = spilled.data();
+        auto readRecord = [&](size_t index, ShapeRecord& record) {
+            std::memcpy(&record, recordBytes + index * sizeof(ShapeRecord), sizeof(ShapeRecord));
+        };
+
+        // Bounds of the bounded shape centers, to quantize them on the Morton grid
+        double sceneMin[3] = {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+        double sceneMax[3] = {-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+        size_t unboundedCount = 0;
+        for (size_t i = 0; i < shapeCount; ++i) {
+            ShapeRecord record;
+            readRecord(i, record);
+            if (record.flags & UNBOUNDED) {
+                ++unboundedCount;
+                continue;
+            }
+            for (int axis = 0; axis < 3; ++axis) {
+                double center = 0.5 * (record.bounds[axis] + record.bounds[3 + axis]);
+                sceneMin[axis] = std::min(sceneMin[axis], center);
+                sceneMax[axis] = std::max(sceneMax[axis], center);
+            }
+        }
+
+        size_t boundedCount = shapeCount - unboundedCount;
+        math::Vector<SortKey> keys(boundedCount);
+        math::Vector<uint64_t> unbounded(unboundedCount);
+        size_t nextKey = 0;
+        size_t nextUnbounded = 0;
+        const double gridSize = static_cast<double>((1u << 21) - 1);
+        for (size_t i = 0; i < shapeCount; ++i) {
+            ShapeRecord record;
+            readRecord(i, record);
+            if (record.flags & UNBOUNDED) {
+                unbounded[nextUnbounded++] = i;
+                continue;
+            }
+            uint64_t code = 0;
+            for (int axis = 0; axis < 3; ++axis) {
+                double extent = sceneMax[axis] - sceneMin[axis];
+                double center = 0.5 * (record.bounds[axis] + record.bounds[3 + axis]);
+                double normalized = extent > 0.0 ? (center - sceneMin[axis]) / extent : 0.0;
+                code |= spreadBits3(static_cast<uint64_t>(normalized * gridSize)) << axis;
+            }
+            keys[nextKey++] = SortKey{code, i};
+        }
+        std::sort(keys.begin(), keys.end());
+
+        FILE* out = fopen(filePath.c_str(), "wb");
+        if (!out) {
+            throw std::runtime_error("Failed to create page file: " + filePath);
+        }
+
+        size_t boundedPages = (boundedCount + shapesPerPage - 1) / shapesPerPage;
+        PageFileHeader header{};
+        std::memcpy(header.magic, PAGE_FILE_MAGIC, sizeof(PAGE_FILE_MAGIC));
+        header.version = PAGE_FILE_VERSION;
+        header.pageCount = 1 + boundedPages;
+        header.recordCount = shapeCount;
+        header.directoryOffset = sizeof(PageFileHeader) + shapeCount * sizeof(ShapeRecord);
+        fwrite(&header, sizeof(header), 1, out);
+
+        math::Vector<ScenePager::PageEntry> directory(header.pageCount);
+
+        // Resident page: every unbounded shape, infinite bounds
+        ScenePager::PageEntry& residentEntry = directory[0];
+        for (int axis = 0; axis < 3; ++axis) {
+            residentEntry.min[axis] = -std::numeric_limits<double>::infinity();
+            residentEntry.max[axis] = std::numeric_limits<double>::infinity();
+        }
+        residentEntry.firstRecord = 0;
+        residentEntry.recordCount = unboundedCount;
+        for (size_t i = 0; i < unboundedCount; ++i) {
+            fwrite(recordBytes + unbounded[i] * sizeof(ShapeRecord), sizeof(ShapeRecord), 1, out);
+        }
+
+        // Spatial pages, consecutive runs of the Morton order
+        for (size_t page = 0; page < boundedPages; ++page) {
+            ScenePager::PageEntry& entry = directory[page + 1];
+            entry.firstRecord = unboundedCount + page * shapesPerPage;
+            entry.recordCount = std::min(shapesPerPage, boundedCount - page * shapesPerPage);
+            for (int axis = 0; axis < 3; ++axis) {
+                entry.min[axis] = std::numeric_limits<double>::infinity();
+                entry.max[axis] = -std::numeric_limits<double>::infinity();
+            }
+            for (size_t k = 0; k < entry.recordCount; ++k) {
+                ShapeRecord record;
+                readRecord(keys[page * shapesPerPage + k].record, record);
+                for (int axis = 0; axis < 3; ++axis) {
+                    entry.min[axis] = std::min(entry.min[axis], record.bounds[axis]);
+                    entry.max[axis] = std::max(entry.max[axis], record.bounds[3 + axis]);
+                }
+                fwrite(&record, sizeof(record), 1, out);
+            }
+        }
+
+        fwrite(directory.begin(), sizeof(ScenePager::PageEntry), directory.size(), out);
+        bool failed = ferror(out) != 0;
+        fclose(out);
+        if (failed) {
+            throw std::runtime_error("Failed to write page file: " + filePath);
+        }
+    }
+
+    #pragma endregion
+
+    #pragma region ScenePager
+
+    ScenePager::ScenePager(const std::string& filePath, size_t memoryBudget) : memoryBudget(memoryBudget) {
+        MappedFile file(filePath);
+        if (file.size() < sizeof(PageFileHeader)) {
+            throw std::runtime_error("Not a page file: " + filePath);
+        }
+
+        PageFileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, PAGE_FILE_MAGIC, sizeof(PAGE_FILE_MAGIC)) != 0 || header.version != PAGE_FILE_VERSION || header.pageCount == 0) {
+            throw std::runtime_error("Not a page file: " + filePath);
+        }
+        if (header.directoryOffset > file.size() || header.pageCount > (file.size() - header.directoryOffset) / sizeof(PageEntry)) {
+            throw std::runtime_error("Truncated page file: " + filePath);
+        }
+        // The records must fit between the header and the directory
+        if (header.directoryOffset < sizeof(PageFileHeader)
+            || header.recordCount > (header.directoryOffset - sizeof(PageFileHeader)) / sizeof(ShapeRecord)) {
+            throw std::runtime_error("Corrupt page file: " + filePath);
+        }
+
+        shapeCount = header.recordCount;
+        recordsOffset = sizeof(PageFileHeader);
+        pages = math::Vector<PageEntry>(header.pageCount);
+        std::memcpy(pages.begin(), file.data() + header.directoryOffset, header.pageCount * sizeof(PageEntry));
+        for (const PageEntry& entry : pages) {
+            if (entry.firstRecord > header.recordCount || entry.recordCount > header.recordCount - entry.firstRecord) {
+                throw std::runtime_error("Corrupt page file: " + filePath);
+            }
+        }
+
+        #ifdef SCENE_PAGER_MMAP
+        file.release(fileDescriptor, mapping, mappingSize);
+        #else
+        // Without mmap the records are copied once; pages are still decoded lazily
+        ownedBytes = std::make_unique<unsigned char[]>(file.size());
+        std::memcpy(ownedBytes.get(), file.data(), file.size());
+        mapping = ownedBytes.get();
+        mappingSize = file.size();
+        #endif
+
+        // Hierarchy over the spatial pages, which are already in Morton order
+        if (pages.size() > 1) {
+            size_t spatialPages = pages.size() - 1;
+            pageTree = math::Vector<PageNode>(2 * spatialPages - 1);
+            size_t next = 0;
+            buildPageTree(1, spatialPages, next);
+        }
+
+        cache = math::Vector<std::shared_ptr<const math::Vector<Camera::ShapeVariant>>>(pages.size());
+        lastUse = math::Vector<uint64_t>(pages.size());
+        acquirePage(RESIDENT_PAGE);
+    }
+
+    ScenePager::~ScenePager() {
+        #ifdef SCENE_PAGER_MMAP
+        if (mapping) munmap(const_cast<unsigned char*>(mapping), mappingSize);
+        if (fileDescriptor >= 0) ::close(fileDescriptor);
+        #endif
+    }
+
+    size_t ScenePager::getPageShapeCount(size_t page) const {
+        if (page >= pages.size()) {
+            throw std::out_of_range("Page index out of bounds");
+        }
+        return pages[page].recordCount;
+    }
+
+    size_t ScenePager::getResidentBytes() const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return residentBytes;
+    }
+
+    size_t ScenePager::getPageLoadCount() const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return loadCount;
+    }
+
+    size_t ScenePager::getEvictionCount() const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return evictionCount;
+    }
+
+    bool ScenePager::isPageCached(size_t page) const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return page < cache.size() && cache[page] != nullptr;
+    }
+
+    std::shared_ptr<const math::Vector<Camera::ShapeVariant>> ScenePager::acquirePage(size_t page) {
+        if (page >= pages.size()) {
+            throw std::out_of_range("Page index out of bounds");
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            if (cache[page]) {
+                lastUse[page] = ++useClock;
+                return cache[page];
+            }
+        }
+
+        // Decode outside the lock, a concurrent load of the same page just loses the race
+        std::shared_ptr<const math::Vector<Camera::ShapeVariant>> shapes = decodePage(page);
+        size_t bytes = pages[page].recordCount * ESTIMATED_SHAPE_BYTES;
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (cache[page]) {
+            lastUse[page] = ++useClock;
+            return cache[page];
+        }
+        evictFor(bytes);
+        cache[page] = shapes;
+        lastUse[page] = ++useClock;
+        residentBytes += bytes;
+        ++loadCount;
+        return shapes;
+    }
+
+    bool ScenePager::rayEntersPage(const Ray& ray, size_t page, double& entryDistance) const {
+        if (page == RESIDENT_PAGE) {
+            entryDistance = 0.0;
+            return pages[RESIDENT_PAGE].recordCount > 0;
+        }
+        return slabEntry(ray, pages[page].min, pages[page].max, entryDistance);
+    }
+
+    size_t ScenePager::buildPageTree(size_t first, size_t count, size_t& next) {
+        size_t index = next++;
+        PageNode& node = pageTree[index];
+        node.first = first;
+        node.count = count;
+        node.right = 0;
+
+        if (count == 1) {
+            std::memcpy(node.min, pages[first].min, sizeof(node.min));
+            std::memcpy(node.max, pages[first].max, sizeof(node.max));
+            return index;
+        }
+
+        size_t half = count / 2;
+        size_t left = buildPageTree(first, half, next);
+        size_t right = buildPageTree(first + half, count - half, next);
+        pageTree[index].right = right;
+        for (int axis = 0; axis < 3; ++axis) {
+            pageTree[index].min[axis] = std::min(pageTree[left].min[axis], pageTree[right].min[axis]);
+            pageTree[index].max[axis] = std::max(pageTree[left].max[axis], pageTree[right].max[axis]);
+        }
+        return index;
+    }
+
+    template<typename PageFunction>
+    void ScenePager::forEachPageCrossed(const Ray& ray, PageFunction&& onPage) const {
+        if (pages[RESIDENT_PAGE].recordCount > 0) {
+            onPage(RESIDENT_PAGE, 0.0);
+        }
+        if (pageTree.empty()) {
+            return;
+        }
+
+        // Depth is bounded by log2 of the page count
+        size_t stack[64];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const PageNode& node = pageTree[stack[--top]];
+            double entry;
+            if (!slabEntry(ray, node.min, node.max, entry)) {
+                continue;
+            }
+            if (node.count == 1) {
+                onPage(node.first, entry);
+            } else {
+                stack[top++] = node.right;
+                stack[top++] = static_cast<size_t>(&node - pageTree.begin()) + 1;
+            }
+        }
+    }
+
+    ScenePager::RayQueues ScenePager::buildRayQueues(const math::Vector<Ray>& rays) const {
+        const size_t pageCount = pages.size();
+        math::Vector<size_t> counts(pageCount);
+
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (size_t r = 0; r < rays.size(); ++r) {
+            forEachPageCrossed(rays[r], [&](size_t page, double) {
+                #pragma omp atomic
+                ++counts[page];
+            });
+        }
+
+        RayQueues queues;
+        queues.offsets = math::Vector<size_t>(pageCount + 1);
+        for (size_t page = 0; page < pageCount; ++page) {
+            queues.offsets[page + 1] = queues.offsets[page] + counts[page];
+        }
+        queues.entries = math::Vector<QueueEntry>(queues.offsets[pageCount]);
+
+        math::Vector<size_t> cursors(pageCount);
+        for (size_t page = 0; page < pageCount; ++page) {
+            cursors[page] = queues.offsets[page];
+        }
+
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (size_t r = 0; r < rays.size(); ++r) {
+            forEachPageCrossed(rays[r], [&](size_t page, double entry) {
+                size_t slot;
+                #pragma omp atomic capture
+                slot = cursors[page]++;
+                queues.entries[slot] = QueueEntry{r, entry};
+            });
+        }
+
+        queues.nearest = math::Vector<double>(pageCount);
+        #pragma omp parallel for schedule(static)
+        for (size_t page = 0; page < pageCount; ++page) {
+            double nearest = std::numeric_limits<double>::infinity();
+            for (size_t e = queues.offsets[page]; e < queues.offsets[page + 1]; ++e) {
+                nearest = std::min(nearest, queues.entries[e].entryDistance);
+            }
+            queues.nearest[page] = nearest;
+        }
+        return queues;
+    }
+
+    math::Vector<size_t> ScenePager::schedulePages(const RayQueues& queues) const {
+        size_t used = 0;
+        for (size_t page = 0; page < pages.size(); ++page) {
+            if (queues.offsets[page + 1] > queues.offsets[page]) ++used;
+        }
+
+        math::Vector<size_t> order(used);
+        math::Vector<bool> cached(pages.size());
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            for (size_t page = 0; page < pages.size(); ++page) {
+                cached[page] = cache[page] != nullptr;
+            }
+        }
+
+        size_t next = 0;
+        for (size_t page = 0; page < pages.size(); ++page) {
+            if (queues.offsets[page + 1] > queues.offsets[page]) order[next++] = page;
+        }
+
+        // Resident page, then pages costing no I/O, then front to back so closer hits cull farther pages
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            if ((a == RESIDENT_PAGE) != (b == RESIDENT_PAGE)) return a == RESIDENT_PAGE;
+            if (cached[a] != cached[b]) return static_cast<bool>(cached[a]);
+            return queues.nearest[a] < queues.nearest[b];
+        });
+        return order;
+    }
+
+    void ScenePager::prefetchPage(size_t page) const {
+        #ifdef SCENE_PAGER_MMAP
+        if (isPageCached(page)) {
+            return;
+        }
+        size_t begin = recordsOffset + pages[page].firstRecord * sizeof(ShapeRecord);
+        size_t length = pages[page].recordCount * sizeof(ShapeRecord);
+        size_t systemPage = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t alignedBegin = begin - begin % systemPage;
+        madvise(const_cast<unsigned char*>(mapping) + alignedBegin, length + (begin - alignedBegin), MADV_WILLNEED);
+        #else
+        (void)page;
+        #endif
+    }
+
+    std::shared_ptr<const math::Vector<Camera::ShapeVariant>> ScenePager::decodePage(size_t page) const {
+        const PageEntry& entry = pages[page];
+        auto shapes = std::make_shared<math::Vector<Camera::ShapeVariant>>(entry.recordCount);
+        const unsigned char* records = mapping + recordsOffset + entry.firstRecord * sizeof(ShapeRecord);
+        for (size_t i = 0; i < entry.recordCount; ++i) {
+            ShapeRecord record;
+            std::memcpy(&record, records + i * sizeof(ShapeRecord), sizeof(ShapeRecord));
+            (*shapes)[i] = decodeShape(record);
+        }
+        return shapes;
+    }
+
+    void ScenePager::evictFor(size_t bytes) {
+        while (residentBytes + bytes > memoryBudget) {
+            size_t victim = pages.size();
+            for (size_t page = 0; page < pages.size(); ++page) {
+                if (page == RESIDENT_PAGE || !cache[page]) continue;
+                if (victim == pages.size() || lastUse[page] < lastUse[victim]) victim = page;
+            }
+            if (victim == pages.size()) {
+                return; // Only the resident page is left, the new page goes over budget
+            }
+            // Users still holding the page keep it alive until they release it
+            cache[victim].reset();
+            residentBytes -= pages[victim].recordCount * ESTIMATED_SHAPE_BYTES;
+            ++evictionCount;
+        }
+    }
+
+    #pragma endregion
+
+} // namespace rendering
@@ -0,0 +1,297 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef SCENE_PAGER_H
+#define SCENE_PAGER_H
+
+#include "../Geometry/Ray.h"
+#include "../Geometry/Vector3D.h"
+#include "../Math/Vector.hpp"
+#include "Camera.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace rendering {
+
+    /**
+     * @class ScenePageWriter
+     * @brief Streams shapes into a page file readable by ScenePager.
+     *
+     * Shapes are spilled to disk as they are added, so building a page file never needs
+     * the whole scene in memory. finalize() sorts the shapes along a Morton curve of their
+     * bounding box centers and cuts the sorted list into pages of shapesPerPage shapes, so
+     * every page covers a compact region of space. Unbounded shapes (planes) are stored in
+     * page 0, which the pager keeps resident.
+     */
+    class ScenePageWriter {
+    public:
+        static constexpr size_t DEFAULT_SHAPES_PER_PAGE = 256;
+
+        /**
+         * @brief Start a page file
+         * @param filePath The page file to create
+         * @param shapesPerPage The number of bounded shapes per page
+         * @throws std::invalid_argument if shapesPerPage is zero
+         * @throws std::runtime_error if the spill file cannot be created
+         */
+        explicit ScenePageWriter(const std::string& filePath, size_t shapesPerPage = DEFAULT_SHAPES_PER_PAGE);
+
+        ~ScenePageWriter();
+
+        ScenePageWriter(const ScenePageWriter&) = delete;
+        ScenePageWriter& operator=(const ScenePageWriter&) = delete;
+
+        /**
+         * @brief Add a shape to the page file
+         * @param shape The shape to add, shapes without geometry are skipped
+         * @throws std::logic_error if the writer was already finalized
+         */
+        void addShape(const Camera::ShapeVariant& shape);
+
+        /**
+         * @brief Add a shape to the page file
+         * @tparam T The geometry type of the shape
+         * @param shape The shape to add
+         */
+        template<typename T>
+        void addShape(const Shape<T>& shape) { addShape(Camera::ShapeVariant{shape}); }
+
+        /**
+         * @brief Get the number of shapes added so far
+         * @return The shape count
+         */
+        size_t getShapeCount() const { return shapeCount; }
+
+        /**
+         * @brief Sort the shapes spatially and write the page file
+         * @throws std::runtime_error on I/O errors
+         */
+        void finalize();
+
+    private:
+        std::string filePath;
+        std::string spillPath;
+        size_t shapesPerPage;
+        size_t shapeCount{0};
+        FILE* spill{nullptr};
+        bool finalized{false};
+    };
+
+    /**
+     * @class ScenePager
+     * @brief Out-of-core access to a page file written by ScenePageWriter.
+     *
+     * The file is memory mapped and pages are decoded into shapes on demand. Decoded pages
+     * are kept in an LRU cache bounded by a memory budget; page 0 (unbounded shapes) is
+     * always resident. Rays are traced in batches with traceBatch(): each ray is queued on
+     * every page whose bounds it crosses and stays deferred until that page is loaded, so
+     * each page is decoded at most once per batch whatever the number of rays needing it.
+     */
+    class ScenePager {
+    public:
+        /// Page holding the unbounded shapes, never evicted
+        static constexpr size_t RESIDENT_PAGE = 0;
+
+        /// Directory entry of a page, as stored at the end of the file
+        struct PageEntry {
+            double min[3];          ///< Lower corner of the bounds of the page shapes
+            double max[3];          ///< Upper corner of the bounds of the page shapes
+            uint64_t firstRecord;   ///< Index of the first shape record of the page
+            uint64_t recordCount;   ///< Number of shape records of the page
+        };
+
+        /**
+         * @brief Open a page file
+         * @param filePath The page file written by ScenePageWriter
+         * @param memoryBudget The maximum size of the decoded pages in bytes, the resident page always stays loaded
+         * @throws std::runtime_error if the file cannot be opened or is not a page file
+         */
+        ScenePager(const std::string& filePath, size_t memoryBudget);
+
+        ~ScenePager();
+
+        ScenePager(const ScenePager&) = delete;
+        ScenePager& operator=(const ScenePager&) = delete;
+
+        /**
+         * @brief Get the number of pages, including the resident page
+         * @return The page count
+         */
+        size_t getPageCount() const { return pages.size(); }
+
+        /**
+         * @brief Get the number of shapes in the file
+         * @return The shape count
+         */
+        size_t getShapeCount() const { return shapeCount; }
+
+        /**
+         * @brief Get the number of shapes stored in a page
+         * @param page The page index
+         * @return The shape count of the page
+         * @throws std::out_of_range if page is invalid
+         */
+        size_t getPageShapeCount(size_t page) const;
+
+        /**
+         * @brief Get the memory budget of the page cache
+         * @return The budget in bytes
+         */
+        size_t getMemoryBudget() const { return memoryBudget; }
+
+        /**
+         * @brief Get the estimated size of the pages currently cached
+         * @return The size in bytes
+         */
+        size_t getResidentBytes() const;
+
+        /**
+         * @brief Get the number of pages decoded since the pager was opened
+         * @return The load count
+         */
+        size_t getPageLoadCount() const;
+
+        /**
+         * @brief Get the number of pages evicted since the pager was opened
+         * @return The eviction count
+         */
+        size_t getEvictionCount() const;
+
+        /**
+         * @brief Check if a page is currently cached
+         * @param page The page index
+         * @return True if the page is decoded in memory
+         */
+        bool isPageCached(size_t page) const;
+
+        /**
+         * @brief Get the shapes of a page, loading it if needed
+         * Loading may evict least recently used pages; shapes handed out stay valid
+         * while the returned pointer is held.
+         * @param page The page index
+         * @return Shared pointer to the shapes of the page
+         * @throws std::out_of_range if page is invalid
+         */
+        std::shared_ptr<const math::Vector<Camera::ShapeVariant>> acquirePage(size_t page);
+
+        /**
+         * @brief Compute where a ray enters the bounds of a page
+         * @param ray The ray to test
+         * @param page The page index
+         * @param entryDistance Output, distance along the ray to the page bounds (0 if the origin is inside)
+         * @return True if the ray crosses the page bounds
+         */
+        bool rayEntersPage(const Ray& ray, size_t page, double& entryDistance) const;
+
+        /**
+         * @brief Trace a batch of rays through every page they cross
+         * Pages are visited one at a time: the resident page first, then cached pages, then the
+         * remaining pages from the nearest. A ray is skipped on a page once isActive returns false
+         * for it, and pages left without active rays are never loaded.
+         * @param rays The rays of the batch
+         * @param isActive Callable isActive(rayIndex, entryDistance) deciding if a ray still needs a page
+         * @param visit Callable visit(rayIndex, page, shapes) intersecting a ray with the shapes of a page,
+         *        called in parallel for distinct rays of the same page
+         */
+        template<typename ActiveFunction, typename VisitFunction>
+        void traceBatch(const math::Vector<Ray>& rays, ActiveFunction&& isActive, VisitFunction&& visit);
+
+    private:
+        /// Queued ray of a page
+        struct QueueEntry {
+            size_t ray;
+            double entryDistance;
+        };
+
+        /// Per-page ray queues of a batch, entries of page p are in [offsets[p], offsets[p + 1])
+        struct RayQueues {
+            math::Vector<size_t> offsets;
+            math::Vector<QueueEntry> entries;
+            math::Vector<double> nearest;   ///< Smallest entry distance of each page
+        };
+
+        /// Node of the hierarchy over the page bounds, used to queue rays
+        struct PageNode {
+            double min[3];
+            double max[3];
+            size_t first;   ///< First page of the node
+            size_t count;   ///< Number of pages, 1 for leaves
+            size_t right;   ///< Right child, the left child follows the node
+        };
+
+        math::Vector<PageEntry> pages;
+        math::Vector<PageNode> pageTree;
+        size_t shapeCount{0};
+        size_t memoryBudget;
+
+        int fileDescriptor{-1};
+        const unsigned char* mapping{nullptr};
+        size_t mappingSize{0};
+        size_t recordsOffset{0};
+        std::unique_ptr<unsigned char[]> ownedBytes;   ///< File copy on platforms without mmap
+
+        mutable std::mutex cacheMutex;
+        math::Vector<std::shared_ptr<const math::Vector<Camera::ShapeVariant>>> cache;
+        math::Vector<uint64_t> lastUse;
+        uint64_t useClock{0};
+        size_t residentBytes{0};
+        size_t loadCount{0};
+        size_t evictionCount{0};
+
+        size_t buildPageTree(size_t first, size_t count, size_t& next);
+        template<typename PageFunction>
+        void forEachPageCrossed(const Ray& ray, PageFunction&& onPage) const;
+        RayQueues buildRayQueues(const math::Vector<Ray>& rays) const;
+        math::Vector<size_t> schedulePages(const RayQueues& queues) const;
+        void prefetchPage(size_t page) const;
+        std::shared_ptr<const math::Vector<Camera::ShapeVariant>> decodePage(size_t page) const;
+        void evictFor(size_t bytes);
+    };
+
+    /* TEMPLATE IMPLEMENTATION */
+
+    template<typename ActiveFunction, typename VisitFunction>
+    void ScenePager::traceBatch(const math::Vector<Ray>& rays, ActiveFunction&& isActive, VisitFunction&& visit) {
+        RayQueues queues = buildRayQueues(rays);
+        math::Vector<size_t> order = schedulePages(queues);
+
+        for (size_t k = 0; k < order.size(); ++k) {
+            size_t page = order[k];
+            size_t begin = queues.offsets[page];
+            size_t end = queues.offsets[page + 1];
+
+            // Rays that found a closer hit meanwhile no longer need this page
+            bool anyActive = false;
+            for (size_t e = begin; e < end && !anyActive; ++e) {
+                anyActive = isActive(queues.entries[e].ray, queues.entries[e].entryDistance);
+            }
+            if (!anyActive) {
+                continue;
+            }
+
+            // Let the kernel read the next page while this one is traced
+            if (k + 1 < order.size()) {
+                prefetchPage(order[k + 1]);
+            }
+
+            std::shared_ptr<const math::Vector<Camera::ShapeVariant>> shapes = acquirePage(page);
+
+            #pragma omp parallel for schedule(dynamic, 64)
+            for (size_t e = begin; e < end; ++e) {
+                const QueueEntry& entry = queues.entries[e];
+                if (isActive(entry.ray, entry.entryDistance)) {
+                    visit(entry.ray, page, *shapes);
+                }
+            }
+        }
+    }
+
+} // namespace rendering
+
+#endif // SCENE_PAGER_H
@@ -0,0 +1,194 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "SecondaryRays.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+namespace rendering {
+
+    namespace {
+
+        constexpr int MORTON_BITS = 10;
+
+        // Spread the low 10 bits of a value to every third bit
+        uint64_t spreadBits(uint64_t value) {
+            value &= 0x3ff;
+            value = (value | (value << 16)) & 0x30000ff;
+            value = (value | (value << 8)) & 0x300f00f;
+            value = (value | (value << 4)) & 0x30c30c3;
+            value = (value | (value << 2)) & 0x9249249;
+            return value;
+        }
+
+        uint64_t cellOf(double value, double low, double size) {
+            const double cells = static_cast<double>(1 << MORTON_BITS);
+            double cell = size > 0.0 ? (value - low) / size * cells : 0.0;
+            return static_cast<uint64_t>(std::clamp(cell, 0.0, cells - 1.0));
+        }
+
+    } // namespace
+
+    uint64_t secondaryRayKey(const Vector3D& origin, const Vector3D& direction, const Vector3D& boundsMin, const Vector3D& boundsSize) {
+        uint64_t morton = spreadBits(cellOf(origin.x(), boundsMin.x(), boundsSize.x()))
+            | (spreadBits(cellOf(origin.y(), boundsMin.y(), boundsSize.y())) << 1)
+            | (spreadBits(cellOf(origin.z(), boundsMin.z(), boundsSize.z())) << 2);
+        uint64_t octant = (direction.x() < 0.0 ? 1u : 0u) | (direction.y() < 0.0 ? 2u : 0u) | (direction.z() < 0.0 ? 4u : 0u);
+        return (morton << 3) | octant;
+    }
+
+    SecondaryRayBatch::SecondaryRayBatch(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, const LightingCache& lighting, size_t primaryCount, int recursivityDepth)
+        : shapes(shapes), lights(lights), lighting(lighting), primaries(primaryCount),
+          waves(static_cast<size_t>(std::max(recursivityDepth, 0))) {
+        for (Node& node : primaries) {
+            node.depth = recursivityDepth;
+        }
+    }
+
+    void SecondaryRayBatch::setPrimary(size_t index, const Ray& ray, const Hit& hit) {
+        Node& node = primaries[index];
+        node.valid = true;
+        node.ray = ray;
+        node.hit = hit;
+    }
+
+    void SecondaryRayBatch::shadeWave(math::Vector<Node>& wave) const {
+        Node* nodes = wave.begin();
+        const long long count = static_cast<long long>(wave.size());
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (long long n = 0; n < count; ++n) {
+            Node& node = nodes[n];
+            if (node.valid) {
+                node.shading = Camera::shadeAdvancedHit(node.hit, node.ray, shapes, lights, node.depth, lighting);
+            }
+        }
+    }
+
+    math::Vector<SecondaryRayBatch::Node> SecondaryRayBatch::traceWave(math::Vector<Node>& wave) {
+        // Buffer the secondary rays of the wave, refracted before reflected as processRayHitAdvanced traces them
+        size_t requestCount = 0;
+        for (const Node& node : wave) {
+            requestCount += (node.valid && node.shading.refracts ? 1 : 0) + (node.valid && node.shading.reflects ? 1 : 0);
+        }
+        math::Vector<Request> requests(requestCount);
+        if (requestCount == 0) {
+            return math::Vector<Node>();
+        }
+
+        Vector3D low(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+        Vector3D high = -low;
+        size_t r = 0;
+        for (size_t n = 0; n < wave.size(); ++n) {
+            const Node& node = wave[n];
+            if (!node.valid) {
+                continue;
+            }
+            for (int slot = 0; slot < 2; ++slot) {
+                if (slot == 0 ? !node.shading.refracts : !node.shading.reflects) {
+                    continue;
+                }
+                Request& request = requests[r++];
+                request.ray = slot == 0 ? node.shading.refractRay : node.shading.reflectRay;
+                request.parent = n;
+                request.slot = slot;
+                const Vector3D& origin = request.ray.getOrigin();
+                low = Vector3D(std::min(low.x(), origin.x()), std::min(low.y(), origin.y()), std::min(low.z(), origin.z()));
+                high = Vector3D(std::max(high.x(), origin.x()), std::max(high.y(), origin.y()), std::max(high.z(), origin.z()));
+            }
+        }
+
+        // Sort by origin cell then direction octant, ties kept in spawn order so the batch is deterministic
+        Request* buffered = requests.begin();
+        const Vector3D size = high - low;
+        math::Vector<size_t> order(requestCount);
+        for (size_t i = 0; i < requestCount; ++i) {
+            buffered[i].key = secondaryRayKey(buffered[i].ray.getOrigin(), buffered[i].ray.getDirection(), low, size);
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [buffered](size_t a, size_t b) {
+            return buffered[a].key != buffered[b].key ? buffered[a].key < buffered[b].key : a < b;
+        });
+
+        // Trace in sorted order, consecutive rays going to the same thread
+        const size_t* sorted = order.begin();
+        const Node* parents = wave.begin();
+        const long long count = static_cast<long long>(requestCount);
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (long long i = 0; i < count; ++i) {
+            Request& request = buffered[sorted[i]];
+            std::optional<Hit> closest = Camera::findClosestHit(request.ray, shapes, static_cast<int>(parents[request.parent].hit.shapeIndex));
+            if (closest) {
+                request.hit = true;
+                request.closest = *closest;
+            }
+        }
+        secondaryRayCount += requestCount;
+
+        // The hits form the next wave, in sorted order so it is shaded coherently too
+        size_t hitCount = 0;
+        for (const Request& request : requests) {
+            hitCount += request.hit ? 1 : 0;
+        }
+        math::Vector<Node> next(hitCount);
+        size_t h = 0;
+        for (size_t i = 0; i < requestCount; ++i) {
+            const Request& request = buffered[sorted[i]];
+            if (!request.hit) {
+                continue;
+            }
+            Node& node = next[h++];
+            node.valid = true;
+            node.ray = request.ray;
+            node.hit = request.closest;
+            node.depth = parents[request.parent].depth - 1;
+            node.parent = request.parent;
+            node.slot = request.slot;
+        }
+        return next;
+    }
+
+    void SecondaryRayBatch::trace() {
+        waveCount = 0;
+        secondaryRayCount = 0;
+
+        math::Vector<Node>* current = &primaries;
+        shadeWave(*current);
+        while (waveCount < waves.size()) {
+            math::Vector<Node> next = traceWave(*current);
+            if (next.empty()) {
+                break;
+            }
+            waves[waveCount] = std::move(next);
+            current = &waves[waveCount];
+            ++waveCount;
+            shadeWave(*current);
+        }
+
+        // Blend from the deepest wave up, each hit handing its color to the slot of its parent
+        for (size_t w = waveCount + 1; w-- > 0;) {
+            math::Vector<Node>& wave = w == 0 ? primaries : waves[w - 1];
+            Node* parents = w == 0 ? nullptr : (w == 1 ? primaries.begin() : waves[w - 2].begin());
+            Node* nodes = wave.begin();
+            const long long count = static_cast<long long>(wave.size());
+            #pragma omp parallel for schedule(dynamic, 64)
+            for (long long n = 0; n < count; ++n) {
+                Node& node = nodes[n];
+                if (!node.valid) {
+                    continue;
+                }
+                node.color = Camera::combineAdvancedShading(node.shading, node.childHit[0], node.childColor[0], node.childHit[1], node.childColor[1]);
+                if (parents) {
+                    Node& parent = parents[node.parent];
+                    parent.childHit[node.slot] = true;
+                    parent.childColor[node.slot] = node.color;
+                }
+            }
+        }
+    }
+
+} // namespace rendering
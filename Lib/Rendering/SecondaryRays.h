@@ -0,0 +1,120 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef SECONDARY_RAYS_H
+#define SECONDARY_RAYS_H
+
+#include "Camera.h"
+#include "Light.h"
+#include "../Math/Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rendering {
+
+    /**
+     * @brief Compute the sort key of a secondary ray
+     * The key is the Morton code of the cell holding the origin, in a 1024^3 grid over the bounds
+     * of the batch, followed by the octant of the direction: rays starting close together and heading
+     * the same way get close keys.
+     * @param origin The origin of the ray
+     * @param direction The direction of the ray
+     * @param boundsMin The lowest corner of the origins of the batch
+     * @param boundsSize The size of the bounds of the origins of the batch
+     * @return The sort key
+     */
+    uint64_t secondaryRayKey(const Vector3D& origin, const Vector3D& direction, const Vector3D& boundsMin, const Vector3D& boundsSize);
+
+    /**
+     * @class SecondaryRayBatch
+     * @brief Shades a batch of primary hits as processRayHitAdvanced does, with deferred secondary rays.
+     *
+     * Rather than tracing reflection and refraction rays depth first as they are spawned, the batch
+     * shades one wave of hits at a time. The secondary rays of a wave are buffered, sorted by
+     * secondaryRayKey and traced in that order, so neighboring rays in the trace loop start close
+     * together and head the same way. Their hits form the next wave. Once no ray is left, the colors
+     * are blended back from the deepest wave up, giving the same colors as processRayHitAdvanced.
+     */
+    class SecondaryRayBatch {
+    public:
+        /**
+         * @brief Prepare a batch
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         * @param lighting Precomputed lighting of the scene, used while tracing
+         * @param primaryCount The number of primary rays of the batch
+         * @param recursivityDepth The secondary bounces allowed from each primary hit
+         */
+        SecondaryRayBatch(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, const LightingCache& lighting, size_t primaryCount, int recursivityDepth = 10);
+
+        /**
+         * @brief Set the hit of a primary ray, primaries left unset hit nothing
+         * @param index The index of the primary ray in the batch
+         * @param ray The primary ray
+         * @param hit Its closest hit
+         */
+        void setPrimary(size_t index, const Ray& ray, const Hit& hit);
+
+        /**
+         * @brief Shade every primary hit, wave after wave of sorted secondary rays
+         */
+        void trace();
+
+        /**
+         * @brief Check if a primary ray hit a shape
+         * @param index The index of the primary ray in the batch
+         */
+        bool hasColor(size_t index) const { return primaries[index].valid; }
+
+        /**
+         * @brief Get the color of a primary ray after trace
+         * @param index The index of the primary ray in the batch
+         * @return The color processRayHitAdvanced gives the primary hit
+         */
+        const RGBA_Color& getColor(size_t index) const { return primaries[index].color; }
+
+        size_t getSecondaryRayCount() const { return secondaryRayCount; }
+        size_t getWaveCount() const { return waveCount; }
+
+    private:
+        /// A hit to shade, with the colors its secondary rays bring back
+        struct Node {
+            bool valid = false;
+            Ray ray;
+            Hit hit{0.0, 0};
+            int depth = 0;
+            size_t parent = 0;          ///< Index of the spawning hit in the previous wave
+            int slot = 0;               ///< 0 for a refracted ray, 1 for a reflected one
+            AdvancedShading shading;
+            bool childHit[2] = {false, false};
+            RGBA_Color childColor[2];
+            RGBA_Color color;
+        };
+
+        /// A buffered secondary ray
+        struct Request {
+            Ray ray;
+            size_t parent = 0;
+            int slot = 0;
+            uint64_t key = 0;
+            bool hit = false;
+            Hit closest{0.0, 0};
+        };
+
+        void shadeWave(math::Vector<Node>& wave) const;
+        math::Vector<Node> traceWave(math::Vector<Node>& wave);
+
+        const math::Vector<Camera::ShapeVariant>& shapes;
+        const math::Vector<Light>& lights;
+        LightingCache lighting;
+        math::Vector<Node> primaries;
+        math::Vector<math::Vector<Node>> waves;     ///< The secondary waves, deepest last, one slot per bounce
+        size_t waveCount = 0;
+        size_t secondaryRayCount = 0;
+    };
+
+} // namespace rendering
+
+#endif // SECONDARY_RAYS_H
@@ -0,0 +1,163 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "ShadowMap.h"
+#include "Material.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <variant>
+
+namespace rendering {
+
+    namespace {
+
+        constexpr double HIT_EPSILON = 1e-9;
+        constexpr double TRANSMISSION_THRESHOLD = 1e-12;
+
+        // Distance and index of the closest opaque shape along a ray, as seen by shadow rays
+        void closestOccluder(const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes, float& depth, uint32_t& occluder) {
+            double closest = std::numeric_limits<double>::infinity();
+            occluder = ShadowMap::NO_OCCLUDER;
+            for (size_t i = 0; i < shapes.size(); ++i) {
+                std::visit([&](auto&& shape) {
+                    if (!shape.getGeometry()) {
+                        return;
+                    }
+                    double alpha = shape.getMaterial() ? shape.getMaterial()->getAlbedo().a() : 1.0;
+                    if (alpha < 1.0 - TRANSMISSION_THRESHOLD) {
+                        return;
+                    }
+                    if (auto d = shape.getGeometry()->rayIntersectDepth(ray, closest)) {
+                        if (*d > HIT_EPSILON) {
+                            closest = *d;
+                            occluder = static_cast<uint32_t>(i);
+                        }
+                    }
+                }, shapes[i]);
+            }
+            depth = static_cast<float>(closest);
+        }
+
+    } // namespace
+
+    double ShadowMap::visibility(const Vector3D& point, size_t selfIndex) const {
+        Vector3D toPoint = point - position;
+        double distance = toPoint.length();
+        if (distance == 0.0 || resolution == 0) {
+            return 1.0;
+        }
+
+        // Cube face and face coordinates of the direction
+        double components[3] = {toPoint.x(), toPoint.y(), toPoint.z()};
+        int axis = 0;
+        for (int a = 1; a < 3; ++a) {
+            if (std::fabs(components[a]) > std::fabs(components[axis])) {
+                axis = a;
+            }
+        }
+        double major = std::fabs(components[axis]);
+        size_t face = 2 * static_cast<size_t>(axis) + (components[axis] < 0.0 ? 1 : 0);
+        double u = components[(axis + 1) % 3] / major;
+        double v = components[(axis + 2) % 3] / major;
+
+        const double n = static_cast<double>(resolution);
+        const long long last = static_cast<long long>(resolution) - 1;
+        long long centerI = std::clamp(static_cast<long long>(std::floor((u + 1.0) * 0.5 * n)), 0LL, last);
+        long long centerJ = std::clamp(static_cast<long long>(std::floor((v + 1.0) * 0.5 * n)), 0LL, last);
+
+        // One texel of slack for the receivers of other shapes, contact shadows aside
+        const double bias = distance * 2.0 / n;
+        const size_t faceOffset = face * resolution * resolution;
+        size_t lit = 0;
+        for (long long dj = -1; dj <= 1; ++dj) {
+            size_t j = static_cast<size_t>(std::clamp(centerJ + dj, 0LL, last));
+            for (long long di = -1; di <= 1; ++di) {
+                size_t i = static_cast<size_t>(std::clamp(centerI + di, 0LL, last));
+                size_t texel = faceOffset + j * resolution + i;
+                if (occluder[texel] == selfIndex || depth[texel] >= distance - bias) {
+                    ++lit;
+                }
+            }
+        }
+        return static_cast<double>(lit) / 9.0;
+    }
+
+    ShadowMapSet ShadowMapSet::build(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, size_t resolution) {
+        if (resolution == 0) {
+            throw std::invalid_argument("Shadow map resolution must be positive");
+        }
+
+        ShadowMapSet result;
+        result.sceneHash = SceneHash::compute(shapes, lights, HASHED_FIELDS);
+        result.resolution = resolution;
+        result.maps = math::Vector<ShadowMap>(lights.size());
+        math::Vector<size_t> lightIndices(lights.size());
+        for (size_t l = 0; l < lights.size(); ++l) {
+            lightIndices[l] = l;
+        }
+        result.renderMaps(shapes, lights, lightIndices);
+        return result;
+    }
+
+    ShadowMapSet ShadowMapSet::rebuild(const ShadowMapSet& previous, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, const math::Vector<size_t>& lightIndices) {
+        if (previous.maps.size() != lights.size()) {
+            throw std::invalid_argument("Shadow maps were built for another number of lights");
+        }
+        for (size_t index : lightIndices) {
+            if (index >= lights.size()) {
+                throw std::out_of_range("Light index out of bounds");
+            }
+        }
+
+        ShadowMapSet result(previous);
+        result.sceneHash = SceneHash::compute(shapes, lights, HASHED_FIELDS);
+        result.renderMaps(shapes, lights, lightIndices);
+        return result;
+    }
+
+    void ShadowMapSet::renderMaps(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, const math::Vector<size_t>& lightIndices) {
+        for (size_t index : lightIndices) {
+            ShadowMap& map = maps[index];
+            map.position = lights[index].getPosition();
+            map.resolution = resolution;
+            map.depth = math::Vector<float>(6 * resolution * resolution);
+            map.occluder = math::Vector<uint32_t>(6 * resolution * resolution);
+        }
+
+        // One texel row of one face of one light per iteration, every light in the same loop
+        const long long rowCount = static_cast<long long>(lightIndices.size() * 6 * resolution);
+        const double n = static_cast<double>(resolution);
+        #pragma omp parallel for schedule(dynamic, 4)
+        for (long long row = 0; row < rowCount; ++row) {
+            size_t light = lightIndices[static_cast<size_t>(row) / (6 * resolution)];
+            size_t face = (static_cast<size_t>(row) / resolution) % 6;
+            size_t j = static_cast<size_t>(row) % resolution;
+            int axis = static_cast<int>(face / 2);
+            double sign = face % 2 == 0 ? 1.0 : -1.0;
+
+            ShadowMap& map = maps[light];
+            float* depth = map.depth.begin() + face * resolution * resolution + j * resolution;
+            uint32_t* occluder = map.occluder.begin() + face * resolution * resolution + j * resolution;
+            double v = (static_cast<double>(j) + 0.5) / n * 2.0 - 1.0;
+            for (size_t i = 0; i < resolution; ++i) {
+                double u = (static_cast<double>(i) + 0.5) / n * 2.0 - 1.0;
+                double components[3];
+                components[axis] = sign;
+                components[(axis + 1) % 3] = u;
+                components[(axis + 2) % 3] = v;
+                Ray ray(map.position, Vector3D(components[0], components[1], components[2]).normal());
+                closestOccluder(ray, shapes, depth[i], occluder[i]);
+            }
+        }
+    }
+
+    bool ShadowMapSet::matches(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights) const {
+        return lights.size() == maps.size() && SceneHash::compute(shapes, lights, HASHED_FIELDS) == sceneHash;
+    }
+
+} // namespace rendering
@@ -0,0 +1,119 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef SHADOW_MAP_H
+#define SHADOW_MAP_H
+
+#include "Camera.h"
+#include "Light.h"
+#include "SceneHash.h"
+#include "../Math/Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rendering {
+
+    /**
+     * @struct ShadowMap
+     * @brief The cube depth map of one point light.
+     *
+     * Face 2 * axis + (direction negative) looks along that axis; on a face the two other axes,
+     * in order (axis + 1) % 3 and (axis + 2) % 3, span [-1, 1] over resolution texels.
+     * Each texel holds the distance from the light to the closest opaque shape in its direction
+     * and the index of that shape.
+     */
+    struct ShadowMap {
+        static constexpr uint32_t NO_OCCLUDER = UINT32_MAX;
+
+        Vector3D position;                  ///< Position of the light
+        size_t resolution = 0;              ///< Texels per side of each face
+        math::Vector<float> depth;          ///< Distance to the closest occluder, infinity if none
+        math::Vector<uint32_t> occluder;    ///< Index of the closest occluder, NO_OCCLUDER if none
+
+        /**
+         * @brief Estimate how much of the light reaches a point, with 3x3 percentage closer filtering
+         * Texels whose closest occluder is the shape of the point never shadow it, as shadow rays
+         * never test the shape they start from.
+         * @param point The lit point
+         * @param selfIndex The index of the shape of the point
+         * @return The fraction of unshadowed texels around the direction of the point, between 0 and 1
+         */
+        double visibility(const Vector3D& point, size_t selfIndex) const;
+    };
+
+    /**
+     * @class ShadowMapSet
+     * @brief Cube shadow maps of every light of a scene, an approximate alternative to shadow rays.
+     *
+     * Building casts one ray per texel from each light, in parallel over all lights. Shadow queries
+     * then cost a filtered lookup whatever the number of shapes. Translucent shapes cast no shadow
+     * in shadow maps, and features thinner than a texel may leak light.
+     */
+    class ShadowMapSet {
+    public:
+        static constexpr size_t DEFAULT_RESOLUTION = 256;
+        /// The maps hold the closest opaque shape seen from each light, whatever its color or the light's
+        static constexpr SceneField HASHED_FIELDS = SceneField::GEOMETRY | SceneField::OPACITY | SceneField::LIGHT_POSITIONS;
+
+        ShadowMapSet() = default;
+
+        /**
+         * @brief Render the shadow maps of every light of a scene
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         * @param resolution The texels per side of each cube face
+         * @return The shadow maps, one per light in order
+         * @throws std::invalid_argument if resolution is zero
+         */
+        static ShadowMapSet build(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, size_t resolution = DEFAULT_RESOLUTION);
+
+        /**
+         * @brief Render the shadow maps of some lights again, after they moved
+         * The maps of the other lights are copied: only valid if the shapes and the positions of those
+         * lights are those of the previous build, e.g. after lights moved or changed color.
+         * @param previous The maps of the scene before the change
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         * @param lightIndices The lights whose maps are rendered again
+         * @return The shadow maps, one per light in order
+         * @throws std::invalid_argument if previous has another number of lights
+         * @throws std::out_of_range if a light index is out of bounds
+         */
+        static ShadowMapSet rebuild(const ShadowMapSet& previous, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, const math::Vector<size_t>& lightIndices);
+
+        /**
+         * @brief Check if the maps were built from a scene
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         * @return True if the HASHED_FIELDS of the scene are those of the build
+         */
+        bool matches(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights) const;
+
+        /**
+         * @brief Estimate how much of a light reaches a point
+         * @param lightIndex The index of the light in the scene
+         * @param point The lit point
+         * @param selfIndex The index of the shape of the point
+         * @return The visibility of the light, between 0 and 1
+         */
+        double visibility(size_t lightIndex, const Vector3D& point, size_t selfIndex) const {
+            return maps[lightIndex].visibility(point, selfIndex);
+        }
+
+        size_t getMapCount() const { return maps.size(); }
+        size_t getResolution() const { return resolution; }
+        const ShadowMap& getMap(size_t lightIndex) const { return maps[lightIndex]; }
+
+    private:
+        uint64_t sceneHash = 0;
+        size_t resolution = 0;
+        math::Vector<ShadowMap> maps;
+
+        void renderMaps(const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, const math::Vector<size_t>& lightIndices);
+    };
+
+} // namespace rendering
+
+#endif // SHADOW_MAP_H
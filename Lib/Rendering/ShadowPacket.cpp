@@ -0,0 +1,188 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "ShadowPacket.h"
+
+#include <algorithm>
+#include <cmath>
+#include <variant>
+
+namespace rendering {
+
+    namespace {
+
+        // Slack of the culling tests, so rounding never culls a shape a ray would hit
+        constexpr double CULL_EPSILON = 1e-9;
+
+        // Widest packet cone still worth testing against, beyond it nothing is culled by the cone
+        constexpr double MIN_CONE_COSINE = 1e-3;
+
+    } // namespace
+
+    ShadowPacketTracer::ShadowPacketTracer(const math::Vector<Camera::ShapeVariant>& shapes)
+        : shapes(shapes), bounds(shapes.size()) {
+        for (size_t i = 0; i < shapes.size(); ++i) {
+            ShapeBound& bound = bounds[i];
+            std::visit([&](auto&& shape) {
+                using T = std::decay_t<decltype(shape)>;
+                const auto* geom = shape.getGeometry();
+                if (!geom) {
+                    return;
+                }
+                bound.valid = true;
+
+                if constexpr (std::is_same_v<T, Shape<Plane>>) {
+                    bound.planar = true;
+                    bound.center = geom->getOrigin();
+                    bound.normal = geom->getNormal().normal();
+                } else if constexpr (std::is_same_v<T, Shape<Sphere>> || std::is_same_v<T, Shape<Circle>>) {
+                    bound.center = geom->getCenter();
+                    bound.radius = geom->getRadius();
+                } else if constexpr (std::is_same_v<T, Shape<Box>>) {
+                    bound.center = geom->getCenter();
+                    bound.radius = 0.5 * (geom->getMaxCorner() - geom->getMinCorner()).length();
+                } else if constexpr (std::is_same_v<T, Shape<Rectangle>>) {
+                    bound.center = geom->getCenter();
+                    bound.radius = 0.5 * std::sqrt(geom->getLength() * geom->getLength() + geom->getWidth() * geom->getWidth());
+                }
+            }, shapes[i]);
+        }
+    }
+
+    void ShadowPacketTracer::cull(const Vector3D& lightPosition, const Vector3D* points, const size_t* selfIndices, size_t count, math::Vector<size_t>& candidates) const {
+        candidates = math::Vector<size_t>();
+
+        // The cone from the light around the directions of the points
+        Vector3D axis(0, 0, 0);
+        double farthest = 0.0;
+        bool coneUsable = count > 0;
+        for (size_t k = 0; k < count && coneUsable; ++k) {
+            Vector3D toPoint = points[k] - lightPosition;
+            double distance = toPoint.length();
+            coneUsable = distance > CULL_EPSILON;
+            if (coneUsable) {
+                axis = axis + toPoint * (1.0 / distance);
+                farthest = std::max(farthest, distance);
+            }
+        }
+        double cosine = -1.0;
+        if (coneUsable && axis.length() > CULL_EPSILON) {
+            axis = axis.normal();
+            cosine = 1.0;
+            for (size_t k = 0; k < count; ++k) {
+                Vector3D toPoint = points[k] - lightPosition;
+                cosine = std::min(cosine, axis.dot(toPoint) / toPoint.length());
+            }
+            cosine -= CULL_EPSILON;
+        }
+        coneUsable = coneUsable && cosine > MIN_CONE_COSINE;
+        const double sine = coneUsable ? std::sqrt(std::max(0.0, 1.0 - cosine * cosine)) : 1.0;
+
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            const ShapeBound& bound = bounds[i];
+            if (!bound.valid) {
+                continue;
+            }
+
+            bool culled = false;
+            if (bound.planar) {
+                // No segment crosses a plane with the light and every point strictly on the same side
+                double lightSide = bound.normal.dot(lightPosition - bound.center);
+                culled = std::fabs(lightSide) > CULL_EPSILON;
+                for (size_t k = 0; k < count && culled; ++k) {
+                    if (selfIndices[k] != i) {
+                        double pointSide = bound.normal.dot(points[k] - bound.center);
+                        culled = std::fabs(pointSide) > CULL_EPSILON && (pointSide > 0.0) == (lightSide > 0.0);
+                    }
+                }
+            } else if (coneUsable) {
+                // Bounding sphere against the cone, capped by the farthest point
+                Vector3D toCenter = bound.center - lightPosition;
+                double radius = bound.radius + CULL_EPSILON * (1.0 + toCenter.length());
+                double along = toCenter.dot(axis);
+                double across = (toCenter - axis * along).length();
+                culled = along < -radius || along > farthest + radius || across * cosine - along * sine > radius;
+            }
+
+            if (!culled) {
+                candidates.append(i);
+            }
+        }
+    }
+
+    size_t ShadowPacketTracer::trace(const Vector3D& lightPosition, const Vector3D* points, const size_t* selfIndices, size_t count, double* transmission, size_t stride) const {
+        math::Vector<size_t> candidates;
+        cull(lightPosition, points, selfIndices, count, candidates);
+        for (size_t k = 0; k < count; ++k) {
+            transmission[k * stride] = Camera::shadowTransmission(points[k], lightPosition, shapes, selfIndices[k], &candidates);
+        }
+        return candidates.size();
+    }
+
+    void ShadowTile::reset(size_t pixelCount, size_t lightCount) {
+        if (pixels.size() != pixelCount || this->lightCount != lightCount) {
+            this->lightCount = lightCount;
+            pixels = math::Vector<PixelShadows>(pixelCount);
+            normals = math::Vector<Vector3D>(pixelCount);
+            transmissions = math::Vector<double>(pixelCount * lightCount);
+            packetPoints = math::Vector<Vector3D>(pixelCount);
+            packetShapes = math::Vector<size_t>(pixelCount);
+            packetPixels = math::Vector<size_t>(pixelCount);
+            packetTransmissions = math::Vector<double>(pixelCount);
+        }
+        for (size_t pixel = 0; pixel < pixelCount; ++pixel) {
+            pixels[pixel].shapeIndex = PixelShadows::NO_SHAPE;
+            pixels[pixel].transmission = transmissions.begin() + pixel * lightCount;
+        }
+        std::fill(transmissions.begin(), transmissions.end(), PixelShadows::NOT_TRACED);
+    }
+
+    void ShadowTile::setPoint(size_t pixel, const Vector3D& point, const Vector3D& normal, size_t shapeIndex) {
+        pixels[pixel].point = point;
+        pixels[pixel].shapeIndex = shapeIndex;
+        normals[pixel] = normal;
+    }
+
+    void ShadowTile::trace(const ShadowPacketTracer& tracer, const math::Vector<Light>& lights, const LightBlock& lightBlock) {
+        // Mark the lights facing each point, as calculateLighting only queries those
+        double weightsSquared[LightBlock::CHUNK];
+        for (size_t pixel = 0; pixel < pixels.size(); ++pixel) {
+            if (pixels[pixel].shapeIndex == PixelShadows::NO_SHAPE) {
+                continue;
+            }
+            double* pixelTransmissions = transmissions.begin() + pixel * lightCount;
+            for (size_t first = 0; first < lightCount; first += LightBlock::CHUNK) {
+                const size_t chunk = std::min(LightBlock::CHUNK, lightCount - first);
+                lightBlock.unshadowedWeights(first, chunk, pixels[pixel].point, normals[pixel], weightsSquared);
+                for (size_t k = 0; k < chunk; ++k) {
+                    if (weightsSquared[k] > 0.0) {
+                        pixelTransmissions[first + k] = 0.0;
+                    }
+                }
+            }
+        }
+
+        // One packet per light, made of the points it faces
+        for (size_t light = 0; light < lightCount; ++light) {
+            size_t packetSize = 0;
+            for (size_t pixel = 0; pixel < pixels.size(); ++pixel) {
+                if (pixels[pixel].shapeIndex != PixelShadows::NO_SHAPE && transmissions[pixel * lightCount + light] != PixelShadows::NOT_TRACED) {
+                    packetPoints[packetSize] = pixels[pixel].point;
+                    packetShapes[packetSize] = pixels[pixel].shapeIndex;
+                    packetPixels[packetSize] = pixel;
+                    ++packetSize;
+                }
+            }
+            if (packetSize == 0) {
+                continue;
+            }
+
+            tracer.trace(lights[light].getPosition(), packetPoints.begin(), packetShapes.begin(), packetSize, packetTransmissions.begin());
+            for (size_t k = 0; k < packetSize; ++k) {
+                transmissions[packetPixels[k] * lightCount + light] = packetTransmissions[k];
+            }
+        }
+    }
+
+} // namespace rendering
@@ -0,0 +1,152 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef SHADOW_PACKET_H
+#define SHADOW_PACKET_H
+
+#include "Camera.h"
+#include "LightBlock.h"
+#include "Light.h"
+#include "../Math/Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rendering {
+
+    /**
+     * @struct PixelShadows
+     * @brief The shadow rays of the first surface seen by one pixel, traced ahead with its tile.
+     *
+     * Camera::calculateLighting uses the transmissions when it lights that exact point of that
+     * shape, and traces its own shadow rays for any other point.
+     */
+    struct PixelShadows {
+        static constexpr size_t NO_SHAPE = SIZE_MAX;
+        static constexpr double NOT_TRACED = -1.0;
+
+        Vector3D point;                             ///< The shaded point
+        size_t shapeIndex = NO_SHAPE;               ///< The shape of the point, NO_SHAPE if the pixel hit nothing
+        const double* transmission = nullptr;       ///< Transmission of each light, NOT_TRACED if not traced
+
+        /**
+         * @brief Get the precomputed transmission of a light at a point
+         * @return The transmission, NOT_TRACED if the point or the light was not traced ahead
+         */
+        double lookup(const Vector3D& hitPoint, size_t selfIndex, size_t lightIndex) const {
+            // Exact comparison: the renderers compute the point the same way before and while shading
+            if (selfIndex != shapeIndex || hitPoint.x() != point.x() || hitPoint.y() != point.y() || hitPoint.z() != point.z()) {
+                return NOT_TRACED;
+            }
+            return transmission[lightIndex];
+        }
+    };
+
+    /**
+     * @class ShadowPacketTracer
+     * @brief Traces the shadow rays of many points toward one light as a packet.
+     *
+     * All the rays of a packet converge on the light, so they lie in the cone from the light through
+     * the points. Shapes whose bounding sphere misses the cone, and planes with the light and every
+     * point on the same side, are culled once for the packet; each ray is then only tested against
+     * the remaining shapes, in scene order, which gives the same transmissions as tracing it alone.
+     */
+    class ShadowPacketTracer {
+    public:
+        /**
+         * @brief Compute the bounds of the shapes of a scene
+         * @param shapes The shapes of the scene, which must outlive the tracer
+         */
+        explicit ShadowPacketTracer(const math::Vector<Camera::ShapeVariant>& shapes);
+
+        /**
+         * @brief Find the shapes that may shadow any point of a packet
+         * @param lightPosition The position of the light
+         * @param points The lit points
+         * @param selfIndices The shape of each point, which does not shadow it
+         * @param count The number of points
+         * @param candidates Output, the indices of the shapes that are not culled, in scene order
+         */
+        void cull(const Vector3D& lightPosition, const Vector3D* points, const size_t* selfIndices, size_t count, math::Vector<size_t>& candidates) const;
+
+        /**
+         * @brief Trace the shadow rays of a packet of points toward one light
+         * @param lightPosition The position of the light
+         * @param points The lit points
+         * @param selfIndices The shape of each point, which does not shadow it
+         * @param count The number of points
+         * @param transmission Output, the transmission of the light at each point
+         * @param stride The distance between two outputs in transmission
+         * @return The number of shapes left after culling
+         */
+        size_t trace(const Vector3D& lightPosition, const Vector3D* points, const size_t* selfIndices, size_t count, double* transmission, size_t stride = 1) const;
+
+    private:
+        /// Bounding sphere of a shape, or the plane of an unbounded one
+        struct ShapeBound {
+            bool valid = false;     ///< False for shapes without geometry, which never shadow
+            bool planar = false;    ///< True for infinite planes, bounded by their plane only
+            Vector3D center;        ///< Center of the sphere, a point of the plane
+            Vector3D normal;        ///< Normal of the plane
+            double radius = 0.0;    ///< Radius of the sphere
+        };
+
+        const math::Vector<Camera::ShapeVariant>& shapes;
+        math::Vector<ShapeBound> bounds;
+    };
+
+    /**
+     * @class ShadowTile
+     * @brief The first surfaces seen by the pixels of one tile, and their shadow rays traced per light.
+     *
+     * Renderers record the shaded point of each pixel, trace the tile once, then shade each pixel
+     * with its PixelShadows in its LightingCache. Only lights facing a point are traced for it.
+     */
+    class ShadowTile {
+    public:
+        /**
+         * @brief Forget the points of the previous tile
+         * @param pixelCount The number of pixels of the tile
+         * @param lightCount The number of lights of the scene
+         */
+        void reset(size_t pixelCount, size_t lightCount);
+
+        /**
+         * @brief Record the surface a pixel shades first
+         * @param pixel The index of the pixel in the tile
+         * @param point The shaded point
+         * @param normal The normal of the surface at the point
+         * @param shapeIndex The shape of the point
+         */
+        void setPoint(size_t pixel, const Vector3D& point, const Vector3D& normal, size_t shapeIndex);
+
+        /**
+         * @brief Trace the shadow rays of every recorded point, one packet per light
+         * @param tracer The packet tracer of the scene
+         * @param lights The lights of the scene
+         * @param lightBlock The same lights laid out for vectorized lighting
+         */
+        void trace(const ShadowPacketTracer& tracer, const math::Vector<Light>& lights, const LightBlock& lightBlock);
+
+        /**
+         * @brief Get the shadows of one pixel
+         * @param pixel The index of the pixel in the tile
+         * @return The shadows, valid until the next reset
+         */
+        const PixelShadows& getPixel(size_t pixel) const { return pixels[pixel]; }
+
+    private:
+        size_t lightCount = 0;
+        math::Vector<PixelShadows> pixels;
+        math::Vector<Vector3D> normals;
+        math::Vector<double> transmissions;     ///< lightCount transmissions per pixel
+        math::Vector<Vector3D> packetPoints;    ///< The packet being traced, sized for a whole tile
+        math::Vector<size_t> packetShapes;
+        math::Vector<size_t> packetPixels;
+        math::Vector<double> packetTransmissions;
+    };
+
+} // namespace rendering
+
+#endif // SHADOW_PACKET_H
@@ -0,0 +1,217 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef SLOT_MAP_HPP
+#define SLOT_MAP_HPP
+
+#include "../Math/Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace rendering {
+
+    /**
+     * @struct SlotHandle
+     * @brief Stable reference to a value of a SlotMap.
+     *
+     * The generation tells apart the successive values stored in the same slot, so a handle to a
+     * removed value never reaches the value that reused its slot.
+     */
+    struct SlotHandle {
+        static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+        uint32_t slot = INVALID_SLOT;
+        uint32_t generation = 0;
+
+        bool isValid() const { return slot != INVALID_SLOT; }
+        bool operator==(const SlotHandle& other) const { return slot == other.slot && generation == other.generation; }
+        bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @class SlotMap
+     * @brief Generational slot map, values addressed by stable handles and stored densely.
+     *
+     * Values live in one packed math::Vector that can be handed to the renderers as is. A slot
+     * table maps each handle to the position of its value, and each position back to its slot.
+     * Removing a value moves the last one into its position, so insertion and removal are O(1)
+     * (amortized for insertion) but positions are not stable: only handles are. Freed slots are
+     * reused last in, first out, their generation bumped on every removal.
+     *
+     * @tparam T The value type, must be default constructible and copy assignable
+     */
+    template<typename T>
+    class SlotMap {
+    public:
+        static constexpr size_t NONE = SIZE_MAX;
+
+        /**
+         * @brief Add a value
+         * @param value The value
+         * @return The handle of the value
+         */
+        SlotHandle insert(const T& value);
+
+        /**
+         * @brief Remove a value, the last value takes its position
+         * @param handle The handle of the value
+         * @return The position the value had, now holding the former last value unless it was the last
+         * @throws std::out_of_range if the handle does not refer to a value of the map
+         */
+        size_t erase(SlotHandle handle);
+
+        /**
+         * @brief Remove the value at a position, the last value takes its place
+         * @param index The position of the value
+         * @throws std::out_of_range if index is out of bounds
+         */
+        void eraseAt(size_t index) { erase(handleAt(index)); }
+
+        /**
+         * @brief Check if a handle refers to a value of the map
+         * @param handle The handle
+         * @return False for removed values and default handles
+         */
+        bool contains(SlotHandle handle) const { return find(handle) != NONE; }
+
+        /**
+         * @brief Get the position of a value in the packed storage
+         * @param handle The handle of the value
+         * @return The position, valid until the next removal
+         * @throws std::out_of_range if the handle does not refer to a value of the map
+         */
+        size_t indexOf(SlotHandle handle) const;
+
+        /**
+         * @brief Get the handle of the value at a position
+         * @param index The position
+         * @return The handle
+         * @throws std::out_of_range if index is out of bounds
+         */
+        SlotHandle handleAt(size_t index) const;
+
+        T& get(SlotHandle handle) { return values[indexOf(handle)]; }
+        const T& get(SlotHandle handle) const { return values[indexOf(handle)]; }
+
+        T& operator[](size_t index) { return values[index]; }
+        const T& operator[](size_t index) const { return values[index]; }
+
+        /**
+         * @brief Get the packed values, in no particular order
+         * @return The values, one per live handle
+         */
+        const math::Vector<T>& getValues() const { return values; }
+
+        size_t size() const { return values.size(); }
+        bool empty() const { return values.empty(); }
+
+        /**
+         * @brief Remove every value, outstanding handles become invalid
+         */
+        void clear();
+
+    private:
+        /// Position of the value of a live slot, next free slot of a free one
+        struct Slot {
+            uint32_t index = 0;
+            uint32_t generation = 0;
+        };
+
+        math::Vector<T> values;             ///< Packed values
+        math::Vector<uint32_t> valueSlots;  ///< Slot of each value
+        math::Vector<Slot> slots;
+        uint32_t freeList = SlotHandle::INVALID_SLOT;   ///< Free slots, chained through Slot::index
+
+        size_t find(SlotHandle handle) const;
+    };
+
+    /* TEMPLATE IMPLEMENTATION */
+
+    template<typename T>
+    size_t SlotMap<T>::find(SlotHandle handle) const {
+        if (handle.slot >= slots.size()) return NONE;
+        const Slot& slot = slots[handle.slot];
+        if (slot.generation != handle.generation || slot.index >= values.size() || valueSlots[slot.index] != handle.slot) {
+            return NONE;
+        }
+        return slot.index;
+    }
+
+    template<typename T>
+    SlotHandle SlotMap<T>::insert(const T& value) {
+        uint32_t slot;
+        if (freeList != SlotHandle::INVALID_SLOT) {
+            slot = freeList;
+            freeList = slots[slot].index;
+        } else {
+            if (slots.size() >= SlotHandle::INVALID_SLOT) {
+                throw std::length_error("SlotMap is full");
+            }
+            slot = static_cast<uint32_t>(slots.size());
+            slots.append(Slot{});
+        }
+        slots[slot].index = static_cast<uint32_t>(values.size());
+        values.append(value);
+        valueSlots.append(slot);
+        return SlotHandle{slot, slots[slot].generation};
+    }
+
+    template<typename T>
+    size_t SlotMap<T>::erase(SlotHandle handle) {
+        size_t index = find(handle);
+        if (index == NONE) {
+            throw std::out_of_range("Invalid slot handle");
+        }
+        size_t last = values.size() - 1;
+        if (index != last) {
+            values[index] = std::move(values[last]);
+            valueSlots[index] = valueSlots[last];
+            slots[valueSlots[index]].index = static_cast<uint32_t>(index);
+        }
+        values.removeLast();
+        valueSlots.removeLast();
+
+        Slot& slot = slots[handle.slot];
+        ++slot.generation;
+        slot.index = freeList;
+        freeList = handle.slot;
+        return index;
+    }
+
+    template<typename T>
+    size_t SlotMap<T>::indexOf(SlotHandle handle) const {
+        size_t index = find(handle);
+        if (index == NONE) {
+            throw std::out_of_range("Invalid slot handle");
+        }
+        return index;
+    }
+
+    template<typename T>
+    SlotHandle SlotMap<T>::handleAt(size_t index) const {
+        if (index >= values.size()) {
+            throw std::out_of_range("Slot map index out of bounds");
+        }
+        uint32_t slot = valueSlots[index];
+        return SlotHandle{slot, slots[slot].generation};
+    }
+
+    template<typename T>
+    void SlotMap<T>::clear() {
+        // Keep the slots so that the generations still reject the old handles
+        for (size_t i = 0; i < valueSlots.size(); ++i) {
+            Slot& slot = slots[valueSlots[i]];
+            ++slot.generation;
+            slot.index = freeList;
+            freeList = valueSlots[i];
+        }
+        values.clear();
+        valueSlots.clear();
+    }
+
+} // namespace rendering
+
+#endif // SLOT_MAP_HPP
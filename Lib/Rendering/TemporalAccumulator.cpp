@@ -0,0 +1,182 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "TemporalAccumulator.h"
+#include "CameraHelper.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+namespace rendering {
+
+    namespace {
+
+        /// One shaded sample, with the surface it landed on
+        struct TemporalSample {
+            RGBA_Color color;
+            double t = std::numeric_limits<double>::infinity();
+            size_t shapeIndex = 0;
+            Vector3D point;
+            Vector3D normal;
+        };
+
+        /**
+         * Shade one primary ray with shadeLightSample and record the surface it landed on
+         * @return True if the ray hit a shape
+         */
+        bool traceSample(const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, bool advanced, const LightingCache& lighting, TemporalSample& sample) {
+            std::optional<Hit> closest = shadeLightSample(ray, shapes, lights, advanced, lighting, sample.color);
+            if (!closest) {
+                return false;
+            }
+            sample.t = closest->t;
+            sample.shapeIndex = closest->shapeIndex;
+            sample.point = ray.getPointAt(closest->t);
+            sample.normal = std::visit([&](auto&& shape) { return shape.getNormalAt(sample.point); }, shapes[closest->shapeIndex]);
+            return true;
+        }
+
+    } // namespace
+
+    TemporalAccumulator::TemporalAccumulator(size_t freshSamples, size_t maxHistorySamples)
+        : freshSamples(freshSamples), maxHistorySamples(maxHistorySamples) {
+        if (freshSamples == 0 || maxHistorySamples == 0) {
+            throw std::invalid_argument("Sample counts must be positive");
+        }
+    }
+
+    void TemporalAccumulator::reset() {
+        previousCamera.reset();
+        history = PixelBuffer<PixelHistory>();
+        frameIndex = 0;
+        lastStats = TemporalStats();
+    }
+
+    bool TemporalAccumulator::reprojectHistory(const Vector3D& point, const Vector3D& normal, size_t shapeIndex, size_t imageWidth, size_t imageHeight, PixelHistory& found) const {
+        double pixelX, pixelY;
+        if (!previousCamera || !previousCamera->projectToPixel(point, imageWidth, imageHeight, pixelX, pixelY)) {
+            return false;
+        }
+
+        // Nearest pixel, pixel x covers x - 0.5 to x + 0.5
+        size_t x = std::min(imageWidth - 1, static_cast<size_t>(pixelX + 0.5));
+        size_t y = std::min(imageHeight - 1, static_cast<size_t>(pixelY + 0.5));
+        const PixelHistory& candidate = history(x, y);
+
+        // Disocclusion: another shape, another depth or another orientation was seen there
+        if (candidate.sampleCount == 0 || candidate.shapeIndex != shapeIndex) {
+            return false;
+        }
+        double expectedDepth = (point - previousCamera->getFOVOrigin()).length();
+        if (std::abs(candidate.depth - expectedDepth) > depthTolerance * expectedDepth) {
+            return false;
+        }
+        if (candidate.normal.dot(normal) < normalTolerance) {
+            return false;
+        }
+
+        found = candidate;
+        return true;
+    }
+
+    Image TemporalAccumulator::renderFrame(const Camera& camera, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, size_t imageWidth, size_t imageHeight, bool advanced) {
+        if (imageWidth == 0 || imageHeight == 0) {
+            throw std::invalid_argument("Image dimensions must be positive");
+        }
+        if (history.getWidth() != imageWidth || history.getHeight() != imageHeight) {
+            reset();
+        }
+
+        Image image = makeFramebuffer(imageWidth, imageHeight, camera.getFramebufferLayout());
+        PixelBuffer<PixelHistory> current(imageWidth, imageHeight);
+        size_t reusedPixels = 0, freshPixels = 0, samplesTraced = 0;
+
+        if (shapes.size() != 0 && lights.size() != 0) {
+            // Every pixel moves to the next sample of the pattern, so a static pixel sees the whole pattern
+            const size_t jitter = frameIndex % freshSamples;
+            const double freshWeight = 1.0 / static_cast<double>(freshSamples);
+            LightingStorage lightingStorage;
+            const LightingCache lighting = camera.prepareLighting(shapes, lights, lightingStorage, camera.getPixelSpread(imageWidth, imageHeight));
+
+            forEachPixel(imageWidth, imageHeight, camera.getRenderSchedule(), [&](size_t x, size_t y) {
+                double offsetX, offsetY;
+                multisampleOffset(jitter, freshSamples, offsetX, offsetY);
+                TemporalSample first;
+                bool firstHit = traceSample(camera.generateRayForSubpixel(x, y, offsetX, offsetY, imageWidth, imageHeight, true), shapes, lights, advanced, lighting, first);
+
+                PixelHistory& pixel = current(x, y);
+                PixelHistory previous;
+                if (firstHit && reprojectHistory(first.point, first.normal, first.shapeIndex, imageWidth, imageHeight, previous)) {
+                    // Refine the history with one sample, as a moving average once it is full
+                    size_t historySamples = std::min(previous.sampleCount, maxHistorySamples);
+                    double weight = 1.0 / static_cast<double>(historySamples + 1);
+                    pixel.color = RGBA_Color(previous.color.r() + (first.color.r() - previous.color.r()) * weight,
+                                             previous.color.g() + (first.color.g() - previous.color.g()) * weight,
+                                             previous.color.b() + (first.color.b() - previous.color.b()) * weight,
+                                             previous.color.a() + (first.color.a() - previous.color.a()) * weight);
+                    pixel.sampleCount = historySamples + 1;
+
+                    #pragma omp atomic
+                    ++reusedPixels;
+                    #pragma omp atomic
+                    ++samplesTraced;
+                } else {
+                    // No usable history: the whole pattern, uncovered samples keep the background
+                    const RGBA_Color background = image.getPixel(x, y);
+                    size_t hitCount = firstHit ? 1 : 0;
+                    RGBA_Color firstColor = firstHit ? first.color : background;
+                    double accR = firstColor.r(), accG = firstColor.g(), accB = firstColor.b(), accA = firstColor.a();
+
+                    for (size_t sample = 0; sample < freshSamples; ++sample) {
+                        if (sample == jitter) {
+                            continue;
+                        }
+                        multisampleOffset(sample, freshSamples, offsetX, offsetY);
+                        TemporalSample extra;
+                        RGBA_Color color = background;
+                        if (traceSample(camera.generateRayForSubpixel(x, y, offsetX, offsetY, imageWidth, imageHeight, true), shapes, lights, advanced, lighting, extra)) {
+                            color = extra.color;
+                            ++hitCount;
+                        }
+                        accR += color.r();
+                        accG += color.g();
+                        accB += color.b();
+                        accA += color.a();
+                    }
+                    if (hitCount == 0) {
+                        return;
+                    }
+
+                    pixel.color = RGBA_Color(accR * freshWeight, accG * freshWeight, accB * freshWeight, accA * freshWeight);
+                    // Only pixels whose first sample saw a surface can be reprojected later
+                    pixel.sampleCount = firstHit ? freshSamples : 0;
+
+                    #pragma omp atomic
+                    ++freshPixels;
+                    #pragma omp atomic
+                    samplesTraced += hitCount;
+                }
+
+                if (firstHit) {
+                    pixel.depth = first.t;
+                    pixel.normal = first.normal;
+                    pixel.shapeIndex = first.shapeIndex;
+                }
+                image.setPixel(x, y, pixel.color.clamp());
+            });
+        }
+
+        history = std::move(current);
+        previousCamera = camera;
+        lastStats.reusedPixels = reusedPixels;
+        lastStats.freshPixels = freshPixels;
+        lastStats.samplesTraced = samplesTraced;
+        ++frameIndex;
+        return image;
+    }
+
+} // namespace rendering
@@ -0,0 +1,112 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef TEMPORAL_ACCUMULATOR_H
+#define TEMPORAL_ACCUMULATOR_H
+
+#include "Camera.h"
+#include "Image.h"
+#include "Light.h"
+#include "PixelBuffer.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+
+namespace rendering {
+
+    /**
+     * @struct TemporalStats
+     * @brief What the last frame of a TemporalAccumulator reused and traced
+     */
+    struct TemporalStats {
+        size_t reusedPixels = 0;    ///< Pixels whose history was reprojected and refined with one sample
+        size_t freshPixels = 0;     ///< Pixels hit by the camera without valid history, traced at full rate
+        size_t samplesTraced = 0;   ///< Shaded samples of the frame
+    };
+
+    /**
+     * @class TemporalAccumulator
+     * @brief Accumulates the lit renders of a camera animation over time.
+     *
+     * Consecutive frames of a smooth camera path see nearly the same surfaces. Each frame, the
+     * surface seen by a pixel is reprojected into the previous camera, and its accumulated color is
+     * reused when the previous frame saw the same shape there, at the expected depth and with the
+     * same orientation. Reused pixels trace a single jittered sample that refines the history;
+     * pixels with no valid history (first frame, disocclusions, edges) trace every sample of the
+     * anti-aliasing pattern. History is capped at a number of samples so that it keeps following
+     * changes of lighting.
+     */
+    class TemporalAccumulator {
+    public:
+        /**
+         * @brief Constructor
+         * @param freshSamples The samples per pixel traced where history is invalid
+         * @param maxHistorySamples The samples after which the history is blended as a moving average
+         * @throws std::invalid_argument if freshSamples or maxHistorySamples is zero
+         */
+        explicit TemporalAccumulator(size_t freshSamples = 8, size_t maxHistorySamples = 32);
+
+        /**
+         * @brief Render the next frame of the animation
+         * @param camera The camera of this frame
+         * @param shapes The shapes of the scene
+         * @param lights The lights of the scene
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param advanced Whether to shade with processRayHitAdvanced instead of processRayHitOld
+         * @return Image The accumulated frame, in the framebuffer layout of the camera
+         */
+        Image renderFrame(const Camera& camera, const math::Vector<Camera::ShapeVariant>& shapes, const math::Vector<Light>& lights, size_t imageWidth, size_t imageHeight, bool advanced = false);
+
+        /**
+         * @brief Forget the history, the next frame is traced at full rate
+         */
+        void reset();
+
+        /**
+         * @brief Set the largest relative difference between reprojected and stored depths
+         * @param tolerance The tolerance, 0.05 by default
+         */
+        void setDepthTolerance(double tolerance) { depthTolerance = tolerance; }
+        double getDepthTolerance() const { return depthTolerance; }
+
+        /**
+         * @brief Set the smallest cosine between the current and stored normals
+         * @param minCosine The cosine, 0.9 by default
+         */
+        void setNormalTolerance(double minCosine) { normalTolerance = minCosine; }
+        double getNormalTolerance() const { return normalTolerance; }
+
+        size_t getFreshSamples() const { return freshSamples; }
+        size_t getMaxHistorySamples() const { return maxHistorySamples; }
+        size_t getFrameIndex() const { return frameIndex; }
+        const TemporalStats& getLastStats() const { return lastStats; }
+
+    private:
+        /// What a pixel saw and accumulated in a frame
+        struct PixelHistory {
+            RGBA_Color color;                                         ///< Mean of the shaded samples
+            double depth = std::numeric_limits<double>::infinity();   ///< Distance from the FOV origin to the surface
+            Vector3D normal;
+            size_t shapeIndex = 0;
+            size_t sampleCount = 0;                                   ///< 0 when the pixel has no history
+        };
+
+        size_t freshSamples;
+        size_t maxHistorySamples;
+        double depthTolerance = 0.05;
+        double normalTolerance = 0.9;
+
+        size_t frameIndex = 0;
+        TemporalStats lastStats;
+        std::optional<Camera> previousCamera;
+        PixelBuffer<PixelHistory> history;
+
+        bool reprojectHistory(const Vector3D& point, const Vector3D& normal, size_t shapeIndex, size_t imageWidth, size_t imageHeight, PixelHistory& found) const;
+    };
+
+} // namespace rendering
+
+#endif // TEMPORAL_ACCUMULATOR_H
@@ -0,0 +1,460 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#include "Texture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <variant>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TEXTURE_PREAD 1
+#endif
+
+namespace rendering {
+
+    namespace {
+
+        constexpr char TEXTURE_FILE_MAGIC[8] = {'S', 'I', '3', 'D', 'T', 'E', 'X', 'R'};
+        constexpr uint32_t TEXTURE_FILE_VERSION = 1;
+
+        // Tiles of a texture are keyed by its id in the high bits, the tile in the low ones
+        constexpr int TILE_KEY_BITS = 40;
+
+        // Grazing rays stretch the footprint at most this much
+        constexpr double MIN_FOOTPRINT_COSINE = 0.05;
+
+        struct TextureFileHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t tileSize;
+            uint64_t width;
+            uint64_t height;
+            uint64_t levelCount;
+            uint64_t tileCount;
+        };
+
+        uint64_t tileKey(uint64_t textureId, size_t tile) {
+            return (textureId << TILE_KEY_BITS) | static_cast<uint64_t>(tile);
+        }
+
+        size_t wrap(long long value, size_t size) {
+            long long n = static_cast<long long>(size);
+            long long r = value % n;
+            return static_cast<size_t>(r < 0 ? r + n : r);
+        }
+
+    } // namespace
+
+    // ========== TextureCache ==========
+
+    TextureCache::TextureCache(size_t memoryBudget) : memoryBudget(memoryBudget) {
+        if (memoryBudget == 0) {
+            throw std::invalid_argument("Texture cache budget must be positive");
+        }
+    }
+
+    std::shared_ptr<const math::Vector<uint8_t>> TextureCache::acquireTile(const Texture& texture, size_t tile) {
+        const uint64_t key = tileKey(texture.getId(), tile);
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            auto found = entries.find(key);
+            if (found != entries.end()) {
+                useOrder.splice(useOrder.begin(), useOrder, found->second.use);
+                return found->second.texels;
+            }
+        }
+
+        // Read outside the lock so other threads keep sampling cached tiles meanwhile
+        auto texels = std::make_shared<const math::Vector<uint8_t>>(texture.readTile(tile));
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto found = entries.find(key);
+        if (found != entries.end()) {
+            // Another thread read it first
+            useOrder.splice(useOrder.begin(), useOrder, found->second.use);
+            return found->second.texels;
+        }
+        evictFor(texels->size());
+        useOrder.push_front(key);
+        entries.emplace(key, Entry{texels, useOrder.begin()});
+        residentBytes += texels->size();
+        ++loadCount;
+        return texels;
+    }
+
+    void TextureCache::forget(uint64_t textureId) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        for (auto it = entries.begin(); it != entries.end();) {
+            if ((it->first >> TILE_KEY_BITS) == textureId) {
+                residentBytes -= it->second.texels->size();
+                useOrder.erase(it->second.use);
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void TextureCache::evictFor(size_t bytes) {
+        while (!useOrder.empty() && residentBytes + bytes > memoryBudget) {
+            auto victim = entries.find(useOrder.back());
+            residentBytes -= victim->second.texels->size();
+            entries.erase(victim);
+            useOrder.pop_back();
+            ++evictionCount;
+        }
+    }
+
+    size_t TextureCache::getResidentBytes() const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return residentBytes;
+    }
+
+    size_t TextureCache::getTileLoadCount() const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return loadCount;
+    }
+
+    size_t TextureCache::getEvictionCount() const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return evictionCount;
+    }
+
+    // ========== Texture ==========
+
+    std::atomic<uint64_t> Texture::nextId{1};
+
+    math::Vector<Texture::Level> Texture::layoutLevels(size_t width, size_t height, size_t tileSize, size_t& tileCount) {
+        size_t levelCount = 1;
+        for (size_t w = width, h = height; w > 1 || h > 1; w = std::max<size_t>(1, w / 2), h = std::max<size_t>(1, h / 2)) {
+            ++levelCount;
+        }
+
+        math::Vector<Level> levels(levelCount);
+        tileCount = 0;
+        for (size_t l = 0; l < levelCount; ++l) {
+            Level& level = levels[l];
+            level.width = width;
+            level.height = height;
+            level.tilesX = (width + tileSize - 1) / tileSize;
+            level.tilesY = (height + tileSize - 1) / tileSize;
+            level.firstTile = tileCount;
+            tileCount += level.tilesX * level.tilesY;
+            width = std::max<size_t>(1, width / 2);
+            height = std::max<size_t>(1, height / 2);
+        }
+        return levels;
+    }
+
+    void Texture::write(const Image& image, const std::string& filePath, size_t tileSize) {
+        if (image.getWidth() == 0 || image.getHeight() == 0) {
+            throw std::invalid_argument("Cannot make a texture of an empty image");
+        }
+        if (tileSize == 0) {
+            throw std::invalid_argument("Texture tile size must be positive");
+        }
+
+        size_t tileCount = 0;
+        math::Vector<Level> levels = layoutLevels(image.getWidth(), image.getHeight(), tileSize, tileCount);
+
+        // The full resolution level, RGBA row by row
+        math::Vector<float> current(4 * image.getWidth() * image.getHeight());
+        for (size_t y = 0; y < image.getHeight(); ++y) {
+            for (size_t x = 0; x < image.getWidth(); ++x) {
+                const RGBA_Color pixel = image.getPixel(x, y);
+                float* texel = current.begin() + 4 * (y * image.getWidth() + x);
+                texel[0] = static_cast<float>(pixel.r());
+                texel[1] = static_cast<float>(pixel.g());
+                texel[2] = static_cast<float>(pixel.b());
+                texel[3] = static_cast<float>(pixel.a());
+            }
+        }
+
+        FILE* out = fopen(filePath.c_str(), "wb");
+        if (!out) {
+            throw std::runtime_error("Failed to create texture file: " + filePath);
+        }
+
+        TextureFileHeader header{};
+        std::memcpy(header.magic, TEXTURE_FILE_MAGIC, sizeof(TEXTURE_FILE_MAGIC));
+        header.version = TEXTURE_FILE_VERSION;
+        header.tileSize = static_cast<uint32_t>(tileSize);
+        header.width = image.getWidth();
+        header.height = image.getHeight();
+        header.levelCount = levels.size();
+        header.tileCount = tileCount;
+        fwrite(&header, sizeof(header), 1, out);
+
+        math::Vector<uint8_t> tile(tileSize * tileSize * 4);
+        for (size_t l = 0; l < levels.size(); ++l) {
+            const Level& level = levels[l];
+
+            // Tiles row by row, texels past the border repeat the last row and column
+            for (size_t tileY = 0; tileY < level.tilesY; ++tileY) {
+                for (size_t tileX = 0; tileX < level.tilesX; ++tileX) {
+                    for (size_t j = 0; j < tileSize; ++j) {
+                        size_t y = std::min(level.height - 1, tileY * tileSize + j);
+                        for (size_t i = 0; i < tileSize; ++i) {
+                            size_t x = std::min(level.width - 1, tileX * tileSize + i);
+                            const float* texel = current.begin() + 4 * (y * level.width + x);
+                            for (size_t c = 0; c < 4; ++c) {
+                                float value = std::clamp(texel[c], 0.0f, 1.0f);
+                                tile[4 * (j * tileSize + i) + c] = static_cast<uint8_t>(std::lround(value * 255.0f));
+                            }
+                        }
+                    }
+                    fwrite(tile.begin(), 1, tile.size(), out);
+                }
+            }
+
+            // Box filter the next level from this one
+            if (l + 1 < levels.size()) {
+                const Level& next = levels[l + 1];
+                math::Vector<float> reduced(4 * next.width * next.height);
+                for (size_t y = 0; y < next.height; ++y) {
+                    size_t y0 = std::min(level.height - 1, 2 * y), y1 = std::min(level.height - 1, 2 * y + 1);
+                    for (size_t x = 0; x < next.width; ++x) {
+                        size_t x0 = std::min(level.width - 1, 2 * x), x1 = std::min(level.width - 1, 2 * x + 1);
+                        for (size_t c = 0; c < 4; ++c) {
+                            reduced[4 * (y * next.width + x) + c] = 0.25f * (current[4 * (y0 * level.width + x0) + c] + current[4 * (y0 * level.width + x1) + c]
+                                + current[4 * (y1 * level.width + x0) + c] + current[4 * (y1 * level.width + x1) + c]);
+                        }
+                    }
+                }
+                current = std::move(reduced);
+            }
+        }
+
+        bool failed = ferror(out) != 0;
+        fclose(out);
+        if (failed) {
+            throw std::runtime_error("Failed to write texture file: " + filePath);
+        }
+    }
+
+    std::shared_ptr<const Texture> Texture::fromImage(const Image& image, const std::string& filePath, std::shared_ptr<TextureCache> cache) {
+        write(image, filePath);
+        return std::make_shared<const Texture>(filePath, std::move(cache));
+    }
+
+    Texture::Texture(const std::string& filePath, std::shared_ptr<TextureCache> cache)
+        : id(nextId++), filePath(filePath), cache(std::move(cache)) {
+        if (!this->cache) {
+            throw std::invalid_argument("Texture needs a cache");
+        }
+
+        TextureFileHeader header;
+        uint64_t fileSize = 0;
+        bool readHeader = false;
+#ifdef TEXTURE_PREAD
+        fileDescriptor = open(filePath.c_str(), O_RDONLY);
+        if (fileDescriptor < 0) {
+            throw std::runtime_error("Failed to open texture file: " + filePath);
+        }
+        struct stat info;
+        if (fstat(fileDescriptor, &info) == 0) {
+            fileSize = static_cast<uint64_t>(info.st_size);
+        }
+        readHeader = pread(fileDescriptor, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+#else
+        file = fopen(filePath.c_str(), "rb");
+        if (!file) {
+            throw std::runtime_error("Failed to open texture file: " + filePath);
+        }
+        if (fseek(file, 0, SEEK_END) == 0) {
+            fileSize = static_cast<uint64_t>(ftell(file));
+        }
+        readHeader = fseek(file, 0, SEEK_SET) == 0 && fread(&header, sizeof(header), 1, file) == 1;
+#endif
+
+        bool valid = readHeader && std::memcmp(header.magic, TEXTURE_FILE_MAGIC, sizeof(TEXTURE_FILE_MAGIC)) == 0
+            && header.version == TEXTURE_FILE_VERSION && header.tileSize > 0 && header.width > 0 && header.height > 0;
+        if (valid) {
+            tileSize = header.tileSize;
+            levels = layoutLevels(header.width, header.height, tileSize, tileCount);
+            dataOffset = sizeof(header);
+            valid = header.levelCount == levels.size() && header.tileCount == tileCount
+                && fileSize >= dataOffset + static_cast<uint64_t>(tileCount) * tileBytes();
+        }
+        if (!valid) {
+#ifdef TEXTURE_PREAD
+            close(fileDescriptor);
+#else
+            fclose(file);
+#endif
+            throw std::runtime_error("Not a texture file: " + filePath);
+        }
+    }
+
+    Texture::~Texture() {
+        cache->forget(id);
+#ifdef TEXTURE_PREAD
+        close(fileDescriptor);
+#else
+        fclose(file);
+#endif
+    }
+
+    math::Vector<uint8_t> Texture::readTile(size_t tile) const {
+        math::Vector<uint8_t> texels(tileBytes());
+        const uint64_t offset = dataOffset + static_cast<uint64_t>(tile) * tileBytes();
+#ifdef TEXTURE_PREAD
+        bool read = pread(fileDescriptor, texels.begin(), texels.size(), static_cast<off_t>(offset)) == static_cast<ssize_t>(texels.size());
+#else
+        std::lock_guard<std::mutex> lock(fileMutex);
+        bool read = fseek(file, static_cast<long>(offset), SEEK_SET) == 0 && fread(texels.begin(), 1, texels.size(), file) == texels.size();
+#endif
+        if (!read) {
+            throw std::runtime_error("Failed to read texture tile from: " + filePath);
+        }
+        return texels;
+    }
+
+    const uint8_t* Texture::fetch(const Level& level, long long x, long long y, TileHandle& handle) const {
+        const size_t wrappedX = wrap(x, level.width), wrappedY = wrap(y, level.height);
+        const size_t tile = level.firstTile + (wrappedY / tileSize) * level.tilesX + wrappedX / tileSize;
+        if (tile != handle.tile) {
+            handle.texels = cache->acquireTile(*this, tile);
+            handle.tile = tile;
+        }
+        return handle.texels->begin() + 4 * ((wrappedY % tileSize) * tileSize + wrappedX % tileSize);
+    }
+
+    RGBA_Color Texture::texel(size_t level, long long x, long long y) const {
+        if (level >= levels.size()) {
+            throw std::out_of_range("Texture level out of range");
+        }
+        TileHandle handle;
+        const uint8_t* value = fetch(levels[level], x, y, handle);
+        return RGBA_Color(value[0] / 255.0, value[1] / 255.0, value[2] / 255.0, value[3] / 255.0);
+    }
+
+    void Texture::bilinear(double u, double v, size_t level, TileHandle& handle, double* rgba) const {
+        const Level& l = levels[std::min(level, levels.size() - 1)];
+
+        // Texel centers lie at half integers
+        const double x = (u - std::floor(u)) * static_cast<double>(l.width) - 0.5;
+        const double y = (v - std::floor(v)) * static_cast<double>(l.height) - 0.5;
+        const double baseX = std::floor(x), baseY = std::floor(y);
+        const double fx = x - baseX, fy = y - baseY;
+        const long long x0 = static_cast<long long>(baseX), y0 = static_cast<long long>(baseY);
+
+        const uint8_t* corners[4] = {fetch(l, x0, y0, handle), fetch(l, x0 + 1, y0, handle), fetch(l, x0, y0 + 1, handle), fetch(l, x0 + 1, y0 + 1, handle)};
+        const double weights[4] = {(1.0 - fx) * (1.0 - fy), fx * (1.0 - fy), (1.0 - fx) * fy, fx * fy};
+        for (size_t c = 0; c < 4; ++c) {
+            double sum = 0.0;
+            for (size_t k = 0; k < 4; ++k) {
+                sum += weights[k] * corners[k][c];
+            }
+            rgba[c] = sum / 255.0;
+        }
+    }
+
+    RGBA_Color Texture::sampleBilinear(double u, double v, size_t level) const {
+        TileHandle handle;
+        double rgba[4];
+        bilinear(u, v, level, handle, rgba);
+        return RGBA_Color(rgba[0], rgba[1], rgba[2], rgba[3]);
+    }
+
+    RGBA_Color Texture::sample(double u, double v, double lod) const {
+        const double last = static_cast<double>(levels.size() - 1);
+        lod = std::clamp(lod, 0.0, last);
+        const size_t level = static_cast<size_t>(lod);
+        const double blend = lod - static_cast<double>(level);
+
+        TileHandle handle;
+        double rgba[4];
+        bilinear(u, v, level, handle, rgba);
+        if (blend > 0.0) {
+            double coarser[4];
+            bilinear(u, v, level + 1, handle, coarser);
+            for (size_t c = 0; c < 4; ++c) {
+                rgba[c] += blend * (coarser[c] - rgba[c]);
+            }
+        }
+        return RGBA_Color(rgba[0], rgba[1], rgba[2], rgba[3]);
+    }
+
+    double Texture::levelOfDetail(double footprint, double uLength, double vLength) const {
+        if (!(footprint > 0.0) || !(uLength > 0.0) || !(vLength > 0.0)) {
+            return 0.0;
+        }
+        // Texels covered by the footprint along the denser axis
+        double texels = footprint * std::max(static_cast<double>(getWidth()) / uLength, static_cast<double>(getHeight()) / vLength);
+        return std::max(0.0, std::log2(texels));
+    }
+
+    // ========== Surface mapping ==========
+
+    bool surfaceCoordinates(const Camera::ShapeVariant& shape, const Vector3D& point, SurfaceCoordinates& coordinates) {
+        return std::visit([&](auto&& typedShape) {
+            using T = std::decay_t<decltype(typedShape)>;
+            const auto* geom = typedShape.getGeometry();
+            if (!geom) {
+                return false;
+            }
+
+            if constexpr (std::is_same_v<T, Shape<Sphere>>) {
+                const double radius = geom->getRadius();
+                const Vector3D local = (point - geom->getCenter()) * (1.0 / radius);
+                coordinates.u = 0.5 + std::atan2(local.z(), local.x()) / (2.0 * M_PI);
+                coordinates.v = std::acos(std::clamp(local.y(), -1.0, 1.0)) / M_PI;
+                coordinates.uLength = 2.0 * M_PI * radius;
+                coordinates.vLength = M_PI * radius;
+                return true;
+            } else if constexpr (std::is_same_v<T, Shape<Rectangle>>) {
+                const Vector3D local = point - geom->getOrigin();
+                coordinates.uLength = geom->getLength();
+                coordinates.vLength = geom->getWidth();
+                coordinates.u = local.dot(geom->getLengthVec()) / coordinates.uLength;
+                coordinates.v = local.dot(geom->getWidthVec()) / coordinates.vLength;
+                return true;
+            } else if constexpr (std::is_same_v<T, Shape<Circle>>) {
+                Vector3D axisU, axisV;
+                geom->getNormal().tangentBasis(axisU, axisV);
+                const Vector3D local = point - geom->getCenter();
+                coordinates.uLength = coordinates.vLength = 2.0 * geom->getRadius();
+                coordinates.u = 0.5 + local.dot(axisU) / coordinates.uLength;
+                coordinates.v = 0.5 + local.dot(axisV) / coordinates.vLength;
+                return true;
+            } else if constexpr (std::is_same_v<T, Shape<Plane>>) {
+                Vector3D axisU, axisV;
+                geom->getNormal().tangentBasis(axisU, axisV);
+                const Vector3D local = point - geom->getOrigin();
+                coordinates.u = local.dot(axisU);
+                coordinates.v = local.dot(axisV);
+                coordinates.uLength = coordinates.vLength = 1.0;
+                return true;
+            } else {
+                return false;
+            }
+        }, shape);
+    }
+
+    RGBA_Color texturedAlbedo(const Camera::ShapeVariant& shape, const Material& material, const Vector3D& point, const Vector3D& normal, const Vector3D& direction, double footprint) {
+        RGBA_Color albedo = material.hasAlbedo() ? material.getAlbedo() : RGBA_Color(1, 1, 1, 1);
+        const Texture* texture = material.getAlbedoTexture().get();
+        SurfaceCoordinates coordinates;
+        if (!texture || !surfaceCoordinates(shape, point, coordinates)) {
+            return albedo;
+        }
+
+        // Ray cone footprint, stretched across the surface at grazing angles
+        const double lengths = normal.length() * direction.length();
+        const double cosine = lengths > 0.0 ? std::fabs(normal.dot(direction)) / lengths : 1.0;
+        const double scale = material.getTextureScale();
+        const double lod = texture->levelOfDetail(footprint / std::max(cosine, MIN_FOOTPRINT_COSINE), coordinates.uLength / scale, coordinates.vLength / scale);
+
+        const RGBA_Color texel = texture->sample(coordinates.u * scale, coordinates.v * scale, lod);
+        return RGBA_Color(albedo.r() * texel.r(), albedo.g() * texel.g(), albedo.b() * texel.b(), albedo.a() * texel.a());
+    }
+
+} // namespace rendering
@@ -0,0 +1,256 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include "Camera.h"
+#include "Image.h"
+#include "Material.h"
+#include "RGBA_Color.h"
+#include "../Geometry/Vector3D.h"
+#include "../Math/Vector.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace rendering {
+
+    class Texture;
+
+    /**
+     * @class TextureCache
+     * @brief Tiles of textures paged in from disk, shared by any number of textures and threads.
+     *
+     * Tiles are read on demand and kept in an LRU cache bounded by a memory budget, so a texture
+     * set larger than the budget renders with only the tiles recently sampled in memory. Tiles
+     * handed out stay valid while the returned pointer is held, even once evicted.
+     */
+    class TextureCache {
+    public:
+        static constexpr size_t DEFAULT_MEMORY_BUDGET = size_t(64) << 20;
+
+        /**
+         * @brief Create an empty cache
+         * @param memoryBudget The maximum size of the cached tiles in bytes
+         * @throws std::invalid_argument if memoryBudget is zero
+         */
+        explicit TextureCache(size_t memoryBudget = DEFAULT_MEMORY_BUDGET);
+
+        TextureCache(const TextureCache&) = delete;
+        TextureCache& operator=(const TextureCache&) = delete;
+
+        /**
+         * @brief Get a tile of a texture, reading it from disk if needed
+         * Reading may evict least recently used tiles of any texture.
+         * @param texture The texture owning the tile
+         * @param tile The index of the tile in the texture, all levels included
+         * @return Shared pointer to the RGBA8 texels of the tile, row by row
+         * @throws std::runtime_error if the tile cannot be read
+         */
+        std::shared_ptr<const math::Vector<uint8_t>> acquireTile(const Texture& texture, size_t tile);
+
+        /**
+         * @brief Drop every cached tile of a texture
+         * @param textureId The id of the texture
+         */
+        void forget(uint64_t textureId);
+
+        size_t getMemoryBudget() const { return memoryBudget; }
+        size_t getResidentBytes() const;
+        size_t getTileLoadCount() const;
+        size_t getEvictionCount() const;
+
+    private:
+        /// A cached tile, its position in the use order and its size
+        struct Entry {
+            std::shared_ptr<const math::Vector<uint8_t>> texels;
+            std::list<uint64_t>::iterator use;
+        };
+
+        size_t memoryBudget;
+        mutable std::mutex cacheMutex;
+        std::unordered_map<uint64_t, Entry> entries;
+        std::list<uint64_t> useOrder;   ///< Keys of the cached tiles, most recently used first
+        size_t residentBytes{0};
+        size_t loadCount{0};
+        size_t evictionCount{0};
+
+        void evictFor(size_t bytes);
+    };
+
+    /**
+     * @class Texture
+     * @brief An RGBA8 texture with its mip chain, stored in square tiles in a texture file.
+     *
+     * Texture files are written from an Image by write(), which builds every mip level by 2x2
+     * box filtering down to 1x1. Opened textures hold no texels: samples fetch the tiles they
+     * need through a TextureCache. Coordinates wrap, (u, v) = (0, 0) is the top left corner of
+     * the image and (1, 1) the bottom right one.
+     */
+    class Texture {
+    public:
+        static constexpr size_t DEFAULT_TILE_SIZE = 32;
+
+        /**
+         * @brief Write the mip chain of an image to a texture file
+         * @param image The full resolution image
+         * @param filePath The texture file to create
+         * @param tileSize The side of the tiles in texels
+         * @throws std::invalid_argument if the image is empty or tileSize is zero
+         * @throws std::runtime_error if the file cannot be written
+         */
+        static void write(const Image& image, const std::string& filePath, size_t tileSize = DEFAULT_TILE_SIZE);
+
+        /**
+         * @brief Write an image to a texture file and open it
+         * @param image The full resolution image
+         * @param filePath The texture file to create
+         * @param cache The cache the texture pages its tiles through
+         * @return The opened texture
+         */
+        static std::shared_ptr<const Texture> fromImage(const Image& image, const std::string& filePath, std::shared_ptr<TextureCache> cache);
+
+        /**
+         * @brief Open a texture file
+         * @param filePath The texture file written by write
+         * @param cache The cache the texture pages its tiles through
+         * @throws std::invalid_argument if cache is null
+         * @throws std::runtime_error if the file cannot be opened or is not a texture file
+         */
+        Texture(const std::string& filePath, std::shared_ptr<TextureCache> cache);
+
+        ~Texture();
+
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+
+        size_t getWidth() const { return levels[0].width; }
+        size_t getHeight() const { return levels[0].height; }
+        size_t getLevelCount() const { return levels.size(); }
+        size_t getTileSize() const { return tileSize; }
+        size_t getTileCount() const { return tileCount; }
+        uint64_t getId() const { return id; }
+
+        /**
+         * @brief Get one texel, coordinates wrapping around the level
+         * @param level The mip level, 0 being the full resolution
+         * @param x The column of the texel
+         * @param y The row of the texel
+         * @return The texel
+         * @throws std::out_of_range if level is invalid
+         */
+        RGBA_Color texel(size_t level, long long x, long long y) const;
+
+        /**
+         * @brief Interpolate the four texels of a level nearest to a point
+         * @param u The horizontal coordinate, wrapping
+         * @param v The vertical coordinate, wrapping
+         * @param level The mip level, clamped to the chain
+         * @return The bilinear sample
+         */
+        RGBA_Color sampleBilinear(double u, double v, size_t level) const;
+
+        /**
+         * @brief Interpolate between the bilinear samples of the two levels around a level of detail
+         * @param u The horizontal coordinate, wrapping
+         * @param v The vertical coordinate, wrapping
+         * @param lod The level of detail, clamped to the chain
+         * @return The trilinear sample
+         */
+        RGBA_Color sample(double u, double v, double lod) const;
+
+        /**
+         * @brief Compute the level of detail matching a footprint on a surface
+         * @param footprint The width of the ray footprint in world units
+         * @param uLength The world length spanned by one unit of u
+         * @param vLength The world length spanned by one unit of v
+         * @return The level of detail, 0 when texels are at least as wide as the footprint
+         */
+        double levelOfDetail(double footprint, double uLength, double vLength) const;
+
+    private:
+        friend class TextureCache;
+
+        /// Size and first tile of a mip level
+        struct Level {
+            size_t width;
+            size_t height;
+            size_t tilesX;
+            size_t tilesY;
+            size_t firstTile;
+        };
+
+        math::Vector<Level> levels;
+        size_t tileSize{0};
+        size_t tileCount{0};
+        uint64_t dataOffset{0};
+        uint64_t id;
+        std::string filePath;
+        std::shared_ptr<TextureCache> cache;
+        int fileDescriptor{-1};
+        FILE* file{nullptr};                    ///< Used where pread is missing, reads then share a lock
+        mutable std::mutex fileMutex;
+
+        static std::atomic<uint64_t> nextId;
+
+        /// The tile a sample is reading, kept across the texels it fetches
+        struct TileHandle {
+            size_t tile = SIZE_MAX;
+            std::shared_ptr<const math::Vector<uint8_t>> texels;
+        };
+
+        static math::Vector<Level> layoutLevels(size_t width, size_t height, size_t tileSize, size_t& tileCount);
+        size_t tileBytes() const { return tileSize * tileSize * 4; }
+        math::Vector<uint8_t> readTile(size_t tile) const;
+        const uint8_t* fetch(const Level& level, long long x, long long y, TileHandle& handle) const;
+        void bilinear(double u, double v, size_t level, TileHandle& handle, double* rgba) const;
+    };
+
+    /**
+     * @struct SurfaceCoordinates
+     * @brief Texture coordinates of a point of a shape, and the world length of one unit of each.
+     */
+    struct SurfaceCoordinates {
+        double u = 0.0;
+        double v = 0.0;
+        double uLength = 1.0;   ///< World length spanned by one unit of u
+        double vLength = 1.0;   ///< World length spanned by one unit of v
+    };
+
+    /**
+     * @brief Compute the texture coordinates of a point of a shape
+     * Spheres are mapped by longitude and latitude, rectangles span [0, 1] along their length and
+     * width, circles span [0, 1] over their bounding square and infinite planes repeat every world unit.
+     * @param shape The shape
+     * @param point The point, on the surface of the shape
+     * @param coordinates Output parameter for the coordinates
+     * @return False if the shape has no geometry or no mapping (boxes)
+     */
+    bool surfaceCoordinates(const Camera::ShapeVariant& shape, const Vector3D& point, SurfaceCoordinates& coordinates);
+
+    /**
+     * @brief Get the albedo of a textured material at a point, as the renderers shade it
+     * The texture is sampled trilinearly with the level of detail of a ray cone: the footprint
+     * grows with the distance traveled and is stretched by grazing angles.
+     * @param shape The shape hit
+     * @param material Its material, which has an albedo texture
+     * @param point The point hit
+     * @param normal The normal of the surface at the point
+     * @param direction The direction of the ray that hit
+     * @param footprint The width of the ray footprint at the point in world units, 0 for the finest level
+     * @return The albedo of the material modulated by the texture
+     */
+    RGBA_Color texturedAlbedo(const Camera::ShapeVariant& shape, const Material& material, const Vector3D& point, const Vector3D& normal, const Vector3D& direction, double footprint);
+
+} // namespace rendering
+
+#endif // TEXTURE_H
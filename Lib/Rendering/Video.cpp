@@ -5,6 +5,8 @@
 #include "Video.h"
 #include <stdexcept>
 #include <algorithm>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 
@@ -14,10 +16,89 @@ double Video::getDuration() const {
     if (framesPerSecond <= 0) {
         return 0.0;
     }
-    return static_cast<double>(frames.size()) / framesPerSecond;
+    return static_cast<double>(getFrameCount()) / framesPerSecond;
+}
+
+void Video::addFrame(const Image& img) {
+    if (!isStreaming()) {
+        frames.append(img);
+        return;
+    }
+
+    std::string frameFile = "frame_" + std::string(6 - std::to_string(streamedFrameCount).length(), '0') + std::to_string(streamedFrameCount);
+    try {
+        img.toBitmapFile(frameFile, streamDirectory);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Failed to stream frame " + std::to_string(streamedFrameCount) + ": " + e.what());
+    }
+    ++streamedFrameCount;
+}
+
+void Video::clearFrames() {
+    if (isStreaming()) {
+        for (size_t i = 0; i < streamedFrameCount; ++i) {
+            std::string frameFile = "frame_" + std::string(6 - std::to_string(i).length(), '0') + std::to_string(i);
+            std::remove((streamDirectory + "/" + frameFile + ".bmp").c_str());
+        }
+        streamedFrameCount = 0;
+    }
+    // Reset the vector completely
+    frames.clear();
+}
+
+void Video::enableFrameStreaming(const std::string& directory) {
+    if (directory.empty()) {
+        throw std::invalid_argument("Stream directory must not be empty");
+    }
+    if (isStreaming()) {
+        throw std::logic_error("Frames are already streamed to " + streamDirectory);
+    }
+    std::filesystem::create_directories(directory);
+
+    // Flush the frames held so far, then release them
+    streamDirectory = directory;
+    math::Vector<Image> heldFrames = frames;
+    frames.clear();
+    for (const Image& frame : heldFrames) {
+        addFrame(frame);
+    }
+}
+
+Image Video::loadFrame(size_t index) const {
+    if (index >= getFrameCount()) {
+        throw std::out_of_range("Frame index out of range");
+    }
+    if (!isStreaming()) {
+        return frames[index];
+    }
+    std::string frameFile = "frame_" + std::string(6 - std::to_string(index).length(), '0') + std::to_string(index) + ".bmp";
+    return Image(frameFile, streamDirectory + "/");
+}
+
+void Video::requireInMemoryFrames() const {
+    if (isStreaming()) {
+        throw std::logic_error("Operation needs the frames in memory but they are streamed to " + streamDirectory);
+    }
+}
+
+std::string Video::stageFrames(const std::string& tempDir) const {
+    if (isStreaming()) {
+        return streamDirectory;
+    }
+
+    // Create temporary directory for frames
+    std::system(("mkdir -p " + tempDir).c_str());
+
+    // Export frames as temporary BMP files with zero-padded names
+    for (size_t i = 0; i < frames.size(); ++i) {
+        std::string frameFile = "frame_" + std::string(6 - std::to_string(i).length(), '0') + std::to_string(i);
+        frames[i].toBitmapFile(frameFile, tempDir);
+    }
+    return tempDir;
 }
 
 void Video::insertFrame(size_t index, const Image& img) {
+    requireInMemoryFrames();
     if (index > frames.size()) {
         throw std::out_of_range("Frame index out of range");
     }
@@ -29,7 +110,7 @@ void Video::exportToFile(const std::string& filename, const std::string& filepat
         throw std::runtime_error("Cannot export invalid video");
     }
     
-    if (frames.empty()) {
+    if (getFrameCount() == 0) {
         throw std::runtime_error("Cannot export video with no frames");
     }
     
@@ -62,6 +143,7 @@ void Video::resizeVideo(size_t newWidth, size_t newHeight) {
     if (newWidth == 0 || newHeight == 0) {
         throw std::invalid_argument("New dimensions must be positive");
     }
+    requireInMemoryFrames();
     
     for (Image& frame : frames) {
         frame.resize(newWidth, newHeight);
@@ -72,6 +154,7 @@ void Video::resizeVideo(size_t newWidth, size_t newHeight) {
 }
 
 Video Video::extractFrameRange(size_t startFrame, size_t endFrame) const {
+    requireInMemoryFrames();
     if (startFrame >= frames.size() || endFrame > frames.size() || startFrame >= endFrame) {
         throw std::out_of_range("Invalid frame range");
     }
@@ -86,11 +169,12 @@ Video Video::extractFrameRange(size_t startFrame, size_t endFrame) const {
 }
 
 void Video::reverseFrames() {
+    requireInMemoryFrames();
     std::reverse(frames.begin(), frames.end());
 }
 
 Image Video::createThumbnail(size_t frameIndex, size_t thumbnailWidth, size_t thumbnailHeight) const {
-    if (frameIndex >= frames.size()) {
+    if (frameIndex >= getFrameCount()) {
         throw std::out_of_range("Frame index out of range");
     }
 
@@ -98,7 +182,7 @@ Image Video::createThumbnail(size_t frameIndex, size_t thumbnailWidth, size_t th
         throw std::invalid_argument("Thumbnail dimensions must be positive");
     }
 
-    Image thumbnail = frames[frameIndex];
+    Image thumbnail = loadFrame(frameIndex);
     thumbnail.resize(thumbnailWidth, thumbnailHeight);
 
     return thumbnail;
@@ -108,11 +192,18 @@ void Video::exportFrameSequence(const std::string& basePath, const std::string&
     // Extract directory and create frame files
     std::string directory = basePath.substr(0, basePath.find_last_of("/\\"));
     
-    for (size_t i = 0; i < frames.size(); ++i) {
+    for (size_t i = 0; i < getFrameCount(); ++i) {
         std::string frameFilename = baseFilename + "_frame_" + std::to_string(i);
         
         try {
-            frames[i].toBitmapFile(frameFilename, basePath);
+            if (isStreaming()) {
+                // Streamed frames are already encoded, copy them
+                std::string frameFile = "frame_" + std::string(6 - std::to_string(i).length(), '0') + std::to_string(i);
+                std::filesystem::copy_file(streamDirectory + "/" + frameFile + ".bmp", basePath + "/" + frameFilename + ".bmp",
+                                           std::filesystem::copy_options::overwrite_existing);
+            } else {
+                frames[i].toBitmapFile(frameFilename, basePath);
+            }
         } catch (const std::exception& e) {
             throw std::runtime_error("Failed to export frame " + std::to_string(i) + ": " + e.what());
         }
@@ -127,7 +218,7 @@ void Video::exportFrameSequence(const std::string& basePath, const std::string&
         metadata << "Width: " << width << " pixels\n";
         metadata << "Height: " << height << " pixels\n";
         metadata << "Frame Rate: " << framesPerSecond << " fps\n";
-        metadata << "Frame Count: " << frames.size() << "\n";
+        metadata << "Frame Count: " << getFrameCount() << "\n";
         metadata << "Duration: " << getDuration() << " seconds\n";
         metadata << "Format: PNG\n";
         metadata.close();
@@ -142,26 +233,12 @@ void Video::exportMKV(const std::string& filename, const std::string& filepath)
     // Create output directory if it doesn't exist
     std::system(("mkdir -p " + filepath).c_str());
     
-    // Create temporary directory for frames
-    std::system(("mkdir -p " + tempDir).c_str());
-    
     try {
-        // Export frames as temporary BMP files with zero-padded names
-        for (size_t i = 0; i < frames.size(); ++i) {
-            // Create zero-padded frame number (6 digits)
-            std::string frameNumber = std::to_string(i);
-            frameNumber = std::string(6 - frameNumber.length(), '0') + frameNumber;
-            std::string frameFile = "frame_" + frameNumber;
-            
-            // Export frame to temp directory
-            frames[i].toBitmapFile(frameFile, tempDir);
-            
-            // Debug: print the actual file path being created
-            std::cout << "Created frame: " << tempDir << "/" << frameFile << ".bmp" << std::endl;
-        }
+        // Export frames as temporary BMP files with zero-padded names, streamed frames are used in place
+        std::string frameDir = stageFrames(tempDir);
         
         // Verify files exist before calling FFmpeg
-        std::string testFile = tempDir + "/frame_000000.bmp";
+        std::string testFile = frameDir + "/frame_000000.bmp";
         std::ifstream test(testFile);
         if (!test.good()) {
             throw std::runtime_error("Frame files were not created properly. Expected: " + testFile);
@@ -170,7 +247,7 @@ void Video::exportMKV(const std::string& filename, const std::string& filepath)
         
         // Use FFmpeg to create MKV video
         std::string ffmpegCmd = "ffmpeg -y -framerate " + std::to_string(framesPerSecond) + 
-                               " -i " + tempDir + "/frame_%06d.bmp" +
+                               " -i " + frameDir + "/frame_%06d.bmp" +
                                " -c:v libx264 -pix_fmt yuv420p \"" + fullPath + "\"";
         
         std::cout << "Running FFmpeg command: " << ffmpegCmd << std::endl;
@@ -197,19 +274,13 @@ void Video::exportMP4(const std::string& filename, const std::string& filepath)
     std::string fullPath = filepath + "/" + filename + ".mp4";
     std::string tempDir = filepath + "/temp_frames";
     
-    // Create temporary directory for frames
-    std::system(("mkdir -p " + tempDir).c_str());
-    
     try {
-        // Export frames as temporary PNG files
-        for (size_t i = 0; i < frames.size(); ++i) {
-            std::string frameFile = "frame_" + std::string(6 - std::to_string(i).length(), '0') + std::to_string(i);
-            frames[i].toBitmapFile(frameFile, tempDir);
-        }
+        // Export frames as temporary BMP files, streamed frames are used in place
+        std::string frameDir = stageFrames(tempDir);
         
         // Use FFmpeg to create MP4 video
         std::string ffmpegCmd = "ffmpeg -y -framerate " + std::to_string(framesPerSecond) + 
-                               " -i " + tempDir + "/frame_%06d.bmp" +
+                               " -i " + frameDir + "/frame_%06d.bmp" +
                                " -c:v libx264 -pix_fmt yuv420p -crf 23 " + fullPath;
         
         int result = std::system(ffmpegCmd.c_str());
@@ -232,15 +303,9 @@ void Video::exportAsGif(const std::string& filename, const std::string& filepath
     std::string fullPath = filepath + "/" + filename + ".gif";
     std::string tempDir = filepath + "/temp_frames";
     
-    // Create temporary directory for frames
-    std::system(("mkdir -p " + tempDir).c_str());
-    
     try {
-        // Export frames as temporary PNG files
-        for (size_t i = 0; i < frames.size(); ++i) {
-            std::string frameFile = "frame_" + std::string(6 - std::to_string(i).length(), '0') + std::to_string(i);
-            frames[i].toBitmapFile(frameFile, tempDir);
-        }
+        // Export frames as temporary BMP files, streamed frames are used in place
+        std::string frameDir = stageFrames(tempDir);
         
         // Calculate delay between frames (in centiseconds for GIF)
         int delay = static_cast<int>(100.0 / framesPerSecond);
@@ -248,7 +313,7 @@ void Video::exportAsGif(const std::string& filename, const std::string& filepath
         
         // Use ImageMagick to create GIF
         std::string magickCmd = "convert -delay " + std::to_string(delay) + 
-                               " -loop 0 " + tempDir + "/frame_*.bmp " + fullPath;
+                               " -loop 0 " + frameDir + "/frame_*.bmp " + fullPath;
         
         int result = std::system(magickCmd.c_str());
         
@@ -279,7 +344,7 @@ bool Video::validateFrameDimensions() const {
 // Method to get video statistics
 VideoStats Video::getStats() const {
     VideoStats stats;
-    stats.frameCount = frames.size();
+    stats.frameCount = getFrameCount();
     stats.duration = getDuration();
     stats.width = width;
     stats.height = height;
@@ -287,7 +352,7 @@ VideoStats Video::getStats() const {
     stats.isValid = isValid();
     
     // Calculate file size estimation (assuming 24-bit RGB)
-    stats.estimatedSizeBytes = static_cast<size_t>(width) * height * 3 * frames.size();
+    stats.estimatedSizeBytes = static_cast<size_t>(width) * height * 3 * getFrameCount();
     
     return stats;
 }
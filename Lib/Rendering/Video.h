@@ -74,7 +74,7 @@ namespace rendering {
         
         /**
          * @brief Get all frames in the video
-         * @return const math::Vector<Image>& Reference to the frames vector
+         * @return const math::Vector<Image>& Reference to the frames vector, empty when frames are streamed
          */
         const math::Vector<Image>& getFrames() const { return frames; }
         
@@ -83,14 +83,27 @@ namespace rendering {
          * @param index Index of the frame to retrieve
          * @return Image& Reference to the frame at the specified index
          * @throws std::out_of_range if index is invalid
+         * @throws std::logic_error if frames are streamed, use loadFrame instead
          */
-        Image& getFrame(size_t index) { return frames[index]; }
+        Image& getFrame(size_t index) { requireInMemoryFrames(); return frames[index]; }
         
         /**
          * @brief Get the total number of frames in the video
-         * @return size_t Number of frames
+         * @return size_t Number of frames, held in memory or streamed
          */
-        size_t getFrameCount() const { return frames.size(); }
+        size_t getFrameCount() const { return isStreaming() ? streamedFrameCount : frames.size(); }
+
+        /**
+         * @brief Check if frames are written to disk instead of kept in memory
+         * @return bool True if enableFrameStreaming was called
+         */
+        bool isStreaming() const { return !streamDirectory.empty(); }
+
+        /**
+         * @brief Get the directory receiving the streamed frames
+         * @return const std::string& The directory, empty if frames are kept in memory
+         */
+        const std::string& getStreamDirectory() const { return streamDirectory; }
         
         /**
          * @brief Get the total duration of the video in seconds
@@ -130,39 +143,57 @@ namespace rendering {
          * @brief Replace all frames with a new set of frames
          * @param f math::Vector of images to set as the new frames
          */
-        void setFrames(const math::Vector<Image>& f) { frames = f; }
+        void setFrames(const math::Vector<Image>& f) { requireInMemoryFrames(); frames = f; }
         
         /**
          * @brief Add a frame to the end of the video
+         * When frames are streamed the frame is written to disk right away and not kept.
          * @param img Image to add as a new frame
+         * @throws std::runtime_error if a streamed frame cannot be written
          */
-        void addFrame(const Image& img) {
-            frames.append(img); 
-        }
+        void addFrame(const Image& img);
         
         /**
          * @brief Remove all frames from the video
+         * Streamed frames are deleted from the stream directory.
          */
-        void clearFrames() {
-            // Reset the vector completely
-            frames.clear();
-        }
+        void clearFrames();
 
         /**
          * @brief Remove a specific frame by index
          * @param index Index of the frame to remove
          * @throws std::out_of_range if index is invalid
+         * @throws std::logic_error if frames are streamed
          */
-        void removeFrame(size_t index) { frames.erase(index); }
+        void removeFrame(size_t index) { requireInMemoryFrames(); frames.erase(index); }
 
         /**
          * @brief Insert a frame at a specific position
          * @param index Position to insert the frame
          * @param img Image to insert
          * @throws std::out_of_range if index is invalid
+         * @throws std::logic_error if frames are streamed
          */
         void insertFrame(size_t index, const Image& img);
 
+        /**
+         * @brief Write frames to disk as they are added instead of keeping them in memory
+         * Frames already held are flushed to the directory first. Frames are stored as
+         * frame_000000.bmp, frame_000001.bmp... and the exports read them from there, so an
+         * animation never holds more than the frame being rendered.
+         * @param directory The directory receiving the frames, created if needed
+         * @throws std::runtime_error if a frame cannot be written
+         */
+        void enableFrameStreaming(const std::string& directory);
+
+        /**
+         * @brief Get a copy of a frame, read back from disk if frames are streamed
+         * @param index Index of the frame
+         * @return Image The frame
+         * @throws std::out_of_range if index is invalid
+         */
+        Image loadFrame(size_t index) const;
+
         #pragma endregion
 
         #pragma region Methods
@@ -196,6 +227,7 @@ namespace rendering {
          * @brief Resize all frames in the video to new dimensions
          * @param newWidth New width for all frames
          * @param newHeight New height for all frames
+         * @throws std::logic_error if frames are streamed
          */
         void resizeVideo(size_t newWidth, size_t newHeight);
 
@@ -205,11 +237,13 @@ namespace rendering {
          * @param endFrame Ending frame index (exclusive)
          * @return Video New video containing the specified frame range
          * @throws std::out_of_range if frame indices are invalid
+         * @throws std::logic_error if frames are streamed
          */
         Video extractFrameRange(size_t startFrame, size_t endFrame) const;
 
         /**
          * @brief Reverse the order of all frames in the video
+         * @throws std::logic_error if frames are streamed
          */
         void reverseFrames();
 
@@ -258,6 +292,21 @@ namespace rendering {
         size_t height;                 ///< Height of video frames in pixels
         double framesPerSecond;     ///< Frame rate in frames per second
         math::Vector<Image> frames; ///< Sequence of image frame pointers
+        std::string streamDirectory;   ///< Directory of the streamed frames, empty when frames are kept in memory
+        size_t streamedFrameCount = 0; ///< Number of frames written to streamDirectory
+
+        /**
+         * @brief Throw if an operation needs the frames in memory while they are streamed
+         * @throws std::logic_error if frames are streamed
+         */
+        void requireInMemoryFrames() const;
+
+        /**
+         * @brief Get the directory holding every frame as frame_%06d.bmp, writing them if needed
+         * @param tempDir Directory to write the frames to when they are held in memory
+         * @return std::string The stream directory when frames are streamed, tempDir otherwise
+         */
+        std::string stageFrames(const std::string& tempDir) const;
 
         /**
          * @brief Validate that all frames have consistent dimensions
@@ -3,32 +3,220 @@
 //
 
 #include "World.h"
+#include "IrradianceCache.h"
+
+#include <limits>
 
 namespace rendering {
 
+    namespace {
+
+        // Remove an entry of a vector kept in the order of a slot map: the last entry takes its place
+        template<typename T>
+        void removeSwapped(math::Vector<T>& entries, size_t index) {
+            size_t last = entries.size() - 1;
+            if (index != last) {
+                entries[index] = entries[last];
+            }
+            entries.removeLast();
+        }
+
+        Box translated(const Box& box, const Vector3D& offset) { return box.translate(offset); }
+        Rectangle translated(const Rectangle& rectangle, const Vector3D& offset) { return rectangle.translate(offset); }
+        Plane translated(const Plane& plane, const Vector3D& offset) { return Plane(plane.getOrigin() + offset, plane.getNormal()); }
+        Circle translated(const Circle& circle, const Vector3D& offset) { return Circle(circle.getCenter() + offset, circle.getRadius(), circle.getNormal()); }
+        Sphere translated(const Sphere& sphere, const Vector3D& offset) {
+            Sphere moved(sphere);
+            moved.translate(offset);
+            return moved;
+        }
+
+    } // namespace
+
     World::World()
-        : objects(math::Vector<ShapeVariant>(0)),
-          camera(Rectangle(Vector3D(0, 0, 0), Vector3D(0, 100, 0), Vector3D(0, 0, 100)))
+        : camera(Rectangle(Vector3D(0, 0, 0), Vector3D(0, 100, 0), Vector3D(0, 0, 100)))
     {
         // Default constructor - initialize empty world with default camera
         // Camera positioned at (0,0,5) with 10x10 viewport looking toward origin
     }
 
+    void World::removeObject(ObjectHandle handle) {
+        size_t index = objects.indexOf(handle);
+        unindexObject(index);
+        removeSwapped(objectVersions, index);
+        objects.erase(handle);
+        objectsRemovedVersion = ++version;
+    }
+
+    void World::setObjectMaterial(ObjectHandle handle, const Material& material) {
+        size_t index = objects.indexOf(handle);
+        std::visit([&](auto& shape) { shape.setMaterial(material); }, objects[index]);
+        // The geometry is unchanged, so is the spatial index
+        recordObjectChange(index, ChangeKind::MATERIAL);
+    }
+
+    void World::moveObject(ObjectHandle handle, const Vector3D& offset) {
+        size_t index = objects.indexOf(handle);
+        std::visit([&](auto& shape) {
+            if (shape.getGeometry()) {
+                shape.setGeometry(translated(*shape.getGeometry(), offset));
+            }
+        }, objects[index]);
+        reindexObject(index);
+        recordObjectChange(index, ChangeKind::TRANSFORM);
+    }
+
+    ChangeKind World::replacementChanges(size_t index, const ShapeVariant& replacement) const {
+        const Material* before = std::visit([](auto&& shape) { return shape.getMaterial(); }, objects[index]);
+        const Material* after = std::visit([](auto&& shape) { return shape.getMaterial(); }, replacement);
+        bool sameMaterial = before == nullptr ? after == nullptr : after != nullptr && *before == *after;
+        return sameMaterial ? ChangeKind::GEOMETRY : ChangeKind::GEOMETRY | ChangeKind::MATERIAL;
+    }
+
+    void World::recordObjectChange(size_t index, ChangeKind kinds) {
+        objectVersions[index].record(kinds, ++version);
+    }
+
     void World::removeObjectAt(const size_t index) {
         if (index >= objects.size()) {
             throw std::out_of_range("Object index out of bounds");
         }
-        objects.erase(index);
+        removeObject(objects.handleAt(index));
+    }
+
+    const Camera::ShapeVariant& World::getObjectAt(size_t index) const {
+        if (index >= objects.size()) {
+            throw std::out_of_range("Object index out of bounds");
+        }
+        return objects[index];
+    }
+
+    World::ObjectHandle World::getObjectHandleAt(size_t index) const {
+        if (index >= objects.size()) {
+            throw std::out_of_range("Object index out of bounds");
+        }
+        return objects.handleAt(index);
+    }
+
+    void World::indexObject(size_t index) {
+        IndexEntry entry;
+        Bounds3D bounds;
+        if (DynamicBVH::boundsOf(objects[index], bounds)) {
+            entry.proxy = objectIndex.insert(index, bounds);
+        } else {
+            entry.unbounded = unboundedObjects.size();
+            unboundedObjects.append(index);
+        }
+        objectEntries.append(entry);
     }
 
-    void World::addLight(const Light& light) {
-        lights.append(light);
+    void World::reindexObject(size_t index) {
+        Bounds3D bounds;
+        bool bounded = DynamicBVH::boundsOf(objects[index], bounds);
+        IndexEntry& entry = objectEntries[index];
+        if (bounded && entry.proxy != DynamicBVH::NONE) {
+            objectIndex.update(entry.proxy, bounds);
+        } else if (bounded) {
+            removeUnbounded(entry.unbounded);
+            entry.unbounded = DynamicBVH::NONE;
+            entry.proxy = objectIndex.insert(index, bounds);
+        } else if (entry.proxy != DynamicBVH::NONE) {
+            objectIndex.remove(entry.proxy);
+            entry.proxy = DynamicBVH::NONE;
+            entry.unbounded = unboundedObjects.size();
+            unboundedObjects.append(index);
+        }
+    }
+
+    void World::unindexObject(size_t index) {
+        IndexEntry& entry = objectEntries[index];
+        if (entry.proxy != DynamicBVH::NONE) {
+            objectIndex.remove(entry.proxy);
+        } else {
+            removeUnbounded(entry.unbounded);
+        }
+
+        // Follow the slot map, which moves the last object into the freed position
+        size_t last = objectEntries.size() - 1;
+        if (index != last) {
+            entry = objectEntries[last];
+            if (entry.proxy != DynamicBVH::NONE) {
+                objectIndex.setObject(entry.proxy, index);
+            } else {
+                unboundedObjects[entry.unbounded] = index;
+            }
+        }
+        objectEntries.removeLast();
+    }
+
+    void World::removeUnbounded(size_t position) {
+        size_t last = unboundedObjects.size() - 1;
+        if (position != last) {
+            unboundedObjects[position] = unboundedObjects[last];
+            objectEntries[unboundedObjects[position]].unbounded = position;
+        }
+        unboundedObjects.removeLast();
+    }
+
+    void World::clearObjectIndex() {
+        objectIndex.clear();
+        objectEntries.clear();
+        unboundedObjects.clear();
+    }
+
+    std::optional<Hit> World::findClosestHit(const Ray& ray) const {
+        std::optional<Hit> closest = objectIndex.findClosestHit(ray, objects.getValues());
+        for (size_t i = 0; i < unboundedObjects.size(); ++i) {
+            size_t index = unboundedObjects[i];
+            std::visit([&](auto&& shape) {
+                if (shape.getGeometry()) {
+                    double tmax = closest ? closest->t : std::numeric_limits<double>::infinity();
+                    if (auto d = shape.getGeometry()->rayIntersectDepth(ray, tmax)) {
+                        // only accept hits in front of the origin
+                        if (*d > 1e-9 && *d < tmax) {
+                            closest = Hit{*d, index};
+                        }
+                    }
+                }
+            }, objects[index]);
+        }
+        return closest;
+    }
+
+    World::LightHandle World::addLight(const Light& light) {
+        LightHandle handle = lights.insert(light);
+        lightVersions.append(ChangeVersions());
+        lightVersions[lightVersions.size() - 1].record(ChangeKind::ADDED, ++version);
+        return handle;
+    }
+
+    void World::setLight(LightHandle handle, const Light& light) {
+        size_t index = lights.indexOf(handle);
+        const Light& before = lights[index];
+        ChangeKind kinds = ChangeKind::NONE;
+        if (!(before.getPosition() == light.getPosition())) {
+            kinds |= ChangeKind::TRANSFORM;
+        }
+        if (!(before.getColor() == light.getColor()) || before.getIntensity() != light.getIntensity()) {
+            kinds |= ChangeKind::MATERIAL;
+        }
+        lights[index] = light;
+        if (kinds != ChangeKind::NONE) {
+            lightVersions[index].record(kinds, ++version);
+        }
+    }
+
+    void World::removeLight(LightHandle handle) {
+        size_t index = lights.indexOf(handle);
+        removeSwapped(lightVersions, index);
+        lights.erase(handle);
+        lightsRemovedVersion = ++version;
     }
 
     void World::removeLight(const Light& light) {
         for (size_t i = 0; i < lights.size(); ++i) {
             if (lights[i] == light) {
-                lights.erase(i);
+                removeLight(lights.handleAt(i));
                 return;
             }
         }
@@ -38,11 +226,75 @@ namespace rendering {
         if (index >= lights.size()) {
             throw std::out_of_range("Light index out of bounds");
         }
-        lights.erase(index);
+        removeLight(lights.handleAt(index));
+    }
+
+    SceneChangeSet World::getChanges(uint64_t sinceVersion) const {
+        SceneChangeSet changes;
+        changes.sinceVersion = sinceVersion;
+        changes.version = version;
+        if (sinceVersion >= version) {
+            return changes;
+        }
+
+        for (size_t i = 0; i < objectVersions.size(); ++i) {
+            ChangeKind kinds = objectVersions[i].since(sinceVersion);
+            if (kinds != ChangeKind::NONE) {
+                changes.objects.append(objects.handleAt(i));
+                changes.objectChanges.append(kinds);
+                changes.objectKinds |= kinds;
+            }
+        }
+        for (size_t i = 0; i < lightVersions.size(); ++i) {
+            ChangeKind kinds = lightVersions[i].since(sinceVersion);
+            if (kinds != ChangeKind::NONE) {
+                changes.lights.append(lights.handleAt(i));
+                changes.lightChanges.append(kinds);
+                changes.lightKinds |= kinds;
+            }
+        }
+        changes.objectsRemoved = objectsRemovedVersion > sinceVersion;
+        changes.lightsRemoved = lightsRemovedVersion > sinceVersion;
+        return changes;
+    }
+
+    void World::updateCaches() {
+        if (pager) {
+            return;
+        }
+
+        if (bakedShadowMaps && camera.getShadowMaps() == bakedShadowMaps && shadowMapVersion < version) {
+            SceneChangeSet changes = getChanges(shadowMapVersion);
+            std::shared_ptr<const ShadowMapSet> shadowMaps;
+            if (!changes.changesObjects() && !changes.lightsRemoved && !hasChange(changes.lightKinds, ChangeKind::ADDED)) {
+                // The maps only see the geometry and the light positions: render the moved lights again
+                math::Vector<size_t> moved;
+                for (size_t i = 0; i < changes.lights.size(); ++i) {
+                    if (hasChange(changes.lightChanges[i], ChangeKind::TRANSFORM)) {
+                        moved.append(lights.indexOf(changes.lights[i]));
+                    }
+                }
+                shadowMaps = std::make_shared<const ShadowMapSet>(ShadowMapSet::rebuild(*bakedShadowMaps, objects.getValues(), lights.getValues(), moved));
+            } else {
+                shadowMaps = std::make_shared<const ShadowMapSet>(ShadowMapSet::build(objects.getValues(), lights.getValues(), bakedShadowMaps->getResolution()));
+            }
+            bakedShadowMaps = shadowMaps;
+            camera.setShadowMaps(shadowMaps);
+            shadowMapVersion = version;
+        }
+
+        if (bakedLightmaps && camera.getLightmaps() == bakedLightmaps && lightmapVersion < version) {
+            bakeLightmaps(lightmapTexelSize, lightmapPlaneExtent);
+        }
+
+        if (camera.getIrradianceCache() && irradianceVersion < version) {
+            camera.getIrradianceCache()->reset(objects.getValues(), lights.getValues());
+        }
+        irradianceVersion = version;
     }
 
     size_t World::getObjectCount() const {
-        return objects.size();
+        return objects.size() + (pager ? pager->getShapeCount() : 0);
     }
 
     Camera& World::getCamera() {
@@ -54,57 +306,199 @@ namespace rendering {
     }
 
     void World::clearObjects() {
+        if (!objects.empty() || pager) {
+            objectsRemovedVersion = ++version;
+        }
+        objects.clear();
+        objectVersions.clear();
+        clearObjectIndex();
+        pager.reset();
+    }
+
+    void World::pageObjectsToFile(const std::string& filePath, size_t memoryBudget, size_t shapesPerPage) {
+        if (pager) {
+            throw std::logic_error("World objects are already paged");
+        }
+        ScenePageWriter writer(filePath, shapesPerPage);
+        for (size_t i = 0; i < objects.size(); ++i) {
+            writer.addShape(objects[i]);
+        }
+        writer.finalize();
+
+        pager = std::make_shared<ScenePager>(filePath, memoryBudget);
         objects.clear();
+        objectVersions.clear();
+        clearObjectIndex();
+        objectsRemovedVersion = ++version;
+    }
+
+    void World::loadPagedObjects(const std::string& filePath, size_t memoryBudget) {
+        pager = std::make_shared<ScenePager>(filePath, memoryBudget);
     }
 
     Image World::renderScene2DColor(size_t imageWidth, size_t imageHeight) const {
+        if (pager) {
+            throw std::logic_error("2D rendering is not available on a paged world");
+        }
         // Dispatch rendering based on the type of shapes in the world
         // For simplicity, we assume all shapes are of the same type here
         if (objects.size() == 0) {
             return Image(imageWidth, imageHeight); // Return empty image if no objects
         }
 
-        return camera.renderScene2DColor(imageWidth, imageHeight, objects);
+        return camera.renderScene2DColor(imageWidth, imageHeight, objects.getValues());
     }
 
     Image World::renderScene2DDepth(size_t imageWidth, size_t imageHeight) const {
+        if (pager) {
+            throw std::logic_error("2D rendering is not available on a paged world");
+        }
         // Dispatch rendering based on the type of shapes in the world
         // For simplicity, we assume all shapes are of the same type here
         if (objects.size() == 0) {
             return Image(imageWidth, imageHeight); // Return empty image if no objects
         }
 
-        return camera.renderScene2DDepth(imageWidth, imageHeight, objects);
+        return camera.renderScene2DDepth(imageWidth, imageHeight, objects.getValues());
     }
 
     Image World::renderScene3DColor(size_t imageWidth, size_t imageHeight) const {
+        if (pager) {
+            return camera.renderScene3DColorPaged(imageWidth, imageHeight, *pager, objects.getValues());
+        }
+
         // Dispatch rendering based on the type of shapes in the world
         // For simplicity, we assume all shapes are of the same type here
         if (objects.size() == 0) {
             return Image(imageWidth, imageHeight); // Return empty image if no objects
         }
 
-        return camera.renderScene3DColor(imageWidth, imageHeight, objects);
+        return camera.renderScene3DColor(imageWidth, imageHeight, objects.getValues());
     }
 
     Image World::renderScene3DDepth(size_t imageWidth, size_t imageHeight) const {
+        if (pager) {
+            return camera.renderScene3DDepthPaged(imageWidth, imageHeight, *pager, objects.getValues());
+        }
+
         // Dispatch rendering based on the type of shapes in the world
         // For simplicity, we assume all shapes are of the same type here
         if (objects.size() == 0) {
             return Image(imageWidth, imageHeight); // Return empty image if no objects
         }
 
-        return camera.renderScene3DDepth(imageWidth, imageHeight, objects);
+        return camera.renderScene3DDepth(imageWidth, imageHeight, objects.getValues());
     }
 
     Image World::renderScene3DLight(size_t imageWidth, size_t imageHeight) const {
+        if (pager) {
+            return camera.renderScene3DLightPaged(imageWidth, imageHeight, *pager, objects.getValues(), lights.getValues());
+        }
+
         // Dispatch rendering based on the type of shapes in the world
         // For simplicity, we assume all shapes are of the same type here
         if (objects.size() == 0) {
             return Image(imageWidth, imageHeight); // Return empty image if no objects
         }
 
-        return camera.renderScene3DLight(imageWidth, imageHeight, objects, lights);
+        return camera.renderScene3DLight(imageWidth, imageHeight, objects.getValues(), lights.getValues());
+    }
+
+    RenderRequest World::makeRenderRequest(size_t imageWidth, size_t imageHeight, size_t samplesPerPixel, Camera::AntiAliasingMethod method, size_t frameCount) const {
+        RenderRequest request;
+        request.imageWidth = imageWidth;
+        request.imageHeight = imageHeight;
+        request.samplesPerPixel = samplesPerPixel;
+        request.method = method;
+        request.frameCount = frameCount;
+        request.shapeCount = objects.size();
+        request.lightCount = lights.size();
+        request.sceneReplication = camera.isSceneReplicationEnabled();
+        return request;
+    }
+
+    Image World::renderScene3DLight(size_t imageWidth, size_t imageHeight, const RenderPlan& plan) const {
+        if (pager) {
+            throw std::logic_error("Anti-aliased rendering is not available on a paged world");
+        }
+        if (objects.size() == 0) {
+            return Image(imageWidth, imageHeight); // Return empty image if no objects
+        }
+
+        return camera.renderScene3DLight_Planned(imageWidth, imageHeight, objects.getValues(), lights.getValues(), plan);
+    }
+
+    Image World::renderScene3DLight(size_t imageWidth, size_t imageHeight, TemporalAccumulator& accumulator) const {
+        if (pager) {
+            throw std::logic_error("Temporal rendering is not available on a paged world");
+        }
+
+        return accumulator.renderFrame(camera, objects.getValues(), lights.getValues(), imageWidth, imageHeight);
+    }
+
+    Image World::renderScene3DLightDenoised(size_t imageWidth, size_t imageHeight, size_t samplesPerPixel, const Denoiser& denoiser) const {
+        if (pager) {
+            throw std::logic_error("Denoised rendering is not available on a paged world");
+        }
+
+        GBuffer gbuffer;
+        Image preview = camera.renderScene3DLight_Preview(imageWidth, imageHeight, objects.getValues(), lights.getValues(), samplesPerPixel, gbuffer);
+        return denoiser.denoise(preview, gbuffer);
+    }
+
+    const LightmapSet& World::bakeLightmaps(double texelSize, double planeExtent) {
+        if (pager) {
+            throw std::logic_error("Lightmap baking is not available on a paged world");
+        }
+
+        auto lightmaps = std::make_shared<const LightmapSet>(LightmapSet::bake(objects.getValues(), lights.getValues(), texelSize, planeExtent));
+        camera.setLightmaps(lightmaps);
+        bakedLightmaps = lightmaps;
+        lightmapTexelSize = texelSize;
+        lightmapPlaneExtent = planeExtent;
+        lightmapVersion = version;
+        return *lightmaps;
+    }
+
+    void World::saveLightmaps(const std::string& filePath) const {
+        if (!camera.getLightmaps()) {
+            throw std::logic_error("No lightmaps to save");
+        }
+        camera.getLightmaps()->save(filePath);
+    }
+
+    void World::loadLightmaps(const std::string& filePath) {
+        if (pager) {
+            throw std::logic_error("Lightmaps are not available on a paged world");
+        }
+
+        auto lightmaps = std::make_shared<const LightmapSet>(LightmapSet::load(filePath));
+        if (!lightmaps->matches(objects.getValues(), lights.getValues())) {
+            throw std::runtime_error("Lightmap file was baked from another scene: " + filePath);
+        }
+        camera.setLightmaps(lightmaps);
+    }
+
+    const ShadowMapSet& World::bakeShadowMaps(size_t resolution) {
+        if (pager) {
+            throw std::logic_error("Shadow maps are not available on a paged world");
+        }
+
+        auto shadowMaps = std::make_shared<const ShadowMapSet>(ShadowMapSet::build(objects.getValues(), lights.getValues(), resolution));
+        camera.setShadowMaps(shadowMaps);
+        bakedShadowMaps = shadowMaps;
+        shadowMapVersion = version;
+        return *shadowMaps;
+    }
+
+    RenderSchedule World::autotune(size_t imageWidth, size_t imageHeight) {
+        if (pager) {
+            throw std::logic_error("Render autotuning is not available on a paged world");
+        }
+
+        RenderSchedule schedule = autotuner.tune(camera, objects.getValues(), lights.getValues(), imageWidth, imageHeight);
+        camera.setRenderSchedule(schedule);
+        return schedule;
     }
 
 } // namespace rendering
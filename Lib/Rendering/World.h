@@ -20,54 +20,231 @@
 #include "./Shape.hpp"
 #include "./Camera.h"
 #include "./Light.h"
+#include "./ScenePager.h"
+#include "./RenderPlanner.h"
+#include "./RenderAutotuner.h"
+#include "./TemporalAccumulator.h"
+#include "./Denoiser.h"
+#include "./Lightmap.h"
+#include "./ShadowMap.h"
+#include "./DynamicBVH.h"
+#include "./SlotMap.hpp"
+#include "./SceneChanges.h"
 
 #include <variant>
 #include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
 
 namespace rendering {
 
+    /**
+     * @class World
+     * @brief The objects, lights and camera of a scene.
+     *
+     * Objects and lights are kept in slot maps: adding or removing one is O(1) and returns or takes
+     * a handle that stays valid until the object or light is removed, while the renderers iterate
+     * over packed storage. Indices address that packed storage and are only valid until the next
+     * removal, which moves the last object (or light) into the freed index.
+     *
+     * Every edit of an object or a light bumps the version of the world and is recorded per object
+     * and per light by kind (geometry, material, transform), see getChanges. Objects of a page file
+     * are not tracked.
+     */
     class World {
-    public:  
+    public:
+        using ObjectHandle = SlotHandle;
+        using LightHandle = SlotHandle;
+
         World();
 
         /**
          * Add an object to the world
          * @tparam T The geometry type of the shape to add
          * @param shape The shape to add
+         * @return The handle of the object
          */
         template<typename T>
-        void addObject(const Shape<T>& shape);
+        ObjectHandle addObject(const Shape<T>& shape);
 
         /**
          * Remove an object from the world
+         * @param handle The handle of the object
+         * @throws std::out_of_range if the object was already removed
+         */
+        void removeObject(ObjectHandle handle);
+
+        /**
+         * Remove an object from the world, the last object takes its index
          * @param index The index of the shape to remove
+         * @throws std::out_of_range if index is out of bounds
          */
         void removeObjectAt(const size_t index);
 
+        /**
+         * Replace an object of the world, typically by a moved copy of it
+         * Only the ancestors of the object in the spatial index are refitted.
+         * @tparam T The geometry type of the new shape
+         * @param handle The handle of the object
+         * @param shape The new shape
+         * @throws std::out_of_range if the object was removed
+         */
+        template<typename T>
+        void setObject(ObjectHandle handle, const Shape<T>& shape);
+
+        /**
+         * Change the material of an object, its geometry and the spatial index are left untouched
+         * @param handle The handle of the object
+         * @param material The new material
+         * @throws std::out_of_range if the object was removed
+         */
+        void setObjectMaterial(ObjectHandle handle, const Material& material);
+
+        /**
+         * Translate an object, recorded as a transform change
+         * @param handle The handle of the object
+         * @param offset The translation
+         * @throws std::out_of_range if the object was removed
+         */
+        void moveObject(ObjectHandle handle, const Vector3D& offset);
+
+        /**
+         * Replace an object of the world by index
+         * @tparam T The geometry type of the new shape
+         * @param index The index of the shape to replace
+         * @param shape The new shape
+         * @throws std::out_of_range if index is out of bounds
+         */
+        template<typename T>
+        void setObjectAt(size_t index, const Shape<T>& shape);
+
+        /**
+         * Get an object of the world
+         * @param handle The handle of the object
+         * @return The shape
+         * @throws std::out_of_range if the object was removed
+         */
+        const Camera::ShapeVariant& getObject(ObjectHandle handle) const { return objects.get(handle); }
+
+        /**
+         * Get an object of the world
+         * @param index The index of the shape
+         * @return The shape
+         * @throws std::out_of_range if index is out of bounds
+         */
+        const Camera::ShapeVariant& getObjectAt(size_t index) const;
+
+        /**
+         * Get the handle of the object at an index, e.g. the shapeIndex of a hit
+         * @param index The index of the shape
+         * @return The handle of the object
+         * @throws std::out_of_range if index is out of bounds
+         */
+        ObjectHandle getObjectHandleAt(size_t index) const;
+
+        /**
+         * Check if a handle refers to an object of the world
+         * @param handle The handle
+         * @return False once the object is removed
+         */
+        bool containsObject(ObjectHandle handle) const { return objects.contains(handle); }
+
+        /**
+         * Find the closest object hit by a ray, through the spatial index of the objects in memory
+         * @param ray The ray
+         * @return The closest hit, its shapeIndex being the index of the object, nullopt if none is hit
+         */
+        std::optional<Hit> findClosestHit(const Ray& ray) const;
+
+        /**
+         * Get the spatial index of the bounded objects in memory
+         * @return The bounding volume hierarchy, kept up to date as objects are added, moved and removed
+         */
+        const DynamicBVH& getObjectIndex() const { return objectIndex; }
+
         /**
          * Add a light to the world
          * @param light The light to add
+         * @return The handle of the light
          */
-        void addLight(const Light& light);
+        LightHandle addLight(const Light& light);
+
+        /**
+         * Replace a light, recorded as a transform change if it moved and a material change if its
+         * color or intensity changed
+         * @param handle The handle of the light
+         * @param light The new light
+         * @throws std::out_of_range if the light was removed
+         */
+        void setLight(LightHandle handle, const Light& light);
 
         /**
          * Remove a light from the world
+         * @param handle The handle of the light
+         * @throws std::out_of_range if the light was already removed
+         */
+        void removeLight(LightHandle handle);
+
+        /**
+         * Remove the first light equal to a light, searching linearly
          * @param light The light to remove
          */
         void removeLight(const Light& light);
 
         /**
-         * Remove a light from the world
+         * Remove a light from the world, the last light takes its index
          * @param index The index of the light to remove
+         * @throws std::out_of_range if index is out of bounds
          */
         void removeLightAt(const size_t& index);
 
+        /**
+         * Get a light of the world
+         * @param handle The handle of the light
+         * @return The light
+         * @throws std::out_of_range if the light was removed
+         */
+        const Light& getLight(LightHandle handle) const { return lights.get(handle); }
+
+        bool containsLight(LightHandle handle) const { return lights.contains(handle); }
+        size_t getLightCount() const { return lights.size(); }
+
+        /**
+         * Get the version of the world, bumped by every change of its objects and lights
+         * @return The version, 0 for a world never changed
+         */
+        uint64_t getVersion() const { return version; }
+
+        /**
+         * Get what changed since a version, typically the version of the previous frame
+         * Costs O(1) when nothing changed, a scan of the version counters otherwise.
+         * @param sinceVersion The version to compare with
+         * @return The objects and lights added or changed since then, and whether some were removed
+         */
+        SceneChangeSet getChanges(uint64_t sinceVersion) const;
+
+        /**
+         * Bring the caches of the camera up to date with the changes since the previous update
+         * Does nothing for camera only animations. Shadow maps baked by bakeShadowMaps are rendered
+         * again for the lights that moved alone when only lights changed, in full otherwise; lightmaps
+         * baked by bakeLightmaps are baked again and the irradiance cache is reset after any change.
+         * The spatial index of the objects needs no update, it follows every edit.
+         */
+        void updateCaches();
+
         /**
          * Get the number of objects in the world
          * @return The number of objects
          */
         size_t getObjectCount() const;
 
+        /**
+         * Get the objects of the world, packed, in the order of getObjectAt
+         * @return The objects, valid until the next edit
+         */
+        const math::Vector<Camera::ShapeVariant>& getObjects() const { return objects.getValues(); }
+
         /**
          * Get the camera
          * @return Reference to the camera
@@ -80,11 +257,41 @@ namespace rendering {
          */
         void clearObjects();
 
+        /**
+         * Move the objects of the world to a page file and render them out-of-core from now on
+         * The objects are written to filePath, removed from memory and paged back on demand while
+         * rendering, within memoryBudget bytes. Objects added afterwards stay in memory.
+         * @param filePath The page file to write
+         * @param memoryBudget The maximum size of the decoded pages in bytes
+         * @param shapesPerPage The number of shapes per page
+         */
+        void pageObjectsToFile(const std::string& filePath, size_t memoryBudget, size_t shapesPerPage = ScenePageWriter::DEFAULT_SHAPES_PER_PAGE);
+
+        /**
+         * Render out-of-core from an existing page file
+         * @param filePath The page file written by ScenePageWriter
+         * @param memoryBudget The maximum size of the decoded pages in bytes
+         */
+        void loadPagedObjects(const std::string& filePath, size_t memoryBudget);
+
+        /**
+         * Check if part of the scene is paged from disk
+         * @return True if a page file is attached
+         */
+        bool isPaged() const { return pager != nullptr; }
+
+        /**
+         * Get the pager of the world
+         * @return The pager, null if the world is not paged
+         */
+        ScenePager* getPager() const { return pager.get(); }
+
         /**
          * Render the scene from the camera's perspective
          * @param imageWidth The width of the output image in pixels
          * @param imageHeight The height of the output image in pixels
          * @return Image The rendered image
+         * @throws std::logic_error if the world is paged
          */
         Image renderScene2DColor(size_t imageWidth, size_t imageHeight) const;
 
@@ -93,6 +300,7 @@ namespace rendering {
          * @param imageWidth The width of the output image in pixels
          * @param imageHeight The height of the output image in pixels
          * @return Image The rendered depth map image
+         * @throws std::logic_error if the world is paged
          */
         Image renderScene2DDepth(size_t imageWidth, size_t imageHeight) const;
 
@@ -120,14 +328,146 @@ namespace rendering {
          */
         Image renderScene3DLight(size_t imageWidth, size_t imageHeight) const;
 
+        /**
+         * Describe a lit render of the world for a RenderPlanner
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param samplesPerPixel The number of anti-aliasing samples per pixel
+         * @param method The anti-aliasing method
+         * @param frameCount The number of frames of the animation, 1 for a still image
+         * @return RenderRequest The request, with the scene size of the world
+         */
+        RenderRequest makeRenderRequest(size_t imageWidth, size_t imageHeight, size_t samplesPerPixel, Camera::AntiAliasingMethod method, size_t frameCount = 1) const;
+
+        /**
+         * Render the scene with light lighting and the anti-aliasing options of a plan
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param plan The plan returned by RenderPlanner::plan
+         * @return Image The rendered image
+         * @throws std::logic_error if the world is paged
+         */
+        Image renderScene3DLight(size_t imageWidth, size_t imageHeight, const RenderPlan& plan) const;
+
+        /**
+         * Tune the render schedule of the camera for lit renders of the world at a resolution
+         * The first call for a scene and resolution benchmarks a low resolution render, later calls
+         * reuse the cached result until the scene or the camera changes.
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @return RenderSchedule The schedule now used by the camera
+         * @throws std::logic_error if the world is paged
+         */
+        RenderSchedule autotune(size_t imageWidth, size_t imageHeight);
+
+        /**
+         * Render the next frame of a camera animation, reusing the history of the previous frames
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param accumulator The history of the animation, updated with this frame
+         * @return Image The rendered image
+         * @throws std::logic_error if the world is paged
+         */
+        Image renderScene3DLight(size_t imageWidth, size_t imageHeight, TemporalAccumulator& accumulator) const;
+
+        /**
+         * Render a low sample preview of the scene and filter it with its G-buffer
+         * @param imageWidth The width of the output image in pixels
+         * @param imageHeight The height of the output image in pixels
+         * @param samplesPerPixel The number of samples per pixel of the preview
+         * @param denoiser The filter to apply
+         * @return Image The filtered image
+         * @throws std::logic_error if the world is paged
+         */
+        Image renderScene3DLightDenoised(size_t imageWidth, size_t imageHeight, size_t samplesPerPixel, const Denoiser& denoiser) const;
+
+        /**
+         * Bake the direct lighting of the planes, rectangles and circles of the world for the camera
+         * Lit renders look the baked lighting up until the objects or lights change.
+         * @param texelSize The spacing of the lightmap texels in world units
+         * @param planeExtent The half side of the baked square of infinite planes
+         * @return The baked lightmaps, now used by the camera
+         * @throws std::invalid_argument if texelSize or planeExtent is not positive
+         * @throws std::logic_error if the world is paged
+         */
+        const LightmapSet& bakeLightmaps(double texelSize, double planeExtent = LightmapSet::DEFAULT_PLANE_EXTENT);
+
+        /**
+         * Write the lightmaps of the camera to disk
+         * @param filePath The lightmap file to write
+         * @throws std::logic_error if no lightmaps are set
+         * @throws std::runtime_error if the file cannot be written
+         */
+        void saveLightmaps(const std::string& filePath) const;
+
+        /**
+         * Load lightmaps baked from this world and use them for the camera
+         * @param filePath The lightmap file written by saveLightmaps
+         * @throws std::runtime_error if the file cannot be read or was baked from another scene
+         * @throws std::logic_error if the world is paged
+         */
+        void loadLightmaps(const std::string& filePath);
+
+        /**
+         * Build the shadow maps of the lights of a static world once, for SHADOW_MAPPED renders of the camera
+         * Renders reuse them until the objects or lights change, then build their own again.
+         * @param resolution The texels per side of each cube face
+         * @return The shadow maps, now used by the camera
+         * @throws std::invalid_argument if resolution is zero
+         * @throws std::logic_error if the world is paged
+         */
+        const ShadowMapSet& bakeShadowMaps(size_t resolution = ShadowMapSet::DEFAULT_RESOLUTION);
+
+        /**
+         * Get the autotuner of the world and its cache of tuned schedules
+         * @return Reference to the autotuner
+         */
+        RenderAutotuner& getAutotuner() { return autotuner; }
+
 
     private:
         using ShapeVariant = std::variant<Shape<geometry::Box>, Shape<geometry::Circle>, Shape<geometry::Plane>, Shape<geometry::Rectangle>, Shape<geometry::Sphere>>;
-        math::Vector<ShapeVariant> objects;
+        SlotMap<ShapeVariant> objects;
+
+        /// Where an object is indexed, either proxy or unbounded is set
+        struct IndexEntry {
+            size_t proxy = DynamicBVH::NONE;        ///< Proxy of the object in objectIndex
+            size_t unbounded = DynamicBVH::NONE;    ///< Position of the object in unboundedObjects
+        };
+
+        DynamicBVH objectIndex;                 ///< Bounded objects, refitted as they move
+        math::Vector<IndexEntry> objectEntries; ///< Entry of each object, in the order of the objects
+        math::Vector<size_t> unboundedObjects;  ///< Objects outside objectIndex, tested by every ray
 
-        math::Vector<Light> lights;
+        SlotMap<Light> lights;
+
+        uint64_t version = 0;                           ///< Bumped by every change of the objects and lights
+        math::Vector<ChangeVersions> objectVersions;    ///< Versions of each object, in the order of the objects
+        math::Vector<ChangeVersions> lightVersions;     ///< Versions of each light, in the order of the lights
+        uint64_t objectsRemovedVersion = 0;
+        uint64_t lightsRemovedVersion = 0;
+
+        std::shared_ptr<const ShadowMapSet> bakedShadowMaps;   ///< Shadow maps of bakeShadowMaps, kept up by updateCaches
+        std::shared_ptr<const LightmapSet> bakedLightmaps;     ///< Lightmaps of bakeLightmaps, kept up by updateCaches
+        double lightmapTexelSize = 0.0;
+        double lightmapPlaneExtent = 0.0;
+        uint64_t shadowMapVersion = 0;                  ///< Version of the scene of bakedShadowMaps
+        uint64_t lightmapVersion = 0;                   ///< Version of the scene of bakedLightmaps
+        uint64_t irradianceVersion = 0;                 ///< Version the irradiance cache was last reset at
+
+        std::shared_ptr<ScenePager> pager;   ///< Out-of-core objects, null if the world is not paged
 
         Camera camera;
+
+        RenderAutotuner autotuner;   ///< Tuned render schedules per scene and resolution
+
+        void indexObject(size_t index);
+        void reindexObject(size_t index);
+        void unindexObject(size_t index);
+        void removeUnbounded(size_t position);
+        ChangeKind replacementChanges(size_t index, const ShapeVariant& replacement) const;
+        void recordObjectChange(size_t index, ChangeKind kinds);
+        void clearObjectIndex();
     };
 
 } // namespace rendering
@@ -136,8 +476,29 @@ namespace rendering {
 namespace rendering {
 
     template<typename T>
-    void World::addObject(const Shape<T>& shape) {
-        objects.append(ShapeVariant{shape});
+    World::ObjectHandle World::addObject(const Shape<T>& shape) {
+        ObjectHandle handle = objects.insert(ShapeVariant{shape});
+        indexObject(objects.size() - 1);
+        objectVersions.append(ChangeVersions());
+        recordObjectChange(objects.size() - 1, ChangeKind::ADDED);
+        return handle;
+    }
+
+    template<typename T>
+    void World::setObject(ObjectHandle handle, const Shape<T>& shape) {
+        setObjectAt(objects.indexOf(handle), shape);
+    }
+
+    template<typename T>
+    void World::setObjectAt(size_t index, const Shape<T>& shape) {
+        if (index >= objects.size()) {
+            throw std::out_of_range("Object index out of bounds");
+        }
+        ShapeVariant replacement{shape};
+        ChangeKind kinds = replacementChanges(index, replacement);
+        objects[index] = std::move(replacement);
+        reindexObject(index);
+        recordObjectChange(index, kinds);
     }
 
 }
@@ -0,0 +1,301 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../Lib/Physics/BroadPhase.h"
+
+using namespace physics;
+using namespace geometry;
+
+// Test function declarations
+void testBounds();
+void testShapeOverlaps();
+void testPairsMatchBruteForce();
+void testSweptBodies();
+void testRemoveAndReuse();
+void testErrors();
+void testLargeScene();
+
+namespace {
+
+    BodyShape randomShape(std::mt19937& rng, double extent, double size) {
+        std::uniform_real_distribution<double> position(-extent, extent);
+        std::uniform_real_distribution<double> scale(0.2 * size, size);
+        std::uniform_real_distribution<double> direction(-1.0, 1.0);
+        Vector3D at(position(rng), position(rng), position(rng));
+        switch (rng() % 3) {
+            case 0:
+                return Box(at, scale(rng), scale(rng), scale(rng), Vector3D(0, 0, 1));
+            case 1:
+                return Sphere(at, scale(rng));
+            default: {
+                Vector3D normal(direction(rng), direction(rng), direction(rng) + 2.0);
+                return Circle(at, scale(rng), normal.normal());
+            }
+        }
+    }
+
+    BodyShape moved(const BodyShape& shape, const Vector3D& offset) {
+        if (const Box* box = std::get_if<Box>(&shape)) {
+            return box->translate(offset);
+        }
+        if (const Circle* circle = std::get_if<Circle>(&shape)) {
+            return Circle(circle->getCenter() + offset, circle->getRadius(), circle->getNormal());
+        }
+        Sphere sphere = std::get<Sphere>(shape);
+        sphere.translate(offset);
+        return sphere;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> sorted(const math::Vector<BodyPair>& pairs) {
+        std::vector<std::pair<uint32_t, uint32_t>> result;
+        for (const BodyPair& pair : pairs) {
+            assert(pair.first < pair.second);
+            result.emplace_back(pair.first, pair.second);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+}
+
+int main() {
+    std::cout << "Running BroadPhase tests..." << std::endl;
+
+    try {
+        testBounds();
+        std::cout << "✓ Bounds tests passed" << std::endl;
+
+        testShapeOverlaps();
+        std::cout << "✓ Shape overlap tests passed" << std::endl;
+
+        testPairsMatchBruteForce();
+        std::cout << "✓ Brute force comparison tests passed" << std::endl;
+
+        testSweptBodies();
+        std::cout << "✓ Swept body tests passed" << std::endl;
+
+        testRemoveAndReuse();
+        std::cout << "✓ Remove and reuse tests passed" << std::endl;
+
+        testErrors();
+        std::cout << "✓ Error tests passed" << std::endl;
+
+        testLargeScene();
+        std::cout << "✓ Large scene tests passed" << std::endl;
+
+        std::cout << "All BroadPhase tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+void testBounds() {
+    Bounds3D sphere = BroadPhase::boundsOf(Sphere(Vector3D(1, 2, 3), 2.0));
+    assert(sphere.low[0] == -1.0 && sphere.high[2] == 5.0);
+
+    Bounds3D box = BroadPhase::boundsOf(Box(Vector3D(0, 0, 0), 1.0, 2.0, 3.0, Vector3D(0, 0, 1)));
+    assert(box.low[0] == 0.0 && box.high[0] == 1.0 && box.high[1] == 2.0 && box.high[2] == 3.0);
+
+    // A disk facing z is flat along z
+    Bounds3D disk = BroadPhase::boundsOf(Circle(Vector3D(0, 0, 0), 2.0, Vector3D(0, 0, 1)));
+    assert(disk.low[0] == -2.0 && disk.high[1] == 2.0);
+    assert(disk.low[2] == 0.0 && disk.high[2] == 0.0);
+
+    Bounds3D swept = sphere.swept(Vector3D(3, -1, 0));
+    assert(swept.low[0] == -4.0 && swept.high[0] == 3.0);
+    assert(swept.low[1] == 0.0 && swept.high[1] == 5.0);
+    assert(swept.overlaps(sphere));
+    assert(!sphere.overlaps(BroadPhase::boundsOf(Sphere(Vector3D(10, 0, 0), 1.0))));
+}
+
+void testShapeOverlaps() {
+    Sphere a(Vector3D(0, 0, 0), 1.0);
+    Sphere b(Vector3D(1.5, 0, 0), 1.0);
+    Sphere far(Vector3D(3, 0, 0), 0.5);
+    assert(BroadPhase::overlaps(a, b));
+    assert(!BroadPhase::overlaps(a, far));
+
+    Box box(Vector3D(2, 2, 2), 1.0, 1.0, 1.0, Vector3D(0, 0, 1));
+    // The box corner is sqrt(12) away from the sphere center, its bounds are not
+    assert(!BroadPhase::overlaps(Sphere(Vector3D(0, 0, 0), 3.0), box));
+    assert(BroadPhase::overlaps(box, Sphere(Vector3D(0, 0, 0), 3.5)));
+    assert(BroadPhase::overlaps(box, Box(Vector3D(2.5, 2.5, 2.5), 2.0, 2.0, 2.0, Vector3D(0, 0, 1))));
+    assert(!BroadPhase::overlaps(box, Box(Vector3D(3.5, 2, 2), 1.0, 1.0, 1.0, Vector3D(0, 0, 1))));
+
+    Circle disk(Vector3D(0, 0, 0), 2.0, Vector3D(0, 0, 1));
+    assert(BroadPhase::overlaps(disk, Sphere(Vector3D(1, 1, 0.5), 0.6)));
+    // Above the rim of the disk, inside its bounds
+    assert(!BroadPhase::overlaps(disk, Sphere(Vector3D(2, 2, 0), 0.5)));
+    assert(!BroadPhase::overlaps(Sphere(Vector3D(0, 0, 1), 0.5), disk));
+    assert(BroadPhase::overlaps(disk, Box(Vector3D(1, 1, -1), 1.0, 1.0, 2.0, Vector3D(0, 0, 1))));
+    assert(!BroadPhase::overlaps(disk, Box(Vector3D(1, 1, 0.5), 1.0, 1.0, 1.0, Vector3D(0, 0, 1))));
+
+    Circle crossing(Vector3D(0, 0, 0), 1.0, Vector3D(1, 0, 0));
+    Circle parallel(Vector3D(0, 0, 1), 2.0, Vector3D(0, 0, 1));
+    assert(BroadPhase::overlaps(disk, crossing));
+    assert(!BroadPhase::overlaps(disk, parallel));
+}
+
+void testPairsMatchBruteForce() {
+    std::mt19937 rng(7);
+    BroadPhase broadPhase;
+    std::vector<BodyShape> shapes;
+    for (int i = 0; i < 2000; ++i) {
+        shapes.push_back(randomShape(rng, 20.0, 1.5));
+        assert(broadPhase.addBody(shapes.back()) == static_cast<size_t>(i));
+    }
+
+    for (int step = 0; step < 3; ++step) {
+        std::vector<std::pair<uint32_t, uint32_t>> expectedCandidates, expectedContacts;
+        for (uint32_t i = 0; i < shapes.size(); ++i) {
+            for (uint32_t j = i + 1; j < shapes.size(); ++j) {
+                if (BroadPhase::boundsOf(shapes[i]).overlaps(BroadPhase::boundsOf(shapes[j]))) {
+                    expectedCandidates.emplace_back(i, j);
+                    if (BroadPhase::overlaps(shapes[i], shapes[j])) {
+                        expectedContacts.emplace_back(i, j);
+                    }
+                }
+            }
+        }
+
+        const math::Vector<BodyPair>& candidates = broadPhase.findPairs();
+        assert(sorted(candidates) == expectedCandidates);
+
+        // The vectorized blocks agree with the pairwise tests, in the order of the candidates
+        math::Vector<BodyPair> contacts;
+        size_t count = broadPhase.narrowPhase(candidates, contacts);
+        assert(count == contacts.size());
+        assert(sorted(contacts) == expectedContacts);
+        size_t next = 0;
+        for (const BodyPair& candidate : candidates) {
+            if (next < contacts.size() && contacts[next] == candidate) {
+                ++next;
+            }
+        }
+        assert(next == contacts.size());
+
+        // Small moves, the order is repaired without a full sort
+        size_t fullSorts = broadPhase.getFullSortCount();
+        for (size_t i = 0; i < shapes.size(); ++i) {
+            shapes[i] = moved(shapes[i], Vector3D(0.05 * step, -0.03, 0.02));
+            broadPhase.setBody(i, shapes[i]);
+        }
+        broadPhase.findPairs();
+        assert(broadPhase.getFullSortCount() == fullSorts);
+    }
+}
+
+void testSweptBodies() {
+    BroadPhase broadPhase;
+    size_t wall = broadPhase.addBody(Box(Vector3D(5, -5, -5), 0.1, 10.0, 10.0, Vector3D(1, 0, 0)));
+    // The bullet ends a step on the far side of the wall
+    size_t bullet = broadPhase.addBody(Sphere(Vector3D(10, 0, 0), 0.1));
+    assert(broadPhase.findPairs().size() == 0);
+
+    broadPhase.setBody(bullet, Sphere(Vector3D(10, 0, 0), 0.1), Vector3D(10, 0, 0));
+    const math::Vector<BodyPair>& pairs = broadPhase.findPairs();
+    assert(pairs.size() == 1);
+    assert(pairs[0] == (BodyPair{static_cast<uint32_t>(wall), static_cast<uint32_t>(bullet)}));
+    assert(broadPhase.getBounds(bullet).low[0] < 0.0);
+}
+
+void testRemoveAndReuse() {
+    BroadPhase broadPhase;
+    size_t a = broadPhase.addBody(Sphere(Vector3D(0, 0, 0), 1.0));
+    size_t b = broadPhase.addBody(Sphere(Vector3D(1, 0, 0), 1.0));
+    size_t c = broadPhase.addBody(Sphere(Vector3D(2, 0, 0), 1.0));
+    assert(broadPhase.findPairs().size() == 3);
+
+    broadPhase.removeBody(b);
+    assert(!broadPhase.containsBody(b));
+    assert(broadPhase.getBodyCount() == 2);
+    const math::Vector<BodyPair>& pairs = broadPhase.findPairs();
+    assert(pairs.size() == 1);
+    assert(pairs[0] == (BodyPair{static_cast<uint32_t>(a), static_cast<uint32_t>(c)}));
+
+    size_t d = broadPhase.addBody(Box(Vector3D(10, 10, 10), 1.0, 1.0, 1.0, Vector3D(0, 0, 1)));
+    assert(d == b);
+    assert(std::holds_alternative<Box>(broadPhase.getShape(d)));
+    assert(broadPhase.findPairs().size() == 1);
+}
+
+void testErrors() {
+    BroadPhase broadPhase;
+    assert(broadPhase.findPairs().size() == 0);
+    size_t id = broadPhase.addBody(Sphere(Vector3D(0, 0, 0), 1.0));
+
+    bool caught = false;
+    try {
+        broadPhase.setBody(id + 1, Sphere(Vector3D(0, 0, 0), 1.0));
+    } catch (const std::out_of_range&) {
+        caught = true;
+    }
+    assert(caught);
+
+    broadPhase.removeBody(id);
+    caught = false;
+    try {
+        broadPhase.removeBody(id);
+    } catch (const std::out_of_range&) {
+        caught = true;
+    }
+    assert(caught);
+
+    caught = false;
+    try {
+        broadPhase.getShape(id);
+    } catch (const std::out_of_range&) {
+        caught = true;
+    }
+    assert(caught);
+}
+
+void testLargeScene() {
+    // 100k bodies at a density of a few neighbours each
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> velocity(-0.5, 0.5);
+    const size_t count = 100000;
+    BroadPhase broadPhase;
+    std::vector<BodyShape> shapes;
+    std::vector<Vector3D> velocities;
+    shapes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        shapes.push_back(randomShape(rng, 100.0, 1.5));
+        velocities.emplace_back(velocity(rng), velocity(rng), velocity(rng));
+        broadPhase.addBody(shapes.back());
+    }
+    broadPhase.findPairs();
+
+    const int steps = 5;
+    double broadTime = 0.0, narrowTime = 0.0;
+    size_t candidateCount = 0, contactCount = 0;
+    math::Vector<BodyPair> contacts;
+    for (int step = 0; step < steps; ++step) {
+        for (size_t i = 0; i < count; ++i) {
+            Vector3D displacement = velocities[i] * 0.1;
+            shapes[i] = moved(shapes[i], displacement);
+            broadPhase.setBody(i, shapes[i], displacement);
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        const math::Vector<BodyPair>& candidates = broadPhase.findPairs();
+        auto middle = std::chrono::high_resolution_clock::now();
+        contactCount = broadPhase.narrowPhase(candidates, contacts);
+        auto end = std::chrono::high_resolution_clock::now();
+        candidateCount = candidates.size();
+        broadTime += std::chrono::duration<double, std::milli>(middle - start).count();
+        narrowTime += std::chrono::duration<double, std::milli>(end - middle).count();
+        assert(contactCount <= candidateCount);
+    }
+    assert(candidateCount > 0 && contactCount > 0);
+
+    std::cout << "  " << count << " bodies: " << candidateCount << " candidates, " << contactCount
+              << " contacts, broad phase " << broadTime / steps << " ms, narrow phase "
+              << narrowTime / steps << " ms per step" << std::endl;
+}
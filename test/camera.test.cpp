@@ -51,6 +51,7 @@ void testCameraRenderScene3DColor();
 void testCameraRenderScene3DDepth();
 void testCameraRenderScene3DLight();
 void testCameraRenderScene3DLight_AA();
+void testCameraRenderScene3DLight_MSAA();
 void testCameraRenderScene3DAdvanced();
 
 int main() {
@@ -96,6 +97,9 @@ int main() {
         testCameraRenderScene3DLight_AA();
         std::cout << "✓ Camera render scene 3D light anti-aliasing tests passed" << std::endl;
 
+        testCameraRenderScene3DLight_MSAA();
+        std::cout << "✓ Camera render scene 3D light multisampling tests passed" << std::endl;
+
         testCameraRenderScene3DAdvanced();
         std::cout << "✓ Camera render scene 3D advanced tests passed" << std::endl;
 
@@ -140,6 +144,12 @@ void testCameraConstructor() {
     assert(isEqual(storedViewport.getWidth(), (bottomLeft - topLeft).length()));
     Vector3D expectedNormal = (topRight - topLeft).cross(bottomLeft - topLeft).normal();
     assert(isEqual(storedViewport.getNormal(), expectedNormal));
+
+    // Test default constructor, a unit viewport at the origin
+    Camera defaultCamera;
+    assert(isEqual(defaultCamera.getViewport().getOrigin(), Vector3D(0, 0, 0)));
+    assert(isEqual(defaultCamera.getViewportLength(), 1.0));
+    assert(isEqual(defaultCamera.getViewportWidth(), 1.0));
 }
 
 void testCameraViewportOperations() {
@@ -1035,6 +1045,57 @@ void testCameraRenderScene3DLight_AA() {
     
 }
 
+void testCameraRenderScene3DLight_MSAA() {
+    Vector3D origin(-10, -10, -5);
+    Rectangle viewport(origin, origin + Vector3D(20.0, 0, 0), origin + Vector3D(0, 20.0, 0));
+    Camera camera(viewport);
+    const RGBA_Color debugColor(1.0, 0.0, 1.0, 1.0);
+
+    math::Vector<Light> lights(1);
+    lights[0] = Light(Vector3D(0, 5, -5), RGBA_Color(1.0, 1.0, 1.0, 1.0), 1.0);
+
+    // A wall covering every sample: shaded once at the pixel sample point, like the render without anti-aliasing
+    math::Vector<Camera::ShapeVariant> wall(1);
+    wall[0] = Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.2, 0.8, 1.0));
+    Image reference = camera.renderScene3DLight(32, 32, wall, lights);
+    Image multisampled = camera.renderScene3DLight_AA(32, 32, wall, lights, 8UL, Camera::AntiAliasingMethod::MSAA);
+    Image referenceAdvanced = camera.renderScene3DLight_Advanced(32, 32, wall, lights);
+    Image multisampledAdvanced = camera.renderScene3DLight_Advanced_AA(32, 32, wall, lights, 8UL, Camera::AntiAliasingMethod::MSAA);
+    for (size_t y = 0; y < 32; ++y) {
+        for (size_t x = 0; x < 32; ++x) {
+            assert(multisampled.getPixel(x, y) == reference.getPixel(x, y));
+            assert(multisampledAdvanced.getPixel(x, y) == referenceAdvanced.getPixel(x, y));
+        }
+    }
+
+    // A sphere against the background: interior pixels match, edge pixels blend with the background
+    math::Vector<Camera::ShapeVariant> sphere(1);
+    sphere[0] = Shape<Sphere>(Sphere(Vector3D(0, 0, 0), 4.0), RGBA_Color(1.0, 1.0, 1.0, 1.0));
+    reference = camera.renderScene3DLight(32, 32, sphere, lights);
+    multisampled = camera.renderScene3DLight_MSAA(32, 32, sphere, lights, 8);
+    size_t sameCount = 0, blendedCount = 0;
+    for (size_t y = 0; y < 32; ++y) {
+        for (size_t x = 0; x < 32; ++x) {
+            RGBA_Color pixel = multisampled.getPixel(x, y);
+            if (pixel == reference.getPixel(x, y)) {
+                ++sameCount;
+            } else if (pixel != debugColor) {
+                ++blendedCount;
+            }
+        }
+    }
+    assert(blendedCount > 0);
+    assert(sameCount > blendedCount);
+
+    bool exceptionThrown = false;
+    try {
+        camera.renderScene3DLight_MSAA(32, 32, sphere, lights, 0);
+    } catch (const std::invalid_argument&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+}
+
 void testCameraRenderScene3DAdvanced() {
     RenderLogger logger("scene3D_advanced");
 
@@ -0,0 +1,439 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include "../Lib/Rendering/DynamicBVH.h"
+#include "../Lib/Rendering/World.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testBounds();
+void testInsertRemove();
+void testClosestHitMatchesLinear();
+void testRefitAndSubtreeRebuild();
+void testQuery();
+void testAnimationCost();
+void testWorldIndex();
+void testArguments();
+
+int main() {
+    std::cout << "Running DynamicBVH tests..." << std::endl;
+
+    try {
+        testBounds();
+        std::cout << "✓ Bounds tests passed" << std::endl;
+
+        testInsertRemove();
+        std::cout << "✓ Insert and remove tests passed" << std::endl;
+
+        testClosestHitMatchesLinear();
+        std::cout << "✓ Closest hit tests passed" << std::endl;
+
+        testRefitAndSubtreeRebuild();
+        std::cout << "✓ Refit and subtree rebuild tests passed" << std::endl;
+
+        testQuery();
+        std::cout << "✓ Query tests passed" << std::endl;
+
+        testAnimationCost();
+        std::cout << "✓ Animation cost tests passed" << std::endl;
+
+        testWorldIndex();
+        std::cout << "✓ World index tests passed" << std::endl;
+
+        testArguments();
+        std::cout << "✓ Argument tests passed" << std::endl;
+
+        std::cout << "All DynamicBVH tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+static Camera::ShapeVariant sphereAt(const Vector3D& center, double radius) {
+    return Shape<Sphere>(Sphere(center, radius), RGBA_Color(1, 1, 1, 1));
+}
+
+// Spheres scattered in a cube of side extent
+static math::Vector<Camera::ShapeVariant> makeSpheres(size_t count, double extent, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> position(0.0, extent), radius(0.1, 0.5);
+    math::Vector<Camera::ShapeVariant> shapes(count);
+    for (size_t i = 0; i < count; ++i) {
+        shapes[i] = sphereAt(Vector3D(position(rng), position(rng), position(rng)), radius(rng));
+    }
+    return shapes;
+}
+
+static DynamicBVH makeTree(const math::Vector<Camera::ShapeVariant>& shapes, math::Vector<size_t>& proxies) {
+    DynamicBVH tree;
+    proxies = math::Vector<size_t>(shapes.size());
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        Bounds3D bounds;
+        assert(DynamicBVH::boundsOf(shapes[i], bounds));
+        proxies[i] = tree.insert(i, bounds);
+    }
+    return tree;
+}
+
+static Ray randomRay(std::mt19937& rng, double extent) {
+    std::uniform_real_distribution<double> position(-0.2 * extent, 1.2 * extent), direction(-1.0, 1.0);
+    Vector3D d(direction(rng), direction(rng), direction(rng));
+    if (d.length() < 1e-3) {
+        d = Vector3D(1, 0, 0);
+    }
+    return Ray(Vector3D(position(rng), position(rng), position(rng)), d.normal());
+}
+
+static bool sameHit(const std::optional<Hit>& a, const std::optional<Hit>& b) {
+    if (!a || !b) {
+        return !a && !b;
+    }
+    return a->shapeIndex == b->shapeIndex && a->t == b->t;
+}
+
+void testBounds() {
+    Bounds3D bounds;
+    assert(DynamicBVH::boundsOf(sphereAt(Vector3D(1, 2, 3), 0.5), bounds));
+    assert(bounds.low[0] == 0.5 && bounds.high[2] == 3.5);
+    assert(std::fabs(bounds.surfaceArea() - 6.0) < 1e-12);
+
+    Camera::ShapeVariant rectangle = Shape<Rectangle>(Rectangle(Vector3D(0, 0, 0), Vector3D(2, 0, 0), Vector3D(0, 3, 1)), RGBA_Color(1, 1, 1, 1));
+    assert(DynamicBVH::boundsOf(rectangle, bounds));
+    assert(bounds.low[0] == 0.0 && bounds.high[0] == 2.0 && bounds.high[1] == 3.0 && bounds.high[2] == 1.0);
+
+    // Planes are unbounded, empty shapes have no bounds
+    Camera::ShapeVariant plane = Shape<Plane>(Plane(Vector3D(0, 0, 0), Vector3D(0, 0, 1)), RGBA_Color(1, 1, 1, 1));
+    assert(!DynamicBVH::boundsOf(plane, bounds));
+    assert(!DynamicBVH::boundsOf(Camera::ShapeVariant(Shape<Sphere>()), bounds));
+
+    Bounds3D a(Vector3D(0, 0, 0), Vector3D(1, 1, 1)), b(Vector3D(2, 0, 0), Vector3D(3, 1, 1));
+    assert(!a.overlaps(b) && a.merged(b).contains(b) && a.merged(b).contains(a));
+}
+
+void testInsertRemove() {
+    DynamicBVH tree;
+    assert(tree.getLeafCount() == 0 && tree.getHeight() == 0);
+
+    math::Vector<size_t> proxies(64);
+    for (size_t i = 0; i < 64; ++i) {
+        proxies[i] = tree.insert(i, Bounds3D(Vector3D(i, 0, 0), Vector3D(i + 0.5, 1, 1)));
+    }
+    assert(tree.getLeafCount() == 64);
+    assert(tree.getHeight() <= 16);
+    for (size_t i = 0; i < 64; ++i) {
+        assert(tree.getObject(proxies[i]) == i);
+    }
+
+    // Removing keeps the other proxies valid, freed nodes are reused
+    for (size_t i = 0; i < 64; i += 2) {
+        tree.remove(proxies[i]);
+    }
+    assert(tree.getLeafCount() == 32);
+    for (size_t i = 1; i < 64; i += 2) {
+        assert(tree.getObject(proxies[i]) == i);
+        assert(tree.getBounds(proxies[i]).low[0] == double(i));
+    }
+    bool threw = false;
+    try {
+        tree.remove(proxies[0]);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    size_t reused = tree.insert(100, Bounds3D(Vector3D(0, 5, 0), Vector3D(1, 6, 1)));
+    assert(reused < 127);
+    tree.setObject(reused, 101);
+    assert(tree.getObject(reused) == 101);
+
+    for (size_t i = 1; i < 64; i += 2) {
+        tree.remove(proxies[i]);
+    }
+    tree.remove(reused);
+    assert(tree.getLeafCount() == 0 && tree.getHeight() == 0);
+}
+
+void testClosestHitMatchesLinear() {
+    const double extent = 25.0;
+    math::Vector<Camera::ShapeVariant> shapes = makeSpheres(2000, extent, 7);
+    math::Vector<size_t> proxies;
+    DynamicBVH tree = makeTree(shapes, proxies);
+
+    std::mt19937 rng(11);
+    size_t hits = 0;
+    for (int i = 0; i < 2000; ++i) {
+        Ray ray = randomRay(rng, extent);
+        std::optional<Hit> expected = Camera::findClosestHit(ray, shapes, -1);
+        assert(sameHit(tree.findClosestHit(ray, shapes), expected));
+        if (expected) {
+            ++hits;
+            // Excluding the shape hit finds the one behind it
+            int excluded = static_cast<int>(expected->shapeIndex);
+            assert(sameHit(tree.findClosestHit(ray, shapes, excluded), Camera::findClosestHit(ray, shapes, excluded)));
+        }
+    }
+    std::cout << "  " << hits << " of 2000 random rays hit" << std::endl;
+    assert(hits > 300);
+
+    // Rays along the axes divide by zero in the slab test
+    Ray axial(Vector3D(-5, 20, 20), Vector3D(1, 0, 0));
+    assert(sameHit(tree.findClosestHit(axial, shapes), Camera::findClosestHit(axial, shapes, -1)));
+
+    // Same after moving, removing and adding objects
+    std::uniform_real_distribution<double> step(-3.0, 3.0);
+    for (size_t i = 0; i < shapes.size(); i += 3) {
+        const Sphere* sphere = std::get<Shape<Sphere>>(shapes[i]).getGeometry();
+        shapes[i] = sphereAt(sphere->getCenter() + Vector3D(step(rng), step(rng), step(rng)), sphere->getRadius());
+        Bounds3D bounds;
+        DynamicBVH::boundsOf(shapes[i], bounds);
+        tree.update(proxies[i], bounds);
+    }
+    for (size_t i = 1; i < shapes.size(); i += 5) {
+        tree.remove(proxies[i]);
+        shapes[i] = Camera::ShapeVariant(Shape<Sphere>());
+    }
+    math::Vector<Camera::ShapeVariant> more = makeSpheres(300, extent, 13);
+    math::Vector<Camera::ShapeVariant> all(shapes.size() + more.size());
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        all[i] = shapes[i];
+    }
+    for (size_t i = 0; i < more.size(); ++i) {
+        all[shapes.size() + i] = more[i];
+        Bounds3D bounds;
+        DynamicBVH::boundsOf(more[i], bounds);
+        tree.insert(shapes.size() + i, bounds);
+    }
+    for (int i = 0; i < 2000; ++i) {
+        Ray ray = randomRay(rng, extent);
+        assert(sameHit(tree.findClosestHit(ray, all), Camera::findClosestHit(ray, all, -1)));
+    }
+}
+
+void testRefitAndSubtreeRebuild() {
+    const double extent = 100.0;
+    math::Vector<Camera::ShapeVariant> shapes = makeSpheres(4000, extent, 3);
+    math::Vector<size_t> proxies;
+    DynamicBVH tree = makeTree(shapes, proxies);
+    tree.rebuild();
+    const double builtCost = tree.getCost();
+    const size_t builtHeight = tree.getHeight();
+    std::cout << "  4000 spheres: cost " << builtCost << ", height " << builtHeight << std::endl;
+    assert(builtHeight <= 14);
+
+    // Small moves only refit
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> jitter(-0.05, 0.05);
+    for (size_t i = 0; i < shapes.size(); i += 4) {
+        const Sphere* sphere = std::get<Shape<Sphere>>(shapes[i]).getGeometry();
+        shapes[i] = sphereAt(sphere->getCenter() + Vector3D(jitter(rng), jitter(rng), jitter(rng)), sphere->getRadius());
+        Bounds3D bounds;
+        DynamicBVH::boundsOf(shapes[i], bounds);
+        tree.update(proxies[i], bounds);
+    }
+    assert(tree.getCost() < builtCost * 1.1);
+
+    // Objects scattered across the scene are inserted again where they land
+    std::uniform_real_distribution<double> anywhere(0.0, extent);
+    for (size_t i = 0; i < shapes.size(); i += 2) {
+        shapes[i] = sphereAt(Vector3D(anywhere(rng), anywhere(rng), anywhere(rng)), 0.3);
+        Bounds3D bounds;
+        DynamicBVH::boundsOf(shapes[i], bounds);
+        tree.update(proxies[i], bounds);
+    }
+    std::cout << "  half of them scattered: " << tree.getReinsertionCount() << " reinsertions, " << tree.getSubtreeRebuildCount()
+              << " subtree rebuilds, cost " << tree.getCost() << std::endl;
+    assert(tree.getReinsertionCount() > shapes.size() / 4);
+    assert(tree.getCost() < builtCost * 3.0);
+
+    // Drifting a cluster little by little rebuilds the subtrees it stretches
+    size_t rebuilds = tree.getSubtreeRebuildCount();
+    for (int frame = 0; frame < 40; ++frame) {
+        for (size_t i = 1; i < shapes.size(); i += 2) {
+            const Sphere* sphere = std::get<Shape<Sphere>>(shapes[i]).getGeometry();
+            Vector3D center = sphere->getCenter();
+            // Away from the middle of the scene, a little more each frame
+            Vector3D drift = (center - Vector3D(50, 50, 50)) * 0.01;
+            shapes[i] = sphereAt(center + drift, sphere->getRadius());
+            Bounds3D bounds;
+            DynamicBVH::boundsOf(shapes[i], bounds);
+            tree.update(proxies[i], bounds);
+        }
+    }
+    std::cout << "  the other half drifting: " << tree.getSubtreeRebuildCount() - rebuilds << " subtree rebuilds, cost "
+              << tree.getCost() << std::endl;
+    assert(tree.getSubtreeRebuildCount() > rebuilds);
+    assert(tree.getCost() < builtCost * 3.0);
+
+    // Proxies survive the rebuilds
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        assert(tree.getObject(proxies[i]) == i);
+    }
+    for (int i = 0; i < 500; ++i) {
+        Ray ray = randomRay(rng, extent);
+        assert(sameHit(tree.findClosestHit(ray, shapes), Camera::findClosestHit(ray, shapes, -1)));
+    }
+}
+
+void testQuery() {
+    const double extent = 20.0;
+    math::Vector<Camera::ShapeVariant> shapes = makeSpheres(500, extent, 17);
+    math::Vector<size_t> proxies;
+    DynamicBVH tree = makeTree(shapes, proxies);
+
+    Bounds3D box(Vector3D(5, 5, 5), Vector3D(12, 9, 15));
+    math::Vector<size_t> found;
+    size_t count = tree.query(box, found);
+    size_t expected = 0;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        Bounds3D bounds;
+        DynamicBVH::boundsOf(shapes[i], bounds);
+        if (bounds.overlaps(box)) {
+            ++expected;
+            bool listed = false;
+            for (size_t j = 0; j < count; ++j) {
+                listed = listed || found[j] == i;
+            }
+            assert(listed);
+        }
+    }
+    assert(count == expected && count > 0);
+    assert(tree.query(Bounds3D(Vector3D(100, 100, 100), Vector3D(101, 101, 101)), found) == 0);
+}
+
+void testAnimationCost() {
+    // A few hundred moving objects among a static 100k
+    const size_t count = 100000, moving = 300;
+    const double extent = 400.0;
+    math::Vector<Camera::ShapeVariant> shapes = makeSpheres(count, extent, 23);
+    math::Vector<Bounds3D> bounds(count);
+    for (size_t i = 0; i < count; ++i) {
+        DynamicBVH::boundsOf(shapes[i], bounds[i]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    DynamicBVH tree;
+    math::Vector<size_t> proxies(count);
+    for (size_t i = 0; i < count; ++i) {
+        proxies[i] = tree.insert(i, bounds[i]);
+    }
+    std::chrono::duration<double, std::milli> insertTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    tree.rebuild();
+    std::chrono::duration<double, std::milli> rebuildTime = std::chrono::steady_clock::now() - start;
+
+    // Every frame, the moving objects orbit a little
+    const int frames = 20;
+    start = std::chrono::steady_clock::now();
+    for (int frame = 1; frame <= frames; ++frame) {
+        for (size_t m = 0; m < moving; ++m) {
+            size_t i = m * (count / moving);
+            double angle = 0.05 * frame + m;
+            Vector3D offset(2.0 * std::cos(angle), 2.0 * std::sin(angle), 0.0);
+            Bounds3D moved = bounds[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                double delta = axis == 0 ? offset.x() : (axis == 1 ? offset.y() : 0.0);
+                moved.low[axis] += delta;
+                moved.high[axis] += delta;
+            }
+            tree.update(proxies[i], moved);
+        }
+    }
+    std::chrono::duration<double, std::milli> animateTime = std::chrono::steady_clock::now() - start;
+    double frameTime = animateTime.count() / frames;
+
+    std::cout << "  100k spheres: inserted in " << insertTime.count() << " ms, full rebuild " << rebuildTime.count()
+              << " ms, " << moving << " moving per frame " << frameTime << " ms, height " << tree.getHeight()
+              << ", " << tree.getSubtreeRebuildCount() << " subtree rebuilds" << std::endl;
+    assert(frameTime * 20.0 < rebuildTime.count());
+}
+
+void testWorldIndex() {
+    World world;
+    world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 10), 1.0), RGBA_Color(1, 0, 0, 1)));
+    world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 20), 1.0), RGBA_Color(0, 1, 0, 1)));
+    world.addObject(Shape<Plane>(Plane(Vector3D(0, 0, 30), Vector3D(0, 0, -1)), RGBA_Color(0, 0, 1, 1)));
+    world.addObject(Shape<Sphere>(Sphere(Vector3D(5, 0, 5), 1.0), RGBA_Color(1, 1, 0, 1)));
+    assert(world.getObjectIndex().getLeafCount() == 3);
+
+    Ray ray(Vector3D(0, 0, 0), Vector3D(0, 0, 1));
+    auto hit = world.findClosestHit(ray);
+    assert(hit && hit->shapeIndex == 0 && std::fabs(hit->t - 9.0) < 1e-9);
+
+    // Moving the first sphere away uncovers the second
+    world.setObjectAt(0, Shape<Sphere>(Sphere(Vector3D(3, 0, 10), 1.0), RGBA_Color(1, 0, 0, 1)));
+    hit = world.findClosestHit(ray);
+    assert(hit && hit->shapeIndex == 1);
+    assert(std::get<Shape<Sphere>>(world.getObjectAt(0)).getGeometry()->getCenter().x() == 3.0);
+
+    // Removing moves the last object into the freed index, bounded or not
+    world.removeObjectAt(0);
+    hit = world.findClosestHit(ray);
+    assert(hit && hit->shapeIndex == 1 && std::fabs(hit->t - 19.0) < 1e-9);
+    assert(std::get<Shape<Sphere>>(world.getObjectAt(0)).getGeometry()->getCenter().x() == 5.0);
+    world.removeObjectAt(1);
+    hit = world.findClosestHit(ray);
+    assert(hit && hit->shapeIndex == 1 && std::fabs(hit->t - 30.0) < 1e-9);
+    world.removeObjectAt(0);
+    hit = world.findClosestHit(ray);
+    assert(hit && hit->shapeIndex == 0 && std::fabs(hit->t - 30.0) < 1e-9);
+    assert(world.getObjectIndex().getLeafCount() == 0);
+    world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 20), 1.0), RGBA_Color(0, 1, 0, 1)));
+    assert(world.getObjectIndex().getLeafCount() == 1);
+
+    // A plane replaced by a sphere moves into the index, and back
+    world.setObjectAt(0, Shape<Sphere>(Sphere(Vector3D(0, 0, 4), 1.0), RGBA_Color(0, 0, 1, 1)));
+    assert(world.getObjectIndex().getLeafCount() == 2);
+    hit = world.findClosestHit(ray);
+    assert(hit && hit->shapeIndex == 0 && std::fabs(hit->t - 3.0) < 1e-9);
+    world.setObjectAt(0, Shape<Plane>(Plane(Vector3D(0, 0, 30), Vector3D(0, 0, -1)), RGBA_Color(0, 0, 1, 1)));
+    assert(world.getObjectIndex().getLeafCount() == 1);
+
+    bool threw = false;
+    try {
+        world.setObjectAt(5, Shape<Sphere>(Sphere(Vector3D(0, 0, 4), 1.0)));
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    world.clearObjects();
+    assert(world.getObjectIndex().getLeafCount() == 0);
+    assert(!world.findClosestHit(ray));
+}
+
+void testArguments() {
+    bool threw = false;
+    try {
+        DynamicBVH tree(1.0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    DynamicBVH tree;
+    assert(tree.getRebuildThreshold() == DynamicBVH::DEFAULT_REBUILD_THRESHOLD);
+    threw = false;
+    try {
+        tree.update(3, Bounds3D());
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+}
@@ -0,0 +1,267 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include "../Lib/Physics/Integrator.h"
+#include "../Lib/Rendering/World.h"
+#include "../Lib/Rendering/SceneChanges.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Sphere.h"
+
+using namespace physics;
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testFreeFall();
+void testStaticBodies();
+void testParachuteDrag();
+void testForces();
+void testRotation();
+void testWorldSync();
+void testErrors();
+void testManyBodies();
+
+int main() {
+    std::cout << "Running Integrator tests..." << std::endl;
+
+    try {
+        testFreeFall();
+        std::cout << "✓ Free fall tests passed" << std::endl;
+
+        testStaticBodies();
+        std::cout << "✓ Static body tests passed" << std::endl;
+
+        testParachuteDrag();
+        std::cout << "✓ Parachute drag tests passed" << std::endl;
+
+        testForces();
+        std::cout << "✓ Force tests passed" << std::endl;
+
+        testRotation();
+        std::cout << "✓ Rotation tests passed" << std::endl;
+
+        testWorldSync();
+        std::cout << "✓ World sync tests passed" << std::endl;
+
+        testErrors();
+        std::cout << "✓ Error tests passed" << std::endl;
+
+        testManyBodies();
+        std::cout << "✓ Many bodies tests passed" << std::endl;
+
+        std::cout << "All Integrator tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+void testFreeFall() {
+    // Thrown up at 10 m/s from 100 m, for 2 s
+    const double expectedHeight = 100.0 + 10.0 * 2.0 - 0.5 * 9.81 * 4.0;
+    const double expectedSpeed = 10.0 - 9.81 * 2.0;
+
+    Integrator verlet(IntegrationMethod::VELOCITY_VERLET);
+    Integrator euler(IntegrationMethod::SEMI_IMPLICIT_EULER);
+    size_t a = verlet.addBody(Vector3D(0, 100, 0), Vector3D(1, 10, 0), 80.0);
+    size_t b = euler.addBody(Vector3D(0, 100, 0), Vector3D(1, 10, 0), 80.0);
+    for (int i = 0; i < 200; ++i) {
+        verlet.step(0.01);
+        euler.step(0.01);
+    }
+
+    // Verlet is exact under a constant force, Euler is off by g * t * dt / 2
+    assert(std::fabs(verlet.getPosition(a).y() - expectedHeight) < 1e-9);
+    assert(std::fabs(verlet.getVelocity(a).y() - expectedSpeed) < 1e-9);
+    assert(std::fabs(verlet.getPosition(a).x() - 2.0) < 1e-9);
+    double eulerError = std::fabs(euler.getPosition(b).y() - expectedHeight);
+    assert(eulerError > 1e-3 && eulerError < 0.5 * 9.81 * 2.0 * 0.01 + 1e-9);
+    assert(std::fabs(euler.getVelocity(b).y() - expectedSpeed) < 1e-9);
+}
+
+void testStaticBodies() {
+    Integrator integrator;
+    size_t ground = integrator.addBody(Vector3D(0, 0, 0), Vector3D(0, 0, 0), 0.0);
+    integrator.applyForce(ground, Vector3D(100, 0, 0));
+    integrator.setDrag(ground, 1.0, 1.0);
+    for (int i = 0; i < 10; ++i) {
+        integrator.step(0.1);
+    }
+    assert(integrator.getPosition(ground) == Vector3D(0, 0, 0));
+    assert(integrator.getVelocity(ground) == Vector3D(0, 0, 0));
+}
+
+void testParachuteDrag() {
+    // An 80 kg skydiver, then a 30 m^2 canopy of Cd 1.3
+    const double mass = 80.0;
+    for (IntegrationMethod method : {IntegrationMethod::SEMI_IMPLICIT_EULER, IntegrationMethod::VELOCITY_VERLET}) {
+        Integrator integrator(method);
+        size_t diver = integrator.addBody(Vector3D(0, 3000, 0), Vector3D(0, 0, 0), mass);
+        integrator.setDrag(diver, 1.0, 0.7);
+
+        for (int i = 0; i < 6000; ++i) {
+            integrator.step(0.01);
+        }
+        double freeFall = std::sqrt(mass * 9.81 / (integrator.getAirDensity() * 0.5 * 1.0 * 0.7));
+        assert(std::fabs(-integrator.getVelocity(diver).y() - freeFall) < 1e-3 * freeFall);
+
+        integrator.setDrag(diver, 1.3, 30.0);
+        double canopy = std::sqrt(mass * 9.81 / (integrator.getAirDensity() * 0.5 * 1.3 * 30.0));
+        if (method == IntegrationMethod::SEMI_IMPLICIT_EULER) {
+            // The canopy opens with a jolt, the implicit drag does not reverse the fall on a large step
+            integrator.step(0.5);
+            assert(integrator.getVelocity(diver).y() < 0.0);
+        }
+        for (int i = 0; i < 2000; ++i) {
+            integrator.step(0.01);
+            assert(integrator.getVelocity(diver).y() < 0.0);
+        }
+        assert(std::fabs(-integrator.getVelocity(diver).y() - canopy) < 1e-3 * canopy);
+    }
+
+    // Without air there is no drag
+    Integrator vacuum;
+    vacuum.setAirDensity(0.0);
+    size_t body = vacuum.addBody(Vector3D(0, 0, 0), Vector3D(0, 0, 0), 1.0);
+    vacuum.setDrag(body, 1.0, 1.0);
+    vacuum.step(1.0);
+    assert(std::fabs(vacuum.getVelocity(body).y() + 9.81) < 1e-12);
+}
+
+void testForces() {
+    Integrator integrator(IntegrationMethod::VELOCITY_VERLET);
+    integrator.setGravity(Vector3D(0, 0, 0));
+    size_t body = integrator.addBody(Vector3D(0, 0, 0), Vector3D(0, 0, 0), 2.0);
+    integrator.applyForce(body, Vector3D(4, 0, 0));
+    integrator.applyForce(body, Vector3D(0, 2, 0));
+    integrator.step(1.0);
+    assert(integrator.getVelocity(body) == Vector3D(2, 1, 0));
+    assert(integrator.getPosition(body) == Vector3D(1, 0.5, 0));
+
+    // Forces last one step
+    integrator.step(1.0);
+    assert(integrator.getVelocity(body) == Vector3D(2, 1, 0));
+    assert(integrator.getPosition(body) == Vector3D(3, 1.5, 0));
+}
+
+void testRotation() {
+    Integrator integrator;
+    integrator.setGravity(Vector3D(0, 0, 0));
+    size_t body = integrator.addBody(Vector3D(0, 0, 0), Vector3D(0, 0, 0), 1.0);
+
+    // A quarter turn around z in one second
+    integrator.setAngularVelocity(body, Vector3D(0, 0, M_PI / 2.0));
+    for (int i = 0; i < 1000; ++i) {
+        integrator.step(0.001);
+    }
+    Quaternion orientation = integrator.getOrientation(body);
+    assert(orientation.isUnit(1e-12));
+    Vector3D turned = orientation * Vector3D(1, 0, 0);
+    assert(std::fabs(turned.x()) < 1e-5 && std::fabs(turned.y() - 1.0) < 1e-5);
+
+    // A torque speeds the turn up by torque / inertia
+    integrator.setInertia(body, 2.0);
+    integrator.applyTorque(body, Vector3D(0, 0, 4.0));
+    integrator.step(0.5);
+    assert(std::fabs(integrator.getAngularVelocity(body).z() - (M_PI / 2.0 + 1.0)) < 1e-12);
+}
+
+void testWorldSync() {
+    World world;
+    Integrator integrator;
+    auto falling = world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 10, 5), 1.0)));
+    auto resting = world.addObject(Shape<Sphere>(Sphere(Vector3D(5, 0, 5), 1.0)));
+    size_t fallingBody = integrator.addBody(Vector3D(0, 10, 5), Vector3D(0, 0, 0), 1.0);
+    size_t restingBody = integrator.addBody(Vector3D(5, 0, 5), Vector3D(0, 0, 0), 0.0);
+    integrator.attach(fallingBody, falling);
+    integrator.attach(restingBody, resting);
+
+    uint64_t frame = world.getVersion();
+    assert(integrator.syncWorld(world) == 0);
+    assert(world.getChanges(frame).empty());
+
+    for (int i = 0; i < 10; ++i) {
+        integrator.step(0.01);
+    }
+    assert(integrator.syncWorld(world) == 1);
+    const Sphere* sphere = std::get<Shape<Sphere>>(world.getObject(falling)).getGeometry();
+    assert((sphere->getCenter() - integrator.getPosition(fallingBody)).length() < 1e-12);
+    assert(std::get<Shape<Sphere>>(world.getObject(resting)).getGeometry()->getCenter() == Vector3D(5, 0, 5));
+
+    // Moves are transforms, the lighting caches see what moved
+    SceneChangeSet changes = world.getChanges(frame);
+    assert(changes.objects.size() == 1 && changes.objects[0] == falling);
+    assert(changes.objectKinds == ChangeKind::TRANSFORM);
+
+    // Removed objects are reported
+    world.removeObject(falling);
+    integrator.step(0.01);
+    bool caught = false;
+    try {
+        integrator.syncWorld(world);
+    } catch (const std::out_of_range&) {
+        caught = true;
+    }
+    assert(caught);
+}
+
+void testErrors() {
+    Integrator integrator;
+    bool caught = false;
+    try {
+        integrator.addBody(Vector3D(0, 0, 0), Vector3D(0, 0, 0), -1.0);
+    } catch (const std::invalid_argument&) {
+        caught = true;
+    }
+    assert(caught);
+
+    caught = false;
+    try {
+        integrator.getPosition(0);
+    } catch (const std::out_of_range&) {
+        caught = true;
+    }
+    assert(caught);
+
+    size_t body = integrator.addBody(Vector3D(0, 0, 0), Vector3D(0, 0, 0), 1.0);
+    caught = false;
+    try {
+        integrator.setDrag(body, -1.0, 1.0);
+    } catch (const std::invalid_argument&) {
+        caught = true;
+    }
+    assert(caught);
+
+    caught = false;
+    try {
+        integrator.step(0.0);
+    } catch (const std::invalid_argument&) {
+        caught = true;
+    }
+    assert(caught);
+}
+
+void testManyBodies() {
+    const size_t count = 1000000;
+    Integrator integrator(IntegrationMethod::VELOCITY_VERLET);
+    for (size_t i = 0; i < count; ++i) {
+        size_t body = integrator.addBody(Vector3D(i % 1000, 1000.0, i / 1000), Vector3D(0, 0, 0), 1.0 + i % 7);
+        integrator.setDrag(body, 1.0, 0.01 * (i % 13));
+        integrator.setAngularVelocity(body, Vector3D(0.1, 0.2, 0.3));
+    }
+
+    const int steps = 10;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int step = 0; step < steps; ++step) {
+        integrator.step(1.0 / 60.0);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double time = std::chrono::duration<double, std::milli>(end - start).count() / steps;
+    assert(integrator.getPosition(count - 1).y() < 1000.0);
+
+    std::cout << "  " << count << " bodies: " << time << " ms per step" << std::endl;
+}
@@ -0,0 +1,427 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include "../Lib/Rendering/IrradianceCache.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Material.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Rendering/Texture.h"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testRecordReuse();
+void testTextureInvalidation();
+void testGradients();
+void testInterpolationError();
+void testParallelLookups();
+void testRenderReuse();
+void testCost();
+void testArguments();
+
+int main() {
+    std::cout << "Running IrradianceCache tests..." << std::endl;
+
+    try {
+        testRecordReuse();
+        std::cout << "✓ Record reuse tests passed" << std::endl;
+
+        testTextureInvalidation();
+        std::cout << "✓ Texture invalidation tests passed" << std::endl;
+
+        testGradients();
+        std::cout << "✓ Gradient tests passed" << std::endl;
+
+        testInterpolationError();
+        std::cout << "✓ Interpolation error tests passed" << std::endl;
+
+        testParallelLookups();
+        std::cout << "✓ Parallel lookup tests passed" << std::endl;
+
+        testRenderReuse();
+        std::cout << "✓ Render reuse tests passed" << std::endl;
+
+        testCost();
+        std::cout << "✓ Cost tests passed" << std::endl;
+
+        testArguments();
+        std::cout << "✓ Argument tests passed" << std::endl;
+
+        std::cout << "All IrradianceCache tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+// A room with a red and a green wall, lit from under the ceiling, and two white spheres
+static math::Vector<Camera::ShapeVariant> makeRoom() {
+    math::Vector<Camera::ShapeVariant> shapes(7);
+    shapes[0] = Shape<Plane>(Plane(Vector3D(0, 0, 18), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.8, 0.8, 1.0));
+    shapes[1] = Shape<Plane>(Plane(Vector3D(0, 10, 0), Vector3D(0, -1, 0)), RGBA_Color(0.8, 0.8, 0.8, 1.0));
+    shapes[2] = Shape<Plane>(Plane(Vector3D(-12, 0, 0), Vector3D(1, 0, 0)), RGBA_Color(0.9, 0.1, 0.1, 1.0));
+    shapes[3] = Shape<Plane>(Plane(Vector3D(12, 0, 0), Vector3D(-1, 0, 0)), RGBA_Color(0.1, 0.9, 0.1, 1.0));
+    shapes[4] = Shape<Plane>(Plane(Vector3D(0, -12, 0), Vector3D(0, 1, 0)), RGBA_Color(0.8, 0.8, 0.8, 1.0));
+    shapes[5] = Shape<Sphere>(Sphere(Vector3D(-4, 6, 12), 4.0), RGBA_Color(0.9, 0.9, 0.9, 1.0));
+    shapes[6] = Shape<Sphere>(Sphere(Vector3D(5, 7, 9), 3.0), RGBA_Color(0.9, 0.9, 0.9, 1.0));
+    return shapes;
+}
+
+static math::Vector<Light> makeLights() {
+    math::Vector<Light> lights(1);
+    lights[0] = Light(Vector3D(0, -9, 8), RGBA_Color(1, 1, 1, 1), 0.9);
+    return lights;
+}
+
+static double channelError(const RGBA_Color& value, const IrradianceRecord& exact) {
+    return std::fabs(value.r() - exact.light[0]) + std::fabs(value.g() - exact.light[1]) + std::fabs(value.b() - exact.light[2]);
+}
+
+static double brightness(const Image& image) {
+    double sum = 0.0;
+    for (size_t y = 0; y < image.getHeight(); ++y) {
+        for (size_t x = 0; x < image.getWidth(); ++x) {
+            const RGBA_Color& p = image.getPixel(x, y);
+            sum += p.r() + p.g() + p.b();
+        }
+    }
+    return sum;
+}
+
+void testRecordReuse() {
+    math::Vector<Camera::ShapeVariant> shapes = makeRoom();
+    math::Vector<Light> lights = makeLights();
+    LightingStorage storage;
+    const LightingCache lighting = makeTestCamera().prepareLighting(shapes, lights, storage);
+
+    IrradianceCache cache;
+    assert(!cache.matches(shapes, lights));
+    cache.reset(shapes, lights);
+    assert(cache.matches(shapes, lights));
+    assert(cache.getRecordCount() == 0);
+
+    // Nothing to interpolate yet, so the first lookup computes a record
+    const Vector3D normal(0, 0, -1);
+    RGBA_Color light;
+    assert(!cache.interpolate(Vector3D(0, 0, 18), normal, light));
+    RGBA_Color first = cache.indirectLight(Vector3D(0, 0, 18), normal, shapes, lights, 0, lighting);
+    assert(cache.getRecordCount() == 1);
+    assert(first.a() == 0.0);
+
+    // The back wall sees the red and green walls: indirect light is reddish on the left, greenish on the right
+    IrradianceRecord left = cache.computeRecord(Vector3D(-10, 0, 18), normal, shapes, lights, 0, lighting);
+    IrradianceRecord right = cache.computeRecord(Vector3D(10, 0, 18), normal, shapes, lights, 0, lighting);
+    assert(left.light[0] > left.light[1] && right.light[1] > right.light[0]);
+    assert(first.r() > 0.0 && first.g() > 0.0 && first.b() > 0.0);
+
+    // Close points reuse it, at the record itself exactly
+    assert(cache.interpolate(Vector3D(0, 0, 18), normal, light));
+    assert(std::fabs(light.r() - first.r()) < 1e-9 && std::fabs(light.b() - first.b()) < 1e-9);
+    cache.indirectLight(Vector3D(0.05, 0.05, 18), normal, shapes, lights, 0, lighting);
+    assert(cache.getRecordCount() == 1);
+
+    // Other normals and far points do not
+    assert(!cache.interpolate(Vector3D(0, 0, 18), Vector3D(0, -1, 0), light));
+    cache.indirectLight(Vector3D(-11, -11, 18), normal, shapes, lights, 0, lighting);
+    assert(cache.getRecordCount() == 2);
+
+    // Records are out of reach behind the surface they were computed on
+    assert(!cache.interpolate(Vector3D(0, 0, 18.5), normal, light));
+
+    // Resetting drops them
+    cache.reset(shapes, lights);
+    assert(cache.getRecordCount() == 0);
+}
+
+void testTextureInvalidation() {
+    const std::string redFile = "./test/test_by_product/irradiance_cache_red.tex";
+    const std::string blueFile = "./test/test_by_product/irradiance_cache_blue.tex";
+    auto textureCache = std::make_shared<TextureCache>();
+    Image red(8, 8);
+    Image blue(8, 8);
+    for (size_t y = 0; y < 8; ++y) {
+        for (size_t x = 0; x < 8; ++x) {
+            red.setPixel(x, y, RGBA_Color(1, 0, 0, 1));
+            blue.setPixel(x, y, RGBA_Color(0, 0, 1, 1));
+        }
+    }
+    std::shared_ptr<const Texture> redTexture = Texture::fromImage(red, redFile, textureCache);
+    std::shared_ptr<const Texture> blueTexture = Texture::fromImage(blue, blueFile, textureCache);
+
+    // The left wall reflects its texture into the room
+    math::Vector<Camera::ShapeVariant> shapes = makeRoom();
+    math::Vector<Light> lights = makeLights();
+    auto setWallTexture = [&](std::shared_ptr<const Texture> texture, double scale) {
+        std::visit([&](auto& shape) {
+            Material material(*shape.getMaterial());
+            material.setAlbedoTexture(texture, scale);
+            shape.setMaterial(material);
+        }, shapes[2]);
+    };
+    setWallTexture(redTexture, 1.0);
+
+    IrradianceCache cache;
+    cache.reset(shapes, lights);
+    assert(cache.matches(shapes, lights));
+
+    // Swapping the texture or its scale makes the records stale
+    setWallTexture(blueTexture, 1.0);
+    assert(!cache.matches(shapes, lights));
+    setWallTexture(redTexture, 2.0);
+    assert(!cache.matches(shapes, lights));
+    setWallTexture(redTexture, 1.0);
+    assert(cache.matches(shapes, lights));
+
+    std::remove(redFile.c_str());
+    std::remove(blueFile.c_str());
+}
+
+void testGradients() {
+    math::Vector<Camera::ShapeVariant> shapes = makeRoom();
+    math::Vector<Light> lights = makeLights();
+    LightingStorage storage;
+    const LightingCache lighting = makeTestCamera().prepareLighting(shapes, lights, storage);
+    IrradianceCache cache;
+    cache.setHemisphereSamples(16, 48);
+
+    // Moving along the floor toward a wall: the translation gradient predicts the change better than a constant
+    double constantError = 0.0, gradientError = 0.0;
+    const Vector3D up(0, -1, 0);
+    for (int i = 0; i < 8; ++i) {
+        Vector3D point(-9.0 + 2.5 * i, 10, 3.0 + i);
+        Vector3D step(0.4, 0, 0.3);
+        IrradianceRecord here = cache.computeRecord(point, up, shapes, lights, 1, lighting);
+        IrradianceRecord there = cache.computeRecord(point + step, up, shapes, lights, 1, lighting);
+        for (int c = 0; c < 3; ++c) {
+            constantError += std::fabs(there.light[c] - here.light[c]);
+            gradientError += std::fabs(there.light[c] - (here.light[c] + step.dot(here.translationGradient[c])));
+        }
+        assert(here.radius >= cache.getMinSpacing() && here.radius <= cache.getMaxSpacing());
+    }
+    std::cout << "  translation: constant error " << constantError << ", with gradient " << gradientError << std::endl;
+    assert(gradientError < constantError);
+
+    // Tilting the normal of a point of the back wall: same with the rotation gradient
+    constantError = 0.0;
+    gradientError = 0.0;
+    for (int i = 0; i < 8; ++i) {
+        Vector3D point(-8.0 + 2.0 * i, -4.0 + i, 18);
+        Vector3D normal(0, 0, -1);
+        Vector3D tilted = Vector3D(0.08 * ((i % 2) ? 1 : -1), 0.05, -1).normal();
+        IrradianceRecord here = cache.computeRecord(point, normal, shapes, lights, 0, lighting);
+        IrradianceRecord there = cache.computeRecord(point, tilted, shapes, lights, 0, lighting);
+        Vector3D rotation = normal.cross(tilted);
+        for (int c = 0; c < 3; ++c) {
+            constantError += std::fabs(there.light[c] - here.light[c]);
+            gradientError += std::fabs(there.light[c] - (here.light[c] + rotation.dot(here.rotationGradient[c])));
+        }
+    }
+    std::cout << "  rotation: constant error " << constantError << ", with gradient " << gradientError << std::endl;
+    assert(gradientError < constantError);
+}
+
+void testInterpolationError() {
+    math::Vector<Camera::ShapeVariant> shapes = makeRoom();
+    math::Vector<Light> lights = makeLights();
+    LightingStorage storage;
+    const LightingCache lighting = makeTestCamera().prepareLighting(shapes, lights, storage);
+    IrradianceCache cache;
+    cache.reset(shapes, lights);
+
+    // Fill the cache over the back wall, then compare interpolated and traced light between the samples
+    const Vector3D normal(0, 0, -1);
+    for (int y = 0; y <= 40; ++y) {
+        for (int x = 0; x <= 40; ++x) {
+            cache.indirectLight(Vector3D(-11.0 + 0.55 * x, -11.0 + 0.5 * y, 18), normal, shapes, lights, 0, lighting);
+        }
+    }
+    size_t records = cache.getRecordCount();
+    std::cout << "  " << records << " records for 1681 points of the back wall" << std::endl;
+    assert(records > 4 && records < 1681 / 4);
+
+    double error = 0.0, total = 0.0;
+    size_t count = 0;
+    for (int y = 0; y < 20; ++y) {
+        for (int x = 0; x < 20; ++x) {
+            Vector3D point(-10.6 + 1.07 * x, -10.7 + 1.03 * y, 18);
+            RGBA_Color light;
+            assert(cache.interpolate(point, normal, light));
+            IrradianceRecord exact = cache.computeRecord(point, normal, shapes, lights, 0, lighting);
+            error += channelError(light, exact);
+            total += exact.light[0] + exact.light[1] + exact.light[2];
+            ++count;
+        }
+    }
+    std::cout << "  mean relative interpolation error " << error / total << std::endl;
+    assert(error / total < 0.1);
+
+    // A tighter accuracy computes more records and lowers the error
+    IrradianceCache tight;
+    tight.setAccuracy(0.1);
+    tight.reset(shapes, lights);
+    for (int y = 0; y <= 40; ++y) {
+        for (int x = 0; x <= 40; ++x) {
+            tight.indirectLight(Vector3D(-11.0 + 0.55 * x, -11.0 + 0.5 * y, 18), normal, shapes, lights, 0, lighting);
+        }
+    }
+    assert(tight.getRecordCount() > records);
+}
+
+void testParallelLookups() {
+    math::Vector<Camera::ShapeVariant> shapes = makeRoom();
+    math::Vector<Light> lights = makeLights();
+    LightingStorage storage;
+    const LightingCache lighting = makeTestCamera().prepareLighting(shapes, lights, storage);
+    IrradianceCache cache;
+    cache.reset(shapes, lights);
+
+    // Every thread inserts while the others look up
+    const int side = 60;
+    math::Vector<double> values(side * side);
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int i = 0; i < side * side; ++i) {
+        Vector3D point(-11.5 + 23.0 * (i % side) / side, 10, 0.5 + 17.0 * (i / side) / side);
+        RGBA_Color light = cache.indirectLight(point, Vector3D(0, -1, 0), shapes, lights, 1, lighting);
+        values[i] = light.r() + light.g() + light.b();
+    }
+    assert(cache.getRecordCount() > 0 && cache.getRecordCount() < size_t(side * side) / 2);
+    assert(cache.getLookupCount() >= size_t(side * side));
+    for (int i = 0; i < side * side; ++i) {
+        assert(std::isfinite(values[i]) && values[i] >= 0.0);
+    }
+
+    // Lookups in the filled cache all interpolate
+    size_t records = cache.getRecordCount();
+    for (int i = 0; i < side * side; i += 7) {
+        Vector3D point(-11.5 + 23.0 * (i % side) / side, 10, 0.5 + 17.0 * (i / side) / side);
+        cache.indirectLight(point, Vector3D(0, -1, 0), shapes, lights, 1, lighting);
+    }
+    assert(cache.getRecordCount() == records);
+}
+
+void testRenderReuse() {
+    Camera camera = makeTestCamera();
+    math::Vector<Camera::ShapeVariant> shapes = makeRoom();
+    math::Vector<Light> lights = makeLights();
+
+    assert(camera.getIrradianceCache() == nullptr);
+    Image direct = camera.renderScene3DLight(60, 60, shapes, lights);
+    Image directAdvanced = camera.renderScene3DLight_Advanced(60, 60, shapes, lights);
+
+    auto cache = std::make_shared<IrradianceCache>();
+    camera.setIrradianceCache(cache);
+    assert(camera.getIrradianceCache() == cache);
+
+    // Indirect light brightens both renderers
+    Image first = camera.renderScene3DLight(60, 60, shapes, lights);
+    size_t records = cache->getRecordCount();
+    assert(records > 0);
+    assert(brightness(first) > brightness(direct) * 1.02);
+    assert(brightness(camera.renderScene3DLight_Advanced(60, 60, shapes, lights)) > brightness(directAdvanced) * 1.02);
+
+    // The static scene reuses its records, and renders the same from then on
+    size_t warmRecords = cache->getRecordCount();
+    Image second = camera.renderScene3DLight(60, 60, shapes, lights);
+    Image third = camera.renderScene3DLight(60, 60, shapes, lights);
+    assert(cache->getRecordCount() == warmRecords);
+    assert(sameImage(second, third));
+
+    // Moving the light resets the cache
+    math::Vector<Light> moved = makeLights();
+    moved[0] = Light(Vector3D(3, -9, 6), RGBA_Color(1, 1, 1, 1), 0.9);
+    assert(!cache->matches(shapes, moved));
+    camera.renderScene3DLight(60, 60, shapes, moved);
+    assert(cache->matches(shapes, moved));
+    assert(!cache->matches(shapes, lights));
+
+    // Removing the cache renders direct light only again
+    camera.setIrradianceCache(nullptr);
+    assert(sameImage(camera.renderScene3DLight(60, 60, shapes, lights), direct));
+}
+
+void testCost() {
+    Camera camera = makeTestCamera();
+    math::Vector<Camera::ShapeVariant> shapes = makeRoom();
+    math::Vector<Light> lights = makeLights();
+    const size_t size = 200;
+
+    auto start = std::chrono::steady_clock::now();
+    camera.renderScene3DLight(size, size, shapes, lights);
+    std::chrono::duration<double, std::milli> directTime = std::chrono::steady_clock::now() - start;
+
+    auto cache = std::make_shared<IrradianceCache>();
+    camera.setIrradianceCache(cache);
+    start = std::chrono::steady_clock::now();
+    camera.renderScene3DLight(size, size, shapes, lights);
+    std::chrono::duration<double, std::milli> coldTime = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    camera.renderScene3DLight(size, size, shapes, lights);
+    std::chrono::duration<double, std::milli> warmTime = std::chrono::steady_clock::now() - start;
+
+    // Brute force: a hemisphere per pixel, the same rays without reuse
+    LightingStorage storage;
+    const LightingCache lighting = camera.prepareLighting(shapes, lights, storage);
+    const size_t probes = 200;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < probes; ++i) {
+        cache->computeRecord(Vector3D(-10.0 + 0.1 * i, 0, 18), Vector3D(0, 0, -1), shapes, lights, 0, lighting);
+    }
+    std::chrono::duration<double, std::milli> probeTime = std::chrono::steady_clock::now() - start;
+    double bruteTime = probeTime.count() / probes * static_cast<double>(size * size);
+
+    std::cout << "  " << size << "x" << size << ", " << cache->getRecordCount() << " records: direct " << directTime.count()
+              << " ms, first frame " << coldTime.count() << " ms, next frames " << warmTime.count()
+              << " ms, one hemisphere per pixel about " << bruteTime << " ms" << std::endl;
+    assert(coldTime.count() < bruteTime / 4.0);
+    assert(warmTime.count() < coldTime.count());
+}
+
+void testArguments() {
+    IrradianceCache cache;
+    assert(cache.getAccuracy() == IrradianceCache::DEFAULT_ACCURACY);
+    assert(cache.getThetaSamples() == IrradianceCache::DEFAULT_THETA_SAMPLES);
+    assert(cache.getPhiSamples() == IrradianceCache::DEFAULT_PHI_SAMPLES);
+
+    bool threw = false;
+    try {
+        cache.setAccuracy(0.0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        cache.setSpacing(1.0, 0.5);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        cache.setHemisphereSamples(1, 8);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    cache.setSpacing(0.1, 2.0);
+    assert(cache.getMinSpacing() == 0.1 && cache.getMaxSpacing() == 2.0);
+    cache.setHemisphereSamples(4, 12);
+    assert(cache.getThetaSamples() == 4 && cache.getPhiSamples() == 12);
+}
@@ -0,0 +1,215 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include "../Lib/Rendering/LightBlock.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testLightBlockLayout();
+void testUnshadowedWeights();
+void testLightingMatchesPerLightLoop();
+void testLightingTiming();
+
+int main() {
+    std::cout << "Running LightBlock tests..." << std::endl;
+
+    try {
+        testLightBlockLayout();
+        std::cout << "✓ Light block layout tests passed" << std::endl;
+
+        testUnshadowedWeights();
+        std::cout << "✓ Unshadowed weight tests passed" << std::endl;
+
+        testLightingMatchesPerLightLoop();
+        std::cout << "✓ Block lighting tests passed" << std::endl;
+
+        testLightingTiming();
+        std::cout << "✓ Block lighting timing tests passed" << std::endl;
+
+        std::cout << "All LightBlock tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+// A wall behind a grid of spheres
+static math::Vector<Camera::ShapeVariant> makeShapes() {
+    math::Vector<Camera::ShapeVariant> shapes(1);
+    shapes[0] = Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.8, 0.8, 1.0));
+    for (int i = 0; i < 24; ++i) {
+        double x = -7.5 + 3.0 * (i % 6), y = -6.0 + 3.0 * (i / 6);
+        shapes.append(Shape<Sphere>(Sphere(Vector3D(x, y, 10.0 + (i % 3)), 0.8), RGBA_Color(1, 1, 1, 1)));
+    }
+    return shapes;
+}
+
+// Colored lights spread on both sides of the wall, so some face away from it
+static math::Vector<Light> makeLights(size_t count) {
+    math::Vector<Light> lights(count);
+    for (size_t i = 0; i < count; ++i) {
+        double angle = 2.399963229728653 * static_cast<double>(i);
+        double radius = 1.0 + 9.0 * static_cast<double>(i) / static_cast<double>(count);
+        double z = i % 4 == 3 ? 20.0 : -2.0;
+        RGBA_Color color(0.5 + 0.5 * std::cos(angle), 0.5 + 0.5 * std::sin(angle), 1.0, 1.0);
+        lights[i] = Light(Vector3D(radius * std::cos(angle), radius * std::sin(angle), z), color, 4.0 / static_cast<double>(count));
+    }
+    return lights;
+}
+
+// The lighting loop as it was, one Light at a time with a shadow ray each
+static RGBA_Color perLightLighting(const Vector3D& hitPoint, const Vector3D& normal, const math::Vector<Light>& lights, const math::Vector<Camera::ShapeVariant>& shapes, size_t selfIndex) {
+    double rgb[3] = {0.0, 0.0, 0.0};
+    for (const Light& light : lights) {
+        Vector3D hitToLight = light.getPosition() - hitPoint;
+        double distance = hitToLight.length();
+        Vector3D lightDir = hitToLight.normal();
+        Ray shadowRay(hitPoint + lightDir * 1e-6, lightDir);
+        bool shadowed = false;
+        for (size_t j = 0; j < shapes.size() && !shadowed; ++j) {
+            if (j == selfIndex) {
+                continue;
+            }
+            std::visit([&](auto&& shape) {
+                auto d = shape.getGeometry()->rayIntersectDepth(shadowRay, std::numeric_limits<double>::infinity());
+                shadowed = d && *d < distance;
+            }, shapes[j]);
+        }
+        if (!shadowed) {
+            double weight = std::max(0.0, normal.dot(lightDir)) / (1.0 + 0.03 * distance * distance);
+            rgb[0] += light.getColor().r() * light.getIntensity() * weight;
+            rgb[1] += light.getColor().g() * light.getIntensity() * weight;
+            rgb[2] += light.getColor().b() * light.getIntensity() * weight;
+        }
+    }
+    return RGBA_Color(rgb[0], rgb[1], rgb[2], 1.0);
+}
+
+void testLightBlockLayout() {
+    math::Vector<Light> lights(2);
+    lights[0] = Light(Vector3D(1, 2, 3), RGBA_Color(0.5, 0.25, 1.0, 1.0), 0.5);
+    lights[1] = Light(Vector3D(-4, 5, -6), RGBA_Color(1, 1, 1, 1), 1.0);
+    LightBlock block(lights);
+
+    assert(block.size() == 2);
+    assert(block.x[0] == 1.0 && block.y[0] == 2.0 && block.z[0] == 3.0);
+    assert(block.x[1] == -4.0 && block.y[1] == 5.0 && block.z[1] == -6.0);
+    assert(block.red[0] == 0.25 && block.green[0] == 0.125 && block.blue[0] == 0.5);
+    assert(block.peak[0] == 0.5 && block.peak[1] == 1.0);
+
+    assert(LightBlock().size() == 0);
+    assert(LightBlock(math::Vector<Light>()).size() == 0);
+}
+
+void testUnshadowedWeights() {
+    math::Vector<Light> lights = makeLights(37);
+    LightBlock block(lights);
+    Vector3D point(0.5, -0.5, 15);
+    Vector3D normal(0, 0, -1);
+
+    double weightsSquared[37];
+    block.unshadowedWeights(0, 37, point, normal, weightsSquared);
+    for (size_t i = 0; i < 37; ++i) {
+        Vector3D toLight = lights[i].getPosition() - point;
+        double distance = toLight.length();
+        double expected = std::max(0.0, normal.dot(toLight.normal())) / (1.0 + LightBlock::ATTENUATION * distance * distance);
+        assert(std::abs(std::sqrt(weightsSquared[i]) - expected) < 1e-12);
+        // Lights behind the wall weigh exactly zero
+        if (toLight.z() > 0.0) {
+            assert(weightsSquared[i] == 0.0);
+        }
+    }
+
+    // A sub-range reads the same lights
+    double tail[5];
+    block.unshadowedWeights(30, 5, point, normal, tail);
+    for (size_t i = 0; i < 5; ++i) {
+        assert(tail[i] == weightsSquared[30 + i]);
+    }
+
+    // A light on the point gives no light rather than a NaN
+    math::Vector<Light> onPoint(1);
+    onPoint[0] = Light(point);
+    LightBlock(onPoint).unshadowedWeights(0, 1, point, normal, weightsSquared);
+    assert(weightsSquared[0] == 0.0);
+}
+
+void testLightingMatchesPerLightLoop() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+
+    for (size_t count : {1, 16, 64, 200}) {
+        math::Vector<Light> lights = makeLights(count);
+        LightBlock block(lights);
+        for (double x = -9.0; x <= 9.0; x += 0.75) {
+            for (double y = -9.0; y <= 9.0; y += 2.25) {
+                Vector3D point(x, y, 15);
+                RGBA_Color expected = perLightLighting(point, Vector3D(0, 0, -1), lights, shapes, 0);
+                RGBA_Color direct = Camera::calculateLighting(point, Vector3D(0, 0, -1), lights, shapes, 0);
+                RGBA_Color shared = Camera::calculateLighting(point, Vector3D(0, 0, -1), lights, shapes, 0, LightingCache{nullptr, nullptr, &block});
+
+                // Skipped shadow queries of negligible lights stay under the cutoff in total
+                assert(std::abs(direct.r() - expected.r()) < 1.0 / 1024.0);
+                assert(std::abs(direct.g() - expected.g()) < 1.0 / 1024.0);
+                assert(std::abs(direct.b() - expected.b()) < 1.0 / 1024.0);
+                assert(direct.a() == 1.0);
+                assert(shared == direct);
+            }
+        }
+    }
+
+    // Renders lay out the lights once per frame
+    Camera camera = makeTestCamera();
+    math::Vector<Light> lights = makeLights(16);
+    LightingStorage storage;
+    LightingCache lighting = camera.prepareLighting(shapes, lights, storage);
+    assert(lighting.lights == &storage.lights);
+    assert(storage.lights.size() == 16);
+}
+
+void testLightingTiming() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    Vector3D normal(0, 0, -1);
+
+    for (size_t count : {16, 64, 256}) {
+        math::Vector<Light> lights = makeLights(count);
+        LightBlock block(lights);
+        const LightingCache lighting{nullptr, nullptr, &block};
+        double checksum = 0.0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (double x = -9.0; x <= 9.0; x += 0.5) {
+            for (double y = -9.0; y <= 9.0; y += 1.0) {
+                checksum += perLightLighting(Vector3D(x, y, 15), normal, lights, shapes, 0).r();
+            }
+        }
+        std::chrono::duration<double, std::milli> perLightTime = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (double x = -9.0; x <= 9.0; x += 0.5) {
+            for (double y = -9.0; y <= 9.0; y += 1.0) {
+                checksum -= Camera::calculateLighting(Vector3D(x, y, 15), normal, lights, shapes, 0, lighting).r();
+            }
+        }
+        std::chrono::duration<double, std::milli> blockTime = std::chrono::steady_clock::now() - start;
+
+        assert(std::abs(checksum) < 37.0 * 19.0 / 1024.0);
+        std::cout << "  " << count << " lights, 703 points: per light " << perLightTime.count() << " ms, block "
+                  << blockTime.count() << " ms" << std::endl;
+    }
+}
@@ -0,0 +1,292 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include "../Lib/Rendering/Lightmap.h"
+#include "../Lib/Rendering/World.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+#include "../Lib/Geometry/Circle.h"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+static const std::string LIGHTMAP_FILE = "./test/test_by_product/lightmap_test.lmap";
+
+// Test function declarations
+void testBakeLayout();
+void testLookupAccuracy();
+void testBakedRender();
+void testSaveLoad();
+void testLightmapArguments();
+void testBakedRenderTiming();
+
+int main() {
+    std::cout << "Running Lightmap tests..." << std::endl;
+
+    try {
+        testBakeLayout();
+        std::cout << "✓ Bake layout tests passed" << std::endl;
+
+        testLookupAccuracy();
+        std::cout << "✓ Lookup accuracy tests passed" << std::endl;
+
+        testBakedRender();
+        std::cout << "✓ Baked render tests passed" << std::endl;
+
+        testSaveLoad();
+        std::cout << "✓ Save and load tests passed" << std::endl;
+
+        testLightmapArguments();
+        std::cout << "✓ Lightmap argument tests passed" << std::endl;
+
+        testBakedRenderTiming();
+        std::cout << "✓ Baked render timing tests passed" << std::endl;
+
+        std::remove(LIGHTMAP_FILE.c_str());
+        std::cout << "All Lightmap tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+// A back wall, a rectangle on the floor, a disc behind the camera and a sphere casting shadows on the wall
+static math::Vector<Camera::ShapeVariant> makeShapes() {
+    math::Vector<Camera::ShapeVariant> shapes(4);
+    shapes[0] = Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.8, 0.8, 1.0));
+    shapes[1] = Shape<Rectangle>(Rectangle(Vector3D(-6, -8, 2), Vector3D(6, -8, 2), Vector3D(-6, -8, 10)), RGBA_Color(0.2, 0.8, 0.2, 1.0));
+    shapes[2] = Shape<Circle>(Circle(Vector3D(5, 6, -20), 2.0, Vector3D(0, 0, 1)), RGBA_Color(0.2, 0.2, 0.8, 1.0));
+    shapes[3] = Shape<Sphere>(Sphere(Vector3D(0, 0, 8), 2.5), RGBA_Color(1, 1, 1, 1));
+    return shapes;
+}
+
+void testBakeLayout() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    math::Vector<Light> lights = makeRingLights(2, 4.0, 1.0);
+    LightmapSet lightmaps = LightmapSet::bake(shapes, lights, 0.5, 10.0);
+
+    // One map per planar surface, none for the sphere
+    assert(lightmaps.getMapCount() == 3);
+    assert(lightmaps.find(0) && lightmaps.find(1) && lightmaps.find(2));
+    assert(lightmaps.find(3) == nullptr);
+    assert(lightmaps.find(42) == nullptr);
+    assert(lightmaps.matches(shapes, lights));
+
+    // Infinite plane: 20 units at 0.5 per texel, rectangle 12 x 8, disc 4 x 4
+    const Lightmap* wall = lightmaps.find(0);
+    assert(wall->width == 41 && wall->height == 41);
+    assert(std::abs(wall->stepU - 0.5) < 1e-12);
+    const Lightmap* floor = lightmaps.find(1);
+    assert(floor->width * floor->height == 25 * 17);
+    assert(lightmaps.getTexelCount() == 41 * 41 + 25 * 17 + 9 * 9);
+
+    // Texels hold exactly the lighting of the renderers
+    for (size_t j = 0; j < wall->height; j += 7) {
+        for (size_t i = 0; i < wall->width; i += 5) {
+            Vector3D point = wall->origin + wall->axisU * (wall->stepU * i) + wall->axisV * (wall->stepV * j);
+            RGBA_Color expected = Camera::calculateLighting(point, Vector3D(0, 0, -1), lights, shapes, 0);
+            RGBA_Color baked;
+            assert(lightmaps.lookup(0, point, baked));
+            assert(std::abs(baked.r() - expected.r()) < 1e-6);
+            assert(std::abs(baked.g() - expected.g()) < 1e-6);
+            assert(std::abs(baked.b() - expected.b()) < 1e-6);
+        }
+    }
+
+    // Resolution is capped
+    LightmapSet fine = LightmapSet::bake(shapes, lights, 1e-3, 1.0);
+    assert(fine.find(0)->width == LightmapSet::MAX_RESOLUTION);
+}
+
+void testLookupAccuracy() {
+    math::Vector<Camera::ShapeVariant> shapes(1);
+    shapes[0] = Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.8, 0.8, 1.0));
+    math::Vector<Light> lights = makeRingLights(3, 4.0, 1.0);
+    LightmapSet lightmaps = LightmapSet::bake(shapes, lights, 0.25, 10.0);
+
+    // Unshadowed lighting is smooth, bilinear lookups stay close between texels
+    double worst = 0.0;
+    for (double x = -9.3; x < 9.5; x += 0.77) {
+        for (double y = -9.1; y < 9.5; y += 0.61) {
+            Vector3D point(x, y, 15);
+            RGBA_Color expected = Camera::calculateLighting(point, Vector3D(0, 0, -1), lights, shapes, 0);
+            RGBA_Color baked;
+            assert(lightmaps.lookup(0, point, baked));
+            worst = std::max(worst, std::abs(baked.r() - expected.r()));
+        }
+    }
+    assert(worst < 0.01);
+
+    // Outside the baked square the surface is lit as usual
+    RGBA_Color outside;
+    assert(!lightmaps.lookup(0, Vector3D(10.5, 0, 15), outside));
+    RGBA_Color direct = Camera::calculateLighting(Vector3D(10.5, 0, 15), Vector3D(0, 0, -1), lights, shapes, 0);
+    RGBA_Color fallback = Camera::calculateLighting(Vector3D(10.5, 0, 15), Vector3D(0, 0, -1), lights, shapes, 0, LightingCache{&lightmaps, nullptr});
+    assert(direct == fallback);
+}
+
+void testBakedRender() {
+    Camera camera = makeTestCamera();
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    math::Vector<Light> lights = makeRingLights(4, 4.0, 1.0);
+
+    Image reference = camera.renderScene3DLight(64, 64, shapes, lights);
+    Image referenceAdvanced = camera.renderScene3DLight_Advanced(64, 64, shapes, lights);
+
+    camera.setLightmaps(std::make_shared<const LightmapSet>(LightmapSet::bake(shapes, lights, 0.1, 12.0)));
+    assert(camera.getLightmaps());
+
+    // Only shadow edges differ, by less than a texel
+    Image baked = camera.renderScene3DLight(64, 64, shapes, lights);
+    assert(meanAbsoluteDifference(baked, reference) < 0.01);
+    Image bakedAdvanced = camera.renderScene3DLight_Advanced(64, 64, shapes, lights);
+    assert(meanAbsoluteDifference(bakedAdvanced, referenceAdvanced) < 0.01);
+    Image bakedMSAA = camera.renderScene3DLight_MSAA(64, 64, shapes, lights, 4);
+    assert(meanAbsoluteDifference(bakedMSAA, reference) < 0.05);
+
+    // Moving a light makes the bake stale, it is ignored
+    math::Vector<Light> moved = makeRingLights(4, 4.0, 1.0);
+    moved[0] = Light(Vector3D(0, 0, 0), RGBA_Color(1, 1, 1, 1), 0.25);
+    Image stale = camera.renderScene3DLight(64, 64, shapes, moved);
+    camera.setLightmaps(nullptr);
+    Image unbaked = camera.renderScene3DLight(64, 64, shapes, moved);
+    assert(meanAbsoluteDifference(stale, unbaked) == 0.0);
+}
+
+void testSaveLoad() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    math::Vector<Light> lights = makeRingLights(2, 4.0, 1.0);
+    LightmapSet lightmaps = LightmapSet::bake(shapes, lights, 0.5, 10.0);
+    lightmaps.save(LIGHTMAP_FILE);
+
+    LightmapSet loaded = LightmapSet::load(LIGHTMAP_FILE);
+    assert(loaded.getMapCount() == lightmaps.getMapCount());
+    assert(loaded.getTexelCount() == lightmaps.getTexelCount());
+    assert(loaded.getSceneHash() == lightmaps.getSceneHash());
+    assert(loaded.matches(shapes, lights));
+    for (size_t shape = 0; shape < 3; ++shape) {
+        const Lightmap* a = lightmaps.find(shape);
+        const Lightmap* b = loaded.find(shape);
+        assert(b && a->width == b->width && a->height == b->height);
+        assert(a->origin == b->origin && a->axisU == b->axisU && a->axisV == b->axisV);
+        assert(a->texels == b->texels);
+    }
+
+    // Through the world, which refuses lightmaps of another scene
+    World world;
+    world.getCamera() = makeTestCamera();
+    for (const auto& shape : shapes) {
+        std::visit([&world](auto&& s) { world.addObject(s); }, shape);
+    }
+    for (const Light& light : lights) {
+        world.addLight(light);
+    }
+    bool threw = false;
+    try {
+        world.saveLightmaps(LIGHTMAP_FILE);
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    world.loadLightmaps(LIGHTMAP_FILE);
+    assert(world.getCamera().getLightmaps()->getMapCount() == 3);
+    Image loadedRender = world.renderScene3DLight(32, 32);
+    world.bakeLightmaps(0.5, 10.0);
+    assert(meanAbsoluteDifference(loadedRender, world.renderScene3DLight(32, 32)) == 0.0);
+    world.saveLightmaps(LIGHTMAP_FILE);
+
+    world.addLight(Light(Vector3D(0, 0, 0), RGBA_Color(1, 1, 1, 1), 0.5));
+    threw = false;
+    try {
+        world.loadLightmaps(LIGHTMAP_FILE);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Not a lightmap file
+    FILE* junk = fopen(LIGHTMAP_FILE.c_str(), "wb");
+    fputs("not a lightmap", junk);
+    fclose(junk);
+    threw = false;
+    try {
+        LightmapSet::load(LIGHTMAP_FILE);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+void testLightmapArguments() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    math::Vector<Light> lights = makeRingLights(1, 4.0, 1.0);
+
+    bool threw = false;
+    try {
+        LightmapSet::bake(shapes, lights, 0.0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        LightmapSet::bake(shapes, lights, 0.5, -1.0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        LightmapSet::load("./test/test_by_product/missing.lmap");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // An empty set matches nothing and looks nothing up
+    LightmapSet empty;
+    RGBA_Color irradiance;
+    assert(!empty.matches(shapes, lights));
+    assert(!empty.lookup(0, Vector3D(0, 0, 15), irradiance));
+}
+
+void testBakedRenderTiming() {
+    Camera camera = makeTestCamera();
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+
+    for (size_t lightCount : {1, 16}) {
+        math::Vector<Light> lights = makeRingLights(lightCount, 4.0, 1.0);
+
+        auto start = std::chrono::steady_clock::now();
+        camera.setLightmaps(nullptr);
+        camera.renderScene3DLight(128, 128, shapes, lights);
+        std::chrono::duration<double, std::milli> direct = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        camera.setLightmaps(std::make_shared<const LightmapSet>(LightmapSet::bake(shapes, lights, 0.1, 12.0)));
+        std::chrono::duration<double, std::milli> bake = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        camera.renderScene3DLight(128, 128, shapes, lights);
+        std::chrono::duration<double, std::milli> baked = std::chrono::steady_clock::now() - start;
+
+        std::cout << "  " << lightCount << " lights: direct " << direct.count() << " ms, bake " << bake.count()
+                  << " ms, baked render " << baked.count() << " ms" << std::endl;
+    }
+}
@@ -2,6 +2,9 @@
 #include <cassert>
 #include <stdexcept>
 #include <memory>
+#include <chrono>
+#include <cmath>
+#include <limits>
 #include "../Lib/Math/Matrix.hpp"
 
 using namespace math;
@@ -31,6 +34,9 @@ void testMatrixCopyOperations();
 void testMatrixTranspose();
 void testMatrixMethods();
 void testMatrixErrorHandling();
+void testMatrixElementwise();
+void testMatrixReductions();
+void testMatrixBlockedTranspose();
 
 int main() {
     std::cout << "=== Matrix Test Suite ===" << std::endl;
@@ -53,6 +59,15 @@ int main() {
         
         testMatrixErrorHandling();
         std::cout << "✓ Matrix error handling test passed" << std::endl;
+
+        testMatrixElementwise();
+        std::cout << "✓ Matrix elementwise test passed" << std::endl;
+
+        testMatrixReductions();
+        std::cout << "✓ Matrix reductions test passed" << std::endl;
+
+        testMatrixBlockedTranspose();
+        std::cout << "✓ Matrix blocked transpose test passed" << std::endl;
         
         std::cout << "\n🎉 All Matrix tests passed successfully! 🎉" << std::endl;
         
@@ -252,4 +267,130 @@ void testMatrixErrorHandling() {
     // Test edge cases
     matrix(1, 1) = obj;  // Last valid position
     assert(matrix(1, 1) == obj);
-}
\ No newline at end of file
+}
+
+void testMatrixElementwise() {
+    std::cout << "Testing Matrix elementwise operations..." << std::endl;
+
+    Matrix<double> matrix(300, 400);
+    matrix.fill(2.0);
+    assert(matrix(0, 0) == 2.0 && matrix(299, 399) == 2.0);
+
+    matrix.map([](double v) { return v * 3.0 + 1.0; });
+    assert(matrix(150, 200) == 7.0);
+
+    Matrix<int> offsets(300, 400);
+    for (size_t i = 0; i < offsets.getRows(); ++i) {
+        for (size_t j = 0; j < offsets.getCols(); ++j) {
+            offsets(i, j) = static_cast<int>(i + j);
+        }
+    }
+    matrix.zip(offsets, [](double v, int offset) { return v + offset; });
+    assert(matrix(0, 0) == 7.0);
+    assert(matrix(299, 399) == 7.0 + 698.0);
+
+    // Objects go through the same loops
+    Matrix<TestObject> objects(2, 3);
+    objects.fill(TestObject(5));
+    objects.map([](const TestObject& o) { return TestObject(o.value * 2); });
+    assert(objects(1, 2) == TestObject(10));
+
+    bool caught = false;
+    try {
+        matrix.zip(Matrix<double>(400, 300), [](double a, double b) { return a + b; });
+    } catch (const std::invalid_argument&) {
+        caught = true;
+    }
+    assert(caught);
+}
+
+void testMatrixReductions() {
+    std::cout << "Testing Matrix reductions..." << std::endl;
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    // A depth buffer: misses at infinity, one NaN
+    Matrix<double> depth(512, 512, inf);
+    depth(3, 4) = 2.5;
+    depth(500, 17) = 9.0;
+    depth(250, 250) = 1.0;
+    depth(0, 0) = nan;
+    depth(100, 100) = -inf;
+
+    assert(depth.max() == inf);
+    assert(depth.min() == -inf);
+    assert(depth.max(true) == 9.0);
+    assert(depth.min(true) == 1.0);
+    assert(depth.sum(true) == 12.5);
+    // +inf and -inf kept, their sum is NaN
+    assert(std::isnan(depth.sum()));
+
+    // Nothing kept
+    Matrix<double> misses(64, 64, inf);
+    assert(misses.max(true) == -inf);
+    assert(misses.min(true) == inf);
+    assert(misses.sum(true) == 0.0);
+    Matrix<double> empty(0, 0);
+    assert(empty.max() == -inf);
+
+    // Integers
+    Matrix<int> counts(3, 3, 2);
+    counts(1, 1) = -7;
+    assert(counts.sum() == 9);
+    assert(counts.min() == -7);
+    assert(counts.max() == 2);
+    assert(Matrix<int>(0, 0).min() == std::numeric_limits<int>::max());
+
+    // Against a scalar loop, on a full HD buffer
+    Matrix<double> frame(1080, 1920);
+    for (size_t i = 0; i < frame.getRows(); ++i) {
+        for (size_t j = 0; j < frame.getCols(); ++j) {
+            frame(i, j) = (i * 31 + j * 17) % 1000 == 0 ? inf : static_cast<double>((i * 7 + j * 13) % 977);
+        }
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    double scalarMax = -inf;
+    for (size_t i = 0; i < frame.getRows(); ++i) {
+        for (size_t j = 0; j < frame.getCols(); ++j) {
+            if (frame(i, j) < inf && frame(i, j) > scalarMax) {
+                scalarMax = frame(i, j);
+            }
+        }
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    double reducedMax = frame.max(true);
+    auto end = std::chrono::high_resolution_clock::now();
+    assert(reducedMax == scalarMax);
+    std::cout << "  Max depth of a 1920x1080 buffer: scalar "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, reduction "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+}
+
+void testMatrixBlockedTranspose() {
+    std::cout << "Testing Matrix blocked transpose..." << std::endl;
+
+    // Sizes not a multiple of the block
+    Matrix<int> matrix(1000, 333);
+    for (size_t i = 0; i < matrix.getRows(); ++i) {
+        for (size_t j = 0; j < matrix.getCols(); ++j) {
+            matrix(i, j) = static_cast<int>(i * 1000 + j);
+        }
+    }
+    const Matrix<int>& constMatrix = matrix;
+    Matrix<int> transposed = constMatrix.transpose();
+    assert(transposed.getRows() == 333);
+    assert(transposed.getCols() == 1000);
+    for (size_t i = 0; i < matrix.getRows(); ++i) {
+        for (size_t j = 0; j < matrix.getCols(); ++j) {
+            assert(transposed(j, i) == matrix(i, j));
+        }
+    }
+
+    Matrix<int> back = transposed.transpose();
+    assert(back(999, 332) == matrix(999, 332));
+
+    Matrix<int> empty(0, 5);
+    Matrix<int> emptyTransposed = empty.transpose();
+    assert(emptyTransposed.getRows() == 5 && emptyTransposed.getCols() == 0);
+}
@@ -0,0 +1,209 @@
+#include <iostream>
+#include <cassert>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Rectangle.h"
+#include "../Lib/Math/Vector.hpp"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+
+// Test function declarations
+void testStereoPair();
+void testCubeMapFaces();
+void testMatchesSingleViews();
+void testEmptyScenes();
+void testMismatchedViews();
+void testCost();
+
+int main() {
+    std::cout << "Running multi-view rendering tests..." << std::endl;
+
+    try {
+        testStereoPair();
+        std::cout << "✓ Stereo pair tests passed" << std::endl;
+
+        testCubeMapFaces();
+        std::cout << "✓ Cube map face tests passed" << std::endl;
+
+        testMatchesSingleViews();
+        std::cout << "✓ Single view equivalence tests passed" << std::endl;
+
+        testEmptyScenes();
+        std::cout << "✓ Empty scene tests passed" << std::endl;
+
+        testMismatchedViews();
+        std::cout << "✓ Mismatched view tests passed" << std::endl;
+
+        testCost();
+        std::cout << "✓ Cost tests passed" << std::endl;
+
+        std::cout << "All multi-view rendering tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+static void makeScene(math::Vector<Camera::ShapeVariant>& shapes, math::Vector<Light>& lights) {
+    Shape<Sphere> sphere(Sphere(Vector3D(0, 0, 4), 3.0));
+    sphere.setColor(RGBA_Color(1, 1, 1, 1));
+    shapes.append(Camera::ShapeVariant{sphere});
+    Shape<Box> box(Box(Vector3D(5, 3, 10), 3.0, 3.0, 3.0, Vector3D(0, 0, 1)));
+    box.setColor(RGBA_Color(1, 0, 0, 1));
+    shapes.append(Camera::ShapeVariant{box});
+    shapes.append(Camera::ShapeVariant{Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.2, 0.8, 1.0))});
+    shapes.append(Camera::ShapeVariant{Shape<Plane>(Plane(Vector3D(0, -10, 0), Vector3D(0, 1, 0)), RGBA_Color(0.2, 0.2, 0.8, 1.0))});
+    shapes.append(Camera::ShapeVariant{Shape<Plane>(Plane(Vector3D(0, 10, 0), Vector3D(0, -1, 0)), RGBA_Color(0.8, 0.8, 0.8, 1.0))});
+    shapes.append(Camera::ShapeVariant{Shape<Plane>(Plane(Vector3D(-10, 0, 0), Vector3D(1, 0, 0)), RGBA_Color(0.2, 0.8, 0.8, 1.0))});
+    shapes.append(Camera::ShapeVariant{Shape<Plane>(Plane(Vector3D(10, 0, 0), Vector3D(-1, 0, 0)), RGBA_Color(0.8, 0.8, 0.2, 1.0))});
+    shapes.append(Camera::ShapeVariant{Shape<Plane>(Plane(Vector3D(0, 0, -20), Vector3D(0, 0, 1)), RGBA_Color(0.5, 0.5, 0.5, 1.0))});
+
+    lights.append(Light(Vector3D(0, 8, -2), RGBA_Color(1.0, 1.0, 1.0, 1.0), 2.0));
+    lights.append(Light(Vector3D(5, -5, -2), RGBA_Color(0.0, 0.0, 1.0, 1.0), 1.0));
+}
+
+// The views of a stereo pair or cube map, as renderMultiView3DLight takes them
+template<size_t N>
+static math::Vector<Camera> toViews(const std::array<Camera, N>& cameras, size_t first = 0, size_t count = N) {
+    return math::Vector<Camera>(cameras.data() + first, count);
+}
+
+void testStereoPair() {
+    Camera camera = makeTestCamera(90.0f);
+    std::array<Camera, 2> eyes = camera.makeStereoPair(0.5);
+
+    assert((eyes[0].getFOVOrigin() - (camera.getFOVOrigin() - Vector3D(0.25, 0, 0))).length() < 1e-12);
+    assert((eyes[1].getFOVOrigin() - (camera.getFOVOrigin() + Vector3D(0.25, 0, 0))).length() < 1e-12);
+    for (const Camera& eye : eyes) {
+        assert((eye.getDirection() - camera.getDirection()).length() < 1e-12);
+        assert(eye.getFOVAngle() == camera.getFOVAngle());
+    }
+}
+
+void testCubeMapFaces() {
+    Camera camera = makeTestCamera(90.0f);
+    std::array<Camera, 6> faces = camera.makeCubeMapFaces();
+
+    // Every face looks from the same eye along one of the six axes
+    Vector3D directionSum(0, 0, 0);
+    for (size_t i = 0; i < faces.size(); ++i) {
+        assert((faces[i].getFOVOrigin() - camera.getFOVOrigin()).length() < 1e-9);
+        const Vector3D direction = faces[i].getDirection();
+        assert(std::fabs(direction.length() - 1.0) < 1e-12);
+        directionSum = directionSum + direction;
+        for (size_t j = 0; j < i; ++j) {
+            const double dot = direction.dot(faces[j].getDirection());
+            assert(std::fabs(dot) < 1e-9 || std::fabs(dot + 1.0) < 1e-9);
+        }
+    }
+    assert(directionSum.length() < 1e-9);
+    assert((faces[0].getDirection() - camera.getDirection()).length() < 1e-12);
+}
+
+void testMatchesSingleViews() {
+    math::Vector<Camera::ShapeVariant> shapes;
+    math::Vector<Light> lights;
+    makeScene(shapes, lights);
+    const size_t size = 48;
+
+    // Cube faces: six views, three pairs
+    std::array<Camera, 6> faces = makeTestCamera(90.0f).makeCubeMapFaces();
+    for (bool advanced : {false, true}) {
+        math::Vector<Image> images = Camera::renderMultiView3DLight(toViews(faces), size, size, shapes, lights, advanced);
+        assert(images.size() == faces.size());
+        for (size_t i = 0; i < faces.size(); ++i) {
+            Image single = advanced ? faces[i].renderScene3DLight_Advanced(size, size, shapes, lights)
+                                    : faces[i].renderScene3DLight(size, size, shapes, lights);
+            assert(sameImage(images[i], single));
+        }
+    }
+
+    // An odd count, the last view rendered alone
+    math::Vector<Image> three = Camera::renderMultiView3DLight(toViews(faces, 1, 3), size, size, shapes, lights);
+    assert(three.size() == 3);
+    assert(sameImage(three[2], faces[3].renderScene3DLight(size, size, shapes, lights)));
+
+    // Per-pixel shadow rays and tiled framebuffers
+    std::array<Camera, 2> eyes = makeTestCamera(90.0f).makeStereoPair(1.0);
+    for (Camera& eye : eyes) {
+        eye.setShadowPackets(false);
+        eye.setFramebufferLayout(PixelLayout::TILED);
+    }
+    math::Vector<Image> images = Camera::renderMultiView3DLight(toViews(eyes), size, size, shapes, lights);
+    for (size_t i = 0; i < eyes.size(); ++i) {
+        assert(images[i].getLayout() == PixelLayout::TILED);
+        assert(sameImage(images[i], eyes[i].renderScene3DLight(size, size, shapes, lights)));
+    }
+    assert(!sameImage(images[0], images[1]));
+}
+
+void testEmptyScenes() {
+    math::Vector<Camera::ShapeVariant> shapes;
+    math::Vector<Light> lights;
+    std::array<Camera, 2> eyes = makeTestCamera(90.0f).makeStereoPair(1.0);
+
+    assert(Camera::renderMultiView3DLight(math::Vector<Camera>(), 16, 16, shapes, lights).size() == 0);
+
+    math::Vector<Image> images = Camera::renderMultiView3DLight(toViews(eyes), 16, 16, shapes, lights);
+    assert(images.size() == 2);
+    assert(sameImage(images[1], eyes[1].renderScene3DLight(16, 16, shapes, lights)));
+}
+
+void testMismatchedViews() {
+    math::Vector<Camera::ShapeVariant> shapes;
+    math::Vector<Light> lights;
+    makeScene(shapes, lights);
+
+    // Views that would need their own pixel spread or framebuffers are refused
+    std::array<Camera, 2> eyes = makeTestCamera(90.0f).makeStereoPair(1.0);
+    math::Vector<Camera> fov = toViews(eyes), viewport = toViews(eyes), layout = toViews(eyes);
+    fov[1].setFOVAngle(60.0);
+    const Vector3D corner = eyes[1].getViewport().getOrigin();
+    viewport[1].setViewport(Rectangle(corner, corner + Vector3D(20, 0, 0), corner + Vector3D(0, 10, 0)));
+    layout[1].setFramebufferLayout(PixelLayout::TILED);
+    for (const math::Vector<Camera>* views : {&fov, &viewport, &layout}) {
+        bool exceptionThrown = false;
+        try {
+            Camera::renderMultiView3DLight(*views, 16, 16, shapes, lights);
+        } catch (const std::invalid_argument&) {
+            exceptionThrown = true;
+        }
+        assert(exceptionThrown);
+    }
+}
+
+void testCost() {
+    math::Vector<Camera::ShapeVariant> shapes;
+    math::Vector<Light> lights;
+    makeScene(shapes, lights);
+    const size_t size = 256;
+    std::array<Camera, 2> eyes = makeTestCamera(90.0f).makeStereoPair(0.5);
+
+    // A single frame with the pixels of both eyes
+    Vector3D origin(-20, -10, -5);
+    Camera wide(Rectangle(origin, origin + Vector3D(40, 0, 0), origin + Vector3D(0, 20, 0)), 90.0f);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    Image left = eyes[0].renderScene3DLight(size, size, shapes, lights);
+    Image right = eyes[1].renderScene3DLight(size, size, shapes, lights);
+    auto separate = std::chrono::high_resolution_clock::now();
+    math::Vector<Image> images = Camera::renderMultiView3DLight(toViews(eyes), size, size, shapes, lights);
+    auto multi = std::chrono::high_resolution_clock::now();
+    Image frame = wide.renderScene3DLight(2 * size, size, shapes, lights);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    assert(sameImage(images[0], left) && sameImage(images[1], right));
+    std::cout << "  Stereo pair of " << size << "x" << size << ": two renders "
+              << std::chrono::duration<double, std::milli>(separate - start).count() << " ms, multi-view "
+              << std::chrono::duration<double, std::milli>(multi - separate).count() << " ms, one "
+              << 2 * size << "x" << size << " frame "
+              << std::chrono::duration<double, std::milli>(end - multi).count() << " ms" << std::endl;
+}
@@ -0,0 +1,259 @@
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+#include "../Lib/Rendering/NumaTopology.h"
+#include "../Lib/Rendering/CameraHelper.h"
+#include "../Lib/Math/Matrix.hpp"
+#include "../Lib/Math/Vector.hpp"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace rendering;
+
+// Test function declarations
+void testTopologyDetection();
+void testThreadToNodeMapping();
+void testNodeReplicated();
+void testForEachPixelCoverage();
+void testMakeFramebuffer();
+void testCallerAffinity();
+
+int main() {
+    std::cout << "Running NumaTopology tests..." << std::endl;
+
+    try {
+        testTopologyDetection();
+        std::cout << "✓ NUMA topology detection tests passed" << std::endl;
+
+        testThreadToNodeMapping();
+        std::cout << "✓ NUMA thread to node mapping tests passed" << std::endl;
+
+        testNodeReplicated();
+        std::cout << "✓ NUMA node replication tests passed" << std::endl;
+
+        testForEachPixelCoverage();
+        std::cout << "✓ forEachPixel coverage tests passed" << std::endl;
+
+        testMakeFramebuffer();
+        std::cout << "✓ makeFramebuffer tests passed" << std::endl;
+
+        testCallerAffinity();
+        std::cout << "✓ Caller affinity tests passed" << std::endl;
+
+        std::cout << "All NumaTopology tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+void testTopologyDetection() {
+    const NumaTopology& topology = NumaTopology::get();
+
+    // Always at least one node, and the same instance on every call
+    assert(topology.getNodeCount() >= 1);
+    assert(&topology == &NumaTopology::get());
+    assert(topology.isMultiNode() == (topology.getNodeCount() > 1));
+
+    // Every processor maps back to the node that lists it
+    for (size_t node = 0; node < topology.getNodeCount(); ++node) {
+        const math::Vector<int>& cpus = topology.getCpusOfNode(node);
+        assert(!cpus.empty());
+        for (int cpu : cpus) {
+            assert(topology.getNodeOfCpu(cpu) == node);
+        }
+    }
+
+    // Unknown processors fall back to node 0
+    assert(topology.getNodeOfCpu(-1) == 0);
+
+    std::cout << "Note: detected " << topology.getNodeCount() << " NUMA node(s)" << std::endl;
+}
+
+void testThreadToNodeMapping() {
+    const NumaTopology& topology = NumaTopology::get();
+    size_t nodeCount = topology.getNodeCount();
+
+    for (size_t threadCount = 1; threadCount <= 64; ++threadCount) {
+        size_t previous = 0;
+        for (size_t thread = 0; thread < threadCount; ++thread) {
+            size_t node = topology.getNodeOfThread(thread, threadCount);
+            // Nodes are assigned in contiguous, increasing blocks
+            assert(node < nodeCount);
+            assert(node >= previous);
+            previous = node;
+        }
+        assert(topology.getNodeOfThread(0, threadCount) == 0);
+        if (threadCount >= nodeCount) {
+            assert(topology.getNodeOfThread(threadCount - 1, threadCount) == nodeCount - 1);
+        }
+    }
+
+    // Out of range queries are mapped to node 0
+    assert(topology.getNodeOfThread(5, 0) == 0);
+    assert(topology.getNodeOfThread(5, 5) == 0);
+
+    // Outside of a parallel region the calling thread is thread 0
+    assert(topology.getCurrentThreadNode() == 0);
+}
+
+void testNodeReplicated() {
+    math::Vector<int> values;
+    values.append(1);
+    values.append(2);
+    values.append(3);
+
+    // Disabled replication only references the source
+    NodeReplicated<math::Vector<int>> disabled(values, false);
+    assert(!disabled.isReplicated());
+    assert(&disabled.local() == &values);
+
+    // Enabled replication only copies on multi-node hosts, but always reads the same data
+    NodeReplicated<math::Vector<int>> enabled(values, true);
+    assert(enabled.isReplicated() == NumaTopology::get().isMultiNode());
+    assert(enabled.local() == values);
+
+    bool allMatch = true;
+    #pragma omp parallel reduction(&&:allMatch)
+    {
+        allMatch = allMatch && (enabled.local() == values);
+    }
+    assert(allMatch);
+}
+
+void testForEachPixelCoverage() {
+    const size_t width = 97;
+    const size_t height = 61;
+    math::Matrix<int> visits(height, width, 0);
+
+    forEachPixel(width, height, [&](size_t x, size_t y) {
+        visits(y, x) += 1;
+    });
+
+    // Each pixel is processed exactly once
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            assert(visits(y, x) == 1);
+        }
+    }
+}
+
+void testMakeFramebuffer() {
+    // Large enough to take the parallel initialisation path
+    Image image = makeFramebuffer(320, 240);
+    assert(image.getWidth() == 320);
+    assert(image.getHeight() == 240);
+    assert(image.isValid());
+
+    // Framebuffers start with the debug color, like Image(w, h)
+    Image reference(320, 240);
+    for (size_t y = 0; y < image.getHeight(); y += 17) {
+        for (size_t x = 0; x < image.getWidth(); x += 13) {
+            assert(image.getPixel(x, y) == reference.getPixel(x, y));
+        }
+    }
+}
+
+#ifdef __linux__
+// Affinity mask of every thread of the default team, by thread number
+math::Vector<cpu_set_t> readTeamAffinity() {
+    math::Vector<cpu_set_t> masks(static_cast<size_t>(omp_get_max_threads()));
+    #pragma omp parallel
+    {
+        cpu_set_t& mask = masks[static_cast<size_t>(omp_get_thread_num())];
+        CPU_ZERO(&mask);
+        sched_getaffinity(0, sizeof(mask), &mask);
+    }
+    return masks;
+}
+
+bool sameTeamAffinity(const math::Vector<cpu_set_t>& a, const math::Vector<cpu_set_t>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t thread = 0; thread < a.size(); ++thread) {
+        if (!CPU_EQUAL(&a[thread], &b[thread])) return false;
+    }
+    return true;
+}
+#endif
+
+void testCallerAffinity() {
+    #ifdef __linux__
+    cpu_set_t before;
+    CPU_ZERO(&before);
+    assert(sched_getaffinity(0, sizeof(before), &before) == 0);
+    math::Vector<cpu_set_t> teamBefore = readTeamAffinity();
+
+    // The caller and the workers may be pinned while they work, never after
+    {
+        ThreadPin pin(0, 2);
+    }
+    {
+        TeamPin pin;
+    }
+    assert(sameTeamAffinity(teamBefore, readTeamAffinity()));
+
+    Image image = makeFramebuffer(320, 240);
+    assert(sameTeamAffinity(teamBefore, readTeamAffinity()));
+    forEachPixel(image.getWidth(), image.getHeight(), [&](size_t x, size_t y) {
+        image.setPixel(x, y, RGBA_Color(0, 0, 0, 1));
+    });
+
+    cpu_set_t after;
+    CPU_ZERO(&after);
+    assert(sched_getaffinity(0, sizeof(after), &after) == 0);
+    assert(CPU_EQUAL(&before, &after));
+
+    // Pins restore the mask they found, even one narrowed by someone else, on any node count
+    int firstCpu = 0;
+    while (!CPU_ISSET(firstCpu, &before)) ++firstCpu;
+    cpu_set_t narrowed;
+    CPU_ZERO(&narrowed);
+    CPU_SET(firstCpu, &narrowed);
+
+    bool restored = true;
+    #pragma omp parallel reduction(&&:restored)
+    {
+        cpu_set_t own;
+        CPU_ZERO(&own);
+        sched_getaffinity(0, sizeof(own), &own);
+        sched_setaffinity(0, sizeof(narrowed), &narrowed);
+        {
+            ThreadPin pin(static_cast<size_t>(omp_get_thread_num()), static_cast<size_t>(omp_get_num_threads()));
+            sched_setaffinity(0, sizeof(own), &own);
+        }
+        cpu_set_t current;
+        CPU_ZERO(&current);
+        sched_getaffinity(0, sizeof(current), &current);
+        restored = restored && CPU_EQUAL(&current, &narrowed);
+        sched_setaffinity(0, sizeof(own), &own);
+    }
+    assert(restored);
+
+    #pragma omp parallel
+    {
+        sched_setaffinity(0, sizeof(narrowed), &narrowed);
+    }
+    math::Vector<cpu_set_t> teamNarrowed = readTeamAffinity();
+    {
+        TeamPin pin;
+        #pragma omp parallel
+        {
+            sched_setaffinity(0, sizeof(before), &before);
+        }
+    }
+    assert(sameTeamAffinity(teamNarrowed, readTeamAffinity()));
+
+    #pragma omp parallel
+    {
+        sched_setaffinity(0, sizeof(teamBefore[static_cast<size_t>(omp_get_thread_num())]), &teamBefore[static_cast<size_t>(omp_get_thread_num())]);
+    }
+    assert(sameTeamAffinity(teamBefore, readTeamAffinity()));
+    #endif
+}
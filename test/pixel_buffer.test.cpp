@@ -0,0 +1,245 @@
+#include <iostream>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+#include "../Lib/Rendering/PixelBuffer.hpp"
+#include "../Lib/Rendering/Image.h"
+#include "../Lib/Rendering/RGBA_Color.h"
+#include "../Lib/Math/Matrix.hpp"
+
+using namespace rendering;
+
+// Test function declarations
+void testMortonIndex();
+void testLayoutAccess();
+void testRowMajorConversion();
+void testSetLayout();
+void testImageLayouts();
+void testReductions();
+
+int main() {
+    std::cout << "Running PixelBuffer tests..." << std::endl;
+
+    try {
+        testMortonIndex();
+        std::cout << "✓ Morton index tests passed" << std::endl;
+
+        testLayoutAccess();
+        std::cout << "✓ Layout access tests passed" << std::endl;
+
+        testRowMajorConversion();
+        std::cout << "✓ Row-major conversion tests passed" << std::endl;
+
+        testSetLayout();
+        std::cout << "✓ Layout change tests passed" << std::endl;
+
+        testImageLayouts();
+        std::cout << "✓ Image layout tests passed" << std::endl;
+
+        testReductions();
+        std::cout << "✓ Reduction tests passed" << std::endl;
+
+        std::cout << "All PixelBuffer tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+// Distinct value for every pixel
+static double pixelValue(size_t x, size_t y) {
+    return static_cast<double>(y * 1000 + x);
+}
+
+void testMortonIndex() {
+    // Z order on a 2x2 block
+    assert(PixelBuffer<int>::mortonIndex(0, 0) == 0);
+    assert(PixelBuffer<int>::mortonIndex(1, 0) == 1);
+    assert(PixelBuffer<int>::mortonIndex(0, 1) == 2);
+    assert(PixelBuffer<int>::mortonIndex(1, 1) == 3);
+    assert(PixelBuffer<int>::mortonIndex(2, 0) == 4);
+    assert(PixelBuffer<int>::mortonIndex(7, 7) == 63);
+
+    // Bijective over a tile
+    bool seen[PIXEL_TILE_SIZE * PIXEL_TILE_SIZE] = {};
+    for (size_t y = 0; y < PIXEL_TILE_SIZE; ++y) {
+        for (size_t x = 0; x < PIXEL_TILE_SIZE; ++x) {
+            size_t index = PixelBuffer<int>::mortonIndex(x, y);
+            assert(index < PIXEL_TILE_SIZE * PIXEL_TILE_SIZE);
+            assert(!seen[index]);
+            seen[index] = true;
+        }
+    }
+}
+
+void testLayoutAccess() {
+    // Sizes that are not multiples of the tile size exercise the padded border tiles
+    const PixelLayout layouts[] = {PixelLayout::ROW_MAJOR, PixelLayout::TILED, PixelLayout::MORTON};
+    for (PixelLayout layout : layouts) {
+        PixelBuffer<double> buffer(21, 13, -1.0, layout);
+        assert(buffer.getWidth() == 21);
+        assert(buffer.getHeight() == 13);
+        assert(buffer.getLayout() == layout);
+
+        for (size_t y = 0; y < 13; ++y) {
+            for (size_t x = 0; x < 21; ++x) {
+                assert(buffer(x, y) == -1.0);
+                buffer(x, y) = pixelValue(x, y);
+            }
+        }
+        for (size_t y = 0; y < 13; ++y) {
+            for (size_t x = 0; x < 21; ++x) {
+                assert(buffer(x, y) == pixelValue(x, y));
+            }
+        }
+
+        buffer.fill(2.5);
+        assert(buffer(0, 0) == 2.5);
+        assert(buffer(20, 12) == 2.5);
+    }
+
+    // Empty buffer
+    PixelBuffer<double> empty;
+    assert(empty.getWidth() == 0);
+    assert(empty.getHeight() == 0);
+}
+
+void testRowMajorConversion() {
+    math::Matrix<double> source(19, 30);
+    for (size_t y = 0; y < 19; ++y) {
+        for (size_t x = 0; x < 30; ++x) {
+            source(y, x) = pixelValue(x, y);
+        }
+    }
+
+    const PixelLayout layouts[] = {PixelLayout::ROW_MAJOR, PixelLayout::TILED, PixelLayout::MORTON};
+    for (PixelLayout layout : layouts) {
+        PixelBuffer<double> buffer(source, layout);
+        assert(buffer.getWidth() == 30);
+        assert(buffer.getHeight() == 19);
+        for (size_t y = 0; y < 19; ++y) {
+            for (size_t x = 0; x < 30; ++x) {
+                assert(buffer(x, y) == pixelValue(x, y));
+            }
+        }
+
+        math::Matrix<double> back = buffer.toRowMajor();
+        assert(back.getRows() == 19);
+        assert(back.getCols() == 30);
+        for (size_t y = 0; y < 19; ++y) {
+            for (size_t x = 0; x < 30; ++x) {
+                assert(back(y, x) == pixelValue(x, y));
+            }
+        }
+    }
+}
+
+void testSetLayout() {
+    PixelBuffer<double> buffer(17, 9, PixelLayout::ROW_MAJOR);
+    for (size_t y = 0; y < 9; ++y) {
+        for (size_t x = 0; x < 17; ++x) {
+            buffer(x, y) = pixelValue(x, y);
+        }
+    }
+
+    buffer.setLayout(PixelLayout::MORTON);
+    assert(buffer.getLayout() == PixelLayout::MORTON);
+    buffer.setLayout(PixelLayout::TILED);
+    assert(buffer.getLayout() == PixelLayout::TILED);
+
+    for (size_t y = 0; y < 9; ++y) {
+        for (size_t x = 0; x < 17; ++x) {
+            assert(buffer(x, y) == pixelValue(x, y));
+        }
+    }
+}
+
+void testImageLayouts() {
+    Image rowMajor(20, 12);
+    Image tiled(20, 12, PixelLayout::TILED);
+    Image morton(20, 12, PixelLayout::MORTON);
+    assert(rowMajor.getLayout() == PixelLayout::ROW_MAJOR);
+    assert(tiled.getLayout() == PixelLayout::TILED);
+    assert(morton.getLayout() == PixelLayout::MORTON);
+    assert(tiled.isValid() && morton.isValid());
+
+    for (size_t y = 0; y < 12; ++y) {
+        for (size_t x = 0; x < 20; ++x) {
+            RGBA_Color color(x / 20.0, y / 12.0, 0.5, 1.0);
+            rowMajor.setPixel(x, y, color);
+            tiled.setPixel(x, y, color);
+            morton.setPixel(x, y, color);
+        }
+    }
+
+    // Same pixels whatever the layout
+    math::Matrix<RGBA_Color> expected = rowMajor.getPixelMatrix();
+    math::Matrix<RGBA_Color> fromTiled = tiled.getPixelMatrix();
+    math::Matrix<RGBA_Color> fromMorton = morton.getPixelMatrix();
+    for (size_t y = 0; y < 12; ++y) {
+        for (size_t x = 0; x < 20; ++x) {
+            assert(tiled.getPixel(x, y) == rowMajor.getPixel(x, y));
+            assert(fromTiled(y, x) == expected(y, x));
+            assert(fromMorton(y, x) == expected(y, x));
+        }
+    }
+
+    // Bounds are checked on the logical size, not the padded storage
+    bool exceptionThrown = false;
+    try {
+        tiled.getPixel(20, 0);
+    } catch (const std::out_of_range&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+
+    // Layout changes and resizes keep the pixels
+    tiled.setLayout(PixelLayout::ROW_MAJOR);
+    assert(tiled.getPixel(13, 9) == rowMajor.getPixel(13, 9));
+    morton.resize(10, 6);
+    assert(morton.getLayout() == PixelLayout::MORTON);
+    assert(morton.getPixel(9, 5) == rowMajor.getPixel(9, 5));
+
+    // Copies keep the layout
+    Image copy = morton;
+    assert(copy.getLayout() == PixelLayout::MORTON);
+    assert(copy.getPixel(3, 4) == morton.getPixel(3, 4));
+}
+
+void testReductions() {
+    const double inf = std::numeric_limits<double>::infinity();
+    const PixelLayout layouts[] = {PixelLayout::ROW_MAJOR, PixelLayout::TILED, PixelLayout::MORTON};
+    for (PixelLayout layout : layouts) {
+        // Partial tiles: the padding holds -5 and must not count
+        PixelBuffer<double> padded(30, 19, -5.0, layout);
+        PixelBuffer<double> full(16, 16, -5.0, layout);
+        for (PixelBuffer<double>* buffer : {&padded, &full}) {
+            double expectedSum = 0.0;
+            for (size_t y = 0; y < buffer->getHeight(); ++y) {
+                for (size_t x = 0; x < buffer->getWidth(); ++x) {
+                    (*buffer)(x, y) = pixelValue(x, y);
+                    expectedSum += pixelValue(x, y);
+                }
+            }
+            (*buffer)(3, 2) = inf;
+            expectedSum -= pixelValue(3, 2);
+
+            assert(buffer->min() == 0.0);
+            assert(buffer->max() == inf);
+            assert(buffer->max(true) == pixelValue(buffer->getWidth() - 1, buffer->getHeight() - 1));
+            assert(buffer->sum(true) == expectedSum);
+
+            buffer->map([](double v) { return v * 2.0; });
+            assert(buffer->sum(true) == 2.0 * expectedSum);
+            assert((*buffer)(1, 1) == 2.0 * pixelValue(1, 1));
+
+            buffer->fill(1.0);
+            assert(buffer->sum() == static_cast<double>(buffer->getWidth() * buffer->getHeight()));
+        }
+    }
+}
@@ -1,7 +1,10 @@
 #include <iostream>
 #include <cassert>
+#include <chrono>
 #include <cmath>
+#include <random>
 #include <stdexcept>
+#include <vector>
 #include "../Lib/Geometry/Quaternion.h"
 #include "../Lib/Geometry/Vector3D.h"
 #include "../Lib/Math/math_common.h"
@@ -37,6 +40,8 @@ void testQuaternionInterpolation();
 void testQuaternionConversions();
 void testQuaternionErrorHandling();
 void testQuaternionStaticMethods();
+void testQuaternionBatch();
+void testQuaternionConstexpr();
 
 int main() {
     std::cout << "=== Quaternion Test Suite ===" << std::endl;
@@ -68,6 +73,12 @@ int main() {
         
         testQuaternionErrorHandling();
         std::cout << "✓ Quaternion error handling test passed" << std::endl;
+
+        testQuaternionBatch();
+        std::cout << "✓ Quaternion batch test passed" << std::endl;
+
+        testQuaternionConstexpr();
+        std::cout << "✓ Quaternion constexpr test passed" << std::endl;
         
         std::cout << "\n🎉 All quaternion tests passed successfully!" << std::endl;
         
@@ -374,4 +385,110 @@ void testQuaternionErrorHandling() {
     // Test t > 1 (should clamp to 1)
     Quaternion result2 = Quaternion::slerp(q1, q2, 1.5);
     assert(isQuaternionEqual(result2, q2, 1e-5));
-}
\ No newline at end of file
+}
+
+void testQuaternionBatch() {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> component(-1.0, 1.0);
+    std::uniform_real_distribution<double> parameter(-0.2, 1.2);
+
+    // Batch rotation gives the vectors of operator*, even for a non-unit quaternion
+    const size_t count = 1000000;
+    std::vector<Vector3D> vectors(count), rotated(count);
+    for (Vector3D& v : vectors) {
+        v = Vector3D(component(rng), component(rng), component(rng));
+    }
+    for (const Quaternion& q : {Quaternion(Vector3D(1, 2, 3), 0.8), Quaternion(0.5, -1.0, 0.25, 2.0)}) {
+        q.rotate(vectors.data(), rotated.data(), count);
+        for (size_t i = 0; i < count; i += 997) {
+            assert(isVector3Equal(rotated[i], q * vectors[i], 1e-12));
+        }
+    }
+
+    // In place
+    Quaternion turn(Vector3D(0, 0, 1), math::pi / 2);
+    std::vector<Vector3D> axes = {Vector3D(1, 0, 0), Vector3D(0, 1, 0)};
+    turn.rotate(axes.data(), axes.data(), axes.size());
+    assert(isVector3Equal(axes[0], Vector3D(0, 1, 0), 1e-12));
+    assert(isVector3Equal(axes[1], Vector3D(-1, 0, 0), 1e-12));
+
+    // Interpolation and normalization match the scalar versions, opposite pairs and close pairs included
+    const size_t tracks = 100000;
+    std::vector<Quaternion> from(tracks), to(tracks), out(tracks);
+    std::vector<double> t(tracks);
+    for (size_t i = 0; i < tracks; ++i) {
+        from[i] = Quaternion(component(rng), component(rng), component(rng), component(rng));
+        to[i] = i % 3 == 0 ? from[i] * -1.001 : i % 3 == 1 ? from[i] + Quaternion(1e-4, 0, 0, 0)
+                           : Quaternion(component(rng), component(rng), component(rng), component(rng));
+        t[i] = parameter(rng);
+    }
+    Quaternion::slerp(from.data(), to.data(), t.data(), out.data(), tracks);
+    for (size_t i = 0; i < tracks; ++i) {
+        assert(isQuaternionEqual(out[i], Quaternion::slerp(from[i], to[i], t[i]), 1e-9));
+    }
+    Quaternion::nlerp(from.data(), to.data(), t.data(), out.data(), tracks);
+    for (size_t i = 0; i < tracks; ++i) {
+        assert(isQuaternionEqual(out[i], Quaternion::nlerp(from[i], to[i], t[i]), 1e-12));
+    }
+    out = from;
+    Quaternion::normalize(out.data(), tracks);
+    for (size_t i = 0; i < tracks; ++i) {
+        assert(isQuaternionEqual(out[i], from[i].normalize(), 1e-12));
+    }
+
+    // Zero quaternions are reported, and left unchanged by normalize
+    std::vector<Quaternion> withZero = {Quaternion(2, 0, 0, 0), Quaternion(0, 0, 0, 0)};
+    try {
+        Quaternion::normalize(withZero.data(), withZero.size());
+        assert(false);  // Should not reach here
+    } catch (const std::invalid_argument&) {
+        assert(isQuaternionEqual(withZero[0], Quaternion::identity()));
+        assert(isQuaternionEqual(withZero[1], Quaternion(0, 0, 0, 0)));
+    }
+    try {
+        Quaternion::slerp(withZero.data(), withZero.data() + 1, t.data(), out.data(), 1);
+        assert(false);  // Should not reach here
+    } catch (const std::invalid_argument&) {
+        // Expected
+    }
+
+    // Against the scalar path
+    Quaternion q(Vector3D(1, 2, 3), 0.8);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        rotated[i] = q * vectors[i];
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    q.rotate(vectors.data(), rotated.data(), count);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  Rotating " << count << " vectors: scalar "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, batch "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < tracks; ++i) {
+        out[i] = Quaternion::slerp(from[i], to[i], t[i]);
+    }
+    middle = std::chrono::high_resolution_clock::now();
+    Quaternion::slerp(from.data(), to.data(), t.data(), out.data(), tracks);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "  Slerp of " << tracks << " tracks: scalar "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, batch "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+}
+
+void testQuaternionConstexpr() {
+    // A quarter turn around z, built and applied at compile time
+    constexpr double h = 0.70710678118654752440;
+    constexpr Quaternion quarter(h, 0.0, 0.0, h);
+    constexpr Vector3D turned = quarter * Vector3D::UNIT_X;
+    static_assert(turned == Vector3D::UNIT_Y);
+    static_assert((quarter * quarter.conjugate()).isUnit());
+    static_assert(quarter.inverse().dot(quarter.conjugate()) > 1.0 - 1e-12);
+    static_assert(Quaternion::identity().w() == Quaternion::IDENTITY.w());
+    static_assert((quarter * quarter * Vector3D::UNIT_X) == Vector3D(-1.0, 0.0, 0.0));
+
+    static_assert(noexcept(quarter * quarter) && noexcept(quarter * Vector3D::UNIT_X));
+    static_assert(!noexcept(quarter.inverse()) && !noexcept(quarter.normalize()));
+    assert(isVector3Equal(turned, Quaternion(Vector3D(0, 0, 1), math::pi / 2) * Vector3D(1, 0, 0), 1e-12));
+}
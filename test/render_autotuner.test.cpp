@@ -0,0 +1,183 @@
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+#include "../Lib/Rendering/RenderAutotuner.h"
+#include "../Lib/Rendering/RenderSchedule.h"
+#include "../Lib/Rendering/CameraHelper.h"
+#include "../Lib/Rendering/World.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Box.h"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testScheduledPixelCoverage();
+void testCandidateSchedules();
+void testTuneCaching();
+void testScheduledRendersMatch();
+
+int main() {
+    std::cout << "Running RenderAutotuner tests..." << std::endl;
+
+    try {
+        testScheduledPixelCoverage();
+        std::cout << "✓ Scheduled pixel coverage tests passed" << std::endl;
+
+        testCandidateSchedules();
+        std::cout << "✓ Candidate schedule tests passed" << std::endl;
+
+        testTuneCaching();
+        std::cout << "✓ Tune caching tests passed" << std::endl;
+
+        testScheduledRendersMatch();
+        std::cout << "✓ Scheduled render tests passed" << std::endl;
+
+        std::cout << "All RenderAutotuner tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+static void buildScene(World& world) {
+    world.getCamera().setViewport(makeTestViewport());
+
+    world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 0), 4.0), RGBA_Color(1, 1, 1, 1)));
+    world.addObject(Shape<Box>(Box(Vector3D(5, 3, 10), 3.0, 3.0, 3.0, Vector3D(0, 0, 1)), RGBA_Color(1, 0, 0, 1)));
+    world.addObject(Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.2, 0.8, 1.0)));
+    world.addLight(Light(Vector3D(0, 5, -5), RGBA_Color(1, 1, 1, 1), 3.0));
+}
+
+void testScheduledPixelCoverage() {
+    // Every pixel visited exactly once, including partial tiles and odd team sizes
+    const size_t width = 45, height = 23;
+    size_t tileSizes[] = {1, 5, 8, 64};
+    for (size_t tileSize : tileSizes) {
+        RenderSchedule schedule;
+        schedule.tileSize = tileSize;
+        schedule.chunkSize = 3;
+        schedule.threadCount = 3;
+
+        math::Matrix<int> visits(height, width, 0);
+        forEachPixel(width, height, schedule, [&](size_t x, size_t y) {
+            #pragma omp atomic
+            visits(y, x) += 1;
+        });
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                assert(visits(y, x) == 1);
+            }
+        }
+    }
+
+    // The default schedule is the historical one
+    RenderSchedule defaults;
+    assert(defaults.tileSize == PIXEL_TILE_SIZE && defaults.chunkSize == 1 && defaults.threadCount == 0);
+    assert(defaults.resolvedThreadCount() >= 1);
+
+    // Invalid schedules are refused by the camera
+    Camera camera(Rectangle(Vector3D(0, 0, 0), Vector3D(10, 0, 0), Vector3D(0, 10, 0)));
+    RenderSchedule invalid;
+    invalid.tileSize = 0;
+    bool exceptionThrown = false;
+    try {
+        camera.setRenderSchedule(invalid);
+    } catch (const std::invalid_argument&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+    assert(camera.getRenderSchedule() == RenderSchedule());
+}
+
+void testCandidateSchedules() {
+    math::Vector<RenderSchedule> candidates = RenderAutotuner::candidateSchedules();
+    assert(candidates.size() >= 8);
+    for (const RenderSchedule& candidate : candidates) {
+        assert(candidate.tileSize > 0 && candidate.chunkSize > 0);
+        assert(candidate.threadCount >= 1 && candidate.threadCount <= omp_get_max_threads());
+    }
+}
+
+void testTuneCaching() {
+    World world;
+    buildScene(world);
+
+    RenderSchedule tuned = world.autotune(64, 64);
+    assert(world.getCamera().getRenderSchedule() == tuned);
+    assert(world.getAutotuner().getCacheSize() == 1);
+
+    // Same scene and resolution: cached
+    assert(world.autotune(64, 64) == tuned);
+    assert(world.getAutotuner().getCacheSize() == 1);
+
+    // The frames of a camera orbit reuse the tuned schedule
+    for (int frame = 1; frame <= 3; ++frame) {
+        Vector3D origin(-10.0 + frame, -10, -5.0 - frame);
+        world.getCamera().setViewport(Rectangle(origin, origin + Vector3D(20.0, 0, 0), origin + Vector3D(0, 20.0, 0)));
+        assert(world.autotune(64, 64) == tuned);
+    }
+    assert(world.getAutotuner().getCacheSize() == 1);
+
+    // The tuned schedule is one of the candidates
+    bool isCandidate = false;
+    for (const RenderSchedule& candidate : RenderAutotuner::candidateSchedules()) {
+        isCandidate = isCandidate || candidate == tuned;
+    }
+    assert(isCandidate);
+
+    // A new resolution or a changed scene is tuned again
+    world.autotune(32, 32);
+    assert(world.getAutotuner().getCacheSize() == 2);
+    world.addLight(Light(Vector3D(5, 5, -5), RGBA_Color(1, 1, 1, 1), 1.0));
+    world.autotune(32, 32);
+    assert(world.getAutotuner().getCacheSize() == 3);
+
+    world.getAutotuner().clearCache();
+    assert(world.getAutotuner().getCacheSize() == 0);
+
+    bool exceptionThrown = false;
+    try {
+        world.autotune(0, 32);
+    } catch (const std::invalid_argument&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+}
+
+void testScheduledRendersMatch() {
+    World world;
+    buildScene(world);
+    Image reference = world.renderScene3DLight(40, 40);
+    Image referenceColor = world.renderScene3DColor(40, 40);
+
+    // Any schedule renders the same pixels
+    for (const RenderSchedule& candidate : RenderAutotuner::candidateSchedules()) {
+        world.getCamera().setRenderSchedule(candidate);
+        assert(sameImage(world.renderScene3DLight(40, 40), reference));
+        assert(sameImage(world.renderScene3DColor(40, 40), referenceColor));
+    }
+
+    RenderPlan plan;
+    plan.method = Camera::AntiAliasingMethod::SSAA;
+    plan.samplesPerPixel = 4;
+    world.getCamera().setRenderSchedule(RenderSchedule());
+    Image referenceSSAA = world.renderScene3DLight(40, 40, plan);
+    plan.ssaaStrategy = SSAAStrategy::TILED;
+    plan.tileSize = 16;
+
+    world.autotune(40, 40);
+    assert(sameImage(world.renderScene3DLight(40, 40), reference));
+    assert(sameImage(world.renderScene3DLight(40, 40, plan), referenceSSAA));
+}
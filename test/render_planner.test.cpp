@@ -0,0 +1,297 @@
+#include <iostream>
+#include <cassert>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include "../Lib/Rendering/RenderPlanner.h"
+#include "../Lib/Rendering/World.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Video.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Box.h"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+static const std::string STREAM_DIRECTORY = "./test/test_by_product/render_planner_frames";
+
+// Test function declarations
+void testEstimates();
+void testPlanChoices();
+void testPlanRefusals();
+void testTiledSSAAMatchesFullFrame();
+void testFrameStreaming();
+void testWorldPlannedRender();
+
+int main() {
+    std::cout << "Running RenderPlanner tests..." << std::endl;
+
+    try {
+        testEstimates();
+        std::cout << "✓ Memory estimate tests passed" << std::endl;
+
+        testPlanChoices();
+        std::cout << "✓ Plan choice tests passed" << std::endl;
+
+        testPlanRefusals();
+        std::cout << "✓ Plan refusal tests passed" << std::endl;
+
+        testTiledSSAAMatchesFullFrame();
+        std::cout << "✓ Tiled SSAA tests passed" << std::endl;
+
+        testFrameStreaming();
+        std::cout << "✓ Frame streaming tests passed" << std::endl;
+
+        testWorldPlannedRender();
+        std::cout << "✓ World planned render tests passed" << std::endl;
+
+        std::filesystem::remove_all(STREAM_DIRECTORY);
+        std::cout << "All RenderPlanner tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+static RenderRequest makeRequest(size_t width, size_t height, size_t samplesPerPixel, Camera::AntiAliasingMethod method, size_t frameCount = 1) {
+    RenderRequest request;
+    request.imageWidth = width;
+    request.imageHeight = height;
+    request.samplesPerPixel = samplesPerPixel;
+    request.method = method;
+    request.frameCount = frameCount;
+    request.shapeCount = 100;
+    request.lightCount = 2;
+    return request;
+}
+
+void testEstimates() {
+    // Images are padded to whole tiles
+    assert(RenderPlanner::estimateImageBytes(8, 8) == 64 * sizeof(RGBA_Color));
+    assert(RenderPlanner::estimateImageBytes(9, 8) == 128 * sizeof(RGBA_Color));
+    assert(RenderPlanner::estimateSceneBytes(0, 0) == 0);
+    assert(RenderPlanner::estimateSceneBytes(10, 1) > RenderPlanner::estimateSceneBytes(5, 1));
+
+    RenderPlanner planner(size_t(1) << 30);
+    RenderRequest still = makeRequest(64, 64, 8, Camera::AntiAliasingMethod::SSAA);
+
+    // Full-frame SSAA holds the image upscaled 4 times per axis
+    MemoryEstimate full = planner.estimate(still, SSAAStrategy::FULL_FRAME, 0, FrameStorage::IN_MEMORY);
+    assert(full.framebufferBytes == RenderPlanner::estimateImageBytes(64, 64));
+    assert(full.supersampleBytes == RenderPlanner::estimateImageBytes(256, 256));
+    assert(full.frameStoreBytes == 0);
+    assert(full.sceneBytes >= RenderPlanner::estimateSceneBytes(100, 2));
+    assert(full.total() == full.framebufferBytes + full.supersampleBytes + full.frameStoreBytes + full.sceneBytes);
+
+    // Tile buffers grow with the tile area, not with the image
+    MemoryEstimate tiled = planner.estimate(still, SSAAStrategy::TILED, 8, FrameStorage::IN_MEMORY);
+    assert(tiled.supersampleBytes > 0);
+    assert(tiled.framebufferBytes == full.framebufferBytes);
+    assert(planner.estimate(still, SSAAStrategy::TILED, 16, FrameStorage::IN_MEMORY).supersampleBytes == 4 * tiled.supersampleBytes);
+
+    // Frames kept in memory grow with the animation, streamed ones do not
+    RenderRequest animation = makeRequest(64, 64, 4, Camera::AntiAliasingMethod::NONE, 10);
+    MemoryEstimate inMemory = planner.estimate(animation, SSAAStrategy::FULL_FRAME, 0, FrameStorage::IN_MEMORY);
+    MemoryEstimate streamed = planner.estimate(animation, SSAAStrategy::FULL_FRAME, 0, FrameStorage::STREAMING);
+    assert(inMemory.frameStoreBytes >= 10 * RenderPlanner::estimateImageBytes(64, 64));
+    assert(streamed.frameStoreBytes == 0);
+    assert(inMemory.supersampleBytes == 0);
+}
+
+void testPlanChoices() {
+    // Everything fits
+    RenderPlanner roomy(size_t(64) << 30);
+    RenderPlan plan = roomy.plan(makeRequest(320, 180, 8, Camera::AntiAliasingMethod::SSAA, 5));
+    assert(plan.method == Camera::AntiAliasingMethod::SSAA);
+    assert(plan.samplesPerPixel == 8);
+    assert(plan.ssaaStrategy == SSAAStrategy::FULL_FRAME);
+    assert(plan.frameStorage == FrameStorage::IN_MEMORY);
+    assert(plan.estimate.total() <= roomy.getMemoryBudget());
+
+    // 1080p at 16 spp needs a 15360x8640 upscaled frame, about 4 GiB: tiled instead
+    RenderRequest heavy = makeRequest(1920, 1080, 16, Camera::AntiAliasingMethod::SSAA);
+    RenderPlanner medium(size_t(2) << 30);
+    plan = medium.plan(heavy);
+    assert(plan.ssaaStrategy == SSAAStrategy::TILED);
+    assert(plan.tileSize >= PIXEL_TILE_SIZE);
+    assert(plan.estimate.total() <= medium.getMemoryBudget());
+
+    // A long 1080p animation does not fit in memory: frames are streamed, SSAA stays full-frame if it can
+    RenderRequest animation = makeRequest(1920, 1080, 4, Camera::AntiAliasingMethod::SSAA, 600);
+    plan = medium.plan(animation);
+    assert(plan.frameStorage == FrameStorage::STREAMING);
+    assert(plan.ssaaStrategy == SSAAStrategy::FULL_FRAME);
+    assert(plan.estimate.frameStoreBytes == 0);
+
+    // Without SSAA only the frame storage is chosen
+    plan = medium.plan(makeRequest(1920, 1080, 4, Camera::AntiAliasingMethod::NONE, 600));
+    assert(plan.method == Camera::AntiAliasingMethod::NONE);
+    assert(plan.frameStorage == FrameStorage::STREAMING);
+    assert(plan.estimate.supersampleBytes == 0);
+}
+
+void testPlanRefusals() {
+    // The output image alone exceeds the budget
+    RenderPlanner tiny(1 << 20);
+    bool exceptionThrown = false;
+    try {
+        tiny.plan(makeRequest(1920, 1080, 16, Camera::AntiAliasingMethod::SSAA, 100));
+    } catch (const std::runtime_error& e) {
+        exceptionThrown = std::string(e.what()).find("memory budget") != std::string::npos;
+    }
+    assert(exceptionThrown);
+
+    // Invalid requests
+    RenderPlanner planner(size_t(1) << 30);
+    exceptionThrown = false;
+    try {
+        planner.plan(makeRequest(64, 64, 6, Camera::AntiAliasingMethod::SSAA));
+    } catch (const std::invalid_argument&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+
+    exceptionThrown = false;
+    try {
+        planner.plan(makeRequest(0, 64, 4, Camera::AntiAliasingMethod::NONE));
+    } catch (const std::invalid_argument&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+
+    exceptionThrown = false;
+    try {
+        RenderPlanner noBudget(0);
+    } catch (const std::invalid_argument&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+}
+
+static void buildScene(World& world) {
+    world.getCamera().setViewport(makeTestViewport());
+
+    world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 0), 4.0), RGBA_Color(1, 1, 1, 1)));
+    world.addObject(Shape<Box>(Box(Vector3D(5, 3, 10), 3.0, 3.0, 3.0, Vector3D(0, 0, 1)), RGBA_Color(1, 0, 0, 1)));
+    world.addObject(Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.2, 0.8, 1.0)));
+    world.addObject(Shape<Plane>(Plane(Vector3D(0, -10, 0), Vector3D(0, 1, 0)), RGBA_Color(0.2, 0.2, 0.8, 1.0)));
+    world.addLight(Light(Vector3D(0, 5, -5), RGBA_Color(1, 1, 1, 1), 3.0));
+}
+
+void testTiledSSAAMatchesFullFrame() {
+    World world;
+    buildScene(world);
+    const Camera& camera = world.getCamera();
+
+    RenderRequest request = world.makeRenderRequest(36, 36, 4, Camera::AntiAliasingMethod::SSAA);
+    assert(request.shapeCount == 4 && request.lightCount == 1);
+
+    // Same samples and same resolve, whatever the tile size (5 does not divide the image)
+    RenderPlan fullPlan;
+    fullPlan.method = Camera::AntiAliasingMethod::SSAA;
+    fullPlan.samplesPerPixel = 4;
+    Image full = world.renderScene3DLight(36, 36, fullPlan);
+
+    RenderPlan tiledPlan = fullPlan;
+    tiledPlan.ssaaStrategy = SSAAStrategy::TILED;
+    tiledPlan.tileSize = 8;
+    assert(sameImage(world.renderScene3DLight(36, 36, tiledPlan), full));
+    tiledPlan.tileSize = 5;
+    assert(sameImage(world.renderScene3DLight(36, 36, tiledPlan), full));
+
+    // Advanced shading too
+    math::Vector<Light> lights(1);
+    lights[0] = Light(Vector3D(0, 5, -5), RGBA_Color(1, 1, 1, 1), 3.0);
+    math::Vector<Camera::ShapeVariant> sceneShapes(2);
+    sceneShapes[0] = Shape<Sphere>(Sphere(Vector3D(0, 0, 0), 4.0), RGBA_Color(1, 1, 1, 1));
+    sceneShapes[1] = Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.2, 0.8, 1.0));
+    Image advancedFull = camera.renderScene3DLight_Advanced_AA(24, 24, sceneShapes, lights, 8, Camera::AntiAliasingMethod::SSAA);
+    assert(sameImage(camera.renderScene3DLight_SSAATiled(24, 24, sceneShapes, lights, 8, 16, true), advancedFull));
+
+    bool exceptionThrown = false;
+    try {
+        camera.renderScene3DLight_SSAATiled(24, 24, sceneShapes, lights, 8, 0);
+    } catch (const std::invalid_argument&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+}
+
+void testFrameStreaming() {
+    std::filesystem::remove_all(STREAM_DIRECTORY);
+
+    Video video(16, 16, 24.0);
+    Image frame(16, 16);
+    video.addFrame(frame);
+    assert(!video.isStreaming());
+
+    // Held frames are flushed when streaming starts
+    video.enableFrameStreaming(STREAM_DIRECTORY);
+    assert(video.isStreaming());
+    assert(video.getFrames().empty());
+    assert(video.getFrameCount() == 1);
+    for (int i = 0; i < 3; ++i) {
+        frame.setPixel(i, i, RGBA_Color(0, 1, 0, 1));
+        video.addFrame(frame);
+    }
+    assert(video.getFrameCount() == 4);
+    assert(video.getFrames().empty());
+    assert(std::filesystem::exists(STREAM_DIRECTORY + "/frame_000000.bmp"));
+    assert(std::filesystem::exists(STREAM_DIRECTORY + "/frame_000003.bmp"));
+    assert(video.getStats().frameCount == 4);
+
+    // In-memory only operations are refused
+    bool exceptionThrown = false;
+    try {
+        video.getFrame(0);
+    } catch (const std::logic_error&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+
+    exceptionThrown = false;
+    try {
+        video.reverseFrames();
+    } catch (const std::logic_error&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+
+    // Frame sequences are copied from the stream
+    video.exportFrameSequence(STREAM_DIRECTORY, "sequence");
+    assert(std::filesystem::exists(STREAM_DIRECTORY + "/sequence_frame_3.bmp"));
+
+    video.clearFrames();
+    assert(video.getFrameCount() == 0);
+    assert(!std::filesystem::exists(STREAM_DIRECTORY + "/frame_000000.bmp"));
+}
+
+void testWorldPlannedRender() {
+    World world;
+    buildScene(world);
+
+    RenderPlanner planner(size_t(1) << 30);
+    RenderPlan plan = planner.plan(world.makeRenderRequest(32, 32, 4, Camera::AntiAliasingMethod::NONE));
+    assert(sameImage(world.renderScene3DLight(32, 32, plan), world.renderScene3DLight(32, 32)));
+
+    // A budget that only fits small tiles still renders the full-frame image
+    RenderRequest request = world.makeRenderRequest(32, 32, 8, Camera::AntiAliasingMethod::SSAA);
+    MemoryEstimate fullEstimate = planner.estimate(request, SSAAStrategy::FULL_FRAME, 0, FrameStorage::IN_MEMORY);
+    RenderPlanner tight(fullEstimate.total() - 1);
+    plan = tight.plan(request);
+    assert(plan.ssaaStrategy == SSAAStrategy::TILED);
+
+    RenderPlan fullPlan = plan;
+    fullPlan.ssaaStrategy = SSAAStrategy::FULL_FRAME;
+    assert(sameImage(world.renderScene3DLight(32, 32, plan), world.renderScene3DLight(32, 32, fullPlan)));
+}
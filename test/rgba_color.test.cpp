@@ -3,6 +3,7 @@
 #include <cmath>
 #include <stdexcept>
 #include <sstream>
+#include <type_traits>
 #include "../Lib/Rendering/RGBA_Color.h"
 #include "../Lib/Math/Vector.hpp"
 
@@ -20,6 +21,7 @@ void testRGBAColorComponentSetters();
 void testRGBAColorUtilityMethods();
 void testRGBAColorVectorOperations();
 void testRGBAColorConvenienceFunctions();
+void testRGBAColorConstexpr();
 void testRGBAColorErrorHandling();
 
 int main() {
@@ -44,6 +46,9 @@ int main() {
         testRGBAColorConvenienceFunctions();
         std::cout << "✓ RGBA_Color convenience functions test passed" << std::endl;
         
+        testRGBAColorConstexpr();
+        std::cout << "✓ RGBA_Color constexpr test passed" << std::endl;
+        
         testRGBAColorErrorHandling();
         std::cout << "✓ RGBA_Color error handling test passed" << std::endl;
         
@@ -358,3 +363,20 @@ void testRGBAColorErrorHandling() {
         assert(true);
     }
 }
+
+// Test compile-time colors
+void testRGBAColorConstexpr() {
+    constexpr RGBA_Color orange(1.0, 0.5, 0.0);
+    constexpr RGBA_Color dim = orange * 0.5;
+    static_assert(dim.r() == 0.5 && dim.g() == 0.25 && dim.a() == 0.5);
+    static_assert(RGBA_Color(2.0, -1.0, 0.5, 1.0) == RGBA_Color(1.0, 0.0, 0.5, 1.0));
+    static_assert(Colors::red() + Colors::green() == RGBA_Color(1.0, 1.0, 0.0, 1.0));
+    static_assert(Colors::white().lerp(Colors::black(), 0.5).r() == 0.5);
+    static_assert(orange.alphaBlend(Colors::blue()) == orange);
+
+    // Plain values, copied without allocating
+    static_assert(std::is_trivially_copyable_v<RGBA_Color>);
+    static_assert(noexcept(orange * Colors::blue()) && noexcept(RGBA_Color(orange)));
+    RGBA_Color copy = dim;
+    assert(copy == dim);
+}
@@ -0,0 +1,359 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include "../Lib/Rendering/SceneChanges.h"
+#include "../Lib/Rendering/World.h"
+#include "../Lib/Rendering/ShadowMap.h"
+#include "../Lib/Rendering/Lightmap.h"
+#include "../Lib/Rendering/IrradianceCache.h"
+#include "../Lib/Rendering/Material.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testChangeVersions();
+void testObjectChanges();
+void testLightChanges();
+void testRemovals();
+void testCameraOnlyAnimation();
+void testMovedLightRebuildsItsShadowMap();
+void testObjectChangeRebuildsLighting();
+
+int main() {
+    std::cout << "Running scene change tests..." << std::endl;
+
+    try {
+        testChangeVersions();
+        std::cout << "✓ Change version tests passed" << std::endl;
+
+        testObjectChanges();
+        std::cout << "✓ Object change tests passed" << std::endl;
+
+        testLightChanges();
+        std::cout << "✓ Light change tests passed" << std::endl;
+
+        testRemovals();
+        std::cout << "✓ Removal tests passed" << std::endl;
+
+        testCameraOnlyAnimation();
+        std::cout << "✓ Camera only animation tests passed" << std::endl;
+
+        testMovedLightRebuildsItsShadowMap();
+        std::cout << "✓ Moved light tests passed" << std::endl;
+
+        testObjectChangeRebuildsLighting();
+        std::cout << "✓ Object change cache tests passed" << std::endl;
+
+        std::cout << "All scene change tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+namespace {
+
+    // A room of four walls around a few spheres, lit by a row of lights
+    World makeRoom(size_t lightCount) {
+        World world;
+        world.addObject(Shape<Plane>(Plane(Vector3D(0, 0, 20), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.8, 0.8, 1)));
+        world.addObject(Shape<Plane>(Plane(Vector3D(0, -10, 0), Vector3D(0, 1, 0)), RGBA_Color(0.6, 0.6, 0.6, 1)));
+        world.addObject(Shape<Rectangle>(Rectangle(Vector3D(-10, -10, 0), Vector3D(-10, 10, 0), Vector3D(-10, -10, 20)), RGBA_Color(0.8, 0.2, 0.2, 1)));
+        world.addObject(Shape<Rectangle>(Rectangle(Vector3D(10, -10, 0), Vector3D(10, 10, 0), Vector3D(10, -10, 20)), RGBA_Color(0.2, 0.8, 0.2, 1)));
+        for (int i = 0; i < 6; ++i) {
+            world.addObject(Shape<Sphere>(Sphere(Vector3D(-6.0 + 2.4 * i, -2.0 + (i % 2), 12.0), 1.0), RGBA_Color(0.2, 0.2, 0.9, 1)));
+        }
+        for (size_t l = 0; l < lightCount; ++l) {
+            world.addLight(Light(Vector3D(-6.0 + 12.0 * l / std::max<size_t>(1, lightCount - 1), 8, 6), RGBA_Color(1, 1, 1, 1), 0.5));
+        }
+        world.getCamera() = makeTestCamera();
+        world.getCamera().setShadowMode(Camera::ShadowMode::SHADOW_MAPPED);
+        return world;
+    }
+
+    bool sameMap(const ShadowMap& a, const ShadowMap& b) {
+        return a.position == b.position && a.depth == b.depth && a.occluder == b.occluder;
+    }
+
+}
+
+void testChangeVersions() {
+    ChangeVersions versions;
+    assert(versions.since(0) == ChangeKind::NONE);
+
+    versions.record(ChangeKind::ADDED, 1);
+    versions.record(ChangeKind::MATERIAL | ChangeKind::TRANSFORM, 4);
+    assert(versions.since(0) == (ChangeKind::ADDED | ChangeKind::MATERIAL | ChangeKind::TRANSFORM));
+    assert(versions.since(1) == (ChangeKind::MATERIAL | ChangeKind::TRANSFORM));
+    assert(versions.since(4) == ChangeKind::NONE);
+
+    assert(hasChange(ChangeKind::GEOMETRY | ChangeKind::MATERIAL, ChangeKind::MATERIAL));
+    assert(!hasChange(ChangeKind::GEOMETRY, ChangeKind::MATERIAL | ChangeKind::TRANSFORM));
+
+    SceneChangeSet changes;
+    assert(changes.empty() && !changes.invalidatesLighting() && !changes.changesObjectIndex());
+    changes.objectKinds = ChangeKind::MATERIAL;
+    assert(!changes.empty() && changes.invalidatesLighting() && !changes.changesObjectIndex());
+    changes.objectKinds |= ChangeKind::TRANSFORM;
+    assert(changes.changesObjectIndex());
+}
+
+void testObjectChanges() {
+    World world;
+    assert(world.getVersion() == 0);
+    auto sphere = world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 10), 1.0), RGBA_Color(1, 0, 0, 1)));
+    auto wall = world.addObject(Shape<Plane>(Plane(Vector3D(0, 0, 30), Vector3D(0, 0, -1)), RGBA_Color(0, 0, 1, 1)));
+
+    SceneChangeSet changes = world.getChanges(0);
+    assert(changes.objects.size() == 2);
+    assert(changes.objectChanges[0] == ChangeKind::ADDED && changes.objectChanges[1] == ChangeKind::ADDED);
+    assert(changes.changesObjectIndex() && !changes.changesLights());
+
+    // A material change leaves the spatial index alone
+    uint64_t frame = world.getVersion();
+    Bounds3D before = world.getObjectIndex().getBounds(0);
+    world.setObjectMaterial(sphere, Material(RGBA_Color(0, 1, 0, 1)));
+    changes = world.getChanges(frame);
+    assert(changes.objects.size() == 1 && changes.objects[0] == sphere);
+    assert(changes.objectChanges[0] == ChangeKind::MATERIAL);
+    assert(!changes.changesObjectIndex() && changes.invalidatesLighting());
+    assert(world.getObjectIndex().getBounds(0) == before);
+    assert(std::get<Shape<Sphere>>(world.getObject(sphere)).getColor()->g() == 1.0);
+
+    // A translation is a transform change, refitted in the index
+    frame = world.getVersion();
+    world.moveObject(sphere, Vector3D(2, 0, 0));
+    world.moveObject(wall, Vector3D(0, 0, 5));
+    changes = world.getChanges(frame);
+    assert(changes.objects.size() == 2);
+    assert(changes.objectKinds == ChangeKind::TRANSFORM && changes.changesObjectIndex());
+    assert(std::get<Shape<Sphere>>(world.getObject(sphere)).getGeometry()->getCenter().x() == 2.0);
+    assert(std::get<Shape<Plane>>(world.getObject(wall)).getGeometry()->getOrigin().z() == 35.0);
+    Ray ray(Vector3D(2, 0, 0), Vector3D(0, 0, 1));
+    assert(world.findClosestHit(ray) && world.findClosestHit(ray)->t < 10.0);
+
+    // Replacing a shape changes its geometry, and its material when the materials differ
+    frame = world.getVersion();
+    world.setObject(sphere, Shape<Sphere>(Sphere(Vector3D(0, 0, 10), 2.0), RGBA_Color(0, 1, 0, 1)));
+    changes = world.getChanges(frame);
+    assert(changes.objectChanges.size() == 1 && changes.objectChanges[0] == ChangeKind::GEOMETRY);
+    frame = world.getVersion();
+    world.setObjectAt(0, Shape<Sphere>(Sphere(Vector3D(0, 0, 10), 2.0), RGBA_Color(1, 1, 0, 1)));
+    changes = world.getChanges(frame);
+    assert(changes.objectChanges[0] == (ChangeKind::GEOMETRY | ChangeKind::MATERIAL));
+
+    // Changes accumulate between two queries
+    changes = world.getChanges(0);
+    assert(changes.objects.size() == 2);
+    assert(hasChange(changes.objectKinds, ChangeKind::ADDED | ChangeKind::GEOMETRY | ChangeKind::MATERIAL | ChangeKind::TRANSFORM));
+
+    bool threw = false;
+    try {
+        world.removeObject(sphere);
+        world.moveObject(sphere, Vector3D(1, 0, 0));
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+void testLightChanges() {
+    World world;
+    world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 10), 1.0), RGBA_Color(1, 0, 0, 1)));
+    auto key = world.addLight(Light(Vector3D(0, 10, 0), RGBA_Color(1, 1, 1, 1), 1.0));
+    auto fill = world.addLight(Light(Vector3D(5, 5, 5), RGBA_Color(1, 1, 1, 1), 0.5));
+
+    uint64_t frame = world.getVersion();
+    world.setLight(key, Light(Vector3D(0, 12, 0), RGBA_Color(1, 1, 1, 1), 1.0));
+    world.setLight(fill, Light(Vector3D(5, 5, 5), RGBA_Color(1, 0.5, 0.5, 1), 0.5));
+    SceneChangeSet changes = world.getChanges(frame);
+    assert(!changes.changesObjects() && changes.changesLights());
+    assert(changes.lights.size() == 2);
+    for (size_t i = 0; i < changes.lights.size(); ++i) {
+        if (changes.lights[i] == key) {
+            assert(changes.lightChanges[i] == ChangeKind::TRANSFORM);
+        } else {
+            assert(changes.lights[i] == fill && changes.lightChanges[i] == ChangeKind::MATERIAL);
+        }
+    }
+    assert(world.getLight(key).getPosition().y() == 12.0);
+
+    // Setting an identical light is not a change
+    frame = world.getVersion();
+    world.setLight(key, world.getLight(key));
+    assert(world.getVersion() == frame && world.getChanges(frame).empty());
+}
+
+void testRemovals() {
+    World world;
+    auto first = world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 10), 1.0)));
+    auto second = world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 20), 1.0)));
+    auto third = world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 30), 1.0)));
+    world.addLight(Light(Vector3D(0, 10, 0)));
+
+    uint64_t frame = world.getVersion();
+    world.moveObject(third, Vector3D(1, 0, 0));
+    world.removeObject(first);
+    // The last object took the freed index, its versions followed it
+    SceneChangeSet changes = world.getChanges(frame);
+    assert(changes.objectsRemoved && !changes.lightsRemoved);
+    assert(changes.objects.size() == 1 && changes.objects[0] == third);
+    assert(changes.objectChanges[0] == ChangeKind::TRANSFORM);
+    assert(world.containsObject(second));
+
+    // An object added and removed between two queries only shows as a removal
+    frame = world.getVersion();
+    auto transient = world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 40), 1.0)));
+    world.removeObject(transient);
+    changes = world.getChanges(frame);
+    assert(changes.objects.empty() && changes.objectsRemoved);
+
+    frame = world.getVersion();
+    world.removeLightAt(0);
+    changes = world.getChanges(frame);
+    assert(changes.lightsRemoved && !changes.changesObjects());
+
+    frame = world.getVersion();
+    world.clearObjects();
+    assert(world.getChanges(frame).objectsRemoved);
+}
+
+void testCameraOnlyAnimation() {
+    World world = makeRoom(3);
+    auto irradiance = std::make_shared<IrradianceCache>();
+    world.getCamera().setIrradianceCache(irradiance);
+    world.bakeShadowMaps(32);
+    world.bakeLightmaps(1.0, 20.0);
+    world.updateCaches();
+    world.renderScene3DLight(24, 24);
+    size_t records = irradiance->getRecordCount();
+    assert(records > 0);
+
+    auto shadowMaps = world.getCamera().getShadowMaps();
+    auto lightmaps = world.getCamera().getLightmaps();
+    uint64_t frame = world.getVersion();
+    for (int f = 0; f < 5; ++f) {
+        world.getCamera().translate(Vector3D(0.2, 0, 0));
+        assert(world.getChanges(frame).empty());
+        world.updateCaches();
+        // Everything is reused, the irradiance records included
+        assert(world.getCamera().getShadowMaps() == shadowMaps);
+        assert(world.getCamera().getLightmaps() == lightmaps);
+        world.renderScene3DLight(24, 24);
+        assert(irradiance->getRecordCount() >= records);
+        records = irradiance->getRecordCount();
+    }
+}
+
+void testMovedLightRebuildsItsShadowMap() {
+    const size_t lightCount = 8;
+    const size_t resolution = 48;
+    World world = makeRoom(lightCount);
+    const ShadowMapSet before = world.bakeShadowMaps(resolution);
+    world.bakeLightmaps(1.0, 20.0);
+    auto lightmaps = world.getCamera().getLightmaps();
+    auto irradiance = std::make_shared<IrradianceCache>();
+    world.getCamera().setIrradianceCache(irradiance);
+    world.renderScene3DLight(16, 16);
+    assert(irradiance->getRecordCount() > 0);
+
+    World::LightHandle moved = world.getChanges(0).lights[3];
+    size_t movedIndex = 3;
+    Light light = world.getLight(moved);
+    light.setPosition(light.getPosition() + Vector3D(1.5, -1.0, 0.5));
+
+    uint64_t frame = world.getVersion();
+    world.setLight(moved, light);
+    SceneChangeSet changes = world.getChanges(frame);
+    assert(!changes.changesObjectIndex() && changes.invalidatesLighting());
+
+    const size_t reinsertions = world.getObjectIndex().getReinsertionCount();
+    auto start = std::chrono::high_resolution_clock::now();
+    world.updateCaches();
+    auto end = std::chrono::high_resolution_clock::now();
+    double updateMs = std::chrono::duration<double, std::milli>(end - start).count();
+    assert(world.getObjectIndex().getReinsertionCount() == reinsertions);
+
+    // Only the map of the moved light differs, and it equals a full build
+    auto afterMaps = world.getCamera().getShadowMaps();
+    const ShadowMapSet& after = *afterMaps;
+    start = std::chrono::high_resolution_clock::now();
+    World reference = makeRoom(lightCount);
+    reference.setLight(reference.getChanges(0).lights[3], light);
+    const ShadowMapSet& full = reference.bakeShadowMaps(resolution);
+    end = std::chrono::high_resolution_clock::now();
+    double fullMs = std::chrono::duration<double, std::milli>(end - start).count();
+    for (size_t l = 0; l < lightCount; ++l) {
+        if (l == movedIndex) {
+            assert(!sameMap(after.getMap(l), before.getMap(l)));
+        } else {
+            assert(sameMap(after.getMap(l), before.getMap(l)));
+        }
+        assert(sameMap(after.getMap(l), full.getMap(l)));
+    }
+
+    // The lighting caches now describe the new scene
+    assert(world.getCamera().getLightmaps() != lightmaps);
+    assert(world.getCamera().getLightmaps()->getSceneHash() != lightmaps->getSceneHash());
+    assert(irradiance->getRecordCount() == 0);
+
+    // A color change re-renders no shadow map
+    light.setColor(RGBA_Color(1, 0.8, 0.6, 1));
+    world.setLight(moved, light);
+    world.updateCaches();
+    for (size_t l = 0; l < lightCount; ++l) {
+        assert(sameMap(world.getCamera().getShadowMaps()->getMap(l), after.getMap(l)));
+    }
+
+    std::cout << "  shadow maps after one of " << lightCount << " lights moved: " << updateMs
+              << " ms including the lightmap bake, full build of the world " << fullMs << " ms" << std::endl;
+}
+
+void testObjectChangeRebuildsLighting() {
+    World world = makeRoom(2);
+    world.bakeShadowMaps(32);
+    auto shadowMaps = world.getCamera().getShadowMaps();
+
+    // Any object change renders every map again, at the same resolution
+    World::ObjectHandle sphere = world.getObjectHandleAt(world.getObjectCount() - 1);
+    world.moveObject(sphere, Vector3D(0, 1, 0));
+    world.updateCaches();
+    auto rebuilt = world.getCamera().getShadowMaps();
+    assert(rebuilt != shadowMaps && rebuilt->getResolution() == 32);
+
+    // Maps set on the camera by hand are left alone
+    auto custom = std::make_shared<const ShadowMapSet>(ShadowMapSet::build(math::Vector<Camera::ShapeVariant>(), math::Vector<Light>(), 8));
+    world.getCamera().setShadowMaps(custom);
+    world.moveObject(sphere, Vector3D(0, -1, 0));
+    world.updateCaches();
+    assert(world.getCamera().getShadowMaps() == custom);
+
+    // Arguments of the partial rebuild
+    math::Vector<size_t> outOfRange;
+    outOfRange.append(5);
+    bool threw = false;
+    try {
+        ShadowMapSet::rebuild(*rebuilt, math::Vector<Camera::ShapeVariant>(), math::Vector<Light>(2), outOfRange);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+    threw = false;
+    try {
+        ShadowMapSet::rebuild(*rebuilt, math::Vector<Camera::ShapeVariant>(), math::Vector<Light>(3), math::Vector<size_t>());
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include "../Lib/Rendering/SceneHash.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Material.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Sphere.h"
+
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testFullHash();
+void testFieldSelection();
+
+int main() {
+    std::cout << "Running SceneHash tests..." << std::endl;
+
+    try {
+        testFullHash();
+        std::cout << "✓ Full scene hash tests passed" << std::endl;
+
+        testFieldSelection();
+        std::cout << "✓ Field selection tests passed" << std::endl;
+
+        std::cout << "All SceneHash tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+static math::Vector<Camera::ShapeVariant> makeShapes(const Vector3D& center, const RGBA_Color& albedo, double roughness) {
+    Material material;
+    material.setAlbedo(albedo);
+    material.setRoughness(roughness);
+    math::Vector<Camera::ShapeVariant> shapes(1);
+    shapes[0] = Shape<Sphere>(Sphere(center, 4.0), material);
+    return shapes;
+}
+
+static math::Vector<Light> makeLights(const Vector3D& position, double intensity) {
+    math::Vector<Light> lights(1);
+    lights[0] = Light(position, RGBA_Color(1, 1, 1, 1), intensity);
+    return lights;
+}
+
+void testFullHash() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes(Vector3D(0, 0, 0), RGBA_Color(1, 1, 1, 1), 0.5);
+    math::Vector<Light> lights = makeLights(Vector3D(0, 5, -5), 3.0);
+
+    uint64_t hash = SceneHash::compute(shapes, lights);
+    assert(SceneHash::compute(shapes, lights) == hash);
+
+    // Geometry, every material field and the lights change the hash
+    assert(SceneHash::compute(makeShapes(Vector3D(0, 1, 0), RGBA_Color(1, 1, 1, 1), 0.5), lights) != hash);
+    assert(SceneHash::compute(makeShapes(Vector3D(0, 0, 0), RGBA_Color(1, 0, 0, 1), 0.5), lights) != hash);
+    assert(SceneHash::compute(makeShapes(Vector3D(0, 0, 0), RGBA_Color(1, 1, 1, 1), 0.9), lights) != hash);
+    assert(SceneHash::compute(shapes, makeLights(Vector3D(0, 5, -5), 0.5)) != hash);
+    assert(SceneHash::compute(shapes, makeLights(Vector3D(1, 5, -5), 3.0)) != hash);
+
+    math::Vector<Camera::ShapeVariant> emissive = makeShapes(Vector3D(0, 0, 0), RGBA_Color(1, 1, 1, 1), 0.5);
+    std::visit([](auto& shape) { shape.getMaterial()->setEmissive(RGBA_Color(1, 1, 0, 1)); }, emissive[0]);
+    assert(SceneHash::compute(emissive, lights) != hash);
+
+    math::Vector<Camera::ShapeVariant> twice = shapes;
+    twice.append(shapes[0]);
+    assert(SceneHash::compute(twice, lights) != hash);
+}
+
+void testFieldSelection() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes(Vector3D(0, 0, 0), RGBA_Color(1, 1, 1, 1), 0.5);
+    math::Vector<Light> lights = makeLights(Vector3D(0, 5, -5), 3.0);
+    const SceneField shadowFields = SceneField::GEOMETRY | SceneField::OPACITY | SceneField::LIGHT_POSITIONS;
+    uint64_t hash = SceneHash::compute(shapes, lights, shadowFields);
+
+    // Fields left out of the selection do not change the hash
+    assert(SceneHash::compute(makeShapes(Vector3D(0, 0, 0), RGBA_Color(1, 0, 0, 1), 0.5), lights, shadowFields) == hash);
+    assert(SceneHash::compute(makeShapes(Vector3D(0, 0, 0), RGBA_Color(1, 1, 1, 1), 0.9), lights, shadowFields) == hash);
+    assert(SceneHash::compute(shapes, makeLights(Vector3D(0, 5, -5), 0.5), shadowFields) == hash);
+
+    // Selected ones do
+    assert(SceneHash::compute(makeShapes(Vector3D(0, 0, 0), RGBA_Color(1, 1, 1, 0.5), 0.5), lights, shadowFields) != hash);
+    assert(SceneHash::compute(makeShapes(Vector3D(2, 0, 0), RGBA_Color(1, 1, 1, 1), 0.5), lights, shadowFields) != hash);
+    assert(SceneHash::compute(shapes, makeLights(Vector3D(0, 6, -5), 3.0), shadowFields) != hash);
+
+    // Nothing selected hashes every scene alike
+    assert(SceneHash::compute(shapes, lights, SceneField::NONE) == SceneHash::compute({}, {}, SceneField::NONE));
+}
@@ -0,0 +1,345 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include "../Lib/Rendering/ScenePager.h"
+#include "../Lib/Rendering/World.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Material.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Box.h"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+#include "../Lib/Geometry/Ray.h"
+#include "../Lib/Math/Vector.hpp"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+static const std::string PAGE_FILE = "./test/test_by_product/scene_pager_test.pages";
+
+// Test function declarations
+void testRoundTrip();
+void testMemoryBudget();
+void testTraceBatchMatchesBruteForce();
+void testPagedWorldRender();
+void testInvalidFiles();
+
+int main() {
+    std::cout << "Running ScenePager tests..." << std::endl;
+
+    try {
+        testRoundTrip();
+        std::cout << "✓ Page file round trip tests passed" << std::endl;
+
+        testMemoryBudget();
+        std::cout << "✓ Page cache budget tests passed" << std::endl;
+
+        testTraceBatchMatchesBruteForce();
+        std::cout << "✓ Batched tracing tests passed" << std::endl;
+
+        testPagedWorldRender();
+        std::cout << "✓ Paged world render tests passed" << std::endl;
+
+        testInvalidFiles();
+        std::cout << "✓ Invalid file tests passed" << std::endl;
+
+        std::remove(PAGE_FILE.c_str());
+        std::cout << "All ScenePager tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+// Grid of small spheres behind the origin, a box and a floor plane
+static math::Vector<Camera::ShapeVariant> makeScene(size_t side) {
+    math::Vector<Camera::ShapeVariant> shapes(side * side + 2);
+    for (size_t i = 0; i < side; ++i) {
+        for (size_t j = 0; j < side; ++j) {
+            Sphere sphere(Vector3D(-8.0 + 16.0 * i / side, -8.0 + 16.0 * j / side, 10.0 + (i + j) % 3), 0.6);
+            Material material(RGBA_Color(i / double(side), j / double(side), 0.5, 1.0));
+            shapes[i * side + j] = Shape<Sphere>(sphere, material);
+        }
+    }
+    shapes[side * side] = Shape<Box>(Box(Vector3D(0, 0, 20), 4.0, 4.0, 4.0, Vector3D(0, 0, 1)), RGBA_Color(1, 0, 0, 1));
+    shapes[side * side + 1] = Shape<Plane>(Plane(Vector3D(0, 0, 30), Vector3D(0, 0, -1)), RGBA_Color(0.2, 0.2, 0.8, 1));
+    return shapes;
+}
+
+static void writePageFile(const math::Vector<Camera::ShapeVariant>& shapes, size_t shapesPerPage) {
+    ScenePageWriter writer(PAGE_FILE, shapesPerPage);
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        writer.addShape(shapes[i]);
+    }
+    assert(writer.getShapeCount() == shapes.size());
+    writer.finalize();
+}
+
+void testRoundTrip() {
+    const size_t side = 10;
+    math::Vector<Camera::ShapeVariant> shapes = makeScene(side);
+    writePageFile(shapes, 8);
+
+    ScenePager pager(PAGE_FILE, size_t(1) << 30);
+    assert(pager.getShapeCount() == shapes.size());
+    // The plane alone in the resident page, the 101 bounded shapes in pages of 8
+    assert(pager.getPageShapeCount(ScenePager::RESIDENT_PAGE) == 1);
+    assert(pager.getPageCount() == 1 + (side * side + 1 + 7) / 8);
+    assert(pager.isPageCached(ScenePager::RESIDENT_PAGE));
+
+    size_t total = 0;
+    size_t spheres = 0;
+    for (size_t page = 0; page < pager.getPageCount(); ++page) {
+        auto pageShapes = pager.acquirePage(page);
+        assert(pageShapes->size() == pager.getPageShapeCount(page));
+        total += pageShapes->size();
+
+        for (size_t s = 0; s < pageShapes->size(); ++s) {
+            const Camera::ShapeVariant& shape = (*pageShapes)[s];
+            if (page == ScenePager::RESIDENT_PAGE) {
+                assert(shape.index() == 2);
+            }
+            if (const Shape<Sphere>* sphere = std::get_if<Shape<Sphere>>(&shape)) {
+                // Find the source sphere and compare geometry and material
+                const Vector3D& center = sphere->getGeometry()->getCenter();
+                bool matched = false;
+                for (size_t k = 0; k < side * side && !matched; ++k) {
+                    const Shape<Sphere>& source = std::get<Shape<Sphere>>(shapes[k]);
+                    if (source.getGeometry()->getCenter() == center) {
+                        assert(sphere->getGeometry()->getRadius() == source.getGeometry()->getRadius());
+                        assert(sphere->getMaterial()->getAlbedo() == source.getMaterial()->getAlbedo());
+                        matched = true;
+                    }
+                }
+                assert(matched);
+                ++spheres;
+            }
+        }
+    }
+    assert(total == shapes.size());
+    assert(spheres == side * side);
+
+    // Out of range pages
+    bool exceptionThrown = false;
+    try {
+        pager.acquirePage(pager.getPageCount());
+    } catch (const std::out_of_range&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+}
+
+void testMemoryBudget() {
+    writePageFile(makeScene(10), 8);
+
+    // A budget too small for any page keeps only the page in use and the resident page
+    ScenePager tight(PAGE_FILE, 1);
+    for (size_t page = 1; page < tight.getPageCount(); ++page) {
+        auto pageShapes = tight.acquirePage(page);
+        assert(pageShapes->size() == tight.getPageShapeCount(page));
+    }
+    assert(tight.getEvictionCount() > 0);
+    assert(tight.isPageCached(ScenePager::RESIDENT_PAGE));
+    assert(!tight.isPageCached(1));
+
+    // A large budget never evicts
+    ScenePager roomy(PAGE_FILE, size_t(1) << 30);
+    for (size_t page = 1; page < roomy.getPageCount(); ++page) {
+        roomy.acquirePage(page);
+    }
+    size_t loads = roomy.getPageLoadCount();
+    for (size_t page = 1; page < roomy.getPageCount(); ++page) {
+        roomy.acquirePage(page);
+        assert(roomy.isPageCached(page));
+    }
+    assert(roomy.getEvictionCount() == 0);
+    assert(roomy.getPageLoadCount() == loads);
+    assert(roomy.getResidentBytes() > 0);
+}
+
+static double closestHit(const Ray& ray, const math::Vector<Camera::ShapeVariant>& shapes) {
+    double closest = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        std::visit([&](auto&& shape) {
+            auto d = shape.getGeometry()->rayIntersectDepth(ray);
+            if (d && *d > 1e-9 && *d < closest) {
+                closest = *d;
+            }
+        }, shapes[i]);
+    }
+    return closest;
+}
+
+void testTraceBatchMatchesBruteForce() {
+    math::Vector<Camera::ShapeVariant> shapes = makeScene(12);
+    writePageFile(shapes, 6);
+    ScenePager pager(PAGE_FILE, 4096);
+
+    // Fan of rays from the origin towards the scene
+    const size_t raysPerSide = 48;
+    math::Vector<Ray> rays(raysPerSide * raysPerSide);
+    for (size_t i = 0; i < raysPerSide; ++i) {
+        for (size_t j = 0; j < raysPerSide; ++j) {
+            Vector3D direction(-0.9 + 1.8 * i / raysPerSide, -0.9 + 1.8 * j / raysPerSide, 1.0);
+            rays[i * raysPerSide + j] = Ray(Vector3D(0, 0, 0), direction.normal());
+        }
+    }
+
+    math::Vector<double> hits(rays.size());
+    for (size_t r = 0; r < hits.size(); ++r) {
+        hits[r] = std::numeric_limits<double>::infinity();
+    }
+    pager.traceBatch(rays,
+        [&](size_t r, double entryDistance) { return entryDistance < hits[r]; },
+        [&](size_t r, size_t, const math::Vector<Camera::ShapeVariant>& pageShapes) {
+            hits[r] = std::min(hits[r], closestHit(rays[r], pageShapes));
+        });
+
+    for (size_t r = 0; r < rays.size(); ++r) {
+        double expected = closestHit(rays[r], shapes);
+        assert(hits[r] == expected);
+    }
+    // The budget fits only a few pages, so pages were evicted along the way
+    assert(pager.getEvictionCount() > 0);
+}
+
+void testPagedWorldRender() {
+    World world;
+    world.getCamera().setViewport(makeTestViewport());
+
+    math::Vector<Camera::ShapeVariant> shapes = makeScene(10);
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        std::visit([&](auto&& shape) { world.addObject(shape); }, shapes[i]);
+    }
+
+    Image inMemoryColor = world.renderScene3DColor(96, 96);
+    Image inMemoryDepth = world.renderScene3DDepth(96, 96);
+
+    world.pageObjectsToFile(PAGE_FILE, 8192, 8);
+    assert(world.isPaged());
+    assert(world.getObjectCount() == shapes.size());
+
+    Image pagedColor = world.renderScene3DColor(96, 96);
+    Image pagedDepth = world.renderScene3DDepth(96, 96);
+    for (size_t y = 0; y < 96; ++y) {
+        for (size_t x = 0; x < 96; ++x) {
+            assert(pagedColor.getPixel(x, y) == inMemoryColor.getPixel(x, y));
+            assert(pagedDepth.getPixel(x, y) == inMemoryDepth.getPixel(x, y));
+        }
+    }
+
+    // Lit render runs out-of-core too
+    world.addLight(Light(Vector3D(0, 0, 0), RGBA_Color(1, 1, 1, 1), 1.0));
+    Image pagedLight = world.renderScene3DLight(96, 96);
+    assert(pagedLight.getWidth() == 96 && pagedLight.getHeight() == 96);
+
+    // 2D renders need the objects in memory
+    bool exceptionThrown = false;
+    try {
+        world.renderScene2DColor(96, 96);
+    } catch (const std::logic_error&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+
+    world.clearObjects();
+    assert(!world.isPaged());
+    assert(world.getObjectCount() == 0);
+}
+
+void testInvalidFiles() {
+    bool exceptionThrown = false;
+    try {
+        ScenePager pager("./test/test_by_product/missing.pages", 1024);
+    } catch (const std::runtime_error&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+
+    exceptionThrown = false;
+    try {
+        ScenePageWriter writer(PAGE_FILE, 0);
+    } catch (const std::invalid_argument&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+
+    // A failed finalize does not leave the spill file behind
+    const std::string directoryPath = "./test/test_by_product";
+    exceptionThrown = false;
+    try {
+        ScenePageWriter writer(directoryPath, 4);
+        writer.addShape(Camera::ShapeVariant{Shape<Sphere>(Sphere(Vector3D(0, 0, 0), 1.0))});
+        writer.finalize();
+    } catch (const std::runtime_error&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+    FILE* spill = fopen((directoryPath + ".spill").c_str(), "rb");
+    assert(spill == nullptr);
+
+    // Header and directory entries pointing past the records
+    const size_t recordCountOffset = 24;
+    const size_t directoryOffsetOffset = 32;
+    const size_t entryRecordCountOffset = 7 * sizeof(double);
+    auto writeValidFile = []() {
+        ScenePageWriter writer(PAGE_FILE, 2);
+        for (int i = 0; i < 5; ++i) {
+            writer.addShape(Camera::ShapeVariant{Shape<Sphere>(Sphere(Vector3D(i, 0, 0), 0.5))});
+        }
+        writer.finalize();
+    };
+    auto patchFile = [](size_t offset, uint64_t value) {
+        FILE* file = fopen(PAGE_FILE.c_str(), "r+b");
+        assert(file != nullptr);
+        fseek(file, static_cast<long>(offset), SEEK_SET);
+        fwrite(&value, sizeof(value), 1, file);
+        fclose(file);
+    };
+    auto readFile = [](size_t offset) {
+        uint64_t value = 0;
+        FILE* file = fopen(PAGE_FILE.c_str(), "rb");
+        assert(file != nullptr);
+        fseek(file, static_cast<long>(offset), SEEK_SET);
+        size_t read = fread(&value, sizeof(value), 1, file);
+        fclose(file);
+        assert(read == 1);
+        (void)read;
+        return value;
+    };
+    auto rejects = []() {
+        try {
+            ScenePager pager(PAGE_FILE, 1 << 20);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+
+    writeValidFile();
+    assert(!rejects());
+    patchFile(recordCountOffset, readFile(recordCountOffset) + 1);
+    assert(rejects());
+
+    writeValidFile();
+    const uint64_t directoryOffset = readFile(directoryOffsetOffset);
+    const size_t lastEntry = directoryOffset + 3 * sizeof(ScenePager::PageEntry);
+    patchFile(lastEntry + entryRecordCountOffset, readFile(lastEntry + entryRecordCountOffset) + 1);
+    assert(rejects());
+
+    writeValidFile();
+    patchFile(lastEntry + entryRecordCountOffset - sizeof(uint64_t), std::numeric_limits<uint64_t>::max());
+    assert(rejects());
+    std::remove(PAGE_FILE.c_str());
+}
@@ -0,0 +1,219 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include "../Lib/Rendering/SecondaryRays.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Material.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testSecondaryRayKey();
+void testBatchMatchesRecursion();
+void testSortedRenders();
+void testSortedTiming();
+
+int main() {
+    std::cout << "Running SecondaryRays tests..." << std::endl;
+
+    try {
+        testSecondaryRayKey();
+        std::cout << "✓ Secondary ray key tests passed" << std::endl;
+
+        testBatchMatchesRecursion();
+        std::cout << "✓ Batch shading tests passed" << std::endl;
+
+        testSortedRenders();
+        std::cout << "✓ Sorted render tests passed" << std::endl;
+
+        testSortedTiming();
+        std::cout << "✓ Sorted timing tests passed" << std::endl;
+
+        std::cout << "All SecondaryRays tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+static Material mirror(const RGBA_Color& albedo) {
+    Material material;
+    material.setAlbedo(albedo);
+    material.setMetalness(1.0);
+    material.setRoughness(0.0);
+    return material;
+}
+
+static Material glass(const RGBA_Color& albedo) {
+    Material material;
+    material.setAlbedo(albedo);
+    material.setTransmission(0.8);
+    material.setRefractiveIndex(1.5);
+    return material;
+}
+
+// A box of mirror walls around mirror and glass spheres, and a matte rectangle
+static math::Vector<Camera::ShapeVariant> makeMirrorShapes(int sphereCount) {
+    math::Vector<Camera::ShapeVariant> shapes(6 + sphereCount);
+    shapes[0] = Shape<Plane>(Plane(Vector3D(0, 0, 18), Vector3D(0, 0, -1)), mirror(RGBA_Color(0.9, 0.9, 1.0, 1.0)));
+    shapes[1] = Shape<Plane>(Plane(Vector3D(0, 10, 0), Vector3D(0, -1, 0)), RGBA_Color(0.6, 0.7, 0.6, 1.0));
+    shapes[2] = Shape<Plane>(Plane(Vector3D(-12, 0, 0), Vector3D(1, 0, 0)), mirror(RGBA_Color(1.0, 0.8, 0.8, 1.0)));
+    shapes[3] = Shape<Plane>(Plane(Vector3D(12, 0, 0), Vector3D(-1, 0, 0)), mirror(RGBA_Color(0.8, 1.0, 0.8, 1.0)));
+    shapes[4] = Shape<Plane>(Plane(Vector3D(0, -12, 0), Vector3D(0, 1, 0)), RGBA_Color(0.9, 0.9, 0.7, 1.0));
+    shapes[5] = Shape<Rectangle>(Rectangle(Vector3D(4, -8, 8), Vector3D(7, -8, 8), Vector3D(4, -5, 8)), RGBA_Color(0.5, 1, 0.5, 1));
+    for (int i = 0; i < sphereCount; ++i) {
+        double x = -7.5 + 3.0 * (i % 6), y = -6.0 + 3.0 * (i / 6);
+        Vector3D center(x, y, 10.0 + (i % 3));
+        if (i % 3 == 1) {
+            shapes[6 + i] = Shape<Sphere>(Sphere(center, 1.0), glass(RGBA_Color(0.3, 0.5, 1.0, 0.6)));
+        } else {
+            shapes[6 + i] = Shape<Sphere>(Sphere(center, 1.0), mirror(RGBA_Color(1.0, 1.0, 0.9, 1.0)));
+        }
+    }
+    return shapes;
+}
+
+static math::Vector<Light> makeLights() {
+    math::Vector<Light> lights(3);
+    lights[0] = Light(Vector3D(-5, -8, 0), RGBA_Color(1, 1, 1, 1), 0.8);
+    lights[1] = Light(Vector3D(6, -6, 2), RGBA_Color(1, 0.9, 0.8, 1), 0.6);
+    lights[2] = Light(Vector3D(0, 5, -2), RGBA_Color(0.8, 0.9, 1, 1), 0.5);
+    return lights;
+}
+
+void testSecondaryRayKey() {
+    Vector3D low(0, 0, 0), size(1024, 1024, 1024);
+    Vector3D up(0.1, 0.2, 0.3);
+
+    // The three low bits are the direction octant
+    assert((secondaryRayKey(Vector3D(5, 5, 5), up, low, size) & 7) == 0);
+    assert((secondaryRayKey(Vector3D(5, 5, 5), Vector3D(-1, 0.2, 0.3), low, size) & 7) == 1);
+    assert((secondaryRayKey(Vector3D(5, 5, 5), Vector3D(0.1, -1, 0.3), low, size) & 7) == 2);
+    assert((secondaryRayKey(Vector3D(5, 5, 5), Vector3D(-1, -1, -1), low, size) & 7) == 7);
+
+    // Above them, the bits of the cell coordinates interleaved x first
+    assert((secondaryRayKey(Vector3D(1.5, 0, 0), up, low, size) >> 3) == 1);
+    assert((secondaryRayKey(Vector3D(0, 1.5, 0), up, low, size) >> 3) == 2);
+    assert((secondaryRayKey(Vector3D(0, 0, 1.5), up, low, size) >> 3) == 4);
+    assert((secondaryRayKey(Vector3D(2.5, 0, 0), up, low, size) >> 3) == 8);
+    assert((secondaryRayKey(Vector3D(3.5, 3.5, 3.5), up, low, size) >> 3) == 63);
+
+    // Origins on or past the far bound land in the last cell, flat bounds in the first
+    assert((secondaryRayKey(Vector3D(1024, 1024, 1024), up, low, size) >> 3) == (1ull << 30) - 1);
+    assert((secondaryRayKey(Vector3D(-3, 2000, 5), up, low, Vector3D(0, 0, 0)) >> 3) == 0);
+}
+
+void testBatchMatchesRecursion() {
+    Camera camera = makeTestCamera();
+    math::Vector<Camera::ShapeVariant> shapes = makeMirrorShapes(18);
+    math::Vector<Light> lights = makeLights();
+    LightingStorage storage;
+    const LightingCache lighting = camera.prepareLighting(shapes, lights, storage);
+
+    // A row of primary hits, every other one left unset
+    const size_t width = 64;
+    SecondaryRayBatch batch(shapes, lights, lighting, width);
+    math::Vector<RGBA_Color> expected(width);
+    math::Vector<int> isSet(width);
+    size_t hitCount = 0;
+    for (size_t x = 0; x < width; x += 2) {
+        Ray ray = camera.generateRayForPixel(x, 20, width, 40, true);
+        auto hit = Camera::findClosestHit(ray, shapes, -1);
+        if (hit) {
+            batch.setPrimary(x, ray, *hit);
+            expected[x] = Camera::processRayHitAdvanced(*hit, ray, shapes, lights, 10, lighting);
+            isSet[x] = 1;
+            ++hitCount;
+        }
+    }
+    assert(hitCount > 10);
+
+    batch.trace();
+    for (size_t x = 0; x < width; ++x) {
+        assert(batch.hasColor(x) == (isSet[x] == 1));
+        if (batch.hasColor(x)) {
+            const RGBA_Color& color = batch.getColor(x);
+            assert(color.r() == expected[x].r() && color.g() == expected[x].g());
+            assert(color.b() == expected[x].b() && color.a() == expected[x].a());
+        }
+    }
+
+    // Mirrors bounce rays back and forth up to the recursion depth
+    assert(batch.getSecondaryRayCount() > hitCount);
+    assert(batch.getWaveCount() >= 2 && batch.getWaveCount() <= 10);
+
+    // A shallow batch stops after its last allowed bounce
+    SecondaryRayBatch shallow(shapes, lights, lighting, 1, 1);
+    Ray ray = camera.generateRayForPixel(width / 2, 20, width, 40, true);
+    auto hit = Camera::findClosestHit(ray, shapes, -1);
+    assert(hit);
+    shallow.setPrimary(0, ray, *hit);
+    shallow.trace();
+    assert(shallow.getWaveCount() <= 1);
+    const RGBA_Color expectedShallow = Camera::processRayHitAdvanced(*hit, ray, shapes, lights, 1, lighting);
+    assert(shallow.getColor(0).r() == expectedShallow.r() && shallow.getColor(0).b() == expectedShallow.b());
+}
+
+void testSortedRenders() {
+    Camera camera = makeTestCamera();
+    math::Vector<Camera::ShapeVariant> shapes = makeMirrorShapes(18);
+    math::Vector<Light> lights = makeLights();
+
+    assert(!camera.isSecondaryRaySortingEnabled());
+    assert(camera.getSecondaryRayBatchSize() == 65536);
+    bool threw = false;
+    try {
+        camera.setSecondaryRayBatchSize(0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    Image recursive = camera.renderScene3DLight_Advanced(80, 60, shapes, lights);
+
+    // One batch for the whole image, then bands of a few rows that are no multiple of the height
+    camera.setSecondaryRaySorting(true);
+    assert(camera.isSecondaryRaySortingEnabled());
+    assert(sameImage(camera.renderScene3DLight_Advanced(80, 60, shapes, lights), recursive));
+    camera.setSecondaryRayBatchSize(7 * 80 + 1);
+    assert(camera.getSecondaryRayBatchSize() == 7 * 80 + 1);
+    assert(sameImage(camera.renderScene3DLight_Advanced(80, 60, shapes, lights), recursive));
+
+    // Same without tile packets on the recursive side
+    camera.setSecondaryRaySorting(false);
+    camera.setShadowPackets(false);
+    assert(sameImage(camera.renderScene3DLight_Advanced(80, 60, shapes, lights), recursive));
+}
+
+void testSortedTiming() {
+    Camera camera = makeTestCamera();
+    math::Vector<Camera::ShapeVariant> shapes = makeMirrorShapes(30);
+    math::Vector<Light> lights = makeLights();
+
+    auto start = std::chrono::steady_clock::now();
+    Image recursive = camera.renderScene3DLight_Advanced(200, 200, shapes, lights);
+    std::chrono::duration<double, std::milli> recursiveTime = std::chrono::steady_clock::now() - start;
+
+    camera.setSecondaryRaySorting(true);
+    start = std::chrono::steady_clock::now();
+    Image sorted = camera.renderScene3DLight_Advanced(200, 200, shapes, lights);
+    std::chrono::duration<double, std::milli> sortedTime = std::chrono::steady_clock::now() - start;
+
+    assert(sameImage(sorted, recursive));
+    std::cout << "  36 shapes, mirror walls at 200x200: depth first " << recursiveTime.count() << " ms, sorted waves "
+              << sortedTime.count() << " ms" << std::endl;
+}
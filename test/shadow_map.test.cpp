@@ -0,0 +1,218 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include "../Lib/Rendering/ShadowMap.h"
+#include "../Lib/Rendering/World.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testShadowMapBuild();
+void testShadowMapVisibility();
+void testShadowMappedRender();
+void testShadowMapArguments();
+void testShadowMapTiming();
+
+int main() {
+    std::cout << "Running ShadowMap tests..." << std::endl;
+
+    try {
+        testShadowMapBuild();
+        std::cout << "✓ Shadow map build tests passed" << std::endl;
+
+        testShadowMapVisibility();
+        std::cout << "✓ Shadow map visibility tests passed" << std::endl;
+
+        testShadowMappedRender();
+        std::cout << "✓ Shadow mapped render tests passed" << std::endl;
+
+        testShadowMapArguments();
+        std::cout << "✓ Shadow map argument tests passed" << std::endl;
+
+        testShadowMapTiming();
+        std::cout << "✓ Shadow map timing tests passed" << std::endl;
+
+        std::cout << "All ShadowMap tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+// A back wall with a sphere in front of it, the lights between the camera and the sphere
+static math::Vector<Camera::ShapeVariant> makeShapes() {
+    math::Vector<Camera::ShapeVariant> shapes(2);
+    shapes[0] = Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.8, 0.8, 1.0));
+    shapes[1] = Shape<Sphere>(Sphere(Vector3D(0, 0, 8), 2.5), RGBA_Color(1, 1, 1, 1));
+    return shapes;
+}
+
+void testShadowMapBuild() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    math::Vector<Light> lights = makeRingLights(3, 3.0, 1.0);
+    lights[0].setPosition(Vector3D(0, 0, 0));
+    ShadowMapSet shadowMaps = ShadowMapSet::build(shapes, lights, 32);
+
+    assert(shadowMaps.getMapCount() == 3);
+    assert(shadowMaps.getResolution() == 32);
+    assert(shadowMaps.matches(shapes, lights));
+    const ShadowMap& map = shadowMaps.getMap(0);
+    assert(map.position == lights[0].getPosition());
+    assert(map.depth.size() == 6 * 32 * 32);
+    assert(map.occluder.size() == 6 * 32 * 32);
+
+    // The +z face sees the sphere at its center and the wall around it, the -z face sees nothing
+    size_t center = 4 * 32 * 32 + 16 * 32 + 16;
+    assert(map.occluder[center] == 1);
+    size_t corner = 4 * 32 * 32;
+    assert(map.occluder[corner] == 0);
+    size_t behind = 5 * 32 * 32 + 16 * 32 + 16;
+    assert(map.occluder[behind] == ShadowMap::NO_OCCLUDER);
+    assert(std::isinf(map.depth[behind]));
+
+    // Any change of the scene invalidates the maps
+    math::Vector<Light> moved = lights;
+    moved[1].setPosition(Vector3D(0, 1, 0));
+    assert(!shadowMaps.matches(shapes, moved));
+    assert(!shadowMaps.matches(shapes, makeRingLights(2, 3.0, 1.0)));
+}
+
+void testShadowMapVisibility() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    math::Vector<Light> lights(1);
+    lights[0] = Light(Vector3D(0, 0, 0), RGBA_Color(1, 1, 1, 1), 1.0);
+    ShadowMapSet shadowMaps = ShadowMapSet::build(shapes, lights, 128);
+
+    // Wall behind the sphere: in shadow; far from it: lit
+    assert(shadowMaps.visibility(0, Vector3D(0, 0, 15), 0) == 0.0);
+    assert(shadowMaps.visibility(0, Vector3D(9, 9, 15), 0) == 1.0);
+
+    // The sphere does not shadow its own lit side
+    assert(shadowMaps.visibility(0, Vector3D(0, 0, 5.5), 1) == 1.0);
+
+    // Same answers as shadow rays, away from the penumbra
+    for (double x = -9.0; x <= 9.0; x += 1.5) {
+        Vector3D point(x, 0.5, 15);
+        RGBA_Color traced = Camera::calculateLighting(point, Vector3D(0, 0, -1), lights, shapes, 0);
+        RGBA_Color mapped = Camera::calculateLighting(point, Vector3D(0, 0, -1), lights, shapes, 0, LightingCache{nullptr, &shadowMaps});
+        double radius = std::abs(x) * 8.0 / 15.0;
+        if (std::abs(radius - 2.5) > 0.3) {
+            assert(std::abs(traced.r() - mapped.r()) < 1e-12);
+        }
+    }
+}
+
+void testShadowMappedRender() {
+    Camera camera = makeTestCamera();
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    math::Vector<Light> lights = makeRingLights(4, 3.0, 1.0);
+
+    // Ray traced shadows stay the default
+    assert(camera.getShadowMode() == Camera::ShadowMode::RAY_TRACED);
+    Image traced = camera.renderScene3DLight(64, 64, shapes, lights);
+    Image tracedAdvanced = camera.renderScene3DLight_Advanced(64, 64, shapes, lights);
+
+    camera.setShadowMode(Camera::ShadowMode::SHADOW_MAPPED);
+    camera.setShadowMapResolution(256);
+    Image mapped = camera.renderScene3DLight(64, 64, shapes, lights);
+    assert(meanAbsoluteDifference(mapped, traced) < 0.01);
+    assert(meanAbsoluteDifference(mapped, traced) > 0.0);
+    Image mappedAdvanced = camera.renderScene3DLight_Advanced(64, 64, shapes, lights);
+    assert(meanAbsoluteDifference(mappedAdvanced, tracedAdvanced) < 0.01);
+
+    // Prebuilt maps of the same scene give the same frame
+    camera.setShadowMaps(std::make_shared<const ShadowMapSet>(ShadowMapSet::build(shapes, lights, 256)));
+    assert(meanAbsoluteDifference(camera.renderScene3DLight(64, 64, shapes, lights), mapped) == 0.0);
+
+    // The mode is chosen per render
+    camera.setShadowMode(Camera::ShadowMode::RAY_TRACED);
+    assert(meanAbsoluteDifference(camera.renderScene3DLight(64, 64, shapes, lights), traced) == 0.0);
+
+    // Through the world
+    World world;
+    world.getCamera() = makeTestCamera();
+    for (const auto& shape : shapes) {
+        std::visit([&world](auto&& s) { world.addObject(s); }, shape);
+    }
+    for (const Light& light : lights) {
+        world.addLight(light);
+    }
+    world.getCamera().setShadowMode(Camera::ShadowMode::SHADOW_MAPPED);
+    const ShadowMapSet& baked = world.bakeShadowMaps(256);
+    assert(baked.getMapCount() == 4);
+    assert(world.getCamera().getShadowMaps().get() == &baked);
+    assert(meanAbsoluteDifference(world.renderScene3DLight(64, 64), mapped) == 0.0);
+}
+
+void testShadowMapArguments() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    math::Vector<Light> lights = makeRingLights(1, 3.0, 1.0);
+
+    bool threw = false;
+    try {
+        ShadowMapSet::build(shapes, lights, 0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        Camera camera = makeTestCamera();
+        camera.setShadowMapResolution(0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Without lights there is nothing to map
+    ShadowMapSet empty = ShadowMapSet::build(shapes, math::Vector<Light>(), 16);
+    assert(empty.getMapCount() == 0);
+}
+
+void testShadowMapTiming() {
+    Camera camera = makeTestCamera();
+
+    // Many lights, many objects
+    math::Vector<Camera::ShapeVariant> shapes(1);
+    shapes[0] = Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.8, 0.8, 1.0));
+    for (int i = 0; i < 48; ++i) {
+        double x = -9.0 + 3.0 * (i % 7), y = -9.0 + 3.0 * (i / 7);
+        shapes.append(Shape<Sphere>(Sphere(Vector3D(x, y, 10.0 + (i % 3)), 0.8), RGBA_Color(1, 1, 1, 1)));
+    }
+    math::Vector<Light> lights = makeRingLights(16, 3.0, 1.0);
+
+    camera.setShadowMode(Camera::ShadowMode::RAY_TRACED);
+    auto start = std::chrono::steady_clock::now();
+    Image traced = camera.renderScene3DLight(192, 192, shapes, lights);
+    std::chrono::duration<double, std::milli> tracedTime = std::chrono::steady_clock::now() - start;
+
+    // Maps of a static scene are built once, then every frame only looks them up
+    camera.setShadowMode(Camera::ShadowMode::SHADOW_MAPPED);
+    start = std::chrono::steady_clock::now();
+    camera.setShadowMaps(std::make_shared<const ShadowMapSet>(ShadowMapSet::build(shapes, lights, 128)));
+    std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    Image mapped = camera.renderScene3DLight(192, 192, shapes, lights);
+    std::chrono::duration<double, std::milli> mappedTime = std::chrono::steady_clock::now() - start;
+
+    assert(meanAbsoluteDifference(mapped, traced) < 0.05);
+    std::cout << "  49 shapes, 16 lights at 192x192: ray traced " << tracedTime.count() << " ms, shadow mapped "
+              << mappedTime.count() << " ms after a " << buildTime.count() << " ms build" << std::endl;
+}
@@ -0,0 +1,213 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include "../Lib/Rendering/ShadowPacket.h"
+#include "../Lib/Rendering/CameraHelper.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testForEachTile();
+void testPacketCulling();
+void testPacketTransmissions();
+void testPacketRenders();
+void testPacketTiming();
+
+int main() {
+    std::cout << "Running ShadowPacket tests..." << std::endl;
+
+    try {
+        testForEachTile();
+        std::cout << "✓ Tile iteration tests passed" << std::endl;
+
+        testPacketCulling();
+        std::cout << "✓ Packet culling tests passed" << std::endl;
+
+        testPacketTransmissions();
+        std::cout << "✓ Packet transmission tests passed" << std::endl;
+
+        testPacketRenders();
+        std::cout << "✓ Packet render tests passed" << std::endl;
+
+        testPacketTiming();
+        std::cout << "✓ Packet timing tests passed" << std::endl;
+
+        std::cout << "All ShadowPacket tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+// A back wall, a floor, a grid of spheres, a translucent sphere and a rectangle in front of the wall
+static math::Vector<Camera::ShapeVariant> makeShapes() {
+    math::Vector<Camera::ShapeVariant> shapes(2);
+    shapes[0] = Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.8, 0.8, 1.0));
+    shapes[1] = Shape<Plane>(Plane(Vector3D(0, 9, 0), Vector3D(0, -1, 0)), RGBA_Color(0.6, 0.7, 0.6, 1.0));
+    for (int i = 0; i < 30; ++i) {
+        double x = -7.5 + 3.0 * (i % 6), y = -6.0 + 3.0 * (i / 6);
+        shapes.append(Shape<Sphere>(Sphere(Vector3D(x, y, 10.0 + (i % 3)), 0.7), RGBA_Color(1, 1, 1, 1)));
+    }
+    shapes.append(Shape<Sphere>(Sphere(Vector3D(2, 2, 6), 1.5), RGBA_Color(0.2, 0.4, 1.0, 0.5)));
+    shapes.append(Shape<Rectangle>(Rectangle(Vector3D(4, -8, 8), Vector3D(7, -8, 8), Vector3D(4, -5, 8)), RGBA_Color(0.5, 1, 0.5, 1)));
+    return shapes;
+}
+
+void testForEachTile() {
+    // Every pixel of an image that is no multiple of the tile size belongs to exactly one tile
+    RenderSchedule schedule;
+    schedule.tileSize = 8;
+    math::Vector<int> covered(21 * 13);
+    forEachTile(21, 13, schedule, [&](size_t beginX, size_t beginY, size_t endX, size_t endY) {
+        assert(endX - beginX <= 8 && endY - beginY <= 8);
+        for (size_t y = beginY; y < endY; ++y) {
+            for (size_t x = beginX; x < endX; ++x) {
+                #pragma omp atomic
+                covered[y * 21 + x] += 1;
+            }
+        }
+    });
+    for (int count : covered) {
+        assert(count == 1);
+    }
+}
+
+void testPacketCulling() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    ShadowPacketTracer tracer(shapes);
+    Vector3D light(-7.5, -6, 0);
+
+    // A small patch of the wall right behind the first sphere of the grid
+    Vector3D points[4] = {Vector3D(-7.6, -6.1, 15), Vector3D(-7.4, -6.1, 15), Vector3D(-7.6, -5.9, 15), Vector3D(-7.4, -5.9, 15)};
+    size_t selves[4] = {0, 0, 0, 0};
+    math::Vector<size_t> candidates;
+    tracer.cull(light, points, selves, 4, candidates);
+
+    // The wall only holds the lit points themselves and the floor is beyond every ray,
+    // the first sphere is in the cone and the spheres far from it are out of it
+    assert(!candidates.contains(0));
+    assert(!candidates.contains(1));
+    assert(candidates.contains(2));
+    assert(!candidates.contains(31));
+    assert(candidates.size() < 6);
+    for (size_t c = 1; c < candidates.size(); ++c) {
+        assert(candidates[c - 1] < candidates[c]);
+    }
+
+    // Rays fanning out around the light cull nothing by the cone
+    Vector3D around[2] = {Vector3D(-7.5, -6, 15), Vector3D(-7.5, -6, -15)};
+    size_t noSelf[2] = {PixelShadows::NO_SHAPE, PixelShadows::NO_SHAPE};
+    tracer.cull(light, around, noSelf, 2, candidates);
+    assert(candidates.size() >= shapes.size() - 2);
+}
+
+void testPacketTransmissions() {
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    ShadowPacketTracer tracer(shapes);
+    math::Vector<Light> lights = makeRingLights(5, 6.0, 2.0);
+
+    // Packets of wall points gathered like 8x8 tiles: same transmissions as lone shadow rays
+    size_t shadowed = 0, partial = 0;
+    for (const Light& light : lights) {
+        for (double tileX = -10.0; tileX < 10.0; tileX += 2.0) {
+            for (double tileY = -10.0; tileY < 9.0; tileY += 2.0) {
+                Vector3D points[64];
+                size_t selves[64];
+                for (size_t k = 0; k < 64; ++k) {
+                    points[k] = Vector3D(tileX + 0.25 * static_cast<double>(k % 8), tileY + 0.25 * static_cast<double>(k / 8), 15);
+                    selves[k] = 0;
+                }
+                double packet[64];
+                tracer.trace(light.getPosition(), points, selves, 64, packet);
+                for (size_t k = 0; k < 64; ++k) {
+                    double alone = Camera::shadowTransmission(points[k], light.getPosition(), shapes, 0);
+                    assert(packet[k] == alone);
+                    shadowed += alone == 0.0 ? 1 : 0;
+                    partial += alone > 0.0 && alone < 1.0 ? 1 : 0;
+                }
+            }
+        }
+    }
+    assert(shadowed > 0);
+    assert(partial > 0);
+
+    // A strided output, and points lit through the floor's own plane
+    Vector3D floorPoints[2] = {Vector3D(0, 9, 12), Vector3D(3, 9, 3)};
+    size_t floorSelves[2] = {1, 1};
+    double strided[4] = {-5, -5, -5, -5};
+    tracer.trace(lights[0].getPosition(), floorPoints, floorSelves, 2, strided, 2);
+    assert(strided[0] == Camera::shadowTransmission(floorPoints[0], lights[0].getPosition(), shapes, 1));
+    assert(strided[2] == Camera::shadowTransmission(floorPoints[1], lights[0].getPosition(), shapes, 1));
+    assert(strided[1] == -5 && strided[3] == -5);
+}
+
+void testPacketRenders() {
+    Camera camera = makeTestCamera();
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes();
+    math::Vector<Light> lights = makeRingLights(6, 6.0, 2.0);
+
+    // Packets are the default and change no pixel
+    assert(camera.isShadowPacketsEnabled());
+    Image packed = camera.renderScene3DLight(72, 60, shapes, lights);
+    Image packedAdvanced = camera.renderScene3DLight_Advanced(72, 60, shapes, lights);
+    camera.setShadowPackets(false);
+    assert(!camera.isShadowPacketsEnabled());
+    Image single = camera.renderScene3DLight(72, 60, shapes, lights);
+    Image singleAdvanced = camera.renderScene3DLight_Advanced(72, 60, shapes, lights);
+    assert(sameImage(packed, single));
+    assert(sameImage(packedAdvanced, singleAdvanced));
+
+    // Whatever the tile size
+    camera.setShadowPackets(true);
+    RenderSchedule schedule;
+    schedule.tileSize = 5;
+    camera.setRenderSchedule(schedule);
+    assert(sameImage(camera.renderScene3DLight(72, 60, shapes, lights), single));
+
+    // Shadow maps replace the packets
+    camera.setShadowMode(Camera::ShadowMode::SHADOW_MAPPED);
+    Image mapped = camera.renderScene3DLight(72, 60, shapes, lights);
+    camera.setShadowPackets(false);
+    assert(sameImage(camera.renderScene3DLight(72, 60, shapes, lights), mapped));
+}
+
+void testPacketTiming() {
+    Camera camera = makeTestCamera();
+
+    // Shadow dominated: many occluders, most of them far from any given tile's rays
+    math::Vector<Camera::ShapeVariant> shapes(1);
+    shapes[0] = Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.8, 0.8, 1.0));
+    for (int i = 0; i < 96; ++i) {
+        double x = -9.0 + 1.5 * (i % 12), y = -9.0 + 2.25 * (i / 12);
+        shapes.append(Shape<Sphere>(Sphere(Vector3D(x, y, 11.0 + (i % 3)), 0.4), RGBA_Color(1, 1, 1, 1)));
+    }
+    math::Vector<Light> lights = makeRingLights(8, 6.0, 2.0);
+
+    camera.setShadowPackets(false);
+    auto start = std::chrono::steady_clock::now();
+    Image single = camera.renderScene3DLight(160, 160, shapes, lights);
+    std::chrono::duration<double, std::milli> singleTime = std::chrono::steady_clock::now() - start;
+
+    camera.setShadowPackets(true);
+    start = std::chrono::steady_clock::now();
+    Image packed = camera.renderScene3DLight(160, 160, shapes, lights);
+    std::chrono::duration<double, std::milli> packedTime = std::chrono::steady_clock::now() - start;
+
+    assert(sameImage(packed, single));
+    std::cout << "  97 shapes, 8 lights at 160x160: per pixel shadow rays " << singleTime.count() << " ms, tile packets "
+              << packedTime.count() << " ms" << std::endl;
+}
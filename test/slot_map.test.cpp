@@ -0,0 +1,281 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../Lib/Rendering/SlotMap.hpp"
+#include "../Lib/Rendering/World.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testInsertErase();
+void testStaleHandles();
+void testPackedStorage();
+void testWorldObjectHandles();
+void testWorldLightHandles();
+void testWorldChurn();
+
+int main() {
+    std::cout << "Running SlotMap tests..." << std::endl;
+
+    try {
+        testInsertErase();
+        std::cout << "✓ Insert and erase tests passed" << std::endl;
+
+        testStaleHandles();
+        std::cout << "✓ Stale handle tests passed" << std::endl;
+
+        testPackedStorage();
+        std::cout << "✓ Packed storage tests passed" << std::endl;
+
+        testWorldObjectHandles();
+        std::cout << "✓ World object handle tests passed" << std::endl;
+
+        testWorldLightHandles();
+        std::cout << "✓ World light handle tests passed" << std::endl;
+
+        testWorldChurn();
+        std::cout << "✓ World churn tests passed" << std::endl;
+
+        std::cout << "All SlotMap tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+void testInsertErase() {
+    SlotMap<int> map;
+    assert(map.empty());
+
+    SlotHandle a = map.insert(1);
+    SlotHandle b = map.insert(2);
+    SlotHandle c = map.insert(3);
+    assert(map.size() == 3);
+    assert(map.get(a) == 1 && map.get(b) == 2 && map.get(c) == 3);
+
+    // The last value fills the hole
+    assert(map.erase(a) == 0);
+    assert(map.size() == 2);
+    assert(map[0] == 3 && map.indexOf(c) == 0);
+    assert(map.get(b) == 2 && map.get(c) == 3);
+    assert(map.handleAt(0) == c && map.handleAt(1) == b);
+
+    // Erasing the last value moves nothing
+    assert(map.erase(b) == 1);
+    assert(map.size() == 1 && map.get(c) == 3);
+
+    map.get(c) = 30;
+    assert(map[0] == 30);
+
+    map.eraseAt(0);
+    assert(map.empty());
+}
+
+void testStaleHandles() {
+    SlotMap<int> map;
+    SlotHandle a = map.insert(1);
+    map.erase(a);
+    assert(!map.contains(a));
+
+    // The slot is reused under a new generation
+    SlotHandle b = map.insert(2);
+    assert(b.slot == a.slot && b.generation != a.generation);
+    assert(!map.contains(a) && map.contains(b));
+
+    bool threw = false;
+    try {
+        map.get(a);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        map.erase(a);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(map.size() == 1);
+
+    assert(!map.contains(SlotHandle{}));
+    assert(!SlotHandle{}.isValid());
+
+    // Clearing invalidates every handle
+    map.clear();
+    assert(!map.contains(b));
+    SlotHandle c = map.insert(3);
+    assert(!map.contains(b) && map.get(c) == 3);
+
+    threw = false;
+    try {
+        map.handleAt(1);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+void testPackedStorage() {
+    // Random inserts and erases against a reference, values stay packed and reachable by handle
+    SlotMap<int> map;
+    std::vector<std::pair<SlotHandle, int>> live;
+    std::mt19937 rng(7);
+    for (int step = 0; step < 20000; ++step) {
+        if (live.empty() || rng() % 3 != 0) {
+            live.push_back({map.insert(step), step});
+        } else {
+            size_t pick = rng() % live.size();
+            map.erase(live[pick].first);
+            live[pick] = live.back();
+            live.pop_back();
+        }
+    }
+    assert(map.size() == live.size());
+    assert(map.getValues().size() == live.size());
+    long long expectedSum = 0, packedSum = 0;
+    for (const auto& [handle, value] : live) {
+        assert(map.get(handle) == value);
+        assert(map.handleAt(map.indexOf(handle)) == handle);
+        expectedSum += value;
+    }
+    for (int value : map.getValues()) {
+        packedSum += value;
+    }
+    assert(packedSum == expectedSum);
+}
+
+void testWorldObjectHandles() {
+    World world;
+    auto near = world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 10), 1.0), RGBA_Color(1, 0, 0, 1)));
+    auto far = world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 20), 1.0), RGBA_Color(0, 1, 0, 1)));
+    auto wall = world.addObject(Shape<Plane>(Plane(Vector3D(0, 0, 30), Vector3D(0, 0, -1)), RGBA_Color(0, 0, 1, 1)));
+    auto side = world.addObject(Shape<Sphere>(Sphere(Vector3D(5, 0, 5), 1.0), RGBA_Color(1, 1, 0, 1)));
+    assert(world.getObjectCount() == 4);
+
+    Ray ray(Vector3D(0, 0, 0), Vector3D(0, 0, 1));
+    auto hit = world.findClosestHit(ray);
+    assert(hit && world.getObjectHandleAt(hit->shapeIndex) == near);
+
+    // Handles survive the removal of other objects
+    world.removeObject(near);
+    assert(!world.containsObject(near));
+    assert(world.containsObject(far) && world.containsObject(wall) && world.containsObject(side));
+    hit = world.findClosestHit(ray);
+    assert(hit && world.getObjectHandleAt(hit->shapeIndex) == far);
+
+    world.setObject(far, Shape<Sphere>(Sphere(Vector3D(3, 0, 20), 1.0), RGBA_Color(0, 1, 0, 1)));
+    assert(std::get<Shape<Sphere>>(world.getObject(far)).getGeometry()->getCenter().x() == 3.0);
+    hit = world.findClosestHit(ray);
+    assert(hit && world.getObjectHandleAt(hit->shapeIndex) == wall);
+
+    world.removeObject(wall);
+    assert(!world.findClosestHit(ray));
+    assert(world.getObjectCount() == 2);
+    assert(world.getObjectIndex().getLeafCount() == 2);
+
+    bool threw = false;
+    try {
+        world.removeObject(wall);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        world.setObject(near, Shape<Sphere>(Sphere(Vector3D(0, 0, 4), 1.0)));
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    world.clearObjects();
+    assert(!world.containsObject(far) && !world.containsObject(side));
+}
+
+void testWorldLightHandles() {
+    World world;
+    Light white(Vector3D(0, 10, 0), RGBA_Color(1, 1, 1, 1), 1.0);
+    Light red(Vector3D(5, 5, 5), RGBA_Color(1, 0, 0, 1), 0.5);
+    Light blue(Vector3D(-5, 5, 5), RGBA_Color(0, 0, 1, 1), 0.5);
+    auto whiteHandle = world.addLight(white);
+    auto redHandle = world.addLight(red);
+    auto blueHandle = world.addLight(blue);
+    assert(world.getLightCount() == 3);
+
+    world.removeLight(whiteHandle);
+    assert(!world.containsLight(whiteHandle));
+    assert(world.getLight(redHandle) == red && world.getLight(blueHandle) == blue);
+
+    world.removeLight(red);
+    assert(!world.containsLight(redHandle) && world.containsLight(blueHandle));
+
+    world.removeLightAt(0);
+    assert(world.getLightCount() == 0 && !world.containsLight(blueHandle));
+
+    bool threw = false;
+    try {
+        world.removeLightAt(0);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+void testWorldChurn() {
+    // Spawn and despawn objects of a large world, each change costs O(1) plus the index update
+    const size_t objectCount = 50000;
+    World world;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> position(-500.0, 500.0);
+    std::vector<World::ObjectHandle> handles;
+    for (size_t i = 0; i < objectCount; ++i) {
+        handles.push_back(world.addObject(Shape<Sphere>(Sphere(Vector3D(position(rng), position(rng), position(rng)), 1.0))));
+    }
+
+    const size_t changeCount = 20000;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < changeCount; ++i) {
+        size_t pick = rng() % handles.size();
+        world.removeObject(handles[pick]);
+        handles[pick] = world.addObject(Shape<Sphere>(Sphere(Vector3D(position(rng), position(rng), position(rng)), 1.0)));
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double churnMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    assert(world.getObjectCount() == objectCount);
+    assert(world.getObjectIndex().getLeafCount() == objectCount);
+    for (size_t i = 0; i < handles.size(); i += 97) {
+        assert(world.containsObject(handles[i]));
+    }
+
+    // Every object is still reported by the index under its current index
+    size_t found = 0;
+    for (size_t i = 0; i < 2000; ++i) {
+        const auto& sphere = std::get<Shape<Sphere>>(world.getObject(handles[i]));
+        Vector3D center = sphere.getGeometry()->getCenter();
+        Ray ray(center + Vector3D(0, 0, -1.5), Vector3D(0, 0, 1));
+        auto hit = world.findClosestHit(ray);
+        if (hit && world.getObjectHandleAt(hit->shapeIndex) == handles[i]) {
+            ++found;
+        }
+    }
+    assert(found > 1990);
+
+    std::cout << "  " << changeCount << " despawn/spawn pairs in " << objectCount << " objects: "
+              << churnMs << " ms (" << 1000.0 * churnMs / changeCount << " us each)" << std::endl;
+    assert(churnMs / changeCount < 0.1);
+}
@@ -0,0 +1,305 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include "../Lib/Physics/SweptSphere.h"
+#include "../Lib/Rendering/World.h"
+#include "../Lib/Rendering/Shape.hpp"
+
+using namespace physics;
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testPlane();
+void testThinRectangle();
+void testRoundedEdges();
+void testBox();
+void testSphere();
+void testStartContact();
+void testBatch();
+void testErrors();
+
+namespace {
+
+    double distanceTo(const SweepTarget& target, const Vector3D& p) {
+        if (const Plane* plane = std::get_if<Plane>(&target)) {
+            return std::fabs((p - plane->getOrigin()).dot(plane->getNormal()));
+        }
+        if (const Rectangle* rectangle = std::get_if<Rectangle>(&target)) {
+            return rectangle->distanceToPoint(p);
+        }
+        if (const Circle* circle = std::get_if<Circle>(&target)) {
+            const Vector3D& n = circle->getNormal();
+            Vector3D radial = p - n * (p - circle->getCenter()).dot(n) - circle->getCenter();
+            if (radial.length() > circle->getRadius()) {
+                radial = radial * (circle->getRadius() / radial.length());
+            }
+            return (p - circle->getCenter() - radial).length();
+        }
+        if (const Box* box = std::get_if<Box>(&target)) {
+            Vector3D low = box->getMinCorner(), high = box->getMaxCorner();
+            Vector3D closest(std::clamp(p.x(), low.x(), high.x()), std::clamp(p.y(), low.y(), high.y()),
+                             std::clamp(p.z(), low.z(), high.z()));
+            return (p - closest).length();
+        }
+        const Sphere& sphere = std::get<Sphere>(target);
+        return std::max(0.0, (p - sphere.getCenter()).length() - sphere.getRadius());
+    }
+
+    // First sampled time the sphere touches the target, or 2 if it never does
+    double sampledTime(const SweptSphere& sphere, const SweepTarget& target, int samples) {
+        for (int i = 0; i <= samples; ++i) {
+            double time = static_cast<double>(i) / samples;
+            if (distanceTo(target, sphere.getCenterAt(time)) <= sphere.getRadius()) {
+                return time;
+            }
+        }
+        return 2.0;
+    }
+
+    void checkAgainstSampling(const SweptSphere& sphere, const SweepTarget& target) {
+        const int samples = 20000;
+        double expected = sampledTime(sphere, target, samples);
+        std::optional<SweepHit> hit = sphere.sweep(target);
+        if (expected > 1.0) {
+            assert(!hit || hit->time > 1.0 - 2.0 / samples);
+            return;
+        }
+        assert(hit);
+        assert(hit->time <= expected + 1e-12 && hit->time >= expected - 2.0 / samples);
+        // The contact point is on the target, a radius away along the normal unless they overlap at the start
+        Vector3D center = sphere.getCenterAt(hit->time);
+        assert(distanceTo(target, hit->point) < 1e-6);
+        assert(hit->time == 0.0 || (center - hit->normal * sphere.getRadius() - hit->point).length() < 1e-6);
+        assert(std::fabs(hit->normal.length() - 1.0) < 1e-9);
+    }
+
+}
+
+int main() {
+    std::cout << "Running SweptSphere tests..." << std::endl;
+
+    try {
+        testPlane();
+        std::cout << "✓ Plane tests passed" << std::endl;
+
+        testThinRectangle();
+        std::cout << "✓ Thin rectangle tests passed" << std::endl;
+
+        testRoundedEdges();
+        std::cout << "✓ Rounded edge tests passed" << std::endl;
+
+        testBox();
+        std::cout << "✓ Box tests passed" << std::endl;
+
+        testSphere();
+        std::cout << "✓ Sphere tests passed" << std::endl;
+
+        testStartContact();
+        std::cout << "✓ Start contact tests passed" << std::endl;
+
+        testBatch();
+        std::cout << "✓ Batch tests passed" << std::endl;
+
+        testErrors();
+        std::cout << "✓ Error tests passed" << std::endl;
+
+        std::cout << "All SweptSphere tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+void testPlane() {
+    Plane ground(Vector3D(0, 0, 0), Vector3D(0, 1, 0));
+    std::optional<SweepHit> hit = SweptSphere(Vector3D(0, 5, 0), Vector3D(0, -5, 0), 0.5).sweep(ground);
+    assert(hit);
+    assert(std::fabs(hit->time - 0.45) < 1e-12);
+    assert(hit->normal == Vector3D(0, 1, 0));
+    assert((hit->point - Vector3D(0, 0, 0)).length() < 1e-12);
+
+    // From below, the normal faces down
+    hit = SweptSphere(Vector3D(1, -5, 2), Vector3D(1, 5, 2), 0.5).sweep(ground);
+    assert(hit && std::fabs(hit->time - 0.45) < 1e-12);
+    assert(hit->normal == Vector3D(0, -1, 0));
+
+    // Moving away, parallel or stopping short
+    assert(!SweptSphere(Vector3D(0, 5, 0), Vector3D(0, 10, 0), 0.5).sweep(ground));
+    assert(!SweptSphere(Vector3D(0, 5, 0), Vector3D(10, 5, 0), 0.5).sweep(ground));
+    assert(!SweptSphere(Vector3D(0, 5, 0), Vector3D(0, 1, 0), 0.5).sweep(ground));
+}
+
+void testThinRectangle() {
+    // A pane the bullet crosses in one step: both ends of the motion are clear of it
+    Rectangle pane(Vector3D(-1, -1, 0), Vector3D(1, -1, 0), Vector3D(-1, 1, 0));
+    SweptSphere bullet(Vector3D(0.2, 0.3, -10), Vector3D(0.2, 0.3, 10), 0.1);
+    assert(distanceTo(pane, bullet.getStart()) > 0.1 && distanceTo(pane, bullet.getEnd()) > 0.1);
+    std::optional<SweepHit> hit = bullet.sweep(pane);
+    assert(hit);
+    assert(std::fabs(hit->time - 9.9 / 20.0) < 1e-12);
+    assert(hit->normal == Vector3D(0, 0, -1));
+
+    Circle disk(Vector3D(0, 0, 5), 1.0, Vector3D(0, 0, 1));
+    hit = bullet.sweep(disk);
+    assert(hit && std::fabs(hit->time - 14.9 / 20.0) < 1e-12);
+
+    // Missing the pane by more than the radius
+    assert(!SweptSphere(Vector3D(1.2, 0, -10), Vector3D(1.2, 0, 10), 0.1).sweep(pane));
+}
+
+void testRoundedEdges() {
+    Rectangle pane(Vector3D(-1, -1, 0), Vector3D(1, -1, 0), Vector3D(-1, 1, 0));
+    Circle disk(Vector3D(0, 0, 0), 1.0, Vector3D(0, 0, 1));
+
+    // Passing beside the edge or the rim, inside the radius
+    SweptSphere beside(Vector3D(1.05, 0, -10), Vector3D(1.05, 0, 10), 0.1);
+    std::optional<SweepHit> hit = beside.sweep(pane);
+    assert(hit);
+    double expected = (10.0 - std::sqrt(0.1 * 0.1 - 0.05 * 0.05)) / 20.0;
+    assert(std::fabs(hit->time - expected) < 1e-9);
+    assert(hit->normal.x() > 0.0 && hit->normal.z() < 0.0);
+    checkAgainstSampling(beside, pane);
+    checkAgainstSampling(beside, disk);
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> position(-3.0, 3.0);
+    std::uniform_real_distribution<double> size(0.05, 0.8);
+    Rectangle tilted = pane.rotate(Quaternion(Vector3D(1, 1, 0), 0.7));
+    Circle leaning(Vector3D(0.3, 0, 0), 1.2, Vector3D(0.2, 0.5, 1).normal());
+    for (int i = 0; i < 300; ++i) {
+        SweptSphere sphere(Vector3D(position(rng), position(rng), position(rng)),
+                           Vector3D(position(rng), position(rng), position(rng)), size(rng));
+        checkAgainstSampling(sphere, tilted);
+        checkAgainstSampling(sphere, leaning);
+    }
+}
+
+void testBox() {
+    Box box(Vector3D(0, 0, 0), 2.0, 1.0, 1.0, Vector3D(0, 0, 1));
+
+    // Face hit
+    std::optional<SweepHit> hit = SweptSphere(Vector3D(1, 0.5, 5), Vector3D(1, 0.5, -5), 0.5).sweep(box);
+    assert(hit && std::fabs(hit->time - 0.35) < 1e-12);
+    assert(hit->normal == Vector3D(0, 0, 1));
+
+    // Corner hit, along the diagonal
+    Vector3D direction = Vector3D(1, 1, 1).normal();
+    hit = SweptSphere(Vector3D(2, 1, 1) + direction * 5.0, Vector3D(2, 1, 1) - direction * 5.0, 0.5).sweep(box);
+    assert(hit && std::fabs(hit->time - 0.45) < 1e-9);
+    assert((hit->normal - direction).length() < 1e-9);
+    assert((hit->point - Vector3D(2, 1, 1)).length() < 1e-9);
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> position(-3.0, 4.0);
+    std::uniform_real_distribution<double> size(0.05, 0.8);
+    for (int i = 0; i < 500; ++i) {
+        SweptSphere sphere(Vector3D(position(rng), position(rng), position(rng)),
+                           Vector3D(position(rng), position(rng), position(rng)), size(rng));
+        checkAgainstSampling(sphere, box);
+    }
+}
+
+void testSphere() {
+    Sphere ball(Vector3D(0, 0, 0), 1.0);
+    std::optional<SweepHit> hit = SweptSphere(Vector3D(-10, 0, 0), Vector3D(10, 0, 0), 0.5).sweep(ball);
+    assert(hit && std::fabs(hit->time - 8.5 / 20.0) < 1e-9);
+    assert((hit->normal - Vector3D(-1, 0, 0)).length() < 1e-9);
+    assert((hit->point - Vector3D(-1, 0, 0)).length() < 1e-9);
+
+    assert(!SweptSphere(Vector3D(-10, 2, 0), Vector3D(10, 2, 0), 0.5).sweep(ball));
+    assert(!SweptSphere(Vector3D(-10, 0, 0), Vector3D(-5, 0, 0), 0.5).sweep(ball));
+
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> position(-3.0, 3.0);
+    std::uniform_real_distribution<double> size(0.05, 0.8);
+    for (int i = 0; i < 300; ++i) {
+        SweptSphere sphere(Vector3D(position(rng), position(rng), position(rng)),
+                           Vector3D(position(rng), position(rng), position(rng)), size(rng));
+        checkAgainstSampling(sphere, ball);
+    }
+}
+
+void testStartContact() {
+    // Resting on the ground and pushed into it
+    Plane ground(Vector3D(0, 0, 0), Vector3D(0, 1, 0));
+    std::optional<SweepHit> hit = SweptSphere(Vector3D(0, 0.4, 0), Vector3D(0, -1, 0), 0.5).sweep(ground);
+    assert(hit && hit->time == 0.0 && hit->normal == Vector3D(0, 1, 0));
+
+    Box box(Vector3D(0, 0, 0), 1.0, 1.0, 1.0, Vector3D(0, 0, 1));
+    hit = SweptSphere(Vector3D(1.2, 0.5, 0.5), Vector3D(5, 0.5, 0.5), 0.5).sweep(box);
+    assert(hit && hit->time == 0.0 && hit->normal == Vector3D(1, 0, 0));
+
+    // A sphere at rest only hits what it already touches
+    assert(!SweptSphere(Vector3D(3, 0.5, 0.5), Vector3D(3, 0.5, 0.5), 0.5).sweep(box));
+    assert(SweptSphere(Vector3D(1.4, 0.5, 0.5), Vector3D(1.4, 0.5, 0.5), 0.5).sweep(box));
+}
+
+void testBatch() {
+    World world;
+    world.addObject(Shape<Plane>(Plane(Vector3D(0, -20, 0), Vector3D(0, 1, 0))));
+    for (int i = 0; i < 8; ++i) {
+        double x = -16.0 + 4.0 * i;
+        world.addObject(Shape<Box>(Box(Vector3D(x, -5, -5), 1.0, 10.0, 10.0, Vector3D(0, 0, 1))));
+        world.addObject(Shape<Rectangle>(Rectangle(Vector3D(x + 2, -3, -3), Vector3D(x + 2, 3, -3), Vector3D(x + 2, -3, 3))));
+        world.addObject(Shape<Circle>(Circle(Vector3D(x, 10, 0), 2.0, Vector3D(0, 1, 0))));
+        world.addObject(Shape<Sphere>(Sphere(Vector3D(x, -10, 0), 1.5)));
+    }
+    const math::Vector<Camera::ShapeVariant>& shapes = world.getObjects();
+    assert(shapes.size() == world.getObjectCount());
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> position(-20.0, 20.0);
+    std::uniform_real_distribution<double> velocity(-4.0, 4.0);
+    const size_t count = 100000;
+    math::Vector<SweptSphere> spheres(count);
+    for (size_t i = 0; i < count; ++i) {
+        Vector3D start(position(rng), position(rng), position(rng));
+        spheres[i] = SweptSphere(start, start + Vector3D(velocity(rng), velocity(rng), velocity(rng)), 0.2);
+    }
+
+    math::Vector<SweepHit> hits;
+    auto begin = std::chrono::high_resolution_clock::now();
+    size_t hitCount = SweptSphere::sweepAll(spheres, shapes, hits);
+    auto end = std::chrono::high_resolution_clock::now();
+    assert(hits.size() == count);
+    assert(hitCount > 0 && hitCount < count);
+
+    // The batch keeps the earliest hit of each sphere, by object index
+    size_t checked = 0;
+    for (size_t i = 0; i < count; i += 97, ++checked) {
+        double earliest = 2.0;
+        size_t target = SweepHit::NO_TARGET;
+        for (size_t t = 0; t < shapes.size(); ++t) {
+            std::optional<SweepHit> hit = std::visit([&](auto&& shape) {
+                return spheres[i].sweep(*shape.getGeometry());
+            }, shapes[t]);
+            if (hit && hit->time < earliest) {
+                earliest = hit->time;
+                target = t;
+            }
+        }
+        assert(hits[i].target == target);
+        assert(!hits[i].isHit() || hits[i].time == earliest);
+    }
+    assert(checked > 1000);
+
+    std::cout << "  " << count << " spheres against " << shapes.size() << " objects: " << hitCount << " hits in "
+              << std::chrono::duration<double, std::milli>(end - begin).count() << " ms" << std::endl;
+}
+
+void testErrors() {
+    bool caught = false;
+    try {
+        SweptSphere(Vector3D(0, 0, 0), Vector3D(1, 0, 0), 0.0);
+    } catch (const std::invalid_argument&) {
+        caught = true;
+    }
+    assert(caught);
+}
@@ -0,0 +1,181 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include "../Lib/Rendering/TemporalAccumulator.h"
+#include "../Lib/Rendering/World.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+// Test function declarations
+void testProjectToPixel();
+void testStaticCameraReuse();
+void testMovingCameraReuse();
+void testDisocclusionRejection();
+void testWorldTemporalRender();
+
+int main() {
+    std::cout << "Running TemporalAccumulator tests..." << std::endl;
+
+    try {
+        testProjectToPixel();
+        std::cout << "✓ Pixel projection tests passed" << std::endl;
+
+        testStaticCameraReuse();
+        std::cout << "✓ Static camera reuse tests passed" << std::endl;
+
+        testMovingCameraReuse();
+        std::cout << "✓ Moving camera reuse tests passed" << std::endl;
+
+        testDisocclusionRejection();
+        std::cout << "✓ Disocclusion rejection tests passed" << std::endl;
+
+        testWorldTemporalRender();
+        std::cout << "✓ World temporal render tests passed" << std::endl;
+
+        std::cout << "All TemporalAccumulator tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+static math::Vector<Camera::ShapeVariant> makeShapes(const Vector3D& sphereCenter) {
+    math::Vector<Camera::ShapeVariant> shapes(2);
+    shapes[0] = Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.2, 0.8, 1.0));
+    shapes[1] = Shape<Sphere>(Sphere(sphereCenter, 4.0), RGBA_Color(1, 1, 1, 1));
+    return shapes;
+}
+
+static math::Vector<Light> makeLights() {
+    math::Vector<Light> lights(1);
+    lights[0] = Light(Vector3D(0, 5, -5), RGBA_Color(1, 1, 1, 1), 1.0);
+    return lights;
+}
+
+void testProjectToPixel() {
+    Camera camera = makeTestCamera();
+
+    // Inverse of generateRayForPixel
+    size_t pixels[][2] = {{0, 0}, {7, 3}, {16, 16}, {31, 20}};
+    for (auto& pixel : pixels) {
+        Ray ray = camera.generateRayForPixel(pixel[0], pixel[1], 32, 32, true);
+        double x, y;
+        assert(camera.projectToPixel(ray.getPointAt(25.0), 32, 32, x, y));
+        assert(std::abs(x - static_cast<double>(pixel[0])) < 1e-6);
+        assert(std::abs(y - static_cast<double>(pixel[1])) < 1e-6);
+    }
+
+    // Behind the camera
+    double x, y;
+    assert(!camera.projectToPixel(camera.getFOVOrigin() - camera.getDirection() * 5.0, 32, 32, x, y));
+}
+
+void testStaticCameraReuse() {
+    Camera camera = makeTestCamera();
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes(Vector3D(0, 0, 0));
+    math::Vector<Light> lights = makeLights();
+
+    TemporalAccumulator accumulator(8, 32);
+    Image first = accumulator.renderFrame(camera, shapes, lights, 32, 32);
+    TemporalStats firstStats = accumulator.getLastStats();
+    assert(firstStats.reusedPixels == 0);
+    assert(firstStats.freshPixels == 32 * 32);
+    assert(firstStats.samplesTraced == 8 * 32 * 32);
+
+    // Same view: almost every pixel reuses its history with a single sample
+    Image second = accumulator.renderFrame(camera, shapes, lights, 32, 32);
+    TemporalStats secondStats = accumulator.getLastStats();
+    assert(secondStats.reusedPixels + secondStats.freshPixels == 32 * 32);
+    assert(secondStats.reusedPixels > 9 * secondStats.freshPixels);
+    assert(secondStats.samplesTraced * 4 < firstStats.samplesTraced);
+
+    // Refining with samples of the same pattern stays close to the full rate result
+    for (int frame = 0; frame < 8; ++frame) {
+        second = accumulator.renderFrame(camera, shapes, lights, 32, 32);
+    }
+    double maxDifference = 0.0;
+    for (size_t y = 0; y < 32; ++y) {
+        for (size_t x = 0; x < 32; ++x) {
+            RGBA_Color a = first.getPixel(x, y), b = second.getPixel(x, y);
+            maxDifference = std::max({maxDifference, std::abs(a.r() - b.r()), std::abs(a.g() - b.g()), std::abs(a.b() - b.b())});
+        }
+    }
+    assert(maxDifference < 0.1);
+    assert(accumulator.getFrameIndex() == 10);
+
+    // A new resolution starts over
+    accumulator.renderFrame(camera, shapes, lights, 16, 16);
+    assert(accumulator.getLastStats().reusedPixels == 0);
+
+    bool exceptionThrown = false;
+    try {
+        TemporalAccumulator invalid(0, 8);
+    } catch (const std::invalid_argument&) {
+        exceptionThrown = true;
+    }
+    assert(exceptionThrown);
+}
+
+void testMovingCameraReuse() {
+    Camera camera = makeTestCamera();
+    math::Vector<Camera::ShapeVariant> shapes = makeShapes(Vector3D(0, 0, 0));
+    math::Vector<Light> lights = makeLights();
+
+    TemporalAccumulator accumulator(8, 32);
+    accumulator.renderFrame(camera, shapes, lights, 32, 32);
+
+    // A small step of a smooth path: most surfaces are still seen, the newly visible ones are traced
+    camera.translate(Vector3D(0.5, 0.0, 0.0));
+    accumulator.renderFrame(camera, shapes, lights, 32, 32);
+    TemporalStats stats = accumulator.getLastStats();
+    assert(stats.reusedPixels > 3 * stats.freshPixels);
+    assert(stats.freshPixels > 0);
+}
+
+void testDisocclusionRejection() {
+    Camera camera = makeTestCamera();
+    math::Vector<Light> lights = makeLights();
+
+    TemporalAccumulator accumulator(4, 32);
+    accumulator.renderFrame(camera, makeShapes(Vector3D(0, 0, 0)), lights, 32, 32);
+
+    // The sphere moves away: the wall behind it has no history, the sphere's new place neither
+    Image moved = accumulator.renderFrame(camera, makeShapes(Vector3D(6, 0, 0)), lights, 32, 32);
+    TemporalStats stats = accumulator.getLastStats();
+    assert(stats.freshPixels > 32);
+    assert(stats.reusedPixels > stats.freshPixels);
+
+    // The disoccluded wall matches a render of the new scene, not the old sphere
+    TemporalAccumulator reference(4, 32);
+    Image expected = reference.renderFrame(camera, makeShapes(Vector3D(6, 0, 0)), lights, 32, 32);
+    assert(moved.getPixel(16, 16) == expected.getPixel(16, 16));
+}
+
+void testWorldTemporalRender() {
+    World world;
+    world.getCamera() = makeTestCamera();
+    world.addObject(Shape<Sphere>(Sphere(Vector3D(0, 0, 0), 4.0), RGBA_Color(1, 1, 1, 1)));
+    world.addObject(Shape<Plane>(Plane(Vector3D(0, 0, 15), Vector3D(0, 0, -1)), RGBA_Color(0.8, 0.2, 0.8, 1.0)));
+    world.addLight(Light(Vector3D(0, 5, -5), RGBA_Color(1, 1, 1, 1), 1.0));
+
+    TemporalAccumulator accumulator(4, 16);
+    Image image = world.renderScene3DLight(24, 24, accumulator);
+    assert(image.getWidth() == 24 && image.getHeight() == 24);
+    world.renderScene3DLight(24, 24, accumulator);
+    assert(accumulator.getLastStats().reusedPixels > 0);
+    assert(accumulator.getFrameIndex() == 2);
+}
@@ -0,0 +1,94 @@
+//
+// Created by villerot on 18/10/2026.
+//
+
+#ifndef RENDER_FIXTURES_H
+#define RENDER_FIXTURES_H
+
+// Internal libraries
+#include "../../Lib/Rendering/Camera.h"
+#include "../../Lib/Rendering/Image.h"
+#include "../../Lib/Rendering/Light.h"
+#include "../../Lib/Geometry/Rectangle.h"
+#include "../../Lib/Geometry/Vector3D.h"
+#include "../../Lib/Math/Vector.hpp"
+
+// External libraries
+#include <cmath>
+#include <cstddef>
+
+// Scene fixtures shared by the rendering tests
+
+/**
+ * @brief Make the viewport of the rendering tests
+ * @return A square 20x20 viewport at z = -5 facing +z
+ */
+inline geometry::Rectangle makeTestViewport() {
+    geometry::Vector3D origin(-10, -10, -5);
+    return geometry::Rectangle(origin, origin + geometry::Vector3D(20.0, 0, 0), origin + geometry::Vector3D(0, 20.0, 0));
+}
+
+/**
+ * @brief Make the camera of the rendering tests, looking through makeTestViewport
+ * @param fovAngle The field of view of the camera in degrees
+ * @return The camera
+ */
+inline rendering::Camera makeTestCamera(float fovAngle = 65.0f) {
+    return rendering::Camera(makeTestViewport(), fovAngle);
+}
+
+/**
+ * @brief Make white lights evenly spaced on a circle of the plane z = -2 around the z axis
+ * @param count The number of lights
+ * @param radius The radius of the circle
+ * @param totalIntensity The sum of the intensities of the lights
+ * @return The lights
+ */
+inline math::Vector<rendering::Light> makeRingLights(size_t count, double radius, double totalIntensity) {
+    math::Vector<rendering::Light> lights(count);
+    for (size_t i = 0; i < count; ++i) {
+        double angle = 6.283185307179586 * static_cast<double>(i) / static_cast<double>(count);
+        lights[i] = rendering::Light(geometry::Vector3D(radius * std::cos(angle), radius * std::sin(angle), -2.0),
+                                     rendering::RGBA_Color(1, 1, 1, 1), totalIntensity / static_cast<double>(count));
+    }
+    return lights;
+}
+
+/**
+ * @brief Check if two images have the same size and exactly the same pixels
+ * @param a The first image
+ * @param b The second image
+ * @return True if the images are identical
+ */
+inline bool sameImage(const rendering::Image& a, const rendering::Image& b) {
+    if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight()) {
+        return false;
+    }
+    for (size_t y = 0; y < a.getHeight(); ++y) {
+        for (size_t x = 0; x < a.getWidth(); ++x) {
+            if (a.getPixel(x, y) != b.getPixel(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Get the mean absolute difference of the color channels of two images of the same size
+ * @param image The image to compare
+ * @param reference The reference image
+ * @return The mean over the pixels of the average difference of the r, g and b channels
+ */
+inline double meanAbsoluteDifference(const rendering::Image& image, const rendering::Image& reference) {
+    double sum = 0.0;
+    for (size_t y = 0; y < image.getHeight(); ++y) {
+        for (size_t x = 0; x < image.getWidth(); ++x) {
+            rendering::RGBA_Color a = image.getPixel(x, y), b = reference.getPixel(x, y);
+            sum += (std::abs(a.r() - b.r()) + std::abs(a.g() - b.g()) + std::abs(a.b() - b.b())) / 3.0;
+        }
+    }
+    return sum / static_cast<double>(image.getWidth() * image.getHeight());
+}
+
+#endif //RENDER_FIXTURES_H
@@ -0,0 +1,365 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include "../Lib/Rendering/Texture.h"
+#include "../Lib/Rendering/Camera.h"
+#include "../Lib/Rendering/Image.h"
+#include "../Lib/Rendering/Light.h"
+#include "../Lib/Rendering/Material.h"
+#include "../Lib/Rendering/Shape.hpp"
+#include "../Lib/Geometry/Plane.h"
+#include "../Lib/Geometry/Sphere.h"
+#include "../Lib/Geometry/Rectangle.h"
+#include "test_helpers/RenderFixtures.h"
+
+using namespace rendering;
+using namespace geometry;
+
+static const std::string TEXTURE_FILE = "./test/test_by_product/texture_test.tex";
+static const std::string CHECKER_FILE = "./test/test_by_product/texture_checker.tex";
+
+// Test function declarations
+void testMipChain();
+void testSampling();
+void testLevelOfDetail();
+void testTileCache();
+void testSurfaceCoordinates();
+void testTexturedRender();
+void testTextureArguments();
+
+int main() {
+    std::cout << "Running Texture tests..." << std::endl;
+
+    try {
+        testMipChain();
+        std::cout << "✓ Mip chain tests passed" << std::endl;
+
+        testSampling();
+        std::cout << "✓ Sampling tests passed" << std::endl;
+
+        testLevelOfDetail();
+        std::cout << "✓ Level of detail tests passed" << std::endl;
+
+        testTileCache();
+        std::cout << "✓ Tile cache tests passed" << std::endl;
+
+        testSurfaceCoordinates();
+        std::cout << "✓ Surface coordinate tests passed" << std::endl;
+
+        testTexturedRender();
+        std::cout << "✓ Textured render tests passed" << std::endl;
+
+        testTextureArguments();
+        std::cout << "✓ Texture argument tests passed" << std::endl;
+
+        std::remove(TEXTURE_FILE.c_str());
+        std::remove(CHECKER_FILE.c_str());
+        std::cout << "All Texture tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Test failed with unknown exception" << std::endl;
+        return 1;
+    }
+}
+
+// A smooth gradient whose texels are all distinct, so misplaced tiles show
+static Image makeGradient(size_t width, size_t height) {
+    Image image(static_cast<int>(width), static_cast<int>(height));
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            image.setPixel(x, y, RGBA_Color(x / 255.0, y / 255.0, ((x + y) % 256) / 255.0, 1.0));
+        }
+    }
+    return image;
+}
+
+// Black and white texels alternating, whose mips are all mid gray
+static Image makeChecker(size_t size) {
+    Image image(static_cast<int>(size), static_cast<int>(size));
+    for (size_t y = 0; y < size; ++y) {
+        for (size_t x = 0; x < size; ++x) {
+            double value = (x + y) % 2 == 0 ? 1.0 : 0.0;
+            image.setPixel(x, y, RGBA_Color(value, value, value, 1.0));
+        }
+    }
+    return image;
+}
+
+static bool near(double a, double b, double tolerance = 1e-9) {
+    return std::fabs(a - b) <= tolerance;
+}
+
+static bool sameColor(const RGBA_Color& a, const RGBA_Color& b, double tolerance = 1e-9) {
+    return near(a.r(), b.r(), tolerance) && near(a.g(), b.g(), tolerance) && near(a.b(), b.b(), tolerance) && near(a.a(), b.a(), tolerance);
+}
+
+void testMipChain() {
+    auto cache = std::make_shared<TextureCache>();
+    Image image = makeGradient(100, 40);
+    Texture::write(image, TEXTURE_FILE, 16);
+    Texture texture(TEXTURE_FILE, cache);
+
+    // 100x40 down to 1x1: 50x20, 25x10, 12x5, 6x2, 3x1, 1x1
+    assert(texture.getWidth() == 100 && texture.getHeight() == 40);
+    assert(texture.getLevelCount() == 7);
+    assert(texture.getTileSize() == 16);
+    assert(texture.getTileCount() == 7 * 3 + 4 * 2 + 2 + 1 + 1 + 1 + 1);
+
+    // The full resolution level holds the image, across tile borders too
+    for (size_t y = 0; y < 40; y += 3) {
+        for (size_t x = 0; x < 100; x += 7) {
+            assert(sameColor(texture.texel(0, x, y), image.getPixel(x, y), 0.5 / 255.0));
+        }
+    }
+
+    // Coordinates wrap
+    assert(sameColor(texture.texel(0, -1, 0), texture.texel(0, 99, 0)));
+    assert(sameColor(texture.texel(0, 100, 41), texture.texel(0, 0, 1)));
+
+    // Every mip of a checker is mid gray, down to the single texel
+    Texture::write(makeChecker(64), CHECKER_FILE);
+    Texture checker(CHECKER_FILE, cache);
+    assert(checker.getLevelCount() == 7);
+    for (size_t level = 1; level < checker.getLevelCount(); ++level) {
+        RGBA_Color texel = checker.texel(level, 0, 0);
+        assert(near(texel.r(), 128.0 / 255.0) && near(texel.a(), 1.0));
+    }
+}
+
+void testSampling() {
+    auto cache = std::make_shared<TextureCache>();
+    Texture texture(TEXTURE_FILE, cache);
+
+    // At a texel center a bilinear sample is the texel
+    double u = (10.5) / 100.0, v = (20.5) / 40.0;
+    assert(sameColor(texture.sampleBilinear(u, v, 0), texture.texel(0, 10, 20)));
+
+    // Halfway between two texels, their mean, across a tile border
+    RGBA_Color mid = texture.sampleBilinear(16.0 / 100.0, 20.5 / 40.0, 0);
+    RGBA_Color left = texture.texel(0, 15, 20), right = texture.texel(0, 16, 20);
+    assert(near(mid.r(), 0.5 * (left.r() + right.r())) && near(mid.b(), 0.5 * (left.b() + right.b())));
+
+    // Past the right border it blends with the first column, and whole periods change nothing
+    RGBA_Color edge = texture.sampleBilinear(1.0, 20.5 / 40.0, 0);
+    assert(near(edge.r(), 0.5 * (texture.texel(0, 99, 20).r() + texture.texel(0, 0, 20).r())));
+    assert(sameColor(texture.sampleBilinear(u + 3.0, v - 2.0, 0), texture.sampleBilinear(u, v, 0), 1e-12));
+
+    // Trilinear samples blend the levels around the level of detail
+    RGBA_Color fine = texture.sampleBilinear(0.3, 0.6, 1), coarse = texture.sampleBilinear(0.3, 0.6, 2);
+    RGBA_Color blended = texture.sample(0.3, 0.6, 1.25);
+    assert(near(blended.r(), 0.75 * fine.r() + 0.25 * coarse.r()));
+    assert(near(blended.g(), 0.75 * fine.g() + 0.25 * coarse.g()));
+    assert(sameColor(texture.sample(0.3, 0.6, 2.0), coarse));
+    assert(sameColor(texture.sample(0.3, 0.6, -4.0), texture.sampleBilinear(0.3, 0.6, 0)));
+    assert(sameColor(texture.sample(0.3, 0.6, 50.0), texture.texel(6, 0, 0)));
+}
+
+void testLevelOfDetail() {
+    auto cache = std::make_shared<TextureCache>();
+    Texture texture(TEXTURE_FILE, cache);
+
+    // 100 texels over 10 world units along u, 40 over 10 along v: u is the denser axis
+    assert(texture.levelOfDetail(0.1, 10.0, 10.0) == 0.0);
+    assert(near(texture.levelOfDetail(0.4, 10.0, 10.0), 2.0));
+    assert(near(texture.levelOfDetail(0.4, 10.0, 40.0), 2.0));
+    assert(texture.levelOfDetail(0.01, 10.0, 10.0) == 0.0);
+    assert(texture.levelOfDetail(0.0, 10.0, 10.0) == 0.0);
+}
+
+void testTileCache() {
+    // Room for four 16x16 tiles of the 35 of the texture
+    auto cache = std::make_shared<TextureCache>(4 * 16 * 16 * 4);
+    Texture texture(TEXTURE_FILE, cache);
+    auto big = std::make_shared<TextureCache>();
+    Texture reference(TEXTURE_FILE, big);
+
+    // Sweeping the whole texture pages tiles in and out within the budget
+    math::Vector<RGBA_Color> serial(200);
+    for (size_t k = 0; k < 200; ++k) {
+        double u = 0.013 * static_cast<double>(k * 7 % 200), v = 0.005 * static_cast<double>(k);
+        serial[k] = texture.sample(u, v, 0.3 * static_cast<double>(k % 10));
+        assert(sameColor(serial[k], reference.sample(u, v, 0.3 * static_cast<double>(k % 10))));
+        assert(cache->getResidentBytes() <= cache->getMemoryBudget());
+    }
+    assert(cache->getEvictionCount() > 0);
+    assert(cache->getTileLoadCount() > 4);
+    assert(cache->getTileLoadCount() - cache->getEvictionCount() == cache->getResidentBytes() / (16 * 16 * 4));
+
+    // Concurrent samples through the shared cache give the same colors
+    math::Vector<RGBA_Color> parallel(200);
+    #pragma omp parallel for
+    for (long long k = 0; k < 200; ++k) {
+        double u = 0.013 * static_cast<double>(k * 7 % 200), v = 0.005 * static_cast<double>(k);
+        parallel[static_cast<size_t>(k)] = texture.sample(u, v, 0.3 * static_cast<double>(k % 10));
+    }
+    for (size_t k = 0; k < 200; ++k) {
+        assert(sameColor(parallel[k], serial[k]));
+    }
+
+    // A sample reuses its tile: a cached texel costs no load
+    size_t loads = cache->getTileLoadCount();
+    texture.texel(0, 5, 5);
+    texture.texel(0, 6, 5);
+    assert(cache->getTileLoadCount() <= loads + 1);
+
+    // Destroyed textures leave the cache
+    size_t resident = big->getResidentBytes();
+    {
+        Texture transient(TEXTURE_FILE, big);
+        transient.sample(0.5, 0.5, 0.0);
+        assert(big->getResidentBytes() > resident);
+    }
+    assert(big->getResidentBytes() == resident);
+}
+
+void testSurfaceCoordinates() {
+    SurfaceCoordinates coordinates;
+
+    // Rectangles span [0, 1] from their top left corner
+    Camera::ShapeVariant rectangle = Shape<Rectangle>(Rectangle(Vector3D(0, 0, 5), Vector3D(4, 0, 5), Vector3D(0, 2, 5)), RGBA_Color(1, 1, 1, 1));
+    assert(surfaceCoordinates(rectangle, Vector3D(0, 0, 5), coordinates));
+    assert(near(coordinates.u, 0.0) && near(coordinates.v, 0.0));
+    assert(surfaceCoordinates(rectangle, Vector3D(3, 1.5, 5), coordinates));
+    assert(near(coordinates.u, 0.75) && near(coordinates.v, 0.75));
+    assert(near(coordinates.uLength, 4.0) && near(coordinates.vLength, 2.0));
+
+    // Spheres by longitude and latitude, v running from the +y pole
+    Camera::ShapeVariant sphere = Shape<Sphere>(Sphere(Vector3D(1, 1, 1), 2.0), RGBA_Color(1, 1, 1, 1));
+    assert(surfaceCoordinates(sphere, Vector3D(1, 3, 1), coordinates));
+    assert(near(coordinates.v, 0.0));
+    assert(surfaceCoordinates(sphere, Vector3D(3, 1, 1), coordinates));
+    assert(near(coordinates.u, 0.5) && near(coordinates.v, 0.5));
+    assert(near(coordinates.uLength, 4.0 * M_PI));
+
+    // Planes repeat every world unit
+    Camera::ShapeVariant plane = Shape<Plane>(Plane(Vector3D(0, 0, 10), Vector3D(0, 0, -1)), RGBA_Color(1, 1, 1, 1));
+    SurfaceCoordinates shifted;
+    assert(surfaceCoordinates(plane, Vector3D(0.3, 0.2, 10), coordinates));
+    assert(surfaceCoordinates(plane, Vector3D(1.3, 0.2, 10), shifted));
+    assert(near(std::hypot(shifted.u - coordinates.u, shifted.v - coordinates.v), 1.0));
+}
+
+void testTexturedRender() {
+    Camera camera = makeTestCamera();
+    math::Vector<Light> lights(1);
+    lights[0] = Light(Vector3D(0, 0, -4), RGBA_Color(1, 1, 1, 1), 1.0);
+
+    // A checkered quad, scaled to 8x8 texels of the 64x64 checker per pixel at 80x80
+    auto cache = std::make_shared<TextureCache>(8 * 32 * 32 * 4);
+    auto checker = std::make_shared<const Texture>(CHECKER_FILE, cache);
+    Material material(RGBA_Color(1, 0.5, 1, 1));
+    material.setAlbedoTexture(checker, 2.0);
+    assert(material.hasAlbedoTexture() && material.getTextureScale() == 2.0);
+
+    // Copies share the texture, a different scale makes another material
+    Material copy = material;
+    assert(copy.getAlbedoTexture() == checker && copy == material);
+    copy.setAlbedoTexture(checker, 3.0);
+    assert(!(copy == material));
+
+    math::Vector<Camera::ShapeVariant> shapes(1);
+    Shape<Rectangle> quad(Rectangle(Vector3D(-6, -6, 8), Vector3D(-6, 6, 8), Vector3D(6, -6, 8)));
+    quad.setMaterial(material);
+    shapes[0] = quad;
+
+    // Footprints span many texels: the mips average the checker to gray, tinted by the albedo
+    Image rendered = camera.renderScene3DLight(80, 80, shapes, lights);
+    RGBA_Color center = rendered.getPixel(40, 40);
+    assert(center.r() > 0.0 && near(center.g(), 0.5 * center.r(), 0.02));
+    for (size_t x = 34; x < 46; ++x) {
+        assert(near(rendered.getPixel(x, 40).r(), center.r(), 0.05));
+    }
+
+    // Without a footprint the finest level aliases: neighboring texels are black and white
+    Vector3D point(-5.015625, -5.015625, 8);
+    RGBA_Color finest = texturedAlbedo(shapes[0], material, point, Vector3D(0, 0, -1), Vector3D(0, 0, 1), 0.0);
+    RGBA_Color neighbor = texturedAlbedo(shapes[0], material, point + Vector3D(12.0 / 128.0, 0, 0), Vector3D(0, 0, -1), Vector3D(0, 0, 1), 0.0);
+    RGBA_Color filtered = texturedAlbedo(shapes[0], material, point, Vector3D(0, 0, -1), Vector3D(0, 0, 1), 2.0);
+    assert(near(finest.r(), 1.0) && near(finest.g(), 0.5) && near(neighbor.r(), 0.0));
+    assert(near(filtered.r(), 128.0 / 255.0, 0.01) && near(filtered.g(), 64.0 / 255.0, 0.01));
+
+    // Grazing rays stretch the footprint to coarser levels
+    RGBA_Color grazing = texturedAlbedo(shapes[0], material, point, Vector3D(0, 0, -1), Vector3D(1, 0, 0.05).normal(), 0.05);
+    assert(near(grazing.r(), 128.0 / 255.0, 0.05));
+
+    // Advanced renders sample the texture too, through a cache smaller than the texture
+    Image advanced = camera.renderScene3DLight_Advanced(80, 80, shapes, lights);
+    assert(near(advanced.getPixel(40, 40).g(), 0.5 * advanced.getPixel(40, 40).r(), 0.02));
+    assert(cache->getResidentBytes() <= cache->getMemoryBudget());
+
+    // Untextured materials render as before
+    Material plain(RGBA_Color(1, 0.5, 1, 1));
+    quad.setMaterial(plain);
+    shapes[0] = quad;
+    Image untextured = camera.renderScene3DLight(80, 80, shapes, lights);
+    assert(untextured.getPixel(40, 40).r() > center.r());
+}
+
+void testTextureArguments() {
+    bool threw = false;
+    try {
+        TextureCache cache(0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        Texture texture(TEXTURE_FILE, nullptr);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        Texture texture("./test/test_by_product/missing.tex", std::make_shared<TextureCache>());
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // A truncated file is no texture
+    {
+        Image small = makeGradient(8, 8);
+        Texture::write(small, CHECKER_FILE, 4);
+        FILE* file = fopen(CHECKER_FILE.c_str(), "rb");
+        char bytes[64];
+        size_t read = fread(bytes, 1, sizeof(bytes), file);
+        fclose(file);
+        file = fopen(CHECKER_FILE.c_str(), "wb");
+        fwrite(bytes, 1, read, file);
+        fclose(file);
+    }
+    threw = false;
+    try {
+        Texture texture(CHECKER_FILE, std::make_shared<TextureCache>());
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        Texture::write(Image(), TEXTURE_FILE);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        Material material;
+        material.setAlbedoTexture(nullptr, 0.0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+}
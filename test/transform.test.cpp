@@ -0,0 +1,140 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../Lib/Geometry/Transform.h"
+
+using namespace geometry;
+
+// Test function declarations
+void testIdentity();
+void testPointsAndNormals();
+void testComposition();
+void testBatch();
+void testErrors();
+
+int main() {
+    std::cout << "Running Transform tests..." << std::endl;
+
+    try {
+        testIdentity();
+        std::cout << "✓ Identity tests passed" << std::endl;
+
+        testPointsAndNormals();
+        std::cout << "✓ Point and normal tests passed" << std::endl;
+
+        testComposition();
+        std::cout << "✓ Composition tests passed" << std::endl;
+
+        testBatch();
+        std::cout << "✓ Batch tests passed" << std::endl;
+
+        testErrors();
+        std::cout << "✓ Error tests passed" << std::endl;
+
+        std::cout << "All Transform tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+void testIdentity() {
+    Transform identity;
+    assert(identity.getScale() == 1.0);
+    assert(identity.getTranslation() == Vector3D(0, 0, 0));
+    assert(identity.transformPoint(Vector3D(1, -2, 3)) == Vector3D(1, -2, 3));
+    assert(identity.transformNormal(Vector3D(0, 1, 0)) == Vector3D(0, 1, 0));
+}
+
+void testPointsAndNormals() {
+    // A quarter turn around z, doubled, then moved up
+    Transform transform(Quaternion(Vector3D(0, 0, 1), M_PI / 2.0), Vector3D(0, 0, 5), 2.0);
+    assert((transform.transformPoint(Vector3D(1, 0, 0)) - Vector3D(0, 2, 5)).length() < 1e-12);
+    assert((transform.transformNormal(Vector3D(1, 0, 0)) - Vector3D(0, 1, 0)).length() < 1e-12);
+
+    // The rotation is normalized
+    Transform scaled(Quaternion(2, 0, 0, 0));
+    assert(scaled.getRotation().isUnit());
+    assert((scaled.transformPoint(Vector3D(1, 2, 3)) - Vector3D(1, 2, 3)).length() < 1e-12);
+}
+
+void testComposition() {
+    Transform first(Quaternion(Vector3D(1, 1, 0), 0.6), Vector3D(1, 2, 3), 0.5);
+    Transform second(Quaternion(Vector3D(0, 1, 2), -1.1), Vector3D(-4, 0, 1), 3.0);
+    Vector3D point(0.3, -0.7, 2.0);
+
+    Transform both = second * first;
+    Vector3D expected = second.transformPoint(first.transformPoint(point));
+    assert((both.transformPoint(point) - expected).length() < 1e-12);
+
+    Vector3D back = both.inverse().transformPoint(expected);
+    assert((back - point).length() < 1e-12);
+    assert(std::fabs(both.inverse().getScale() - 1.0 / 1.5) < 1e-15);
+}
+
+void testBatch() {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> component(-10.0, 10.0);
+    const size_t count = 1000000;
+    std::vector<Vector3D> points(count), out(count);
+    for (Vector3D& p : points) {
+        p = Vector3D(component(rng), component(rng), component(rng));
+    }
+    Transform transform(Quaternion(Vector3D(3, -1, 2), 2.3), Vector3D(5, 6, 7), 1.5);
+    Quaternion rotation = transform.getRotation();
+
+    // Points are scaled, rotated, translated; normals only rotated
+    transform.transformPoints(points.data(), out.data(), count);
+    for (size_t i = 0; i < count; i += 997) {
+        Vector3D expected = rotation * (points[i] * 1.5) + Vector3D(5, 6, 7);
+        assert((out[i] - expected).length() < 1e-11);
+    }
+    transform.transformNormals(points.data(), out.data(), count);
+    for (size_t i = 0; i < count; i += 997) {
+        assert((out[i] - rotation * points[i]).length() < 1e-11);
+    }
+
+    // In place
+    std::vector<Vector3D> copy = points;
+    transform.transformPoints(copy.data(), copy.data(), count);
+    transform.inverse().transformPoints(copy.data(), copy.data(), count);
+    for (size_t i = 0; i < count; i += 997) {
+        assert((copy[i] - points[i]).length() < 1e-11);
+    }
+
+    // Against the scalar path
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = rotation * (points[i] * 1.5) + Vector3D(5, 6, 7);
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    transform.transformPoints(points.data(), out.data(), count);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  Transforming " << count << " points: scalar "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, batch "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+}
+
+void testErrors() {
+    bool caught = false;
+    try {
+        Transform(Quaternion(0, 0, 0, 0));
+    } catch (const std::invalid_argument&) {
+        caught = true;
+    }
+    assert(caught);
+
+    caught = false;
+    try {
+        Transform(Quaternion(), Vector3D(0, 0, 0), 0.0);
+    } catch (const std::invalid_argument&) {
+        caught = true;
+    }
+    assert(caught);
+}
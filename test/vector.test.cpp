@@ -20,6 +20,7 @@ void testVectorMethods();
 void testVector3Constructors();
 void testVector3Methods();
 void testVector3Operations();
+void testVector3Constexpr();
 void testErrorHandling();
 
 int main() {
@@ -44,6 +45,9 @@ int main() {
         testVector3Operations();
         std::cout << "✓ Vector3D operations test passed" << std::endl;
         
+        testVector3Constexpr();
+        std::cout << "✓ Vector3D constexpr test passed" << std::endl;
+        
         testErrorHandling();
         std::cout << "✓ Error handling test passed" << std::endl;
         
@@ -195,6 +199,27 @@ void testVectorMethods() {
         count++;
     }
     assert(count == 5);
+
+    // Test reserve and removeLast, which keep the storage
+    Vector<double> v3;
+    v3.reserve(16);
+    assert(v3.size() == 0 && v3.capacity() == 16);
+    double* storage = v3.begin();
+    for (int i = 0; i < 16; ++i) v3.append(double(i));
+    assert(v3.begin() == storage);
+    v3.removeLast();
+    assert(v3.size() == 15 && v3[14] == 14.0);
+    v3.append(v3[0]);   // appending an element of the vector itself
+    v3.append(v3[1]);   // past the capacity
+    assert(v3.size() == 17 && v3[15] == 0.0 && v3[16] == 1.0);
+    assert(v3.capacity() >= 17);
+    v3.clear();
+    assert(v3.capacity() == 0);
+    try {
+        v3.removeLast();
+        assert(false); // Should not reach here
+    } catch (const std::out_of_range&) {
+    }
 }
 
 void testVector3Constructors() {
@@ -261,6 +286,19 @@ void testVector3Methods() {
     assert(isEqual(v3.length(), 1.0));
     assert(isEqual(v3.x(), 0.6));
     assert(isEqual(v3.y(), 0.8));
+
+    // Test tangent basis, including a normal along the helper axis
+    Vector3D normals[] = {v1, Vector3D(5.0, 0.0, 0.0), Vector3D(0.0, 0.0, -2.0)};
+    for (const Vector3D& n : normals) {
+        Vector3D axisU, axisV;
+        n.tangentBasis(axisU, axisV);
+        assert(isEqual(axisU.length(), 1.0));
+        assert(isEqual(axisV.length(), 1.0));
+        assert(isEqual(axisU.dot(axisV), 0.0));
+        assert(isEqual(axisU.dot(n), 0.0));
+        assert(isEqual(axisV.dot(n), 0.0));
+        assert(axisU.cross(axisV).squaredDistance(n.normal()) < 1e-18);
+    }
 }
 
 void testVector3Operations() {
@@ -359,4 +397,21 @@ void testErrorHandling() {
     } catch (const std::invalid_argument&) {
         // Expected
     }
-}
\ No newline at end of file
+}
+
+void testVector3Constexpr() {
+    // Built and combined at compile time
+    constexpr Vector3D a(1.0, 2.0, 3.0);
+    constexpr Vector3D b = Vector3D::UNIT_Y * 2.0 - a;
+    static_assert(b.x() == -1.0 && b.y() == 0.0 && b.z() == -3.0);
+    static_assert(a.dot(Vector3D::UNIT_Z) == 3.0);
+    static_assert(Vector3D::UNIT_X.cross(Vector3D::UNIT_Y) == Vector3D::UNIT_Z);
+    static_assert(a.lengthSquared() == 14.0);
+    static_assert((a / 2.0).at(2) == 1.5);
+    static_assert(Vector3D::ZERO.zero() && Vector3D::UNIT_X.parallel(Vector3D(-3.0, 0.0, 0.0)));
+
+    // Arithmetic does not throw, division and normalization may
+    static_assert(noexcept(a + b) && noexcept(a.cross(b)) && noexcept(a.length()));
+    static_assert(!noexcept(a / 2.0) && !noexcept(a.normal()));
+    assert(isEqual(a.length(), std::sqrt(14.0)));
+}